@@ -0,0 +1,213 @@
+#include "custom-mem-alloc/AllocationTrace.hpp"
+#include "custom-mem-alloc/CustomMemoryAllocator.hpp"
+#include "utils/config/RootDir.h"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// replays the allocation traces given as arguments, which the svo builder records with
+// SvoBuilder.allocationTraceFile, against every allocation strategy, or a synthetic workload of
+// growing chunks if there are none, the fragmentation over time is written to a csv
+namespace {
+size_t constexpr kMb = 1024 * 1024;
+// the fragmentation is sampled this many times per run
+size_t constexpr kFragmentationSampleCount = 200;
+
+char const *const kFragmentationCsvFile = "allocator_benchmark.csv";
+
+struct Workload {
+  std::string name;
+  AllocationTrace trace;
+};
+
+struct RunResult {
+  size_t opCount     = 0;
+  size_t failedCount = 0;
+  double totalMs     = 0.0;
+  // the latencies of the single ops
+  double p50Ns = 0.0;
+  double p99Ns = 0.0;
+  double maxNs = 0.0;
+  // the op index, the fragmentation and the free size of every sample
+  std::vector<std::tuple<size_t, double, size_t>> fragmentationSamples{};
+};
+
+// mirrors the removed CustomMemoryAllocator::_test, 100 chunks of 1 to 3 mb are freed and allocated
+// again in random order, each one slightly larger than before, until it's reset to a random size
+AllocationTrace _makeSyntheticTrace() {
+  size_t constexpr kPoolSize       = 512 * kMb;
+  size_t constexpr kChunkCount     = 100;
+  size_t constexpr kIterationCount = 1000000;
+  double constexpr kLowerBoundMb   = 1.0;
+  double constexpr kUpperBoundMb   = 3.0;
+  double constexpr kGrowSpeedMb    = 0.0001;
+
+  // a fixed seed, so the runs are comparable
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> chunkSizeDis(kLowerBoundMb, kUpperBoundMb);
+  std::uniform_int_distribution<size_t> chunkSelectionDis(0, kChunkCount - 1);
+
+  AllocationTrace trace(kPoolSize);
+  uint32_t allocationCount = 0;
+  std::vector<std::pair<uint32_t, double>> chunks{};
+  for (size_t i = 0; i < kChunkCount; i++) {
+    double const sizeMb = chunkSizeDis(gen);
+    trace.addOp({AllocationTrace::OpType::kAllocate, allocationCount,
+                 static_cast<size_t>(sizeMb * kMb)});
+    chunks.emplace_back(allocationCount++, sizeMb);
+  }
+
+  for (size_t i = 0; i < kIterationCount; i++) {
+    auto &[allocationId, sizeMb] = chunks[chunkSelectionDis(gen)];
+    trace.addOp({AllocationTrace::OpType::kDeallocate, allocationId, 0});
+
+    sizeMb       = sizeMb < kUpperBoundMb ? sizeMb + kGrowSpeedMb : chunkSizeDis(gen);
+    allocationId = allocationCount++;
+    trace.addOp(
+        {AllocationTrace::OpType::kAllocate, allocationId, static_cast<size_t>(sizeMb * kMb)});
+  }
+  return trace;
+}
+
+double _getFragmentation(CustomMemoryAllocator const &allocator, size_t &freeSize) {
+  size_t largestFreeBlockSize = 0;
+  allocator.getFreeStats(freeSize, largestFreeBlockSize);
+  if (freeSize == 0) {
+    return 0.0;
+  }
+  return 1.0 - static_cast<double>(largestFreeBlockSize) / static_cast<double>(freeSize);
+}
+
+// the allocations that don't fit are skipped, and so are the later ops on them, the allocators
+// exit on a failed allocation
+RunResult _replay(Logger *logger, AllocationTrace const &trace, AllocationStrategy strategy) {
+  CustomMemoryAllocator allocator(logger, trace.getPoolSize(), strategy);
+  std::unordered_map<uint32_t, CustomMemoryAllocationResult> allocations{};
+
+  auto const &ops           = trace.getOps();
+  size_t const sampleStride = std::max<size_t>(ops.size() / kFragmentationSampleCount, 1);
+
+  RunResult result{};
+  std::vector<double> latenciesNs{};
+  latenciesNs.reserve(ops.size());
+  for (size_t opIndex = 0; opIndex < ops.size(); opIndex++) {
+    auto const &op = ops[opIndex];
+    auto const it  = allocations.find(op.allocationId);
+
+    std::chrono::steady_clock::time_point beginTime{};
+    switch (op.type) {
+    case AllocationTrace::OpType::kAllocate: {
+      if (!allocator.canAllocate(op.size)) {
+        result.failedCount++;
+        continue;
+      }
+      beginTime                    = std::chrono::steady_clock::now();
+      allocations[op.allocationId] = allocator.allocate(op.size);
+      break;
+    }
+    case AllocationTrace::OpType::kDeallocate:
+      if (it == allocations.end()) {
+        continue;
+      }
+      beginTime = std::chrono::steady_clock::now();
+      allocator.deallocate(it->second);
+      allocations.erase(it);
+      break;
+    case AllocationTrace::OpType::kShrink:
+      if (it == allocations.end()) {
+        continue;
+      }
+      beginTime  = std::chrono::steady_clock::now();
+      it->second = allocator.shrink(it->second, op.size);
+      break;
+    case AllocationTrace::OpType::kFreeAll:
+      beginTime = std::chrono::steady_clock::now();
+      allocator.freeAll();
+      allocations.clear();
+      break;
+    }
+    latenciesNs.push_back(
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - beginTime)
+            .count());
+
+    if (opIndex % sampleStride == 0) {
+      size_t freeSize            = 0;
+      double const fragmentation = _getFragmentation(allocator, freeSize);
+      result.fragmentationSamples.emplace_back(opIndex, fragmentation, freeSize);
+    }
+  }
+
+  result.opCount = latenciesNs.size();
+  if (latenciesNs.empty()) {
+    return result;
+  }
+  for (double const latencyNs : latenciesNs) {
+    result.totalMs += latencyNs / 1e6;
+  }
+  std::sort(latenciesNs.begin(), latenciesNs.end());
+  result.p50Ns = latenciesNs[latenciesNs.size() / 2];
+  result.p99Ns = latenciesNs[std::min(latenciesNs.size() * 99 / 100, latenciesNs.size() - 1)];
+  result.maxNs = latenciesNs.back();
+  return result;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Logger logger{};
+
+  std::vector<Workload> workloads{};
+  for (int i = 1; i < argc; i++) {
+    auto trace = AllocationTrace::readFromFile(argv[i]);
+    if (!trace.has_value()) {
+      logger.error("failed to read the allocation trace {}", argv[i]);
+      return 1;
+    }
+    workloads.push_back({argv[i], std::move(trace.value())});
+  }
+  if (workloads.empty()) {
+    logger.info("no allocation traces are given, running the synthetic workload");
+    workloads.push_back({"synthetic", _makeSyntheticTrace()});
+  }
+
+  std::vector<std::pair<char const *, AllocationStrategy>> const strategies = {
+      {"first-fit", AllocationStrategy::kFirstFit}, {"tlsf", AllocationStrategy::kTlsf}};
+
+  std::string const pathToCsv = kPathToResourceFolder + "profiles/" + kFragmentationCsvFile;
+  std::filesystem::create_directories(kPathToResourceFolder + "profiles/");
+  std::ofstream csvFile(pathToCsv);
+  csvFile << "workload,strategy,op,fragmentation,free_mb\n";
+
+  for (auto const &workload : workloads) {
+    logger.info("{}: {} ops over a pool of {} mb", workload.name, workload.trace.getOps().size(),
+                workload.trace.getPoolSize() / kMb);
+    for (auto const &[strategyName, strategy] : strategies) {
+      RunResult const result = _replay(&logger, workload.trace, strategy);
+
+      double maxFragmentation = 0.0;
+      for (auto const &[opIndex, fragmentation, freeSize] : result.fragmentationSamples) {
+        maxFragmentation = std::max(maxFragmentation, fragmentation);
+        csvFile << workload.name << "," << strategyName << "," << opIndex << "," << fragmentation
+                << "," << static_cast<double>(freeSize) / kMb << "\n";
+      }
+
+      double const opsPerSec =
+          result.totalMs > 0.0 ? static_cast<double>(result.opCount) / result.totalMs * 1e3 : 0.0;
+      logger.subInfo("{}: {:.0f} ops/s, p50 {:.0f} ns, p99 {:.0f} ns, max {:.0f} ns, max "
+                     "fragmentation {:.3f}, {} allocations didn't fit",
+                     strategyName, opsPerSec, result.p50Ns, result.p99Ns, result.maxNs,
+                     maxFragmentation, result.failedCount);
+    }
+  }
+
+  logger.info("fragmentation samples written to {}", pathToCsv);
+  return 0;
+}
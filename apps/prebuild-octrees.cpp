@@ -0,0 +1,18 @@
+#include "application/svo-builder/CpuSvoBuilder.hpp"
+#include "config-container/ConfigContainer.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <cstring>
+
+// with --compare, the host octrees are compared with the cache that the gpu builder wrote, instead
+// of replacing it
+int main(int argc, char **argv) {
+  Logger logger{};
+  ConfigContainer configContainer{&logger};
+  CpuSvoBuilder cpuSvoBuilder{&logger, &configContainer};
+  bool const isComparing = argc > 1 && std::strcmp(argv[1], "--compare") == 0;
+  if (isComparing) {
+    return cpuSvoBuilder.compareWithCache() ? 0 : 1;
+  }
+  return cpuSvoBuilder.buildSceneToCache() ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#ifndef ADAPTIVE_SAMPLING_GLSL
+#define ADAPTIVE_SAMPLING_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+// the primary hits that aren't sampled in a frame skip their shadow and indirect rays, and the
+// temporal filter makes up for their raw color
+
+// with ADAPTIVE_SAMPLING, the temporal filter flags the tiles whose pixels all converged while the
+// frame stood still, the primary hits of a flagged tile aren't sampled in the next frame, and the
+// temporal filter keeps their history as it is, every tile is sampled again as soon as the camera,
+// the chunks, the render size or the tweaking change
+
+// with sceneInfo.tracingInterleave at 2 or 4, the pixels take turns in a checkerboard or in 2x2
+// blocks, the turn steps with the sample index, the same one that picks the taa offset, the pixels
+// out of their turn reproject their history without a fresh sample
+
+uint getSamplingTileIndex(ivec2 uvi) {
+  uint tilesPerRow = (renderInfoUbo.data.lowResSize.x + kFilterTileSize - 1u) / kFilterTileSize;
+  uvec2 tile       = uvec2(uvi) / kFilterTileSize;
+  return tile.y * tilesPerRow + tile.x;
+}
+
+// the flags of the last frame only hold while the frame stands still
+bool isTileConverged(ivec2 uvi) {
+#ifdef ADAPTIVE_SAMPLING
+  return renderInfoUbo.data.staticFrameCount != 0u &&
+         samplingTileBuffer.data[getSamplingTileIndex(uvi)] != 0u;
+#else
+  return false;
+#endif // ADAPTIVE_SAMPLING
+}
+
+// the 2x2 blocks are visited diagonally first, so that every two frames cover a checkerboard
+bool isPixelsTurn(ivec2 uvi) {
+  const uint kBlockOrder[4] = {0u, 3u, 1u, 2u};
+
+  uint interleave = sceneInfoBuffer.data.tracingInterleave;
+  uint turn       = renderInfoUbo.data.currentSample % interleave;
+  if (interleave == 2u) {
+    return ((uint(uvi.x + uvi.y) + turn) & 1u) == 0u;
+  }
+  if (interleave == 4u) {
+    return (uint(uvi.x & 1) | (uint(uvi.y & 1) << 1u)) == kBlockOrder[turn];
+  }
+  return true;
+}
+
+bool isPixelSampled(ivec2 uvi) { return isPixelsTurn(uvi) && !isTileConverged(uvi); }
+
+#endif // ADAPTIVE_SAMPLING_GLSL
@@ -1,26 +1,12 @@
 #ifndef BLOCK_COLOR_GLSL
 #define BLOCK_COLOR_GLSL
 
-#include "../include/blockType.glsl"
-
 // for debugging: return tweakableParametersUbo.data.debugC1;
 
-// https://colorhunt.co/palette/973131e0a75ef9d689f5e7b2
-vec3 getBlockColor(uint blockType) {
-  switch (blockType) {
-  case kBlockTypeDirt:
-    return vec3(69.0, 49.0, 49.0) / 255.0;
-  case kBlockTypeRock:
-    return vec3(128.0, 128.0, 128.0) / 255.0;
-  case kBlockTypeSand:
-    return vec3(253.0, 255.0, 226.0) / 255.0;
-  case kBlockTypeGrass:
-    return vec3(86.0, 159.0, 46.0) / 255.0;
-  case kBlockTypeWater:
-    return vec3(53.0, 114.0, 239.0) / 255.0;
-  default:
-    return vec3(0.0);
-  }
+// the palette is packed as rgba8, the block types of the generated terrain and the color indices
+// of an imported scene both index it, see BlockPalette.cpp
+vec3 getPaletteColor(uint paletteIndex) {
+  return unpackUnorm4x8(paletteBuffer.data[paletteIndex]).rgb;
 }
 
 #endif // BLOCK_COLOR_GLSL
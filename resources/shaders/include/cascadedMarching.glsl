@@ -5,6 +5,7 @@
 
 #include "../include/chunking.glsl"
 #include "../include/ddaMarching.glsl"
+#include "../include/octreeInstance.glsl"
 #include "../include/svoMarching.glsl"
 
 struct MarchingResult {
@@ -17,13 +18,10 @@ struct MarchingResult {
   vec3 normal;
   uint voxHash;
   bool lightSourceHit;
+  uint chunkLod; // of the hit chunk
 };
 
-// this marching algorithm fetches leaf properties
-bool cascadedMarching(out MarchingResult oResult, vec3 o, vec3 d) {
-  ivec3 chunkIndex;
-  bool hitVoxel = false;
-
+void _initMarchingResult(out MarchingResult oResult, vec3 o, vec3 d) {
   oResult.iter                = 0;
   oResult.chunkTraversed      = 0;
   oResult.t                   = 1e10;
@@ -33,47 +31,236 @@ bool cascadedMarching(out MarchingResult oResult, vec3 o, vec3 d) {
   oResult.normal              = vec3(0);
   oResult.voxHash             = 0;
   oResult.lightSourceHit      = false;
+  oResult.chunkLod            = 0;
+}
+
+// the entry of the ray into the bounds of the voxels of the chunk, in the octree space of the
+// chunk, see makeChunkBounds, it's zero for a ray that starts within them
+bool _clipToChunkBounds(out float oTEnter, ivec3 chunkIndex, vec3 o, vec3 d, bool isPacket) {
+  vec3 boundsMin, boundsMax;
+  getChunkBounds(boundsMin, boundsMax, loadChunkBounds(chunkIndex, isPacket));
+
+  const vec3 invD = 1.0 / d;
+  const vec3 t0   = (vec3(1.0) + boundsMin - o) * invD;
+  const vec3 t1   = (vec3(1.0) + boundsMax - o) * invD;
+  const vec3 tMin = min(t0, t1);
+  const vec3 tMax = max(t0, t1);
+  oTEnter         = max(max(max(tMin.x, tMin.y), tMin.z), 0.0);
+  return oTEnter <= min(min(tMax.x, tMax.y), tMax.z);
+}
+
+// marches the octree of a chunk, the result is only replaced by a closer hit
+bool _marchChunkOctree(inout MarchingResult oResult, ivec3 chunkIndex, vec3 o, vec3 d,
+                       bool isPacket) {
+  // preOffset is to offset the octree tracing position, which works best with the range of [1, 2]
+  const ivec3 preOffset   = ivec3(1);
+  const vec3 originOffset = preOffset - chunkIndex;
+
+  uvec2 chunkIndicesEntry = loadChunkIndicesEntry(chunkIndex, isPacket);
+  if (!hasChunkOctree(chunkIndicesEntry)) {
+    return false;
+  }
+
+  // the ray is clipped to the bounds of the voxels of the chunk, a miss skips the octree, a hit
+  // starts the descent where the ray enters the bounds
+  float tEnter;
+  if (!_clipToChunkBounds(tEnter, chunkIndex, o + originOffset, d, isPacket)) {
+    return false;
+  }
+  const vec3 clippedOffset = d * tEnter;
+
+  uint chunkIterCount, voxHash;
+  vec3 color, pos, nextTracingPos, normal;
+  bool lightSourceHit;
+  float t;
+  bool hitVoxel = svoMarching(t, chunkIterCount, color, pos, nextTracingPos, normal, voxHash,
+                              lightSourceHit, o + originOffset + clippedOffset, d,
+                              getChunkOctreePage(chunkIndicesEntry),
+                              getChunkOctreeBufferOffset(chunkIndicesEntry), isPacket);
+  t += tEnter;
+
+  oResult.iter += chunkIterCount;
+  oResult.chunkTraversed++;
+  if (!hitVoxel || t >= oResult.t) {
+    return false;
+  }
+  oResult.t                   = t;
+  oResult.color               = color;
+  oResult.position            = pos - originOffset;
+  oResult.nextTracingPosition = nextTracingPos - originOffset;
+  oResult.normal              = normal;
+  oResult.voxHash             = voxHash;
+  oResult.lightSourceHit      = lightSourceHit;
+  oResult.chunkLod            = getChunkLod(chunkIndicesEntry);
+  return true;
+}
+
+// marches an instance within a chunk, the cube of the instance is mapped to the [1, 2] of its
+// octree, which keeps the t of the ray, and the ray is clipped to the part of the cube within the
+// chunk, so an instance that spans several chunks never hits behind a chunk that the dda visits
+// later, the result is only replaced by a closer hit
+bool _marchOctreeInstance(inout MarchingResult oResult, ivec3 chunkIndex, OctreeInstance instance,
+                          vec3 o, vec3 d, bool isPacket) {
+  const vec3 localO = (o - instance.position) / instance.size + 1.0;
+  const vec3 localD = d / instance.size;
+
+  const vec3 clipMin =
+      max(vec3(1.0), (vec3(chunkIndex) - instance.position) / instance.size + 1.0);
+  const vec3 clipMax =
+      min(vec3(2.0), (vec3(chunkIndex + 1) - instance.position) / instance.size + 1.0);
+  const vec3 invD    = 1.0 / localD;
+  const vec3 t0      = (clipMin - localO) * invD;
+  const vec3 t1      = (clipMax - localO) * invD;
+  const float tEnter = max(max(max(min(t0.x, t1.x), min(t0.y, t1.y)), min(t0.z, t1.z)), 0.0);
+  const float tExit  = min(min(max(t0.x, t1.x), max(t0.y, t1.y)), max(t0.z, t1.z));
+  if (tEnter > tExit || tEnter >= oResult.t) {
+    return false;
+  }
+
+  uint instanceIterCount, voxHash;
+  vec3 color, pos, nextTracingPos, normal;
+  bool lightSourceHit;
+  float t;
+  bool hitVoxel = svoMarching(t, instanceIterCount, color, pos, nextTracingPos, normal, voxHash,
+                              lightSourceHit, localO + localD * tEnter, localD,
+                              instance.octreePage, instance.octreeBufferOffset, isPacket);
+  t += tEnter;
+
+  oResult.iter += instanceIterCount;
+  if (!hitVoxel || t > tExit || t >= oResult.t) {
+    return false;
+  }
+  oResult.t                   = t;
+  oResult.color               = color;
+  oResult.position            = (pos - 1.0) * instance.size + instance.position;
+  oResult.nextTracingPosition = (nextTracingPos - 1.0) * instance.size + instance.position;
+  oResult.normal              = normal;
+  oResult.voxHash             = voxHash;
+  oResult.lightSourceHit      = lightSourceHit;
+  oResult.chunkLod            = 0;
+  return true;
+}
+
+// marches the prefab instances of a chunk, and the dynamic objects that the grid of the frame
+// lists in it, the result is only replaced by a closer hit
+bool _marchChunkInstances(inout MarchingResult oResult, ivec3 chunkIndex, vec3 o, vec3 d,
+                          bool isPacket) {
+  const uvec2 chunkInstancesEntry = loadChunkInstancesEntry(chunkIndex);
+  const uint instanceCount        = getChunkInstanceCount(chunkInstancesEntry);
+
+  bool hitInstance = false;
+  for (uint i = 0u; i < instanceCount; i++) {
+    if (_marchOctreeInstance(oResult, chunkIndex, loadOctreeInstance(chunkInstancesEntry, i), o, d,
+                             isPacket)) {
+      hitInstance = true;
+    }
+  }
+
+  const uvec2 chunkDynamicObjectsEntry = loadChunkDynamicObjectsEntry(chunkIndex);
+  for (uint i = 0u; i < chunkDynamicObjectsEntry.y; i++) {
+    if (_marchOctreeInstance(oResult, chunkIndex,
+                             loadDynamicObjectInstance(chunkDynamicObjectsEntry, i), o, d,
+                             isPacket)) {
+      hitInstance = true;
+    }
+  }
+  return hitInstance;
+}
+
+// marches a non-empty chunk, its own octree, its prefab instances and its dynamic objects
+bool _marchChunk(inout MarchingResult oResult, ivec3 chunkIndex, vec3 o, vec3 d, bool isPacket) {
+  const bool hitOctree    = _marchChunkOctree(oResult, chunkIndex, o, d, isPacket);
+  const bool hitInstances = _marchChunkInstances(oResult, chunkIndex, o, d, isPacket);
+  return hitOctree || hitInstances;
+}
+
+bool _cascadedMarching(out MarchingResult oResult, vec3 o, vec3 d, uint chunkFrustum,
+                       bool isPacket) {
+  _initMarchingResult(oResult, o, d);
 
   d = max(abs(d), vec3(kEpsilon)) * (step(0.0, d) * 2.0 - 1.0);
 
-  ivec3 mapPos               = ivec3(floor(o));
-  const vec3 deltaDist       = 1.0 / abs(d);
-  const ivec3 rayStep        = ivec3(sign(d));
-  vec3 sideDist              = (((sign(d) * 0.5) + 0.5) + sign(d) * (vec3(mapPos) - o)) * deltaDist;
+  ivec3 chunkIndex, rangeBegin, rangeEnd, mapPos;
+  vec3 sideDist;
+  const vec3 deltaDist = 1.0 / abs(d);
+  const ivec3 rayStep  = ivec3(sign(d));
+  if (!getChunkRange(rangeBegin, rangeEnd, chunkFrustum) ||
+      !initDdaMarching(mapPos, sideDist, rangeBegin, rangeEnd, deltaDist, o, d)) {
+    return false;
+  }
   bool enteredBigBoundingBox = false;
   uint ddaIteration          = 0;
+  // the chunks are visited front to back, so the first hit is the closest one
   while (ddaMarchingWithSave(chunkIndex, mapPos, sideDist, enteredBigBoundingBox, ddaIteration,
-                             deltaDist, rayStep, o, d)) {
-    // preOffset is to offset the octree tracing position, which works best with the range of [1, 2]
-    const ivec3 preOffset   = ivec3(1);
-    const vec3 originOffset = preOffset - chunkIndex;
-
-    uint chunkBufferOffset =
-        chunkIndicesBuffer
-            .data[getChunksBufferLinearIndex(uvec3(chunkIndex), sceneInfoBuffer.data.chunksDim)] -
-        1;
-
-    uint chunkIterCount, voxHash;
-    vec3 color, pos, nextTracingPos, normal;
-    bool lightSourceHit;
-    float t;
-    hitVoxel = svoMarching(t, chunkIterCount, color, pos, nextTracingPos, normal, voxHash,
-                           lightSourceHit, o + originOffset, d, chunkBufferOffset);
-
-    oResult.iter += chunkIterCount;
-    oResult.chunkTraversed++;
-    if (hitVoxel) {
-      oResult.t                   = t;
-      oResult.color               = color;
-      oResult.position            = pos - originOffset;
-      oResult.nextTracingPosition = nextTracingPos - originOffset;
-      oResult.normal              = normal;
-      oResult.voxHash             = voxHash;
-      oResult.lightSourceHit      = lightSourceHit;
+                             deltaDist, rayStep, rangeBegin, rangeEnd, o, d, isPacket)) {
+    // the chunk is not empty, ddaMarchingWithSave skips those
+    if (_marchChunk(oResult, chunkIndex, o, d, isPacket)) {
       return true;
     }
   }
   return false;
 }
 
+// this marching algorithm fetches leaf properties
+bool cascadedMarching(out MarchingResult oResult, vec3 o, vec3 d) {
+  return _cascadedMarching(oResult, o, d, kNoChunkFrustum, false);
+}
+
+// the same marching for the rays that stay within a frustum of the frame, like the primary rays,
+// they only march the chunks within its bounds, see getChunkRange, the coherent ones may be
+// marched as packets, the lanes of a subgroup share the fetches of the chunks and of the octree
+// nodes while their rays agree on them, and fall back to their own fetches once they diverge, the
+// including shader has to define SUBGROUP_PACKET_TRAVERSAL for that, see loadPacketOctreeNode
+bool frustumMarching(out MarchingResult oResult, vec3 o, vec3 d, uint chunkFrustum,
+                     bool isPacket) {
+  return _cascadedMarching(oResult, o, d, chunkFrustum, isPacket);
+}
+
+#ifdef SUPPORTS_RAY_QUERY
+// the hardware traversal finds the chunk boxes along the ray, unlike the dda it skips the empty
+// space between the non-empty chunks, the boxes arrive in no particular order, so each hit is
+// committed to cull the farther boxes, a shadow ray is done with any hit
+bool rayQueryMarching(out MarchingResult oResult, vec3 o, vec3 d, bool isAnyHitEnough) {
+  _initMarchingResult(oResult, o, d);
+
+  d = max(abs(d), vec3(kEpsilon)) * (step(0.0, d) * 2.0 - 1.0);
+
+  const uint rayFlags =
+      gl_RayFlagsOpaqueEXT | (isAnyHitEnough ? gl_RayFlagsTerminateOnFirstHitEXT : 0u);
+  rayQueryEXT rayQuery;
+  rayQueryInitializeEXT(rayQuery, chunksAccelerationStructure, rayFlags, 0xFF, o, 0.0, d,
+                        oResult.t);
+
+  bool hitVoxel = false;
+  while (rayQueryProceedEXT(rayQuery)) {
+    if (rayQueryGetIntersectionTypeEXT(rayQuery, false) !=
+        gl_RayQueryCandidateIntersectionAABBEXT) {
+      continue;
+    }
+    // the instances are translated to their chunk indices
+    const ivec3 chunkIndex =
+        ivec3(round(rayQueryGetIntersectionObjectToWorldEXT(rayQuery, false)[3]));
+    // the structure is built from the chunks of the builder, whose swaps may not be visible yet
+    if (!_inChunkRange(chunkIndex) || !_hasChunk(chunkIndex, false)) {
+      continue;
+    }
+    if (_marchChunk(oResult, chunkIndex, o, d, false)) {
+      rayQueryGenerateIntersectionEXT(rayQuery, oResult.t);
+      hitVoxel = true;
+    }
+  }
+  return hitVoxel;
+}
+#endif // SUPPORTS_RAY_QUERY
+
+// the shadow and indirect rays diverge, so they gain the most from the hardware traversal
+bool incoherentMarching(out MarchingResult oResult, vec3 o, vec3 d, bool isAnyHitEnough) {
+#ifdef SUPPORTS_RAY_QUERY
+  if (tweakableParametersUbo.data.useRayQuery != 0u) {
+    return rayQueryMarching(oResult, o, d, isAnyHitEnough);
+  }
+#endif // SUPPORTS_RAY_QUERY
+  return cascadedMarching(oResult, o, d);
+}
+
 #endif // CASCADED_MARCHING_GLSL
\ No newline at end of file
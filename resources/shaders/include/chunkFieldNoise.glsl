@@ -0,0 +1,215 @@
+#ifndef CHUNK_FIELD_NOISE_GLSL
+#define CHUNK_FIELD_NOISE_GLSL
+
+#include "../include/core/cnoise.glsl"
+#include "../include/core/inoise.glsl"
+
+#include "../include/blockTypeAndWeight.glsl"
+
+// the terrain of the generated chunks, shared by chunkFieldConstruction.comp and its batched
+// variant, both run workgroups of 8^3
+
+const float kNoiseAmplitude   = 0.5;
+const float kNoiseFrequency   = 2.0;
+const float kNoisePersistence = 0.3;
+const float kNoiseLacunarity  = 2.2;
+const int kNoiseOctaveCount   = 5;
+
+// the octave at the position in lattice cells, the lowest BAKED_NOISE_OCTAVE_COUNT octaves are
+// filtered from the baked volume instead, which repeats every kNoiseVolumeLatticeDim cells, and
+// matches the analytic noise up to the trilinear filtering within that period
+vec4 sampleNoiseOctave(vec3 latticePos, int octave) {
+#ifdef BAKED_NOISE_OCTAVE_COUNT
+  if (octave < BAKED_NOISE_OCTAVE_COUNT) {
+    return textureLod(noiseVolumeTexture, latticePos / float(kNoiseVolumeLatticeDim), 0.0);
+  }
+#endif // BAKED_NOISE_OCTAVE_COUNT
+  return noised(latticePos);
+}
+
+vec4 computeNoise(vec3 p) {
+  float total       = 0.0;
+  float amplitude   = kNoiseAmplitude;
+  float frequency   = kNoiseFrequency;
+  float persistence = kNoisePersistence;
+  float lacunarity  = kNoiseLacunarity;
+  int octaves       = kNoiseOctaveCount;
+
+  vec3 gradient = vec3(0.0);
+  for (int i = 0; i < octaves; i++) {
+    vec4 noise = sampleNoiseOctave(p * frequency, i);
+    // vec4 noise = vec4(cnoise(p * frequency));
+    total += amplitude * (noise.x + 0.5);
+    gradient += amplitude * frequency * noise.yzw;
+    amplitude *= persistence;
+    frequency *= lacunarity;
+  }
+
+  return vec4(total, gradient);
+}
+
+float islandGradientFalloff(ivec3 chunkDimension, vec3 globalVoxelPos) {
+  vec2 halfWorldDim2D = chunkDimension.xz / 2.0;
+  vec2 center         = halfWorldDim2D;
+  return 1.0 - smoothstep(0.0, min(halfWorldDim2D.x, halfWorldDim2D.y),
+                          distance(center, globalVoxelPos.xz));
+}
+
+// the packed block type and weight of the field point, in world chunks
+uint makeFieldValue(vec3 globalVoxelPos, uvec3 chunksDim, bool islandFalloff) {
+  // x: noise val, yzw: gradient
+  // this step takes ~80% of the time for the entire chunk generation
+  float noise   = computeNoise(globalVoxelPos).x;
+  // noise -= (1.0 - islandGradientFalloff(ivec3(chunksDim), globalVoxelPos));
+  if (islandFalloff) {
+    float falloff = islandGradientFalloff(ivec3(chunksDim), globalVoxelPos);
+    noise *= falloff;
+  }
+
+  float weight = noise - globalVoxelPos.y;
+
+  uint blockType = getBlockTypeFromWeight(weight);
+
+  if (blockType != kBlockTypeEmpty) {
+    if (globalVoxelPos.y < 0.1) {
+      blockType = kBlockTypeSand;
+    }
+  }
+
+  return packBlockTypeAndWeight(blockType, weight);
+}
+
+// the field is bounded over boxes of field points before the noise is evaluated at each of them,
+// the weight of a box that is certainly past the boundaries of the packed weight packs the same way
+// at every point, so only the boxes near the surface are evaluated point by point
+//
+// a workgroup of 8^3 points is one box, then 8 boxes of 4^3, then 64 of 2^3, a box is only
+// bounded if its parent is near the surface, the bound is the value at the center of the box, plus
+// the largest change over its extent
+const uint kFieldBoxNearSurface = 0;
+const uint kFieldBoxEmpty       = 1;
+const uint kFieldBoxSolid       = 2;
+const uint kFieldBoxLevelCount  = 3;
+
+// each partial derivative of noised() stays within this, whatever the gradients of its hash are,
+// the largest one found over its cell is 4.625, the rest is a margin
+const float kNoiseDerivativeBound = 5.0;
+// covers the rounding of the noise, and of the weight
+const float kFieldBoundMargin = 1e-3;
+// the trilinear filtering of the hardware weighs the texels with 8 bits of the fraction, so a
+// filtered octave may be off by a 1/256 of the change between texels along each axis
+const float kFilterWeightError = 1.0 / 256.0;
+
+shared uint sharedFieldBoxStates[1 + 8 + 64];
+
+// the largest change of the noise per unit of distance along an axis
+float getNoiseDerivativeBound() {
+  float bound     = 0.0;
+  float amplitude = kNoiseAmplitude;
+  float frequency = kNoiseFrequency;
+  for (int i = 0; i < kNoiseOctaveCount; i++) {
+    bound += amplitude * frequency * kNoiseDerivativeBound;
+    amplitude *= kNoisePersistence;
+    frequency *= kNoiseLacunarity;
+  }
+  return bound;
+}
+
+// how far the baked octaves may stray from the trilinear interpolation of their texels, which is
+// what the derivative bound holds for, at the center of a box and at any of its points
+float getBakedNoiseErrorBound() {
+  float bound = 0.0;
+#ifdef BAKED_NOISE_OCTAVE_COUNT
+  float amplitude = kNoiseAmplitude;
+  for (int i = 0; i < min(BAKED_NOISE_OCTAVE_COUNT, kNoiseOctaveCount); i++) {
+    bound += 2.0 * amplitude * 3.0 * kFilterWeightError * kNoiseDerivativeBound /
+             float(kNoiseVolumeTexelsPerCell);
+    amplitude *= kNoisePersistence;
+  }
+#endif // BAKED_NOISE_OCTAVE_COUNT
+  return bound;
+}
+
+// the box is centered at the position, in world chunks
+uint classifyFieldBox(vec3 center, vec3 halfExtent, uvec3 chunksDim, bool islandFalloff) {
+  float noise      = computeNoise(center).x;
+  float noiseBound = getNoiseDerivativeBound() * (halfExtent.x + halfExtent.y + halfExtent.z);
+
+  // |n f(p) - n f(c)| <= |n(p) - n(c)| f(p) + |n(c)| |f(p) - f(c)|, the falloff is within [0, 1],
+  // and its smoothstep changes at most 1.5 times as fast as the distance on the xz plane
+  float falloff      = 1.0;
+  float falloffBound = 0.0;
+  if (islandFalloff) {
+    float halfWorldDim = 0.5 * min(float(chunksDim.x), float(chunksDim.z));
+    falloff            = islandGradientFalloff(ivec3(chunksDim), center);
+    falloffBound       = 1.5 / halfWorldDim * length(halfExtent.xz);
+  }
+
+  float weight      = noise * falloff - center.y;
+  float weightBound = noiseBound + abs(noise) * falloffBound + halfExtent.y + kFieldBoundMargin +
+                      getBakedNoiseErrorBound();
+  if (weight + weightBound < boundaryMin) {
+    return kFieldBoxEmpty;
+  }
+  if (weight - weightBound > boundaryMax) {
+    return kFieldBoxSolid;
+  }
+  return kFieldBoxNearSurface;
+}
+
+// makeFieldValue() of the field point of the invocation, uvi is in the field of the chunk, it has
+// to be called by the whole workgroup of 8^3, in uniform control flow
+uint makeFieldValueOfWorkgroup(ivec3 uvi, uint voxelResolution, vec3 chunkPos, uvec3 chunksDim,
+                               bool islandFalloff) {
+  ivec3 groupBase = uvi - ivec3(gl_LocalInvocationID);
+
+  uint levelOffset       = 0;
+  uint parentLevelOffset = 0;
+  for (uint level = 0; level < kFieldBoxLevelCount; level++) {
+    uint boxDim       = 8u >> level;
+    uint boxesPerAxis = 1u << level;
+    uint boxCount     = boxesPerAxis * boxesPerAxis * boxesPerAxis;
+
+    uint i = gl_LocalInvocationIndex;
+    if (i < boxCount) {
+      uvec3 box = uvec3(i % boxesPerAxis, (i / boxesPerAxis) % boxesPerAxis,
+                        i / (boxesPerAxis * boxesPerAxis));
+
+      uint state = kFieldBoxNearSurface;
+      if (level > 0) {
+        uvec3 parent        = box / 2u;
+        uint parentsPerAxis = boxesPerAxis / 2u;
+        uint parentIndex    = parent.x + (parent.y + parent.z * parentsPerAxis) * parentsPerAxis;
+        state               = sharedFieldBoxStates[parentLevelOffset + parentIndex];
+      }
+
+      if (state == kFieldBoxNearSurface) {
+        vec3 centerPoint = vec3(groupBase + ivec3(box * boxDim)) + 0.5 * float(boxDim - 1u);
+        vec3 center      = chunkPos + (centerPoint - 0.5) / float(voxelResolution);
+        vec3 halfExtent  = vec3(0.5 * float(boxDim - 1u) / float(voxelResolution));
+        state            = classifyFieldBox(center, halfExtent, chunksDim, islandFalloff);
+      }
+      sharedFieldBoxStates[levelOffset + i] = state;
+    }
+    barrier();
+
+    parentLevelOffset = levelOffset;
+    levelOffset += boxCount;
+  }
+
+  uvec3 box           = gl_LocalInvocationID / 2u;
+  uint state          = sharedFieldBoxStates[parentLevelOffset + box.x + (box.y + box.z * 4u) * 4u];
+  vec3 globalVoxelPos = chunkPos + (vec3(uvi) - 0.5) / float(voxelResolution);
+
+  // mirrors makeFieldValue(), with the weight clamped by the packing
+  if (state == kFieldBoxEmpty) {
+    return packBlockTypeAndWeight(kBlockTypeEmpty, boundaryMin);
+  }
+  if (state == kFieldBoxSolid) {
+    return packBlockTypeAndWeight(globalVoxelPos.y < 0.1 ? kBlockTypeSand : kBlockTypeDirt,
+                                  boundaryMax);
+  }
+  return makeFieldValue(globalVoxelPos, chunksDim, islandFalloff);
+}
+
+#endif // CHUNK_FIELD_NOISE_GLSL
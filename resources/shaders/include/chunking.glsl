@@ -1,8 +1,59 @@
 #ifndef CHUNK_INDEX_GLSL
 #define CHUNK_INDEX_GLSL
 
-uint getChunksBufferLinearIndex(uvec3 chunkIndex, uvec3 chunksDim) {
-  return chunkIndex.x + chunkIndex.y * chunksDim.x + chunkIndex.z * chunksDim.x * chunksDim.y;
+#include "../include/svoBuilderDataStructs.glsl"
+
+// the chunk indices buffer is a toroidal window over the world, a chunk shares its entry with the
+// chunks that are a multiple of chunksDim away, so the window is moved by rewriting the entries
+// that leave it only, the mapping is the plain linear index while the window is at the origin
+uint getChunksBufferLinearIndex(ivec3 chunkIndex, uvec3 chunksDim) {
+  const ivec3 dim = ivec3(chunksDim);
+  // the modulo of negative integers is undefined in glsl, the float division is exact for any
+  // reachable chunk index, the remaining rounding is corrected afterwards
+  ivec3 wrapped = chunkIndex - dim * ivec3(floor(vec3(chunkIndex) / vec3(dim)));
+  wrapped += dim * ivec3(lessThan(wrapped, ivec3(0))) - dim * ivec3(greaterThanEqual(wrapped, dim));
+  return uint(wrapped.x + wrapped.y * dim.x + wrapped.z * dim.x * dim.y);
+}
+
+uvec2 makeChunkIndicesEntry(uint octreePage, uint lod, uint octreeBufferOffset) {
+  return uvec2(octreeBufferOffset + 1u, (octreePage << kChunkLodBitCount) | lod);
+}
+
+bool hasChunkOctree(uvec2 chunkIndicesEntry) { return chunkIndicesEntry.x != 0u; }
+
+// the entry must not be empty
+uint getChunkOctreePage(uvec2 chunkIndicesEntry) {
+  return chunkIndicesEntry.y >> kChunkLodBitCount;
+}
+// the leaves of a coarser octree are simply larger, so the traversal itself doesn't need it
+uint getChunkLod(uvec2 chunkIndicesEntry) {
+  return chunkIndicesEntry.y & (kMaxChunkLodCount - 1u);
+}
+uint getChunkOctreeBufferOffset(uvec2 chunkIndicesEntry) { return chunkIndicesEntry.x - 1u; }
+
+// the tight bounds of the voxels of a chunk, in cells of 1 / kChunkBoundsCellDim of the chunk, 5
+// bits per bound, the tracer clips the rays to them before the octree is descended, the upper
+// bounds are counted from the far side, so a zero entry is the whole chunk, which stands for the
+// chunks whose bounds aren't known, like the ones that are loaded by the host
+const uint kChunkBoundsCellDim = 32u;
+uint makeChunkBounds(uvec3 minCell, uvec3 maxCell) {
+  uvec3 farCell = (kChunkBoundsCellDim - 1u) - maxCell;
+  return minCell.x | (minCell.y << 5) | (minCell.z << 10) | (farCell.x << 15) |
+         (farCell.y << 20) | (farCell.z << 25);
+}
+// in [0, 1] of the chunk
+void getChunkBounds(out vec3 oMin, out vec3 oMax, uint chunkBounds) {
+  uvec3 minCell = uvec3(chunkBounds, chunkBounds >> 5, chunkBounds >> 10) & 0x1Fu;
+  uvec3 farCell = uvec3(chunkBounds >> 15, chunkBounds >> 20, chunkBounds >> 25) & 0x1Fu;
+  oMin          = vec3(minCell) / float(kChunkBoundsCellDim);
+  oMax          = vec3(kChunkBoundsCellDim - farCell) / float(kChunkBoundsCellDim);
+}
+
+// the tracer keeps an occupancy bit per cell of chunks, so that the dda over the chunks leaps over
+// the empty cells at once, should also be synchronized with SvoTracer
+const uint kChunkOccupancyCellDim = 4u;
+uvec3 getChunkOccupancyCellsDim(uvec3 chunksDim) {
+  return (chunksDim + kChunkOccupancyCellDim - 1u) / kChunkOccupancyCellDim;
 }
 
 #endif // CHUNK_INDEX_GLSL
@@ -0,0 +1,21 @@
+#ifndef HALF_GLSL
+#define HALF_GLSL
+
+// the weights and the blending of the filters are computed in 16 bits with HALF_PRECISION_FILTERS,
+// which is only defined if the device supports the float16 arithmetic, the values that can exceed
+// the range of a half, the positions and the luminance moments, stay in 32 bits
+#ifdef HALF_PRECISION_FILTERS
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+#define hfloat float16_t
+#define hvec2 f16vec2
+#define hvec3 f16vec3
+#else
+#define hfloat float
+#define hvec2 vec2
+#define hvec3 vec3
+#endif // HALF_PRECISION_FILTERS
+
+// mirrors lum of color.glsl
+hfloat halfLum(hvec3 col) { return dot(col, hvec3(0.2126, 0.7152, 0.0722)); }
+
+#endif // HALF_GLSL
@@ -58,13 +58,25 @@ vec3 hash(vec3 p) // this hash is not production ready, please
 }
 #endif
 
-// return value noise (in x) and its derivatives (in yzw)
-vec4 noised(in vec3 x) {
+// return value noise (in x) and its derivatives (in yzw), the lattice of the gradients wraps every
+// period cells along each axis, so a volume baked over one period tiles, it's the same as noised()
+// within the first period, x is non-negative if it wraps, a period of 0 doesn't wrap
+vec4 noisedWrapped(in vec3 x, int period) {
 // grid
 #if METHOD == 0
-  ivec3 i = ivec3(floor(x));
+  ivec3 i0 = ivec3(floor(x));
+  ivec3 i1 = i0 + 1;
+  if (period > 0) {
+    i0 %= period;
+    i1 %= period;
+  }
 #else
-  vec3 i = floor(x);
+  vec3 i0 = floor(x);
+  vec3 i1 = i0 + 1.0;
+  if (period > 0) {
+    i0 = mod(i0, float(period));
+    i1 = mod(i1, float(period));
+  }
 #endif
   vec3 f = fract(x);
 
@@ -80,23 +92,23 @@ vec4 noised(in vec3 x) {
 
 // gradients
 #if METHOD == 0
-  vec3 ga = hash(i + ivec3(0, 0, 0));
-  vec3 gb = hash(i + ivec3(1, 0, 0));
-  vec3 gc = hash(i + ivec3(0, 1, 0));
-  vec3 gd = hash(i + ivec3(1, 1, 0));
-  vec3 ge = hash(i + ivec3(0, 0, 1));
-  vec3 gf = hash(i + ivec3(1, 0, 1));
-  vec3 gg = hash(i + ivec3(0, 1, 1));
-  vec3 gh = hash(i + ivec3(1, 1, 1));
+  vec3 ga = hash(ivec3(i0.x, i0.y, i0.z));
+  vec3 gb = hash(ivec3(i1.x, i0.y, i0.z));
+  vec3 gc = hash(ivec3(i0.x, i1.y, i0.z));
+  vec3 gd = hash(ivec3(i1.x, i1.y, i0.z));
+  vec3 ge = hash(ivec3(i0.x, i0.y, i1.z));
+  vec3 gf = hash(ivec3(i1.x, i0.y, i1.z));
+  vec3 gg = hash(ivec3(i0.x, i1.y, i1.z));
+  vec3 gh = hash(ivec3(i1.x, i1.y, i1.z));
 #else
-  vec3 ga = hash(i + vec3(0.0, 0.0, 0.0));
-  vec3 gb = hash(i + vec3(1.0, 0.0, 0.0));
-  vec3 gc = hash(i + vec3(0.0, 1.0, 0.0));
-  vec3 gd = hash(i + vec3(1.0, 1.0, 0.0));
-  vec3 ge = hash(i + vec3(0.0, 0.0, 1.0));
-  vec3 gf = hash(i + vec3(1.0, 0.0, 1.0));
-  vec3 gg = hash(i + vec3(0.0, 1.0, 1.0));
-  vec3 gh = hash(i + vec3(1.0, 1.0, 1.0));
+  vec3 ga = hash(vec3(i0.x, i0.y, i0.z));
+  vec3 gb = hash(vec3(i1.x, i0.y, i0.z));
+  vec3 gc = hash(vec3(i0.x, i1.y, i0.z));
+  vec3 gd = hash(vec3(i1.x, i1.y, i0.z));
+  vec3 ge = hash(vec3(i0.x, i0.y, i1.z));
+  vec3 gf = hash(vec3(i1.x, i0.y, i1.z));
+  vec3 gg = hash(vec3(i0.x, i1.y, i1.z));
+  vec3 gh = hash(vec3(i1.x, i1.y, i1.z));
 #endif
 
   // projections
@@ -123,4 +135,6 @@ vec4 noised(in vec3 x) {
                 u.yzx * u.zxy * (-va + vb + vc - vd + ve - vf - vg + vh)));
 }
 
+vec4 noised(in vec3 x) { return noisedWrapped(x, 0); }
+
 #endif // INOISE_GLSL
@@ -0,0 +1,18 @@
+#ifndef SPHERICAL_HARMONICS_GLSL
+#define SPHERICAL_HARMONICS_GLSL
+
+// the real spherical harmonics of the first three bands, in the order of the bands, from -m to m,
+// the direction has to be normalized
+void getShBasis9(out float oBasis[9], vec3 d) {
+  oBasis[0] = 0.282095;
+  oBasis[1] = 0.488603 * d.y;
+  oBasis[2] = 0.488603 * d.z;
+  oBasis[3] = 0.488603 * d.x;
+  oBasis[4] = 1.092548 * d.x * d.y;
+  oBasis[5] = 1.092548 * d.y * d.z;
+  oBasis[6] = 0.315392 * (3.0 * d.z * d.z - 1.0);
+  oBasis[7] = 1.092548 * d.x * d.z;
+  oBasis[8] = 0.546274 * (d.x * d.x - d.y * d.y);
+}
+
+#endif // SPHERICAL_HARMONICS_GLSL
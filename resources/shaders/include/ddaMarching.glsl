@@ -4,22 +4,134 @@
 #include "../include/svoTracerDescriptorSetLayouts.glsl"
 
 #include "../include/chunking.glsl"
+#include "../include/octreeInstance.glsl"
+
+bool _inChunkRange(ivec3 pos, ivec3 rangeBegin, ivec3 rangeEnd) {
+  return all(greaterThanEqual(pos, rangeBegin)) && all(lessThan(pos, rangeEnd));
+}
 
 bool _inChunkRange(ivec3 pos) {
-  return all(greaterThanEqual(pos, ivec3(0))) && all(lessThan(pos, sceneInfoBuffer.data.chunksDim));
+  const ivec3 windowOrigin = renderInfoUbo.data.chunkWindowOrigin;
+  return _inChunkRange(pos, windowOrigin, windowOrigin + ivec3(sceneInfoBuffer.data.chunksDim));
+}
+
+// the chunks that the dda visits, the whole chunk window, or the bounds of the non-empty chunks in
+// a frustum of this frame, see G_ChunkFrustumBounds, false if there's none in them
+bool getChunkRange(out ivec3 oRangeBegin, out ivec3 oRangeEnd, uint chunkFrustum) {
+  const ivec3 windowOrigin = renderInfoUbo.data.chunkWindowOrigin;
+  if (chunkFrustum == kNoChunkFrustum) {
+    oRangeBegin = windowOrigin;
+    oRangeEnd   = windowOrigin + ivec3(sceneInfoBuffer.data.chunksDim);
+    return true;
+  }
+  const uint base       = chunkFrustum * 3u;
+  const uvec3 boundsMin = uvec3(chunkFrustumBoundsBuffer.data.boundsMin[base],
+                                chunkFrustumBoundsBuffer.data.boundsMin[base + 1u],
+                                chunkFrustumBoundsBuffer.data.boundsMin[base + 2u]);
+  const uvec3 boundsMax = uvec3(chunkFrustumBoundsBuffer.data.boundsMax[base],
+                                chunkFrustumBoundsBuffer.data.boundsMax[base + 1u],
+                                chunkFrustumBoundsBuffer.data.boundsMax[base + 2u]);
+  if (any(greaterThan(boundsMin, boundsMax))) {
+    return false;
+  }
+  oRangeBegin = windowOrigin + ivec3(boundsMin);
+  oRangeEnd   = windowOrigin + ivec3(boundsMax) + 1;
+  return true;
+}
+
+// the chunk entries are shared by the lanes like the octree nodes, see loadPacketOctreeNode
+uvec2 loadChunkIndicesEntry(ivec3 chunkIndex, bool isPacket) {
+  uint linearIndex = getChunksBufferLinearIndex(chunkIndex, sceneInfoBuffer.data.chunksDim);
+#ifdef SUBGROUP_PACKET_TRAVERSAL
+  if (isPacket && subgroupAllEqual(linearIndex)) {
+    uvec2 entry = uvec2(0u);
+    if (subgroupElect()) {
+      entry = chunkIndicesBuffer.data[linearIndex];
+    }
+    return subgroupBroadcastFirst(entry);
+  }
+#endif // SUBGROUP_PACKET_TRAVERSAL
+  return chunkIndicesBuffer.data[linearIndex];
+}
+
+// the packed bounds of the voxels of the chunk, see makeChunkBounds
+uint loadChunkBounds(ivec3 chunkIndex, bool isPacket) {
+  uint linearIndex = getChunksBufferLinearIndex(chunkIndex, sceneInfoBuffer.data.chunksDim);
+#ifdef SUBGROUP_PACKET_TRAVERSAL
+  if (isPacket && subgroupAllEqual(linearIndex)) {
+    uint chunkBounds = 0u;
+    if (subgroupElect()) {
+      chunkBounds = chunkBoundsBuffer.data[linearIndex];
+    }
+    return subgroupBroadcastFirst(chunkBounds);
+  }
+#endif // SUBGROUP_PACKET_TRAVERSAL
+  return chunkBoundsBuffer.data[linearIndex];
+}
+
+// a chunk without an octree of its own may still hold prefab instances, or dynamic objects
+bool _hasChunk(ivec3 chunkIndex, bool isPacket) {
+  return hasChunkOctree(loadChunkIndicesEntry(chunkIndex, isPacket)) ||
+         hasChunkInstances(chunkIndex);
+}
+
+bool _isChunkOccupancyCellOccupied(ivec3 chunkIndex) {
+  const uvec3 cellsDim = getChunkOccupancyCellsDim(sceneInfoBuffer.data.chunksDim);
+  const uvec3 cell =
+      uvec3(chunkIndex - renderInfoUbo.data.chunkWindowOrigin) / kChunkOccupancyCellDim;
+  return chunkOccupancyBuffer
+             .data[cell.x + cell.y * cellsDim.x + cell.z * cellsDim.x * cellsDim.y] != 0u;
 }
 
-bool _hasChunk(uvec3 chunkIndex) {
-  return chunkIndicesBuffer
-             .data[getChunksBufferLinearIndex(chunkIndex, sceneInfoBuffer.data.chunksDim)] > 0;
+// moves the dda to the chunk behind the exit face of the empty cell of the chunk
+void _leapOverChunkOccupancyCell(inout ivec3 mapPos, inout vec3 sideDist, ivec3 chunkIndex,
+                                 vec3 deltaDist, vec3 o, vec3 d) {
+  const ivec3 windowOrigin = renderInfoUbo.data.chunkWindowOrigin;
+  const ivec3 windowEnd    = windowOrigin + ivec3(sceneInfoBuffer.data.chunksDim);
+  const ivec3 cellDim      = ivec3(kChunkOccupancyCellDim);
+  const ivec3 cellMin      = windowOrigin + (chunkIndex - windowOrigin) / cellDim * cellDim;
+  const ivec3 cellMax      = min(cellMin + cellDim, windowEnd);
+
+  const vec3 exitPlanes = mix(vec3(cellMin), vec3(cellMax), step(0.0, d));
+  const vec3 exitDists  = (exitPlanes - o) / d;
+  const float exitDist  = min(exitDists.x, min(exitDists.y, exitDists.z));
+  const bvec3 exitMask  = lessThanEqual(exitDists, vec3(exitDist));
+
+  // the exit point can be off by a rounding error, so the axes that don't exit are kept in the
+  // cell, the ones that exit step right behind it
+  const ivec3 exitChunk  = clamp(ivec3(floor(o + d * exitDist)), cellMin, cellMax - 1);
+  const ivec3 behindCell = ivec3(mix(vec3(cellMin - 1), vec3(cellMax), step(0.0, d)));
+  mapPos                 = ivec3(mix(vec3(exitChunk), vec3(behindCell), vec3(exitMask)));
+  sideDist               = (((sign(d) * 0.5) + 0.5) + sign(d) * (vec3(mapPos) - o)) * deltaDist;
 }
 
 #define MAX_DDA_ITERATION 50
 
-// this function if used for continuous raymarching, where we need to save the last hit chunk
+// starts the dda at the chunk where the ray enters the range, so the rays from outside of it don't
+// spend their iterations on the way there, false if the ray misses the range
+bool initDdaMarching(out ivec3 oMapPos, out vec3 oSideDist, ivec3 rangeBegin, ivec3 rangeEnd,
+                     vec3 deltaDist, vec3 o, vec3 d) {
+  const vec3 t0      = (vec3(rangeBegin) - o) / d;
+  const vec3 t1      = (vec3(rangeEnd) - o) / d;
+  const vec3 tNear   = min(t0, t1);
+  const vec3 tFar    = max(t0, t1);
+  const float tEnter = max(max(max(tNear.x, tNear.y), tNear.z), 0.0);
+  const float tExit  = min(min(tFar.x, tFar.y), tFar.z);
+  if (tEnter > tExit) {
+    return false;
+  }
+  // the entry point can be off by a rounding error, like the exit of _leapOverChunkOccupancyCell
+  oMapPos   = clamp(ivec3(floor(o + d * tEnter)), rangeBegin, rangeEnd - 1);
+  oSideDist = (((sign(d) * 0.5) + 0.5) + sign(d) * (vec3(oMapPos) - o)) * deltaDist;
+  return true;
+}
+
+// this function if used for continuous raymarching, where we need to save the last hit chunk, the
+// packets share the chunk entries while their rays step through the same chunks
 bool ddaMarchingWithSave(out ivec3 oChunkIndex, inout ivec3 mapPos, inout vec3 sideDist,
                          inout bool enteredBigBoundingBox, inout uint it, vec3 deltaDist,
-                         ivec3 rayStep, vec3 o, vec3 d) {
+                         ivec3 rayStep, ivec3 rangeBegin, ivec3 rangeEnd, vec3 o, vec3 d,
+                         bool isPacket) {
   bvec3 mask;
   while (it++ < MAX_DDA_ITERATION) {
     mask = lessThanEqual(sideDist.xyz, min(sideDist.yzx, sideDist.zxy));
@@ -28,11 +140,14 @@ bool ddaMarchingWithSave(out ivec3 oChunkIndex, inout ivec3 mapPos, inout vec3 s
     oChunkIndex = mapPos;
     mapPos += ivec3(vec3(mask)) * rayStep;
 
-    if (_inChunkRange(oChunkIndex)) {
+    if (_inChunkRange(oChunkIndex, rangeBegin, rangeEnd)) {
       enteredBigBoundingBox = true;
-      if (_hasChunk(oChunkIndex)) {
+      if (_hasChunk(oChunkIndex, isPacket)) {
         return true;
       }
+      if (!_isChunkOccupancyCellOccupied(oChunkIndex)) {
+        _leapOverChunkOccupancyCell(mapPos, sideDist, oChunkIndex, deltaDist, o, d);
+      }
     }
     // went outside the outer bounding box
     else if (enteredBigBoundingBox) {
@@ -0,0 +1,26 @@
+#ifndef FIELD_BRICKS_GLSL
+#define FIELD_BRICKS_GLSL
+
+#include "../include/svoBuilderDataStructs.glsl"
+
+// the saved fields are always at full detail, so the field covers (voxelResolution + 1)^3 points,
+// the bricks of the last layer stick out of it
+uint getFieldBrickGridDim(uint fieldDim) {
+  return (fieldDim + kFieldBrickDim - 1u) / kFieldBrickDim;
+}
+
+uint getFieldBrickTableIndex(uvec3 brickPos, uint brickGridDim) {
+  return brickPos.x + brickPos.y * brickGridDim + brickPos.z * brickGridDim * brickGridDim;
+}
+
+// the bricks directly follow the table of the field
+uint getFieldBrickOffset(uint tableOffset, uint brickGridDim, uint brickIndex) {
+  return tableOffset + brickGridDim * brickGridDim * brickGridDim + brickIndex * kFieldBrickLength;
+}
+
+uint getFieldBrickPointIndex(uvec3 pointPosInBrick) {
+  return pointPosInBrick.x + pointPosInBrick.y * kFieldBrickDim +
+         pointPosInBrick.z * kFieldBrickDim * kFieldBrickDim;
+}
+
+#endif // FIELD_BRICKS_GLSL
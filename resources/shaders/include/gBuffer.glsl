@@ -0,0 +1,59 @@
+#ifndef G_BUFFER_GLSL
+#define G_BUFFER_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/projection.glsl"
+
+// the world position of a pixel, at the depth along its primary ray, mirrors rayGen of
+// svoTracing.comp, the previous frame may have been rendered at another scale, and with another
+// subpixel offset
+vec3 reconstructWorldPos(ivec2 uvi, float depth, bool previous) {
+  vec2 subpixOffset = vec2(0);
+  if (bool(tweakableParametersUbo.data.taa)) {
+    subpixOffset =
+        previous ? renderInfoUbo.data.subpixOffsetPrev : renderInfoUbo.data.subpixOffset;
+  }
+  vec2 size = previous ? vec2(renderInfoUbo.data.lowResSizePrev)
+                       : vec2(renderInfoUbo.data.lowResSize);
+  vec2 screenSpaceUv = (vec2(uvi) + vec2(0.5) + subpixOffset) / size;
+
+  vec3 o = previous ? renderInfoUbo.data.vMatPrevInv[3].xyz : renderInfoUbo.data.camPosition;
+  vec3 d = normalize(projectScreenUvToWorldCamFarPoint(screenSpaceUv, previous) - o);
+  return o + depth * d;
+}
+
+vec3 loadPosition(ivec2 uvi) {
+#ifdef POSITION_FROM_DEPTH
+  return reconstructWorldPos(uvi, imageLoad(depthImage, uvi).x, false);
+#else
+  return imageLoad(positionImage, uvi).xyz;
+#endif // POSITION_FROM_DEPTH
+}
+
+vec3 loadLastPosition(ivec2 uvi) {
+#ifdef POSITION_FROM_DEPTH
+  return reconstructWorldPos(uvi, imageLoad(lastDepthImage, uvi).x, true);
+#else
+  return imageLoad(lastPositionImage, uvi).xyz;
+#endif // POSITION_FROM_DEPTH
+}
+
+// the same through the sampled views, for the passes that don't write the g-buffer
+vec3 fetchPosition(ivec2 uvi) {
+#ifdef POSITION_FROM_DEPTH
+  return reconstructWorldPos(uvi, texelFetch(depthTexture, uvi, 0).x, false);
+#else
+  return texelFetch(positionTexture, uvi, 0).xyz;
+#endif // POSITION_FROM_DEPTH
+}
+
+vec3 fetchLastPosition(ivec2 uvi) {
+#ifdef POSITION_FROM_DEPTH
+  return reconstructWorldPos(uvi, texelFetch(lastDepthTexture, uvi, 0).x, true);
+#else
+  return texelFetch(lastPositionTexture, uvi, 0).xyz;
+#endif // POSITION_FROM_DEPTH
+}
+
+#endif // G_BUFFER_GLSL
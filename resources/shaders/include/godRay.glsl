@@ -0,0 +1,21 @@
+#ifndef GOD_RAY_GLSL
+#define GOD_RAY_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+// the god rays are marched this far along the primary rays at most
+const float kGodRayMaxRayDepth = 1.0;
+
+// a god ray pixel covers sceneInfo.godRayDownscale low res pixels per axis
+uvec2 getGodRaySize(uvec2 lowResSize) {
+  uint downscale = sceneInfoBuffer.data.godRayDownscale;
+  return (lowResSize + downscale - 1u) / downscale;
+}
+
+// the low res pixel that a god ray pixel samples, the one in the middle of those it covers
+ivec2 getGodRayLowResUvi(ivec2 godRayUvi) {
+  int downscale = int(sceneInfoBuffer.data.godRayDownscale);
+  return min(godRayUvi * downscale + downscale / 2, ivec2(renderInfoUbo.data.lowResSize) - 1);
+}
+
+#endif // GOD_RAY_GLSL
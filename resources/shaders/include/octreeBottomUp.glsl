@@ -0,0 +1,73 @@
+#ifndef OCTREE_BOTTOM_UP_GLSL
+#define OCTREE_BOTTOM_UP_GLSL
+
+#include "../include/svoBuilderDescriptorSetLayouts.glsl"
+
+// the alternative octree builder, the fragments are sorted by their morton codes, then every level
+// of the octree is the list of the distinct codes of the level below shifted by an octant, so the
+// levels are built from the leaves up with a compaction each, no fragment walks down the tree
+
+// the sort and the levels bounce between the fragment list and its scratch list, pass is the radix
+// pass of the sort, or the level step, which writes the nodes of the level below it
+layout(push_constant) uniform OctreeBottomUpPushConstants {
+  uint pass;
+  uint levelCount;
+  uint isSourceFragmentList; // bool
+}
+bottomUpPushConstants;
+
+// interleaves the 10 bits of a coordinate, so that every third bit is one of them
+uint _spreadBits(uint x) {
+  x &= 0x000003FFu;
+  x = (x | (x << 16)) & 0xFF0000FFu;
+  x = (x | (x << 8)) & 0x0300F00Fu;
+  x = (x | (x << 4)) & 0x030C30C3u;
+  x = (x | (x << 2)) & 0x09249249u;
+  return x;
+}
+
+// the octant of a child is x | y << 1 | z << 2, same as the traversal of octreeTagNode.comp
+uint makeMortonCode(uint coordinates) {
+  return _spreadBits(coordinates) | (_spreadBits(coordinates >> 10) << 1) |
+         (_spreadBits(coordinates >> 20) << 2);
+}
+
+G_FragmentListEntry loadSourceEntry(uint i) {
+  return bool(bottomUpPushConstants.isSourceFragmentList) ? fragmentListBuffer.datas[i]
+                                                          : fragmentListScratchBuffer.datas[i];
+}
+
+void storeDestinationEntry(uint i, G_FragmentListEntry entry) {
+  if (bool(bottomUpPushConstants.isSourceFragmentList)) {
+    fragmentListScratchBuffer.datas[i] = entry;
+  } else {
+    fragmentListBuffer.datas[i] = entry;
+  }
+}
+
+// the first radix pass reads the coordinates of the fragments, the others the codes it wrote
+uint getRadixSortKey(G_FragmentListEntry entry) {
+  return bottomUpPushConstants.pass == 0u ? makeMortonCode(entry.coordinates) : entry.coordinates;
+}
+
+uint getRadixDigit(uint sortKey) {
+  return (sortKey >> (bottomUpPushConstants.pass * kRadixBitCount)) & (kRadixBinCount - 1u);
+}
+
+// the level step that reads the fragments only drops the duplicated codes, the following ones drop
+// the octant of the level below
+uint getLevelShift() {
+  return bottomUpPushConstants.pass == bottomUpPushConstants.levelCount ? 0u : 3u;
+}
+
+// the first entry of each distinct key of the level, the sorted entries of a key are contiguous
+bool isRunHead(uint i) {
+  if (i == 0u) {
+    return true;
+  }
+  uint shift = getLevelShift();
+  return (loadSourceEntry(i).coordinates >> shift) !=
+         (loadSourceEntry(i - 1u).coordinates >> shift);
+}
+
+#endif // OCTREE_BOTTOM_UP_GLSL
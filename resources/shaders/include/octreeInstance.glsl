@@ -0,0 +1,69 @@
+#ifndef OCTREE_INSTANCE_GLSL
+#define OCTREE_INSTANCE_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/chunking.glsl"
+#include "../include/octreeNode.glsl"
+
+// an instance of a prefab, or a dynamic object, the octree spans the cube of the instance, it's
+// shared by all of the instances of the prefab, or the objects of the shape, see
+// kOctreeInstanceLength
+struct OctreeInstance {
+  vec3 position; // of the min corner of the cube, in chunks
+  float size;    // of the edge of the cube, in chunks
+  uint octreePage;
+  uint octreeBufferOffset;
+};
+
+uvec2 loadChunkInstancesEntry(ivec3 chunkIndex) {
+  return chunkInstancesBuffer
+      .data[getChunksBufferLinearIndex(chunkIndex, sceneInfoBuffer.data.chunksDim)];
+}
+
+uint getChunkInstanceCount(uvec2 chunkInstancesEntry) {
+  return chunkInstancesEntry.y & kMaxChunkInstanceCount;
+}
+
+// the dynamic objects in the chunk, the offset of their records in the grid and their count
+uvec2 loadChunkDynamicObjectsEntry(ivec3 chunkIndex) {
+  const uint i = 2u * getChunksBufferLinearIndex(chunkIndex, sceneInfoBuffer.data.chunksDim);
+  return uvec2(dynamicObjectGridBuffer.data[i], dynamicObjectGridBuffer.data[i + 1u]);
+}
+
+// the prefab instances and the dynamic objects alike
+bool hasChunkInstances(ivec3 chunkIndex) {
+  return getChunkInstanceCount(loadChunkInstancesEntry(chunkIndex)) != 0u ||
+         loadChunkDynamicObjectsEntry(chunkIndex).y != 0u;
+}
+
+// the entry must have more than i instances
+OctreeInstance loadOctreeInstance(uvec2 chunkInstancesEntry, uint i) {
+  const uint page   = chunkInstancesEntry.y >> kChunkInstanceCountBitCount;
+  const uint offset = chunkInstancesEntry.x + i * kOctreeInstanceLength;
+
+  OctreeInstance instance;
+  instance.position           = uintBitsToFloat(uvec3(loadOctreeNode(page, offset),
+                                                      loadOctreeNode(page, offset + 1u),
+                                                      loadOctreeNode(page, offset + 2u)));
+  instance.size               = uintBitsToFloat(loadOctreeNode(page, offset + 3u));
+  instance.octreePage         = loadOctreeNode(page, offset + 4u);
+  instance.octreeBufferOffset = loadOctreeNode(page, offset + 5u);
+  return instance;
+}
+
+// the entry must have more than i objects, their records have the layout of the instances
+OctreeInstance loadDynamicObjectInstance(uvec2 chunkDynamicObjectsEntry, uint i) {
+  const uint offset = chunkDynamicObjectsEntry.x + i * kOctreeInstanceLength;
+
+  OctreeInstance instance;
+  instance.position           = uintBitsToFloat(uvec3(dynamicObjectGridBuffer.data[offset],
+                                                      dynamicObjectGridBuffer.data[offset + 1u],
+                                                      dynamicObjectGridBuffer.data[offset + 2u]));
+  instance.size               = uintBitsToFloat(dynamicObjectGridBuffer.data[offset + 3u]);
+  instance.octreePage         = dynamicObjectGridBuffer.data[offset + 4u];
+  instance.octreeBufferOffset = dynamicObjectGridBuffer.data[offset + 5u];
+  return instance;
+}
+
+#endif // OCTREE_INSTANCE_GLSL
@@ -0,0 +1,37 @@
+#ifndef OCTREE_NODE_GLSL
+#define OCTREE_NODE_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+// the tracer only reads the octree pages, with OCTREE_TEXEL_BUFFER defined, the nodes are fetched
+// through uniform texel buffer views of the pages, the traversal benchmark compares them with the
+// storage buffers, with OCTREE_DEVICE_ADDRESS defined, the page is dereferenced through its
+// address, which needs no descriptor array, nor a non-uniform index into one
+uint loadOctreeNode(uint octreePage, uint nodeIndex) {
+#if defined(OCTREE_DEVICE_ADDRESS)
+  return OctreePage(octreePageAddressBuffer.data[octreePage]).data[nodeIndex];
+#elif defined(OCTREE_TEXEL_BUFFER)
+  return texelFetch(octreeTexelBuffers[nonuniformEXT(octreePage)], int(nodeIndex)).x;
+#else
+  return octreeBuffers[nonuniformEXT(octreePage)].data[nodeIndex];
+#endif // OCTREE_TEXEL_BUFFER
+}
+
+// the coherent rays of a subgroup walk the same top levels of an octree, with
+// SUBGROUP_PACKET_TRAVERSAL defined by a shader that enables GL_KHR_shader_subgroup_ballot and
+// GL_KHR_shader_subgroup_vote, a single lane fetches the node while all of the active lanes agree
+// on it, and each lane fetches its own once they diverge
+uint loadPacketOctreeNode(uint octreePage, uint nodeIndex) {
+#ifdef SUBGROUP_PACKET_TRAVERSAL
+  if (subgroupAllEqual(uvec2(octreePage, nodeIndex))) {
+    uint node = 0u;
+    if (subgroupElect()) {
+      node = loadOctreeNode(octreePage, nodeIndex);
+    }
+    return subgroupBroadcastFirst(node);
+  }
+#endif // SUBGROUP_PACKET_TRAVERSAL
+  return loadOctreeNode(octreePage, nodeIndex);
+}
+
+#endif // OCTREE_NODE_GLSL
@@ -0,0 +1,103 @@
+#ifndef RADIANCE_CACHE_GLSL
+#define RADIANCE_CACHE_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/core/hash.glsl"
+
+// a world space hash grid of the radiance that leaves the voxels, without their brdf, keyed by the
+// finest voxel and the dominant axis of its normal, the primary hits blend their fresh estimates
+// in, and the indirect rays that hit a cached voxel end there instead of tracing its shadow ray,
+// the cached estimates carry the bounces of the voxels they saw, so the bounces add up over the
+// frames, the entries are found by linear probing, an entry that hasn't been touched for a while
+// is taken over by the next voxel that needs a slot, the updates race with each other, which only
+// loses a sample now and then
+
+const uint kRadianceCacheProbeCount = 8;
+// the frames an entry is kept for without being touched
+const uint kRadianceCacheMaxAge = 64;
+// the indirect rays only end in an entry that has seen this many samples
+const float kRadianceCacheMinSampleCount = 4.0;
+// the history is capped to this many samples, so that the entries follow the changes of the
+// lighting
+const float kRadianceCacheMaxSampleCount = 32.0;
+
+// the home slot of the voxel, and its key, 0 marks an empty entry
+uvec2 _getRadianceCacheSlotAndKey(vec3 position, vec3 normal) {
+  float finestVoxelSize = exp2(1.0 - sceneInfoBuffer.data.voxelLevelCount);
+  ivec3 voxel           = ivec3(floor(position / finestVoxelSize + 0.5));
+
+  vec3 absNormal = abs(normal);
+  uint axis      = absNormal.x > absNormal.y ? (absNormal.x > absNormal.z ? 0u : 2u)
+                                             : (absNormal.y > absNormal.z ? 1u : 2u);
+  uint face      = axis * 2u + uint(normal[axis] < 0.0);
+
+  uvec2 hash = murmurHash24(uvec4(uvec3(voxel), face));
+  return uvec2(hash.x & (sceneInfoBuffer.data.radianceCacheSize - 1u), max(hash.y, 1u));
+}
+
+// an entry that is taken over starts without samples
+bool _findRadianceCacheEntry(out uint oIndex, vec3 position, vec3 normal, bool isInserting) {
+  const uint currentFrame = renderInfoUbo.data.currentSample;
+  uvec2 slotAndKey        = _getRadianceCacheSlotAndKey(position, normal);
+
+  for (uint i = 0; i < kRadianceCacheProbeCount; i++) {
+    oIndex   = (slotAndKey.x + i) & (sceneInfoBuffer.data.radianceCacheSize - 1u);
+    uint key = radianceCacheBuffer.data[oIndex].key;
+    if (key == slotAndKey.y) {
+      return true;
+    }
+
+    uint age = currentFrame - radianceCacheBuffer.data[oIndex].lastFrame;
+    if (!isInserting) {
+      if (key == 0u) {
+        return false;
+      }
+      continue;
+    }
+    if (key != 0u && age <= kRadianceCacheMaxAge) {
+      continue;
+    }
+
+    uint oldKey = atomicCompSwap(radianceCacheBuffer.data[oIndex].key, key, slotAndKey.y);
+    if (oldKey == key) {
+      radianceCacheBuffer.data[oIndex].radiance    = vec3(0.0);
+      radianceCacheBuffer.data[oIndex].sampleCount = 0.0;
+      radianceCacheBuffer.data[oIndex].lastFrame   = currentFrame;
+      return true;
+    }
+    // another voxel took it first, unless it's the same one
+    if (oldKey == slotAndKey.y) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool lookUpRadianceCache(out vec3 oRadiance, vec3 position, vec3 normal) {
+  oRadiance = vec3(0.0);
+
+  uint index;
+  if (!_findRadianceCacheEntry(index, position, normal, false) ||
+      radianceCacheBuffer.data[index].sampleCount < kRadianceCacheMinSampleCount) {
+    return false;
+  }
+  oRadiance                                 = radianceCacheBuffer.data[index].radiance;
+  radianceCacheBuffer.data[index].lastFrame = renderInfoUbo.data.currentSample;
+  return true;
+}
+
+void updateRadianceCache(vec3 position, vec3 normal, vec3 radiance) {
+  uint index;
+  if (!_findRadianceCacheEntry(index, position, normal, true)) {
+    return;
+  }
+  float sampleCount =
+      min(radianceCacheBuffer.data[index].sampleCount + 1.0, kRadianceCacheMaxSampleCount);
+  radianceCacheBuffer.data[index].radiance =
+      mix(radianceCacheBuffer.data[index].radiance, radiance, 1.0 / sampleCount);
+  radianceCacheBuffer.data[index].sampleCount = sampleCount;
+  radianceCacheBuffer.data[index].lastFrame   = renderInfoUbo.data.currentSample;
+}
+
+#endif // RADIANCE_CACHE_GLSL
@@ -24,6 +24,7 @@ const float kWaterBottomHeight = 0.01;
 
 const int ITER_RAYMARCH = 3;
 const int ITER_NORMAL   = 5;
+const int MAX_STEPS     = 64;
 const float SEA_CHOPPY  = 4.0;
 const float SEA_FREQ    = 0.6;
 #define SEA_TIME (1.0 + renderInfoUbo.data.time * 0.2)
@@ -73,6 +74,17 @@ float _getWaveHeight01(vec2 p, uint iterationCount) {
   return h;
 }
 
+// the finer octaves shrink below the pixels, and the normals are flattened with the distance, see
+// traceSeascape, so the water drops an octave and halves its steps every time the distance doubles
+// past this one
+const float kSeaLodDistance = 2.0;
+
+uint _getSeaLod(float t) { return uint(max(0.0, log2(max(t, 1e-6) / kSeaLodDistance))); }
+
+uint _getLodIterationCount(int iterationCount, uint lod) {
+  return uint(max(1, iterationCount - int(lod)));
+}
+
 // ray-plane intersection checker
 float _intersectPlane(vec3 origin, vec3 direction, vec3 point, vec3 normal) {
   return clamp(dot(point - origin, normal) / dot(direction, normal), -1.0, 9991999.0);
@@ -80,18 +92,17 @@ float _intersectPlane(vec3 origin, vec3 direction, vec3 point, vec3 normal) {
 
 // assertion: water must be hit before calling this function
 // raymarches the ray from top water layer boundary to low water layer boundary
-float _raymarchWater(vec3 o, vec3 d) {
-  // calculate intersections and reconstruct positions
-  float tHighPlane = _intersectPlane(o, d, vec3(0.0, kWaterTopHeight, 0.0), vec3(0.0, 1.0, 0.0));
-  float tLowPlane  = _intersectPlane(o, d, vec3(0.0, kWaterBottomHeight, 0.0), vec3(0.0, 1.0, 0.0));
-  vec3 start       = o + tHighPlane * d; // high hit position
-  vec3 end         = o + tLowPlane * d;  // low hit position
+float _raymarchWater(vec3 o, vec3 d, float tHighPlane) {
+  vec3 start = o + tHighPlane * d; // high hit position
 
   float t  = tHighPlane;
   vec3 pos = start;
 
-  for (int i = 0; i < 64; i++) {
-    float h = mix(kWaterBottomHeight, kWaterTopHeight, _getWaveHeight01(pos.xz, ITER_RAYMARCH));
+  uint lod            = _getSeaLod(tHighPlane);
+  uint iterationCount = _getLodIterationCount(ITER_RAYMARCH, lod);
+  uint stepCount      = max(4u, uint(MAX_STEPS) >> lod);
+  for (uint i = 0; i < stepCount; i++) {
+    float h = mix(kWaterBottomHeight, kWaterTopHeight, _getWaveHeight01(pos.xz, iterationCount));
 
     if (h + 1e-3 * t > pos.y) {
       return t;
@@ -107,17 +118,20 @@ float _raymarchWater(vec3 o, vec3 d) {
 
 // calculate normal at point by calculating the height at the pos and 2 additional points very
 // close to pos
-vec3 normalCalc(vec2 pos, float eps) {
+vec3 normalCalc(vec2 pos, float eps, uint iterationCount) {
   vec2 ex     = vec2(eps, 0);
   float depth = kWaterTopHeight - kWaterBottomHeight;
-  float h     = _getWaveHeight01(pos, ITER_NORMAL) * depth;
+  float h     = _getWaveHeight01(pos, iterationCount) * depth;
   vec3 a      = vec3(pos.x, h, pos.y);
   return normalize(
-      cross(a - vec3(pos.x - eps, _getWaveHeight01(pos - ex.xy, ITER_NORMAL) * depth, pos.y),
-            a - vec3(pos.x, _getWaveHeight01(pos + ex.yx, ITER_NORMAL) * depth, pos.y + eps)));
+      cross(a - vec3(pos.x - eps, _getWaveHeight01(pos - ex.xy, iterationCount) * depth, pos.y),
+            a - vec3(pos.x, _getWaveHeight01(pos + ex.yx, iterationCount) * depth, pos.y + eps)));
 }
 
-bool traceSeascape(out vec3 oPosition, out vec3 oNormal, out float oT, vec3 o, vec3 d) {
+// the water beyond tMax is left out, so the callers that know of a closer hit skip the marching,
+// the rays that don't reach the slab between the water layers return before any of it
+bool traceSeascape(out vec3 oPosition, out vec3 oNormal, out float oT, vec3 o, vec3 d,
+                   float tMax) {
   oT        = 1e10;
   oPosition = o + d * oT;
 
@@ -125,11 +139,16 @@ bool traceSeascape(out vec3 oPosition, out vec3 oNormal, out float oT, vec3 o, v
     return false;
   }
 
+  float tHighPlane = _intersectPlane(o, d, vec3(0.0, kWaterTopHeight, 0.0), vec3(0.0, 1.0, 0.0));
+  if (tHighPlane >= tMax) {
+    return false;
+  }
+
   // raymatch water and reconstruct the hit pos
-  float dist       = _raymarchWater(o, d);
+  float dist       = _raymarchWater(o, d, tHighPlane);
   vec3 waterHitPos = o + d * dist;
 
-  vec3 N = normalCalc(waterHitPos.xz, 0.01);
+  vec3 N = normalCalc(waterHitPos.xz, 0.01, _getLodIterationCount(ITER_NORMAL, _getSeaLod(dist)));
 
   oT        = dist;
   oPosition = waterHitPos;
@@ -0,0 +1,50 @@
+#ifndef SHADOW_MAP_VISIBILITY_GLSL
+#define SHADOW_MAP_VISIBILITY_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/projection.glsl"
+#include "../include/skyColor.glsl"
+
+// the sun visibility of a point from the shadow map, 1 if it's lit and 0 if it's in the umbra, -1
+// if the map can't tell, near its depth edges, in the penumbra, or outside of its range
+float classifyShadowMapVisibility(vec3 p) {
+  vec2 shadowMapUv = projectWorldPosToShadowMapUv(p);
+  if (any(lessThan(shadowMapUv, vec2(0.0))) || any(greaterThan(shadowMapUv, vec2(1.0)))) {
+    return -1.0;
+  }
+
+  vec2 texelSize        = 1.0 / vec2(textureSize(shadowMapTexture, 0));
+  vec2 nextTexelUv      = shadowMapUv + vec2(texelSize.x, 0.0);
+  vec3 nearPoint        = projectShadowMapUvToShadowMapCamNearPoint(shadowMapUv);
+  vec3 nextNearPoint    = projectShadowMapUvToShadowMapCamNearPoint(nextTexelUv);
+  float texelWorldSize  = length(nextNearPoint - nearPoint);
+  float dist            = length(nearPoint - p);
+  float finestVoxelSize = exp2(1.0 - sceneInfoBuffer.data.voxelLevelCount);
+
+  float minDepth = 1e10;
+  float maxDepth = 0.0;
+  for (int y = -1; y <= 1; y++) {
+    for (int x = -1; x <= 1; x++) {
+      float depth = textureLod(shadowMapTexture, shadowMapUv + vec2(x, y) * texelSize, 0).r;
+      minDepth    = min(minDepth, depth);
+      maxDepth    = max(maxDepth, depth);
+    }
+  }
+
+  // the map samples the voxels at other points than the surface, so the surface is a few texels
+  // and a voxel off its own depth in the map
+  const float kBiasTexelCount = 4.0;
+  float bias                  = kBiasTexelCount * texelWorldSize + finestVoxelSize;
+  if (minDepth >= dist - bias) {
+    return 1.0;
+  }
+  // the whole neighbourhood is occluded, and the occluders are close enough that the penumbra they
+  // cast is narrower than a texel, so no part of the sun disk gets through
+  if (maxDepth < dist - bias && (dist - minDepth) * kTanSunAngleReal < texelWorldSize) {
+    return 0.0;
+  }
+  return -1.0;
+}
+
+#endif // SHADOW_MAP_VISIBILITY_GLSL
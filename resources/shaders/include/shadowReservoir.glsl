@@ -0,0 +1,98 @@
+#ifndef SHADOW_RESERVOIR_GLSL
+#define SHADOW_RESERVOIR_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/core/color.glsl"
+
+// the resampled importance sampling of the sun and sky shadow rays, a pixel keeps one of the
+// samples it has seen in its reservoir, the samples of its history and of its neighbours are merged
+// in as well, the target of a sample is the luminance of its radiance times the cosine at the
+// pixel, the radiance is shadow tested once, by the pixel that traced it, so the reused samples
+// aren't tested again, which trades a slight bias for not tracing them
+
+// the history is capped to this many samples, so that the reservoirs follow the changes of the
+// lighting
+const float kShadowReservoirMaxSampleCount = 20.0;
+
+// a reservoir while it's being built, its weight sum becomes the weight of G_ShadowReservoir
+struct ShadowReservoirBuilder {
+  vec3 dir;
+  vec3 radiance;
+  float weightSum;
+  float sampleCount;
+};
+
+uint getShadowReservoirIndex(ivec2 uvi, uvec2 size) { return uint(uvi.y) * size.x + uint(uvi.x); }
+
+float getShadowSampleTarget(vec3 dir, vec3 radiance, vec3 normal) {
+  return lum(radiance) * max(dot(dir, normal), 0.0);
+}
+
+void initShadowReservoir(out ShadowReservoirBuilder oReservoir) {
+  oReservoir.dir         = vec3(0.0);
+  oReservoir.radiance    = vec3(0.0);
+  oReservoir.weightSum   = 0.0;
+  oReservoir.sampleCount = 0.0;
+}
+
+// rand ranges from 0 to 1
+void _updateShadowReservoir(inout ShadowReservoirBuilder reservoir, vec3 dir, vec3 radiance,
+                            float weight, float sampleCount, float rand) {
+  reservoir.weightSum += weight;
+  reservoir.sampleCount += sampleCount;
+  if (weight > 0.0 && rand * reservoir.weightSum < weight) {
+    reservoir.dir      = dir;
+    reservoir.radiance = radiance;
+  }
+}
+
+// a fresh sample of the pixel, with the pdf it was drawn with
+void addShadowSample(inout ShadowReservoirBuilder reservoir, vec3 dir, vec3 radiance, float pdf,
+                     vec3 normal, float rand) {
+  float weight = getShadowSampleTarget(dir, radiance, normal) / pdf;
+  _updateShadowReservoir(reservoir, dir, radiance, weight, 1.0, rand);
+}
+
+// the sample of another reservoir is weighted by its target at the receiving pixel
+void mergeShadowReservoir(inout ShadowReservoirBuilder reservoir, G_ShadowReservoir other,
+                          vec3 normal, float rand) {
+  float sampleCount = min(other.sampleCount, kShadowReservoirMaxSampleCount);
+  float target      = getShadowSampleTarget(other.dir, other.radiance, normal);
+  float weight      = target * other.weight * sampleCount;
+  _updateShadowReservoir(reservoir, other.dir, other.radiance, weight, sampleCount, rand);
+}
+
+G_ShadowReservoir finalizeShadowReservoir(ShadowReservoirBuilder reservoir, vec3 normal,
+                                          vec3 brdf) {
+  float target           = getShadowSampleTarget(reservoir.dir, reservoir.radiance, normal);
+  float weightNormalizer = reservoir.sampleCount * target;
+
+  G_ShadowReservoir finalized;
+  finalized.dir         = reservoir.dir;
+  finalized.weight      = weightNormalizer > 0.0 ? reservoir.weightSum / weightNormalizer : 0.0;
+  finalized.radiance    = reservoir.radiance;
+  finalized.sampleCount = reservoir.sampleCount;
+  finalized.brdf        = brdf;
+  finalized.isValid     = 1u;
+  return finalized;
+}
+
+G_ShadowReservoir makeInvalidShadowReservoir() {
+  G_ShadowReservoir reservoir;
+  reservoir.dir         = vec3(0.0);
+  reservoir.weight      = 0.0;
+  reservoir.radiance    = vec3(0.0);
+  reservoir.sampleCount = 0.0;
+  reservoir.brdf        = vec3(0.0);
+  reservoir.isValid     = 0u;
+  return reservoir;
+}
+
+// the direct light of the pixel without its brdf, a single fresh sample gives the estimate of
+// computeRawSurfaceCol
+vec3 getShadowReservoirRadiance(G_ShadowReservoir reservoir, vec3 normal) {
+  return reservoir.radiance * max(dot(reservoir.dir, normal), 0.0) * reservoir.weight;
+}
+
+#endif // SHADOW_RESERVOIR_GLSL
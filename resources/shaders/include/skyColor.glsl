@@ -5,6 +5,7 @@
 
 #include "../include/atmosCommon.glsl"
 #include "../include/core/postProcessing.glsl"
+#include "../include/core/sphericalHarmonics.glsl"
 #include "../include/random.glsl"
 
 const float kSunAngleReal    = 0.016;
@@ -69,4 +70,29 @@ vec3 skyColor(vec3 rayDir, bool isSunAdded) {
   return skyCol;
 }
 
+// the sky without the sun from its spherical harmonics, see skyRadianceSh.comp, it's smooth, so the
+// indirect rays that miss are less noisy with it, and it doesn't sample the luts
+vec3 shSkyColor(vec3 rayDir) {
+  float basis[kSkyShCoeffCount];
+  getShBasis9(basis, rayDir);
+  vec3 radiance = vec3(0.0);
+  for (uint c = 0; c < kSkyShCoeffCount; c++) {
+    const vec3 coeff = vec3(skyRadianceShBuffer.data.coeffs[c * 3],
+                            skyRadianceShBuffer.data.coeffs[c * 3 + 1],
+                            skyRadianceShBuffer.data.coeffs[c * 3 + 2]);
+    radiance += coeff * basis[c];
+  }
+  // the bands ring around the bright horizon, so the radiance can turn negative, the scale of
+  // skyColor is left out of the projection
+  return max(radiance, vec3(0.0)) * pow(vec3(30.0 * environmentUbo.data.atmosLuminance), vec3(1.3));
+}
+
+// the sky without the sun for the indirect rays that miss
+vec3 indirectSkyColor(vec3 rayDir) {
+  if (tweakableParametersUbo.data.indirectSkySh != 0u) {
+    return shSkyColor(rayDir);
+  }
+  return skyColor(rayDir, false);
+}
+
 #endif // SKY_COLOR_GLSL
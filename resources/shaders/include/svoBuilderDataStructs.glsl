@@ -3,14 +3,72 @@
 
 struct G_ChunksInfo {
   uvec3 chunksDim;
-  uvec3 currentlyWritingChunk;
+  // in world chunks, the chunk indices buffer wraps around (see chunking.glsl)
+  ivec3 currentlyWritingChunk;
+  uint islandFalloff; // bool, the streamed terrain is endless, so it has no island shape
+  // the octree of a chunk at level n is built at chunkVoxelDim / 2^n, see G_FragmentListInfo
+  uint lod;
 };
 
+// the fields of the freshly generated chunks of several build slots are constructed by a single
+// dispatch, with an entry per chunk, the field images are indexed by the slot, this is valid in
+// both glsl and c++
+const uint kMaxFieldBatchSize = 8;
+
+// the lowest octaves of the terrain noise can be sampled from a volume of the gradient noise, baked
+// over a lattice that wraps every kNoiseVolumeLatticeDim cells, with kNoiseVolumeTexelsPerCell
+// texels per cell along each axis, see chunkFieldNoise.glsl, this is valid in both glsl and c++
+const uint kNoiseVolumeLatticeDim    = 32;
+const uint kNoiseVolumeTexelsPerCell = 4;
+
+struct G_FieldBatchEntry {
+  ivec3 chunkIndex;
+  uint slotIndex;
+  uint voxelResolution;
+};
+
+struct G_FieldBatchInfo {
+  uvec3 chunksDim;
+  uint islandFalloff; // bool
+  // the depth of the slab of an entry in the dispatch, the field dim rounded up to the workgroup
+  uint fieldDispatchDim;
+  uint entryCount;
+  G_FieldBatchEntry entries[kMaxFieldBatchSize];
+};
+
+// the operations and the shapes of an edit, this is valid in both glsl and c++
+const uint kChunkEditingOperationDeletion    = 0;
+const uint kChunkEditingOperationAddition    = 1;
+const uint kChunkEditingOperationSmoothUnion = 2;
+const uint kChunkEditingOperationFill        = 3;
+
+const uint kChunkEditingShapeSphere   = 0;
+const uint kChunkEditingShapeBox      = 1;
+const uint kChunkEditingShapeCylinder = 2;
+
+// an edit is a shape grown by its radius, the grown sphere is a point, the box spans the half
+// extent, the cylinder stands upright with the radius x and the half height y of the half extent,
+// additions and deletions fade out from the shape to the end of the radius and are scaled by the
+// strength, a smooth union blends the grown shape into the field over the smoothness, a fill sets
+// the block type of the grown shape, an empty block type carves it out instead
 struct G_ChunkEditingInfo {
   vec3 pos;
   float radius;
+  vec3 halfExtent;
   float strength;
-  uint operation; // 0: deletion, 1: addition
+  uint operation;
+  uint shape;
+  float smoothness;
+  uint blockType; // of the points the edit makes solid
+};
+
+// edits that hit the same chunk are accumulated, and applied in a single field modification pass,
+// this is valid in both glsl and c++
+const uint kMaxChunkEditingStampCount = 64;
+
+struct G_ChunkEditingBatch {
+  uint stampCount;
+  G_ChunkEditingInfo stamps[kMaxChunkEditingStampCount];
 };
 
 struct G_FragmentListEntry {
@@ -29,9 +87,95 @@ struct G_IndirectDispatchInfo {
   uint dispatchZ;
 };
 
+// the chunk octrees are spread over several buffer pages, which are created on demand, a chunk
+// indices entry is two words, the offset in the page plus one, zero is left for the empty chunks,
+// and the page above the level of detail of the octree (see chunking.glsl), so the offsets take a
+// whole word, and the size of a page is only bound by the storage buffer range, the child pointers
+// are relative to the octree of their chunk, so they never need more than their 30 bits
+const uint kMaxOctreePageCount = 8;
+const uint kChunkLodBitCount   = 2;
+const uint kMaxChunkLodCount   = 1u << kChunkLodBitCount;
+
+// the prefabs of an imported scene have their octrees stored once in the pages, a chunk that they
+// overlap has a table of their instances in the pages too, its chunk instances entry is two words,
+// the offset of the table in the page, and the page above the instance count, a zero count stands
+// for the chunks without instances, an instance is kOctreeInstanceLength words, the min corner and
+// the edge of its cube, in chunks, as float bits, and the page and the offset of its prefab octree,
+// see octreeInstance.glsl
+const uint kOctreeInstanceLength       = 6;
+const uint kChunkInstanceCountBitCount = 16;
+const uint kMaxChunkInstanceCount      = (1u << kChunkInstanceCountBitCount) - 1u;
+
+// the octree of a chunk is written straight into this speculative reservation of an octree buffer
+// page, if it doesn't fit, the copy is skipped and the host retries with the exact length
+struct G_OctreeReservationInfo {
+  uint octreePage;
+  uint octreeBufferOffset; // in uint32
+  uint reservedLength;     // in uint32
+};
+
+// the state of the bottom-up octree build between its level steps, see octreeBottomUp.glsl, a step
+// compacts the sorted entries of the level below into the distinct keys of its level, and writes
+// the nodes of the level below into the groups of their parents
+struct G_OctreeBottomUpInfo {
+  uint sourceCount;
+  uint blockCount; // of kBottomUpBlockSize entries
+  uint resultCount;
+  // in uint32, of the node groups written by the step, and of the child groups of those nodes, the
+  // groups of the deepest level follow the root group, the ones of the levels above come after
+  uint groupBase;
+  uint childGroupBase;
+};
+
+// the bottom-up kernels work on blocks of this many entries, the radix sort takes this many bits
+// per pass, and the block histograms have a bin per digit, this is valid in both glsl and c++
+const uint kBottomUpBlockSize = 64;
+const uint kRadixBitCount     = 4;
+const uint kRadixBinCount     = 1u << kRadixBitCount;
+
 struct G_FragmentListInfo {
   uint voxelResolution;
+  // every fragment is counted, the ones past the capacity of the fragment list are dropped, the
+  // host grows the list and retries then, see chunkModifyArg.comp
   uint voxelFragmentCount;
+  uint fragmentListCapacity;
+  // fragments are only generated within this region of the chunk, in voxels, edits narrow it down
+  // to the region the brush stamps can reach
+  uvec3 regionOffset;
+  uvec3 regionExtent;
+  // the bounds of the fragments of the chunk, in voxels, inclusive, the minimum starts above the
+  // maximum, the fragments uploaded by the host leave them so, see chunkIndicesBufferUpdater.comp
+  uint fragmentBoundsMin[3];
+  uint fragmentBoundsMax[3];
+};
+
+// the fragment list of an edited chunk is kept in the saved fragment list buffer, so the following
+// edits only regenerate the fragments of their region, the rest is loaded from the saved list, the
+// list is then stored again if it fits into the reservation, offsets and counts are in entries
+struct G_FragmentListSaveInfo {
+  uint loadOffset;
+  uint loadCount;
+  uint storeOffset;
+  uint storeCapacity;
+};
+
+// the field of an edited chunk is kept sparsely in the field brick pool buffer, the field is split
+// into bricks of kFieldBrickDim^3 points, and a table with one entry per brick comes first, an
+// entry either holds the packed value of a uniform brick, flagged by kFieldBrickUniformBit, or the
+// index of the brick in the bricks that follow the table, only the bricks around the surface are
+// stored that way, two 16 bit field points are packed into a uint32, this is valid in both glsl
+// and c++
+const uint kFieldBrickDim        = 8;
+const uint kFieldBrickLength     = kFieldBrickDim * kFieldBrickDim * kFieldBrickDim / 2;
+const uint kFieldBrickUniformBit = 0x80000000u;
+const uint kFieldBrickValueMask  = 0xFFFFu;
+
+// the saved field of the chunk is loaded from the load table, and stored again right after the
+// edit, the store pass allocates its bricks by counting up brickCount, offsets are in uint32
+struct G_FieldBrickSaveInfo {
+  uint loadTableOffset;
+  uint storeTableOffset;
+  uint brickCount;
 };
 
 #endif // SVO_BUILDER_DATA_STRUCTS_GLSL
\ No newline at end of file
@@ -7,7 +7,7 @@
 
 layout(binding = 0) uniform uimage3D chunkFieldImage;
 
-layout(std430, binding = 1) buffer ChunkIndicesBuffer { uint data[]; }
+layout(std430, binding = 1) buffer ChunkIndicesBuffer { uvec2 data[]; }
 chunkIndicesBuffer;
 layout(std430, binding = 2) writeonly buffer IndirectFragLengthBuffer {
   G_IndirectDispatchInfo data;
@@ -29,10 +29,51 @@ layout(std430, binding = 9) buffer ChunksInfoBuffer { G_ChunksInfo data; }
 chunksInfoBuffer;
 layout(std430, binding = 10) buffer OctreeBufferLengthBuffer { uint data; }
 octreeBufferLengthBuffer;
-layout(std430, binding = 11) buffer OctreeBufferWriteOffsetBuffer { uint data; }
-octreeBufferWriteOffsetBuffer;
+layout(std430, binding = 11) buffer OctreeReservationInfoBuffer { G_OctreeReservationInfo data; }
+octreeReservationInfoBuffer;
 
-layout(std430, binding = 12) buffer ChunkEditingInfo { G_ChunkEditingInfo data; }
-chunkEditingInfo;
+layout(std430, binding = 12) buffer ChunkEditingBatch { G_ChunkEditingBatch data; }
+chunkEditingBatch;
+
+// indexed by the page of the reservation, which is the same for the whole dispatch
+layout(std430, binding = 13) buffer AppendedOctreeBuffer { uint data[]; }
+appendedOctreeBuffers[kMaxOctreePageCount];
+
+layout(std430, binding = 14) buffer SavedFragmentListBuffer { G_FragmentListEntry datas[]; }
+savedFragmentListBuffer;
+
+layout(std430, binding = 15) buffer FragmentListSaveInfoBuffer { G_FragmentListSaveInfo data; }
+fragmentListSaveInfoBuffer;
+
+layout(std430, binding = 16) buffer FieldBrickPoolBuffer { uint data[]; }
+fieldBrickPoolBuffer;
+
+layout(std430, binding = 17) buffer FieldBrickSaveInfoBuffer { G_FieldBrickSaveInfo data; }
+fieldBrickSaveInfoBuffer;
+
+// the bottom-up octree build, the scratch list takes turns with the fragment list, the block sums
+// hold the counts of every block, then their exclusive scan
+layout(std430, binding = 18) buffer FragmentListScratchBuffer { G_FragmentListEntry datas[]; }
+fragmentListScratchBuffer;
+layout(std430, binding = 19) buffer OctreeBlockSumBuffer { uint data[]; }
+octreeBlockSumBuffer;
+layout(std430, binding = 20) buffer OctreeBottomUpInfoBuffer { G_OctreeBottomUpInfo data; }
+octreeBottomUpInfoBuffer;
+
+// the batched field construction, the same for every build slot, see G_FieldBatchInfo
+layout(binding = 21) uniform uimage3D batchedChunkFieldImages[kMaxFieldBatchSize];
+layout(std430, binding = 22) buffer FieldBatchInfoBuffer { G_FieldBatchInfo data; }
+fieldBatchInfoBuffer;
+
+// the value and the derivatives of the wrapped gradient noise, baked by noiseVolumeBake.comp, and
+// filtered with the repeat addressing by the field construction
+#ifdef BAKED_NOISE_OCTAVE_COUNT
+layout(binding = 23, rgba16f) uniform writeonly image3D noiseVolumeImage;
+layout(binding = 24) uniform sampler3D noiseVolumeTexture;
+#endif // BAKED_NOISE_OCTAVE_COUNT
+
+// the packed bounds of the chunks, next to their chunk indices entries, see makeChunkBounds
+layout(std430, binding = 25) buffer ChunkBoundsBuffer { uint data[]; }
+chunkBoundsBuffer;
 
 #endif // SVO_BUILDER_DESCRIPTOR_SET_GLSL
\ No newline at end of file
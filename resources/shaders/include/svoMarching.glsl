@@ -5,26 +5,22 @@
 
 #include "../include/blockColor.glsl"
 #include "../include/blockType.glsl"
+#include "../include/octreeNode.glsl"
+#include "../include/svoStack.glsl"
 
+// mirrors compressNormal of chunkVoxelCreation.comp
 vec3 decompressNormal(uint packed) {
-  // extract the components
-  uvec3 quantized;
-  quantized.r = packed & 0x7F;
-  quantized.g = (packed >> 7) & 0x7F;
-  quantized.b = (packed >> 14) & 0x7F;
+  vec2 p = vec2(packed & 0x3F, (packed >> 6) & 0x3F) / 62.0 * 2.0 - 1.0;
 
-  // convert back to [-1, 1] range
-  vec3 normal = vec3(quantized) / 127.0 * 2.0 - 1.0;
-
-  return normal;
+  // unfold the lower hemisphere of the octahedron
+  vec3 normal = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+  if (normal.z < 0.0) {
+    normal.xy = (1.0 - abs(normal.yx)) * vec2(normal.x >= 0.0 ? 1.0 : -1.0,
+                                              normal.y >= 0.0 ? 1.0 : -1.0);
+  }
+  return normalize(normal);
 }
 
-const uint STACK_SIZE = 23;
-struct StackItem {
-  uint node;
-  float t_max;
-} stack[STACK_SIZE + 1];
-
 // this algorithm is from here:
 // https://research.nvidia.com/sites/default/files/pubs/2010-02_Efficient-Sparse-Voxel/laine2010tr1_paper.pdf
 
@@ -39,10 +35,13 @@ struct StackItem {
 // 3. all eight childrens are stored if at least one is active, so the parent node masks only need
 // two bits (isLeaf and hasChild), this is different from the paper, which needs 16 bits for
 // that
+// 4. the packets of coherent rays share the node fetches while they agree on the nodes, see
+// loadPacketOctreeNode
 
 bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPosition,
                  out vec3 oNextTracingPosition, out vec3 oNormal, out uint oVoxHash,
-                 out bool oLightSourceHit, vec3 o, vec3 d, uint chunkBufferOffset) {
+                 out bool oLightSourceHit, vec3 o, vec3 d, uint octreePage,
+                 uint chunkBufferOffset, bool isPacket) {
   uint parent  = 0;
   uint iter    = 0;
   uint voxHash = 0;
@@ -74,6 +73,7 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
     idx ^= 4u, pos.z = 1.5f;
   }
 
+  svoStackInit();
   uint scale       = STACK_SIZE - 1;
   float scale_exp2 = 0.5;
 
@@ -82,7 +82,10 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
 
     // parent pointer is the address of first largest sub-octree (8 in total) of the parent
     voxHash = parent + (idx ^ oct_mask);
-    if (cur == 0u) cur = octreeBuffer.data[voxHash + chunkBufferOffset];
+    if (cur == 0u) {
+      cur = isPacket ? loadPacketOctreeNode(octreePage, voxHash + chunkBufferOffset)
+                     : loadOctreeNode(octreePage, voxHash + chunkBufferOffset);
+    }
 
     vec3 t_corner = pos * t_coef - t_bias;
     float tc_max  = min(min(t_corner.x, t_corner.y), t_corner.z);
@@ -99,8 +102,7 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
 
         // PUSH
         if (tc_max < h) {
-          stack[scale].node  = parent;
-          stack[scale].t_max = t_max;
+          svoStackPush(scale, parent, t_max);
         }
         h = tc_max;
 
@@ -145,8 +147,8 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
       scale_exp2 = uintBitsToFloat((scale - STACK_SIZE + 127u) << 23u); // exp2f(scale - s_max)
 
       // restore parent voxel from the stack
-      parent = stack[scale].node;
-      t_max  = stack[scale].t_max;
+      svoStackPop(parent, t_max, scale, pos, t_coef, t_bias, oct_mask, octreePage,
+                  chunkBufferOffset);
 
       // round cube position and extract child slot index
       uint shx = floatBitsToUint(pos.x) >> scale;
@@ -184,16 +186,16 @@ bool svoMarching(out float oT, out uint oIter, out vec3 oColor, out vec3 oPositi
   // oNormal = norm;
 
   // scale_exp2 is the length of the edges of the voxel
-  oNormal = decompressNormal((cur & 0x1FFFFF00u) >> 8);
+  oNormal = decompressNormal((cur & 0x000FFF00u) >> 8);
 
   oNextTracingPosition = pos + scale_exp2 * 0.5 + 0.87 * scale_exp2 * oNormal;
   // oNextTracingPosition = oPosition + 1e-7 * norm;
 
   oLightSourceHit = false;
 
-  uint blockType = cur & 0xFF;
+  uint paletteIndex = cur & 0xFF;
 
-  oColor = getBlockColor(blockType);
+  oColor = getPaletteColor(paletteIndex);
   // oColor = oNormal * 0.5 + 0.5;
 
   oIter    = iter;
@@ -0,0 +1,82 @@
+#ifndef SVO_STACK_GLSL
+#define SVO_STACK_GLSL
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+#include "../include/octreeNode.glsl"
+
+const uint STACK_SIZE = 23;
+
+// the traversal stack of the octree marching, the parent of the cubes of a scale is kept at that
+// scale, with SVO_SHORT_STACK_SIZE defined, only the parents of the last few scales are kept, in a
+// ring tagged with their scales, the ones that fell out of it are found again by descending from
+// the root, see svoStackPop
+#ifdef SVO_SHORT_STACK_SIZE
+struct StackItem {
+  uint node;
+  float t_max;
+  uint scale;
+} stack[SVO_SHORT_STACK_SIZE];
+#else
+struct StackItem {
+  uint node;
+  float t_max;
+} stack[STACK_SIZE + 1];
+#endif // SVO_SHORT_STACK_SIZE
+
+void svoStackInit() {
+#ifdef SVO_SHORT_STACK_SIZE
+  for (uint slot = 0; slot < SVO_SHORT_STACK_SIZE; slot++) {
+    stack[slot].scale = STACK_SIZE;
+  }
+#endif // SVO_SHORT_STACK_SIZE
+}
+
+void svoStackPush(uint scale, uint node, float t_max) {
+#ifdef SVO_SHORT_STACK_SIZE
+  uint slot         = scale % SVO_SHORT_STACK_SIZE;
+  stack[slot].node  = node;
+  stack[slot].t_max = t_max;
+  stack[slot].scale = scale;
+#else
+  stack[scale].node  = node;
+  stack[scale].t_max = t_max;
+#endif // SVO_SHORT_STACK_SIZE
+}
+
+// only the bits of pos above scale are used, so it doesn't have to be rounded yet, the rest is the
+// setup of the traversal
+void svoStackPop(out uint oNode, out float oTMax, uint scale, vec3 pos, vec3 t_coef, vec3 t_bias,
+                 uint oct_mask, uint octreePage, uint chunkBufferOffset) {
+#ifdef SVO_SHORT_STACK_SIZE
+  uint slot = scale % SVO_SHORT_STACK_SIZE;
+  if (stack[slot].scale == scale) {
+    oNode = stack[slot].node;
+    oTMax = stack[slot].t_max;
+    return;
+  }
+
+  // the ancestors of the cube are the ones the ray descended through, so they all have children
+  const uvec3 posBits = floatBitsToUint(pos);
+  uint node           = 0;
+  for (uint level = STACK_SIZE - 1; level > scale; level--) {
+    uvec3 childBits = (posBits >> level) & 1u;
+    uint idx        = childBits.x | (childBits.y << 1u) | (childBits.z << 2u);
+    uint voxHash    = node + (idx ^ oct_mask);
+    uint cur        = loadOctreeNode(octreePage, voxHash + chunkBufferOffset);
+    node            = cur & 0x3FFFFFFFu;
+  }
+  oNode = node;
+
+  // the span of the parent ends where the ray leaves its cube
+  const uint parentScale = scale + 1u;
+  vec3 parentPos         = uintBitsToFloat((posBits >> parentScale) << parentScale);
+  vec3 t_corner          = parentPos * t_coef - t_bias;
+  oTMax                  = min(min(t_corner.x, t_corner.y), t_corner.z);
+#else
+  oNode = stack[scale].node;
+  oTMax = stack[scale].t_max;
+#endif // SVO_SHORT_STACK_SIZE
+}
+
+#endif // SVO_STACK_GLSL
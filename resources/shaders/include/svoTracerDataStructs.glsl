@@ -5,6 +5,7 @@ struct G_RenderInfo {
   vec3 camPosition;
   vec3 shadowMapCamPosition;
   vec2 subpixOffset;
+  vec2 subpixOffsetPrev;
   mat4 vMat;
   mat4 vMatInv;
   mat4 vMatPrev;
@@ -19,13 +20,23 @@ struct G_RenderInfo {
   mat4 vpMatPrevInv;
   mat4 vpMatShadowMapCam;
   mat4 vpMatShadowMapCamInv;
+  // the rendered part of the low res images, it only differs from their size with the dynamic
+  // resolution, the history images hold the previous one
   uvec2 lowResSize;
   vec2 lowResSizeInv;
+  uvec2 lowResSizePrev;
   uvec2 highResSize;
   vec2 highResSizeInv;
   float vfov;
   uint currentSample;
   float time;
+  // the world chunk at the lowest corner of the chunk window, it only moves while streaming
+  ivec3 chunkWindowOrigin;
+  // the voxel depths of the last frame still hold for the octrees of this one
+  uint isLastVoxelDepthReprojected; // bool
+  // the frames since the camera, the chunks, the render size or the tweaking last changed, 0 for
+  // a frame that changed
+  uint staticFrameCount;
 };
 
 struct G_EnvironmentInfo {
@@ -45,22 +56,43 @@ struct G_TweakableParameters {
   uint debugI1;
   vec3 debugC1;
   float explosure;
-  uint visualizeChunks;  // bool
-  uint visualizeOctree;  // bool
-  uint beamOptimization; // bool
-  uint traceIndirectRay; // bool
-  uint taa;              // bool
+  uint visualizeChunks;              // bool
+  uint visualizeOctree;              // bool
+  uint beamOptimization;             // bool
+  uint traceIndirectRay;             // bool
+  uint taa;                          // bool
+  uint useRayQuery;                  // bool
+  uint wavefrontTracing;             // bool
+  uint wavefrontRayBinning;          // bool
+  uint shadowResampling;             // bool
+  uint shadowResamplingCheckerboard; // bool
+  uint shadowMapVisibility;          // bool
+  uint radianceCache;                // bool
+  uint traversalStatistics;          // bool
+  uint indirectSkySh;                // bool
 };
 
 struct G_SceneInfo {
   uint beamResolution;
   uint voxelLevelCount;
   uvec3 chunksDim;
+  // a power of two
+  uint radianceCacheSize;
+  // a pixel updates the radiance cache once every this many frames
+  uint radianceCacheUpdateInterval;
+  // a god ray pixel covers this many low res pixels per axis
+  uint godRayDownscale;
+  // the pixels take turns at sampling their shadow and indirect rays, 1, 2 or 4
+  uint tracingInterleave;
 };
 
 struct G_TemporalFilterInfo {
   float temporalAlpha;
   float temporalPositionPhi;
+  // a pixel is converged once it has been sampled in this many still frames, and the relative
+  // noise of its temporal mean is within the tolerance, with SvoTracer.adaptiveSampling
+  float convergedSampleCount;
+  float convergedNoiseTolerance;
 };
 
 struct G_SpatialFilterInfo {
@@ -72,6 +104,77 @@ struct G_SpatialFilterInfo {
   float maxPhiZ;
   float phiZStableSampleCount;
   uint changingLuminancePhi; // bool
+  // the relative noise of the temporal mean that a tile is filtered down to, with
+  // SvoTracer.aTrousAdaptive
+  float aTrousNoiseTolerance;
+};
+
+// with SvoTracer.aTrousAdaptive, the temporal filter queues every tile for the a-trous iterations
+// it needs, see temporalFilter.comp
+const uint kATrousMaxIterationCount = 5;
+// a group of the temporal filter, of the a-trous iterations and of the tracing covers a tile of
+// this many pixels per axis
+const uint kFilterTileSize = 8;
+// marks a tile that only copies its color, after the last iteration that it needs
+const uint kATrousCopyTileBit = 1u << 31u;
+
+struct G_ATrousTileListInfo {
+  // the indirect dispatch of the list comes first, a group per tile
+  uint dispatchX;
+  uint dispatchY;
+  uint dispatchZ;
+  uint padding;
+};
+
+// the wavefront tracing keeps the rays between its bounces in these queues, instead of tracing all
+// of them in the invocation of their pixel
+const uint kWavefrontRayQueueCount = 2;
+const uint kIndirectRayQueue       = 0;
+const uint kShadowRayQueue         = 1;
+
+struct G_WavefrontQueueInfo {
+  // the indirect dispatch of the queue comes first, see wavefrontQueueArg.comp
+  uint dispatchX;
+  uint dispatchY;
+  uint dispatchZ;
+  uint rayCount;
+};
+
+// the radiance of a queued ray is its weight times what it sees, stored to the slot of its pixel
+struct G_WavefrontRay {
+  vec3 origin;
+  uint pixel;
+  vec3 dir;
+  uint radianceSlot;
+  vec3 weight;
+  // the indirect rays keep the shadow ray dir of their pixel for the shadow ray of their hit
+  vec3 shadowDirReuse;
+};
+
+// the queued rays of a pixel write to different slots, so they never race on it
+struct G_WavefrontPixel {
+  vec3 directRadiance;
+  uint isQueued; // bool
+  vec3 indirectRadiance;
+};
+
+// a reservoir of the sun and sky shadow rays of a pixel, its sample keeps the radiance it found,
+// shadowed or not, the brdf of the pixel comes along for the resolve
+struct G_ShadowReservoir {
+  vec3 dir;
+  float weight;
+  vec3 radiance;
+  float sampleCount;
+  vec3 brdf;
+  uint isValid; // bool
+};
+
+// an entry of the radiance cache, see radianceCache.glsl
+struct G_RadianceCacheEntry {
+  vec3 radiance;
+  uint key;
+  uint lastFrame;
+  float sampleCount;
 };
 
 struct G_OutputInfo {
@@ -79,4 +182,78 @@ struct G_OutputInfo {
   uint midRayHit; // bool
 };
 
+// the sums over the rays of a traversal benchmark batch, see traversalBenchmark.comp, they're reset
+// before every batch, so they fit in uints
+struct G_TraversalStats {
+  uint rayCount;
+  uint hitCount;
+  uint iterSum;
+  uint chunkTraversedSum;
+};
+
+// the primary hits of the grid, where the hemisphere and the shadow rays of the batches start
+struct G_TraversalSurface {
+  vec3 position;
+  uint isValid; // bool
+  vec3 normal;
+};
+
+// the traversal statistics of the rays of a frame, with SvoTracerTweakingData.traversalStatistics,
+// see traversalStatistics.glsl, should also be synchronized with TraversalStatsSink
+const uint kTraversalRayTypeCount = 3;
+const uint kPrimaryTraversalRay   = 0;
+const uint kShadowTraversalRay    = 1;
+const uint kIndirectTraversalRay  = 2;
+// the iterations are bucketed by their log2, the traversed chunks by their count, the last bucket
+// takes the rest
+const uint kTraversalIterBucketCount  = 16;
+const uint kTraversalChunkBucketCount = 16;
+
+// reset at the start of every frame, so the sums of the low res rays fit in uints
+struct G_TraversalHistogram {
+  uint rayCount[kTraversalRayTypeCount];
+  uint iterSum[kTraversalRayTypeCount];
+  uint chunkTraversedSum[kTraversalRayTypeCount];
+  uint iterBuckets[kTraversalRayTypeCount * kTraversalIterBucketCount];
+  uint chunkBuckets[kTraversalRayTypeCount * kTraversalChunkBucketCount];
+};
+
+// the radiance of the sky without the sun, projected onto the spherical harmonics of the first
+// three bands by skyRadianceSh.comp whenever the sky luts change, the rgb of each coefficient
+// follow each other, the indirect rays that miss evaluate it, see shSkyColor, this is valid in both
+// glsl and c++
+const uint kSkyShCoeffCount = 9;
+struct G_SkyRadianceSh {
+  float coeffs[kSkyShCoeffCount * 3];
+};
+
+// the frusta that the chunks are culled against every frame by chunkOccupancy.comp, the rays that
+// stay within one only march the chunks within its bounds, see getChunkRange
+const uint kChunkFrustumCount     = 2;
+const uint kCameraChunkFrustum    = 0;
+const uint kShadowMapChunkFrustum = 1;
+// the rays that may leave the frusta march the whole chunk window
+const uint kNoChunkFrustum = kChunkFrustumCount;
+
+// the bounds of the non-empty chunks that intersect each frustum, in chunks relative to the chunk
+// window, inclusive, the minimum stays above the maximum for a frustum without any, reset at the
+// start of every frame
+struct G_ChunkFrustumBounds {
+  uint boundsMin[kChunkFrustumCount * 3];
+  uint boundsMax[kChunkFrustumCount * 3];
+};
+
+// a view of a capture, rendered into its own layer of the capture image by viewCapture.comp, the
+// views are square, the axes are normalized
+struct G_CaptureView {
+  vec3 position;
+  float tanHalfFov;
+  vec3 right;
+  uint padding0;
+  vec3 up;
+  uint padding1;
+  vec3 forward;
+  uint padding2;
+};
+
 #endif // SVO_TRACER_DATA_STRUCTS_GLSL
\ No newline at end of file
@@ -2,7 +2,13 @@
 #define SVO_TRACER_DESCRIPTOR_SET_LAYOUTS_GLSL
 
 #extension GL_EXT_shader_image_load_formatted : require
+#extension GL_EXT_nonuniform_qualifier : require
+#ifdef OCTREE_DEVICE_ADDRESS
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+#endif // OCTREE_DEVICE_ADDRESS
 
+#include "../include/svoBuilderDataStructs.glsl"
 #include "../include/svoTracerDataStructs.glsl"
 
 layout(binding = 0) uniform RenderInfoUniformBuffer { G_RenderInfo data; }
@@ -21,8 +27,18 @@ layout(binding = 6) readonly uniform image2DArray vec2BlueNoise;
 layout(binding = 7) readonly uniform image2DArray vec3BlueNoise;
 layout(binding = 8) readonly uniform image2DArray weightedCosineBlueNoise;
 
-layout(std430, binding = 9) readonly buffer ChunkIndicesBuffer { uint[] data; }
+layout(std430, binding = 9) readonly buffer ChunkIndicesBuffer { uvec2[] data; }
 chunkIndicesBuffer;
+// the tight bounds of the voxels of the chunks, see makeChunkBounds
+layout(std430, binding = 78) readonly buffer ChunkBoundsBuffer { uint data[]; }
+chunkBoundsBuffer;
+// the tables of the prefab instances of the chunks, see octreeInstance.glsl
+layout(std430, binding = 83) readonly buffer ChunkInstancesBuffer { uvec2 data[]; }
+chunkInstancesBuffer;
+// the top-level grid of the dynamic objects of the frame, the entries of the chunks, then the
+// records that they point to, see octreeInstance.glsl
+layout(std430, binding = 84) readonly buffer DynamicObjectGridBuffer { uint data[]; }
+dynamicObjectGridBuffer;
 
 layout(binding = 10) uniform uimage2D backgroundImage;
 layout(binding = 11) uniform image2D beamDepthImage;
@@ -35,8 +51,11 @@ layout(binding = 17) uniform uimage2D temporalHistLengthImage;
 layout(binding = 18) uniform image2D motionImage;
 layout(binding = 19) uniform uimage2D normalImage;
 layout(binding = 20) readonly uniform uimage2D lastNormalImage;
+// the positions are reconstructed from depthImage and lastDepthImage instead, see gBuffer.glsl
+#ifndef POSITION_FROM_DEPTH
 layout(binding = 21) uniform image2D positionImage;
 layout(binding = 22) uniform image2D lastPositionImage;
+#endif // POSITION_FROM_DEPTH
 layout(binding = 23) uniform uimage2D voxHashImage;
 layout(binding = 24) readonly uniform uimage2D lastVoxHashImage;
 layout(binding = 25) uniform uimage2D accumedImage;
@@ -64,17 +83,135 @@ layout(binding = 38) uniform image2D skyViewLutImage;
 layout(binding = 39) uniform sampler2D transmittanceLutTexture;
 layout(binding = 40) uniform sampler2D multiScatteringLutTexture;
 layout(binding = 41) uniform sampler2D skyViewLutTexture;
+// shared by the frames in flight like the luts, see G_SkyRadianceSh
+layout(std430, binding = 80) buffer SkyRadianceShBuffer { G_SkyRadianceSh data; }
+skyRadianceShBuffer;
+
+// the views of a capture, and the layers that they're rendered to, see SvoTracer::captureViews
+layout(binding = 81, rgba16f) uniform image2DArray captureImage;
+layout(std430, binding = 82) readonly buffer CaptureViewBuffer { G_CaptureView data[]; }
+captureViewBuffer;
 
 layout(binding = 42) uniform image2D shadowMapImage;
 layout(binding = 43) uniform sampler2D shadowMapTexture;
 
 layout(std430, binding = 44) readonly buffer SceneInfoBuffer { G_SceneInfo data; }
 sceneInfoBuffer;
-layout(std430, binding = 45) readonly buffer OctreeBuffer { uint[] data; }
-octreeBuffer;
-layout(binding = 46) readonly buffer ATrousIterationBuffer { uint data; }
-aTrousIterationBuffer;
+// the rays of a subgroup can be in chunks of different pages, so the index is non-uniform
+layout(std430, binding = 45) readonly restrict buffer OctreeBuffer { uint[] data; }
+octreeBuffers[kMaxOctreePageCount];
+#ifdef OCTREE_TEXEL_BUFFER
+// the same pages, viewed as r32ui texels, see octreeNode.glsl
+layout(binding = 67) uniform usamplerBuffer octreeTexelBuffers[kMaxOctreePageCount];
+#endif // OCTREE_TEXEL_BUFFER
+#ifdef OCTREE_DEVICE_ADDRESS
+// the same pages, dereferenced through the addresses of the table, see octreeNode.glsl
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly restrict buffer OctreePage {
+  uint data[];
+};
+layout(std430, binding = 76) readonly buffer OctreePageAddressBuffer { uvec2 data[]; }
+octreePageAddressBuffer;
+#endif // OCTREE_DEVICE_ADDRESS
+// the colors that the leaves index, see blockColor.glsl
+layout(std430, binding = 46) readonly buffer PaletteBuffer { uint data[]; }
+paletteBuffer;
 layout(binding = 47) buffer OutputInfoBuffer { G_OutputInfo data; }
 outputInfoBuffer;
+// one uint per cell of kChunkOccupancyCellDim^3 chunks, relative to the chunk window
+layout(binding = 49) buffer ChunkOccupancyBuffer { uint[] data; }
+chunkOccupancyBuffer;
+// the bounds of the chunks in the frusta of the frame, written along with the occupancy
+layout(std430, binding = 79) buffer ChunkFrustumBoundsBuffer { G_ChunkFrustumBounds data; }
+chunkFrustumBoundsBuffer;
+// the ray queues of the wavefront tracing, see wavefrontQueues.glsl
+layout(std430, binding = 50) buffer WavefrontRayQueueBuffer {
+  G_WavefrontQueueInfo info;
+  G_WavefrontRay rays[];
+}
+wavefrontRayQueueBuffers[kWavefrontRayQueueCount];
+layout(std430, binding = 51) buffer WavefrontPixelBuffer { G_WavefrontPixel data[]; }
+wavefrontPixelBuffer;
+// the ray count of every bin of the indirect rays, then the offsets of the bins after the scan
+layout(std430, binding = 52) buffer WavefrontRayBinBuffer { uint data[]; }
+wavefrontRayBinBuffer;
+// the indirect rays, sorted by their bins
+layout(std430, binding = 53) buffer WavefrontBinnedRayBuffer { G_WavefrontRay data[]; }
+wavefrontBinnedRayBuffer;
+// the shadow reservoirs of the frame, and the ones of the last frame after their spatial reuse, see
+// shadowReservoir.glsl
+layout(std430, binding = 54) buffer ShadowReservoirBuffer { G_ShadowReservoir data[]; }
+shadowReservoirBuffer;
+layout(std430, binding = 55) buffer LastShadowReservoirBuffer { G_ShadowReservoir data[]; }
+lastShadowReservoirBuffer;
+// the traversal benchmark, see traversalBenchmark.comp
+layout(std430, binding = 57) buffer TraversalStatsBuffer { G_TraversalStats data; }
+traversalStatsBuffer;
+layout(std430, binding = 58) buffer TraversalSurfaceBuffer { G_TraversalSurface data[]; }
+traversalSurfaceBuffer;
+// the traversal statistics of the frame, see traversalStatistics.glsl
+layout(std430, binding = 77) buffer TraversalHistogramBuffer { G_TraversalHistogram data; }
+traversalHistogramBuffer;
+// premultiplied, composited by the post processing
+layout(binding = 59, rgba8) readonly uniform image2D guiOverlayImage;
+// the radiance that leaves the voxels, see radianceCache.glsl
+layout(std430, binding = 62) buffer RadianceCacheBuffer { G_RadianceCacheEntry data[]; }
+radianceCacheBuffer;
+
+// the non-empty chunks of the window, only bound if the device supports ray queries
+#ifdef SUPPORTS_RAY_QUERY
+#extension GL_EXT_ray_query : require
+layout(binding = 48) uniform accelerationStructureEXT chunksAccelerationStructure;
+#endif // SUPPORTS_RAY_QUERY
+
+// the depth of the last frame, depthImage is a history image then
+#ifdef POSITION_FROM_DEPTH
+layout(binding = 56) readonly uniform image2D lastDepthImage;
+#endif // POSITION_FROM_DEPTH
+
+// the distances to the voxels that the primary rays of the last frame hit, 0 for the other pixels,
+// and their distances from the camera of this frame, scattered to the pixels they land on, as the
+// bits of the floats, see depthReprojection.comp
+#ifdef DEPTH_REPROJECTION
+layout(binding = 60) uniform image2D voxelDepthImage;
+layout(binding = 61, r32ui) uniform uimage2D reprojectedDepthImage;
+#endif // DEPTH_REPROJECTION
+
+// the luminance moments of the temporal mean, with ATROUS_ADAPTIVE or ADAPTIVE_SAMPLING
+#ifdef TEMPORAL_MOMENTS
+layout(binding = 63) uniform image2D temporalMomentsImage;
+layout(binding = 64) readonly uniform image2D lastTemporalMomentsImage;
+#endif // TEMPORAL_MOMENTS
+
+// the tile lists of the a-trous iterations, every tile is packed as its x, its y and whether it
+// only copies its color to the other image, see temporalFilter.comp
+#ifdef ATROUS_ADAPTIVE
+layout(std430, binding = 65) buffer ATrousTileListBuffer {
+  G_ATrousTileListInfo info;
+  uint tiles[];
+}
+aTrousTileListBuffers[kATrousMaxIterationCount];
+#endif // ATROUS_ADAPTIVE
+
+// 1 for every tile whose pixels all converged in the last frame, see adaptiveSampling.glsl
+#ifdef ADAPTIVE_SAMPLING
+layout(std430, binding = 66) buffer SamplingTileBuffer { uint data[]; }
+samplingTileBuffer;
+#endif // ADAPTIVE_SAMPLING
+
+// the g-buffer images above, sampled through the texture cache by the passes that only read them,
+// the denoising filters tap them around every pixel, the writes stay on the storage images
+layout(binding = 68) uniform usampler2D hitTexture;
+layout(binding = 69) uniform usampler2D temporalHistLengthTexture;
+layout(binding = 70) uniform usampler2D normalTexture;
+layout(binding = 71) uniform usampler2D lastNormalTexture;
+#ifdef POSITION_FROM_DEPTH
+layout(binding = 72) uniform sampler2D depthTexture;
+layout(binding = 73) uniform sampler2D lastDepthTexture;
+#else
+layout(binding = 72) uniform sampler2D positionTexture;
+layout(binding = 73) uniform sampler2D lastPositionTexture;
+#endif // POSITION_FROM_DEPTH
+layout(binding = 74) uniform usampler2D voxHashTexture;
+layout(binding = 75) uniform usampler2D lastAccumedTexture;
 
 #endif // SVO_TRACER_DESCRIPTOR_SET_LAYOUTS_GLSL
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef TRAVERSAL_STATISTICS_GLSL
+#define TRAVERSAL_STATISTICS_GLSL
+
+// the including shaders have to enable GL_KHR_shader_subgroup_arithmetic and
+// GL_KHR_shader_subgroup_ballot
+
+#include "../include/cascadedMarching.glsl"
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+uint _getTraversalIterBucket(uint iter) {
+  // 0 for no iteration, then [2^(b-1), 2^b) for the bucket b
+  uint bucket = iter == 0 ? 0 : uint(findMSB(iter)) + 1;
+  return min(bucket, kTraversalIterBucketCount - 1);
+}
+
+// the lanes of the same bucket add to it with a single atomic, the subgroup takes as many rounds as
+// it has distinct buckets, which is a few for the coherent rays
+void _addToTraversalHistogram(uint bucket, bool isChunkHistogram) {
+  for (;;) {
+    if (bucket == subgroupBroadcastFirst(bucket)) {
+      uint count = subgroupBallotBitCount(subgroupBallot(true));
+      if (subgroupElect()) {
+        if (isChunkHistogram) {
+          atomicAdd(traversalHistogramBuffer.data.chunkBuckets[bucket], count);
+        } else {
+          atomicAdd(traversalHistogramBuffer.data.iterBuckets[bucket], count);
+        }
+      }
+      return;
+    }
+  }
+}
+
+// called by the lanes that marched a ray of the type, the lanes of a call share it, the sums cost
+// an atomic per subgroup, so the statistics barely add to the traced time
+void recordTraversalStatistics(uint rayType, MarchingResult result) {
+  if (!bool(tweakableParametersUbo.data.traversalStatistics)) {
+    return;
+  }
+
+  uvec2 sums    = subgroupAdd(uvec2(result.iter, result.chunkTraversed));
+  uint rayCount = subgroupBallotBitCount(subgroupBallot(true));
+  if (subgroupElect()) {
+    atomicAdd(traversalHistogramBuffer.data.rayCount[rayType], rayCount);
+    atomicAdd(traversalHistogramBuffer.data.iterSum[rayType], sums.x);
+    atomicAdd(traversalHistogramBuffer.data.chunkTraversedSum[rayType], sums.y);
+  }
+
+  _addToTraversalHistogram(rayType * kTraversalIterBucketCount +
+                               _getTraversalIterBucket(result.iter),
+                           false);
+  _addToTraversalHistogram(rayType * kTraversalChunkBucketCount +
+                               min(result.chunkTraversed, kTraversalChunkBucketCount - 1),
+                           true);
+}
+
+#endif // TRAVERSAL_STATISTICS_GLSL
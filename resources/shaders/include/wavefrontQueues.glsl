@@ -0,0 +1,69 @@
+#ifndef WAVEFRONT_QUEUES_GLSL
+#define WAVEFRONT_QUEUES_GLSL
+
+// the including shaders have to enable GL_KHR_shader_subgroup_ballot
+
+#include "../include/svoTracerDescriptorSetLayouts.glsl"
+
+// the local size of the kernels dispatched over a queue, should also be synchronized with
+// SvoTracer.cpp
+const uint kWavefrontQueueWorkGroupSize = 64;
+
+// the direction bins of a chunk, an octant times the dominant axis in it, should also be
+// synchronized with SvoTracer.cpp
+const uint kWavefrontDirectionBinCount = 24;
+
+// the slots of G_WavefrontPixel
+const uint kDirectRadianceSlot   = 0;
+const uint kIndirectRadianceSlot = 1;
+
+uint getWavefrontPixelIndex(ivec2 uvi) {
+  return uint(uvi.y) * renderInfoUbo.data.lowResSize.x + uint(uvi.x);
+}
+
+// the surviving rays of a subgroup are appended next to each other with a single atomic, so the
+// queue stays compact, mirrors octreeAllocNode.comp
+void pushWavefrontRay(uint queue, G_WavefrontRay ray) {
+  uvec4 ballot = subgroupBallot(true);
+  uint base;
+  if (subgroupElect()) {
+    base =
+        atomicAdd(wavefrontRayQueueBuffers[queue].info.rayCount, subgroupBallotBitCount(ballot));
+  }
+  base = subgroupBroadcastFirst(base);
+  wavefrontRayQueueBuffers[queue].rays[base + subgroupBallotExclusiveBitCount(ballot)] = ray;
+}
+
+uint getWavefrontRayBinCount() {
+  const uvec3 chunksDim = sceneInfoBuffer.data.chunksDim;
+  return chunksDim.x * chunksDim.y * chunksDim.z * kWavefrontDirectionBinCount;
+}
+
+// the rays of a bin start in the same chunk of the window, and go roughly the same way, so they
+// walk the same octree nodes, the neighbouring chunks have neighbouring bins
+uint getWavefrontRayBin(G_WavefrontRay ray) {
+  const ivec3 chunksDim = ivec3(sceneInfoBuffer.data.chunksDim);
+  const ivec3 windowChunk =
+      clamp(ivec3(floor(ray.origin)) - renderInfoUbo.data.chunkWindowOrigin, ivec3(0),
+            chunksDim - 1);
+  const uint chunk = uint(windowChunk.x + windowChunk.y * chunksDim.x +
+                          windowChunk.z * chunksDim.x * chunksDim.y);
+
+  const uvec3 isNegative = uvec3(lessThan(ray.dir, vec3(0.0)));
+  const uint octant      = isNegative.x | (isNegative.y << 1u) | (isNegative.z << 2u);
+  const vec3 absDir      = abs(ray.dir);
+  const uint dominantAxis =
+      absDir.x >= max(absDir.y, absDir.z) ? 0u : (absDir.y >= absDir.z ? 1u : 2u);
+
+  return chunk * kWavefrontDirectionBinCount + octant * 3u + dominantAxis;
+}
+
+void storeWavefrontRadiance(G_WavefrontRay ray, vec3 radiance) {
+  if (ray.radianceSlot == kDirectRadianceSlot) {
+    wavefrontPixelBuffer.data[ray.pixel].directRadiance = radiance;
+  } else {
+    wavefrontPixelBuffer.data[ray.pixel].indirectRadiance = radiance;
+  }
+}
+
+#endif // WAVEFRONT_QUEUES_GLSL
@@ -0,0 +1,43 @@
+#include "DeviceGroupSubmit.hpp"
+
+#include <utility>
+
+DeviceGroupSubmit::DeviceGroupSubmit(VkSubmitInfo &submitInfo, uint32_t deviceCount,
+                                     uint32_t deviceMask) {
+  if (deviceCount < 2) {
+    return;
+  }
+  uint32_t semaphoreDeviceIndex = 0;
+  while ((deviceMask & (1U << semaphoreDeviceIndex)) == 0) {
+    semaphoreDeviceIndex++;
+  }
+
+  _waitSemaphoreDeviceIndices.assign(submitInfo.waitSemaphoreCount, semaphoreDeviceIndex);
+  _signalSemaphoreDeviceIndices.assign(submitInfo.signalSemaphoreCount, semaphoreDeviceIndex);
+  _chain(submitInfo, deviceMask);
+}
+
+DeviceGroupSubmit::DeviceGroupSubmit(VkSubmitInfo &submitInfo, uint32_t deviceCount,
+                                     uint32_t deviceMask,
+                                     std::vector<uint32_t> waitSemaphoreDeviceIndices,
+                                     std::vector<uint32_t> signalSemaphoreDeviceIndices) {
+  if (deviceCount < 2) {
+    return;
+  }
+  _waitSemaphoreDeviceIndices   = std::move(waitSemaphoreDeviceIndices);
+  _signalSemaphoreDeviceIndices = std::move(signalSemaphoreDeviceIndices);
+  _chain(submitInfo, deviceMask);
+}
+
+void DeviceGroupSubmit::_chain(VkSubmitInfo &submitInfo, uint32_t deviceMask) {
+  _commandBufferDeviceMasks.assign(submitInfo.commandBufferCount, deviceMask);
+
+  _deviceGroupSubmitInfo.pNext                         = submitInfo.pNext;
+  _deviceGroupSubmitInfo.waitSemaphoreCount            = submitInfo.waitSemaphoreCount;
+  _deviceGroupSubmitInfo.pWaitSemaphoreDeviceIndices   = _waitSemaphoreDeviceIndices.data();
+  _deviceGroupSubmitInfo.commandBufferCount            = submitInfo.commandBufferCount;
+  _deviceGroupSubmitInfo.pCommandBufferDeviceMasks     = _commandBufferDeviceMasks.data();
+  _deviceGroupSubmitInfo.signalSemaphoreCount          = submitInfo.signalSemaphoreCount;
+  _deviceGroupSubmitInfo.pSignalSemaphoreDeviceIndices = _signalSemaphoreDeviceIndices.data();
+  submitInfo.pNext                                     = &_deviceGroupSubmitInfo;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "volk.h"
+
+#include <cstdint>
+#include <vector>
+
+// chained to a submission on a logical device that is made of a device group, so that its command
+// buffers only run on the devices of the mask, and its semaphores are waited on and signalled by
+// the lowest of them, nothing is chained on a single device, it has to outlive the submission
+class DeviceGroupSubmit {
+public:
+  DeviceGroupSubmit(VkSubmitInfo &submitInfo, uint32_t deviceCount, uint32_t deviceMask);
+  // every semaphore is waited on or signalled by the device of its index instead
+  DeviceGroupSubmit(VkSubmitInfo &submitInfo, uint32_t deviceCount, uint32_t deviceMask,
+                    std::vector<uint32_t> waitSemaphoreDeviceIndices,
+                    std::vector<uint32_t> signalSemaphoreDeviceIndices);
+
+  // disable move and copy, the submission points to it
+  DeviceGroupSubmit(const DeviceGroupSubmit &)            = delete;
+  DeviceGroupSubmit &operator=(const DeviceGroupSubmit &) = delete;
+  DeviceGroupSubmit(DeviceGroupSubmit &&)                 = delete;
+  DeviceGroupSubmit &operator=(DeviceGroupSubmit &&)      = delete;
+
+  // the device mask of the first device, which renders and presents
+  static uint32_t constexpr kPrimaryDeviceMask = 1U;
+
+private:
+  VkDeviceGroupSubmitInfo _deviceGroupSubmitInfo{VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO};
+  std::vector<uint32_t> _waitSemaphoreDeviceIndices;
+  std::vector<uint32_t> _commandBufferDeviceMasks;
+  std::vector<uint32_t> _signalSemaphoreDeviceIndices;
+
+  void _chain(VkSubmitInfo &submitInfo, uint32_t deviceMask);
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+// the tags of the allocations, the memory panel breaks the usage of the heaps down by them
+enum class MemoryCategory : uint32_t {
+  kUntagged,
+  kOctreePool,
+  kFieldData,
+  kRenderTargets,
+  kBlueNoise,
+  kStaging,
+  kCount,
+};
+
+inline char const *getMemoryCategoryName(MemoryCategory category) {
+  switch (category) {
+  case MemoryCategory::kUntagged:
+    return "Untagged";
+  case MemoryCategory::kOctreePool:
+    return "Octree Pool";
+  case MemoryCategory::kFieldData:
+    return "Field Data";
+  case MemoryCategory::kRenderTargets:
+    return "Render Targets";
+  case MemoryCategory::kBlueNoise:
+    return "Blue Noise";
+  case MemoryCategory::kStaging:
+    return "Staging";
+  case MemoryCategory::kCount:
+    break;
+  }
+  return "";
+}
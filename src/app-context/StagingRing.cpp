@@ -0,0 +1,349 @@
+#include "StagingRing.hpp"
+
+#include "DeviceGroupSubmit.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+StagingRing::StagingRing(VkDevice device, VmaAllocator allocator, uint32_t queueFamilyIndex,
+                         VkQueue queue, uint32_t deviceCount)
+    : _device(device), _allocator(allocator), _queue(queue), _deviceCount(deviceCount) {
+  VkCommandPoolCreateInfo commandPoolCreateInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+  commandPoolCreateInfo.queueFamilyIndex = queueFamilyIndex;
+  // this flag allows the use of vkResetCommandBuffer
+  commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  vkCreateCommandPool(_device, &commandPoolCreateInfo, nullptr, &_commandPool);
+
+  for (auto &batch : _batches) {
+    VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool        = _commandPool;
+    allocInfo.commandBufferCount = 1;
+    vkAllocateCommandBuffers(_device, &allocInfo, &batch.commandBuffer);
+
+    VkFenceCreateInfo fenceCreateInfo{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+    vkCreateFence(_device, &fenceCreateInfo, nullptr, &batch.fence);
+  }
+
+  VkSemaphoreTypeCreateInfo semaphoreTypeInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+  semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  semaphoreTypeInfo.initialValue  = 0;
+  VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  semaphoreInfo.pNext = &semaphoreTypeInfo;
+  _timelineSemaphores.assign(_deviceCount, VK_NULL_HANDLE);
+  for (auto &timelineSemaphore : _timelineSemaphores) {
+    vkCreateSemaphore(_device, &semaphoreInfo, nullptr, &timelineSemaphore);
+  }
+
+  VkBufferCreateInfo bufferCreateInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+  bufferCreateInfo.size  = kCapacity;
+  bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+  // the readbacks are read by the host, so the random access is preferred over the sequential
+  // write, which may be uncached
+  VmaAllocationCreateInfo allocCreateInfo{};
+  allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocCreateInfo.flags =
+      VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+  VmaAllocationInfo allocInfo{};
+  vmaCreateBuffer(_allocator, &bufferCreateInfo, &allocCreateInfo, &_vkBuffer, &_bufferAllocation,
+                  &allocInfo);
+  _mappedAddr = static_cast<uint8_t *>(allocInfo.pMappedData);
+}
+
+StagingRing::~StagingRing() {
+  waitIdle();
+  for (auto &batch : _batches) {
+    vkDestroyFence(_device, batch.fence, nullptr);
+  }
+  for (auto const &timelineSemaphore : _timelineSemaphores) {
+    vkDestroySemaphore(_device, timelineSemaphore, nullptr);
+  }
+  // the command buffers are freed along with their pool
+  vkDestroyCommandPool(_device, _commandPool, nullptr);
+  vmaDestroyBuffer(_allocator, _vkBuffer, _bufferAllocation);
+}
+
+bool StagingRing::upload(VkBuffer dst, void const *data, VkDeviceSize size,
+                         VkDeviceSize dstOffset) {
+  if (size > kCapacity) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  if (data == nullptr) {
+    _beginCurrentBatch();
+    _recordCopyBarrier();
+    vkCmdFillBuffer(_batches[_currentBatch].commandBuffer, dst, dstOffset, VK_WHOLE_SIZE, 0);
+    return true;
+  }
+
+  VkDeviceSize const offset = _allocate(size);
+  std::memcpy(_mappedAddr + offset, data, size);
+
+  VkBufferCopy bufCopy = {
+      offset,    // srcOffset
+      dstOffset, // dstOffset,
+      size,      // size
+  };
+  _recordCopyBarrier();
+  vkCmdCopyBuffer(_batches[_currentBatch].commandBuffer, _vkBuffer, dst, 1, &bufCopy);
+  return true;
+}
+
+bool StagingRing::readback(VkBuffer src, void *data, VkDeviceSize size) {
+  if (size > kCapacity) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  VkDeviceSize const offset = _allocate(size);
+  Batch &batch              = _batches[_currentBatch];
+  _recordReadbackCopy(src, 0, offset, size);
+  _submitCurrentBatch();
+
+  // the older batches are retired first, to keep the used bytes contiguous
+  while (batch.isInFlight) {
+    _retireOldestBatch();
+  }
+  vmaInvalidateAllocation(_allocator, _bufferAllocation, offset, size);
+  std::memcpy(data, _mappedAddr + offset, size);
+  return true;
+}
+
+bool StagingRing::readbackAsync(VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize size,
+                                std::function<void(void const *data)> onCopied) {
+  if (size > kCapacity) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+
+  // the region is held by the batch until it's retired, which calls back before releasing it
+  VkDeviceSize const offset = _allocate(size);
+  _recordReadbackCopy(src, srcOffset, offset, size);
+  _batches[_currentBatch].readbackCallbacks.emplace_back(
+      [this, offset, size, onCopied = std::move(onCopied)]() {
+        vmaInvalidateAllocation(_allocator, _bufferAllocation, offset, size);
+        onCopied(_mappedAddr + offset);
+      });
+  return true;
+}
+
+void StagingRing::flush(VkQueue consumerQueue) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _submitCurrentBatch();
+  // the queues are only ordered by the semaphores, which the consumers of the uploads don't wait on
+  if (consumerQueue != _queue) {
+    while (_retireOldestBatch()) {
+    }
+  }
+}
+
+uint64_t StagingRing::submit() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _submitCurrentBatch();
+  return _timelineValue;
+}
+
+void StagingRing::setConsumerTimelineValue(VkSemaphore timelineSemaphore, uint64_t value,
+                                           uint32_t deviceIndex) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto it = std::find_if(_consumerTimelineValues.begin(), _consumerTimelineValues.end(),
+                         [timelineSemaphore](auto const &consumerTimelineValue) {
+                           return consumerTimelineValue.timelineSemaphore == timelineSemaphore;
+                         });
+  if (it == _consumerTimelineValues.end()) {
+    _consumerTimelineValues.push_back({timelineSemaphore, value, deviceIndex});
+    return;
+  }
+  it->value = std::max(it->value, value);
+}
+
+void StagingRing::waitIdle() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _submitCurrentBatch();
+  while (_retireOldestBatch()) {
+  }
+}
+
+void StagingRing::collect() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  // the batches are done in the order they're submitted
+  for (uint32_t i = 0; i < kBatchCount; i++) {
+    Batch &batch = _batches[(_currentBatch + i) % kBatchCount];
+    if (!batch.isInFlight) {
+      continue;
+    }
+    if (vkGetFenceStatus(_device, batch.fence) != VK_SUCCESS) {
+      return;
+    }
+    _retireBatch(batch);
+  }
+}
+
+VkDeviceSize StagingRing::_allocate(VkDeviceSize size) {
+  VkDeviceSize const alignedSize = (size + kRegionAlign - 1) / kRegionAlign * kRegionAlign;
+  for (;;) {
+    if (_usedSize == 0) {
+      _head = 0;
+    }
+    // the regions never wrap around the end of the ring, the skipped tail is held by the batch
+    VkDeviceSize const padding      = _head + alignedSize > kCapacity ? kCapacity - _head : 0;
+    VkDeviceSize const consumedSize = padding + alignedSize;
+    if (_usedSize + consumedSize <= kCapacity) {
+      _beginCurrentBatch();
+      VkDeviceSize const offset = padding != 0 ? 0 : _head;
+      _batches[_currentBatch].size += consumedSize;
+      _usedSize += consumedSize;
+      _head = (offset + alignedSize) % kCapacity;
+      return offset;
+    }
+    // the rest of the ring is held by the batch that is being recorded otherwise
+    if (!_retireOldestBatch()) {
+      _submitCurrentBatch();
+    }
+  }
+}
+
+void StagingRing::_beginCurrentBatch() {
+  Batch &batch = _batches[_currentBatch];
+  if (batch.isRecording) {
+    return;
+  }
+  // the batches are reused round robin, so this is the oldest one in flight
+  if (batch.isInFlight) {
+    _retireBatch(batch);
+  }
+  vkResetCommandBuffer(batch.commandBuffer, 0);
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(batch.commandBuffer, &beginInfo);
+  batch.isRecording = true;
+
+  // the transfers used to wait for the queue to go idle, so they're ordered after everything that
+  // is submitted before them, which may still read the buffers that are overwritten, the other
+  // queues are covered by the waits on the consumer timeline values
+  _recordMemoryBarrier(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_ACCESS_MEMORY_WRITE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+}
+
+void StagingRing::_recordMemoryBarrier(VkPipelineStageFlags srcStageMask,
+                                       VkAccessFlags srcAccessMask,
+                                       VkPipelineStageFlags dstStageMask,
+                                       VkAccessFlags dstAccessMask) {
+  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  memoryBarrier.srcAccessMask = srcAccessMask;
+  memoryBarrier.dstAccessMask = dstAccessMask;
+  vkCmdPipelineBarrier(_batches[_currentBatch].commandBuffer, srcStageMask, dstStageMask, 0, 1,
+                       &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void StagingRing::_recordCopyBarrier() {
+  _recordMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+}
+
+void StagingRing::_recordReadbackCopy(VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize offset,
+                                      VkDeviceSize size) {
+  VkCommandBuffer const commandBuffer = _batches[_currentBatch].commandBuffer;
+
+  VkBufferCopy bufCopy = {
+      srcOffset, // srcOffset
+      offset,    // dstOffset,
+      size,      // size
+  };
+  _recordCopyBarrier();
+  // every device would write its own instance of src to the same host memory otherwise
+  if (_deviceCount > 1) {
+    vkCmdSetDeviceMask(commandBuffer, DeviceGroupSubmit::kPrimaryDeviceMask);
+  }
+  vkCmdCopyBuffer(commandBuffer, src, _vkBuffer, 1, &bufCopy);
+  if (_deviceCount > 1) {
+    vkCmdSetDeviceMask(commandBuffer, (1U << _deviceCount) - 1);
+  }
+}
+
+void StagingRing::_submitCurrentBatch() {
+  Batch &batch = _batches[_currentBatch];
+  if (!batch.isRecording) {
+    return;
+  }
+  // the later submissions, and the host for the readbacks, see the transferred data
+  _recordMemoryBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT,
+                       VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT |
+                           VK_ACCESS_HOST_READ_BIT);
+  vkEndCommandBuffer(batch.commandBuffer);
+
+  // a no-op for the coherent memory
+  vmaFlushAllocation(_allocator, _bufferAllocation, 0, VK_WHOLE_SIZE);
+
+  std::vector<VkSemaphore> waitSemaphores{};
+  std::vector<uint64_t> waitValues{};
+  std::vector<uint32_t> waitDeviceIndices{};
+  for (auto const &consumerTimelineValue : _consumerTimelineValues) {
+    waitSemaphores.push_back(consumerTimelineValue.timelineSemaphore);
+    waitValues.push_back(consumerTimelineValue.value);
+    waitDeviceIndices.push_back(consumerTimelineValue.deviceIndex);
+  }
+  std::vector<VkPipelineStageFlags> const waitStages(waitSemaphores.size(),
+                                                     VK_PIPELINE_STAGE_TRANSFER_BIT);
+  _timelineValue++;
+  // every device signals its own semaphore, the copies run on all of them
+  std::vector<uint64_t> const signalValues(_timelineSemaphores.size(), _timelineValue);
+  std::vector<uint32_t> signalDeviceIndices(_timelineSemaphores.size());
+  for (uint32_t deviceIndex = 0; deviceIndex < signalDeviceIndices.size(); deviceIndex++) {
+    signalDeviceIndices[deviceIndex] = deviceIndex;
+  }
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  timelineInfo.waitSemaphoreValueCount   = static_cast<uint32_t>(waitValues.size());
+  timelineInfo.pWaitSemaphoreValues      = waitValues.data();
+  timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+  timelineInfo.pSignalSemaphoreValues    = signalValues.data();
+
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.pNext                = &timelineInfo;
+  submitInfo.waitSemaphoreCount   = static_cast<uint32_t>(waitSemaphores.size());
+  submitInfo.pWaitSemaphores      = waitSemaphores.data();
+  submitInfo.pWaitDstStageMask    = waitStages.data();
+  submitInfo.signalSemaphoreCount = static_cast<uint32_t>(_timelineSemaphores.size());
+  submitInfo.pSignalSemaphores    = _timelineSemaphores.data();
+  submitInfo.commandBufferCount   = 1;
+  submitInfo.pCommandBuffers      = &batch.commandBuffer;
+  DeviceGroupSubmit const deviceGroupSubmit(submitInfo, _deviceCount, (1U << _deviceCount) - 1,
+                                            waitDeviceIndices, signalDeviceIndices);
+  vkResetFences(_device, 1, &batch.fence);
+  vkQueueSubmit(_queue, 1, &submitInfo, batch.fence);
+
+  batch.isRecording = false;
+  batch.isInFlight  = true;
+  _currentBatch     = (_currentBatch + 1) % kBatchCount;
+}
+
+void StagingRing::_retireBatch(Batch &batch) {
+  vkWaitForFences(_device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+  for (auto const &readbackCallback : batch.readbackCallbacks) {
+    readbackCallback();
+  }
+  batch.readbackCallbacks.clear();
+  _usedSize -= batch.size;
+  batch.size       = 0;
+  batch.isInFlight = false;
+}
+
+// returns false if no batch is in flight
+bool StagingRing::_retireOldestBatch() {
+  for (uint32_t i = 0; i < kBatchCount; i++) {
+    Batch &batch = _batches[(_currentBatch + i) % kBatchCount];
+    if (batch.isInFlight) {
+      _retireBatch(batch);
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "volk.h"
+
+#ifdef __APPLE__
+#include "vk_mem_alloc.h"
+#else
+#include "vma/vk_mem_alloc.h"
+#endif
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// a persistent host visible buffer that the transfers of the dedicated buffers are staged in, the
+// uploads are batched into a command buffer, which is submitted with the next flush, the regions
+// and the command buffers are reused once the fence of their batch is signaled, the ring may be on
+// a dedicated transfer queue, the buffers are shared by all of the queue families concurrently, so
+// there are no ownership transfers, the batches are ordered against the other queues by timeline
+// semaphores instead, on a device group the uploads reach the memory instances of every device,
+// while the readbacks only copy from the first one
+class StagingRing {
+public:
+  StagingRing(VkDevice device, VmaAllocator allocator, uint32_t queueFamilyIndex, VkQueue queue,
+              uint32_t deviceCount);
+  ~StagingRing();
+
+  // disable move and copy
+  StagingRing(const StagingRing &)            = delete;
+  StagingRing &operator=(const StagingRing &) = delete;
+  StagingRing(StagingRing &&)                 = delete;
+  StagingRing &operator=(StagingRing &&)      = delete;
+
+  // records the copy of the data to the offset of dst, it's zero filled from the offset on if data
+  // is nullptr, returns false if the data doesn't fit into the ring, nothing is recorded then
+  bool upload(VkBuffer dst, void const *data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+
+  // mirrors upload, the copy and the pending uploads are submitted and waited on before returning
+  bool readback(VkBuffer src, void *data, VkDeviceSize size);
+  // the copy is submitted with the next batch instead, onCopied is given the data once the batch
+  // is retired, by whichever call to the ring retires it, on its thread, and with the ring locked,
+  // so it mustn't call the ring itself
+  bool readbackAsync(VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize size,
+                     std::function<void(void const *data)> onCopied);
+
+  // submits the pending uploads, the later submissions to the queue of the ring are ordered after
+  // them, it waits on their fence too if the consumer queue is another one
+  void flush(VkQueue consumerQueue);
+
+  // submits the pending uploads, returns the value of the timeline semaphores that they're done
+  // at, a consumer on any queue waits on it in place of the fences, with the semaphore of the
+  // device that it runs on
+  uint64_t submit();
+  [[nodiscard]] VkSemaphore getTimelineSemaphore(uint32_t deviceIndex = 0) const {
+    return _timelineSemaphores[deviceIndex];
+  }
+
+  // the latest value of a timeline semaphore that a consumer has submitted a signal of, the next
+  // batches wait on it, so a transfer on the dedicated queue never overwrites what the work before
+  // it still reads, which the barrier at the start of a batch only covers on the same queue, the
+  // device of a group that signals it waits on it
+  void setConsumerTimelineValue(VkSemaphore timelineSemaphore, uint64_t value,
+                                uint32_t deviceIndex = 0);
+
+  // submits the pending uploads and waits on all of the batches in flight
+  void waitIdle();
+  // retires the batches that are done without waiting, which calls back their readbacks
+  void collect();
+
+  [[nodiscard]] VkQueue getQueue() const { return _queue; }
+  [[nodiscard]] static VkDeviceSize getCapacity() { return kCapacity; }
+
+private:
+  static uint32_t constexpr kBatchCount      = 4;
+  static VkDeviceSize constexpr kCapacity    = 16 * 1024 * 1024;
+  static VkDeviceSize constexpr kRegionAlign = 16;
+
+  struct Batch {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    VkFence fence                 = VK_NULL_HANDLE;
+    // the bytes of the ring that the batch holds, the skipped tail of a wrap included
+    VkDeviceSize size = 0;
+    bool isRecording  = false;
+    bool isInFlight   = false;
+    std::vector<std::function<void()>> readbackCallbacks{};
+  };
+
+  struct ConsumerTimelineValue {
+    VkSemaphore timelineSemaphore = VK_NULL_HANDLE;
+    uint64_t value                = 0;
+    uint32_t deviceIndex          = 0;
+  };
+
+  VkDevice _device;
+  VmaAllocator _allocator;
+  VkQueue _queue;
+  uint32_t _deviceCount;
+
+  VkCommandPool _commandPool      = VK_NULL_HANDLE;
+  VkBuffer _vkBuffer              = VK_NULL_HANDLE;
+  VmaAllocation _bufferAllocation = VK_NULL_HANDLE;
+  uint8_t *_mappedAddr            = nullptr;
+
+  // signaled by every batch, with the count of the batches submitted so far, one per device of a
+  // group, each signaled by its own device once its copies are done
+  std::vector<VkSemaphore> _timelineSemaphores{};
+  uint64_t _timelineValue = 0;
+  std::vector<ConsumerTimelineValue> _consumerTimelineValues{};
+
+  // the batches are retired in the order they're submitted, so the used bytes are always the
+  // contiguous range that ends at the head
+  std::array<Batch, kBatchCount> _batches{};
+  uint32_t _currentBatch = 0;
+  VkDeviceSize _head     = 0;
+  VkDeviceSize _usedSize = 0;
+
+  // the buffers may be filled and fetched from any thread
+  std::mutex _mutex;
+
+  // returns the offset of a region of the ring, the current batch is begun, and owns the region
+  VkDeviceSize _allocate(VkDeviceSize size);
+  void _beginCurrentBatch();
+  void _recordMemoryBarrier(VkPipelineStageFlags srcStageMask, VkAccessFlags srcAccessMask,
+                            VkPipelineStageFlags dstStageMask, VkAccessFlags dstAccessMask);
+  // orders the copy after the earlier ones of the batch, which may target the same buffer
+  void _recordCopyBarrier();
+  void _recordReadbackCopy(VkBuffer src, VkDeviceSize srcOffset, VkDeviceSize offset,
+                           VkDeviceSize size);
+  void _submitCurrentBatch();
+  void _retireBatch(Batch &batch);
+  bool _retireOldestBatch();
+};
@@ -4,8 +4,18 @@
 
 #include "VulkanApplicationContext.hpp"
 
+#include "utils/config/RootDir.h"
 #include "utils/logger/Logger.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <thread>
+#include <utility>
+
 static const std::vector<const char *> validationLayers = {"VK_LAYER_KHRONOS_validation"};
 
 #ifdef __APPLE__
@@ -15,17 +25,54 @@ static const std::vector<const char *> requiredDeviceExtensions = {VK_KHR_SWAPCH
 static const std::vector<const char *> requiredDeviceExtensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 #endif
 
+// enabled along with their features only if all of them are available
+static const std::vector<const char *> rayQueryDeviceExtensions = {
+    VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME, VK_KHR_RAY_QUERY_EXTENSION_NAME,
+    VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME};
+
+// mirrors the ray query ones, for the low latency present mode
+static const std::vector<const char *> presentWaitDeviceExtensions = {
+    VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME};
+
+// for the budgets that the driver reports, instead of the estimated ones
+static const std::vector<const char *> memoryBudgetDeviceExtensions = {
+    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME};
+
+namespace {
+std::string _getPathToPipelineCache() { return kPathToResourceFolder + "cache/pipeline-cache.bin"; }
+
+// the driver rejects the foreign caches too, but not every one of them does it gracefully
+bool _isPipelineCacheCompatible(std::vector<char> const &data,
+                                VkPhysicalDeviceProperties const &properties) {
+  if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne)) {
+    return false;
+  }
+  VkPipelineCacheHeaderVersionOne header{};
+  std::memcpy(&header, data.data(), sizeof(header));
+  return header.headerSize >= sizeof(header) &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+         std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+} // namespace
+
 VulkanApplicationContext::VulkanApplicationContext() = default;
 
 VulkanApplicationContext::~VulkanApplicationContext() {
+  _stagingRing.reset();
+
   vkDestroyCommandPool(_device, _commandPool, nullptr);
   vkDestroyCommandPool(_device, _guiCommandPool, nullptr);
-
-  for (auto &swapchainImageView : _swapchainImageViews) {
-    vkDestroyImageView(_device, swapchainImageView, nullptr);
+  vkDestroyCommandPool(_device, _asyncComputeCommandPool, nullptr);
+  for (auto &recordingCommandPool : _recordingCommandPools) {
+    vkDestroyCommandPool(_device, recordingCommandPool, nullptr);
   }
 
-  vkDestroySwapchainKHR(_device, _swapchain, nullptr);
+  _savePipelineCache();
+  vkDestroyPipelineCache(_device, _pipelineCache, nullptr);
+
+  destroyRetiredSwapchains();
+  _destroySwapchainImages();
 
   vkDestroySurfaceKHR(_vkInstance, _surface, nullptr);
 
@@ -62,13 +109,23 @@ void VulkanApplicationContext::init(Logger *logger, GLFWwindow *window,
   appInfo.apiVersion         = VK_API_VERSION_1_2;
   ContextCreator::createInstance(_logger, _vkInstance, _debugMessager, appInfo, validationLayers);
 
-  ContextCreator::createSurface(_logger, _vkInstance, _surface, _glWindow);
+  _isHeadless = settings->isHeadless;
+  if (!_isHeadless) {
+    ContextCreator::createSurface(_logger, _vkInstance, _surface, _glWindow);
+  }
 
   // selects physical device, creates logical device from that, decides queues,
   // loads device-related functions too
   ContextCreator::QueueSelection queueSelection{};
   ContextCreator::createDevice(_logger, _physicalDevice, _device, _queueFamilyIndices,
-                               queueSelection, _vkInstance, _surface, requiredDeviceExtensions);
+                               queueSelection, _vkInstance, _surface, requiredDeviceExtensions,
+                               rayQueryDeviceExtensions, _isRayQuerySupported,
+                               presentWaitDeviceExtensions, _isPresentWaitSupported,
+                               memoryBudgetDeviceExtensions, _isMemoryBudgetSupported,
+                               _isShaderFloat16Supported, _isBufferDeviceAddressSupported,
+                               _isDescriptorUpdateAfterBindSupported,
+                               _isPipelineStatisticsQuerySupported, settings->isDeviceGroupUsed,
+                               _deviceCount);
   _graphicsQueueIndex = queueSelection.graphicsQueueIndex;
   _presentQueueIndex  = queueSelection.presentQueueIndex;
   _computeQueueIndex  = queueSelection.computeQueueIndex;
@@ -79,23 +136,196 @@ void VulkanApplicationContext::init(Logger *logger, GLFWwindow *window,
   _computeQueue  = queueSelection.computeQueue;
   _transferQueue = queueSelection.transferQueue;
 
-  _createSwapchain(settings->isFramerateLimited);
+  _asyncComputeQueue = queueSelection.asyncComputeQueue;
+
+  // the transfer-only family is never the graphics or the compute one
+  if (!settings->isTransferQueueDedicated || _transferQueueIndex == _graphicsQueueIndex) {
+    _transferQueueIndex = _graphicsQueueIndex;
+    _transferQueue      = _graphicsQueue;
+  } else {
+    _logger->info("the transfers are submitted to the dedicated queue family {}",
+                  _transferQueueIndex);
+  }
+
+  std::set<uint32_t> const sharedQueueFamilyIndices = {_graphicsQueueIndex, _computeQueueIndex,
+                                                       _transferQueueIndex};
+  if (sharedQueueFamilyIndices.size() > 1) {
+    _sharedQueueFamilyIndices.assign(sharedQueueFamilyIndices.begin(),
+                                     sharedQueueFamilyIndices.end());
+  }
+
+  _isPeerMemoryCopySupported = _deviceCount > 1 && _checkPeerMemoryCopySupport();
+
+  _isLowLatencyPresent = settings->isLowLatencyPresent && !_isHeadless;
+  // the offscreen images of the headless mode are allocated from it
   _createAllocator();
+  if (_isHeadless) {
+    _createOffscreenImages(settings->headlessExtent, settings->headlessImageCount);
+  } else {
+    _createSwapchain(settings->isFramerateLimited);
+  }
   _createCommandPool();
+  _createPipelineCache();
+
+  _stagingRing = std::make_unique<StagingRing>(_device, _allocator, _transferQueueIndex,
+                                               _transferQueue, _deviceCount);
+  trackMemory(MemoryCategory::kStaging, StagingRing::getCapacity());
+}
+
+VulkanApplicationContext::MemoryCategoryScope::MemoryCategoryScope(
+    VulkanApplicationContext *appContext, MemoryCategory category)
+    : _appContext(appContext), _previousCategory(appContext->_memoryCategory) {
+  _appContext->_memoryCategory = category;
+}
+
+VulkanApplicationContext::MemoryCategoryScope::~MemoryCategoryScope() {
+  _appContext->_memoryCategory = _previousCategory;
+}
+
+void VulkanApplicationContext::trackMemory(MemoryCategory category, VkDeviceSize size) {
+  _trackedMemorySizes[static_cast<size_t>(category)] += size;
+}
+
+void VulkanApplicationContext::untrackMemory(MemoryCategory category, VkDeviceSize size) {
+  _trackedMemorySizes[static_cast<size_t>(category)] -= size;
+}
+
+std::vector<VmaBudget> VulkanApplicationContext::getHeapBudgets() const {
+  VkPhysicalDeviceMemoryProperties const *memoryProperties = nullptr;
+  vmaGetMemoryProperties(_allocator, &memoryProperties);
+  std::vector<VmaBudget> budgets(memoryProperties->memoryHeapCount);
+  vmaGetHeapBudgets(_allocator, budgets.data());
+  return budgets;
+}
+
+bool VulkanApplicationContext::isDeviceLocalHeap(uint32_t heapIndex) const {
+  VkPhysicalDeviceMemoryProperties const *memoryProperties = nullptr;
+  vmaGetMemoryProperties(_allocator, &memoryProperties);
+  return (memoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+}
+
+bool VulkanApplicationContext::fitsDeviceMemoryBudget(VkDeviceSize size) const {
+  auto const budgets = getHeapBudgets();
+  for (uint32_t heapIndex = 0; heapIndex < budgets.size(); heapIndex++) {
+    if (isDeviceLocalHeap(heapIndex) &&
+        budgets[heapIndex].usage + size <= budgets[heapIndex].budget) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void VulkanApplicationContext::onSwapchainResize(bool isFramerateLimited) {
+  // the offscreen images keep the headless extent
+  if (_isHeadless) {
+    return;
+  }
+  _retiredSwapchains.push_back({_swapchain, std::move(_swapchainImageViews)});
+  _swapchainImageViews.clear();
+  _swapchainImages.clear();
+  _createSwapchain(isFramerateLimited);
+}
+
+void VulkanApplicationContext::destroyRetiredSwapchains() {
+  for (auto &retiredSwapchain : _retiredSwapchains) {
+    for (auto &imageView : retiredSwapchain.imageViews) {
+      vkDestroyImageView(_device, imageView, nullptr);
+    }
+    vkDestroySwapchainKHR(_device, retiredSwapchain.swapchain, nullptr);
+  }
+  _retiredSwapchains.clear();
+}
+
+void VulkanApplicationContext::_destroySwapchainImages() {
   for (auto &swapchainImageView : _swapchainImageViews) {
     vkDestroyImageView(_device, swapchainImageView, nullptr);
   }
+  _swapchainImageViews.clear();
+
+  for (size_t i = 0; i < _offscreenImageAllocations.size(); i++) {
+    VmaAllocationInfo allocInfo{};
+    vmaGetAllocationInfo(_allocator, _offscreenImageAllocations[i], &allocInfo);
+    untrackMemory(MemoryCategory::kRenderTargets, allocInfo.size);
+    vmaDestroyImage(_allocator, _swapchainImages[i], _offscreenImageAllocations[i]);
+  }
+  _offscreenImageAllocations.clear();
+  _swapchainImages.clear();
+
   vkDestroySwapchainKHR(_device, _swapchain, nullptr);
-  _createSwapchain(isFramerateLimited);
+  _swapchain = VK_NULL_HANDLE;
+}
+
+// mirrors the images of the swapchain, in the format that it prefers, they can be copied from too
+void VulkanApplicationContext::_createOffscreenImages(VkExtent2D extent, uint32_t imageCount) {
+  _swapchainSurfaceFormat = {VK_FORMAT_B8G8R8A8_UNORM, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+  _swapchainExtent        = extent;
+
+  VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageInfo.imageType     = VK_IMAGE_TYPE_2D;
+  imageInfo.format        = _swapchainSurfaceFormat.format;
+  imageInfo.extent        = {extent.width, extent.height, 1};
+  imageInfo.mipLevels     = 1;
+  imageInfo.arrayLayers   = 1;
+  imageInfo.samples       = VK_SAMPLE_COUNT_1_BIT;
+  imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
+  imageInfo.usage         = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                            VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+  imageInfo.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  VmaAllocationCreateInfo allocCreateInfo{};
+  allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+  _swapchainImages.resize(imageCount);
+  _swapchainImageViews.resize(imageCount);
+  _offscreenImageAllocations.resize(imageCount);
+  for (uint32_t i = 0; i < imageCount; i++) {
+    VmaAllocationInfo allocInfo{};
+    vmaCreateImage(_allocator, &imageInfo, &allocCreateInfo, &_swapchainImages[i],
+                   &_offscreenImageAllocations[i], &allocInfo);
+    trackMemory(MemoryCategory::kRenderTargets, allocInfo.size);
+
+    VkImageViewCreateInfo viewInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    viewInfo.image            = _swapchainImages[i];
+    viewInfo.viewType         = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format           = _swapchainSurfaceFormat.format;
+    viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vkCreateImageView(_device, &viewInfo, nullptr, &_swapchainImageViews[i]);
+  }
+  _logger->info("headless: {} offscreen images of {}x{}", imageCount, extent.width,
+                extent.height);
 }
 
 void VulkanApplicationContext::_createSwapchain(bool isFramerateLimited) {
-  ContextCreator::createSwapchain(_logger, isFramerateLimited, _swapchain, _swapchainImages,
-                                  _swapchainImageViews, _swapchainSurfaceFormat, _swapchainExtent,
-                                  _surface, _device, _physicalDevice, _queueFamilyIndices);
+  // the swapchain that is replaced has been retired already, if there's one
+  VkSwapchainKHR const oldSwapchain =
+      _retiredSwapchains.empty() ? VK_NULL_HANDLE : _retiredSwapchains.back().swapchain;
+  ContextCreator::createSwapchain(_logger, isFramerateLimited, _isLowLatencyPresent, _swapchain,
+                                  oldSwapchain, _swapchainImages, _swapchainImageViews,
+                                  _swapchainSurfaceFormat, _swapchainExtent, _surface, _device,
+                                  _physicalDevice, _queueFamilyIndices);
+}
+
+// the buffers of the device local heaps are copied from the other devices of the group
+bool VulkanApplicationContext::_checkPeerMemoryCopySupport() const {
+  VkPhysicalDeviceMemoryProperties memoryProperties{};
+  vkGetPhysicalDeviceMemoryProperties(_physicalDevice, &memoryProperties);
+  for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; heapIndex++) {
+    if ((memoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0) {
+      continue;
+    }
+    for (uint32_t remoteDeviceIndex = 1; remoteDeviceIndex < _deviceCount; remoteDeviceIndex++) {
+      VkPeerMemoryFeatureFlags peerMemoryFeatures = 0;
+      vkGetDeviceGroupPeerMemoryFeatures(_device, heapIndex, 0, remoteDeviceIndex,
+                                         &peerMemoryFeatures);
+      if ((peerMemoryFeatures & VK_PEER_MEMORY_FEATURE_COPY_SRC_BIT) == 0) {
+        _logger->info("the device {} of the group can't be copied from, only the first one is used",
+                      remoteDeviceIndex);
+        return false;
+      }
+    }
+  }
+  return true;
 }
 
 void VulkanApplicationContext::_createAllocator() {
@@ -132,12 +362,21 @@ void VulkanApplicationContext::_createAllocator() {
   allocatorInfo.device                 = _device;
   allocatorInfo.instance               = _vkInstance;
   allocatorInfo.pVulkanFunctions       = &vmaVulkanFunc;
+  // the acceleration structures are built from buffer addresses, and the octree pages can be read
+  // through theirs
+  if (_isBufferDeviceAddressSupported) {
+    allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+  }
+  if (_isMemoryBudgetSupported) {
+    allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+  }
 
   vmaCreateAllocator(&allocatorInfo, &_allocator);
 }
 
-// create a command pool for rendering commands and a command pool for gui
-// commands (imgui)
+// create a command pool for rendering commands, a command pool for gui
+// commands (imgui), a command pool for the async compute passes, and the pools of the recording
+// threads
 void VulkanApplicationContext::_createCommandPool() {
   VkCommandPoolCreateInfo commandPoolCreateInfo1{};
   commandPoolCreateInfo1.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -152,4 +391,71 @@ void VulkanApplicationContext::_createCommandPool() {
   commandPoolCreateInfo2.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
   vkCreateCommandPool(_device, &commandPoolCreateInfo2, nullptr, &_guiCommandPool);
+
+  VkCommandPoolCreateInfo commandPoolCreateInfo3{};
+  commandPoolCreateInfo3.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  commandPoolCreateInfo3.queueFamilyIndex = _queueFamilyIndices.computeFamily;
+
+  vkCreateCommandPool(_device, &commandPoolCreateInfo3, nullptr, &_asyncComputeCommandPool);
+
+  VkCommandPoolCreateInfo commandPoolCreateInfo4{};
+  commandPoolCreateInfo4.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  commandPoolCreateInfo4.queueFamilyIndex = _queueFamilyIndices.graphicsFamily;
+  // the frames in flight share the pools, so the command buffers of a frame that is recorded again
+  // are reset one by one, while the other frames are still executed
+  commandPoolCreateInfo4.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+  // the command buffers are recorded in groups that are far fewer than the cores
+  uint32_t constexpr kMaxRecordingThreadCount = 8;
+  _recordingCommandPools.resize(
+      std::max(1U, std::min(std::thread::hardware_concurrency(), kMaxRecordingThreadCount)));
+  for (auto &recordingCommandPool : _recordingCommandPools) {
+    vkCreateCommandPool(_device, &commandPoolCreateInfo4, nullptr, &recordingCommandPool);
+  }
+}
+
+// the cache of another device or driver is dropped, the pipelines are compiled from scratch then
+void VulkanApplicationContext::_createPipelineCache() {
+  std::vector<char> initialData{};
+  std::ifstream file(_getPathToPipelineCache(), std::ios::binary);
+  if (file.is_open()) {
+    initialData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_physicalDevice, &properties);
+  if (!initialData.empty() && !_isPipelineCacheCompatible(initialData, properties)) {
+    _logger->info("the pipeline cache belongs to another device or driver, it's discarded");
+    initialData.clear();
+  }
+
+  VkPipelineCacheCreateInfo pipelineCacheCreateInfo{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+  pipelineCacheCreateInfo.initialDataSize = initialData.size();
+  pipelineCacheCreateInfo.pInitialData    = initialData.empty() ? nullptr : initialData.data();
+  vkCreatePipelineCache(_device, &pipelineCacheCreateInfo, nullptr, &_pipelineCache);
+
+  _logger->info("pipeline cache created with {} bytes from the disk", initialData.size());
+}
+
+void VulkanApplicationContext::_savePipelineCache() {
+  if (_pipelineCache == VK_NULL_HANDLE) {
+    return;
+  }
+  size_t dataSize = 0;
+  vkGetPipelineCacheData(_device, _pipelineCache, &dataSize, nullptr);
+  std::vector<char> data(dataSize);
+  if (dataSize == 0 ||
+      vkGetPipelineCacheData(_device, _pipelineCache, &dataSize, data.data()) != VK_SUCCESS) {
+    return;
+  }
+
+  std::string const pathToFile = _getPathToPipelineCache();
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+  std::ofstream file(pathToFile, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    _logger->warn("failed to save the pipeline cache to {}", pathToFile);
+    return;
+  }
+  file.write(data.data(), static_cast<std::streamsize>(dataSize));
 }
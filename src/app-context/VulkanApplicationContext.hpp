@@ -2,6 +2,9 @@
 
 // this should be defined first for the definition of VK_VERSION_1_0, which is
 // used in glfw3.h
+#include "DeviceGroupSubmit.hpp"
+#include "MemoryCategory.hpp"
+#include "StagingRing.hpp"
 #include "context-creators/ContextCreators.hpp"
 #include "volk.h"
 
@@ -14,6 +17,9 @@
 #include "vma/vk_mem_alloc.h"
 #endif
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 class Logger;
@@ -22,6 +28,17 @@ class VulkanApplicationContext {
 public:
   struct GraphicsSettings {
     bool isFramerateLimited;
+    bool isLowLatencyPresent;
+    // there's no surface or swapchain then, the frames are delivered to offscreen images of the
+    // headless extent, one per frame in flight, in place of the swapchain images
+    bool isHeadless;
+    VkExtent2D headlessExtent;
+    uint32_t headlessImageCount;
+    // only honored if the device has a transfer-only queue family
+    bool isTransferQueueDedicated;
+    // the other physical devices of the group of the selected one join its logical device, only
+    // honored if it's in such a group
+    bool isDeviceGroupUsed;
   };
 
 public:
@@ -37,7 +54,41 @@ public:
   VulkanApplicationContext(VulkanApplicationContext &&)                 = delete;
   VulkanApplicationContext &operator=(VulkanApplicationContext &&)      = delete;
 
+  // the old swapchain is retired, not destroyed, its last images may still be presented, the
+  // caller destroys it once the frames that used it are done, the other resources are kept
   void onSwapchainResize(bool isFramerateLimited);
+  void destroyRetiredSwapchains();
+  [[nodiscard]] bool hasRetiredSwapchains() const { return !_retiredSwapchains.empty(); }
+
+  // the buffers and the images that are allocated while it's alive are tagged with the category
+  class MemoryCategoryScope {
+  public:
+    MemoryCategoryScope(VulkanApplicationContext *appContext, MemoryCategory category);
+    ~MemoryCategoryScope();
+
+    // disable move and copy
+    MemoryCategoryScope(const MemoryCategoryScope &)            = delete;
+    MemoryCategoryScope &operator=(const MemoryCategoryScope &) = delete;
+    MemoryCategoryScope(MemoryCategoryScope &&)                 = delete;
+    MemoryCategoryScope &operator=(MemoryCategoryScope &&)      = delete;
+
+  private:
+    VulkanApplicationContext *_appContext;
+    MemoryCategory _previousCategory;
+  };
+
+  [[nodiscard]] MemoryCategory getMemoryCategory() const { return _memoryCategory; }
+  void trackMemory(MemoryCategory category, VkDeviceSize size);
+  void untrackMemory(MemoryCategory category, VkDeviceSize size);
+  [[nodiscard]] VkDeviceSize getTrackedMemorySize(MemoryCategory category) const {
+    return _trackedMemorySizes[static_cast<size_t>(category)];
+  }
+
+  // one per memory heap, the budgets are reported by the driver if VK_EXT_memory_budget is there
+  [[nodiscard]] std::vector<VmaBudget> getHeapBudgets() const;
+  [[nodiscard]] bool isDeviceLocalHeap(uint32_t heapIndex) const;
+  // whether a device local heap can take the size without going over its budget
+  [[nodiscard]] bool fitsDeviceMemoryBudget(VkDeviceSize size) const;
 
   [[nodiscard]] inline const VkInstance &getVkInstance() const { return _vkInstance; }
   [[nodiscard]] inline const VkDevice &getDevice() const { return _device; }
@@ -46,7 +97,23 @@ public:
 
   [[nodiscard]] inline const VkCommandPool &getCommandPool() const { return _commandPool; }
   [[nodiscard]] inline const VkCommandPool &getGuiCommandPool() const { return _guiCommandPool; }
+  // a pool per recording thread, for the graphics queue, a pool is only used by one thread at a
+  // time
+  [[nodiscard]] inline const VkCommandPool &getRecordingCommandPool(size_t threadIndex) const {
+    return _recordingCommandPools[threadIndex];
+  }
+  [[nodiscard]] inline size_t getRecordingThreadCount() const {
+    return _recordingCommandPools.size();
+  }
+  // for the command buffers that are submitted to the async compute queue
+  [[nodiscard]] inline const VkCommandPool &getAsyncComputeCommandPool() const {
+    return _asyncComputeCommandPool;
+  }
   [[nodiscard]] inline const VmaAllocator &getAllocator() const { return _allocator; }
+  // shared by all of the pipelines, it's loaded from the disk, and saved back on destruction
+  [[nodiscard]] inline const VkPipelineCache &getPipelineCache() const { return _pipelineCache; }
+  // stages the transfers of the dedicated buffers, on the transfer queue
+  [[nodiscard]] inline StagingRing *getStagingRing() const { return _stagingRing.get(); }
   [[nodiscard]] inline const std::vector<VkImage> &getSwapchainImages() const {
     return _swapchainImages;
   }
@@ -67,29 +134,93 @@ public:
   [[nodiscard]] uint32_t getComputeQueueIndex() const { return _computeQueueIndex; }
   [[nodiscard]] uint32_t getTransferQueueIndex() const { return _transferQueueIndex; }
 
+  // the ray query extensions are optional, see rayQueryDeviceExtensions
+  [[nodiscard]] bool isRayQuerySupported() const { return _isRayQuerySupported; }
+  // the present ids and waits are optional, see presentWaitDeviceExtensions
+  [[nodiscard]] bool isPresentWaitSupported() const { return _isPresentWaitSupported; }
+  // the float16 arithmetic of the shaders is optional, it's enabled along with the core features
+  [[nodiscard]] bool isShaderFloat16Supported() const { return _isShaderFloat16Supported; }
+  // the buffer device addresses are core, but not every device of vulkan 1.2 has them
+  [[nodiscard]] bool isBufferDeviceAddressSupported() const {
+    return _isBufferDeviceAddressSupported;
+  }
+  // the buffer arrays of the descriptor sets can be partially bound, and updated after binding
+  [[nodiscard]] bool isDescriptorUpdateAfterBindSupported() const {
+    return _isDescriptorUpdateAfterBindSupported;
+  }
+  // a core feature, which is enabled along with the others if the device has it
+  [[nodiscard]] bool isPipelineStatisticsQuerySupported() const {
+    return _isPipelineStatisticsQuerySupported;
+  }
+  // the physical devices of the logical device, the first one renders and presents, the others
+  // only run the submissions that ask for them, see DeviceGroupSubmit
+  [[nodiscard]] uint32_t getDeviceCount() const { return _deviceCount; }
+  // whether the first device can copy from the memory instances of the others, through the buffers
+  // that are bound to them
+  [[nodiscard]] bool isPeerMemoryCopySupported() const { return _isPeerMemoryCopySupported; }
+  // the frames wait on their presents then, if they're supported
+  [[nodiscard]] bool isLowLatencyPresent() const { return _isLowLatencyPresent; }
+  // nothing is acquired or presented then, the swapchain getters return the offscreen images
+  [[nodiscard]] bool isHeadless() const { return _isHeadless; }
+
   [[nodiscard]] const VkQueue &getGraphicsQueue() const { return _graphicsQueue; }
   [[nodiscard]] const VkQueue &getPresentQueue() const { return _presentQueue; }
   [[nodiscard]] const VkQueue &getComputeQueue() const { return _computeQueue; }
   [[nodiscard]] const VkQueue &getTransferQueue() const { return _transferQueue; }
+  // of the compute family, see ContextCreator::QueueSelection
+  [[nodiscard]] const VkQueue &getAsyncComputeQueue() const { return _asyncComputeQueue; }
+  // otherwise the async passes have to be submitted along the graphics ones, since waiting on a
+  // later submission to the same queue would never return
+  [[nodiscard]] bool isAsyncComputeQueueSeparate() const {
+    return _asyncComputeQueue != _graphicsQueue;
+  }
+  // the transfer queue is the graphics queue itself, unless a dedicated one is requested, and the
+  // device has a transfer-only family
+  [[nodiscard]] bool isTransferQueueDedicated() const { return _transferQueue != _graphicsQueue; }
 
   [[nodiscard]] const ContextCreator::QueueFamilyIndices &getQueueFamilyIndices() const {
     return _queueFamilyIndices;
   }
 
+  // resources are shared between the graphics, the compute and the dedicated transfer queue
+  // without ownership transfers, this is empty if all of them are from the same family, so
+  // exclusive sharing can be used
+  [[nodiscard]] const std::vector<uint32_t> &getSharedQueueFamilyIndices() const {
+    return _sharedQueueFamilyIndices;
+  }
+
 private:
   // stores the indices of the each queue family, they might not overlap
   ContextCreator::QueueFamilyIndices _queueFamilyIndices;
+  std::vector<uint32_t> _sharedQueueFamilyIndices;
 
   ContextCreator::SwapchainSupportDetails _swapchainSupportDetails;
 
   GLFWwindow *_glWindow = nullptr;
   Logger *_logger       = nullptr;
 
-  VkInstance _vkInstance           = VK_NULL_HANDLE;
-  VkSurfaceKHR _surface            = VK_NULL_HANDLE;
-  VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
-  VkDevice _device                 = VK_NULL_HANDLE;
-  VmaAllocator _allocator          = VK_NULL_HANDLE;
+  VkInstance _vkInstance                     = VK_NULL_HANDLE;
+  VkSurfaceKHR _surface                      = VK_NULL_HANDLE;
+  VkPhysicalDevice _physicalDevice           = VK_NULL_HANDLE;
+  VkDevice _device                           = VK_NULL_HANDLE;
+  VmaAllocator _allocator                    = VK_NULL_HANDLE;
+  VkPipelineCache _pipelineCache             = VK_NULL_HANDLE;
+  bool _isRayQuerySupported                  = false;
+  bool _isPresentWaitSupported               = false;
+  bool _isMemoryBudgetSupported              = false;
+  bool _isShaderFloat16Supported             = false;
+  bool _isBufferDeviceAddressSupported       = false;
+  bool _isDescriptorUpdateAfterBindSupported = false;
+  bool _isPipelineStatisticsQuerySupported   = false;
+  bool _isLowLatencyPresent                  = false;
+  bool _isHeadless                           = false;
+  uint32_t _deviceCount                      = 1;
+  bool _isPeerMemoryCopySupported            = false;
+
+  MemoryCategory _memoryCategory = MemoryCategory::kUntagged;
+  // the buffers may be destroyed from other threads
+  std::array<std::atomic<VkDeviceSize>, static_cast<size_t>(MemoryCategory::kCount)>
+      _trackedMemorySizes{};
 
   // These queues are implicitly cleaned up when the device is destroyed
   uint32_t _graphicsQueueIndex = 0;
@@ -100,9 +231,14 @@ private:
   VkQueue _presentQueue        = VK_NULL_HANDLE;
   VkQueue _computeQueue        = VK_NULL_HANDLE;
   VkQueue _transferQueue       = VK_NULL_HANDLE;
+  VkQueue _asyncComputeQueue   = VK_NULL_HANDLE;
 
-  VkCommandPool _commandPool    = VK_NULL_HANDLE;
-  VkCommandPool _guiCommandPool = VK_NULL_HANDLE;
+  VkCommandPool _commandPool             = VK_NULL_HANDLE;
+  VkCommandPool _guiCommandPool          = VK_NULL_HANDLE;
+  VkCommandPool _asyncComputeCommandPool = VK_NULL_HANDLE;
+  std::vector<VkCommandPool> _recordingCommandPools{};
+
+  std::unique_ptr<StagingRing> _stagingRing;
 
   VkDebugUtilsMessengerEXT _debugMessager = VK_NULL_HANDLE;
 
@@ -112,12 +248,24 @@ private:
 
   std::vector<VkImage> _swapchainImages;
   std::vector<VkImageView> _swapchainImageViews;
+  struct RetiredSwapchain {
+    VkSwapchainKHR swapchain;
+    std::vector<VkImageView> imageViews;
+  };
+  std::vector<RetiredSwapchain> _retiredSwapchains;
+  // the memory of the offscreen images of the headless mode
+  std::vector<VmaAllocation> _offscreenImageAllocations;
 
   void _initWindow(uint8_t windowSize);
 
   void _createSwapchain(bool isFramerateLimited);
+  void _createOffscreenImages(VkExtent2D extent, uint32_t imageCount);
+  void _destroySwapchainImages();
   void _createAllocator();
+  [[nodiscard]] bool _checkPeerMemoryCopySupport() const;
   void _createCommandPool();
+  void _createPipelineCache();
+  void _savePipelineCache();
 
   static std::vector<const char *> _getRequiredInstanceExtensions();
   void _checkDeviceSuitable(VkSurfaceKHR surface, VkPhysicalDevice physicalDevice);
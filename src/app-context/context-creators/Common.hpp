@@ -3,15 +3,18 @@
 #include "volk.h"
 
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 namespace ContextCreator {
+uint32_t constexpr kInvalidQueueFamilyIndex = std::numeric_limits<uint32_t>::max();
+
 // stores the indices of the each queue family, they might not overlap
 struct QueueFamilyIndices {
-  uint32_t graphicsFamily = 0;
-  uint32_t presentFamily  = 0;
-  uint32_t computeFamily  = 0;
-  uint32_t transferFamily = 0;
+  uint32_t graphicsFamily = kInvalidQueueFamilyIndex;
+  uint32_t presentFamily  = kInvalidQueueFamilyIndex;
+  uint32_t computeFamily  = kInvalidQueueFamilyIndex;
+  uint32_t transferFamily = kInvalidQueueFamilyIndex;
 };
 
 struct SwapchainSupportDetails {
@@ -3,11 +3,15 @@
 #include "Common.hpp"
 #include "utils/logger/Logger.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <set>
 namespace {
 bool _queueIndicesAreFilled(const ContextCreator::QueueFamilyIndices &indices) {
-  return indices.computeFamily != -1 && indices.transferFamily != -1 &&
-         indices.graphicsFamily != -1 && indices.presentFamily != -1;
+  return indices.computeFamily != ContextCreator::kInvalidQueueFamilyIndex &&
+         indices.transferFamily != ContextCreator::kInvalidQueueFamilyIndex &&
+         indices.graphicsFamily != ContextCreator::kInvalidQueueFamilyIndex &&
+         indices.presentFamily != ContextCreator::kInvalidQueueFamilyIndex;
 }
 
 bool _findQueueFamilies(ContextCreator::QueueFamilyIndices &indices,
@@ -20,34 +24,49 @@ bool _findQueueFamilies(ContextCreator::QueueFamilyIndices &indices,
   for (uint32_t i = 0; i < queueFamilyCount; ++i) {
     const auto &queueFamily = queueFamilies[i];
 
-    if (indices.computeFamily == -1) {
-      if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != 0) {
+    // a compute-only family is preferred, so that the svo builder can run asynchronously to the
+    // rendering
+    if (indices.computeFamily == ContextCreator::kInvalidQueueFamilyIndex) {
+      if ((queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) != 0 &&
+          (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0) {
         indices.computeFamily = i;
       }
     }
 
-    if (indices.transferFamily == -1) {
-      if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) != 0) {
+    // a transfer-only family is preferred too, so the streaming is submitted apart from the
+    // graphics and the compute queues
+    if (indices.transferFamily == ContextCreator::kInvalidQueueFamilyIndex) {
+      if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) != 0 &&
+          (queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == 0) {
         indices.transferFamily = i;
       }
     }
 
-    if (indices.graphicsFamily == -1) {
+    if (indices.graphicsFamily == ContextCreator::kInvalidQueueFamilyIndex) {
       if ((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0) {
-        uint32_t presentSupport = 0;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+        // nothing is presented without a surface, in the headless mode
+        uint32_t presentSupport = surface == VK_NULL_HANDLE ? 1 : 0;
+        if (surface != VK_NULL_HANDLE) {
+          vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &presentSupport);
+        }
         if (presentSupport != 0) {
           indices.graphicsFamily = i;
           indices.presentFamily  = i;
         }
       }
     }
+  }
 
-    if (_queueIndicesAreFilled(indices)) {
-      return true;
-    }
+  // graphics families always support compute, so fall back to it if there's no dedicated one
+  if (indices.computeFamily == ContextCreator::kInvalidQueueFamilyIndex) {
+    indices.computeFamily = indices.graphicsFamily;
   }
-  return false;
+  // the same for the transfers, which the graphics families support implicitly
+  if (indices.transferFamily == ContextCreator::kInvalidQueueFamilyIndex) {
+    indices.transferFamily = indices.graphicsFamily;
+  }
+
+  return _queueIndicesAreFilled(indices);
 }
 
 bool _checkDeviceExtensionSupport(Logger *logger, const VkPhysicalDevice &physicalDevice,
@@ -91,6 +110,27 @@ bool _checkDeviceExtensionSupport(Logger *logger, const VkPhysicalDevice &physic
   return false;
 }
 
+// unlike the required extensions, the missing ones are not reported
+bool _areDeviceExtensionsAvailable(const VkPhysicalDevice &physicalDevice,
+                                   const std::vector<const char *> &deviceExtensions) {
+  uint32_t extensionCount = 0;
+  vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+
+  std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+  vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount,
+                                       availableExtensions.data());
+
+  std::set<std::string> availableExtensionsSet{};
+  for (const auto &extension : availableExtensions) {
+    availableExtensionsSet.insert(static_cast<const char *>(extension.extensionName));
+  }
+  return std::all_of(deviceExtensions.begin(), deviceExtensions.end(),
+                     [&availableExtensionsSet](const char *extensionName) {
+                       return availableExtensionsSet.find(extensionName) !=
+                              availableExtensionsSet.end();
+                     });
+}
+
 // this function is also called in swapchain creation step
 // so check if this overhead can be eliminated
 // query for physical device's swapchain sepport details
@@ -132,8 +172,8 @@ void checkDeviceSuitable(Logger *logger, const VkSurfaceKHR &surface,
   // Check extension support
   bool extensionSupported =
       _checkDeviceExtensionSupport(logger, physicalDevice, requiredDeviceExtensions);
-  bool swapChainAdequate = false;
-  if (extensionSupported) {
+  bool swapChainAdequate = surface == VK_NULL_HANDLE;
+  if (extensionSupported && surface != VK_NULL_HANDLE) {
     ContextCreator::SwapchainSupportDetails swapChainSupport =
         querySwapchainSupport(surface, physicalDevice);
     swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
@@ -228,6 +268,30 @@ VkPhysicalDevice selectBestDevice(Logger *logger,
   }
   return bestDevice;
 }
+
+// the physical devices of the group of the selected one, which goes first, so that it's the device
+// index 0 of the logical device, only the selected one is returned if it isn't in a larger group
+std::vector<VkPhysicalDevice> _getDeviceGroupOf(VkInstance instance,
+                                                VkPhysicalDevice physicalDevice) {
+  uint32_t groupCount = 0;
+  vkEnumeratePhysicalDeviceGroups(instance, &groupCount, nullptr);
+  std::vector<VkPhysicalDeviceGroupProperties> groups(
+      groupCount, {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES});
+  vkEnumeratePhysicalDeviceGroups(instance, &groupCount, groups.data());
+
+  for (auto const &group : groups) {
+    auto const *begin = group.physicalDevices;
+    auto const *end   = group.physicalDevices + group.physicalDeviceCount;
+    if (std::find(begin, end, physicalDevice) == end) {
+      continue;
+    }
+    std::vector<VkPhysicalDevice> groupDevices{physicalDevice};
+    std::copy_if(begin, end, std::back_inserter(groupDevices),
+                 [physicalDevice](VkPhysicalDevice other) { return other != physicalDevice; });
+    return groupDevices;
+  }
+  return {physicalDevice};
+}
 } // namespace
 
 // pick the most suitable physical device, and create logical device from it
@@ -235,7 +299,17 @@ void ContextCreator::createDevice(Logger *logger, VkPhysicalDevice &physicalDevi
                                   VkDevice &device, QueueFamilyIndices &indices,
                                   QueueSelection &queueSelection, const VkInstance &instance,
                                   VkSurfaceKHR surface,
-                                  const std::vector<const char *> &requiredDeviceExtensions) {
+                                  const std::vector<const char *> &requiredDeviceExtensions,
+                                  const std::vector<const char *> &rayQueryDeviceExtensions,
+                                  bool &isRayQuerySupported,
+                                  const std::vector<const char *> &presentWaitDeviceExtensions,
+                                  bool &isPresentWaitSupported,
+                                  const std::vector<const char *> &memoryBudgetDeviceExtensions,
+                                  bool &isMemoryBudgetSupported, bool &isShaderFloat16Supported,
+                                  bool &isBufferDeviceAddressSupported,
+                                  bool &isDescriptorUpdateAfterBindSupported,
+                                  bool &isPipelineStatisticsQuerySupported,
+                                  bool isDeviceGroupRequested, uint32_t &groupDeviceCount) {
   // pick the physical device with the best performance
   {
     physicalDevice = VK_NULL_HANDLE;
@@ -259,52 +333,186 @@ void ContextCreator::createDevice(Logger *logger, VkPhysicalDevice &physicalDevi
     std::set<uint32_t> queueFamilyIndicesSet = {indices.graphicsFamily, indices.presentFamily,
                                                 indices.computeFamily, indices.transferFamily};
 
+    // the compute family gets a second queue if it has one, the tracer submits its async passes
+    // there, while the svo builder keeps the first one
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
+                                             queueFamilies.data());
+    uint32_t const computeQueueCount =
+        std::min(queueFamilies[indices.computeFamily].queueCount, 2U);
+
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    float queuePriority = 1.F; // ranges from 0 - 1.;
+    std::vector<float> queuePriorities(computeQueueCount, 1.F); // ranges from 0 - 1.;
     for (uint32_t queueFamilyIndex : queueFamilyIndicesSet) {
       VkDeviceQueueCreateInfo queueCreateInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
       queueCreateInfo.queueFamilyIndex = queueFamilyIndex;
-      queueCreateInfo.queueCount       = 1;
-      queueCreateInfo.pQueuePriorities = &queuePriority;
+      queueCreateInfo.queueCount =
+          queueFamilyIndex == indices.computeFamily ? computeQueueCount : 1;
+      queueCreateInfo.pQueuePriorities = queuePriorities.data();
       queueCreateInfos.push_back(queueCreateInfo);
     }
 
     VkPhysicalDeviceFeatures2 physicalDeviceFeatures{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
 
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexing = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
+
+    // the half precision filters are optional, the features are core in vulkan 1.2, so they're
+    // always chained, and enabled whenever the device reports them
+    VkPhysicalDeviceShaderFloat16Int8Features shaderFloat16Int8 = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES};
+    descriptorIndexing.pNext = &shaderFloat16Int8;
+
+    // used to hand over the edited chunks from the compute queue to the rendering
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineSemaphore = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES};
+    shaderFloat16Int8.pNext = &timelineSemaphore;
+
+    // core in vulkan 1.2 as well, needed by the acceleration structures, and by the tracer if it
+    // reads the octree pages through their addresses
     VkPhysicalDeviceBufferDeviceAddressFeatures bufferDeviceAddress = {
         VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES};
-    bufferDeviceAddress.bufferDeviceAddress = VK_TRUE;
-
-    VkPhysicalDeviceRayTracingPipelineFeaturesKHR rayTracingPipeline = {
-        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR};
-    rayTracingPipeline.pNext              = &bufferDeviceAddress;
-    rayTracingPipeline.rayTracingPipeline = VK_TRUE;
+    timelineSemaphore.pNext = &bufferDeviceAddress;
 
-    VkPhysicalDeviceAccelerationStructureFeaturesKHR rayTracingStructure = {
+    // the ray queries are optional, the tracer falls back to its dda over the chunks without them,
+    // their features can only be chained if the extensions are enabled
+    VkPhysicalDeviceAccelerationStructureFeaturesKHR accelerationStructure = {
         VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR};
-    rayTracingStructure.pNext                 = &rayTracingPipeline;
-    rayTracingStructure.accelerationStructure = VK_TRUE;
 
-    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexing = {
-        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES};
-    // descriptorIndexing.pNext = &rayTracingStructure; // uncomment this to
-    // enable the features above
+    VkPhysicalDeviceRayQueryFeaturesKHR rayQuery = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR};
+    rayQuery.pNext = &accelerationStructure;
+
+    // the present ids are waited on by the low latency present mode, which is optional as well
+    VkPhysicalDevicePresentIdFeaturesKHR presentId = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWait = {
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+    presentWait.pNext = &presentId;
+
+    // the optional groups are chained after the buffer device address features, in this order
+    auto const chainOptionalFeatures = [&]() {
+      void **chainTail            = &bufferDeviceAddress.pNext;
+      *chainTail                  = nullptr;
+      accelerationStructure.pNext = nullptr;
+      presentId.pNext             = nullptr;
+      if (isRayQuerySupported) {
+        *chainTail = &rayQuery;
+        chainTail  = &accelerationStructure.pNext;
+      }
+      if (isPresentWaitSupported) {
+        *chainTail = &presentWait;
+      }
+    };
+
+    isRayQuerySupported = _areDeviceExtensionsAvailable(physicalDevice, rayQueryDeviceExtensions);
+
+    isPresentWaitSupported =
+        _areDeviceExtensionsAvailable(physicalDevice, presentWaitDeviceExtensions);
+    chainOptionalFeatures();
 
     physicalDeviceFeatures.pNext = &descriptorIndexing;
 
     vkGetPhysicalDeviceFeatures2(physicalDevice,
                                  &physicalDeviceFeatures); // enable all the features our GPU has
 
+    if (timelineSemaphore.timelineSemaphore == VK_FALSE) {
+      logger->error("timeline semaphores are not supported by the device!");
+    }
+
+    isBufferDeviceAddressSupported = bufferDeviceAddress.bufferDeviceAddress == VK_TRUE;
+
+    // the buffer arrays are partially bound, and their unused elements are written while the sets
+    // are in use then, see DescriptorSetBundle
+    isDescriptorUpdateAfterBindSupported =
+        descriptorIndexing.descriptorBindingPartiallyBound == VK_TRUE &&
+        descriptorIndexing.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+        descriptorIndexing.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE &&
+        descriptorIndexing.descriptorBindingUniformTexelBufferUpdateAfterBind == VK_TRUE;
+
+    // only queried by the pass profiler, which leaves the statistics out without it
+    isPipelineStatisticsQuerySupported =
+        physicalDeviceFeatures.features.pipelineStatisticsQuery == VK_TRUE;
+
+    isShaderFloat16Supported = shaderFloat16Int8.shaderFloat16 == VK_TRUE;
+    if (isShaderFloat16Supported) {
+      logger->info("float16 arithmetic is supported by the device");
+    } else {
+      logger->info("float16 arithmetic is not supported by the device, the filters stay in 32 "
+                   "bits");
+    }
+
+    std::vector<const char *> enabledDeviceExtensions = requiredDeviceExtensions;
+    if (isRayQuerySupported) {
+      isRayQuerySupported = rayQuery.rayQuery == VK_TRUE &&
+                            accelerationStructure.accelerationStructure == VK_TRUE &&
+                            isBufferDeviceAddressSupported;
+    }
+    if (isRayQuerySupported) {
+      enabledDeviceExtensions.insert(enabledDeviceExtensions.end(),
+                                     rayQueryDeviceExtensions.begin(),
+                                     rayQueryDeviceExtensions.end());
+      logger->info("ray queries are supported by the device");
+    } else {
+      logger->info("ray queries are not supported by the device, the chunks are marched with dda");
+    }
+
+    if (isPresentWaitSupported) {
+      isPresentWaitSupported =
+          presentWait.presentWait == VK_TRUE && presentId.presentId == VK_TRUE;
+    }
+    if (isPresentWaitSupported) {
+      enabledDeviceExtensions.insert(enabledDeviceExtensions.end(),
+                                     presentWaitDeviceExtensions.begin(),
+                                     presentWaitDeviceExtensions.end());
+      logger->info("present waits are supported by the device");
+    } else {
+      logger->info("present waits are not supported by the device, the low latency present mode "
+                   "only prefers the mailbox");
+    }
+
+    // it has no features, the allocator estimates the budgets from the heap sizes without it
+    isMemoryBudgetSupported =
+        _areDeviceExtensionsAvailable(physicalDevice, memoryBudgetDeviceExtensions);
+    if (isMemoryBudgetSupported) {
+      enabledDeviceExtensions.insert(enabledDeviceExtensions.end(),
+                                     memoryBudgetDeviceExtensions.begin(),
+                                     memoryBudgetDeviceExtensions.end());
+    }
+    chainOptionalFeatures();
+
+    // the features are those of the selected device, the devices of a group are the same model
+    std::vector<VkPhysicalDevice> groupDevices{physicalDevice};
+    if (isDeviceGroupRequested) {
+      groupDevices = _getDeviceGroupOf(instance, physicalDevice);
+    }
+    groupDeviceCount = static_cast<uint32_t>(groupDevices.size());
+    VkDeviceGroupDeviceCreateInfo deviceGroup{VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO};
+    deviceGroup.pNext               = &physicalDeviceFeatures;
+    deviceGroup.physicalDeviceCount = groupDeviceCount;
+    deviceGroup.pPhysicalDevices    = groupDevices.data();
+    if (groupDeviceCount > 1) {
+      logger->info("the logical device spans a group of {} physical devices", groupDeviceCount);
+    } else if (isDeviceGroupRequested) {
+      logger->info("the device isn't in a group of several physical devices, only it is used");
+    }
+
     VkDeviceCreateInfo deviceCreateInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
     deviceCreateInfo.pNext                = &physicalDeviceFeatures;
     deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     deviceCreateInfo.pQueueCreateInfos    = queueCreateInfos.data();
+    if (groupDeviceCount > 1) {
+      deviceCreateInfo.pNext = &deviceGroup;
+    }
     // createInfo.pEnabledFeatures = &deviceFeatures;
     deviceCreateInfo.pEnabledFeatures = nullptr;
 
     // enabling device extensions
-    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(requiredDeviceExtensions.size());
-    deviceCreateInfo.ppEnabledExtensionNames = requiredDeviceExtensions.data();
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(enabledDeviceExtensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = enabledDeviceExtensions.data();
 
     // The enabledLayerCount and ppEnabledLayerNames fields of
     // VkDeviceCreateInfo are ignored by up-to-date implementations.
@@ -328,6 +536,8 @@ void ContextCreator::createDevice(Logger *logger, VkPhysicalDevice &physicalDevi
     vkGetDeviceQueue(device, indices.presentFamily, 0, &queueSelection.presentQueue);
     vkGetDeviceQueue(device, indices.computeFamily, 0, &queueSelection.computeQueue);
     vkGetDeviceQueue(device, indices.transferFamily, 0, &queueSelection.transferQueue);
+    vkGetDeviceQueue(device, indices.computeFamily, computeQueueCount - 1,
+                     &queueSelection.asyncComputeQueue);
 
     // // if raytracing support requested - let's get raytracing properties to
     // // know shader header size and max recursion
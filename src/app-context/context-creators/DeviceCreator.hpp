@@ -18,10 +18,23 @@ struct QueueSelection {
   VkQueue presentQueue;
   VkQueue computeQueue;
   VkQueue transferQueue;
+  // a second queue of the compute family, which is the compute queue itself if the family only has
+  // one, and the graphics queue if that family is shared with the graphics as well
+  VkQueue asyncComputeQueue;
 };
 
 void createDevice(Logger *logger, VkPhysicalDevice &physicalDevice, VkDevice &device,
                   QueueFamilyIndices &indices, QueueSelection &queueSelection,
                   const VkInstance &instance, VkSurfaceKHR surface,
-                  const std::vector<const char *> &requiredDeviceExtensions);
+                  const std::vector<const char *> &requiredDeviceExtensions,
+                  const std::vector<const char *> &rayQueryDeviceExtensions,
+                  bool &isRayQuerySupported,
+                  const std::vector<const char *> &presentWaitDeviceExtensions,
+                  bool &isPresentWaitSupported,
+                  const std::vector<const char *> &memoryBudgetDeviceExtensions,
+                  bool &isMemoryBudgetSupported, bool &isShaderFloat16Supported,
+                  bool &isBufferDeviceAddressSupported,
+                  bool &isDescriptorUpdateAfterBindSupported,
+                  bool &isPipelineStatisticsQuerySupported, bool isDeviceGroupRequested,
+                  uint32_t &groupDeviceCount);
 } // namespace ContextCreator
@@ -649,12 +649,14 @@ _chooseSwapSurfaceFormat(Logger *logger, const std::vector<VkSurfaceFormatKHR> &
   return availableFormats[0];
 }
 
-// choose the present mode of the swapchain
+// choose the present mode of the swapchain, the low latency mode always prefers the mailbox, the
+// frames are paced by waiting on their presents then, if the device supports it
 VkPresentModeKHR
-_chooseSwapPresentMode(Logger *logger, bool isFramerateLimited,
+_chooseSwapPresentMode(Logger *logger, bool isFramerateLimited, bool isLowLatencyPresent,
                        const std::vector<VkPresentModeKHR> &availablePresentModes) {
   VkPresentModeKHR preferredPresentMode =
-      isFramerateLimited ? VK_PRESENT_MODE_FIFO_RELAXED_KHR : VK_PRESENT_MODE_MAILBOX_KHR;
+      isFramerateLimited && !isLowLatencyPresent ? VK_PRESENT_MODE_FIFO_RELAXED_KHR
+                                                 : VK_PRESENT_MODE_MAILBOX_KHR;
 
   std::unordered_set<VkPresentModeKHR> availablePresentModesSet(availablePresentModes.begin(),
                                                                 availablePresentModes.end());
@@ -680,7 +682,8 @@ VkExtent2D _getSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities, Logger *
 } // namespace
 
 void ContextCreator::createSwapchain(Logger *logger, bool isFramerateLimited,
-                                     VkSwapchainKHR &swapchain,
+                                     bool isLowLatencyPresent, VkSwapchainKHR &swapchain,
+                                     VkSwapchainKHR oldSwapchain,
                                      std::vector<VkImage> &swapchainImages,
                                      std::vector<VkImageView> &swapchainImageViews,
                                      VkSurfaceFormatKHR &surfaceFormat, VkExtent2D &swapchainExtent,
@@ -706,7 +709,8 @@ void ContextCreator::createSwapchain(Logger *logger, bool isFramerateLimited,
   logger->println();
 
   VkPresentModeKHR presentMode =
-      _chooseSwapPresentMode(logger, isFramerateLimited, swapchainSupport.presentModes);
+      _chooseSwapPresentMode(logger, isFramerateLimited, isLowLatencyPresent,
+                             swapchainSupport.presentModes);
 
   swapchainExtent = _getSwapExtent(swapchainSupport.capabilities, logger);
 
@@ -754,7 +758,9 @@ void ContextCreator::createSwapchain(Logger *logger, bool isFramerateLimited,
   swapchainCreateInfo.presentMode = presentMode;
   swapchainCreateInfo.clipped     = VK_TRUE;
 
-  swapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+  // the images of the old one that are still presented stay valid, the rest are freed by the
+  // driver
+  swapchainCreateInfo.oldSwapchain = oldSwapchain;
 
   vkCreateSwapchainKHR(device, &swapchainCreateInfo, nullptr, &swapchain);
 
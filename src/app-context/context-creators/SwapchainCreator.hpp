@@ -4,7 +4,9 @@
 
 class Logger;
 namespace ContextCreator {
-void createSwapchain(Logger *logger, bool isFramerateLimited, VkSwapchainKHR &swapchain,
+// the old swapchain is retired by the new one, it may be VK_NULL_HANDLE
+void createSwapchain(Logger *logger, bool isFramerateLimited, bool isLowLatencyPresent,
+                     VkSwapchainKHR &swapchain, VkSwapchainKHR oldSwapchain,
                      std::vector<VkImage> &swapchainImages,
                      std::vector<VkImageView> &swapchainImageViews,
                      VkSurfaceFormatKHR &swapchainImageFormat, VkExtent2D &swapchainExtent,
@@ -1,40 +1,185 @@
 #include "application/Application.hpp"
 
+#include "Benchmark.hpp"
+#include "DynamicObjectDemo.hpp"
+#include "EditSession.hpp"
+#include "FrameDumper.hpp"
 #include "svo-builder/SvoBuilder.hpp"
 #include "svo-tracer/SvoTracer.hpp"
+#include "svo-tracer/TracingPassProfiler.hpp"
 
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/ApplicationInfo.hpp"
+#include "config-container/sub-config/BenchmarkInfo.hpp"
+#include "config-container/sub-config/BrushInfo.hpp"
+#include "config-container/sub-config/SvoBuilderInfo.hpp"
+#include "config-container/sub-config/SvoTracerInfo.hpp"
+#include "config-container/sub-config/TerrainInfo.hpp"
 
 #include "BlockState.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "imgui-manager/gui-manager/ImguiManager.hpp"
+#include "utils/config/RootDir.h"
 #include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
 #include "utils/fps-sink/FpsSink.hpp"
 #include "utils/logger/Logger.hpp"
+#include "utils/pass-time-sink/PassTimeSink.hpp"
+#include "utils/traversal-stats-sink/TraversalStatsSink.hpp"
 #include "utils/shader-compiler/ShaderCompiler.hpp"
+#include "utils/startup-trace/StartupTrace.hpp"
 #include "window/CursorInfo.hpp"
 #include "window/Window.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+
+#ifdef __APPLE__
+#define GLFW_THUMB_KEY GLFW_KEY_LEFT_SUPER
+#else
+#define GLFW_THUMB_KEY GLFW_KEY_LEFT_CONTROL
+#endif
+
+namespace {
+// every frame signals three values of the frame timeline in this order, the async compute one is
+// skipped if there's nothing to submit to that queue
+enum FrameTimelineStage : uint64_t {
+  kChunkOccupancyDone = 1,
+  kAsyncComputeDone   = 2,
+  kFrameDone          = 3,
+};
+uint64_t constexpr kFrameTimelineStride = 3;
+
+uint64_t _getFrameTimelineValue(uint64_t frame, FrameTimelineStage stage) {
+  return frame * kFrameTimelineStride + stage;
+}
+
+// the presents aren't completed while the window is occluded, the frames go on without the wait
+uint64_t constexpr kPresentWaitTimeoutNs = 100'000'000;
+
+// the sleeps of the frame limiter wake up this much before the deadline, which covers the
+// granularity of the os timers, the rest is spun
+auto constexpr kFrameLimiterSpinMargin = std::chrono::microseconds(1500);
+
+double _toMs(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+} // namespace
 
 // https://www.reddit.com/r/vulkan/comments/10io2l8/is_framesinflight_fif_method_really_worth_it/
 Application::Application(Logger *logger) : _logger(logger) {
+  StartupTrace::get().start();
   _appContext              = std::make_unique<VulkanApplicationContext>();
   _configContainer         = std::make_unique<ConfigContainer>(_logger);
-  _shaderFileWatchListener = std::make_unique<ShaderChangeListener>(_logger);
+  _shaderCompiler          = std::make_unique<ShaderCompiler>(logger);
+  _shaderFileWatchListener = std::make_unique<ShaderChangeListener>(_logger, _shaderCompiler.get());
 
-  _shaderCompiler = std::make_unique<ShaderCompiler>(
-      logger, [this](std::string const &fullPathToIncludedShaderFile) {
-        _shaderFileWatchListener->appendShaderFileToLastWatchedPipeline(
-            fullPathToIncludedShaderFile);
-      });
+  // the headless mode renders to offscreen images of the given resolution, its window is never
+  // shown, and only stands in for the input and the close request of the benchmark
+  auto const *applicationInfo = _configContainer->applicationInfo.get();
+  {
+    StartupTrace::Scope scope("window");
+    if (applicationInfo->isHeadless) {
+      _window = std::make_unique<Window>(WindowStyle::kHeadless, logger,
+                                         applicationInfo->headlessResolution[0],
+                                         applicationInfo->headlessResolution[1]);
+    } else {
+      _window = std::make_unique<Window>(WindowStyle::kMaximized, logger);
+    }
+  }
 
-  _window = std::make_unique<Window>(WindowStyle::kMaximized, logger);
+  // the benchmark measures how fast the frames can go, the swapchain is created without the limit
+  if (_configContainer->benchmarkInfo->enabled) {
+    _configContainer->applicationInfo->isFramerateLimited = false;
+    _benchmark = std::make_unique<Benchmark>(_logger, _configContainer->benchmarkInfo.get());
+  } else if (!_configContainer->benchmarkInfo->recordEditSessionFile.empty()) {
+    _editSessionRecording = std::make_unique<EditSession>(_logger);
+  }
 
   VulkanApplicationContext::GraphicsSettings settings{};
-  settings.isFramerateLimited = _configContainer->applicationInfo->isFramerateLimited;
-  _appContext->init(_logger, _window->getGlWindow(), &settings);
+  settings.isFramerateLimited  = _configContainer->applicationInfo->isFramerateLimited;
+  settings.isLowLatencyPresent = _configContainer->applicationInfo->isLowLatencyPresent;
+  settings.isHeadless          = applicationInfo->isHeadless;
+  settings.headlessExtent      = {static_cast<uint32_t>(applicationInfo->headlessResolution[0]),
+                                  static_cast<uint32_t>(applicationInfo->headlessResolution[1])};
+  // one offscreen image per frame in flight, which is then the image index of the frame
+  settings.headlessImageCount       = applicationInfo->framesInFlight;
+  settings.isTransferQueueDedicated = applicationInfo->isTransferQueueDedicated;
+  settings.isDeviceGroupUsed        = applicationInfo->isDeviceGroupUsed;
+  {
+    StartupTrace::Scope scope("vulkan context");
+    _appContext->init(_logger, _window->getGlWindow(), &settings);
+  }
+  // the shaders are only compiled from here on, the tracer marches the chunks with ray queries if
+  // this is defined
+  if (_appContext->isRayQuerySupported()) {
+    _shaderCompiler->addMacroDefinition("SUPPORTS_RAY_QUERY");
+  }
+  // the octree marching keeps a short stack, and restarts from the root past it
+  if (_configContainer->svoTracerInfo->shortStackSize > 0) {
+    _shaderCompiler->addMacroDefinition(
+        "SVO_SHORT_STACK_SIZE",
+        std::to_string(_configContainer->svoTracerInfo->shortStackSize) + "u");
+  }
+  // the position history is replaced by a depth history
+  if (_configContainer->svoTracerInfo->positionFromDepth) {
+    _shaderCompiler->addMacroDefinition("POSITION_FROM_DEPTH");
+  }
+  // the primary rays start near the voxels of the last frame
+  if (_configContainer->svoTracerInfo->depthReprojection) {
+    _shaderCompiler->addMacroDefinition("DEPTH_REPROJECTION");
+  }
+  // the temporal filter outputs to the ping image, which the fused a-trous iterations read
+  if (_configContainer->svoTracerInfo->aTrousFused) {
+    _shaderCompiler->addMacroDefinition("ATROUS_FUSED");
+  }
+  // the a-trous iterations are dispatched over the tiles that the temporal filter queues
+  if (_configContainer->svoTracerInfo->aTrousAdaptive) {
+    _shaderCompiler->addMacroDefinition("ATROUS_ADAPTIVE");
+  }
+  // the tracing skips the secondary rays of the tiles that the temporal filter found converged
+  if (_configContainer->svoTracerInfo->adaptiveSampling) {
+    _shaderCompiler->addMacroDefinition("ADAPTIVE_SAMPLING");
+  }
+  // both of the above need the noise of the temporal mean
+  if (_configContainer->svoTracerInfo->aTrousAdaptive ||
+      _configContainer->svoTracerInfo->adaptiveSampling) {
+    _shaderCompiler->addMacroDefinition("TEMPORAL_MOMENTS");
+  }
+  // the octree nodes are fetched from the texel buffer views of the pages
+  if (_configContainer->svoTracerInfo->octreeTexelBuffer) {
+    _shaderCompiler->addMacroDefinition("OCTREE_TEXEL_BUFFER");
+  }
+  // or through the addresses of the pages, the builder and the tracer are created with the option
+  // cleared if the device can't do that
+  if (_configContainer->svoTracerInfo->octreeDeviceAddress) {
+    if (_appContext->isBufferDeviceAddressSupported()) {
+      _shaderCompiler->addMacroDefinition("OCTREE_DEVICE_ADDRESS");
+    } else {
+      _logger->info("buffer device addresses are not supported by the device, the octree pages "
+                    "are read through the storage buffers");
+      _configContainer->svoTracerInfo->octreeDeviceAddress = false;
+    }
+  }
+  // the filters compute their weights and blends in 16 bits
+  if (_configContainer->svoTracerInfo->halfPrecisionFilters) {
+    if (_appContext->isShaderFloat16Supported()) {
+      _shaderCompiler->addMacroDefinition("HALF_PRECISION_FILTERS");
+    } else {
+      _logger->info("half precision filters are not supported by the device, they're disabled");
+    }
+  }
+  // the lowest octaves of the terrain noise are filtered from the volume that the builder bakes
+  if (_configContainer->terrainInfo->bakedNoiseOctaveCount > 0) {
+    _shaderCompiler->addMacroDefinition(
+        "BAKED_NOISE_OCTAVE_COUNT",
+        std::to_string(_configContainer->terrainInfo->bakedNoiseOctaveCount));
+  }
+  _prewarmShaders();
 
   _svoBuilder =
       std::make_unique<SvoBuilder>(_appContext.get(), _logger, _shaderCompiler.get(),
@@ -49,11 +194,19 @@ Application::Application(Logger *logger) : _logger(logger) {
 
   _fpsSink = std::make_unique<FpsSink>();
 
+  if ((applicationInfo->isHeadless && applicationInfo->dumpHeadlessFrames) ||
+      (!applicationInfo->isHeadless && applicationInfo->frameRecording)) {
+    _frameDumper = std::make_unique<FrameDumper>(_logger, kPathToResourceFolder + "frames/");
+  }
+
   _init();
 
   GlobalEventDispatcher::get()
       .sink<E_RenderLoopBlockRequest>()
       .connect<&Application::_onRenderLoopBlockRequest>(this);
+  GlobalEventDispatcher::get()
+      .sink<E_OctreeBufferPageAdded>()
+      .connect<&Application::_onOctreeBufferPageAdded>(this);
 }
 
 Application::~Application() { GlobalEventDispatcher::get().disconnect<>(this); }
@@ -66,10 +219,33 @@ void Application::run() {
 void Application::_cleanup() {
   _logger->info("application is cleaning up resources...");
 
+  for (auto const &[typeName, queueLatency] : GlobalEventDispatcher::getQueueLatencies()) {
+    _logger->info("queued event {}: {} times, {:.3f} ms mean latency, {:.3f} ms max latency",
+                  typeName, queueLatency.eventCount,
+                  queueLatency.totalMs / static_cast<double>(queueLatency.eventCount),
+                  queueLatency.maxMs);
+  }
+
   for (size_t i = 0; i < _configContainer->applicationInfo->framesInFlight; i++) {
     vkDestroySemaphore(_appContext->getDevice(), _renderFinishedSemaphores[i], nullptr);
     vkDestroySemaphore(_appContext->getDevice(), _imageAvailableSemaphores[i], nullptr);
-    vkDestroyFence(_appContext->getDevice(), _framesInFlightFences[i], nullptr);
+  }
+  vkDestroySemaphore(_appContext->getDevice(), _frameTimelineSemaphore, nullptr);
+}
+
+void Application::_finishStartupTrace() {
+  double const timeToFirstFrameInMs = StartupTrace::get().finish();
+  _logger->info("time to first frame: {:.1f} ms", timeToFirstFrameInMs);
+
+  auto const &startupTraceFile = _configContainer->applicationInfo->startupTraceFile;
+  if (startupTraceFile.empty()) {
+    return;
+  }
+  std::string const pathToFile = kPathToResourceFolder + "profiles/" + startupTraceFile;
+  if (StartupTrace::get().writeJson(pathToFile)) {
+    _logger->info("startup trace written to {}", pathToFile);
+  } else {
+    _logger->warn("failed to write the startup trace to {}", pathToFile);
   }
 }
 
@@ -77,93 +253,362 @@ void Application::_onRenderLoopBlockRequest(E_RenderLoopBlockRequest const &even
   _blockStateBits |= event.blockStateBits;
 }
 
+// the builder runs between the frames, on this thread, so the tracer can write the new element now
+void Application::_onOctreeBufferPageAdded() { _svoTracer->onOctreeBufferPagesChanged(); }
+
 void Application::_onSwapchainResize() {
+  // the present ids start over with the new swapchain
+  _lastPresentId       = 0;
+  _swapchainFirstFrame = _frameCount;
   _appContext->onSwapchainResize(_configContainer->applicationInfo->isFramerateLimited);
-  _imguiManager->onSwapchainResize();
   _svoTracer->onSwapchainResize();
+  _imguiManager->onSwapchainResize(_svoTracer->getGuiOverlayImage());
 }
 
-void Application::_createSemaphoresAndFences() {
+void Application::_createSemaphores() {
   _imageAvailableSemaphores.resize(_configContainer->applicationInfo->framesInFlight);
   _renderFinishedSemaphores.resize(_configContainer->applicationInfo->framesInFlight);
-  _framesInFlightFences.resize(_configContainer->applicationInfo->framesInFlight);
+  _frameSubmitTimes.resize(_configContainer->applicationInfo->framesInFlight);
 
   VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
 
-  VkFenceCreateInfo fenceCreateInfoPreSignalled{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
-  fenceCreateInfoPreSignalled.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
   for (size_t i = 0; i < _configContainer->applicationInfo->framesInFlight; i++) {
     vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr,
                       &_imageAvailableSemaphores[i]);
     vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr,
                       &_renderFinishedSemaphores[i]);
-    vkCreateFence(_appContext->getDevice(), &fenceCreateInfoPreSignalled, nullptr,
-                  &_framesInFlightFences[i]);
   }
+
+  VkSemaphoreTypeCreateInfo semaphoreTypeInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+  semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  semaphoreTypeInfo.initialValue  = 0;
+
+  VkSemaphoreCreateInfo timelineSemaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  timelineSemaphoreInfo.pNext = &semaphoreTypeInfo;
+  vkCreateSemaphore(_appContext->getDevice(), &timelineSemaphoreInfo, nullptr,
+                    &_frameTimelineSemaphore);
 }
 
-void Application::_drawFrame() {
-  static size_t currentFrame = 0;
-  vkWaitForFences(_appContext->getDevice(), 1, &_framesInFlightFences[currentFrame], VK_TRUE,
-                  UINT64_MAX);
-  vkResetFences(_appContext->getDevice(), 1, &_framesInFlightFences[currentFrame]);
-
-  uint32_t imageIndex = 0;
-  // this process is fairly quick, but it is related to communicating with the GPU
-  // https://stackoverflow.com/questions/60419749/why-does-vkacquirenextimagekhr-never-block-my-thread
-  VkResult result =
-      vkAcquireNextImageKHR(_appContext->getDevice(), _appContext->getSwapchain(), UINT64_MAX,
-                            _imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
-  if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+void Application::_waitForFrameTimeline(uint64_t value) {
+  VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores    = &_frameTimelineSemaphore;
+  waitInfo.pValues        = &value;
+  vkWaitSemaphores(_appContext->getDevice(), &waitInfo, UINT64_MAX);
+}
+
+void Application::_waitForFrameDeadline() {
+  uint32_t const targetFps = _configContainer->applicationInfo->targetFps;
+  if (targetFps == 0) {
     return;
   }
+  // the frames are paced by their completion on the gpu, rather than by their submission, so they
+  // don't queue up in flight, which only adds to their latency
+  if (_frameCount > 0) {
+    _waitForFrameTimeline(_getFrameTimelineValue(_frameCount - 1, kFrameDone));
+  }
 
-  if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-    // sub-optimal: a swapchain no longer matches the surface properties
-    // exactly, but can still be used to present to the surface successfully
-    _logger->error("resizing is not allowed!");
+  auto const framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / static_cast<double>(targetFps)));
+  auto const now = std::chrono::steady_clock::now();
+  // a frame that is late by a whole period, or the first one after a block, starts over from now,
+  // instead of rushing the frames after it to catch up
+  if (now >= _nextFrameDeadline + framePeriod) {
+    _nextFrameDeadline = now;
   }
 
+  auto const sleepUntil = _nextFrameDeadline - kFrameLimiterSpinMargin;
+  if (now < sleepUntil) {
+    std::this_thread::sleep_until(sleepUntil);
+  }
+  while (std::chrono::steady_clock::now() < _nextFrameDeadline) {
+    std::this_thread::yield();
+  }
+  _nextFrameDeadline += framePeriod;
+}
+
+void Application::_drawFrame(double deltaTimeInSec) {
+  static size_t currentFrame    = 0;
+  uint64_t const framesInFlight = _configContainer->applicationInfo->framesInFlight;
+
+  // the low latency mode waits until the previous frame is displayed, so that the input below is
+  // sampled as late as possible, the input to photon latency is measured from that sampling
+  bool const isPresentWaited =
+      _appContext->isLowLatencyPresent() && _appContext->isPresentWaitSupported();
+  if (isPresentWaited && _lastPresentId != 0) {
+    VkResult const presentWaitResult =
+        vkWaitForPresentKHR(_appContext->getDevice(), _appContext->getSwapchain(), _lastPresentId,
+                            kPresentWaitTimeoutNs);
+    if (presentWaitResult == VK_SUCCESS) {
+      _fpsSink->addInputLatencyRecord(
+          _toMs(std::chrono::steady_clock::now() - _lastInputSampleTime));
+    }
+  }
+
+  // the frame that used this slot last is done with its command buffers and its semaphores, the
+  // latency is the time from its submission until the host has seen it done, the wait is how long
+  // the host was blocked on it
+  if (_frameCount >= framesInFlight) {
+    auto const waitBeginTime = std::chrono::steady_clock::now();
+    _waitForFrameTimeline(_getFrameTimelineValue(_frameCount - framesInFlight, kFrameDone));
+    auto const waitEndTime = std::chrono::steady_clock::now();
+    _fpsSink->addFrameLatencyRecord(_toMs(waitEndTime - _frameSubmitTimes[currentFrame]),
+                                    _toMs(waitEndTime - waitBeginTime));
+    _dumpFrame(_frameCount - framesInFlight);
+  }
+
+  // the frames that drew to the retired swapchains are done, and so are the frames in flight after
+  // them, which is the margin for their presents, there's no fence for those without
+  // VK_EXT_swapchain_maintenance1
+  if (_appContext->hasRetiredSwapchains() &&
+      _frameCount >= _swapchainFirstFrame + 2 * framesInFlight) {
+    _appContext->destroyRetiredSwapchains();
+  }
+
+  // the offscreen images of the headless mode are used in the order of the slots, nothing has to
+  // be acquired or presented then
+  bool const isHeadless = _appContext->isHeadless();
+  auto imageIndex       = static_cast<uint32_t>(currentFrame);
+  if (!isHeadless) {
+    // this process is fairly quick, but it is related to communicating with the GPU
+    // https://stackoverflow.com/questions/60419749/why-does-vkacquirenextimagekhr-never-block-my-thread
+    VkResult result =
+        vkAcquireNextImageKHR(_appContext->getDevice(), _appContext->getSwapchain(), UINT64_MAX,
+                              _imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+      return;
+    }
+
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+      // sub-optimal: a swapchain no longer matches the surface properties
+      // exactly, but can still be used to present to the surface successfully
+      _logger->error("resizing is not allowed!");
+    }
+  }
+
+  // the camera is moved after the waits on the gpu and the presentation
+  if (_benchmark != nullptr) {
+    glm::vec3 position = _svoTracer->getCameraPosition();
+    float yaw          = 0.F;
+    float pitch        = 0.F;
+    _benchmark->getCameraPose(position, yaw, pitch);
+    _svoTracer->setCameraPose(position, yaw, pitch);
+  } else {
+    _svoTracer->processInput(deltaTimeInSec);
+  }
+  _lastInputSampleTime = std::chrono::steady_clock::now();
+
   // this is some debuging features, which are disabled for release builds
   CursorInfo const &cursorInfo = _window->getCursorInfo();
-  if (cursorInfo.cursorState == CursorState::kInvisible &&
-      (cursorInfo.leftButtonPressed || cursorInfo.rightButtonPressed)) {
-    auto outputInfo = _svoTracer->getOutputInfo();
+  if (_benchmark != nullptr) {
+    _replayBenchmarkEdits();
+  } else if (cursorInfo.cursorState == CursorState::kInvisible &&
+             (cursorInfo.leftButtonPressed || cursorInfo.rightButtonPressed)) {
+    auto outputInfo = _svoTracer->getOutputInfo(currentFrame);
     if (outputInfo.midRayHit) {
       // _logger->info("mid ray hit at: " + std::to_string(outputInfo.midRayHitPos.x) + ", " +
       //               std::to_string(outputInfo.midRayHitPos.y) + ", " +
       //               std::to_string(outputInfo.midRayHitPos.z));
 
       _svoBuilder->handleCursorHit(outputInfo.midRayHitPos, cursorInfo.leftButtonPressed);
+      if (_editSessionRecording != nullptr) {
+        auto const *brushInfo = _configContainer->brushInfo.get();
+        _editSessionRecording->addStamp(_frameCount, outputInfo.midRayHitPos, brushInfo->size,
+                                        brushInfo->strength, cursorInfo.leftButtonPressed);
+      }
+    }
+  } else {
+    // releasing the brush ends the stroke, the next one is undone separately
+    _svoBuilder->endEditStroke();
+    if (_editSessionRecording != nullptr) {
+      _editSessionRecording->addStrokeEnd(_frameCount);
     }
   }
 
+  // edits are built on the compute queue, this picks up the finished ones and submits new ones, the
+  // streamed chunks follow the camera
+  _svoBuilder->update(_svoTracer->getCameraPosition(), _svoTracer->getCameraFront());
+  // the objects are listed in the grid of the frame by the tracer
+  if (_dynamicObjectDemo != nullptr) {
+    _dynamicObjectDemo->update(static_cast<float>(deltaTimeInSec));
+  }
+
   _svoTracer->drawFrame(currentFrame);
+  if (_configContainer->svoTracerInfo->recordEveryFrame) {
+    _fpsSink->addRecordingTimeRecord(_svoTracer->getLatestRecordingTimeMs());
+  }
 
-  _imguiManager->recordCommandBuffer(currentFrame, imageIndex);
-  std::vector<VkCommandBuffer> submitCommandBuffers = {
-      _svoTracer->getTracingCommandBuffer(currentFrame),
-      _svoTracer->getDeliveryCommandBuffer(imageIndex),
-      _imguiManager->getCommandBuffer(currentFrame),
-  };
+  // the overlay of the gui is only drawn again when it has changed
+  bool const isGuiDrawn = _imguiManager->recordCommandBuffer(currentFrame);
 
-  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  // wait until the image is ready
-  submitInfo.waitSemaphoreCount = 1;
-  submitInfo.pWaitSemaphores    = &_imageAvailableSemaphores[currentFrame];
-  // signal a semaphore after render finished
-  submitInfo.signalSemaphoreCount = 1;
-  submitInfo.pSignalSemaphores    = &_renderFinishedSemaphores[currentFrame];
-  // wait for no stage
-  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
-  submitInfo.pWaitDstStageMask = &waitStages;
+  // the sky luts are only computed again when the atmosphere has changed, the shadow map when the
+  // sun, the snapped shadow map camera, or its chunks have changed, they run on the async compute
+  // queue, alongside the coarse beam
+  std::vector<VkCommandBuffer> asyncCommandBuffers{};
+  if (_svoTracer->isSkyLutOutdated()) {
+    asyncCommandBuffers.push_back(_svoTracer->getSkyLutCommandBuffer(currentFrame));
+  }
+  if (_svoTracer->isShadowMapOutdated()) {
+    asyncCommandBuffers.push_back(_svoTracer->getShadowMapCommandBuffer(currentFrame));
+  }
+  bool const isAsyncSubmitted =
+      !asyncCommandBuffers.empty() && _appContext->isAsyncComputeQueueSeparate();
+
+  std::vector<VkCommandBuffer> occupancyCommandBuffers{};
+  // the chunk acceleration structure is only built again when the chunks have changed
+  if (_svoTracer->isChunkAccelerationStructureOutdated()) {
+    occupancyCommandBuffers.push_back(
+        _svoTracer->getChunkAccelerationStructureCommandBuffer(currentFrame));
+  }
+  occupancyCommandBuffers.push_back(_svoTracer->getChunkOccupancyCommandBuffer(currentFrame));
 
-  submitInfo.commandBufferCount = static_cast<uint32_t>(submitCommandBuffers.size());
-  submitInfo.pCommandBuffers    = submitCommandBuffers.data();
+  VkCommandBuffer beamCommandBuffer = _svoTracer->getCoarseBeamCommandBuffer(currentFrame);
 
-  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo,
-                _framesInFlightFences[currentFrame]);
+  std::vector<VkCommandBuffer> tracingCommandBuffers{};
+  if (!isAsyncSubmitted) {
+    tracingCommandBuffers = asyncCommandBuffers;
+  }
+  // the post processing of the tracing composites the gui
+  if (isGuiDrawn) {
+    tracingCommandBuffers.push_back(_imguiManager->getCommandBuffer(currentFrame));
+  }
+  tracingCommandBuffers.push_back(_svoTracer->getTracingCommandBuffer(currentFrame));
+  tracingCommandBuffers.push_back(_svoTracer->getDeliveryCommandBuffer(imageIndex));
+
+  // wait for the chunk swaps the host has seen, this never stalls, but it makes the edited chunk
+  // indices visible to the frame
+  VkSemaphore const chunkSwapSemaphore    = _svoBuilder->getChunkSwapSemaphore();
+  uint64_t const chunkSwapValue           = _svoBuilder->getCompletedChunkSwapValue();
+  VkPipelineStageFlags const computeStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+  // the uploads of the dedicated buffers since the last frame land before it, the staging ring may
+  // be on the dedicated transfer queue, so it's waited on like the chunk swaps
+  auto *stagingRing                      = _appContext->getStagingRing();
+  VkSemaphore const stagingRingSemaphore = stagingRing->getTimelineSemaphore();
+  uint64_t const stagingRingValue        = stagingRing->submit();
+
+  std::array<VkSemaphore, 2> const occupancyWaitSemaphores = {chunkSwapSemaphore,
+                                                              stagingRingSemaphore};
+  std::array<uint64_t, 2> const occupancyWaitValues        = {chunkSwapValue, stagingRingValue};
+  // the chunk occupancy is the first pass of the frame that reads either
+  std::array<VkPipelineStageFlags, 2> const occupancyWaitStages = {computeStage, computeStage};
+
+  uint64_t const occupancyDoneValue    = _getFrameTimelineValue(_frameCount, kChunkOccupancyDone);
+  uint64_t const asyncComputeDoneValue = _getFrameTimelineValue(_frameCount, kAsyncComputeDone);
+  uint64_t const frameDoneValue        = _getFrameTimelineValue(_frameCount, kFrameDone);
+
+  VkTimelineSemaphoreSubmitInfo occupancyTimelineInfo{
+      VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  occupancyTimelineInfo.waitSemaphoreValueCount =
+      static_cast<uint32_t>(occupancyWaitValues.size());
+  occupancyTimelineInfo.pWaitSemaphoreValues      = occupancyWaitValues.data();
+  occupancyTimelineInfo.signalSemaphoreValueCount = 1;
+  occupancyTimelineInfo.pSignalSemaphoreValues    = &occupancyDoneValue;
+
+  VkSubmitInfo occupancySubmitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  occupancySubmitInfo.pNext                = &occupancyTimelineInfo;
+  occupancySubmitInfo.waitSemaphoreCount   = static_cast<uint32_t>(occupancyWaitSemaphores.size());
+  occupancySubmitInfo.pWaitSemaphores      = occupancyWaitSemaphores.data();
+  occupancySubmitInfo.pWaitDstStageMask    = occupancyWaitStages.data();
+  occupancySubmitInfo.signalSemaphoreCount = 1;
+  occupancySubmitInfo.pSignalSemaphores    = &_frameTimelineSemaphore;
+  occupancySubmitInfo.commandBufferCount   = static_cast<uint32_t>(occupancyCommandBuffers.size());
+  occupancySubmitInfo.pCommandBuffers      = occupancyCommandBuffers.data();
+
+  VkSubmitInfo beamSubmitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  beamSubmitInfo.commandBufferCount = 1;
+  beamSubmitInfo.pCommandBuffers    = &beamCommandBuffer;
+
+  // the frames are only rendered by the first device of a group, the others only build chunks
+  uint32_t const deviceCount = _appContext->getDeviceCount();
+  DeviceGroupSubmit const occupancyDeviceGroupSubmit(occupancySubmitInfo, deviceCount,
+                                                     DeviceGroupSubmit::kPrimaryDeviceMask);
+  DeviceGroupSubmit const beamDeviceGroupSubmit(beamSubmitInfo, deviceCount,
+                                                DeviceGroupSubmit::kPrimaryDeviceMask);
+
+  std::array<VkSubmitInfo, 2> const preludeSubmitInfos = {occupancySubmitInfo, beamSubmitInfo};
+  vkQueueSubmit(_appContext->getGraphicsQueue(), static_cast<uint32_t>(preludeSubmitInfos.size()),
+                preludeSubmitInfos.data(), VK_NULL_HANDLE);
+
+  // the value of the binary semaphore is ignored
+  std::vector<VkSemaphore> waitSemaphores{};
+  std::vector<uint64_t> waitValues{};
+  std::vector<VkPipelineStageFlags> waitStages{};
+  if (!isHeadless) {
+    waitSemaphores.push_back(_imageAvailableSemaphores[currentFrame]);
+    waitValues.push_back(0);
+    waitStages.push_back(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+  }
+  // the async compute passes of a frame wait on its chunk occupancy, which also keeps them from
+  // overwriting what the previous frame still reads, its tracing waits on them in turn
+  if (isAsyncSubmitted) {
+    VkTimelineSemaphoreSubmitInfo asyncTimelineInfo{
+        VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+    asyncTimelineInfo.waitSemaphoreValueCount   = 1;
+    asyncTimelineInfo.pWaitSemaphoreValues      = &occupancyDoneValue;
+    asyncTimelineInfo.signalSemaphoreValueCount = 1;
+    asyncTimelineInfo.pSignalSemaphoreValues    = &asyncComputeDoneValue;
+
+    VkSubmitInfo asyncSubmitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    asyncSubmitInfo.pNext                = &asyncTimelineInfo;
+    asyncSubmitInfo.waitSemaphoreCount   = 1;
+    asyncSubmitInfo.pWaitSemaphores      = &_frameTimelineSemaphore;
+    asyncSubmitInfo.pWaitDstStageMask    = &computeStage;
+    asyncSubmitInfo.signalSemaphoreCount = 1;
+    asyncSubmitInfo.pSignalSemaphores    = &_frameTimelineSemaphore;
+    asyncSubmitInfo.commandBufferCount   = static_cast<uint32_t>(asyncCommandBuffers.size());
+    asyncSubmitInfo.pCommandBuffers      = asyncCommandBuffers.data();
+    DeviceGroupSubmit const asyncDeviceGroupSubmit(asyncSubmitInfo, deviceCount,
+                                                   DeviceGroupSubmit::kPrimaryDeviceMask);
+
+    vkQueueSubmit(_appContext->getAsyncComputeQueue(), 1, &asyncSubmitInfo, VK_NULL_HANDLE);
+
+    waitSemaphores.push_back(_frameTimelineSemaphore);
+    waitValues.push_back(asyncComputeDoneValue);
+    waitStages.push_back(VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+  }
+
+  // signal a semaphore after render finished, and the end of the frame, which the async passes are
+  // part of as well, the value of the binary semaphore is ignored, and nothing presents it in the
+  // headless mode
+  std::array<VkSemaphore, 2> const signalSemaphores = {_frameTimelineSemaphore,
+                                                       _renderFinishedSemaphores[currentFrame]};
+  std::array<uint64_t, 2> const signalValues        = {frameDoneValue, 0};
+  uint32_t const signalCount                        = isHeadless ? 1 : 2;
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  timelineInfo.waitSemaphoreValueCount   = static_cast<uint32_t>(waitValues.size());
+  timelineInfo.pWaitSemaphoreValues      = waitValues.data();
+  timelineInfo.signalSemaphoreValueCount = signalCount;
+  timelineInfo.pSignalSemaphoreValues    = signalValues.data();
+
+  // wait until the image is ready
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.pNext                = &timelineInfo;
+  submitInfo.waitSemaphoreCount   = static_cast<uint32_t>(waitSemaphores.size());
+  submitInfo.pWaitSemaphores      = waitSemaphores.data();
+  submitInfo.pWaitDstStageMask    = waitStages.data();
+  submitInfo.signalSemaphoreCount = signalCount;
+  submitInfo.pSignalSemaphores    = signalSemaphores.data();
+
+  submitInfo.commandBufferCount = static_cast<uint32_t>(tracingCommandBuffers.size());
+  submitInfo.pCommandBuffers    = tracingCommandBuffers.data();
+  DeviceGroupSubmit const deviceGroupSubmit(submitInfo, deviceCount,
+                                            DeviceGroupSubmit::kPrimaryDeviceMask);
+
+  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
+  // the later uploads may overwrite what the frame reads
+  stagingRing->setConsumerTimelineValue(_frameTimelineSemaphore, frameDoneValue);
+  _frameSubmitTimes[currentFrame] = std::chrono::steady_clock::now();
+  _frameCount++;
+  if (_frameCount == 1) {
+    _finishStartupTrace();
+  }
+
+  if (isHeadless) {
+    currentFrame = (currentFrame + 1) % _configContainer->applicationInfo->framesInFlight;
+    return;
+  }
 
   VkPresentInfoKHR presentInfo{};
   presentInfo.sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -174,11 +619,43 @@ void Application::_drawFrame() {
   presentInfo.pImageIndices      = &imageIndex;
   presentInfo.pResults           = nullptr;
 
+  VkPresentIdKHR presentId{VK_STRUCTURE_TYPE_PRESENT_ID_KHR};
+  if (isPresentWaited) {
+    _lastPresentId++;
+    presentId.swapchainCount = 1;
+    presentId.pPresentIds    = &_lastPresentId;
+    presentInfo.pNext        = &presentId;
+  }
+
   vkQueuePresentKHR(_appContext->getPresentQueue(), &presentInfo);
 
   currentFrame = (currentFrame + 1) % _configContainer->applicationInfo->framesInFlight;
 }
 
+// the frames are drawn in the order of the slots, and the headless image index is the slot
+void Application::_dumpFrame(uint64_t frame) {
+  if (_frameDumper == nullptr) {
+    return;
+  }
+  uint64_t const framesInFlight = _configContainer->applicationInfo->framesInFlight;
+  uint8_t const *frameDump      = _svoTracer->getFrameDump(frame % framesInFlight);
+  if (frameDump == nullptr) {
+    return;
+  }
+  uint32_t const width  = _svoTracer->getFrameDumpWidth();
+  uint32_t const height = _svoTracer->getFrameDumpHeight();
+
+  // every headless frame is written, the recording drops frames rather than stalling the loop
+  if (_configContainer->applicationInfo->isHeadless) {
+    _frameDumper->dump(frame, frameDump, width, height);
+    return;
+  }
+  if (_isRecordingFrames) {
+    bool const isWritten = _frameDumper->tryDump(frame, frameDump, width, height);
+    _fpsSink->addRecordedFrame(!isWritten);
+  }
+}
+
 void Application::_waitForTheWindowToBeResumed() {
   int windowWidth  = 0;
   int windowHeight = 0;
@@ -191,26 +668,61 @@ void Application::_waitForTheWindowToBeResumed() {
 
 void Application::_mainLoop() {
   static std::chrono::time_point fpsRecordLastTime = std::chrono::steady_clock::now();
+  // the counters of the scene build aren't part of the first frame
+  _svoBuilder->takeEditStats();
 
   while (glfwWindowShouldClose(_window->getGlWindow()) == 0) {
+    // the events are polled after the wait, so the input is as fresh as it gets, the benchmark runs
+    // without the limit
+    if (_benchmark == nullptr) {
+      _waitForFrameDeadline();
+    }
 
     glfwPollEvents();
+    // the events that the other threads have handed off since the last frame
+    GlobalEventDispatcher::drain();
+    _shaderFileWatchListener->update();
 
     if (_blockStateBits != 0) {
-      vkDeviceWaitIdle(_appContext->getDevice());
+      // the shaders of the svo builder are also used by its compute queue, which the frame
+      // timeline doesn't cover, neither does it cover the octrees that a capture reads, the
+      // swapchain that is replaced by a resize is only retired, so that its presents don't have to
+      // be waited on
+      if ((_blockStateBits &
+           (BlockState::kShaderChanged | BlockState::kViewCaptureRequested)) != 0) {
+        vkDeviceWaitIdle(_appContext->getDevice());
+      } else if (_frameCount > 0) {
+        _waitForFrameTimeline(_getFrameTimelineValue(_frameCount - 1, kFrameDone));
+      }
 
-      if (_blockStateBits & BlockState::kShaderChanged) {
+      // the handlers can request another block, e.g. the scene rebuild after a shader change
+      // grows the octree pool, that request is handled in the next iteration then
+      uint32_t const blockStateBits = _blockStateBits;
+      _blockStateBits               = 0;
+
+      if (blockStateBits & BlockState::kShaderChanged) {
         GlobalEventDispatcher::get().trigger<E_RenderLoopBlocked>();
         // then some rebuilding will happen
       }
 
-      if (_blockStateBits & BlockState::kWindowResized) {
+      if (blockStateBits & BlockState::kWindowResized) {
         _waitForTheWindowToBeResumed();
         _onSwapchainResize();
       }
 
-      // reset the block state and timer
-      _blockStateBits   = 0;
+      if (blockStateBits & BlockState::kOctreeBufferPagesChanged) {
+        _svoTracer->onOctreeBufferPagesChanged();
+      }
+
+      if (blockStateBits & BlockState::kPipelineVariantsChanged) {
+        _svoTracer->onPipelineVariantsChanged();
+      }
+
+      if (blockStateBits & BlockState::kViewCaptureRequested) {
+        _captureCubemap();
+      }
+
+      // reset the timer
       fpsRecordLastTime = std::chrono::steady_clock::now();
       continue;
     }
@@ -225,17 +737,198 @@ void Application::_mainLoop() {
 
     _fpsSink->addRecord(1.0F / deltaTimeInSec);
 
-    _imguiManager->draw(_fpsSink.get());
-    _svoTracer->processInput(deltaTimeInSec);
+    _imguiManager->draw(_fpsSink.get(), _svoTracer->getPassProfiler()->getPassTimeSink(),
+                        _svoTracer->getTraversalStatsSink());
+
+    // the benchmark steps its camera path by the fixed time step, however long the frames take
+    if (_benchmark != nullptr) {
+      _drawFrame(_benchmark->getTimeStepInSec());
+      auto const cpuTime = std::chrono::steady_clock::now() - currentTime;
+      _recordBenchmarkFrame(static_cast<float>(_toMs(deltaTime)),
+                            static_cast<float>(_toMs(cpuTime)));
+      continue;
+    }
 
-    _drawFrame();
+    _drawFrame(deltaTimeInSec);
   }
 
   vkDeviceWaitIdle(_appContext->getDevice());
+
+  // the frames still in flight at the end haven't been dumped yet
+  uint64_t const framesInFlight = _configContainer->applicationInfo->framesInFlight;
+  for (uint64_t frame = _frameCount - std::min(framesInFlight, _frameCount); frame < _frameCount;
+       frame++) {
+    _dumpFrame(frame);
+  }
+
+  if (_benchmark != nullptr) {
+    _benchmark->finish(_svoTracer->getPassProfiler()->getPassTimeSink()->getPassNames(),
+                       _svoTracer->getTraversalStatsSink()->getRayTypeNames(),
+                       kPathToResourceFolder + "profiles/" +
+                           _configContainer->benchmarkInfo->csvFile);
+    _runTraversalBenchmark();
+  }
+
+  if (_editSessionRecording != nullptr) {
+    _editSessionRecording->save(kPathToResourceFolder + "profiles/" +
+                                _configContainer->benchmarkInfo->recordEditSessionFile);
+  }
+
+  auto const &passProfileCsvFile = _configContainer->svoTracerInfo->passProfileCsvFile;
+  if (!passProfileCsvFile.empty()) {
+    _svoTracer->getPassProfiler()->writeCsv(kPathToResourceFolder + "profiles/" +
+                                            passProfileCsvFile);
+  }
+}
+
+void Application::_recordBenchmarkFrame(float frameTimeMs, float cpuTimeMs) {
+  Benchmark::FrameRecord frameRecord{};
+  frameRecord.frameTimeMs = frameTimeMs;
+  frameRecord.cpuTimeMs   = cpuTimeMs;
+
+  auto const *passTimeSink = _svoTracer->getPassProfiler()->getPassTimeSink();
+  for (size_t pass = 0; pass < passTimeSink->getPassNames().size(); pass++) {
+    auto const &passHistory = passTimeSink->getPassHistory(pass);
+    frameRecord.passTimesMs.push_back(passHistory.empty() ? 0.F : passHistory.back());
+  }
+
+  auto const *traversalStatsSink = _svoTracer->getTraversalStatsSink();
+  if (traversalStatsSink->hasRecord()) {
+    for (size_t rayType = 0; rayType < traversalStatsSink->getRayTypeNames().size(); rayType++) {
+      auto const &stats = traversalStatsSink->getLatestStats(rayType);
+      frameRecord.traversalRayCounts.push_back(stats.rayCount);
+      frameRecord.traversalAvgIters.push_back(stats.getAvgIter());
+      frameRecord.traversalAvgChunks.push_back(stats.getAvgChunkTraversed());
+    }
+  }
+
+  float constexpr kMb = 1024.F * 1024.F;
+  auto const budgets  = _appContext->getHeapBudgets();
+  for (uint32_t heapIndex = 0; heapIndex < budgets.size(); heapIndex++) {
+    if (_appContext->isDeviceLocalHeap(heapIndex)) {
+      frameRecord.deviceMemoryUsageMb += static_cast<float>(budgets[heapIndex].usage) / kMb;
+    }
+  }
+  frameRecord.octreePoolMb =
+      static_cast<float>(_appContext->getTrackedMemorySize(MemoryCategory::kOctreePool)) / kMb;
+
+  auto const editStats                = _svoBuilder->takeEditStats();
+  frameRecord.editStampCount          = _replayedStampCount;
+  frameRecord.editedChunkCount        = editStats.editedChunkCount;
+  frameRecord.editBuildGpuTimeMs      = static_cast<float>(editStats.editBuildGpuTimeMs);
+  frameRecord.octreeAllocationCount   = editStats.octreeAllocationCount;
+  frameRecord.octreeDeallocationCount = editStats.octreeDeallocationCount;
+  _replayedStampCount                 = 0;
+
+  _benchmark->addFrameRecord(std::move(frameRecord));
+  if (_benchmark->isDone()) {
+    glfwSetWindowShouldClose(_window->getGlWindow(), 1);
+  }
+}
+
+// the brush is set to the recorded one for every stamp, the hit positions are replayed as they were
+// recorded, whatever the camera of the benchmark looks at
+void Application::_replayBenchmarkEdits() {
+  auto *brushInfo = _configContainer->brushInfo.get();
+  for (auto const &edit : _benchmark->takeEditsOfCurrentFrame()) {
+    if (edit.kind == EditSession::Kind::kStrokeEnd) {
+      _svoBuilder->endEditStroke();
+      continue;
+    }
+    brushInfo->size     = edit.brushSize;
+    brushInfo->strength = edit.brushStrength;
+    _svoBuilder->handleCursorHit(edit.hitPos, edit.isDeletion);
+    _replayedStampCount++;
+  }
+}
+
+// the batches reuse the camera and the chunk window of the last frame, so they measure the
+// traversal alone on the final view of the path
+void Application::_runTraversalBenchmark() {
+  uint32_t const batchCount = _configContainer->benchmarkInfo->traversalBatchCount;
+  uint32_t const rayCount   = _configContainer->benchmarkInfo->traversalRayCount;
+  if (batchCount == 0 || rayCount == 0 || _frameCount == 0) {
+    return;
+  }
+  uint64_t const framesInFlight = _configContainer->applicationInfo->framesInFlight;
+  auto const lastFrameSlot      = static_cast<size_t>((_frameCount - 1) % framesInFlight);
+
+  std::array<std::pair<char const *, SvoTracer::TraversalRayMode>, 3> const modes = {{
+      {"coherent primary", SvoTracer::TraversalRayMode::kCoherentPrimary},
+      {"random hemisphere", SvoTracer::TraversalRayMode::kRandomHemisphere},
+      {"shadow toward sun", SvoTracer::TraversalRayMode::kShadowTowardSun},
+  }};
+
+  std::string octreeReadPath = "storage buffers";
+  if (_configContainer->svoTracerInfo->octreeDeviceAddress) {
+    octreeReadPath = "device addresses";
+  } else if (_configContainer->svoTracerInfo->octreeTexelBuffer) {
+    octreeReadPath = "texel buffers";
+  }
+  _logger->info("traversal benchmark, {} batches of {} rays, octree read through {}", batchCount,
+                rayCount, octreeReadPath);
+  for (auto const &[modeName, mode] : modes) {
+    double gpuTimeMs          = 0.0;
+    uint64_t tracedRayCount   = 0;
+    uint64_t hitCount         = 0;
+    uint64_t iterationSum     = 0;
+    uint64_t chunkTraverseSum = 0;
+    for (uint32_t batch = 0; batch < batchCount; batch++) {
+      auto const result = _svoTracer->runTraversalBatch(lastFrameSlot, mode, batch);
+      gpuTimeMs += result.gpuTimeMs;
+      tracedRayCount += result.stats.rayCount;
+      hitCount += result.stats.hitCount;
+      iterationSum += result.stats.iterSum;
+      chunkTraverseSum += result.stats.chunkTraversedSum;
+    }
+    if (tracedRayCount == 0) {
+      _logger->subInfo("{}: no rays were traced", modeName);
+      continue;
+    }
+    auto const rays = static_cast<double>(tracedRayCount);
+    _logger->subInfo("{}: {:.1f} mrays/s, {:.2f} iterations per ray, {:.2f} chunks per ray, "
+                     "{:.1f}% hit",
+                     modeName, rays / (gpuTimeMs * 1e3), static_cast<double>(iterationSum) / rays,
+                     static_cast<double>(chunkTraverseSum) / rays,
+                     100.0 * static_cast<double>(hitCount) / rays);
+  }
+}
+
+// the faces are rendered in one batch, with the luts and the shadow map of the last frame
+void Application::_captureCubemap() {
+  if (_frameCount == 0) {
+    return;
+  }
+  uint64_t const framesInFlight = _configContainer->applicationInfo->framesInFlight;
+  auto const lastFrameSlot      = static_cast<size_t>((_frameCount - 1) % framesInFlight);
+
+  auto const views = SvoTracer::makeCubemapCaptureViews(_svoTracer->getCameraPosition());
+  double const gpuTimeMs =
+      _svoTracer->captureViews(lastFrameSlot, views, static_cast<uint32_t>(_frameCount));
+  uint32_t const resolution = _configContainer->svoTracerInfo->captureResolution;
+  _logger->info("cubemap of {}x{} faces captured in {:.2f} ms", resolution, resolution, gpuTimeMs);
+}
+
+// the phases that submit to the gpu share the graphics queue and its command pool, so they stay on
+// this thread, in order, the shader compilation is what runs behind them
+void Application::_prewarmShaders() {
+  std::vector<std::string> fullPathsToShaders{};
+  for (auto const *folder : {"shaders/svo-builder/", "shaders/svo-tracer/"}) {
+    std::error_code errorCode{};
+    for (auto const &entry :
+         std::filesystem::directory_iterator(kPathToResourceFolder + folder, errorCode)) {
+      if (entry.path().extension() == ".comp") {
+        fullPathsToShaders.push_back(kPathToResourceFolder + folder +
+                                     entry.path().filename().string());
+      }
+    }
+  }
+  _shaderCompiler->prewarm(fullPathsToShaders);
 }
 
 void Application::_init() {
   {
+    StartupTrace::Scope scope("svo builder init");
     auto startTime = std::chrono::steady_clock::now();
     _svoBuilder->init();
     auto endTime = std::chrono::steady_clock::now();
@@ -244,16 +937,30 @@ void Application::_init() {
     _logger->info("SVO init time: " + std::to_string(duration) + " seconds");
   }
 
-  _svoTracer->init(_svoBuilder.get());
-  _imguiManager->init();
+  {
+    StartupTrace::Scope scope("svo tracer init");
+    _svoTracer->init(_svoBuilder.get());
+  }
+  {
+    StartupTrace::Scope scope("imgui init");
+    _imguiManager->init(_svoTracer->getGuiOverlayImage());
+  }
 
-  _createSemaphoresAndFences();
+  _createSemaphores();
 
   // attach application-level keyboard listeners
   _window->addKeyboardCallback(
       [this](KeyboardInfo const &keyboardInfo) { _applicationKeyboardCallback(keyboardInfo); });
 
   _buildScene();
+
+  // the shapes are uploaded into the octree pages of the built scene
+  uint32_t const dynamicObjectDemoCount = _configContainer->svoBuilderInfo->dynamicObjectDemoCount;
+  if (dynamicObjectDemoCount > 0) {
+    _dynamicObjectDemo = std::make_unique<DynamicObjectDemo>(
+        _logger, _svoBuilder->getDynamicObjects(), dynamicObjectDemoCount,
+        _configContainer->terrainInfo->chunkVoxelDim, _svoTracer->getCameraPosition());
+  }
 }
 
 void Application::_applicationKeyboardCallback(KeyboardInfo const &keyboardInfo) {
@@ -266,9 +973,33 @@ void Application::_applicationKeyboardCallback(KeyboardInfo const &keyboardInfo)
     _window->toggleCursor();
     return;
   }
+
+  if (keyboardInfo.isKeyPressed(GLFW_KEY_C)) {
+    _blockStateBits |= BlockState::kViewCaptureRequested;
+    return;
+  }
+
+  if (keyboardInfo.isKeyPressed(GLFW_KEY_F9) && _frameDumper != nullptr) {
+    _isRecordingFrames = !_isRecordingFrames;
+    _logger->info("frame recording {}", _isRecordingFrames ? "started" : "stopped");
+    return;
+  }
+
+  // the brush strokes, both repeat while held
+  if (keyboardInfo.isKeyPressed(GLFW_THUMB_KEY)) {
+    if (keyboardInfo.isKeyPressed(GLFW_KEY_Z)) {
+      _svoBuilder->undoEditStroke();
+      return;
+    }
+    if (keyboardInfo.isKeyPressed(GLFW_KEY_Y)) {
+      _svoBuilder->redoEditStroke();
+      return;
+    }
+  }
 }
 
 void Application::_buildScene() {
+  StartupTrace::Scope scope("scene build");
   auto startTime = std::chrono::steady_clock::now();
   _svoBuilder->buildScene();
   auto endTime = std::chrono::steady_clock::now();
@@ -6,12 +6,17 @@
 #include "utils/logger/Logger.hpp"
 #include "window/KeyboardInfo.hpp"
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
 struct ConfigContainer;
 
 class Logger;
+class Benchmark;
+class EditSession;
+class FrameDumper;
+class DynamicObjectDemo;
 class Window;
 class SvoBuilder;
 class SvoTracer;
@@ -40,32 +45,74 @@ private:
 
   std::unique_ptr<VulkanApplicationContext> _appContext          = nullptr;
   std::unique_ptr<ConfigContainer> _configContainer              = nullptr;
-  std::unique_ptr<ShaderChangeListener> _shaderFileWatchListener = nullptr;
+  // the listener drops the changed files from the include cache of the compiler, so it's destroyed
+  // first
   std::unique_ptr<ShaderCompiler> _shaderCompiler                = nullptr;
+  std::unique_ptr<ShaderChangeListener> _shaderFileWatchListener = nullptr;
   std::unique_ptr<Window> _window                                = nullptr;
   std::unique_ptr<SvoBuilder> _svoBuilder                        = nullptr;
   std::unique_ptr<SvoTracer> _svoTracer                          = nullptr;
   std::unique_ptr<ImguiManager> _imguiManager                    = nullptr;
   std::unique_ptr<FpsSink> _fpsSink                              = nullptr;
+  // only in the benchmark mode, it drives the camera instead of the input
+  std::unique_ptr<Benchmark> _benchmark = nullptr;
+  // the stamps the benchmark replayed in the current frame
+  uint32_t _replayedStampCount = 0;
+  // only outside of the benchmark mode, with an edit session file to record to
+  std::unique_ptr<EditSession> _editSessionRecording = nullptr;
+  // only in the headless mode with the frames dumped, or in the windowed one with the recording
+  std::unique_ptr<FrameDumper> _frameDumper = nullptr;
+  // toggled with F9, with Application.frameRecording
+  bool _isRecordingFrames = false;
+  // only with SvoBuilder.dynamicObjectDemoCount
+  std::unique_ptr<DynamicObjectDemo> _dynamicObjectDemo = nullptr;
 
-  // semaphores and fences for synchronization
+  // semaphores for synchronization, the swapchain only takes binary ones
   std::vector<VkSemaphore> _imageAvailableSemaphores{};
   std::vector<VkSemaphore> _renderFinishedSemaphores{};
-  std::vector<VkFence> _framesInFlightFences{};
+  // the frames signal their stages on this timeline, see FrameTimelineStage, a frame waits on the
+  // one that used its slot of the frames in flight before it
+  VkSemaphore _frameTimelineSemaphore = VK_NULL_HANDLE;
+  uint64_t _frameCount                = 0;
+  // when the frames in the slots were submitted, for their latencies
+  std::vector<std::chrono::steady_clock::time_point> _frameSubmitTimes{};
+  // the last frame presented to the current swapchain, in the low latency present mode
+  uint64_t _lastPresentId = 0;
+  // the first frame that is drawn to the current swapchain, the retired ones are destroyed once the
+  // frames before it are done
+  uint64_t _swapchainFirstFrame = 0;
+  std::chrono::steady_clock::time_point _lastInputSampleTime{};
+  // the time the next frame starts at, with Application.targetFps
+  std::chrono::steady_clock::time_point _nextFrameDeadline{};
 
   // BlockState _blockState = BlockState::kUnblocked;
   uint32_t _blockStateBits = 0;
 
   void _applicationKeyboardCallback(KeyboardInfo const &keyboardInfo);
 
-  void _createSemaphoresAndFences();
+  void _createSemaphores();
+  void _waitForFrameTimeline(uint64_t value);
   void _onSwapchainResize();
   void _waitForTheWindowToBeResumed();
-  void _drawFrame();
+  // with Application.targetFps, waits until the previous frame is done on the gpu, then until the
+  // deadline of the next frame
+  void _waitForFrameDeadline();
+  void _drawFrame(double deltaTimeInSec);
+  // the frame has to be completed on the gpu
+  void _dumpFrame(uint64_t frame);
+  void _recordBenchmarkFrame(float frameTimeMs, float cpuTimeMs);
+  void _replayBenchmarkEdits();
+  void _runTraversalBenchmark();
+  void _captureCubemap();
   void _mainLoop();
+  // the shaders of the builder and the tracer are compiled on the scheduler meanwhile
+  void _prewarmShaders();
   void _init();
+  // with the first frame submitted
+  void _finishStartupTrace();
   void _cleanup();
 
   void _onRenderLoopBlockRequest(E_RenderLoopBlockRequest const &event);
+  void _onOctreeBufferPageAdded();
   void _buildScene();
 };
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "Benchmark.hpp"
+
+#include "config-container/sub-config/BenchmarkInfo.hpp"
+#include "utils/config/RootDir.h"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace {
+// the layout of the keyframes of the config
+size_t constexpr kTime  = 0;
+size_t constexpr kX     = 1;
+size_t constexpr kYaw   = 4;
+size_t constexpr kPitch = 5;
+
+glm::vec3 _getPosition(std::array<float, 6> const &keyframe) {
+  return {keyframe[kX], keyframe[kX + 1], keyframe[kX + 2]};
+}
+
+float _getPercentile(std::vector<float> const &sortedValues, float fraction) {
+  auto const index = static_cast<size_t>(fraction * static_cast<float>(sortedValues.size()));
+  return sortedValues[std::min(index, sortedValues.size() - 1)];
+}
+
+// the upper bounds of the buckets of the frame time histogram, the refresh intervals of the common
+// displays among them, the last bucket takes the rest
+std::array<float, 6> constexpr kHistogramBucketsMs = {4.F, 8.F, 16.667F, 33.333F, 50.F, 100.F};
+} // namespace
+
+Benchmark::Benchmark(Logger *logger, BenchmarkInfo const *benchmarkInfo)
+    : _logger(logger), _timeStepInSec(benchmarkInfo->fixedTimeStepMs / 1000.0),
+      _keyframes(benchmarkInfo->keyframes) {
+  if (_keyframes.empty()) {
+    _logger->warn("the benchmark has no keyframes, it ends right away");
+  }
+  _logger->info("benchmark of {} keyframes, {} s with a time step of {} ms", _keyframes.size(),
+                _keyframes.empty() ? 0.F : _keyframes.back()[kTime],
+                benchmarkInfo->fixedTimeStepMs);
+
+  if (!benchmarkInfo->replayEditSessionFile.empty()) {
+    _editSession = std::make_unique<EditSession>(_logger);
+    if (!_editSession->load(kPathToResourceFolder + "profiles/" +
+                            benchmarkInfo->replayEditSessionFile)) {
+      _editSession = nullptr;
+    }
+  }
+}
+
+double Benchmark::_getCurrentTimeInSec() const {
+  return static_cast<double>(_frameRecords.size()) * _timeStepInSec;
+}
+
+bool Benchmark::isDone() const {
+  return _keyframes.empty() || _getCurrentTimeInSec() > _keyframes.back()[kTime];
+}
+
+void Benchmark::getCameraPose(glm::vec3 &position, float &yaw, float &pitch) const {
+  if (_keyframes.empty()) {
+    return;
+  }
+
+  auto const time = static_cast<float>(_getCurrentTimeInSec());
+  // the first keyframe that is later than the current time, the path holds at its ends
+  auto const next = std::upper_bound(
+      _keyframes.begin(), _keyframes.end(), time,
+      [](float t, std::array<float, 6> const &keyframe) { return t < keyframe[kTime]; });
+  if (next == _keyframes.begin() || next == _keyframes.end()) {
+    auto const &keyframe = next == _keyframes.end() ? _keyframes.back() : _keyframes.front();
+    position             = _getPosition(keyframe);
+    yaw                  = keyframe[kYaw];
+    pitch                = keyframe[kPitch];
+    return;
+  }
+
+  auto const &from   = *(next - 1);
+  auto const &to     = *next;
+  float const factor = (time - from[kTime]) / (to[kTime] - from[kTime]);
+  position           = glm::mix(_getPosition(from), _getPosition(to), factor);
+  yaw                = glm::mix(from[kYaw], to[kYaw], factor);
+  pitch              = glm::mix(from[kPitch], to[kPitch], factor);
+}
+
+std::vector<EditSession::Edit> Benchmark::takeEditsOfCurrentFrame() {
+  if (_editSession == nullptr) {
+    return {};
+  }
+  return _editSession->takeEditsOfFrame(static_cast<uint32_t>(_frameRecords.size()));
+}
+
+void Benchmark::addFrameRecord(FrameRecord frameRecord) {
+  _frameRecords.push_back(std::move(frameRecord));
+}
+
+void Benchmark::finish(std::vector<std::string> const &passNames,
+                       std::vector<std::string> const &traversalRayTypeNames,
+                       std::string const &pathToFile) const {
+  if (_writeCsv(passNames, traversalRayTypeNames, pathToFile)) {
+    _logger->info("benchmark written to {}", pathToFile);
+  } else {
+    _logger->warn("failed to write the benchmark to {}", pathToFile);
+  }
+  _logSummary(traversalRayTypeNames);
+}
+
+bool Benchmark::_writeCsv(std::vector<std::string> const &passNames,
+                          std::vector<std::string> const &traversalRayTypeNames,
+                          std::string const &pathToFile) const {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+  std::ofstream file(pathToFile, std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file << "frame,frame_ms,cpu_ms";
+  for (auto const &passName : passNames) {
+    file << "," << passName << "_ms";
+  }
+  file << ",device_memory_mb,octree_pool_mb,edit_stamps,edited_chunks,edit_gpu_ms,"
+          "octree_allocations,octree_deallocations";
+  for (auto const &rayTypeName : traversalRayTypeNames) {
+    file << "," << rayTypeName << "_rays," << rayTypeName << "_avg_iter," << rayTypeName
+         << "_avg_chunks";
+  }
+  file << "\n";
+
+  for (size_t frame = 0; frame < _frameRecords.size(); frame++) {
+    auto const &frameRecord = _frameRecords[frame];
+    file << frame << "," << frameRecord.frameTimeMs << "," << frameRecord.cpuTimeMs;
+    for (size_t pass = 0; pass < passNames.size(); pass++) {
+      file << "," << (pass < frameRecord.passTimesMs.size() ? frameRecord.passTimesMs[pass] : 0.F);
+    }
+    file << "," << frameRecord.deviceMemoryUsageMb << "," << frameRecord.octreePoolMb << ","
+         << frameRecord.editStampCount << "," << frameRecord.editedChunkCount << ","
+         << frameRecord.editBuildGpuTimeMs << "," << frameRecord.octreeAllocationCount << ","
+         << frameRecord.octreeDeallocationCount;
+    // the frames without the statistics are left empty
+    for (size_t rayType = 0; rayType < traversalRayTypeNames.size(); rayType++) {
+      if (rayType < frameRecord.traversalRayCounts.size()) {
+        file << "," << frameRecord.traversalRayCounts[rayType] << ","
+             << frameRecord.traversalAvgIters[rayType] << ","
+             << frameRecord.traversalAvgChunks[rayType];
+      } else {
+        file << ",,,";
+      }
+    }
+    file << "\n";
+  }
+  return static_cast<bool>(file);
+}
+
+void Benchmark::_logSummary(std::vector<std::string> const &traversalRayTypeNames) const {
+  if (_frameRecords.empty()) {
+    _logger->info("benchmark: no frames recorded");
+    return;
+  }
+
+  std::vector<float> frameTimesMs{};
+  frameTimesMs.reserve(_frameRecords.size());
+  double totalCpuTimeMs         = 0.0;
+  double totalGpuTimeMs         = 0.0;
+  float peakDeviceMemoryUsageMb = 0.F;
+  for (auto const &frameRecord : _frameRecords) {
+    frameTimesMs.push_back(frameRecord.frameTimeMs);
+    totalCpuTimeMs += frameRecord.cpuTimeMs;
+    for (float const passTimeMs : frameRecord.passTimesMs) {
+      totalGpuTimeMs += passTimeMs;
+    }
+    peakDeviceMemoryUsageMb = std::max(peakDeviceMemoryUsageMb, frameRecord.deviceMemoryUsageMb);
+  }
+  std::sort(frameTimesMs.begin(), frameTimesMs.end());
+  auto const frameCount = static_cast<double>(_frameRecords.size());
+
+  _logger->info("benchmark: {} frames, frame p50: {:.2f} ms, p95: {:.2f} ms, p99: {:.2f} ms, "
+                "max: {:.2f} ms",
+                _frameRecords.size(), _getPercentile(frameTimesMs, 0.5F),
+                _getPercentile(frameTimesMs, 0.95F), _getPercentile(frameTimesMs, 0.99F),
+                frameTimesMs.back());
+  _logger->info("benchmark: avg cpu: {:.2f} ms, avg gpu: {:.2f} ms, peak device memory: {:.0f} mb",
+                totalCpuTimeMs / frameCount, totalGpuTimeMs / frameCount, peakDeviceMemoryUsageMb);
+  _logFrameTimeHistogram(frameTimesMs);
+  _logEditSummary();
+  _logTraversalSummary(traversalRayTypeNames);
+}
+
+void Benchmark::_logFrameTimeHistogram(std::vector<float> const &sortedFrameTimesMs) const {
+  std::string histogram{};
+  auto bucketBegin = sortedFrameTimesMs.begin();
+  for (float const bucketEndMs : kHistogramBucketsMs) {
+    auto const bucketEnd = std::lower_bound(bucketBegin, sortedFrameTimesMs.end(), bucketEndMs);
+    histogram += fmt::format("<{:.1f} ms: {}, ", bucketEndMs, bucketEnd - bucketBegin);
+    bucketBegin = bucketEnd;
+  }
+  histogram += fmt::format(">={:.1f} ms: {}", kHistogramBucketsMs.back(),
+                           sortedFrameTimesMs.end() - bucketBegin);
+  _logger->info("benchmark: frame times: {}", histogram);
+}
+
+// the builds of the edits finish a few frames after their stamps, so the edits are summarized over
+// the whole run rather than per stamp
+void Benchmark::_logEditSummary() const {
+  uint64_t stampCount              = 0;
+  uint64_t editedChunkCount        = 0;
+  double editBuildGpuTimeMs        = 0.0;
+  uint64_t octreeAllocationCount   = 0;
+  uint64_t octreeDeallocationCount = 0;
+  for (auto const &frameRecord : _frameRecords) {
+    stampCount += frameRecord.editStampCount;
+    editedChunkCount += frameRecord.editedChunkCount;
+    editBuildGpuTimeMs += frameRecord.editBuildGpuTimeMs;
+    octreeAllocationCount += frameRecord.octreeAllocationCount;
+    octreeDeallocationCount += frameRecord.octreeDeallocationCount;
+  }
+  auto const frameCount = static_cast<double>(_frameRecords.size());
+
+  if (stampCount > 0) {
+    _logger->info("benchmark: {} stamps, {} edited chunks, {:.2f} chunks per stamp, edit gpu: "
+                  "{:.3f} ms per stamp, {:.3f} ms per chunk",
+                  stampCount, editedChunkCount,
+                  static_cast<double>(editedChunkCount) / static_cast<double>(stampCount),
+                  editBuildGpuTimeMs / static_cast<double>(stampCount),
+                  editedChunkCount == 0
+                      ? 0.0
+                      : editBuildGpuTimeMs / static_cast<double>(editedChunkCount));
+  }
+  _logger->info("benchmark: octree allocator churn: {} allocations, {} deallocations, {:.2f} per "
+                "frame",
+                octreeAllocationCount, octreeDeallocationCount,
+                static_cast<double>(octreeAllocationCount + octreeDeallocationCount) / frameCount);
+}
+
+// the averages are weighted by the rays of the frames, over the frames with the statistics
+void Benchmark::_logTraversalSummary(std::vector<std::string> const &traversalRayTypeNames) const {
+  for (size_t rayType = 0; rayType < traversalRayTypeNames.size(); rayType++) {
+    uint64_t rayCount        = 0;
+    double iterSum           = 0.0;
+    double chunkSum          = 0.0;
+    size_t countedFrameCount = 0;
+    for (auto const &frameRecord : _frameRecords) {
+      if (rayType >= frameRecord.traversalRayCounts.size()) {
+        continue;
+      }
+      auto const frameRayCount = frameRecord.traversalRayCounts[rayType];
+      rayCount += frameRayCount;
+      iterSum += static_cast<double>(frameRecord.traversalAvgIters[rayType]) * frameRayCount;
+      chunkSum += static_cast<double>(frameRecord.traversalAvgChunks[rayType]) * frameRayCount;
+      countedFrameCount++;
+    }
+    if (rayCount == 0) {
+      continue;
+    }
+    _logger->info("benchmark: {} rays: {:.0f} per frame, {:.1f} iterations, {:.2f} chunks per ray",
+                  traversalRayTypeNames[rayType],
+                  static_cast<double>(rayCount) / static_cast<double>(countedFrameCount),
+                  iterSum / static_cast<double>(rayCount),
+                  chunkSum / static_cast<double>(rayCount));
+  }
+}
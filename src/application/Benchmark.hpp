@@ -0,0 +1,79 @@
+#pragma once
+
+#include "EditSession.hpp"
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Logger;
+struct BenchmarkInfo;
+
+// plays the camera path of the benchmark config with a fixed time step, and records the frame
+// times, the gpu times of the passes and the memory usage of every frame, so the builds can be
+// compared on the same path, the brush edits of a recorded session are replayed along with it
+class Benchmark {
+public:
+  struct FrameRecord {
+    // between the starts of this frame and the previous one
+    float frameTimeMs = 0.F;
+    // from the start of the frame until its submission
+    float cpuTimeMs = 0.F;
+    // the latest gpu record of each pass, which is as old as the frames in flight
+    std::vector<float> passTimesMs{};
+    float deviceMemoryUsageMb = 0.F;
+    float octreePoolMb        = 0.F;
+    // the stamps replayed in this frame, and the edit builds that finished within it
+    uint32_t editStampCount   = 0;
+    uint32_t editedChunkCount = 0;
+    float editBuildGpuTimeMs  = 0.F;
+    // the octree regions allocated and freed within the frame, by the streaming and the edits alike
+    uint32_t octreeAllocationCount   = 0;
+    uint32_t octreeDeallocationCount = 0;
+    // one per ray type, of the frame the pass times are of, empty without
+    // SvoTracerTweakingData.traversalStatistics
+    std::vector<uint32_t> traversalRayCounts{};
+    std::vector<float> traversalAvgIters{};
+    std::vector<float> traversalAvgChunks{};
+  };
+
+  Benchmark(Logger *logger, BenchmarkInfo const *benchmarkInfo);
+
+  [[nodiscard]] double getTimeStepInSec() const { return _timeStepInSec; }
+  // once the last keyframe is passed
+  [[nodiscard]] bool isDone() const;
+  // the pose of the current frame, interpolated between its keyframes
+  void getCameraPose(glm::vec3 &position, float &yaw, float &pitch) const;
+
+  // the replayed edits of the current frame, none without an edit session
+  std::vector<EditSession::Edit> takeEditsOfCurrentFrame();
+
+  // advances the path by one time step
+  void addFrameRecord(FrameRecord frameRecord);
+
+  // writes one line per frame, and logs the summary of the run
+  void finish(std::vector<std::string> const &passNames,
+              std::vector<std::string> const &traversalRayTypeNames,
+              std::string const &pathToFile) const;
+
+private:
+  Logger *_logger;
+  double _timeStepInSec;
+  std::vector<std::array<float, 6>> _keyframes;
+
+  std::unique_ptr<EditSession> _editSession = nullptr;
+
+  std::vector<FrameRecord> _frameRecords{};
+
+  [[nodiscard]] double _getCurrentTimeInSec() const;
+  bool _writeCsv(std::vector<std::string> const &passNames,
+                 std::vector<std::string> const &traversalRayTypeNames,
+                 std::string const &pathToFile) const;
+  void _logSummary(std::vector<std::string> const &traversalRayTypeNames) const;
+  void _logEditSummary() const;
+  void _logTraversalSummary(std::vector<std::string> const &traversalRayTypeNames) const;
+  void _logFrameTimeHistogram(std::vector<float> const &sortedFrameTimesMs) const;
+};
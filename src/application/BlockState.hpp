@@ -5,4 +5,10 @@
 enum BlockState : uint32_t {
   kShaderChanged = 1U,
   kWindowResized = 2U,
+  // the svo builder has added an octree buffer page, that the tracer needs to bind
+  kOctreeBufferPagesChanged = 4U,
+  // a toggle that is baked into a pipeline variant of the tracer has been flipped
+  kPipelineVariantsChanged = 8U,
+  // a cubemap is captured at the camera, see SvoTracer::captureViews
+  kViewCaptureRequested = 16U,
 };
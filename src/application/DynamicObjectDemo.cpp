@@ -0,0 +1,98 @@
+#include "DynamicObjectDemo.hpp"
+
+#include "svo-builder/DynamicObjects.hpp"
+#include "svo-builder/SvoBuilderDataGpu.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include "glm/gtc/constants.hpp"
+
+#include <cmath>
+
+namespace {
+// the voxels across a sphere
+uint32_t constexpr kSphereVoxelResolution = 32;
+// in chunks
+float constexpr kSphereSize    = 0.5F;
+float constexpr kOrbitRadius   = 1.5F;
+float constexpr kOrbitHeight   = 0.5F;
+float constexpr kOrbitSpeed    = 0.4F;
+float constexpr kBobbingHeight = 0.25F;
+
+// mirrors CpuSvoBuilder, see the octahedral normals of BlockPalette.hpp
+uint32_t _compressNormal(glm::vec3 normal) {
+  float const l1Norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (l1Norm == 0.F) {
+    return 0;
+  }
+  glm::vec2 p = glm::vec2(normal.x, normal.y) / l1Norm;
+  if (normal.z < 0.F) {
+    p = (1.F - glm::abs(glm::vec2(p.y, p.x))) *
+        glm::vec2(p.x >= 0.F ? 1.F : -1.F, p.y >= 0.F ? 1.F : -1.F);
+  }
+  glm::uvec2 const quantized = glm::uvec2(glm::round((p * 0.5F + 0.5F) * 62.F));
+  return quantized.x | (quantized.y << 6);
+}
+
+// the shell of a sphere that fills the cube of the octree
+std::vector<G_FragmentListEntry> _makeSphereFragments() {
+  std::vector<G_FragmentListEntry> fragments{};
+  float const radius = static_cast<float>(kSphereVoxelResolution) * 0.5F;
+  for (uint32_t z = 0; z < kSphereVoxelResolution; z++) {
+    for (uint32_t y = 0; y < kSphereVoxelResolution; y++) {
+      for (uint32_t x = 0; x < kSphereVoxelResolution; x++) {
+        glm::vec3 const offset = glm::vec3(x, y, z) + 0.5F - radius;
+        float const distance   = glm::length(offset);
+        if (distance > radius || distance < radius - 1.5F) {
+          continue;
+        }
+        G_FragmentListEntry fragment{};
+        fragment.coordinates = x | (y << 10) | (z << 20);
+        fragment.properties  = kBlockTypeRock | (_compressNormal(offset / distance) << 8);
+        fragments.push_back(fragment);
+      }
+    }
+  }
+  return fragments;
+}
+} // namespace
+
+DynamicObjectDemo::DynamicObjectDemo(Logger *logger, DynamicObjects *dynamicObjects,
+                                     uint32_t objectCount, uint32_t chunkVoxelDim,
+                                     glm::vec3 centre)
+    : _dynamicObjects(dynamicObjects), _centre(centre) {
+  auto const shapeIndex =
+      _dynamicObjects->addShape(_makeSphereFragments(), kSphereVoxelResolution);
+  if (!shapeIndex.has_value()) {
+    logger->warn("the dynamic object demo has no shape, its objects aren't created");
+    return;
+  }
+
+  // the voxels of the spheres are scaled up, so every sphere is as large at any chunk resolution
+  float const scale =
+      kSphereSize * static_cast<float>(chunkVoxelDim) / static_cast<float>(kSphereVoxelResolution);
+  for (uint32_t i = 0; i < objectCount; i++) {
+    _entities.push_back(_dynamicObjects->createObject(*shapeIndex, _centre, scale));
+  }
+  update(0.F);
+  logger->info("the dynamic object demo circles {} spheres", objectCount);
+}
+
+void DynamicObjectDemo::update(float deltaTimeInSec) {
+  _timeInSec += deltaTimeInSec;
+
+  auto &registry = _dynamicObjects->getRegistry();
+  for (size_t i = 0; i < _entities.size(); i++) {
+    float const phase =
+        glm::two_pi<float>() * static_cast<float>(i) / static_cast<float>(_entities.size());
+    float const angle = phase + _timeInSec * kOrbitSpeed;
+    glm::vec3 const sphereCentre =
+        _centre + glm::vec3(std::cos(angle) * kOrbitRadius,
+                            kOrbitHeight + std::sin(_timeInSec + phase) * kBobbingHeight,
+                            std::sin(angle) * kOrbitRadius);
+
+    // the position is the min corner of the cube of the sphere
+    registry.patch<DynamicObjectTransform>(_entities[i], [&](DynamicObjectTransform &transform) {
+      transform.position = sphereCentre - kSphereSize * 0.5F;
+    });
+  }
+}
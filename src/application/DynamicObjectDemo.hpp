@@ -0,0 +1,29 @@
+#pragma once
+
+#include "entt/entity/registry.hpp"
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Logger;
+class DynamicObjects;
+
+// with SvoBuilder.dynamicObjectDemoCount, a ring of voxel spheres circles the spot the camera
+// starts at, they're moved every frame through the registry of the dynamic objects, which drives
+// the per-frame grid and the instance marching of the tracer, the spheres only translate and scale,
+// the dynamic objects have no rotation
+class DynamicObjectDemo {
+public:
+  DynamicObjectDemo(Logger *logger, DynamicObjects *dynamicObjects, uint32_t objectCount,
+                    uint32_t chunkVoxelDim, glm::vec3 centre);
+
+  // the time step of the benchmark keeps the motion the same from run to run
+  void update(float deltaTimeInSec);
+
+private:
+  DynamicObjects *_dynamicObjects;
+  glm::vec3 _centre;
+  std::vector<entt::entity> _entities{};
+  float _timeInSec = 0.F;
+};
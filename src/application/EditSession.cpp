@@ -0,0 +1,151 @@
+#include "EditSession.hpp"
+
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+uint32_t constexpr kSessionFormatVersion = 1;
+uint32_t constexpr kSessionMagic         = 0x53454C56; // "VLES"
+
+struct SessionFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t editCount;
+  uint32_t padding;
+};
+
+// 28 bytes per edit, the stroke ends leave the brush fields zeroed
+struct EditRecord {
+  uint32_t frame;
+  uint32_t flags;
+  float hitPos[3];
+  float brushSize;
+  float brushStrength;
+};
+
+uint32_t constexpr kStrokeEndFlag = 1U << 0;
+uint32_t constexpr kDeletionFlag  = 1U << 1;
+} // namespace
+
+EditSession::EditSession(Logger *logger) : _logger(logger) {}
+
+void EditSession::addStamp(uint64_t frame, glm::vec3 hitPos, float brushSize, float brushStrength,
+                           bool isDeletion) {
+  if (!_firstFrame) {
+    _firstFrame = frame;
+  }
+  Edit edit{};
+  edit.frame         = static_cast<uint32_t>(frame - *_firstFrame);
+  edit.kind          = Kind::kStamp;
+  edit.isDeletion    = isDeletion;
+  edit.hitPos        = hitPos;
+  edit.brushSize     = brushSize;
+  edit.brushStrength = brushStrength;
+  _edits.push_back(edit);
+  _isStrokeOpen = true;
+}
+
+void EditSession::addStrokeEnd(uint64_t frame) {
+  if (!_isStrokeOpen) {
+    return;
+  }
+  Edit edit{};
+  edit.frame = static_cast<uint32_t>(frame - *_firstFrame);
+  edit.kind  = Kind::kStrokeEnd;
+  _edits.push_back(edit);
+  _isStrokeOpen = false;
+}
+
+bool EditSession::save(std::string const &pathToFile) const {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+  std::ofstream file(pathToFile, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    _logger->warn("failed to create the edit session at {}", pathToFile);
+    return false;
+  }
+
+  SessionFileHeader const header{kSessionMagic, kSessionFormatVersion,
+                                 static_cast<uint32_t>(_edits.size()), 0};
+  file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  for (auto const &edit : _edits) {
+    EditRecord record{};
+    record.frame = edit.frame;
+    record.flags = (edit.kind == Kind::kStrokeEnd ? kStrokeEndFlag : 0U) |
+                   (edit.isDeletion ? kDeletionFlag : 0U);
+    record.hitPos[0]     = edit.hitPos.x;
+    record.hitPos[1]     = edit.hitPos.y;
+    record.hitPos[2]     = edit.hitPos.z;
+    record.brushSize     = edit.brushSize;
+    record.brushStrength = edit.brushStrength;
+    file.write(reinterpret_cast<char const *>(&record), sizeof(record));
+  }
+
+  file.close();
+  if (!file) {
+    _logger->warn("failed to write the edit session to {}", pathToFile);
+    return false;
+  }
+  _logger->info("edit session of {} stamps written to {}", getStampCount(), pathToFile);
+  return true;
+}
+
+bool EditSession::load(std::string const &pathToFile) {
+  std::ifstream file(pathToFile, std::ios::binary);
+  if (!file.is_open()) {
+    _logger->warn("no edit session found at {}", pathToFile);
+    return false;
+  }
+
+  SessionFileHeader header{};
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file || header.magic != kSessionMagic || header.version != kSessionFormatVersion) {
+    _logger->warn("{} isn't an edit session of this version", pathToFile);
+    return false;
+  }
+
+  std::vector<EditRecord> records(header.editCount);
+  file.read(reinterpret_cast<char *>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(EditRecord)));
+  if (!file) {
+    _logger->warn("the edit session at {} is truncated", pathToFile);
+    return false;
+  }
+
+  _edits.clear();
+  _edits.reserve(records.size());
+  for (auto const &record : records) {
+    Edit edit{};
+    edit.frame         = record.frame;
+    edit.kind          = (record.flags & kStrokeEndFlag) != 0 ? Kind::kStrokeEnd : Kind::kStamp;
+    edit.isDeletion    = (record.flags & kDeletionFlag) != 0;
+    edit.hitPos        = {record.hitPos[0], record.hitPos[1], record.hitPos[2]};
+    edit.brushSize     = record.brushSize;
+    edit.brushStrength = record.brushStrength;
+    _edits.push_back(edit);
+  }
+  // the recorded frames never go back, a hand edited file is kept in order anyway
+  std::stable_sort(_edits.begin(), _edits.end(),
+                   [](Edit const &a, Edit const &b) { return a.frame < b.frame; });
+  _nextEdit = 0;
+
+  _logger->info("edit session of {} stamps over {} frames loaded from {}", getStampCount(),
+                _edits.empty() ? 0 : _edits.back().frame + 1, pathToFile);
+  return true;
+}
+
+size_t EditSession::getStampCount() const {
+  return std::count_if(_edits.begin(), _edits.end(),
+                       [](Edit const &edit) { return edit.kind == Kind::kStamp; });
+}
+
+std::vector<EditSession::Edit> EditSession::takeEditsOfFrame(uint32_t frame) {
+  std::vector<Edit> edits{};
+  while (_nextEdit < _edits.size() && _edits[_nextEdit].frame <= frame) {
+    edits.push_back(_edits[_nextEdit++]);
+  }
+  return edits;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+class Logger;
+
+// the brush edits of an interactive session, with the brush they were made with, recorded to a
+// compact binary file, so that the benchmark can replay the same edits in every run, the frames are
+// counted from the first edit, and the hit positions are kept, so the replay doesn't depend on the
+// camera
+class EditSession {
+public:
+  enum class Kind : uint32_t { kStamp, kStrokeEnd };
+
+  struct Edit {
+    uint32_t frame = 0;
+    Kind kind      = Kind::kStamp;
+    // the rest is only set for the stamps
+    bool isDeletion     = false;
+    glm::vec3 hitPos    = glm::vec3(0.F);
+    float brushSize     = 0.F;
+    float brushStrength = 0.F;
+  };
+
+  explicit EditSession(Logger *logger);
+
+  void addStamp(uint64_t frame, glm::vec3 hitPos, float brushSize, float brushStrength,
+                bool isDeletion);
+  // only recorded while a stroke is open, the brush ends its stroke on every frame it isn't held
+  void addStrokeEnd(uint64_t frame);
+  bool save(std::string const &pathToFile) const;
+
+  bool load(std::string const &pathToFile);
+  [[nodiscard]] size_t getStampCount() const;
+  // the edits of the frame, in the order they were made, the frames have to be asked in order
+  std::vector<Edit> takeEditsOfFrame(uint32_t frame);
+
+private:
+  Logger *_logger;
+  std::vector<Edit> _edits{};
+
+  // recording
+  std::optional<uint64_t> _firstFrame{};
+  bool _isStrokeOpen = false;
+
+  // replay
+  size_t _nextEdit = 0;
+};
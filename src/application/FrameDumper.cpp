@@ -0,0 +1,105 @@
+#include "FrameDumper.hpp"
+
+#include "utils/logger/Logger.hpp"
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+FrameDumper::FrameDumper(Logger *logger, std::string pathToFolder)
+    : _logger(logger), _pathToFolder(std::move(pathToFolder)) {
+  std::error_code errorCode;
+  std::filesystem::create_directories(_pathToFolder, errorCode);
+  if (errorCode) {
+    _logger->error("failed to create the frame dump folder {}: {}", _pathToFolder,
+                   errorCode.message());
+  }
+}
+
+FrameDumper::~FrameDumper() { TaskScheduler::get().wait(_writeTasks); }
+
+void FrameDumper::dump(uint64_t frameIndex, uint8_t const *bgraTexels, uint32_t width,
+                       uint32_t height) {
+  _removeFinishedWrites();
+  while (_writeTasks.size() >= kMaxWritingFrames) {
+    TaskScheduler::get().wait(_writeTasks.front());
+    _removeFinishedWrites();
+  }
+  _submitWrite(frameIndex, bgraTexels, width, height);
+}
+
+bool FrameDumper::tryDump(uint64_t frameIndex, uint8_t const *bgraTexels, uint32_t width,
+                          uint32_t height) {
+  _removeFinishedWrites();
+  if (_writeTasks.size() >= kMaxWritingFrames) {
+    return false;
+  }
+  _submitWrite(frameIndex, bgraTexels, width, height);
+  return true;
+}
+
+void FrameDumper::_removeFinishedWrites() {
+  _writeTasks.erase(std::remove_if(_writeTasks.begin(), _writeTasks.end(),
+                                   [](TaskScheduler::TaskHandle const &task) {
+                                     return task->isDone.load(std::memory_order_acquire);
+                                   }),
+                    _writeTasks.end());
+}
+
+void FrameDumper::_submitWrite(uint64_t frameIndex, uint8_t const *bgraTexels, uint32_t width,
+                               uint32_t height) {
+  std::shared_ptr<std::vector<uint8_t>> texels = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(_freeTexelsMutex);
+    if (!_freeTexels.empty()) {
+      texels = std::move(_freeTexels.back());
+      _freeTexels.pop_back();
+    }
+  }
+  if (texels == nullptr) {
+    texels = std::make_shared<std::vector<uint8_t>>();
+  }
+
+  // only the copy is done here, the readback buffer is reused once this returns
+  size_t const size = static_cast<size_t>(width) * height * 4;
+  texels->resize(size);
+  std::memcpy(texels->data(), bgraTexels, size);
+
+  _writeTasks.push_back(TaskScheduler::get().submit([this, frameIndex, texels, width, height]() {
+    _write(frameIndex, *texels, width, height);
+    std::lock_guard<std::mutex> lock(_freeTexelsMutex);
+    _freeTexels.push_back(texels);
+  }));
+}
+
+// the texels are swizzled to rgb in place, each texel only moves towards the front
+void FrameDumper::_write(uint64_t frameIndex, std::vector<uint8_t> &texels, uint32_t width,
+                         uint32_t height) {
+  size_t const texelCount = static_cast<size_t>(width) * height;
+  for (size_t i = 0; i < texelCount; i++) {
+    uint8_t const b   = texels[i * 4 + 0];
+    uint8_t const g   = texels[i * 4 + 1];
+    uint8_t const r   = texels[i * 4 + 2];
+    texels[i * 3 + 0] = r;
+    texels[i * 3 + 1] = g;
+    texels[i * 3 + 2] = b;
+  }
+
+  std::array<char, 32> fileName{};
+  std::snprintf(fileName.data(), fileName.size(), "frame_%06llu.png",
+                static_cast<unsigned long long>(frameIndex));
+  std::string const pathToFile = _pathToFolder + fileName.data();
+
+  auto const intWidth  = static_cast<int>(width);
+  auto const intHeight = static_cast<int>(height);
+  if (stbi_write_png(pathToFile.c_str(), intWidth, intHeight, 3, texels.data(), intWidth * 3) ==
+      0) {
+    _logger->error("failed to write the frame dump {}", pathToFile);
+  }
+}
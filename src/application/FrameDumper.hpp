@@ -0,0 +1,50 @@
+#pragma once
+
+#include "scheduler/TaskScheduler.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Logger;
+
+// writes the frames of the headless mode, and the recorded ones, to numbered png files, the swizzle
+// and the encoding run on the workers of the task scheduler, several frames at once, so that the
+// render loop only pays for the copy out of the readback buffer
+class FrameDumper {
+public:
+  FrameDumper(Logger *logger, std::string pathToFolder);
+  // the frames being written are waited for
+  ~FrameDumper();
+
+  // disable move and copy
+  FrameDumper(const FrameDumper &)            = delete;
+  FrameDumper &operator=(const FrameDumper &) = delete;
+  FrameDumper(FrameDumper &&)                 = delete;
+  FrameDumper &operator=(FrameDumper &&)      = delete;
+
+  // the texels are bgra, it blocks while the writers are busy, so the dumps never fall behind by
+  // more than a few frames
+  void dump(uint64_t frameIndex, uint8_t const *bgraTexels, uint32_t width, uint32_t height);
+  // never blocks, the frame is dropped if the writers are busy, returns whether it's written
+  bool tryDump(uint64_t frameIndex, uint8_t const *bgraTexels, uint32_t width, uint32_t height);
+
+private:
+  static size_t constexpr kMaxWritingFrames = 8;
+
+  Logger *_logger;
+  std::string _pathToFolder;
+
+  // only touched by the dumping thread
+  std::vector<TaskScheduler::TaskHandle> _writeTasks{};
+  // the texels of the finished writes are reused, so their pages are only faulted in once
+  std::mutex _freeTexelsMutex;
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> _freeTexels{};
+
+  void _removeFinishedWrites();
+  void _submitWrite(uint64_t frameIndex, uint8_t const *bgraTexels, uint32_t width,
+                    uint32_t height);
+  void _write(uint64_t frameIndex, std::vector<uint8_t> &texels, uint32_t width, uint32_t height);
+};
@@ -0,0 +1,21 @@
+#include "BlockPalette.hpp"
+
+#include "SvoBuilderDataGpu.hpp"
+
+namespace {
+// https://colorhunt.co/palette/973131e0a75ef9d689f5e7b2
+uint32_t constexpr _packColor(uint32_t r, uint32_t g, uint32_t b) {
+  // the order of unpackUnorm4x8, the first component is in the lowest byte
+  return r | (g << 8) | (b << 16) | (0xFFU << 24);
+}
+} // namespace
+
+BlockPalette::Palette BlockPalette::makeTerrainPalette() {
+  Palette palette{};
+  palette[kBlockTypeDirt]  = _packColor(69, 49, 49);
+  palette[kBlockTypeRock]  = _packColor(128, 128, 128);
+  palette[kBlockTypeSand]  = _packColor(253, 255, 226);
+  palette[kBlockTypeGrass] = _packColor(86, 159, 46);
+  palette[kBlockTypeWater] = _packColor(53, 114, 239);
+  return palette;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// the colors that the leaves of the chunk octrees index, packed as rgba8, so the payload of a leaf
+// is an index instead of a color, and the leaves of a material are shared by the dag, see
+// blockColor.glsl
+namespace BlockPalette {
+uint32_t constexpr kPaletteSize = 256;
+using Palette                   = std::array<uint32_t, kPaletteSize>;
+
+// the block types of the generated terrain index the palette directly, an imported scene brings
+// the palette of its file instead
+Palette makeTerrainPalette();
+}; // namespace BlockPalette
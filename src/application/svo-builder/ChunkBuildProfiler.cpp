@@ -0,0 +1,118 @@
+#include "ChunkBuildProfiler.hpp"
+
+#include "app-context/VulkanApplicationContext.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+ChunkBuildProfiler::ChunkBuildProfiler(VulkanApplicationContext *appContext, Logger *logger,
+                                       uint32_t slotCount, uint32_t octreeLevelCount)
+    : _appContext(appContext), _logger(logger), _octreeLevelCount(octreeLevelCount),
+      _stageCount(kOctreeLevelBegin + octreeLevelCount + 1), _stageTotals(_stageCount) {
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_appContext->getPhysicalDevice(), &properties);
+  _timestampPeriodNs = static_cast<double>(properties.limits.timestampPeriod);
+
+  VkQueryPoolCreateInfo queryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+  queryPoolInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+  queryPoolInfo.queryCount = slotCount * _stageCount * 2;
+  vkCreateQueryPool(_appContext->getDevice(), &queryPoolInfo, nullptr, &_queryPool);
+}
+
+ChunkBuildProfiler::~ChunkBuildProfiler() {
+  vkDestroyQueryPool(_appContext->getDevice(), _queryPool, nullptr);
+}
+
+void ChunkBuildProfiler::recordReset(VkCommandBuffer commandBuffer, uint32_t slotIndex) {
+  vkCmdResetQueryPool(commandBuffer, _queryPool, _getQueryIndex(slotIndex, 0), _stageCount * 2);
+}
+
+// both wait for the commands before them, the stages are separated by barriers anyway
+void ChunkBuildProfiler::recordStageBegin(VkCommandBuffer commandBuffer, uint32_t slotIndex,
+                                          uint32_t stage) {
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool,
+                      _getQueryIndex(slotIndex, stage));
+}
+
+void ChunkBuildProfiler::recordStageEnd(VkCommandBuffer commandBuffer, uint32_t slotIndex,
+                                        uint32_t stage) {
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool,
+                      _getQueryIndex(slotIndex, stage) + 1);
+}
+
+double ChunkBuildProfiler::collect(uint32_t slotIndex) {
+  // a timestamp and its availability per query, the ones that weren't written are unavailable
+  std::vector<uint64_t> results(static_cast<size_t>(_stageCount) * 2 * 2);
+  vkGetQueryPoolResults(_appContext->getDevice(), _queryPool, _getQueryIndex(slotIndex, 0),
+                        _stageCount * 2, results.size() * sizeof(uint64_t), results.data(),
+                        2 * sizeof(uint64_t),
+                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+  double buildTimeMs = 0.0;
+  for (uint32_t stage = 0; stage < _stageCount; stage++) {
+    uint64_t const *begin = &results[static_cast<size_t>(stage) * 4];
+    uint64_t const *end   = begin + 2;
+    if (begin[1] == 0 || end[1] == 0 || end[0] < begin[0]) {
+      continue;
+    }
+    double constexpr kNsPerMs = 1000000.0;
+    double const stageTimeMs =
+        static_cast<double>(end[0] - begin[0]) * _timestampPeriodNs / kNsPerMs;
+    _stageTotals[stage].totalMs += stageTimeMs;
+    _stageTotals[stage].runCount++;
+    buildTimeMs += stageTimeMs;
+  }
+  return buildTimeMs;
+}
+
+void ChunkBuildProfiler::clear() { _stageTotals.assign(_stageCount, StageTotal{}); }
+
+std::string ChunkBuildProfiler::_getStageName(uint32_t stage) const {
+  static std::array<char const *, kOctreeLevelBegin> const kStageNames = {
+      "field construction",  "field modification", "field brick store", "voxel creation",
+      "fragment list store", "fragment upload",    "octree sort"};
+  if (stage < kOctreeLevelBegin) {
+    return kStageNames[stage];
+  }
+  if (stage == getOctreeCopyStage()) {
+    return "octree copy";
+  }
+  return "octree level " + std::to_string(stage - kOctreeLevelBegin);
+}
+
+void ChunkBuildProfiler::printStats() const {
+  _logger->info("chunk build stages (gpu):");
+  for (uint32_t stage = 0; stage < _stageCount; stage++) {
+    auto const &stageTotal = _stageTotals[stage];
+    if (stageTotal.runCount == 0) {
+      continue;
+    }
+    _logger->info("  {}: avg {:.3f} ms, total {:.1f} ms ({} builds)", _getStageName(stage),
+                  stageTotal.totalMs / stageTotal.runCount, stageTotal.totalMs,
+                  stageTotal.runCount);
+  }
+}
+
+void ChunkBuildProfiler::writeCsv(std::string const &pathToFile) const {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+  std::ofstream file(pathToFile, std::ios::trunc);
+  if (!file.is_open()) {
+    _logger->warn("failed to write the chunk build profile to {}", pathToFile);
+    return;
+  }
+
+  file << "stage,builds,total_ms,avg_ms\n";
+  for (uint32_t stage = 0; stage < _stageCount; stage++) {
+    auto const &stageTotal = _stageTotals[stage];
+    if (stageTotal.runCount == 0) {
+      continue;
+    }
+    file << _getStageName(stage) << "," << stageTotal.runCount << "," << stageTotal.totalMs << ","
+         << stageTotal.totalMs / stageTotal.runCount << "\n";
+  }
+  _logger->info("chunk build profile written to {}", pathToFile);
+}
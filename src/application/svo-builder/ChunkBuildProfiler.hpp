@@ -0,0 +1,75 @@
+#pragma once
+
+#include "volk.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Logger;
+class VulkanApplicationContext;
+
+// gpu timestamps around every stage of the chunk builds, one range of queries per build slot, the
+// stages a build skips are simply not available, and left out of the averages
+class ChunkBuildProfiler {
+public:
+  enum Stage : uint32_t {
+    kFieldConstruction, // the field is generated, or loaded from the saved bricks
+    kFieldModification,
+    kFieldBrickStore,
+    kVoxelCreation, // the saved fragments are loaded within this stage as well
+    kFragmentListStore,
+    kFragmentUpload, // replaces the voxelization for an imported scene
+    kOctreeSort,     // the bottom-up octree build only, the leaves are merged within it as well
+    kOctreeLevelBegin,
+    // kOctreeLevelBegin + level for every octree level, followed by the octree copy, see
+    // getOctreeCopyStage()
+  };
+
+  ChunkBuildProfiler(VulkanApplicationContext *appContext, Logger *logger, uint32_t slotCount,
+                     uint32_t octreeLevelCount);
+  ~ChunkBuildProfiler();
+
+  // disable copy and move
+  ChunkBuildProfiler(ChunkBuildProfiler const &)            = delete;
+  ChunkBuildProfiler(ChunkBuildProfiler &&)                 = delete;
+  ChunkBuildProfiler &operator=(ChunkBuildProfiler const &) = delete;
+  ChunkBuildProfiler &operator=(ChunkBuildProfiler &&)      = delete;
+
+  [[nodiscard]] uint32_t getOctreeCopyStage() const {
+    return kOctreeLevelBegin + _octreeLevelCount;
+  }
+
+  // the reset goes first in the first command buffer of a build
+  void recordReset(VkCommandBuffer commandBuffer, uint32_t slotIndex);
+  void recordStageBegin(VkCommandBuffer commandBuffer, uint32_t slotIndex, uint32_t stage);
+  void recordStageEnd(VkCommandBuffer commandBuffer, uint32_t slotIndex, uint32_t stage);
+
+  // adds the stages of the finished build of the slot to the totals, returns their sum
+  double collect(uint32_t slotIndex);
+  void clear();
+
+  void printStats() const;
+  // one line per stage, the stages that never ran are left out
+  void writeCsv(std::string const &pathToFile) const;
+
+private:
+  VulkanApplicationContext *_appContext;
+  Logger *_logger;
+  uint32_t _octreeLevelCount;
+  uint32_t _stageCount;
+  double _timestampPeriodNs = 0.0;
+
+  VkQueryPool _queryPool = VK_NULL_HANDLE;
+
+  struct StageTotal {
+    double totalMs    = 0.0;
+    uint32_t runCount = 0;
+  };
+  std::vector<StageTotal> _stageTotals;
+
+  [[nodiscard]] uint32_t _getQueryIndex(uint32_t slotIndex, uint32_t stage) const {
+    return (slotIndex * _stageCount + stage) * 2;
+  }
+  [[nodiscard]] std::string _getStageName(uint32_t stage) const;
+};
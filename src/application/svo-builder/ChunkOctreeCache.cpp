@@ -0,0 +1,185 @@
+#include "ChunkOctreeCache.hpp"
+
+#include "CpuSvoBuilder.hpp"
+#include "config-container/sub-config/SvoBuilderInfo.hpp"
+#include "utils/config/RootDir.h"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <utility>
+
+namespace {
+// bumped whenever the layout of the file, or of the octree data changes
+uint32_t constexpr kCacheFormatVersion = 3;
+uint32_t constexpr kCacheMagic         = 0x434F4C56; // "VLOC"
+
+struct CacheFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key;
+  uint32_t chunkCount;
+  uint32_t flags;
+};
+
+uint32_t constexpr kBuiltOnHostFlag = 1U << 0;
+
+// fnv-1a, the key has to stay the same between launches, unlike std::hash
+uint64_t constexpr kFnvOffsetBasis = 14695981039346656037ULL;
+uint64_t constexpr kFnvPrime       = 1099511628211ULL;
+
+uint64_t _hashBytes(uint64_t hash, void const *data, size_t size) {
+  auto const *bytes = static_cast<unsigned char const *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+uint64_t _hashString(uint64_t hash, std::string const &str) {
+  return _hashBytes(hash, str.data(), str.size());
+}
+} // namespace
+
+ChunkOctreeCache::ChunkOctreeCache(Logger *logger, std::string pathToFile, uint64_t key)
+    : _logger(logger), _pathToFile(std::move(pathToFile)), _key(key) {}
+
+ChunkOctreeCache::~ChunkOctreeCache() = default;
+
+uint64_t ChunkOctreeCache::makeKey(uint32_t chunkVoxelDim, glm::uvec3 chunksDim,
+                                   uint32_t bakedNoiseOctaveCount,
+                                   SvoBuilderInfo const &builderInfo,
+                                   std::vector<std::string> const &shaderFolders,
+                                   std::string const &pathToVoxScene) {
+  uint64_t hash = kFnvOffsetBasis;
+  hash          = _hashBytes(hash, &kCacheFormatVersion, sizeof(kCacheFormatVersion));
+  hash          = _hashBytes(hash, &chunkVoxelDim, sizeof(chunkVoxelDim));
+  hash          = _hashBytes(hash, &chunksDim, sizeof(chunksDim));
+  hash          = _hashBytes(hash, &bakedNoiseOctaveCount, sizeof(bakedNoiseOctaveCount));
+  // the host builder ports the shaders by hand, a change of the port invalidates the cache as well
+  hash = _hashBytes(hash, &CpuSvoBuilder::kPortVersion, sizeof(CpuSvoBuilder::kPortVersion));
+
+  auto const isDeduplicated = static_cast<uint32_t>(builderInfo.deduplicateChunkOctrees);
+  auto const isReordered    = static_cast<uint32_t>(builderInfo.reorderChunkOctrees);
+  auto const &lodDistances  = builderInfo.chunkLodDistances;
+
+  hash = _hashBytes(hash, &isDeduplicated, sizeof(isDeduplicated));
+  hash = _hashBytes(hash, &isReordered, sizeof(isReordered));
+  hash = _hashBytes(hash, lodDistances.data(), lodDistances.size() * sizeof(uint32_t));
+
+  // the included files are hashed along with the shaders, the paths are sorted, so that the order
+  // of the directory listing doesn't matter
+  for (auto const &shaderFolder : shaderFolders) {
+    std::vector<std::filesystem::path> shaderPaths{};
+    for (auto const &entry : std::filesystem::recursive_directory_iterator(shaderFolder)) {
+      if (entry.is_regular_file()) {
+        shaderPaths.push_back(entry.path());
+      }
+    }
+    std::sort(shaderPaths.begin(), shaderPaths.end());
+
+    for (auto const &shaderPath : shaderPaths) {
+      std::ifstream file(shaderPath, std::ios::binary);
+      std::string const source{std::istreambuf_iterator<char>(file),
+                               std::istreambuf_iterator<char>()};
+      std::string const relativePath =
+          std::filesystem::relative(shaderPath, shaderFolder).generic_string();
+      hash = _hashString(hash, relativePath);
+      hash = _hashString(hash, source);
+    }
+  }
+
+  hash = _hashString(hash, pathToVoxScene);
+  std::error_code errorCode{};
+  if (!pathToVoxScene.empty() && std::filesystem::exists(pathToVoxScene, errorCode)) {
+    auto const fileSize       = static_cast<uint64_t>(std::filesystem::file_size(pathToVoxScene));
+    auto const lastWriteTicks = static_cast<int64_t>(
+        std::filesystem::last_write_time(pathToVoxScene).time_since_epoch().count());
+    hash = _hashBytes(hash, &fileSize, sizeof(fileSize));
+    hash = _hashBytes(hash, &lastWriteTicks, sizeof(lastWriteTicks));
+  }
+  return hash;
+}
+
+std::string ChunkOctreeCache::getPathToSceneCache() {
+  return kPathToResourceFolder + "cache/chunk-octrees.bin";
+}
+
+std::vector<std::string> ChunkOctreeCache::getBuilderShaderFolders() {
+  return {kPathToResourceFolder + "shaders/svo-builder/",
+          kPathToResourceFolder + "shaders/include/"};
+}
+
+bool ChunkOctreeCache::openForReading() {
+  _inputFile.open(_pathToFile, std::ios::binary);
+  if (!_inputFile.is_open()) {
+    _logger->info("no chunk octree cache found at {}", _pathToFile);
+    return false;
+  }
+
+  CacheFileHeader header{};
+  _inputFile.read(reinterpret_cast<char *>(&header), sizeof(header));
+  _inputFile.read(reinterpret_cast<char *>(_palette.data()), sizeof(_palette));
+  if (!_inputFile || header.magic != kCacheMagic || header.version != kCacheFormatVersion ||
+      header.key != _key) {
+    _logger->info("the chunk octree cache is outdated, the scene is generated again");
+    _inputFile.close();
+    return false;
+  }
+
+  _chunkCount    = header.chunkCount;
+  _isBuiltOnHost = (header.flags & kBuiltOnHostFlag) != 0;
+  return true;
+}
+
+bool ChunkOctreeCache::readChunkRecord(ChunkRecord &record) {
+  _inputFile.read(reinterpret_cast<char *>(&record), sizeof(record));
+  return static_cast<bool>(_inputFile);
+}
+
+bool ChunkOctreeCache::readOctreeData(void *data, size_t size) {
+  _inputFile.read(static_cast<char *>(data), static_cast<std::streamsize>(size));
+  return static_cast<bool>(_inputFile);
+}
+
+bool ChunkOctreeCache::openForWriting(uint32_t chunkCount, BlockPalette::Palette const &palette,
+                                      bool isBuiltOnHost) {
+  std::filesystem::create_directories(std::filesystem::path(_pathToFile).parent_path());
+  _outputFile.open(_getTemporaryPath(), std::ios::binary | std::ios::trunc);
+  if (!_outputFile.is_open()) {
+    _logger->warn("failed to create the chunk octree cache at {}", _getTemporaryPath());
+    return false;
+  }
+
+  CacheFileHeader const header{kCacheMagic, kCacheFormatVersion, _key, chunkCount,
+                               isBuiltOnHost ? kBuiltOnHostFlag : 0U};
+  _outputFile.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  _outputFile.write(reinterpret_cast<char const *>(palette.data()), sizeof(palette));
+  return true;
+}
+
+void ChunkOctreeCache::writeChunkRecord(ChunkRecord const &record, void const *octreeData) {
+  _outputFile.write(reinterpret_cast<char const *>(&record), sizeof(record));
+  _outputFile.write(static_cast<char const *>(octreeData),
+                    static_cast<std::streamsize>(record.octreeLength * sizeof(uint32_t)));
+}
+
+bool ChunkOctreeCache::finishWriting() {
+  _outputFile.close();
+  if (!_outputFile) {
+    _logger->warn("failed to write the chunk octree cache");
+    std::remove(_getTemporaryPath().c_str());
+    return false;
+  }
+
+  std::error_code errorCode{};
+  std::filesystem::rename(_getTemporaryPath(), _pathToFile, errorCode);
+  if (errorCode) {
+    _logger->warn("failed to replace the chunk octree cache: {}", errorCode.message());
+    return false;
+  }
+  return true;
+}
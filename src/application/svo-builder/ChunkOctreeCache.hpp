@@ -0,0 +1,84 @@
+#pragma once
+
+#include "BlockPalette.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Logger;
+struct SvoBuilderInfo;
+
+// the compacted chunk octrees of a generated scene, kept on disk, so that the next launch with the
+// same terrain and the same builder shaders copies them instead of generating them again
+// the file is a header and the palette that the leaves index, followed by one record per non-empty
+// chunk, each record is directly followed by the octree data, so that the whole file can be
+// streamed in order
+class ChunkOctreeCache {
+public:
+  struct ChunkRecord {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+    uint32_t lod;
+    uint32_t octreeLength; // in uint32
+  };
+
+  ChunkOctreeCache(Logger *logger, std::string pathToFile, uint64_t key);
+  ~ChunkOctreeCache();
+
+  // disable copy and move
+  ChunkOctreeCache(ChunkOctreeCache const &)            = delete;
+  ChunkOctreeCache(ChunkOctreeCache &&)                 = delete;
+  ChunkOctreeCache &operator=(ChunkOctreeCache const &) = delete;
+  ChunkOctreeCache &operator=(ChunkOctreeCache &&)      = delete;
+
+  // identifies the generated scene, the builder shaders contain the terrain noise, so any change
+  // to them invalidates the cache, an imported scene is identified by its file, its size and its
+  // modification time, the path is empty for the generated terrain, the baked noise octaves filter
+  // the terrain differently, they're 0 for the host builder, which always hashes the noise, the
+  // octrees are cached after they're merged and laid out, at the levels of detail of their
+  // distances, so the options of those are part of the key too
+  static uint64_t makeKey(uint32_t chunkVoxelDim, glm::uvec3 chunksDim,
+                          uint32_t bakedNoiseOctaveCount, SvoBuilderInfo const &builderInfo,
+                          std::vector<std::string> const &shaderFolders,
+                          std::string const &pathToVoxScene);
+  // the cache of the scene is shared by the gpu builder and the host one, the host one ports the
+  // builder shaders, so they key its cache as well, along with the version of the port
+  static std::string getPathToSceneCache();
+  static std::vector<std::string> getBuilderShaderFolders();
+
+  // returns false on a miss, that is, if there's no cache file, or it belongs to another key
+  bool openForReading();
+  [[nodiscard]] uint32_t getChunkCount() const { return _chunkCount; }
+  // written by CpuSvoBuilder, rather than by the builder shaders
+  [[nodiscard]] bool isBuiltOnHost() const { return _isBuiltOnHost; }
+  [[nodiscard]] BlockPalette::Palette const &getPalette() const { return _palette; }
+  // both return false if the file ends early, the octree data of a record has to be read before
+  // the next record
+  bool readChunkRecord(ChunkRecord &record);
+  bool readOctreeData(void *data, size_t size);
+
+  // the records are written to a temporary file, which replaces the cache file once it's
+  // finished, so an interrupted write never leaves a broken cache behind
+  bool openForWriting(uint32_t chunkCount, BlockPalette::Palette const &palette,
+                      bool isBuiltOnHost = false);
+  void writeChunkRecord(ChunkRecord const &record, void const *octreeData);
+  bool finishWriting();
+
+private:
+  Logger *_logger;
+  std::string _pathToFile;
+  uint64_t _key;
+
+  std::ifstream _inputFile;
+  std::ofstream _outputFile;
+  uint32_t _chunkCount = 0;
+  bool _isBuiltOnHost  = false;
+  BlockPalette::Palette _palette{};
+
+  [[nodiscard]] std::string _getTemporaryPath() const { return _pathToFile + ".tmp"; }
+};
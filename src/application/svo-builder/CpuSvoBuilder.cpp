@@ -0,0 +1,516 @@
+#include "CpuSvoBuilder.hpp"
+
+#include "BlockPalette.hpp"
+#include "ChunkOctreeCache.hpp"
+#include "OctreeDag.hpp"
+#include "OctreeLayout.hpp"
+#include "SvoBuilderDataGpu.hpp"
+#include "VoxData.hpp"
+#include "VoxLoader.hpp"
+#include "scheduler/TaskScheduler.hpp"
+#include "utils/config/RootDir.h"
+#include "utils/logger/Logger.hpp"
+
+#include "config-container/ConfigContainer.hpp"
+#include "config-container/sub-config/SvoBuilderInfo.hpp"
+#include "config-container/sub-config/TerrainInfo.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <string>
+
+namespace {
+// ports of blockTypeAndWeight.glsl and inoise.glsl, the float operations are kept in the order of
+// the shaders, and the integer ones wrap around like in glsl
+float constexpr kWeightBoundaryMin   = -(1.0F / 100.0F);
+float constexpr kWeightBoundaryMax   = 1.0F / 100.0F;
+uint32_t constexpr kWeightBitCount   = 12;
+uint32_t constexpr kWeightLevelCount = (1U << kWeightBitCount) - 1;
+
+uint32_t _getBlockTypeFromWeight(float weight) {
+  if (weight < 0.0F) {
+    return kBlockTypeEmpty;
+  }
+  if (weight < 0.01F) {
+    return kBlockTypeGrass;
+  }
+  return kBlockTypeDirt;
+}
+
+uint32_t _packWeight(float weight) {
+  weight          = std::min(std::max(weight, kWeightBoundaryMin), kWeightBoundaryMax);
+  float const f01 = (weight - kWeightBoundaryMin) / (kWeightBoundaryMax - kWeightBoundaryMin);
+  return static_cast<uint32_t>(f01 * static_cast<float>(kWeightLevelCount));
+}
+
+float _unpackWeight(uint32_t encodedWeight) {
+  return (static_cast<float>(encodedWeight) / static_cast<float>(kWeightLevelCount)) *
+             (kWeightBoundaryMax - kWeightBoundaryMin) +
+         kWeightBoundaryMin;
+}
+
+uint32_t _packBlockTypeAndWeight(uint32_t blockType, float weight) {
+  return (blockType << kWeightBitCount) | _packWeight(weight);
+}
+
+void _unpackBlockTypeAndWeight(uint32_t &oBlockType, float &oWeight, uint32_t data) {
+  oBlockType = data >> kWeightBitCount;
+  oWeight    = _unpackWeight(data & kWeightLevelCount);
+}
+
+glm::vec3 _hash(glm::ivec3 p) {
+  glm::uvec3 const q{p};
+  glm::uvec3 n{q.x * 127U + q.y * 311U + q.z * 74U, q.x * 269U + q.y * 183U + q.z * 246U,
+               q.x * 113U + q.y * 271U + q.z * 124U};
+
+  // 1D hash by Hugo Elias
+  n = (n << 13U) ^ n;
+  n = n * (n * n * 15731U + 789221U) + 1376312589U;
+  return -1.0F + 2.0F * glm::vec3(n & glm::uvec3(0x0FFFFFFFU)) / static_cast<float>(0x0FFFFFFF);
+}
+
+// the value of noised, the derivatives aren't used by the field
+float _noise(glm::vec3 x) {
+  glm::ivec3 const i = glm::ivec3(glm::floor(x));
+  glm::vec3 const f  = glm::fract(x);
+
+  // quintic interpolant
+  glm::vec3 const u = f * f * f * (f * (f * 6.0F - 15.0F) + 10.0F);
+
+  float const va = glm::dot(_hash(i + glm::ivec3(0, 0, 0)), f - glm::vec3(0.0F, 0.0F, 0.0F));
+  float const vb = glm::dot(_hash(i + glm::ivec3(1, 0, 0)), f - glm::vec3(1.0F, 0.0F, 0.0F));
+  float const vc = glm::dot(_hash(i + glm::ivec3(0, 1, 0)), f - glm::vec3(0.0F, 1.0F, 0.0F));
+  float const vd = glm::dot(_hash(i + glm::ivec3(1, 1, 0)), f - glm::vec3(1.0F, 1.0F, 0.0F));
+  float const ve = glm::dot(_hash(i + glm::ivec3(0, 0, 1)), f - glm::vec3(0.0F, 0.0F, 1.0F));
+  float const vf = glm::dot(_hash(i + glm::ivec3(1, 0, 1)), f - glm::vec3(1.0F, 0.0F, 1.0F));
+  float const vg = glm::dot(_hash(i + glm::ivec3(0, 1, 1)), f - glm::vec3(0.0F, 1.0F, 1.0F));
+  float const vh = glm::dot(_hash(i + glm::ivec3(1, 1, 1)), f - glm::vec3(1.0F, 1.0F, 1.0F));
+
+  return va + u.x * (vb - va) + u.y * (vc - va) + u.z * (ve - va) +
+         u.x * u.y * (va - vb - vc + vd) + u.y * u.z * (va - vc - ve + vg) +
+         u.z * u.x * (va - vb - ve + vf) +
+         (-va + vb + vc - vd + ve - vf - vg + vh) * u.x * u.y * u.z;
+}
+
+// ports of chunkFieldConstruction.comp and chunkVoxelCreation.comp, for the whole chunk
+float _computeNoise(glm::vec3 p) {
+  float total       = 0.0F;
+  float amplitude   = 0.5F;
+  float frequency   = 2.0F;
+  float persistence = 0.3F;
+  float lacunarity  = 2.2F;
+  int octaves       = 5;
+
+  for (int i = 0; i < octaves; i++) {
+    total += amplitude * (_noise(p * frequency) + 0.5F);
+    amplitude *= persistence;
+    frequency *= lacunarity;
+  }
+  return total;
+}
+
+float _islandGradientFalloff(glm::uvec3 chunksDim, glm::vec3 globalVoxelPos) {
+  glm::vec2 const halfWorldDim2D = glm::vec2(chunksDim.x, chunksDim.z) / 2.0F;
+  glm::vec2 const center         = halfWorldDim2D;
+  float const distanceToCenter =
+      glm::distance(center, glm::vec2(globalVoxelPos.x, globalVoxelPos.z));
+  return 1.0F - glm::smoothstep(0.0F, std::min(halfWorldDim2D.x, halfWorldDim2D.y),
+                                distanceToCenter);
+}
+
+// mirrors compressNormal of chunkVoxelCreation.comp, the octahedral projection doesn't need the
+// normal to be normalized, and a zero one is packed as zero, like there
+uint32_t _compressNormal(glm::vec3 normal) {
+  float const l1Norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (l1Norm == 0.F) {
+    return 0;
+  }
+  glm::vec2 p = glm::vec2(normal.x, normal.y) / l1Norm;
+  if (normal.z < 0.F) {
+    p = (1.F - glm::abs(glm::vec2(p.y, p.x))) *
+        glm::vec2(p.x >= 0.F ? 1.F : -1.F, p.y >= 0.F ? 1.F : -1.F);
+  }
+  glm::uvec2 const quantized = glm::uvec2(glm::round((p * 0.5F + 0.5F) * 62.F));
+  return quantized.x | (quantized.y << 6);
+}
+
+std::vector<G_FragmentListEntry> _createChunkFragments(glm::ivec3 chunkIndex,
+                                                       uint32_t voxelResolution,
+                                                       glm::uvec3 chunksDim, bool islandFalloff) {
+  uint32_t const fieldDim = voxelResolution + 1;
+  auto const fieldIndex   = [fieldDim](uint32_t x, uint32_t y, uint32_t z) {
+    return x + fieldDim * (y + fieldDim * z);
+  };
+
+  // the points of a row are contiguous, so that the compiler can vectorize the noise
+  glm::vec3 const chunkPos{chunkIndex};
+  std::vector<uint32_t> field(static_cast<size_t>(fieldDim) * fieldDim * fieldDim);
+  for (uint32_t z = 0; z < fieldDim; z++) {
+    for (uint32_t y = 0; y < fieldDim; y++) {
+      for (uint32_t x = 0; x < fieldDim; x++) {
+        glm::vec3 const localVoxelPos =
+            (glm::vec3(x, y, z) - 0.5F) / static_cast<float>(voxelResolution);
+        glm::vec3 const globalVoxelPos = chunkPos + localVoxelPos;
+
+        float noise = _computeNoise(globalVoxelPos);
+        if (islandFalloff) {
+          noise *= _islandGradientFalloff(chunksDim, globalVoxelPos);
+        }
+        float const weight = noise - globalVoxelPos.y;
+
+        uint32_t blockType = _getBlockTypeFromWeight(weight);
+        if (blockType != kBlockTypeEmpty && globalVoxelPos.y < 0.1F) {
+          blockType = kBlockTypeSand;
+        }
+        field[fieldIndex(x, y, z)] = _packBlockTypeAndWeight(blockType, weight);
+      }
+    }
+  }
+
+  std::vector<G_FragmentListEntry> fragments{};
+  for (uint32_t z = 0; z < voxelResolution; z++) {
+    for (uint32_t y = 0; y < voxelResolution; y++) {
+      for (uint32_t x = 0; x < voxelResolution; x++) {
+        std::array<uint32_t, 8> blockTypeData{};
+        std::array<float, 8> weightData{};
+        for (uint32_t i = 0; i < 8; i++) {
+          _unpackBlockTypeAndWeight(blockTypeData[i], weightData[i],
+                                    field[fieldIndex(x + (i & 1), y + ((i >> 1) & 1),
+                                                     z + ((i >> 2) & 1))]);
+        }
+
+        auto const [lightestBlockType, densestBlockType] =
+            std::minmax_element(blockTypeData.begin(), blockTypeData.end());
+        if (*lightestBlockType != kBlockTypeEmpty || *densestBlockType == kBlockTypeEmpty) {
+          continue;
+        }
+
+        glm::vec3 normal{};
+        normal.x = ((weightData[0] + weightData[2] + weightData[4] + weightData[6]) -
+                    (weightData[1] + weightData[3] + weightData[5] + weightData[7])) *
+                   0.25F;
+        normal.y = ((weightData[0] + weightData[1] + weightData[4] + weightData[5]) -
+                    (weightData[2] + weightData[3] + weightData[6] + weightData[7])) *
+                   0.25F;
+        normal.z = ((weightData[0] + weightData[1] + weightData[2] + weightData[3]) -
+                    (weightData[4] + weightData[5] + weightData[6] + weightData[7])) *
+                   0.25F;
+
+        G_FragmentListEntry fragment{};
+        fragment.coordinates = x | (y << 10) | (z << 20);
+        fragment.properties  = (*densestBlockType & 0xFF) | (_compressNormal(normal) << 8);
+        fragments.push_back(fragment);
+      }
+    }
+  }
+  return fragments;
+}
+
+// the passes of octreeInitNode.comp, octreeTagNode.comp, octreeAllocNode.comp and
+// octreeModifyArg.comp, level by level, the tagged nodes of a level get their child groups in the
+// order of their index, an empty chunk has no octree
+std::vector<uint32_t> _buildChunkOctree(std::vector<G_FragmentListEntry> const &fragments,
+                                        uint32_t voxelResolution) {
+  if (fragments.empty()) {
+    return {};
+  }
+
+  uint32_t constexpr kCoordinateMask = 0x3FF;
+  auto const levelCount = static_cast<uint32_t>(std::log2(voxelResolution));
+
+  // the root group is pre-allocated
+  std::vector<uint32_t> octree(OctreeDag::kNodeGroupLength, 0);
+  uint32_t allocBegin = 0;
+  uint32_t allocNum   = OctreeDag::kNodeGroupLength;
+  uint32_t groupCount = 1;
+
+  for (uint32_t level = 0; level < levelCount; level++) {
+    for (auto const &fragment : fragments) {
+      glm::uvec3 levelPos{fragment.coordinates & kCoordinateMask,
+                          (fragment.coordinates >> 10) & kCoordinateMask,
+                          (fragment.coordinates >> 20) & kCoordinateMask};
+      uint32_t levelDim = voxelResolution;
+      uint32_t idx      = 0;
+      uint32_t cur      = 0;
+      do {
+        levelDim >>= 1;
+        glm::uvec3 const cmp = glm::uvec3(glm::greaterThanEqual(levelPos, glm::uvec3(levelDim)));
+        idx                  = cur | cmp.x | (cmp.y << 1) | (cmp.z << 2);
+        cur                  = octree[idx] & OctreeDag::kChildPointerMask;
+        levelPos -= cmp * levelDim;
+      } while (cur != 0 && levelDim > 1);
+
+      // the fragments that end up in the same leaf overwrite each other, the gpu keeps an
+      // arbitrary one of them as well
+      octree[idx] = levelDim == 1 ? OctreeDag::kHasChildBit | OctreeDag::kIsLeafBit |
+                                        fragment.properties
+                                  : OctreeDag::kHasChildBit;
+    }
+
+    if (level == levelCount - 1) {
+      break;
+    }
+
+    for (uint32_t idx = allocBegin; idx < allocBegin + allocNum; idx++) {
+      if ((octree[idx] & OctreeDag::kHasChildBit) != 0) {
+        octree[idx] = (groupCount++ * OctreeDag::kNodeGroupLength) | OctreeDag::kHasChildBit;
+      }
+    }
+    allocBegin += allocNum;
+    allocNum = groupCount * OctreeDag::kNodeGroupLength - allocBegin;
+    octree.resize(allocBegin + allocNum, 0);
+  }
+  return octree;
+}
+
+// the coordinates of an imported fragment are scaled down like the upload of SvoBuilder does
+std::vector<G_FragmentListEntry>
+_scaleImportedFragments(std::vector<G_FragmentListEntry> const &fragmentList, uint32_t lod) {
+  uint32_t constexpr kCoordinateMask = 0x3FF;
+
+  std::vector<G_FragmentListEntry> fragments(fragmentList.size());
+  for (size_t i = 0; i < fragmentList.size(); i++) {
+    uint32_t const coordinates = fragmentList[i].coordinates;
+    uint32_t const x           = (coordinates & kCoordinateMask) >> lod;
+    uint32_t const y           = ((coordinates >> 10) & kCoordinateMask) >> lod;
+    uint32_t const z           = ((coordinates >> 20) & kCoordinateMask) >> lod;
+
+    fragments[i].coordinates = x | (y << 10) | (z << 20);
+    fragments[i].properties  = fragmentList[i].properties;
+  }
+  return fragments;
+}
+} // namespace
+
+CpuSvoBuilder::CpuSvoBuilder(Logger *logger, ConfigContainer *configContainer)
+    : _logger(logger), _configContainer(configContainer) {
+  // mirrors SvoBuilder::init
+  auto const voxelLevelCount =
+      static_cast<uint32_t>(std::log2(_configContainer->terrainInfo->chunkVoxelDim));
+  _chunkLodCount = std::clamp(voxelLevelCount, 3U, kMaxChunkLodCount + 2) - 2;
+}
+
+CpuSvoBuilder::~CpuSvoBuilder() = default;
+
+std::vector<uint32_t> CpuSvoBuilder::buildOctree(std::vector<G_FragmentListEntry> const &fragments,
+                                                 uint32_t voxelResolution) {
+  return _buildChunkOctree(fragments, voxelResolution);
+}
+
+uint32_t CpuSvoBuilder::_decideChunkLod(glm::ivec3 chunkIndex, glm::ivec3 cameraChunk) const {
+  auto const &lodDistances = _configContainer->svoBuilderInfo->chunkLodDistances;
+  int64_t const dx         = chunkIndex.x - cameraChunk.x;
+  int64_t const dz         = chunkIndex.z - cameraChunk.z;
+  int64_t const distanceSq = dx * dx + dz * dz;
+
+  uint32_t lod = 0;
+  while (lod + 1 < _chunkLodCount && lodDistances[lod] > 0 &&
+         distanceSq >= static_cast<int64_t>(lodDistances[lod]) * lodDistances[lod]) {
+    lod++;
+  }
+  return lod;
+}
+
+bool CpuSvoBuilder::buildSceneToCache() {
+  if (!_configContainer->svoBuilderInfo->useChunkOctreeCache) {
+    _logger->warn("the chunk octree cache is disabled, the prebuilt octrees won't be loaded");
+  }
+  BuiltScene scene{};
+  if (!_buildScene(scene)) {
+    return false;
+  }
+
+  uint32_t chunkCount = 0;
+  for (auto const &chunk : scene.chunks) {
+    chunkCount += chunk.octree.empty() ? 0 : 1;
+  }
+  ChunkOctreeCache cache(_logger, ChunkOctreeCache::getPathToSceneCache(), scene.cacheKey);
+  if (!cache.openForWriting(chunkCount, scene.palette, true)) {
+    return false;
+  }
+  for (auto const &chunk : scene.chunks) {
+    if (chunk.octree.empty()) {
+      continue;
+    }
+    ChunkOctreeCache::ChunkRecord const record{
+        static_cast<uint32_t>(chunk.chunkIndex.x), static_cast<uint32_t>(chunk.chunkIndex.y),
+        static_cast<uint32_t>(chunk.chunkIndex.z), chunk.lod,
+        static_cast<uint32_t>(chunk.octree.size())};
+    cache.writeChunkRecord(record, chunk.octree.data());
+  }
+  if (!cache.finishWriting()) {
+    return false;
+  }
+  _logger->info("{} chunk octrees saved to the cache", chunkCount);
+  return true;
+}
+
+bool CpuSvoBuilder::compareWithCache() {
+  BuiltScene scene{};
+  if (!_buildScene(scene)) {
+    return false;
+  }
+
+  ChunkOctreeCache cache(_logger, ChunkOctreeCache::getPathToSceneCache(), scene.cacheKey);
+  if (!cache.openForReading()) {
+    _logger->error("there's no chunk octree cache of the same scene and builder to compare with");
+    return false;
+  }
+  if (cache.isBuiltOnHost()) {
+    _logger->error("the chunk octree cache was written by the host builder, run the application "
+                   "with the cache enabled to have the gpu builder write it");
+    return false;
+  }
+
+  uint32_t mismatchCount = 0;
+  if (cache.getPalette() != scene.palette) {
+    _logger->error("the palette of the cache differs");
+    mismatchCount++;
+  }
+
+  // the node groups are laid out in traversal order on both sides, which only depends on the
+  // shape of the octree, so the allocation order of the gpu doesn't matter
+  auto const canonicalize = [](std::vector<uint32_t> const &octree) {
+    return OctreeLayout::reorderForTraversal(octree.data(), octree.size(),
+                                             OctreeLayout::kBreadthFirstLevelCount);
+  };
+  uint32_t constexpr kLoggedMismatchCount = 8;
+  auto const reportMismatch = [&](glm::ivec3 chunkIndex, char const *reason) {
+    if (mismatchCount < kLoggedMismatchCount) {
+      _logger->error("chunk ({}, {}, {}) differs: {}", chunkIndex.x, chunkIndex.y, chunkIndex.z,
+                     reason);
+    }
+    mismatchCount++;
+  };
+
+  glm::uvec3 const chunksDim = _configContainer->terrainInfo->chunksDim;
+  std::vector<bool> isCompared(scene.chunks.size(), false);
+  std::vector<uint32_t> gpuOctree{};
+  for (uint32_t i = 0; i < cache.getChunkCount(); i++) {
+    ChunkOctreeCache::ChunkRecord record{};
+    if (!cache.readChunkRecord(record)) {
+      _logger->error("the chunk octree cache ends early");
+      return false;
+    }
+    gpuOctree.resize(record.octreeLength);
+    if (!cache.readOctreeData(gpuOctree.data(), gpuOctree.size() * sizeof(uint32_t))) {
+      _logger->error("the chunk octree cache ends early");
+      return false;
+    }
+
+    glm::uvec3 const chunkIndex(record.x, record.y, record.z);
+    if (glm::any(glm::greaterThanEqual(chunkIndex, chunksDim))) {
+      reportMismatch(glm::ivec3(chunkIndex), "it's outside of the terrain");
+      continue;
+    }
+    size_t const index = static_cast<size_t>(chunkIndex.x) +
+                         static_cast<size_t>(chunkIndex.y) * chunksDim.x +
+                         static_cast<size_t>(chunkIndex.z) * chunksDim.x * chunksDim.y;
+    auto const &chunk = scene.chunks[index];
+    isCompared[index] = true;
+    if (chunk.lod != record.lod) {
+      reportMismatch(chunk.chunkIndex, "its level of detail");
+    } else if (chunk.octree.empty()) {
+      reportMismatch(chunk.chunkIndex, "it's empty on the host");
+    } else if (canonicalize(chunk.octree) != canonicalize(gpuOctree)) {
+      reportMismatch(chunk.chunkIndex, "its octree");
+    }
+  }
+  for (size_t i = 0; i < scene.chunks.size(); i++) {
+    if (!isCompared[i] && !scene.chunks[i].octree.empty()) {
+      reportMismatch(scene.chunks[i].chunkIndex, "it's empty on the gpu");
+    }
+  }
+
+  if (mismatchCount > 0) {
+    _logger->error("{} differences between the host and the gpu octrees", mismatchCount);
+    return false;
+  }
+  _logger->info("the {} chunk octrees of the host and the gpu builder match",
+                cache.getChunkCount());
+  return true;
+}
+
+bool CpuSvoBuilder::_buildScene(BuiltScene &scene) {
+  auto const &terrainInfo = *_configContainer->terrainInfo;
+  auto const &builderInfo = *_configContainer->svoBuilderInfo;
+  if (terrainInfo.streamChunks) {
+    _logger->error("the streamed chunks are never cached, there's nothing to prebuild");
+    return false;
+  }
+
+  auto const buildStart      = std::chrono::steady_clock::now();
+  uint32_t const voxelDim    = terrainInfo.chunkVoxelDim;
+  glm::uvec3 const chunksDim = terrainInfo.chunksDim;
+
+  std::string const pathToVoxScene =
+      builderInfo.voxSceneFile.empty()
+          ? ""
+          : kPathToResourceFolder + "models/vox/" + builderInfo.voxSceneFile;
+  std::unique_ptr<VoxData> voxData = nullptr;
+  if (!pathToVoxScene.empty()) {
+    voxData = std::make_unique<VoxData>(
+        VoxLoader::fetchDataFromFile(pathToVoxScene, voxelDim, chunksDim, _logger));
+  }
+
+  // the scene is built before the camera moves, from the centre of the terrain
+  glm::ivec3 const cameraChunk(chunksDim.x / 2, 0, chunksDim.z / 2);
+
+  auto &jobs = scene.chunks;
+  jobs.reserve(static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z);
+  for (uint32_t z = 0; z < chunksDim.z; z++) {
+    for (uint32_t y = 0; y < chunksDim.y; y++) {
+      for (uint32_t x = 0; x < chunksDim.x; x++) {
+        glm::ivec3 const chunkIndex{x, y, z};
+        jobs.push_back({chunkIndex, _decideChunkLod(chunkIndex, cameraChunk), {}});
+      }
+    }
+  }
+
+  // the chunks differ a lot in cost, the empty ones skip the octree entirely, so the workers take
+  // them one by one instead of in even shares
+  TaskScheduler::get().parallelFor(jobs.size(), [&](size_t jobIndex, uint32_t /*slot*/) {
+    auto &job                      = jobs[jobIndex];
+    uint32_t const voxelResolution = voxelDim >> job.lod;
+    std::vector<G_FragmentListEntry> const fragments =
+        voxData != nullptr
+            ? _scaleImportedFragments(voxData->chunkFragmentLists[jobIndex], job.lod)
+            : _createChunkFragments(job.chunkIndex, voxelResolution, chunksDim, true);
+
+    job.octree = _buildChunkOctree(fragments, voxelResolution);
+    if (job.octree.empty()) {
+      return;
+    }
+    if (builderInfo.deduplicateChunkOctrees) {
+      job.octree = OctreeDag::deduplicate(job.octree.data(), job.octree.size());
+    }
+    if (builderInfo.reorderChunkOctrees) {
+      job.octree = OctreeLayout::reorderForTraversal(job.octree.data(), job.octree.size(),
+                                                     OctreeLayout::kBreadthFirstLevelCount);
+    }
+  });
+
+  uint32_t chunkCount = 0;
+  size_t octreeLength = 0;
+  for (auto const &job : jobs) {
+    chunkCount += job.octree.empty() ? 0 : 1;
+    octreeLength += job.octree.size();
+  }
+  auto const buildTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - buildStart)
+                               .count();
+  size_t constexpr kMb = 1024 * 1024;
+  _logger->info("{} chunk octrees built on {} threads in {} ms, {} mb", chunkCount,
+                TaskScheduler::get().getSlotCount(), buildTimeMs,
+                octreeLength * sizeof(uint32_t) / kMb);
+
+  // the host builder always hashes the noise, it doesn't share a cache with the baked octaves
+  scene.cacheKey = ChunkOctreeCache::makeKey(voxelDim, chunksDim, 0, builderInfo,
+                                             ChunkOctreeCache::getBuilderShaderFolders(),
+                                             pathToVoxScene);
+  scene.palette = voxData != nullptr ? voxData->paletteData : BlockPalette::makeTerrainPalette();
+  return true;
+}
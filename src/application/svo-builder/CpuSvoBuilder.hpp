@@ -0,0 +1,72 @@
+#pragma once
+
+#include "BlockPalette.hpp"
+
+#include "glm/glm.hpp"
+
+#include <cstdint>
+#include <vector>
+
+struct ConfigContainer;
+struct G_FragmentListEntry;
+class Logger;
+
+// builds the chunk octrees of the scene on the host, for the machines without a gpu, e.g. the
+// build servers of the asset pipeline, the field, the fragment list and the octree of a chunk are
+// made the same way as by the builder shaders, which this has to be kept in sync with, the chunks
+// are spread over a pool of worker threads
+// the octrees are optimized the same way as the ones of SvoBuilder::buildScene, and saved to the
+// chunk octree cache, which is loaded by the next launch, the gpu allocates the node groups of a
+// level in the order its atomics happen to be served, so both octrees are laid out in traversal
+// order before they're compared, see compareWithCache
+class CpuSvoBuilder {
+public:
+  // bumped with every change of the port, which has to follow the builder shaders by hand, the
+  // chunk octree cache is keyed by it, so the octrees of an outdated port are never loaded
+  static uint32_t constexpr kPortVersion = 1;
+
+  CpuSvoBuilder(Logger *logger, ConfigContainer *configContainer);
+  ~CpuSvoBuilder();
+
+  // disable copy and move
+  CpuSvoBuilder(CpuSvoBuilder const &)            = delete;
+  CpuSvoBuilder(CpuSvoBuilder &&)                 = delete;
+  CpuSvoBuilder &operator=(CpuSvoBuilder const &) = delete;
+  CpuSvoBuilder &operator=(CpuSvoBuilder &&)      = delete;
+
+  // returns false if the scene can't be cached, that is, while streaming, or if the cache can't be
+  // written
+  bool buildSceneToCache();
+  // builds the scene the same way, and compares it with the cache that the gpu builder wrote for
+  // the same key, chunk by chunk, returns false if any of them differs, or there's no such cache
+  bool compareWithCache();
+
+  // the octree of the fragments, level by level like the builder shaders, empty without fragments,
+  // the prefabs of SvoBuilder are built with it
+  static std::vector<uint32_t> buildOctree(std::vector<G_FragmentListEntry> const &fragments,
+                                           uint32_t voxelResolution);
+
+private:
+  struct BuiltChunk {
+    glm::ivec3 chunkIndex;
+    uint32_t lod;
+    // empty for the chunks without fragments
+    std::vector<uint32_t> octree;
+  };
+  // the chunks are in x, y, z order, so a chunk is found by its index
+  struct BuiltScene {
+    std::vector<BuiltChunk> chunks{};
+    BlockPalette::Palette palette{};
+    uint64_t cacheKey = 0;
+  };
+
+  Logger *_logger;
+  ConfigContainer *_configContainer;
+
+  uint32_t _chunkLodCount = 0;
+
+  // mirrors SvoBuilder::_decideChunkLod, for the camera chunk the scene is built from
+  [[nodiscard]] uint32_t _decideChunkLod(glm::ivec3 chunkIndex, glm::ivec3 cameraChunk) const;
+  // returns false if the scene can't be cached
+  bool _buildScene(BuiltScene &scene);
+};
@@ -0,0 +1,176 @@
+#include "DynamicObjects.hpp"
+#include "CpuSvoBuilder.hpp"
+#include "OctreeDag.hpp"
+#include "OctreeLayout.hpp"
+#include "SvoBuilder.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include "config-container/ConfigContainer.hpp"
+#include "config-container/sub-config/SvoBuilderInfo.hpp"
+#include "config-container/sub-config/TerrainInfo.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+// an object in one of the chunks it overlaps
+struct GridListing {
+  uint32_t linearIndex;
+  glm::ivec3 chunkIndex;
+  std::array<uint32_t, kOctreeInstanceLength> record;
+};
+
+// the same wrapping as the chunk indices buffer, see SvoBuilder::_getChunksBufferLinearIndex
+uint32_t _getChunksBufferLinearIndex(glm::ivec3 chunkIndex, glm::uvec3 chunksDim) {
+  auto const dim     = glm::ivec3(chunksDim);
+  glm::ivec3 wrapped = chunkIndex % dim;
+  wrapped += dim * glm::ivec3(glm::lessThan(wrapped, glm::ivec3(0)));
+  return static_cast<uint32_t>(wrapped.x + wrapped.y * dim.x + wrapped.z * dim.x * dim.y);
+}
+} // namespace
+
+DynamicObjects::DynamicObjects(Logger *logger, ConfigContainer *configContainer,
+                               SvoBuilder *svoBuilder)
+    : _logger(logger), _configContainer(configContainer), _svoBuilder(svoBuilder) {}
+
+std::optional<uint32_t> DynamicObjects::addShape(std::vector<G_FragmentListEntry> const &fragments,
+                                                 uint32_t voxelResolution) {
+  // the same optimizations as the octrees of the prefabs
+  auto octree = CpuSvoBuilder::buildOctree(fragments, voxelResolution);
+  if (octree.empty()) {
+    return std::nullopt;
+  }
+  if (_configContainer->svoBuilderInfo->deduplicateChunkOctrees) {
+    octree = OctreeDag::deduplicate(octree.data(), octree.size());
+  }
+  if (_configContainer->svoBuilderInfo->reorderChunkOctrees) {
+    octree = OctreeLayout::reorderForTraversal(octree.data(), octree.size(),
+                                               OctreeLayout::kBreadthFirstLevelCount);
+  }
+
+  auto const region = _svoBuilder->uploadObjectOctree(octree);
+  if (!region.has_value()) {
+    _logger->warn("the octree of a dynamic object shape of {} kb doesn't fit into a page",
+                  octree.size() * sizeof(uint32_t) / 1024);
+    return std::nullopt;
+  }
+  float const size = static_cast<float>(voxelResolution) /
+                     static_cast<float>(_configContainer->terrainInfo->chunkVoxelDim);
+  _shapes.push_back({std::move(octree), size, region});
+  return static_cast<uint32_t>(_shapes.size() - 1);
+}
+
+void DynamicObjects::uploadShapes() {
+  for (auto &shape : _shapes) {
+    shape.region = _svoBuilder->uploadObjectOctree(shape.octree);
+  }
+}
+
+entt::entity DynamicObjects::createObject(uint32_t shapeIndex, glm::vec3 position, float scale) {
+  entt::entity const entity = _registry.create();
+  _registry.emplace<DynamicObjectTransform>(entity, position, scale);
+  _registry.emplace<DynamicObjectShape>(entity, shapeIndex);
+  return entity;
+}
+
+void DynamicObjects::destroyObject(entt::entity entity) { _registry.destroy(entity); }
+
+size_t DynamicObjects::getGridLength() const {
+  glm::uvec3 const chunksDim = _svoBuilder->getChunksDim();
+  size_t const chunkCount    = static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z;
+  return 2 * chunkCount + static_cast<size_t>(kOctreeInstanceLength) *
+                              _configContainer->svoBuilderInfo->dynamicObjectGridCapacity;
+}
+
+std::vector<glm::ivec3> DynamicObjects::updateGrid(glm::ivec3 chunkWindowOrigin) {
+  glm::uvec3 const chunksDim = _svoBuilder->getChunksDim();
+  size_t const chunkCount    = static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z;
+
+  // an object is listed by every chunk of the window that its cube overlaps, the chunks clip the
+  // rays to themselves, like they do with the prefab instances
+  std::vector<GridListing> listings{};
+  glm::ivec3 const windowMax = chunkWindowOrigin + glm::ivec3(chunksDim) - 1;
+  auto const view = _registry.view<DynamicObjectTransform const, DynamicObjectShape const>();
+  for (auto const entity : view) {
+    auto const &transform = view.get<DynamicObjectTransform const>(entity);
+    auto const &shape     = view.get<DynamicObjectShape const>(entity);
+    if (shape.shapeIndex >= _shapes.size() || !_shapes[shape.shapeIndex].region.has_value()) {
+      continue;
+    }
+    glm::uvec2 const region = *_shapes[shape.shapeIndex].region;
+    float const size        = _shapes[shape.shapeIndex].size * transform.scale;
+
+    glm::ivec3 const minChunk =
+        glm::max(glm::ivec3(glm::floor(transform.position)), chunkWindowOrigin);
+    glm::ivec3 const maxChunk =
+        glm::min(glm::ivec3(glm::ceil(transform.position + size)) - 1, windowMax);
+    std::array<uint32_t, kOctreeInstanceLength> const record{
+        glm::floatBitsToUint(transform.position.x),
+        glm::floatBitsToUint(transform.position.y),
+        glm::floatBitsToUint(transform.position.z),
+        glm::floatBitsToUint(size),
+        region.x,
+        region.y};
+    for (int32_t z = minChunk.z; z <= maxChunk.z; z++) {
+      for (int32_t y = minChunk.y; y <= maxChunk.y; y++) {
+        for (int32_t x = minChunk.x; x <= maxChunk.x; x++) {
+          glm::ivec3 const chunkIndex{x, y, z};
+          listings.push_back({_getChunksBufferLinearIndex(chunkIndex, chunksDim), chunkIndex,
+                              record});
+        }
+      }
+    }
+  }
+
+  uint32_t const capacity = _configContainer->svoBuilderInfo->dynamicObjectGridCapacity;
+  if (listings.size() > capacity) {
+    if (!_hasGridOverflowed) {
+      _logger->warn("the dynamic objects are listed {} times, the listings over {} are dropped",
+                    listings.size(), capacity);
+    }
+    _hasGridOverflowed = true;
+    listings.resize(capacity);
+  }
+
+  // the records of a chunk are contiguous, in the order of the registry
+  std::stable_sort(listings.begin(), listings.end(),
+                   [](GridListing const &a, GridListing const &b) {
+                     return a.linearIndex < b.linearIndex;
+                   });
+  std::vector<glm::ivec3> gridChunks{};
+  std::vector<uint32_t> records{};
+  records.reserve(listings.size() * kOctreeInstanceLength);
+  for (size_t i = 0; i < listings.size(); i++) {
+    if (i == 0 || listings[i - 1].linearIndex != listings[i].linearIndex) {
+      gridChunks.push_back(listings[i].chunkIndex);
+    }
+    records.insert(records.end(), listings[i].record.begin(), listings[i].record.end());
+  }
+  if (gridChunks == _gridChunks && records == _gridRecords && !_grid.empty()) {
+    return {};
+  }
+
+  // only the entries that the last grid has set are cleared
+  _grid.resize(getGridLength(), 0);
+  for (auto const &chunkIndex : _gridChunks) {
+    uint32_t const linearIndex = _getChunksBufferLinearIndex(chunkIndex, chunksDim);
+    _grid[2 * linearIndex]     = 0;
+    _grid[2 * linearIndex + 1] = 0;
+  }
+  for (size_t i = 0; i < listings.size(); i++) {
+    uint32_t const linearIndex = listings[i].linearIndex;
+    if (_grid[2 * linearIndex + 1] == 0) {
+      _grid[2 * linearIndex] = static_cast<uint32_t>(2 * chunkCount + i * kOctreeInstanceLength);
+    }
+    _grid[2 * linearIndex + 1]++;
+  }
+  std::copy(records.begin(), records.end(),
+            _grid.begin() + static_cast<std::ptrdiff_t>(2 * chunkCount));
+
+  std::vector<glm::ivec3> changedChunks = std::move(_gridChunks);
+  changedChunks.insert(changedChunks.end(), gridChunks.begin(), gridChunks.end());
+  _gridChunks  = std::move(gridChunks);
+  _gridRecords = std::move(records);
+  return changedChunks;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "SvoBuilderDataGpu.hpp"
+
+#include "entt/entity/registry.hpp"
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+struct ConfigContainer;
+
+class Logger;
+class SvoBuilder;
+
+// where a dynamic object is, it's set freely from frame to frame, there's no rotation, the objects
+// are traced like the prefab instances, whose octrees stay axis aligned, a rotated object would
+// need its own rotated octree
+struct DynamicObjectTransform {
+  glm::vec3 position{}; // of the min corner of the cube of the object, in chunks
+  float scale = 1.F;    // of its voxels, relative to the voxels of the chunks
+};
+
+// the shape that a dynamic object is traced with, see DynamicObjects::addShape
+struct DynamicObjectShape {
+  uint32_t shapeIndex = 0;
+};
+
+// the voxel objects that move over the static chunks, each entity of the registry owns a transform
+// and a shape, whose octree is stored once in the octree pages of the builder, the chunks that the
+// objects overlap list them in a top-level grid over the chunk window, which is written anew every
+// frame, and traced like the prefab instance tables, so a move never rebuilds an octree
+class DynamicObjects {
+public:
+  DynamicObjects(Logger *logger, ConfigContainer *configContainer, SvoBuilder *svoBuilder);
+
+  // the octree of the shape is built on the host, and uploaded right away, the leaves index the
+  // palette of the scene, returns nullopt for a shape without fragments, or one that doesn't fit
+  // into a page, the shapes are meant to be added up front, the upload is waited for
+  std::optional<uint32_t> addShape(std::vector<G_FragmentListEntry> const &fragments,
+                                   uint32_t voxelResolution);
+  // the scene rebuilds free every octree region, so the shapes are uploaded again after them
+  void uploadShapes();
+
+  entt::entity createObject(uint32_t shapeIndex, glm::vec3 position, float scale = 1.F);
+  void destroyObject(entt::entity entity);
+  // the transforms are patched through it, the other components are up to the game logic
+  entt::registry &getRegistry() { return _registry; }
+
+  // in words, the entries of every chunk of the window, and the records after them
+  [[nodiscard]] size_t getGridLength() const;
+  // lists the objects in the chunks of the window that they overlap, returns the chunks that the
+  // last grid and this one list if any object has moved, or changed, since the last update, or
+  // nothing otherwise, only the entries that the last grid has set are cleared
+  std::vector<glm::ivec3> updateGrid(glm::ivec3 chunkWindowOrigin);
+  // sized for the chunk window, see getGridLength
+  [[nodiscard]] std::vector<uint32_t> const &getGrid() const { return _grid; }
+  // the chunks that list any object, as of the last update
+  [[nodiscard]] std::vector<glm::ivec3> const &getGridChunks() const { return _gridChunks; }
+
+private:
+  struct Shape {
+    std::vector<uint32_t> octree;
+    // of the edge of the cube of the octree, in chunks, at a scale of 1
+    float size = 0.F;
+    // the page and the offset in words, nullopt once it doesn't fit anymore
+    std::optional<glm::uvec2> region;
+  };
+
+  Logger *_logger;
+  ConfigContainer *_configContainer;
+  SvoBuilder *_svoBuilder;
+
+  entt::registry _registry;
+  std::vector<Shape> _shapes;
+
+  std::vector<uint32_t> _grid;
+  std::vector<glm::ivec3> _gridChunks;
+  // the records of the grid, in the order of its chunks
+  std::vector<uint32_t> _gridRecords;
+  bool _hasGridOverflowed = false;
+};
@@ -0,0 +1,80 @@
+#include "OctreeDag.hpp"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+
+namespace {
+using NodeGroup = std::array<uint32_t, OctreeDag::kNodeGroupLength>;
+
+// fnv-1a over the nodes, the child pointers are already remapped, so equal groups are equal
+// subtrees
+struct NodeGroupHash {
+  size_t operator()(NodeGroup const &nodeGroup) const {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t const node : nodeGroup) {
+      hash ^= node;
+      hash *= 1099511628211ULL;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+struct DeduplicationContext {
+  uint32_t const *octree;
+  size_t octreeLength;
+  std::vector<uint32_t> dag;
+  std::unordered_map<NodeGroup, uint32_t, NodeGroupHash> groupOffsets;
+};
+
+uint32_t _internNodeGroup(DeduplicationContext &context, NodeGroup const &nodeGroup) {
+  auto const [it, isInserted] =
+      context.groupOffsets.try_emplace(nodeGroup, static_cast<uint32_t>(context.dag.size()));
+  if (isInserted) {
+    context.dag.insert(context.dag.end(), nodeGroup.begin(), nodeGroup.end());
+  }
+  return it->second;
+}
+
+// the children are merged first, so a group is looked up once its subtrees are final, returns
+// false if a pointer leaves the octree, or doesn't point past its parent
+bool _deduplicateNodeGroup(DeduplicationContext &context, uint32_t groupOffset,
+                           NodeGroup &oNodeGroup) {
+  for (uint32_t i = 0; i < OctreeDag::kNodeGroupLength; i++) {
+    uint32_t node = context.octree[groupOffset + i];
+    if ((node & OctreeDag::kHasChildBit) != 0 && (node & OctreeDag::kIsLeafBit) == 0) {
+      uint32_t const childOffset = node & OctreeDag::kChildPointerMask;
+      if (childOffset <= groupOffset ||
+          childOffset + OctreeDag::kNodeGroupLength > context.octreeLength) {
+        return false;
+      }
+
+      NodeGroup childGroup{};
+      if (!_deduplicateNodeGroup(context, childOffset, childGroup)) {
+        return false;
+      }
+      node = (node & ~OctreeDag::kChildPointerMask) | _internNodeGroup(context, childGroup);
+    }
+    oNodeGroup[i] = node;
+  }
+  return true;
+}
+} // namespace
+
+std::vector<uint32_t> OctreeDag::deduplicate(uint32_t const *octree, size_t octreeLength) {
+  if (octreeLength < kNodeGroupLength) {
+    return {octree, octree + octreeLength};
+  }
+
+  DeduplicationContext context{octree, octreeLength, {}, {}};
+  context.dag.reserve(octreeLength);
+  // the root group is never shared, it's written to its place once its children are done
+  context.dag.resize(kNodeGroupLength);
+
+  NodeGroup rootGroup{};
+  if (!_deduplicateNodeGroup(context, 0, rootGroup)) {
+    return {octree, octree + octreeLength};
+  }
+  std::copy(rootGroup.begin(), rootGroup.end(), context.dag.begin());
+  return context.dag;
+}
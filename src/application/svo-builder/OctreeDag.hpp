@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// merges the identical subtrees of a chunk octree into a directed acyclic graph, the child
+// pointers of svoMarching.glsl can point to any node group of the chunk, so the tracer traverses
+// the result without knowing about the sharing
+namespace OctreeDag {
+// the node format of the octree builder, a node with a child holds the offset of its group of 8
+// children, relative to the chunk octree, a leaf holds its properties instead
+uint32_t constexpr kHasChildBit      = 0x80000000U;
+uint32_t constexpr kIsLeafBit        = 0x40000000U;
+uint32_t constexpr kChildPointerMask = 0x3FFFFFFFU;
+uint32_t constexpr kNodeGroupLength  = 8;
+
+// the root group stays at the front, the octree is returned as it is if it's malformed, the
+// result is never longer than the octree, in uint32
+std::vector<uint32_t> deduplicate(uint32_t const *octree, size_t octreeLength);
+}; // namespace OctreeDag
@@ -0,0 +1,112 @@
+#include "OctreeLayout.hpp"
+
+#include "OctreeDag.hpp"
+
+#include <unordered_map>
+#include <utility>
+
+namespace {
+bool _hasChildGroup(uint32_t node) {
+  return (node & OctreeDag::kHasChildBit) != 0 && (node & OctreeDag::kIsLeafBit) == 0;
+}
+
+bool _isValidChildGroup(uint32_t childOffset, size_t octreeLength) {
+  return childOffset + OctreeDag::kNodeGroupLength <= octreeLength;
+}
+} // namespace
+
+std::vector<uint32_t> OctreeLayout::reorderForTraversal(uint32_t const *octree,
+                                                        size_t octreeLength,
+                                                        uint32_t breadthFirstLevelCount) {
+  if (octreeLength < OctreeDag::kNodeGroupLength) {
+    return {octree, octree + octreeLength};
+  }
+
+  // the old offsets of the groups in their new order, a group reached twice is a shared one
+  std::vector<uint32_t> groupOrder{};
+  std::unordered_map<uint32_t, uint32_t> newGroupOffsets{};
+  auto const placeGroup = [&](uint32_t groupOffset) {
+    auto const [it, isInserted] = newGroupOffsets.try_emplace(
+        groupOffset, static_cast<uint32_t>(groupOrder.size() * OctreeDag::kNodeGroupLength));
+    if (isInserted) {
+      groupOrder.push_back(groupOffset);
+    }
+    return isInserted;
+  };
+
+  std::vector<uint32_t> levelGroups{0};
+  placeGroup(0);
+  for (uint32_t level = 1; level < breadthFirstLevelCount && !levelGroups.empty(); level++) {
+    std::vector<uint32_t> nextLevelGroups{};
+    for (uint32_t const groupOffset : levelGroups) {
+      for (uint32_t i = 0; i < OctreeDag::kNodeGroupLength; i++) {
+        uint32_t const node = octree[groupOffset + i];
+        if (!_hasChildGroup(node)) {
+          continue;
+        }
+        uint32_t const childOffset = node & OctreeDag::kChildPointerMask;
+        if (!_isValidChildGroup(childOffset, octreeLength)) {
+          return {octree, octree + octreeLength};
+        }
+        if (placeGroup(childOffset)) {
+          nextLevelGroups.push_back(childOffset);
+        }
+      }
+    }
+    levelGroups = std::move(nextLevelGroups);
+  }
+
+  // the children of the last breadth first level root the depth first subtrees, the stack is
+  // filled in reverse, so the first child is placed first
+  for (uint32_t const groupOffset : levelGroups) {
+    std::vector<uint32_t> groupStack{};
+    auto const pushChildGroups = [&](uint32_t parentOffset) {
+      for (uint32_t i = OctreeDag::kNodeGroupLength; i-- > 0;) {
+        uint32_t const node = octree[parentOffset + i];
+        if (_hasChildGroup(node)) {
+          groupStack.push_back(node & OctreeDag::kChildPointerMask);
+        }
+      }
+    };
+
+    pushChildGroups(groupOffset);
+    while (!groupStack.empty()) {
+      uint32_t const childOffset = groupStack.back();
+      groupStack.pop_back();
+      if (!_isValidChildGroup(childOffset, octreeLength)) {
+        return {octree, octree + octreeLength};
+      }
+      if (placeGroup(childOffset)) {
+        pushChildGroups(childOffset);
+      }
+    }
+  }
+
+  std::vector<uint32_t> reordered(groupOrder.size() * OctreeDag::kNodeGroupLength);
+  for (size_t i = 0; i < groupOrder.size(); i++) {
+    for (uint32_t j = 0; j < OctreeDag::kNodeGroupLength; j++) {
+      uint32_t node = octree[groupOrder[i] + j];
+      if (_hasChildGroup(node)) {
+        node = (node & ~OctreeDag::kChildPointerMask) |
+               newGroupOffsets[node & OctreeDag::kChildPointerMask];
+      }
+      reordered[i * OctreeDag::kNodeGroupLength + j] = node;
+    }
+  }
+  return reordered;
+}
+
+double OctreeLayout::getMeanChildDistance(uint32_t const *octree, size_t octreeLength) {
+  double distanceSum  = 0.0;
+  size_t pointerCount = 0;
+  for (size_t i = 0; i < octreeLength; i++) {
+    if (!_hasChildGroup(octree[i])) {
+      continue;
+    }
+    auto const childOffset = static_cast<double>(octree[i] & OctreeDag::kChildPointerMask);
+    distanceSum += childOffset > static_cast<double>(i) ? childOffset - static_cast<double>(i)
+                                                        : static_cast<double>(i) - childOffset;
+    pointerCount++;
+  }
+  return pointerCount == 0 ? 0.0 : distanceSum / static_cast<double>(pointerCount);
+}
@@ -1,448 +1,3430 @@
 #include "SvoBuilder.hpp"
 
+#include "BlockPalette.hpp"
+#include "ChunkBuildProfiler.hpp"
+#include "ChunkOctreeCache.hpp"
+#include "CpuSvoBuilder.hpp"
+#include "DynamicObjects.hpp"
+#include "OctreeDag.hpp"
+#include "OctreeLayout.hpp"
 #include "SvoBuilderDataGpu.hpp"
+#include "VoxData.hpp"
+#include "VoxLoader.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
+#include "application/BlockState.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "utils/config/RootDir.h"
+#include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
+#include "utils/event-types/EventType.hpp"
 #include "utils/io/ShaderFileReader.hpp"
 #include "utils/logger/Logger.hpp"
 #include "vulkan-wrapper/descriptor-set/DescriptorSetBundle.hpp"
 #include "vulkan-wrapper/memory/Buffer.hpp"
+#include "vulkan-wrapper/memory/BufferBundle.hpp"
 #include "vulkan-wrapper/memory/Image.hpp"
 #include "vulkan-wrapper/pipeline/ComputePipeline.hpp"
+#include "vulkan-wrapper/sampler/Sampler.hpp"
 #include "vulkan-wrapper/utils/SimpleCommands.hpp"
 
 #include "config-container/ConfigContainer.hpp"
+#include "config-container/sub-config/ApplicationInfo.hpp"
 #include "config-container/sub-config/BrushInfo.hpp"
+#include "config-container/sub-config/SvoBuilderInfo.hpp"
+#include "config-container/sub-config/SvoTracerInfo.hpp"
 #include "config-container/sub-config/TerrainInfo.hpp"
+#include "custom-mem-alloc/AllocationTrace.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <cmath>
+#include <iterator>
+#include <limits>
+#include <string>
 
 namespace {
 
+// the copy shaders work with a grid stride, so a fixed thread count is enough for any length
+uint32_t constexpr kGridStrideCopyThreadCount = 64 * 1024;
+
+// the octrees of the loaded chunks that are uploaded per frame, half of the staging ring
+size_t constexpr kWorldChunkUploadBudget = 8 * 1024 * 1024;
+
+// the camera velocity follows the one of the last frame by this much per frame
+float constexpr kCameraVelocitySmoothing = 0.1F;
+// in chunks per second, the chunks are closed in on at least this fast, so a still camera orders
+// them by their distance
+float constexpr kMinClosingSpeed = 0.25F;
+// the time to turn to a chunk right behind the view, the ones to the side take half of it
+float constexpr kTurnAroundTimeSec = 1.F;
+
+// mirrors makeChunkIndicesEntry of chunking.glsl, the empty chunks are zero
+using ChunkIndicesEntry = glm::uvec2;
+ChunkIndicesEntry _makeChunkIndicesEntry(uint32_t octreePage, uint32_t lod,
+                                         size_t octreeBufferOffset) {
+  return {static_cast<uint32_t>(octreeBufferOffset + 1), (octreePage << kChunkLodBitCount) | lod};
+}
+
 std::string _makeShaderFullPath(std::string const &shaderName) {
   return kPathToResourceFolder + "shaders/svo-builder/" + shaderName;
 }
 
+template <typename T>
+void _recordBufferUpdate(VkCommandBuffer commandBuffer, Buffer *buffer, T const &data) {
+  vkCmdUpdateBuffer(commandBuffer, buffer->getVkBuffer(), 0, sizeof(T), &data);
+}
+
+void _recordShaderAccessBarrier(VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier shaderAccessBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  shaderAccessBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+  shaderAccessBarrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0, nullptr,
+                       0, nullptr);
+}
+
+void _recordTransferToShaderBarrier(VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier transferBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  transferBarrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+  transferBarrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                  VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                       0, 1, &transferBarrier, 0, nullptr, 0, nullptr);
+}
+
+void _waitForTimelineValue(VkDevice device, VkSemaphore timelineSemaphore, uint64_t value) {
+  VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores    = &timelineSemaphore;
+  waitInfo.pValues        = &value;
+  vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+}
+
+// the builder submits to the compute queue, or to the transfer queue for the plain copies, after
+// the pending uploads of the staging ring, which waits on the signal before its next batches, only
+// the chunk builds of a device group leave the first device, they wait on the ring semaphore of
+// their own device, since every device copies the uploads into its own memory
+void _submitWithTimelineSignal(VulkanApplicationContext *appContext,
+                               std::vector<VkCommandBuffer> const &commandBuffers,
+                               VkSemaphore timelineSemaphore, uint64_t signalValue,
+                               VkQueue queue       = VK_NULL_HANDLE,
+                               uint32_t deviceMask = DeviceGroupSubmit::kPrimaryDeviceMask) {
+  if (queue == VK_NULL_HANDLE) {
+    queue = appContext->getComputeQueue();
+  }
+  uint32_t deviceIndex = 0;
+  while ((deviceMask & (1U << deviceIndex)) == 0) {
+    deviceIndex++;
+  }
+  auto *stagingRing                      = appContext->getStagingRing();
+  VkSemaphore const stagingRingSemaphore = stagingRing->getTimelineSemaphore(deviceIndex);
+  uint64_t const stagingRingValue        = stagingRing->submit();
+  VkPipelineStageFlags const waitStage   = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+  VkTimelineSemaphoreSubmitInfo timelineInfo{VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO};
+  timelineInfo.waitSemaphoreValueCount   = 1;
+  timelineInfo.pWaitSemaphoreValues      = &stagingRingValue;
+  timelineInfo.signalSemaphoreValueCount = 1;
+  timelineInfo.pSignalSemaphoreValues    = &signalValue;
+
+  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
+  submitInfo.pNext                = &timelineInfo;
+  submitInfo.waitSemaphoreCount   = 1;
+  submitInfo.pWaitSemaphores      = &stagingRingSemaphore;
+  submitInfo.pWaitDstStageMask    = &waitStage;
+  submitInfo.commandBufferCount   = static_cast<uint32_t>(commandBuffers.size());
+  submitInfo.pCommandBuffers      = commandBuffers.data();
+  submitInfo.signalSemaphoreCount = 1;
+  submitInfo.pSignalSemaphores    = &timelineSemaphore;
+  DeviceGroupSubmit const deviceGroupSubmit(submitInfo, appContext->getDeviceCount(), deviceMask);
+  vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
+  stagingRing->setConsumerTimelineValue(timelineSemaphore, signalValue, deviceIndex);
+}
+
+// the half size of the box around the position that an edit can change
+glm::vec3 _getEditingReach(G_ChunkEditingInfo const &edit) {
+  glm::vec3 reach{edit.radius};
+  if (edit.shape == kChunkEditingShapeBox) {
+    reach += edit.halfExtent;
+  } else if (edit.shape == kChunkEditingShapeCylinder) {
+    reach += glm::vec3{edit.halfExtent.x, edit.halfExtent.y, edit.halfExtent.x};
+  }
+  if (edit.operation == kChunkEditingOperationSmoothUnion) {
+    reach += glm::vec3{edit.smoothness};
+  }
+  return reach;
+}
+
 } // namespace
 
 SvoBuilder::SvoBuilder(VulkanApplicationContext *appContext, Logger *logger,
                        ShaderCompiler *shaderCompiler, ShaderChangeListener *shaderChangeListener,
                        ConfigContainer *configContainer)
     : _appContext(appContext), _logger(logger), _shaderCompiler(shaderCompiler),
-      _shaderChangeListener(shaderChangeListener), _configContainer(configContainer) {}
+      _shaderChangeListener(shaderChangeListener), _configContainer(configContainer) {
+  _dynamicObjects = std::make_unique<DynamicObjects>(logger, configContainer, this);
+}
 
 SvoBuilder::~SvoBuilder() {
-  vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getCommandPool(), 1,
-                       &_octreeCreationCommandBuffer);
+  // the loads hold the builder, the writes only the store
+  saveWorld();
+  TaskScheduler::get().wait(_worldLoadTasks);
+  _waitForAllChunkBuildSlots();
+  _destroyPeerBufferAliases();
+  _destroyChunkBuildSlots();
+  _writeAllocationTraces();
+}
+
+bool SvoBuilder::_isTracingAllocations() const {
+  return !_configContainer->svoBuilderInfo->allocationTraceFile.empty();
+}
+
+void SvoBuilder::_writeAllocationTraces() const {
+  if (!_isTracingAllocations()) {
+    return;
+  }
+  std::string const pathStem =
+      kPathToResourceFolder + "profiles/" + _configContainer->svoBuilderInfo->allocationTraceFile;
+
+  std::vector<std::pair<std::string, CustomMemoryAllocator const *>> allocators = {
+      {"fragment_lists", _fragmentListMemoryAllocator.get()},
+      {"field_bricks", _fieldBrickPoolMemoryAllocator.get()}};
+  for (size_t page = 0; page < _octreePageAllocators.size(); page++) {
+    allocators.emplace_back("octree_page_" + std::to_string(page),
+                            _octreePageAllocators[page].get());
+  }
+
+  for (auto const &[poolName, allocator] : allocators) {
+    std::string const pathToFile = pathStem + "_" + poolName + ".trace";
+    if (allocator->getTrace()->writeToFile(pathToFile)) {
+      _logger->info("allocation trace of {} ops written to {}",
+                    allocator->getTrace()->getOps().size(), pathToFile);
+    } else {
+      _logger->error("failed to write the allocation trace {}", pathToFile);
+    }
+  }
 }
 
 glm::uvec3 SvoBuilder::getChunksDim() const { return _configContainer->terrainInfo->chunksDim; }
 
+bool SvoBuilder::_isStreamingChunks() const { return _configContainer->terrainInfo->streamChunks; }
+
+bool SvoBuilder::_isChunkWindowSettled() const {
+  return _visibleChunkWindowOrigin == _chunkWindowOrigin && _chunkWindowSettleFramesLeft == 0;
+}
+
+uint32_t SvoBuilder::_getChunksBufferLinearIndex(ChunkIndex const &chunkIndex) const {
+  auto const dim = glm::ivec3(getChunksDim());
+  // the remainder keeps the sign of the chunk index
+  glm::ivec3 wrapped = glm::ivec3{chunkIndex.x, chunkIndex.y, chunkIndex.z} % dim;
+  wrapped += dim * glm::ivec3(glm::lessThan(wrapped, glm::ivec3(0)));
+  return static_cast<uint32_t>(wrapped.x + wrapped.y * dim.x + wrapped.z * dim.x * dim.y);
+}
+
+bool SvoBuilder::_isInChunkWindow(ChunkIndex const &chunkIndex, glm::ivec3 windowOrigin) const {
+  glm::ivec3 const pos{chunkIndex.x, chunkIndex.y, chunkIndex.z};
+  return glm::all(glm::greaterThanEqual(pos, windowOrigin)) &&
+         glm::all(glm::lessThan(pos, windowOrigin + glm::ivec3(getChunksDim())));
+}
+
+std::vector<SvoBuilder::ChunkIndex> SvoBuilder::_getChunkWindow(glm::ivec3 windowOrigin) const {
+  auto const chunksDim = glm::ivec3(getChunksDim());
+  std::vector<ChunkIndex> chunkIndices{};
+  chunkIndices.reserve(chunksDim.x * chunksDim.y * chunksDim.z);
+  for (int32_t z = windowOrigin.z; z < windowOrigin.z + chunksDim.z; z++) {
+    for (int32_t y = windowOrigin.y; y < windowOrigin.y + chunksDim.y; y++) {
+      for (int32_t x = windowOrigin.x; x < windowOrigin.x + chunksDim.x; x++) {
+        chunkIndices.push_back({x, y, z});
+      }
+    }
+  }
+  return chunkIndices;
+}
+
 void SvoBuilder::init() {
   _voxelLevelCount = static_cast<uint32_t>(std::log2(_configContainer->terrainInfo->chunkVoxelDim));
+  _chunkBuildSlotCount = std::max(1U, _configContainer->svoBuilderInfo->chunkBuildSlotCount);
+
+  static_assert(std::tuple_size_v<decltype(SvoBuilderInfo::chunkLodDistances)> + 1 ==
+                    kMaxChunkLodCount,
+                "a distance is needed for every level of detail after the first one");
+  // the coarsest level still fills a work group of the voxel creation
+  _chunkLodCount = std::clamp(_voxelLevelCount, 3U, kMaxChunkLodCount + 2) - 2;
+
+  // the camera starts in the centre of the terrain
+  auto const &chunksDim = getChunksDim();
+  _cameraChunk          = glm::ivec3(chunksDim.x / 2, 0, chunksDim.z / 2);
+  _lodCameraChunk       = _cameraChunk;
+
+  if (_isStreamingChunks() && !_configContainer->svoBuilderInfo->voxSceneFile.empty()) {
+    _logger->warn("the vox scene is ignored, as the chunks are streamed");
+  }
+
+  // a starting guess for the octree reservations, it only grows from the observed lengths
+  uint32_t const chunkVoxelDim = _configContainer->terrainInfo->chunkVoxelDim;
+  _octreeLengthEstimate        = chunkVoxelDim * chunkVoxelDim * chunkVoxelDim / 64;
+  // the terrain is mostly a height field, so the fragments are roughly a layer of the chunk
+  _fragmentCountEstimate = 2 * chunkVoxelDim * chunkVoxelDim;
+  // the fragment lists start at a few of those layers instead of a fragment per voxel, the builds
+  // that overflow them grow them
+  _fragmentListCapacity = static_cast<uint32_t>(
+      std::min(static_cast<size_t>(chunkVoxelDim) * chunkVoxelDim * chunkVoxelDim,
+               static_cast<size_t>(4) * chunkVoxelDim * chunkVoxelDim));
+
+  size_t constexpr kMb               = 1024 * 1024;
+  size_t savedFragmentListBufferSize = 256 * kMb;
+
+  // a page is bound as a whole, the offsets in it always fit into the chunk indices entries then
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_appContext->getPhysicalDevice(), &properties);
+  _octreePageSize = static_cast<size_t>(_configContainer->svoBuilderInfo->octreePageSizeMb) * kMb;
+  if (_octreePageSize == 0 || _octreePageSize > properties.limits.maxStorageBufferRange) {
+    _logger->error("octree page size {} mb is out of range",
+                   _configContainer->svoBuilderInfo->octreePageSizeMb);
+    exit(0);
+  }
+  // the texel buffer views of the tracer cover the whole page as well
+  if (_configContainer->svoTracerInfo->octreeTexelBuffer &&
+      _octreePageSize / sizeof(uint32_t) > properties.limits.maxTexelBufferElements) {
+    _logger->error("octree page size {} mb exceeds the texel buffer element limit {}",
+                   _configContainer->svoBuilderInfo->octreePageSizeMb,
+                   properties.limits.maxTexelBufferElements);
+    exit(0);
+  }
 
-  size_t constexpr kMb    = 1024 * 1024;
-  size_t constexpr kGb    = 1024 * kMb;
-  size_t octreeBufferSize = 2 * kGb;
+  // every chunk build allocates, shrinks and frees, the tlsf strategy keeps those constant time
+  // however fragmented the pools get
+  _fragmentListMemoryAllocator = std::make_unique<CustomMemoryAllocator>(
+      _logger, savedFragmentListBufferSize, AllocationStrategy::kTlsf);
+  if (_isTracingAllocations()) {
+    _fragmentListMemoryAllocator->startTrace();
+  }
 
-  _chunkBufferMemoryAllocator = std::make_unique<CustomMemoryAllocator>(_logger, octreeBufferSize);
+  // the bricks are addressed in uint32 by the shaders
+  size_t const fieldBrickPoolBufferSize =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->fieldBrickPoolSizeMb) * kMb;
+  size_t const fullFieldSize =
+      static_cast<size_t>(_getFieldBrickTableLength()) * (kFieldBrickLength + 1) * sizeof(uint32_t);
+  if (fieldBrickPoolBufferSize < fullFieldSize ||
+      fieldBrickPoolBufferSize / sizeof(uint32_t) > UINT32_MAX) {
+    _logger->error("field brick pool size {} mb is out of range",
+                   _configContainer->svoBuilderInfo->fieldBrickPoolSizeMb);
+    exit(0);
+  }
+  // the fields of the builds in flight and the journaled ones are on top of the resident ones
+  size_t const fieldBrickResidentBudget =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->fieldBrickResidentBudgetMb) * kMb;
+  size_t const editJournalBudget =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->editJournalBudgetMb) * kMb;
+  if (fieldBrickResidentBudget + editJournalBudget + _chunkBuildSlotCount * fullFieldSize >
+      fieldBrickPoolBufferSize) {
+    _logger->warn("the field brick budgets ({} + {} mb) leave no room for the edits in flight",
+                  _configContainer->svoBuilderInfo->fieldBrickResidentBudgetMb,
+                  _configContainer->svoBuilderInfo->editJournalBudgetMb);
+  }
+  _fieldBrickPoolMemoryAllocator = std::make_unique<CustomMemoryAllocator>(
+      _logger, fieldBrickPoolBufferSize, AllocationStrategy::kTlsf);
+  if (_isTracingAllocations()) {
+    _fieldBrickPoolMemoryAllocator->startTrace();
+  }
 
   // images
   _createImages();
 
-  // buffers
-  _createBuffers(octreeBufferSize);
-  _initBufferData();
+  // buffers
+  _createBuffers(savedFragmentListBufferSize, fieldBrickPoolBufferSize);
+  _initBufferData();
+
+  // pipelines
+  _createDescriptorSetBundle();
+  _createPipelines();
+  _bakeNoiseVolume();
+
+  _chunkBuildProfiler = std::make_unique<ChunkBuildProfiler>(
+      _appContext, _logger, _chunkBuildSlotCount, _voxelLevelCount);
+
+  _createChunkBuildSlots();
+  _createWorldRegionStore();
+  _recordCommandBuffers();
+}
+
+void SvoBuilder::onPipelineRebuilt() {
+  // the in flight edits are dropped along with the whole scene
+  _waitForAllChunkBuildSlots();
+
+  // the saved edits are written first, with the key of the shaders that built their octrees, the
+  // stale octrees are left out of the loads then
+  if (_worldRegionStore != nullptr) {
+    saveWorld();
+    TaskScheduler::get().wait(_worldLoadTasks);
+    _worldLoadTasks.clear();
+    _loadedWorldChunks.clear();
+    _pendingWorldChunks.clear();
+    _worldRegionStore->setBuilderKey(_makeWorldBuilderKey());
+  }
+  _pendingChunkEdits.clear();
+  _retiredAllocations.clear();
+  _inFlightOctreeMoves.clear();
+  _octreeBufferMayHaveHoles = false;
+
+  // the current window is built again as a whole
+  _pendingChunkBuilds.clear();
+  _chunkIndexToLod.clear();
+  _chunkWindowLeavingAllocations.clear();
+  _visibleChunkWindowOrigin    = _chunkWindowOrigin;
+  _chunkWindowSettleFramesLeft = 0;
+
+  _recordCommandBuffers();
+
+  // the pages are kept, the scene is likely to need them again
+  for (auto &allocator : _octreePageAllocators) {
+    allocator->freeAll();
+  }
+  _chunkIndexToBufferAllocResult.clear();
+  _instancedChunks.clear();
+  _fragmentListMemoryAllocator->freeAll();
+  _chunkIndexToFragmentListAllocResult.clear();
+  _fieldBrickPoolMemoryAllocator->freeAll();
+  _chunkIndexToSavedField.clear();
+  _chunkIndexToEvictedField.clear();
+  _pendingFieldEvictions.clear();
+  // the journaled fields are gone with the pool, and so are the edits they belong to
+  _undoJournal.clear();
+  _redoJournal.clear();
+  _requestedJournalSteps = 0;
+  _pendingChunkRestores.clear();
+
+  _initBufferData();
+
+  // the bake shader may have changed along with the others
+  _bakeNoiseVolume();
+
+  buildScene();
+  // their regions are gone along with the rest of the scene
+  _dynamicObjects->uploadShapes();
+}
+
+void SvoBuilder::_createChunkBuildSlots() {
+  // all chunk builds run on the compute queue, so they don't stall the rendering, the command
+  // buffers of the slots are re-recorded for every chunk
+  VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+  poolInfo.flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  poolInfo.queueFamilyIndex = _appContext->getComputeQueueIndex();
+  vkCreateCommandPool(_appContext->getDevice(), &poolInfo, nullptr, &_buildCommandPool);
+
+  VkSemaphoreTypeCreateInfo semaphoreTypeInfo{VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO};
+  semaphoreTypeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  semaphoreTypeInfo.initialValue  = 0;
+  VkSemaphoreCreateInfo semaphoreInfo{VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+  semaphoreInfo.pNext = &semaphoreTypeInfo;
+  vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr, &_chunkSwapSemaphore);
+
+  _chunkBuildSlots.resize(_chunkBuildSlotCount);
+  for (auto &slot : _chunkBuildSlots) {
+    VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocInfo.commandPool        = _buildCommandPool;
+    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &slot.voxelizationCommandBuffer);
+    vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &slot.mergeCommandBuffer);
+  }
+
+  // the first device signals the chunk swap semaphore
+  uint32_t const buildDeviceCount =
+      _appContext->isPeerMemoryCopySupported() ? _appContext->getDeviceCount() : 1;
+  _peerBuildSemaphores.assign(buildDeviceCount, VK_NULL_HANDLE);
+  _peerBuildValues.assign(buildDeviceCount, 0);
+  for (uint32_t deviceIndex = 1; deviceIndex < buildDeviceCount; deviceIndex++) {
+    vkCreateSemaphore(_appContext->getDevice(), &semaphoreInfo, nullptr,
+                      &_peerBuildSemaphores[deviceIndex]);
+  }
+
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = _buildCommandPool;
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = 1;
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &_compactionCommandBuffer);
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &_chunkWindowShiftCommandBuffer);
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &_fieldBatchCommandBuffer);
+}
+
+void SvoBuilder::_destroyChunkBuildSlots() {
+  _chunkBuildSlots.clear();
+  vkDestroySemaphore(_appContext->getDevice(), _chunkSwapSemaphore, nullptr);
+  _chunkSwapSemaphore = VK_NULL_HANDLE;
+  for (auto &peerBuildSemaphore : _peerBuildSemaphores) {
+    vkDestroySemaphore(_appContext->getDevice(), peerBuildSemaphore, nullptr);
+  }
+  _peerBuildSemaphores.clear();
+
+  for (auto &commandBuffer : _octreeCreationCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _buildCommandPool, 1, &commandBuffer);
+  }
+  _octreeCreationCommandBuffers.clear();
+
+  // slot, merge, compaction, window shift and field batch command buffers are freed along with the
+  // pool
+  vkDestroyCommandPool(_appContext->getDevice(), _buildCommandPool, nullptr);
+  _buildCommandPool              = VK_NULL_HANDLE;
+  _compactionCommandBuffer       = VK_NULL_HANDLE;
+  _chunkWindowShiftCommandBuffer = VK_NULL_HANDLE;
+  _fieldBatchCommandBuffer       = VK_NULL_HANDLE;
+}
+
+// recorded at the beginning of every chunk generation, replaces the blocking buffer fills
+void SvoBuilder::_recordBufferDataResetForNewChunkGeneration(VkCommandBuffer commandBuffer,
+                                                             uint32_t slotIndex,
+                                                             ChunkIndex chunkIndex) {
+  uint32_t atomicCounterInitData = 1;
+  _recordBufferUpdate(commandBuffer, _counterBufferBundle->getBuffer(slotIndex),
+                      atomicCounterInitData);
+
+  G_OctreeBuildInfo buildInfo{};
+  buildInfo.allocBegin = 0;
+  buildInfo.allocNum   = 8;
+  _recordBufferUpdate(commandBuffer, _octreeBuildInfoBufferBundle->getBuffer(slotIndex), buildInfo);
+
+  G_IndirectDispatchInfo indirectDispatchInfo{};
+  indirectDispatchInfo.dispatchX = 1;
+  indirectDispatchInfo.dispatchY = 1;
+  indirectDispatchInfo.dispatchZ = 1;
+  _recordBufferUpdate(commandBuffer, _indirectAllocNumBufferBundle->getBuffer(slotIndex),
+                      indirectDispatchInfo);
+  _recordBufferUpdate(commandBuffer, _indirectFragLengthBufferBundle->getBuffer(slotIndex),
+                      indirectDispatchInfo);
+
+  auto const &slot = _chunkBuildSlots[slotIndex];
+
+  G_FragmentListInfo fragmentListInfo{};
+  fragmentListInfo.voxelResolution      = _configContainer->terrainInfo->chunkVoxelDim >> slot.lod;
+  fragmentListInfo.voxelFragmentCount   = slot.importedFragmentCount;
+  fragmentListInfo.fragmentListCapacity = _fragmentListCapacity;
+  fragmentListInfo.regionOffset         = slot.regionOffset;
+  fragmentListInfo.regionExtent         = slot.regionExtent;
+  // empty until the fragments are created, see chunkIndicesBufferUpdater.comp
+  std::fill(std::begin(fragmentListInfo.fragmentBoundsMin),
+            std::end(fragmentListInfo.fragmentBoundsMin), std::numeric_limits<uint32_t>::max());
+  _recordBufferUpdate(commandBuffer, _fragmentListInfoBufferBundle->getBuffer(slotIndex),
+                      fragmentListInfo);
+
+  G_ChunksInfo chunksInfo{};
+  chunksInfo.chunksDim             = getChunksDim();
+  chunksInfo.currentlyWritingChunk = {chunkIndex.x, chunkIndex.y, chunkIndex.z};
+  chunksInfo.islandFalloff         = _isStreamingChunks() ? 0U : 1U;
+  chunksInfo.lod                   = slot.lod;
+  _recordBufferUpdate(commandBuffer, _chunksInfoBufferBundle->getBuffer(slotIndex), chunksInfo);
+
+  // the first 8 are not calculated, so pre-allocate them
+  uint32_t octreeBufferSize = 8;
+  _recordBufferUpdate(commandBuffer, _octreeBufferLengthBufferBundle->getBuffer(slotIndex),
+                      octreeBufferSize);
+
+  if (slot.isEditing) {
+    _recordBufferUpdate(commandBuffer, _chunkEditingBatchBufferBundle->getBuffer(slotIndex),
+                        slot.editingBatch);
+    _recordBufferUpdate(commandBuffer, _fragmentListSaveInfoBufferBundle->getBuffer(slotIndex),
+                        slot.fragmentListSaveInfo);
+  }
+  // the saved field is loaded by the rebuilds of an edited chunk as well
+  _recordBufferUpdate(commandBuffer, _fieldBrickSaveInfoBufferBundle->getBuffer(slotIndex),
+                      slot.fieldBrickSaveInfo);
+
+  // the region of the octree buffer pages that is reserved for this build
+  auto const &reservation = slot.reservation;
+  G_OctreeReservationInfo reservationInfo{};
+  reservationInfo.octreePage         = reservation.page;
+  reservationInfo.octreeBufferOffset = reservation.region.offset() / sizeof(uint32_t);
+  reservationInfo.reservedLength     = reservation.region.size() / sizeof(uint32_t);
+  _recordBufferUpdate(commandBuffer, _octreeReservationInfoBufferBundle->getBuffer(slotIndex),
+                      reservationInfo);
+
+  _recordTransferToShaderBarrier(commandBuffer);
+}
+
+void SvoBuilder::buildScene() {
+  auto const &chunksDim = getChunksDim();
+
+  // an imported scene is bounded, and the cache only holds the window at the origin, so neither is
+  // used while streaming
+  auto const &voxSceneFile = _configContainer->svoBuilderInfo->voxSceneFile;
+  std::string const pathToVoxScene = voxSceneFile.empty() || _isStreamingChunks()
+                                         ? ""
+                                         : kPathToResourceFolder + "models/vox/" + voxSceneFile;
+
+  // the terrain is generated by the builder shaders, so their sources are part of the key, the
+  // cache holds no prefabs, so the scenes that have them are always imported
+  bool const hasVoxPrefabs =
+      !pathToVoxScene.empty() && _configContainer->svoBuilderInfo->voxPrefabMinInstanceCount > 0;
+  std::unique_ptr<ChunkOctreeCache> cache = nullptr;
+  if (_configContainer->svoBuilderInfo->useChunkOctreeCache && !_isStreamingChunks() &&
+      !hasVoxPrefabs) {
+    uint64_t const cacheKey = ChunkOctreeCache::makeKey(
+        _configContainer->terrainInfo->chunkVoxelDim, chunksDim,
+        _configContainer->terrainInfo->bakedNoiseOctaveCount, *_configContainer->svoBuilderInfo,
+        ChunkOctreeCache::getBuilderShaderFolders(), pathToVoxScene);
+    cache = std::make_unique<ChunkOctreeCache>(_logger, ChunkOctreeCache::getPathToSceneCache(),
+                                               cacheKey);
+    if (cache->openForReading() && _loadChunkOctreesFromCache(*cache)) {
+      _setPalette(cache->getPalette());
+      _requestWorldChunks(_getChunkWindow(_chunkWindowOrigin));
+      _loadWorldWindow();
+      return;
+    }
+  }
+
+  // the saved chunks are read while the window is generated, and replace it afterwards
+  _requestWorldChunks(_getChunkWindow(_chunkWindowOrigin));
+
+  // an imported scene is only parsed on a cache miss
+  if (!pathToVoxScene.empty() && _voxData == nullptr) {
+    _loadVoxScene();
+  }
+  _setPalette(_voxData != nullptr ? _voxData->paletteData : BlockPalette::makeTerrainPalette());
+
+  std::vector<ChunkIndex> pendingChunks{};
+  pendingChunks.reserve(chunksDim.x * chunksDim.y * chunksDim.z);
+  // reversed, so the chunks are popped in the original order
+  for (uint32_t z = chunksDim.z; z-- > 0;) {
+    for (uint32_t y = chunksDim.y; y-- > 0;) {
+      for (uint32_t x = chunksDim.x; x-- > 0;) {
+        ChunkIndex const chunkIndex{_chunkWindowOrigin.x + static_cast<int32_t>(x),
+                                    _chunkWindowOrigin.y + static_cast<int32_t>(y),
+                                    _chunkWindowOrigin.z + static_cast<int32_t>(z)};
+        // the empty chunks of an imported scene are known on the host already
+        if (_voxData != nullptr &&
+            _voxData->chunkFragmentLists[_getChunksBufferLinearIndex(chunkIndex)].empty()) {
+          continue;
+        }
+        pendingChunks.emplace_back(chunkIndex);
+      }
+    }
+  }
+  auto const chunkCount = static_cast<uint32_t>(pendingChunks.size());
+
+  uint32_t minTimeMs = std::numeric_limits<uint32_t>::max();
+  uint32_t maxTimeMs = 0;
+  uint32_t avgTimeMs = 0;
+  _chunkBuildProfiler->clear();
+
+  auto const buildStart = std::chrono::steady_clock::now();
+
+  // every slot is submitted as a whole, the host only looks at a slot again once the chunk swap
+  // semaphore reaches its value, to mirror the final allocation size
+  uint32_t busySlotCount = 0;
+  std::vector<std::pair<uint32_t, ChunkIndex>> builds{};
+  while (!pendingChunks.empty() || busySlotCount > 0) {
+    builds.clear();
+    for (uint32_t slotIndex = 0; slotIndex < _chunkBuildSlotCount; slotIndex++) {
+      auto &slot = _chunkBuildSlots[slotIndex];
+
+      if (slot.state == ChunkBuildSlot::State::kBuilding) {
+        if (!_isChunkBuildSlotFinished(slotIndex) || !_finishChunkBuild(slotIndex)) {
+          continue;
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - slot.startTime)
+                            .count();
+        minTimeMs  = std::min(minTimeMs, static_cast<uint32_t>(duration));
+        maxTimeMs  = std::max(maxTimeMs, static_cast<uint32_t>(duration));
+        avgTimeMs += static_cast<uint32_t>(duration);
+        busySlotCount--;
+      }
+
+      if (!pendingChunks.empty()) {
+        builds.emplace_back(slotIndex, pendingChunks.back());
+        pendingChunks.pop_back();
+        busySlotCount++;
+      }
+    }
+    _submitGeneratedChunkBuilds(builds);
+
+    // sleep until any of the busy slots is finished, the semaphore is signaled in submission
+    // order, so that is the slot with the lowest value
+    uint64_t earliestTimelineValue = std::numeric_limits<uint64_t>::max();
+    for (auto const &slot : _chunkBuildSlots) {
+      if (slot.state == ChunkBuildSlot::State::kBuilding) {
+        earliestTimelineValue = std::min(earliestTimelineValue, slot.timelineValue);
+      }
+    }
+    if (earliestTimelineValue != std::numeric_limits<uint64_t>::max()) {
+      VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+      waitInfo.semaphoreCount = 1;
+      waitInfo.pSemaphores    = &_chunkSwapSemaphore;
+      waitInfo.pValues        = &earliestTimelineValue;
+      vkWaitSemaphores(_appContext->getDevice(), &waitInfo, UINT64_MAX);
+    }
+  }
+
+  auto const totalTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::steady_clock::now() - buildStart)
+                               .count();
+
+  avgTimeMs /= std::max(chunkCount, 1U);
+
+  _logger->info("min time: {} ms, max time: {} ms, avg time: {} ms (in flight: {}), total: {} ms",
+                minTimeMs, maxTimeMs, avgTimeMs, _chunkBuildSlotCount, totalTimeMs);
+  _chunkBuildProfiler->printStats();
+  auto const &profileCsvFile = _configContainer->svoBuilderInfo->chunkBuildProfileCsvFile;
+  if (!profileCsvFile.empty()) {
+    _chunkBuildProfiler->writeCsv(kPathToResourceFolder + "profiles/" + profileCsvFile);
+  }
+
+  // nothing is edited yet, the cache keeps the optimized octrees
+  if (_configContainer->svoBuilderInfo->deduplicateChunkOctrees ||
+      _configContainer->svoBuilderInfo->reorderChunkOctrees) {
+    _optimizeChunkOctrees();
+  }
+  if (_voxData != nullptr && !_voxData->prefabs.empty()) {
+    _uploadPrefabInstances();
+  }
+
+  for (uint32_t page = 0; page < _octreePageAllocators.size(); page++) {
+    _logger->info("octree buffer page {}:", page);
+    _octreePageAllocators[page]->printStats();
+  }
+
+  // the cache only holds the generated terrain
+  if (cache != nullptr) {
+    _saveChunkOctreesToCache(*cache);
+  }
+  _loadWorldWindow();
+}
+
+bool SvoBuilder::_loadChunkOctreesFromCache(ChunkOctreeCache &cache) {
+  auto const loadStart = std::chrono::steady_clock::now();
+
+  // the file is read into one segment of the ring, while the copies of the others are in flight,
+  // a segment is only refilled once its copies are done
+  size_t constexpr kStagingSegmentSize    = 16 * 1024 * 1024;
+  uint32_t constexpr kStagingSegmentCount = 4;
+  Buffer stagingBuffer(_appContext, kStagingSegmentSize * kStagingSegmentCount,
+                       VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryStyle::kHostVisible);
+  auto *stagingData = static_cast<char *>(stagingBuffer.getMappedAddr());
+
+  // the copies go to the dedicated transfer queue if there's one, instead of the queue of the
+  // frames that start meanwhile, the pages are shared with its family concurrently,
+  // and the frames wait on the chunk swaps, which makes the copies visible without a barrier
+  bool const isTransferQueueDedicated = _appContext->isTransferQueueDedicated();
+  VkQueue const copyQueue =
+      isTransferQueueDedicated ? _appContext->getTransferQueue() : _appContext->getComputeQueue();
+  VkCommandPool copyCommandPool = _buildCommandPool;
+  if (isTransferQueueDedicated) {
+    VkCommandPoolCreateInfo poolInfo{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    poolInfo.queueFamilyIndex = _appContext->getTransferQueueIndex();
+    vkCreateCommandPool(_appContext->getDevice(), &poolInfo, nullptr, &copyCommandPool);
+  }
+
+  std::vector<VkCommandBuffer> segmentCommandBuffers(kStagingSegmentCount);
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = copyCommandPool;
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = kStagingSegmentCount;
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, segmentCommandBuffers.data());
+  std::vector<uint64_t> segmentTimelineValues(kStagingSegmentCount, 0);
+
+  struct StagedCopy {
+    uint32_t page;
+    VkBufferCopy region;
+  };
+  std::vector<StagedCopy> stagedCopies{};
+  uint32_t segment   = 0;
+  size_t segmentFill = 0;
+
+  auto const submitSegment = [&]() {
+    VkCommandBuffer cmdBuffer = segmentCommandBuffers[segment];
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+    for (auto const &stagedCopy : stagedCopies) {
+      vkCmdCopyBuffer(cmdBuffer, stagingBuffer.getVkBuffer(),
+                      _octreeBufferPages[stagedCopy.page]->getVkBuffer(), 1, &stagedCopy.region);
+    }
+    if (!isTransferQueueDedicated) {
+      _recordTransferToShaderBarrier(cmdBuffer);
+    }
+    vkEndCommandBuffer(cmdBuffer);
+
+    segmentTimelineValues[segment] = ++_chunkSwapValue;
+    _submitWithTimelineSignal(_appContext, {cmdBuffer}, _chunkSwapSemaphore,
+                              segmentTimelineValues[segment], copyQueue);
+    stagedCopies.clear();
+
+    segment     = (segment + 1) % kStagingSegmentCount;
+    segmentFill = 0;
+    _waitForTimelineValue(_appContext->getDevice(), _chunkSwapSemaphore,
+                          segmentTimelineValues[segment]);
+  };
+
+  // the chunk indices entries are uploaded last, so a broken cache never becomes visible
+  auto const &chunksDim = getChunksDim();
+  std::vector<ChunkIndicesEntry> chunkIndicesEntries(chunksDim.x * chunksDim.y * chunksDim.z,
+                                                     ChunkIndicesEntry{0});
+
+  bool isValid = true;
+  for (uint32_t i = 0; isValid && i < cache.getChunkCount(); i++) {
+    ChunkOctreeCache::ChunkRecord record{};
+    if (!cache.readChunkRecord(record)) {
+      isValid = false;
+      break;
+    }
+
+    size_t const octreeSize = static_cast<size_t>(record.octreeLength) * sizeof(uint32_t);
+    if (record.x >= chunksDim.x || record.y >= chunksDim.y || record.z >= chunksDim.z ||
+        record.lod >= _chunkLodCount || record.octreeLength == 0 || octreeSize > _octreePageSize) {
+      isValid = false;
+      break;
+    }
+
+    ChunkIndex const chunkIndex{static_cast<int32_t>(record.x), static_cast<int32_t>(record.y),
+                                static_cast<int32_t>(record.z)};
+    auto const allocation                      = _allocateOctreeRegion(octreeSize);
+    _chunkIndexToBufferAllocResult[chunkIndex] = allocation;
+    _chunkIndexToLod[chunkIndex]               = record.lod;
+    _octreeLengthEstimate =
+        std::max(_octreeLengthEstimate, record.octreeLength + record.octreeLength / 4);
+
+    chunkIndicesEntries[_getChunksBufferLinearIndex(chunkIndex)] = _makeChunkIndicesEntry(
+        allocation.page, record.lod, allocation.region.offset() / sizeof(uint32_t));
+
+    // large octrees are split over several segments
+    size_t copiedSize = 0;
+    while (copiedSize < octreeSize) {
+      if (segmentFill == kStagingSegmentSize) {
+        submitSegment();
+      }
+      size_t const copySize =
+          std::min(octreeSize - copiedSize, kStagingSegmentSize - segmentFill);
+      size_t const stagingOffset = segment * kStagingSegmentSize + segmentFill;
+      if (!cache.readOctreeData(stagingData + stagingOffset, copySize)) {
+        isValid = false;
+        break;
+      }
+      stagedCopies.push_back(
+          {allocation.page, {stagingOffset, allocation.region.offset() + copiedSize, copySize}});
+      segmentFill += copySize;
+      copiedSize += copySize;
+    }
+  }
+
+  if (!stagedCopies.empty()) {
+    submitSegment();
+  }
+  _waitForTimelineValue(_appContext->getDevice(), _chunkSwapSemaphore, _chunkSwapValue);
+  vkFreeCommandBuffers(_appContext->getDevice(), copyCommandPool, kStagingSegmentCount,
+                       segmentCommandBuffers.data());
+  if (isTransferQueueDedicated) {
+    vkDestroyCommandPool(_appContext->getDevice(), copyCommandPool, nullptr);
+  }
+
+  if (!isValid) {
+    _logger->warn("the chunk octree cache is broken, the scene is generated again");
+    for (auto &allocator : _octreePageAllocators) {
+      allocator->freeAll();
+    }
+    _chunkIndexToBufferAllocResult.clear();
+    _chunkIndexToLod.clear();
+    return false;
+  }
+
+  _chunkIndicesBuffer->fillData(chunkIndicesEntries.data());
+  // the cache holds no bounds, the chunks are clipped to their whole cube
+  std::vector<uint32_t> const chunkBounds(chunkIndicesEntries.size(), 0);
+  _chunkBoundsBuffer->fillData(chunkBounds.data());
+
+  auto const loadTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - loadStart)
+                              .count();
+  _logger->info("{} chunk octrees loaded from the cache in {} ms",
+                _chunkIndexToBufferAllocResult.size(), loadTimeMs);
+  return true;
+}
+
+void SvoBuilder::_setPalette(BlockPalette::Palette const &palette) {
+  _palette = palette;
+  _paletteBuffer->fillData(_palette.data());
+}
+
+void SvoBuilder::_saveChunkOctreesToCache(ChunkOctreeCache &cache) {
+  std::vector<std::pair<ChunkIndex, OctreeAllocation>> chunkOctrees(
+      _chunkIndexToBufferAllocResult.begin(), _chunkIndexToBufferAllocResult.end());
+  if (!cache.openForWriting(static_cast<uint32_t>(chunkOctrees.size()), _palette)) {
+    return;
+  }
+
+  // a whole page is fetched at once, this only happens after a generation, which takes by far
+  // longer than the readback
+  std::vector<uint32_t> pageData(_octreePageSize / sizeof(uint32_t));
+  for (uint32_t page = 0; page < _octreeBufferPages.size(); page++) {
+    bool isPageUsed = std::any_of(chunkOctrees.begin(), chunkOctrees.end(),
+                                  [page](auto const &chunkOctree) {
+                                    return chunkOctree.second.page == page;
+                                  });
+    if (!isPageUsed) {
+      continue;
+    }
+
+    _octreeBufferPages[page]->fetchData(pageData.data());
+    for (auto const &[chunkIndex, allocation] : chunkOctrees) {
+      if (allocation.page != page) {
+        continue;
+      }
+      ChunkOctreeCache::ChunkRecord const record{
+          static_cast<uint32_t>(chunkIndex.x), static_cast<uint32_t>(chunkIndex.y),
+          static_cast<uint32_t>(chunkIndex.z), _chunkIndexToLod[chunkIndex],
+          static_cast<uint32_t>(allocation.region.size() / sizeof(uint32_t))};
+      cache.writeChunkRecord(record, &pageData[allocation.region.offset() / sizeof(uint32_t)]);
+    }
+  }
+
+  if (cache.finishWriting()) {
+    _logger->info("{} chunk octrees saved to the cache", chunkOctrees.size());
+  }
+}
+
+void SvoBuilder::_optimizeChunkOctrees() {
+  auto const optimizationStart = std::chrono::steady_clock::now();
+  bool const isDeduplicating   = _configContainer->svoBuilderInfo->deduplicateChunkOctrees;
+  bool const isReordering      = _configContainer->svoBuilderInfo->reorderChunkOctrees;
+
+  size_t originalLength         = 0;
+  size_t optimizedLength        = 0;
+  double originalChildDistance  = 0.0;
+  double optimizedChildDistance = 0.0;
+  std::vector<uint32_t> pageData(_octreePageSize / sizeof(uint32_t));
+  for (uint32_t page = 0; page < _octreeBufferPages.size(); page++) {
+    std::vector<std::pair<ChunkIndex, std::vector<uint32_t>>> chunkOctrees{};
+    for (auto const &[chunkIndex, allocation] : _chunkIndexToBufferAllocResult) {
+      if (allocation.page == page) {
+        chunkOctrees.emplace_back(chunkIndex, std::vector<uint32_t>{});
+      }
+    }
+    if (chunkOctrees.empty()) {
+      continue;
+    }
+
+    // all of the octrees of the page are done before any of them is written back
+    _octreeBufferPages[page]->fetchData(pageData.data());
+    for (auto &[chunkIndex, octree] : chunkOctrees) {
+      auto const &region        = _chunkIndexToBufferAllocResult[chunkIndex].region;
+      size_t const octreeLength = region.size() / sizeof(uint32_t);
+      uint32_t const *original  = &pageData[region.offset() / sizeof(uint32_t)];
+      octree.assign(original, original + octreeLength);
+      originalLength += octreeLength;
+      originalChildDistance += OctreeLayout::getMeanChildDistance(original, octreeLength);
+
+      if (isDeduplicating) {
+        octree = OctreeDag::deduplicate(octree.data(), octree.size());
+      }
+      if (isReordering) {
+        octree = OctreeLayout::reorderForTraversal(octree.data(), octree.size(),
+                                                   OctreeLayout::kBreadthFirstLevelCount);
+      }
+      optimizedLength += octree.size();
+      optimizedChildDistance += OctreeLayout::getMeanChildDistance(octree.data(), octree.size());
+    }
+
+    // neither pass makes an octree longer, so they fit into the page again
+    _octreePageAllocators[page]->freeAll();
+    for (auto const &[chunkIndex, octree] : chunkOctrees) {
+      auto const region = _octreePageAllocators[page]->allocate(octree.size() * sizeof(uint32_t));
+      std::copy(octree.begin(), octree.end(),
+                pageData.begin() + region.offset() / sizeof(uint32_t));
+      _chunkIndexToBufferAllocResult[chunkIndex] = {page, region};
+    }
+    _octreeBufferPages[page]->fillData(pageData.data());
+  }
+
+  auto const &chunksDim = getChunksDim();
+  std::vector<ChunkIndicesEntry> chunkIndicesEntries(chunksDim.x * chunksDim.y * chunksDim.z,
+                                                     ChunkIndicesEntry{0});
+  for (auto const &[chunkIndex, allocation] : _chunkIndexToBufferAllocResult) {
+    chunkIndicesEntries[_getChunksBufferLinearIndex(chunkIndex)] =
+        _makeChunkIndicesEntry(allocation.page, _chunkIndexToLod[chunkIndex],
+                               allocation.region.offset() / sizeof(uint32_t));
+  }
+  _chunkIndicesBuffer->fillData(chunkIndicesEntries.data());
+  _octreeBufferMayHaveHoles = false;
+
+  size_t constexpr kMb = 1024 * 1024;
+  auto const chunkCount =
+      static_cast<double>(std::max<size_t>(_chunkIndexToBufferAllocResult.size(), 1));
+  auto const optimizationTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - optimizationStart)
+                                      .count();
+  _logger->info("chunk octrees optimized in {} ms: {} mb -> {} mb, mean child distance: {:.1f} -> "
+                "{:.1f} uint32",
+                optimizationTimeMs, originalLength * sizeof(uint32_t) / kMb,
+                optimizedLength * sizeof(uint32_t) / kMb, originalChildDistance / chunkCount,
+                optimizedChildDistance / chunkCount);
+}
+
+std::vector<SvoBuilder::ChunkIndex> SvoBuilder::_getEditingChunks(glm::vec3 minPos,
+                                                                  glm::vec3 maxPos) {
+  std::vector<ChunkIndex> chunks{};
+
+  // floored, the positions are negative behind the starting point while streaming
+  glm::ivec3 minChunkIndex = glm::ivec3(glm::floor(minPos));
+  glm::ivec3 maxChunkIndex = glm::ivec3(glm::floor(maxPos));
+
+  // ensure min and max is in the range of the chunk window
+  minChunkIndex = glm::max(minChunkIndex, _chunkWindowOrigin);
+  maxChunkIndex = glm::min(maxChunkIndex, _chunkWindowOrigin + glm::ivec3(getChunksDim()) - 1);
+
+  for (int32_t z = minChunkIndex.z; z <= maxChunkIndex.z; z++) {
+    for (int32_t y = minChunkIndex.y; y <= maxChunkIndex.y; y++) {
+      for (int32_t x = minChunkIndex.x; x <= maxChunkIndex.x; x++) {
+        chunks.emplace_back(ChunkIndex{x, y, z});
+      }
+    }
+  }
+
+  // print using logger
+  // _logger->info("------");
+  // for (auto const &chunk : chunks) {
+  //   _logger->info("editing chunk: x: {}, y: {}, z: {}", chunk.x, chunk.y, chunk.z);
+  // }
+  // _logger->info("------");
+
+  // print no only
+  // _logger->info("editing chunks: {}", chunks.size());
+
+  return chunks;
+}
+
+void SvoBuilder::handleCursorHit(glm::vec3 hitPos, bool deletionMode) {
+  // an imported scene has no field to edit, the edit would replace its chunks with the terrain
+  if (_voxData != nullptr) {
+    return;
+  }
+
+  // a new stroke can't be redone over, the undone strokes are dropped
+  if (!_isEditStrokeActive) {
+    _isEditStrokeActive = true;
+    _clearEditJournal(_redoJournal);
+    _undoJournal.push_back({++_editStrokeCount, {}});
+  }
+
+  G_ChunkEditingInfo chunkEditingInfo{};
+  chunkEditingInfo.pos       = hitPos;
+  chunkEditingInfo.radius    = _configContainer->brushInfo->size;
+  chunkEditingInfo.strength  = _configContainer->brushInfo->strength;
+  chunkEditingInfo.operation = deletionMode ? kChunkEditingOperationDeletion
+                                            : kChunkEditingOperationAddition;
+  chunkEditingInfo.shape     = kChunkEditingShapeSphere;
+  chunkEditingInfo.blockType = kBlockTypeDirt;
+  _queueEdit(chunkEditingInfo);
+}
+
+void SvoBuilder::applyEdits(std::vector<G_ChunkEditingInfo> const &edits) {
+  if (_voxData != nullptr || edits.empty()) {
+    return;
+  }
+
+  // the list is a stroke of its own, so a single undo takes all of it back
+  _clearEditJournal(_redoJournal);
+  _undoJournal.push_back({++_editStrokeCount, {}});
+  _isEditStrokeActive = false;
+
+  for (auto const &edit : edits) {
+    _queueEdit(edit);
+  }
+}
+
+void SvoBuilder::_queueEdit(G_ChunkEditingInfo const &edit) {
+  glm::vec3 const reach = _getEditingReach(edit);
+  const auto &chunks    = _getEditingChunks(edit.pos - reach, edit.pos + reach);
+  for (auto const &chunk : chunks) {
+    auto &chunkEdits = _pendingChunkEdits[chunk];
+
+    // holding the brush still repeats the same stamp, which is merged by adding up the strength
+    if (!chunkEdits.empty() && edit.operation <= kChunkEditingOperationAddition) {
+      auto &lastEdit  = chunkEdits.back();
+      auto &lastStamp = lastEdit.editingBatch.stamps[lastEdit.editingBatch.stampCount - 1];
+      if (lastStamp.pos == edit.pos && lastStamp.radius == edit.radius &&
+          lastStamp.operation == edit.operation && lastStamp.shape == edit.shape &&
+          lastStamp.halfExtent == edit.halfExtent && lastStamp.blockType == edit.blockType) {
+        lastStamp.strength += edit.strength;
+        lastEdit.editStroke = _editStrokeCount;
+        continue;
+      }
+    }
+
+    // a full batch is submitted as soon as possible, the stamps after it wait in the next one
+    if (chunkEdits.empty() ||
+        chunkEdits.back().editingBatch.stampCount == kMaxChunkEditingStampCount) {
+      chunkEdits.emplace_back();
+      chunkEdits.back().firstStampTime = std::chrono::steady_clock::now();
+    }
+    auto &pendingEdit      = chunkEdits.back();
+    pendingEdit.editStroke = _editStrokeCount;
+    pendingEdit.editingBatch.stamps[pendingEdit.editingBatch.stampCount++] = edit;
+  }
+}
+
+void SvoBuilder::update(glm::vec3 cameraPosition, glm::vec3 cameraFront) {
+  auto const streamingDeadline =
+      std::chrono::steady_clock::now() +
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<float, std::milli>(
+              _configContainer->svoBuilderInfo->streamingFrameBudgetMs));
+  _updateCameraMotion(cameraPosition, cameraFront);
+
+  vkGetSemaphoreCounterValue(_appContext->getDevice(), _chunkSwapSemaphore,
+                             &_completedChunkSwapValue);
+
+  _releaseRetiredAllocations();
+
+  // the builds of the first device are judged by the value read above, and finished in the order
+  // of their values, so the preview of an edit is always finished before the full build that
+  // replaces it
+  _finishCompletedChunkBuilds();
+
+  _cameraChunk = glm::ivec3(glm::floor(cameraPosition));
+  if (_isStreamingChunks()) {
+    _updateChunkWindow();
+  }
+  if (_cameraChunk != _lodCameraChunk) {
+    _lodCameraChunk = _cameraChunk;
+    _queueChunkLodChanges();
+  } else {
+    // the order of the queued chunks follows the motion of the camera within its chunk too
+    _sortPendingChunkBuilds();
+  }
+
+  // the loaded chunks take the place of their builds, the restored chunks and the edits go first,
+  // the background builds fill the slots that are left
+  _applyLoadedWorldChunks(kWorldChunkUploadBudget, streamingDeadline);
+  _applyRequestedJournalSteps();
+  _submitPendingChunkRestores();
+  _submitPendingChunkEdits();
+  _drainPendingChunkEdits();
+  _submitPendingChunkBuilds(streamingDeadline);
+  _updateOctreeCompaction();
+  _evictColdSavedFields();
+  _updateWorldSave();
+}
+
+void SvoBuilder::_updateChunkWindow() {
+  if (_visibleChunkWindowOrigin != _chunkWindowOrigin) {
+    if (_completedChunkSwapValue < _chunkWindowShiftTimelineValue) {
+      return;
+    }
+
+    // from now on, the left chunks are no longer traced, except by the frames in flight
+    _visibleChunkWindowOrigin = _chunkWindowOrigin;
+    auto const framesInFlight =
+        static_cast<uint32_t>(_configContainer->applicationInfo->framesInFlight);
+    for (auto const &allocation : _chunkWindowLeavingAllocations) {
+      _retiredAllocations.push_back({allocation, framesInFlight});
+    }
+    _chunkWindowLeavingAllocations.clear();
+    _chunkWindowSettleFramesLeft = framesInFlight;
+    return;
+  }
+
+  if (_chunkWindowSettleFramesLeft > 0) {
+    _chunkWindowSettleFramesLeft--;
+  }
+
+  // the window is centred on the chunk the camera is heading to, so the chunks ahead of it enter
+  // the window, and are loaded and built, before the camera gets there
+  auto const chunksDim          = glm::ivec3(getChunksDim());
+  glm::ivec3 const centreChunk  = _getPredictedCameraChunk();
+  glm::ivec3 const windowOrigin = {centreChunk.x - chunksDim.x / 2, 0,
+                                   centreChunk.z - chunksDim.z / 2};
+  if (windowOrigin == _chunkWindowOrigin) {
+    return;
+  }
+
+  // the builds and the moves in flight write the entries of their chunks, which might be about to
+  // leave the window, they are short enough to wait for
+  bool const isBuilding = std::any_of(_chunkBuildSlots.begin(), _chunkBuildSlots.end(),
+                                      [](ChunkBuildSlot const &slot) {
+                                        return slot.state == ChunkBuildSlot::State::kBuilding;
+                                      });
+  if (isBuilding || !_inFlightOctreeMoves.empty()) {
+    return;
+  }
+
+  _submitChunkWindowShift(windowOrigin);
+}
+
+void SvoBuilder::_submitChunkWindowShift(glm::ivec3 newOrigin) {
+  // the edits of the leaving chunks are written before their fields are dropped, the shift is
+  // submitted after the copies, so their octrees are still in place
+  std::vector<ChunkIndex> leavingDirtyChunks{};
+  for (auto const &chunkIndex : _dirtyWorldChunks) {
+    if (!_isInChunkWindow(chunkIndex, newOrigin)) {
+      leavingDirtyChunks.push_back(chunkIndex);
+    }
+  }
+  _saveWorldChunks(std::move(leavingDirtyChunks));
+
+  VkCommandBuffer cmdBuffer = _chunkWindowShiftCommandBuffer;
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+  // the entries are written by the chunk builds and the compaction before
+  VkMemoryBarrier entryWriteBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  entryWriteBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  entryWriteBarrier.dstAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(cmdBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &entryWriteBarrier, 0, nullptr, 0,
+                       nullptr);
+
+  // the entering chunks share the entries of the leaving ones, which are emptied until the
+  // entering chunks are built
+  ChunkIndicesEntry const emptyChunkIndicesEntry{0};
+  auto it = _chunkIndexToBufferAllocResult.begin();
+  while (it != _chunkIndexToBufferAllocResult.end()) {
+    if (_isInChunkWindow(it->first, newOrigin)) {
+      it++;
+      continue;
+    }
+    vkCmdUpdateBuffer(cmdBuffer, _chunkIndicesBuffer->getVkBuffer(),
+                      _getChunksBufferLinearIndex(it->first) * sizeof(ChunkIndicesEntry),
+                      sizeof(ChunkIndicesEntry), &emptyChunkIndicesEntry);
+    _chunkWindowLeavingAllocations.push_back(it->second);
+    it = _chunkIndexToBufferAllocResult.erase(it);
+  }
+
+  vkEndCommandBuffer(cmdBuffer);
+
+  _chunkWindowShiftTimelineValue = ++_chunkSwapValue;
+  _submitWithTimelineSignal(_appContext, {cmdBuffer}, _chunkSwapSemaphore,
+                            _chunkWindowShiftTimelineValue);
+
+  // the saved edit states of the left chunks are dropped, they are generated again once the
+  // window comes back
+  for (auto fieldIt = _chunkIndexToSavedField.begin(); fieldIt != _chunkIndexToSavedField.end();) {
+    if (_isInChunkWindow(fieldIt->first, newOrigin)) {
+      fieldIt++;
+      continue;
+    }
+    _fieldBrickPoolMemoryAllocator->deallocate(fieldIt->second.allocation);
+    fieldIt = _chunkIndexToSavedField.erase(fieldIt);
+  }
+  for (auto fieldIt = _chunkIndexToEvictedField.begin();
+       fieldIt != _chunkIndexToEvictedField.end();) {
+    if (_isInChunkWindow(fieldIt->first, newOrigin)) {
+      fieldIt++;
+      continue;
+    }
+    fieldIt = _chunkIndexToEvictedField.erase(fieldIt);
+  }
+  for (auto listIt = _chunkIndexToFragmentListAllocResult.begin();
+       listIt != _chunkIndexToFragmentListAllocResult.end();) {
+    if (_isInChunkWindow(listIt->first, newOrigin)) {
+      listIt++;
+      continue;
+    }
+    _fragmentListMemoryAllocator->deallocate(listIt->second);
+    listIt = _chunkIndexToFragmentListAllocResult.erase(listIt);
+  }
+  for (auto editIt = _pendingChunkEdits.begin(); editIt != _pendingChunkEdits.end();) {
+    if (_isInChunkWindow(editIt->first, newOrigin)) {
+      editIt++;
+      continue;
+    }
+    editIt = _pendingChunkEdits.erase(editIt);
+  }
+  // so are their journaled fields, the strokes can still be undone within the window
+  for (auto *journal : {&_undoJournal, &_redoJournal}) {
+    for (auto &journalEntry : *journal) {
+      auto &chunkFields = journalEntry.chunkFields;
+      for (auto fieldIt = chunkFields.begin(); fieldIt != chunkFields.end();) {
+        if (_isInChunkWindow(fieldIt->first, newOrigin)) {
+          fieldIt++;
+          continue;
+        }
+        if (fieldIt->second.has_value()) {
+          _fieldBrickPoolMemoryAllocator->deallocate(*fieldIt->second);
+        }
+        fieldIt = chunkFields.erase(fieldIt);
+      }
+    }
+  }
+  _pendingChunkRestores.erase(std::remove_if(_pendingChunkRestores.begin(),
+                                             _pendingChunkRestores.end(),
+                                             [this, newOrigin](ChunkIndex const &chunkIndex) {
+                                               return !_isInChunkWindow(chunkIndex, newOrigin);
+                                             }),
+                              _pendingChunkRestores.end());
+  for (auto lodIt = _chunkIndexToLod.begin(); lodIt != _chunkIndexToLod.end();) {
+    if (_isInChunkWindow(lodIt->first, newOrigin)) {
+      lodIt++;
+      continue;
+    }
+    lodIt = _chunkIndexToLod.erase(lodIt);
+  }
+
+  // the chunks that haven't been built yet are kept if they're still in the window
+  std::vector<ChunkIndex> pendingChunks{};
+  for (auto const &chunkIndex : _pendingChunkBuilds) {
+    if (_isInChunkWindow(chunkIndex, newOrigin)) {
+      pendingChunks.push_back(chunkIndex);
+    }
+  }
+  std::vector<ChunkIndex> enteringChunks{};
+  for (auto const &chunkIndex : _getChunkWindow(newOrigin)) {
+    if (!_isInChunkWindow(chunkIndex, _chunkWindowOrigin)) {
+      pendingChunks.push_back(chunkIndex);
+      enteringChunks.push_back(chunkIndex);
+    }
+  }
+  _requestWorldChunks(enteringChunks);
+
+  _pendingChunkBuilds = std::move(pendingChunks);
+  _sortPendingChunkBuilds();
+
+  _chunkWindowOrigin        = newOrigin;
+  _octreeBufferMayHaveHoles = true;
+}
+
+uint32_t SvoBuilder::_decideChunkLod(ChunkIndex const &chunkIndex) const {
+  auto const &lodDistances = _configContainer->svoBuilderInfo->chunkLodDistances;
+  int64_t const dx         = chunkIndex.x - _cameraChunk.x;
+  int64_t const dz         = chunkIndex.z - _cameraChunk.z;
+  int64_t const distanceSq = dx * dx + dz * dz;
+
+  uint32_t lod = 0;
+  while (lod + 1 < _chunkLodCount && lodDistances[lod] > 0 &&
+         distanceSq >= static_cast<int64_t>(lodDistances[lod]) * lodDistances[lod]) {
+    lod++;
+  }
+  return lod;
+}
+
+void SvoBuilder::_queueChunkLodChanges() {
+  for (auto const &[chunkIndex, lod] : _chunkIndexToLod) {
+    bool const isEdited =
+        _chunkIndexToSavedField.find(chunkIndex) != _chunkIndexToSavedField.end() ||
+        _chunkIndexToEvictedField.find(chunkIndex) != _chunkIndexToEvictedField.end();
+    if (isEdited || lod == _decideChunkLod(chunkIndex) ||
+        std::find(_pendingChunkBuilds.begin(), _pendingChunkBuilds.end(), chunkIndex) !=
+            _pendingChunkBuilds.end()) {
+      continue;
+    }
+    _pendingChunkBuilds.push_back(chunkIndex);
+  }
+
+  // the camera has moved, so the queued chunks are sorted again, even if none is added
+  _sortPendingChunkBuilds();
+}
+
+void SvoBuilder::_updateCameraMotion(glm::vec3 cameraPosition, glm::vec3 cameraFront) {
+  auto const now = std::chrono::steady_clock::now();
+  if (_lastCameraUpdateTime != std::chrono::steady_clock::time_point{}) {
+    float const deltaTimeInSec = std::chrono::duration<float>(now - _lastCameraUpdateTime).count();
+    if (deltaTimeInSec > 0.F) {
+      glm::vec3 const velocity = (cameraPosition - _cameraPosition) / deltaTimeInSec;
+      _cameraVelocity          = glm::mix(_cameraVelocity, velocity, kCameraVelocitySmoothing);
+    }
+  }
+  _lastCameraUpdateTime = now;
+  _cameraPosition       = cameraPosition;
+  _cameraFront          = cameraFront;
+}
+
+glm::ivec3 SvoBuilder::_getPredictedCameraChunk() const {
+  // the camera stays within a quarter of the window from its centre, so the chunks around it are
+  // kept, the lead only goes along the xz plane, like the window
+  auto const chunksDim    = glm::vec2(getChunksDim().x, getChunksDim().z);
+  glm::vec2 const maxLead = glm::max(glm::floor(chunksDim / 4.F), glm::vec2(0.F));
+  glm::vec2 const lead =
+      glm::clamp(glm::vec2(_cameraVelocity.x, _cameraVelocity.z) *
+                     _configContainer->svoBuilderInfo->streamingLookaheadSec,
+                 -maxLead, maxLead);
+  return glm::ivec3(glm::floor(_cameraPosition + glm::vec3(lead.x, 0.F, lead.y)));
+}
+
+float SvoBuilder::_getTimeToVisibility(ChunkIndex const &chunkIndex) const {
+  glm::vec2 const toChunk = glm::vec2(static_cast<float>(chunkIndex.x) + 0.5F,
+                                      static_cast<float>(chunkIndex.z) + 0.5F) -
+                            glm::vec2(_cameraPosition.x, _cameraPosition.z);
+  float const distance = glm::length(toChunk);
+  if (distance <= 0.F) {
+    return 0.F;
+  }
+  glm::vec2 const direction = toChunk / distance;
+
+  // the chunk is seen once the camera is within a chunk of it, the chunks ahead are closed in on
+  // with the speed of the camera
+  float const closingSpeed =
+      kMinClosingSpeed +
+      std::max(0.F, glm::dot(glm::vec2(_cameraVelocity.x, _cameraVelocity.z), direction));
+  float const closingTime = std::max(0.F, distance - 1.F) / closingSpeed;
+
+  // the chunks behind the view are only seen after a turn
+  glm::vec2 const front = glm::vec2(_cameraFront.x, _cameraFront.z);
+  float const facing =
+      glm::length(front) > 0.F ? glm::dot(glm::normalize(front), direction) : 1.F;
+  return closingTime + kTurnAroundTimeSec * (1.F - facing) * 0.5F;
+}
+
+void SvoBuilder::_sortPendingChunkBuilds() {
+  // the latest first, so the chunk that is seen first is popped first
+  std::vector<std::pair<float, ChunkIndex>> timedChunks{};
+  timedChunks.reserve(_pendingChunkBuilds.size());
+  for (auto const &chunkIndex : _pendingChunkBuilds) {
+    timedChunks.emplace_back(_getTimeToVisibility(chunkIndex), chunkIndex);
+  }
+  std::sort(timedChunks.begin(), timedChunks.end(),
+            [](auto const &a, auto const &b) { return a.first > b.first; });
+  for (size_t i = 0; i < timedChunks.size(); i++) {
+    _pendingChunkBuilds[i] = timedChunks[i].second;
+  }
+}
+
+bool SvoBuilder::_isChunkInFlight(ChunkIndex const &chunkIndex) const {
+  return std::any_of(_chunkBuildSlots.begin(), _chunkBuildSlots.end(),
+                     [&chunkIndex](ChunkBuildSlot const &slot) {
+                       return slot.state == ChunkBuildSlot::State::kBuilding &&
+                              slot.chunkIndex == chunkIndex;
+                     });
+}
+
+void SvoBuilder::_submitPendingChunkBuilds(std::chrono::steady_clock::time_point deadline) {
+  // the entering chunks are written to the entries of the left ones, which the tracer keeps using
+  // until it has followed the window
+  if (!_isChunkWindowSettled() || std::chrono::steady_clock::now() > deadline) {
+    return;
+  }
+
+  // the builds wait until the left chunks, or the compaction, have released enough of the pages
+  bool const isOverBudget =
+      !_pendingChunkBuilds.empty() &&
+      !_canAllocateOctreeRegionWithinBudget(_octreeLengthEstimate * sizeof(uint32_t));
+  if (isOverBudget && !_isOverOctreePoolBudget) {
+    _logger->warn("the octree pages are at their budget, the streamed chunk builds are held back");
+  }
+  _isOverOctreePoolBudget = isOverBudget;
+  if (isOverBudget) {
+    return;
+  }
+
+  std::vector<std::pair<uint32_t, ChunkIndex>> builds{};
+  for (uint32_t slotIndex = 0; slotIndex < _chunkBuildSlotCount; slotIndex++) {
+    if (_chunkBuildSlots[slotIndex].state != ChunkBuildSlot::State::kIdle) {
+      continue;
+    }
+
+    // the chunks that are back at their level of detail, as the camera has returned, are dropped
+    for (size_t i = _pendingChunkBuilds.size(); i-- > 0;) {
+      ChunkIndex const chunkIndex = _pendingChunkBuilds[i];
+      bool const isTaken = std::any_of(builds.begin(), builds.end(), [&chunkIndex](auto const &b) {
+        return b.second == chunkIndex;
+      });
+      if (_isChunkInFlight(chunkIndex) || isTaken) {
+        continue;
+      }
+      _pendingChunkBuilds.erase(_pendingChunkBuilds.begin() + static_cast<std::ptrdiff_t>(i));
+
+      auto const builtLod = _chunkIndexToLod.find(chunkIndex);
+      if (builtLod != _chunkIndexToLod.end() && builtLod->second == _decideChunkLod(chunkIndex)) {
+        continue;
+      }
+      builds.emplace_back(slotIndex, chunkIndex);
+      break;
+    }
+  }
+  _submitGeneratedChunkBuilds(builds);
+}
+
+uint32_t SvoBuilder::_getEditPreviewLod() const {
+  // the fragments of an imported scene aren't built from a field
+  if (_voxData != nullptr) {
+    return 0;
+  }
+  return std::min(_configContainer->svoBuilderInfo->editPreviewLod, _chunkLodCount - 1);
+}
+
+void SvoBuilder::_submitPendingChunkEdits() {
+  // the edits are written to the entries of the window, just like the streamed chunks
+  if (!_isChunkWindowSettled()) {
+    return;
+  }
+
+  auto const now = std::chrono::steady_clock::now();
+  auto const batchInterval =
+      std::chrono::milliseconds(_configContainer->svoBuilderInfo->editBatchIntervalMs);
+
+  for (uint32_t slotIndex = 0; slotIndex < _chunkBuildSlotCount; slotIndex++) {
+    auto &slot = _chunkBuildSlots[slotIndex];
+    if (slot.state != ChunkBuildSlot::State::kIdle) {
+      continue;
+    }
+
+    // pick the oldest batch that is due, the saved field image of a chunk is shared by its edits,
+    // so the chunks in flight keep accumulating stamps instead, only the first batch of a chunk is
+    // considered, the ones behind it are built after it
+    auto chosen = _pendingChunkEdits.end();
+    for (auto it = _pendingChunkEdits.begin(); it != _pendingChunkEdits.end(); it++) {
+      auto const &edit = it->second.front();
+      bool const isDue = now - edit.firstStampTime >= batchInterval ||
+                         edit.editingBatch.stampCount == kMaxChunkEditingStampCount;
+      if (!isDue || (chosen != _pendingChunkEdits.end() &&
+                     chosen->second.front().firstStampTime <= edit.firstStampTime)) {
+        continue;
+      }
+
+      bool const isInFlight =
+          std::any_of(_chunkBuildSlots.begin(), _chunkBuildSlots.end(),
+                      [&it](ChunkBuildSlot const &otherSlot) {
+                        return otherSlot.state == ChunkBuildSlot::State::kBuilding &&
+                               otherSlot.chunkIndex == it->first;
+                      });
+      if (!isInFlight) {
+        chosen = it;
+      }
+    }
+
+    if (chosen == _pendingChunkEdits.end()) {
+      return;
+    }
+
+    // the first edit of a chunk generates it as a whole at full detail, which is all a background
+    // build would do
+    _pendingChunkBuilds.erase(
+        std::remove(_pendingChunkBuilds.begin(), _pendingChunkBuilds.end(), chosen->first),
+        _pendingChunkBuilds.end());
+
+    // the preview is submitted first, to the same queue, so it's swapped in before the full build,
+    // and only if another slot is idle, the full build never waits for a slot, a batch with more
+    // queued behind it isn't previewed, the preview of the last one shows them all
+    if (_getEditPreviewLod() > 0 && chosen->second.size() == 1) {
+      for (uint32_t previewSlotIndex = slotIndex + 1; previewSlotIndex < _chunkBuildSlotCount;
+           previewSlotIndex++) {
+        auto &previewSlot = _chunkBuildSlots[previewSlotIndex];
+        if (previewSlot.state != ChunkBuildSlot::State::kIdle) {
+          continue;
+        }
+        previewSlot.editingBatch = chosen->second.front().editingBatch;
+        previewSlot.editStroke   = chosen->second.front().editStroke;
+        previewSlot.isPreview    = true;
+        _submitChunkBuild(previewSlotIndex, chosen->first, true);
+        break;
+      }
+    }
+
+    slot.editingBatch = chosen->second.front().editingBatch;
+    slot.editStroke   = chosen->second.front().editStroke;
+    _submitChunkBuild(slotIndex, chosen->first, true);
+    chosen->second.pop_front();
+    if (chosen->second.empty()) {
+      _pendingChunkEdits.erase(chosen);
+    }
+  }
+}
+
+void SvoBuilder::_finishCompletedChunkBuilds() {
+  std::vector<uint32_t> finishedSlots{};
+  for (uint32_t slotIndex = 0; slotIndex < _chunkBuildSlotCount; slotIndex++) {
+    auto const &slot = _chunkBuildSlots[slotIndex];
+    if (slot.state != ChunkBuildSlot::State::kBuilding) {
+      continue;
+    }
+    bool const isFinished = slot.deviceIndex == 0 ? slot.timelineValue <= _completedChunkSwapValue
+                                                  : _isChunkBuildSlotFinished(slotIndex);
+    if (isFinished) {
+      finishedSlots.push_back(slotIndex);
+    }
+  }
+  std::sort(finishedSlots.begin(), finishedSlots.end(), [this](uint32_t a, uint32_t b) {
+    auto const &slotA = _chunkBuildSlots[a];
+    auto const &slotB = _chunkBuildSlots[b];
+    return std::make_pair(slotA.deviceIndex, slotA.timelineValue) <
+           std::make_pair(slotB.deviceIndex, slotB.timelineValue);
+  });
+  for (uint32_t const slotIndex : finishedSlots) {
+    _finishChunkBuild(slotIndex);
+  }
+}
+
+void SvoBuilder::_drainPendingChunkEdits() {
+  auto const getPendingBatchCount = [this]() {
+    size_t batchCount = 0;
+    for (auto const &chunkEdits : _pendingChunkEdits) {
+      batchCount += chunkEdits.second.size();
+    }
+    return batchCount;
+  };
+
+  while (getPendingBatchCount() > _configContainer->svoBuilderInfo->maxPendingEditBatches) {
+    // the oldest build is waited for, a window that isn't settled takes no edits, the cap is
+    // enforced once it is
+    auto oldestSlot = _chunkBuildSlots.end();
+    for (auto it = _chunkBuildSlots.begin(); it != _chunkBuildSlots.end(); it++) {
+      if (it->state == ChunkBuildSlot::State::kBuilding &&
+          (oldestSlot == _chunkBuildSlots.end() || it->startTime < oldestSlot->startTime)) {
+        oldestSlot = it;
+      }
+    }
+    if (oldestSlot == _chunkBuildSlots.end()) {
+      return;
+    }
+    _waitForChunkBuildSlot(static_cast<uint32_t>(oldestSlot - _chunkBuildSlots.begin()));
+
+    vkGetSemaphoreCounterValue(_appContext->getDevice(), _chunkSwapSemaphore,
+                               &_completedChunkSwapValue);
+    _finishCompletedChunkBuilds();
+    _submitPendingChunkEdits();
+  }
+}
+
+void SvoBuilder::_releaseRetiredAllocations() {
+  auto it = _retiredAllocations.begin();
+  while (it != _retiredAllocations.end()) {
+    if (it->framesLeft == 0) {
+      _deallocateOctreeRegion(it->allocation);
+      _octreeBufferMayHaveHoles = true;
+      it = _retiredAllocations.erase(it);
+      continue;
+    }
+    it->framesLeft--;
+    it++;
+  }
+}
+
+void SvoBuilder::_journalReplacedSavedField(
+    uint64_t editStroke, ChunkIndex const &chunkIndex,
+    std::optional<CustomMemoryAllocationResult> replacedField) {
+  // the strokes are journaled in order, the edits land shortly after theirs
+  auto entry = std::find_if(_undoJournal.rbegin(), _undoJournal.rend(),
+                            [editStroke](EditJournalEntry const &journalEntry) {
+                              return journalEntry.editStroke == editStroke;
+                            });
+  bool const isJournaled =
+      entry != _undoJournal.rend() && entry->chunkFields.emplace(chunkIndex, replacedField).second;
+  if (!isJournaled) {
+    if (replacedField.has_value()) {
+      _fieldBrickPoolMemoryAllocator->deallocate(*replacedField);
+    }
+    return;
+  }
+
+  size_t constexpr kMb = 1024 * 1024;
+  size_t const journalBudget =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->editJournalBudgetMb) * kMb;
+  size_t journalSize = 0;
+  for (auto const *journal : {&_undoJournal, &_redoJournal}) {
+    for (auto const &journalEntry : *journal) {
+      for (auto const &[journaledChunk, field] : journalEntry.chunkFields) {
+        journalSize += field.has_value() ? field->size() : 0;
+      }
+    }
+  }
+
+  // the oldest strokes can no longer be undone
+  while (journalSize > journalBudget && !_undoJournal.empty()) {
+    for (auto const &[journaledChunk, field] : _undoJournal.front().chunkFields) {
+      if (field.has_value()) {
+        journalSize -= field->size();
+        _fieldBrickPoolMemoryAllocator->deallocate(*field);
+      }
+    }
+    _undoJournal.erase(_undoJournal.begin());
+  }
+}
+
+void SvoBuilder::_clearEditJournal(std::vector<EditJournalEntry> &journal) {
+  for (auto const &journalEntry : journal) {
+    for (auto const &[chunkIndex, field] : journalEntry.chunkFields) {
+      if (field.has_value()) {
+        _fieldBrickPoolMemoryAllocator->deallocate(*field);
+      }
+    }
+  }
+  journal.clear();
+}
+
+void SvoBuilder::_applyRequestedJournalSteps() {
+  if (_requestedJournalSteps == 0) {
+    return;
+  }
+
+  // the journal entries are complete once every edit of their strokes has landed
+  bool const isEditInFlight =
+      std::any_of(_chunkBuildSlots.begin(), _chunkBuildSlots.end(), [](ChunkBuildSlot const &slot) {
+        return slot.state == ChunkBuildSlot::State::kBuilding && slot.isEditing;
+      });
+  if (_isEditStrokeActive || !_pendingChunkEdits.empty() || isEditInFlight) {
+    return;
+  }
+
+  while (_requestedJournalSteps != 0) {
+    bool const isUndo = _requestedJournalSteps > 0;
+    auto &journal     = isUndo ? _undoJournal : _redoJournal;
+    if (journal.empty()) {
+      _logger->info("nothing to {}", isUndo ? "undo" : "redo");
+      _requestedJournalSteps = 0;
+      return;
+    }
+
+    // a stroke that missed every chunk isn't worth a step
+    auto &entry = journal.back();
+    if (entry.chunkFields.empty()) {
+      journal.pop_back();
+      continue;
+    }
+
+    // the builds in flight read the saved fields of their chunks, the step is retried next frame
+    for (auto const &[chunkIndex, field] : entry.chunkFields) {
+      if (_isChunkInFlight(chunkIndex)) {
+        return;
+      }
+    }
+
+    _swapJournaledSavedFields(entry);
+    auto &otherJournal = isUndo ? _redoJournal : _undoJournal;
+    otherJournal.push_back(std::move(entry));
+    journal.pop_back();
+    _requestedJournalSteps += isUndo ? -1 : 1;
+  }
+}
+
+void SvoBuilder::_swapJournaledSavedFields(EditJournalEntry &entry) {
+  for (auto &[chunkIndex, field] : entry.chunkFields) {
+    // the evicted field is brought back, so that the entry can own it
+    _uploadEvictedSavedField(chunkIndex);
+
+    std::optional<CustomMemoryAllocationResult> currentField{};
+    auto const savedField = _chunkIndexToSavedField.find(chunkIndex);
+    if (savedField != _chunkIndexToSavedField.end()) {
+      currentField = savedField->second.allocation;
+      _chunkIndexToSavedField.erase(savedField);
+    }
+    if (field.has_value()) {
+      _chunkIndexToSavedField[chunkIndex] = {*field, ++_savedFieldUseCount};
+    }
+    field = currentField;
+
+    // the saved fragment list belongs to the replaced field, the next edit voxelizes the whole
+    // chunk again
+    auto const savedFragmentList = _chunkIndexToFragmentListAllocResult.find(chunkIndex);
+    if (savedFragmentList != _chunkIndexToFragmentListAllocResult.end()) {
+      _fragmentListMemoryAllocator->deallocate(savedFragmentList->second);
+      _chunkIndexToFragmentListAllocResult.erase(savedFragmentList);
+    }
+
+    if (std::find(_pendingChunkRestores.begin(), _pendingChunkRestores.end(), chunkIndex) ==
+        _pendingChunkRestores.end()) {
+      _pendingChunkRestores.push_back(chunkIndex);
+    }
+    _markWorldChunkDirty(chunkIndex);
+  }
+}
+
+void SvoBuilder::_submitPendingChunkRestores() {
+  // the restores are written to the entries of the window, just like the edits
+  if (!_isChunkWindowSettled()) {
+    return;
+  }
+
+  for (uint32_t slotIndex = 0; slotIndex < _chunkBuildSlotCount; slotIndex++) {
+    if (_chunkBuildSlots[slotIndex].state != ChunkBuildSlot::State::kIdle) {
+      continue;
+    }
+
+    // a restored chunk is built from its saved field at full detail, or generated again without
+    // one, which is all a background build would do
+    for (size_t i = _pendingChunkRestores.size(); i-- > 0;) {
+      ChunkIndex const chunkIndex = _pendingChunkRestores[i];
+      if (_isChunkInFlight(chunkIndex)) {
+        continue;
+      }
+      _pendingChunkRestores.erase(_pendingChunkRestores.begin() + static_cast<std::ptrdiff_t>(i));
+      _pendingChunkBuilds.erase(
+          std::remove(_pendingChunkBuilds.begin(), _pendingChunkBuilds.end(), chunkIndex),
+          _pendingChunkBuilds.end());
+      _submitChunkBuild(slotIndex, chunkIndex, false);
+      break;
+    }
+  }
+}
+
+bool SvoBuilder::_isChunkBuildSlotFinished(uint32_t slotIndex) {
+  uint64_t currentValue = 0;
+  vkGetSemaphoreCounterValue(_appContext->getDevice(), _getChunkBuildSemaphore(slotIndex),
+                             &currentValue);
+  return currentValue >= _chunkBuildSlots[slotIndex].timelineValue;
+}
+
+void SvoBuilder::_waitForChunkBuildSlot(uint32_t slotIndex) {
+  _waitForTimelineValue(_appContext->getDevice(), _getChunkBuildSemaphore(slotIndex),
+                        _chunkBuildSlots[slotIndex].timelineValue);
+}
+
+void SvoBuilder::_waitForAllChunkBuildSlots() {
+  if (_chunkSwapSemaphore == VK_NULL_HANDLE) {
+    return;
+  }
+
+  VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+  waitInfo.semaphoreCount = 1;
+  waitInfo.pSemaphores    = &_chunkSwapSemaphore;
+  waitInfo.pValues        = &_chunkSwapValue;
+  vkWaitSemaphores(_appContext->getDevice(), &waitInfo, UINT64_MAX);
+  // the builds that are never merged are dropped along with the scene
+  for (uint32_t deviceIndex = 1; deviceIndex < _peerBuildSemaphores.size(); deviceIndex++) {
+    _waitForTimelineValue(_appContext->getDevice(), _peerBuildSemaphores[deviceIndex],
+                          _peerBuildValues[deviceIndex]);
+  }
+
+  for (auto &slot : _chunkBuildSlots) {
+    slot.state     = ChunkBuildSlot::State::kIdle;
+    slot.isPreview = false;
+  }
+}
+
+uint32_t SvoBuilder::_decideChunkBuildDevice(uint32_t slotIndex) const {
+  // the fragments of an imported scene are staged per slot on the host, which is left as it is
+  if (_peerBuildSemaphores.size() < 2 || _voxData != nullptr) {
+    return 0;
+  }
+  return slotIndex % static_cast<uint32_t>(_peerBuildSemaphores.size());
+}
+
+VkSemaphore SvoBuilder::_getChunkBuildSemaphore(uint32_t slotIndex) const {
+  uint32_t const deviceIndex = _chunkBuildSlots[slotIndex].deviceIndex;
+  return deviceIndex == 0 ? _chunkSwapSemaphore : _peerBuildSemaphores[deviceIndex];
+}
+
+void SvoBuilder::_createPeerBufferAliases() {
+  VkDevice const device      = _appContext->getDevice();
+  uint32_t const deviceCount = _appContext->getDeviceCount();
+
+  auto const createAlias = [&](Buffer *buffer, uint32_t deviceIndex) {
+    VkBufferCreateInfo bufferCreateInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    bufferCreateInfo.size  = buffer->getSize();
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    VkBuffer alias         = VK_NULL_HANDLE;
+    vkCreateBuffer(device, &bufferCreateInfo, nullptr, &alias);
+
+    // every device of the group reads the memory instance of the device that built into it
+    std::vector<uint32_t> const deviceIndices(deviceCount, deviceIndex);
+    VkBindBufferMemoryDeviceGroupInfo deviceGroupBindInfo{
+        VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_DEVICE_GROUP_INFO};
+    deviceGroupBindInfo.deviceIndexCount = deviceCount;
+    deviceGroupBindInfo.pDeviceIndices   = deviceIndices.data();
+    vmaBindBufferMemory2(_appContext->getAllocator(), buffer->getAllocation(), 0, alias,
+                         &deviceGroupBindInfo);
+    return alias;
+  };
+
+  _peerBufferAliases.resize(_peerBuildSemaphores.size());
+  for (uint32_t deviceIndex = 1; deviceIndex < _peerBufferAliases.size(); deviceIndex++) {
+    auto &aliases = _peerBufferAliases[deviceIndex];
+    if (aliases.chunkIndices == VK_NULL_HANDLE) {
+      aliases.chunkIndices = createAlias(_chunkIndicesBuffer.get(), deviceIndex);
+      aliases.chunkBounds  = createAlias(_chunkBoundsBuffer.get(), deviceIndex);
+    }
+    for (size_t page = aliases.octreePages.size(); page < _octreeBufferPages.size(); page++) {
+      aliases.octreePages.push_back(createAlias(_octreeBufferPages[page].get(), deviceIndex));
+    }
+  }
+}
+
+void SvoBuilder::_destroyPeerBufferAliases() {
+  VkDevice const device = _appContext->getDevice();
+  for (auto &aliases : _peerBufferAliases) {
+    for (auto &octreePage : aliases.octreePages) {
+      vkDestroyBuffer(device, octreePage, nullptr);
+    }
+    vkDestroyBuffer(device, aliases.chunkIndices, nullptr);
+    vkDestroyBuffer(device, aliases.chunkBounds, nullptr);
+  }
+  _peerBufferAliases.clear();
+}
+
+uint64_t SvoBuilder::_submitChunkBuildMerge(uint32_t slotIndex, uint32_t octreeBufferLength) {
+  auto &slot = _chunkBuildSlots[slotIndex];
+  // a whole build has been in between, so the previous merge of the slot is done already
+  _waitForTimelineValue(_appContext->getDevice(), _chunkSwapSemaphore, slot.mergeTimelineValue);
+  _createPeerBufferAliases();
+  auto const &aliases = _peerBufferAliases[slot.deviceIndex];
+
+  VkCommandBuffer cmdBuffer = slot.mergeCommandBuffer;
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+  // the octree lands ahead of its entry, like in the octree creation, so the frames never trace an
+  // entry whose octree isn't there yet
+  if (octreeBufferLength > 0) {
+    uint32_t const page           = slot.reservation.page;
+    VkBufferCopy const octreeCopy = {slot.reservation.region.offset(),
+                                     slot.reservation.region.offset(),
+                                     octreeBufferLength * sizeof(uint32_t)};
+    vkCmdCopyBuffer(cmdBuffer, aliases.octreePages[page], _octreeBufferPages[page]->getVkBuffer(),
+                    1, &octreeCopy);
+
+    VkMemoryBarrier copyBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    copyBarrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+    copyBarrier.dstAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 1, &copyBarrier, 0, nullptr, 0, nullptr);
+  }
+
+  uint32_t const linearIndex   = _getChunksBufferLinearIndex(slot.chunkIndex);
+  VkBufferCopy const entryCopy = {linearIndex * sizeof(ChunkIndicesEntry),
+                                  linearIndex * sizeof(ChunkIndicesEntry),
+                                  sizeof(ChunkIndicesEntry)};
+  vkCmdCopyBuffer(cmdBuffer, aliases.chunkIndices, _chunkIndicesBuffer->getVkBuffer(), 1,
+                  &entryCopy);
+  VkBufferCopy const boundsCopy = {linearIndex * sizeof(uint32_t), linearIndex * sizeof(uint32_t),
+                                   sizeof(uint32_t)};
+  vkCmdCopyBuffer(cmdBuffer, aliases.chunkBounds, _chunkBoundsBuffer->getVkBuffer(), 1,
+                  &boundsCopy);
+
+  vkEndCommandBuffer(cmdBuffer);
+
+  slot.mergeTimelineValue = ++_chunkSwapValue;
+  _submitWithTimelineSignal(_appContext, {cmdBuffer}, _chunkSwapSemaphore, slot.mergeTimelineValue);
+  return slot.mergeTimelineValue;
+}
+
+uint32_t SvoBuilder::_getFieldBrickTableLength() const {
+  uint32_t const brickGridDim =
+      (_configContainer->terrainInfo->chunkVoxelDim + kFieldBrickDim) / kFieldBrickDim;
+  return brickGridDim * brickGridDim * brickGridDim;
+}
+
+void SvoBuilder::_evictColdSavedFields() {
+  _finishSavedFieldEvictions();
+
+  size_t constexpr kMb = 1024 * 1024;
+  size_t const residentBudget =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->fieldBrickResidentBudgetMb) * kMb;
+
+  // the fields of the builds in flight are read and written by them, the ones being evicted
+  // already are counted as gone
+  size_t residentSize = 0;
+  std::vector<std::pair<uint64_t, ChunkIndex>> evictableFields{};
+  for (auto const &[chunkIndex, savedField] : _chunkIndexToSavedField) {
+    if (_pendingFieldEvictions.count(chunkIndex) != 0) {
+      continue;
+    }
+    residentSize += savedField.allocation.size();
+    if (!_isChunkInFlight(chunkIndex)) {
+      evictableFields.emplace_back(savedField.lastUse, chunkIndex);
+    }
+  }
+  if (residentSize <= residentBudget) {
+    return;
+  }
+
+  // the least recently used first
+  std::sort(evictableFields.begin(), evictableFields.end(),
+            [](auto const &a, auto const &b) { return a.first < b.first; });
+  auto *stagingRing  = _appContext->getStagingRing();
+  size_t evictedSize = 0;
+  for (auto const &[lastUse, chunkIndex] : evictableFields) {
+    if (residentSize - evictedSize <= residentBudget) {
+      break;
+    }
+    auto const &allocation = _chunkIndexToSavedField[chunkIndex].allocation;
+    auto copy              = std::make_shared<EvictedFieldCopy>();
+    bool const isRecorded  = stagingRing->readbackAsync(
+        _fieldBrickPoolBuffer->getVkBuffer(), allocation.offset(), allocation.size(),
+        [copy, size = allocation.size()](void const *data) {
+          auto const *field = static_cast<uint32_t const *>(data);
+          copy->field.assign(field, field + size / sizeof(uint32_t));
+          copy->isDone.store(true, std::memory_order_release);
+        });
+    // a field larger than the ring stays resident
+    if (!isRecorded) {
+      continue;
+    }
+    _pendingFieldEvictions[chunkIndex] = {lastUse, std::move(copy)};
+    evictedSize += allocation.size();
+  }
+
+  // the ring orders the copies after the builds that wrote the fields, and the later builds,
+  // which may reuse the freed bricks, after the copies
+  if (evictedSize > 0) {
+    stagingRing->submit();
+  }
+}
+
+void SvoBuilder::_finishSavedFieldEvictions() {
+  if (_pendingFieldEvictions.empty()) {
+    return;
+  }
+  _appContext->getStagingRing()->collect();
+
+  uint32_t evictedCount = 0;
+  size_t evictedSize    = 0;
+  for (auto it = _pendingFieldEvictions.begin(); it != _pendingFieldEvictions.end();) {
+    auto const &[chunkIndex, eviction] = *it;
+    if (!eviction.copy->isDone.load(std::memory_order_acquire)) {
+      it++;
+      continue;
+    }
+    // a field that was used, replaced or dropped meanwhile stays as it is
+    auto const savedField = _chunkIndexToSavedField.find(chunkIndex);
+    if (savedField != _chunkIndexToSavedField.end() &&
+        savedField->second.lastUse == eviction.lastUse) {
+      evictedCount++;
+      evictedSize += savedField->second.allocation.size();
+      _chunkIndexToEvictedField[chunkIndex] = std::move(eviction.copy->field);
+      _fieldBrickPoolMemoryAllocator->deallocate(savedField->second.allocation);
+      _chunkIndexToSavedField.erase(savedField);
+    }
+    it = _pendingFieldEvictions.erase(it);
+  }
+  if (evictedCount > 0) {
+    _logger->debug("{} saved chunk fields evicted to the host ({} kb)", evictedCount,
+                   evictedSize / 1024);
+  }
+}
+
+void SvoBuilder::_uploadEvictedSavedField(ChunkIndex const &chunkIndex) {
+  // the field is still saved while its eviction is in flight
+  _pendingFieldEvictions.erase(chunkIndex);
+  auto const evictedField = _chunkIndexToEvictedField.find(chunkIndex);
+  if (evictedField == _chunkIndexToEvictedField.end()) {
+    return;
+  }
+
+  // the fields loaded from a world may exceed the ring, so they're uploaded in parts
+  size_t const fieldSize         = evictedField->second.size() * sizeof(uint32_t);
+  auto const allocation          = _fieldBrickPoolMemoryAllocator->allocate(fieldSize);
+  auto const *fieldData          = reinterpret_cast<uint8_t const *>(evictedField->second.data());
+  VkDeviceSize const maxPartSize = StagingRing::getCapacity();
+  for (size_t offset = 0; offset < fieldSize; offset += maxPartSize) {
+    _appContext->getStagingRing()->upload(_fieldBrickPoolBuffer->getVkBuffer(), fieldData + offset,
+                                          std::min<VkDeviceSize>(maxPartSize, fieldSize - offset),
+                                          allocation.offset() + offset);
+  }
+
+  _chunkIndexToSavedField[chunkIndex] = {allocation, _savedFieldUseCount};
+  _chunkIndexToEvictedField.erase(evictedField);
+}
+
+void SvoBuilder::_createWorldRegionStore() {
+  auto const &worldName = _configContainer->svoBuilderInfo->worldName;
+  if (worldName.empty()) {
+    return;
+  }
+  if (!_configContainer->svoBuilderInfo->voxSceneFile.empty() && !_isStreamingChunks()) {
+    _logger->warn("the world {} isn't used, as the imported scene can't be edited", worldName);
+    return;
+  }
+  _worldRegionStore = std::make_unique<WorldRegionStore>(
+      _logger, kPathToResourceFolder + "worlds/" + worldName + "/",
+      _configContainer->terrainInfo->chunkVoxelDim, _makeWorldBuilderKey());
+
+  // a batch holds a full field at least, the octrees are left out if they don't fit
+  size_t constexpr kMb              = 1024 * 1024;
+  uint32_t constexpr kSaveBatchCount = 2;
+  size_t const fullFieldSize =
+      static_cast<size_t>(_getFieldBrickTableLength()) * (kFieldBrickLength + 1) * sizeof(uint32_t);
+  _worldSaveBatches.resize(kSaveBatchCount);
+  for (auto &batch : _worldSaveBatches) {
+    batch.readbackBuffer =
+        std::make_unique<Buffer>(_appContext, std::max(32 * kMb, fullFieldSize),
+                                 VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryStyle::kHostVisible);
+    VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    allocInfo.commandPool        = _buildCommandPool;
+    allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = 1;
+    vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &batch.commandBuffer);
+  }
+  _lastWorldSaveTime = std::chrono::steady_clock::now();
+}
+
+uint64_t SvoBuilder::_makeWorldBuilderKey() const {
+  // the chunks of a world are placed by their indices, so the window size doesn't matter
+  return ChunkOctreeCache::makeKey(_configContainer->terrainInfo->chunkVoxelDim, glm::uvec3(0),
+                                   _configContainer->terrainInfo->bakedNoiseOctaveCount,
+                                   *_configContainer->svoBuilderInfo,
+                                   ChunkOctreeCache::getBuilderShaderFolders(), "");
+}
+
+void SvoBuilder::_markWorldChunkDirty(ChunkIndex const &chunkIndex) {
+  if (_worldRegionStore != nullptr) {
+    _dirtyWorldChunks.insert(chunkIndex);
+  }
+}
+
+bool SvoBuilder::_isChunkOctreeCurrent(ChunkIndex const &chunkIndex) const {
+  bool const isMoving = std::any_of(
+      _inFlightOctreeMoves.begin(), _inFlightOctreeMoves.end(),
+      [&chunkIndex](OctreeMove const &move) { return move.chunkIndex == chunkIndex; });
+  return _chunkIndexToLod.find(chunkIndex) != _chunkIndexToLod.end() &&
+         !_isChunkInFlight(chunkIndex) && !isMoving &&
+         _pendingChunkEdits.find(chunkIndex) == _pendingChunkEdits.end() &&
+         std::find(_pendingChunkRestores.begin(), _pendingChunkRestores.end(), chunkIndex) ==
+             _pendingChunkRestores.end();
+}
+
+void SvoBuilder::_submitWorldSaveBatch(std::vector<ChunkIndex> &chunkIndices) {
+  auto &batch         = _worldSaveBatches[_nextWorldSaveBatch];
+  _nextWorldSaveBatch = (_nextWorldSaveBatch + 1) % _worldSaveBatches.size();
+  if (batch.writeTask != nullptr) {
+    TaskScheduler::get().wait(batch.writeTask);
+  }
+
+  // the resident fields and the octrees are copied into the readback buffer, the evicted fields
+  // are on the host already
+  struct StagedData {
+    size_t chunk;
+    bool isOctree;
+    size_t offset;
+    size_t size;
+  };
+  std::vector<std::pair<glm::ivec3, std::optional<WorldRegionStore::ChunkData>>> chunks{};
+  std::vector<StagedData> stagedData{};
+  std::vector<VkBufferCopy> fieldCopies{};
+  std::vector<std::pair<uint32_t, VkBufferCopy>> octreeCopies{};
+  size_t const capacity = batch.readbackBuffer->getSize();
+  size_t stagedSize     = 0;
+
+  size_t takenCount = 0;
+  for (; takenCount < chunkIndices.size(); takenCount++) {
+    ChunkIndex const &chunkIndex = chunkIndices[takenCount];
+    glm::ivec3 const chunkPos{chunkIndex.x, chunkIndex.y, chunkIndex.z};
+    auto const savedField   = _chunkIndexToSavedField.find(chunkIndex);
+    auto const evictedField = _chunkIndexToEvictedField.find(chunkIndex);
+    size_t const fieldSize =
+        savedField != _chunkIndexToSavedField.end() ? savedField->second.allocation.size() : 0;
+    if (stagedSize + fieldSize > capacity) {
+      break;
+    }
+
+    // a chunk that was undone back to the generated terrain is removed
+    if (savedField == _chunkIndexToSavedField.end() &&
+        evictedField == _chunkIndexToEvictedField.end()) {
+      chunks.emplace_back(chunkPos, std::nullopt);
+      continue;
+    }
+
+    WorldRegionStore::ChunkData chunkData{};
+    if (savedField != _chunkIndexToSavedField.end()) {
+      chunkData.field.resize(fieldSize / sizeof(uint32_t));
+      stagedData.push_back({chunks.size(), false, stagedSize, fieldSize});
+      fieldCopies.push_back({savedField->second.allocation.offset(), stagedSize, fieldSize});
+      stagedSize += fieldSize;
+    } else {
+      chunkData.field = evictedField->second;
+    }
+
+    // the octree is optional, without it the chunk is built from its field once it's loaded
+    if (_isChunkOctreeCurrent(chunkIndex)) {
+      auto const octree = _chunkIndexToBufferAllocResult.find(chunkIndex);
+      size_t const octreeSize =
+          octree != _chunkIndexToBufferAllocResult.end() ? octree->second.region.size() : 0;
+      if (stagedSize + octreeSize <= capacity) {
+        chunkData.hasOctree = true;
+        chunkData.lod       = _chunkIndexToLod.at(chunkIndex);
+        if (octreeSize > 0) {
+          chunkData.octree.resize(octreeSize / sizeof(uint32_t));
+          stagedData.push_back({chunks.size(), true, stagedSize, octreeSize});
+          octreeCopies.push_back(
+              {octree->second.page, {octree->second.region.offset(), stagedSize, octreeSize}});
+          stagedSize += octreeSize;
+        }
+      }
+    }
+    chunks.emplace_back(chunkPos, std::move(chunkData));
+  }
+  for (size_t i = 0; i < takenCount; i++) {
+    _dirtyWorldChunks.erase(chunkIndices[i]);
+  }
+  chunkIndices.erase(chunkIndices.begin(),
+                     chunkIndices.begin() + static_cast<std::ptrdiff_t>(takenCount));
+
+  VkCommandBuffer cmdBuffer = batch.commandBuffer;
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+  // the fields are written by the store passes, the octrees by the builds and the compaction
+  VkMemoryBarrier transferReadBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  transferReadBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  transferReadBarrier.dstAccessMask   = VK_ACCESS_TRANSFER_READ_BIT;
+  vkCmdPipelineBarrier(cmdBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &transferReadBarrier, 0, nullptr, 0,
+                       nullptr);
+  if (!fieldCopies.empty()) {
+    vkCmdCopyBuffer(cmdBuffer, _fieldBrickPoolBuffer->getVkBuffer(),
+                    batch.readbackBuffer->getVkBuffer(), static_cast<uint32_t>(fieldCopies.size()),
+                    fieldCopies.data());
+  }
+  for (auto const &[page, octreeCopy] : octreeCopies) {
+    vkCmdCopyBuffer(cmdBuffer, _octreeBufferPages[page]->getVkBuffer(),
+                    batch.readbackBuffer->getVkBuffer(), 1, &octreeCopy);
+  }
+
+  VkMemoryBarrier hostReadBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  hostReadBarrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+  hostReadBarrier.dstAccessMask   = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1,
+                       &hostReadBarrier, 0, nullptr, 0, nullptr);
+  vkEndCommandBuffer(cmdBuffer);
+
+  uint64_t const timelineValue = ++_chunkSwapValue;
+  _submitWithTimelineSignal(_appContext, {cmdBuffer}, _chunkSwapSemaphore, timelineValue);
+
+  // the compression and the file writes are left to a worker, the render thread never waits on
+  // them unless the ring is full
+  auto const *readbackData = static_cast<char const *>(batch.readbackBuffer->getMappedAddr());
+  batch.writeTask          = TaskScheduler::get().submitAfterTimelineValue(
+      _appContext->getDevice(), _chunkSwapSemaphore, timelineValue,
+      [store = _worldRegionStore.get(), readbackData, chunks = std::move(chunks),
+       stagedData = std::move(stagedData)]() mutable {
+        for (auto const &staged : stagedData) {
+          auto &chunkData = *chunks[staged.chunk].second;
+          auto &data      = staged.isOctree ? chunkData.octree : chunkData.field;
+          std::memcpy(data.data(), readbackData + staged.offset, staged.size);
+        }
+        store->writeChunks(chunks);
+      });
+}
+
+void SvoBuilder::_saveWorldChunks(std::vector<ChunkIndex> chunkIndices) {
+  if (_worldRegionStore == nullptr) {
+    return;
+  }
+  while (!chunkIndices.empty()) {
+    _submitWorldSaveBatch(chunkIndices);
+  }
+}
+
+void SvoBuilder::saveWorld() {
+  if (_worldRegionStore == nullptr) {
+    return;
+  }
+  _saveWorldChunks({_dirtyWorldChunks.begin(), _dirtyWorldChunks.end()});
+  for (auto const &batch : _worldSaveBatches) {
+    if (batch.writeTask != nullptr) {
+      TaskScheduler::get().wait(batch.writeTask);
+    }
+  }
+  _lastWorldSaveTime = std::chrono::steady_clock::now();
+}
+
+void SvoBuilder::_updateWorldSave() {
+  uint32_t const saveIntervalSec = _configContainer->svoBuilderInfo->worldSaveIntervalSec;
+  if (_worldRegionStore == nullptr || _dirtyWorldChunks.empty() || saveIntervalSec == 0) {
+    return;
+  }
+  auto const now = std::chrono::steady_clock::now();
+  if (now - _lastWorldSaveTime < std::chrono::seconds(saveIntervalSec)) {
+    return;
+  }
+
+  // a busy batch is left for a later frame rather than waited on
+  auto const &batch = _worldSaveBatches[_nextWorldSaveBatch];
+  if (batch.writeTask != nullptr && !batch.writeTask->isDone) {
+    return;
+  }
+
+  // the fields of the builds in flight are about to be replaced
+  std::vector<ChunkIndex> chunkIndices{};
+  for (auto const &chunkIndex : _dirtyWorldChunks) {
+    if (!_isChunkInFlight(chunkIndex)) {
+      chunkIndices.push_back(chunkIndex);
+    }
+  }
+  if (chunkIndices.empty()) {
+    return;
+  }
+  // the rest goes with the next frames, the interval starts over once every chunk is written
+  _submitWorldSaveBatch(chunkIndices);
+  if (_dirtyWorldChunks.empty()) {
+    _lastWorldSaveTime = now;
+  }
+}
+
+void SvoBuilder::_requestWorldChunks(std::vector<ChunkIndex> const &chunkIndices) {
+  if (_worldRegionStore == nullptr || chunkIndices.empty()) {
+    return;
+  }
+  std::vector<TaskScheduler::TaskHandle> writeTasks{};
+  for (auto const &batch : _worldSaveBatches) {
+    if (batch.writeTask != nullptr) {
+      writeTasks.push_back(batch.writeTask);
+    }
+  }
+  std::vector<glm::ivec3> chunkPositions{};
+  chunkPositions.reserve(chunkIndices.size());
+  for (auto const &chunkIndex : chunkIndices) {
+    chunkPositions.emplace_back(chunkIndex.x, chunkIndex.y, chunkIndex.z);
+  }
+
+  // the finished loads are dropped, they have handed their chunks over already
+  _worldLoadTasks.erase(std::remove_if(_worldLoadTasks.begin(), _worldLoadTasks.end(),
+                                       [](auto const &task) { return task->isDone.load(); }),
+                        _worldLoadTasks.end());
+  _worldLoadTasks.push_back(TaskScheduler::get().submit(
+      [this, chunkPositions = std::move(chunkPositions)]() {
+        auto loadedChunks = _worldRegionStore->readChunks(chunkPositions);
+        std::lock_guard<std::mutex> lock(_loadedWorldChunksMutex);
+        std::move(loadedChunks.begin(), loadedChunks.end(),
+                  std::back_inserter(_loadedWorldChunks));
+      },
+      writeTasks));
+}
+
+void SvoBuilder::_applyLoadedWorldChunks(size_t uploadBudget,
+                                         std::chrono::steady_clock::time_point deadline) {
+  {
+    std::lock_guard<std::mutex> lock(_loadedWorldChunksMutex);
+    std::move(_loadedWorldChunks.begin(), _loadedWorldChunks.end(),
+              std::back_inserter(_pendingWorldChunks));
+    _loadedWorldChunks.clear();
+  }
+  // the octrees are written to the entries of the window, just like the edits
+  if (_pendingWorldChunks.empty() || !_isChunkWindowSettled() || !_inFlightOctreeMoves.empty()) {
+    return;
+  }
+
+  // the chunks the camera is expected to see first are uploaded first
+  std::vector<std::pair<float, size_t>> chunkOrder{};
+  chunkOrder.reserve(_pendingWorldChunks.size());
+  for (size_t i = 0; i < _pendingWorldChunks.size(); i++) {
+    glm::ivec3 const chunkPos = _pendingWorldChunks[i].first;
+    chunkOrder.emplace_back(_getTimeToVisibility({chunkPos.x, chunkPos.y, chunkPos.z}), i);
+  }
+  std::sort(chunkOrder.begin(), chunkOrder.end());
+  std::vector<std::pair<glm::ivec3, WorldRegionStore::ChunkData>> orderedChunks{};
+  orderedChunks.reserve(chunkOrder.size());
+  for (auto const &[timeToVisibility, chunk] : chunkOrder) {
+    orderedChunks.push_back(std::move(_pendingWorldChunks[chunk]));
+  }
+  _pendingWorldChunks = std::move(orderedChunks);
+
+  auto *stagingRing     = _appContext->getStagingRing();
+  auto const framesLeft = static_cast<uint32_t>(_configContainer->applicationInfo->framesInFlight);
+  size_t uploadedSize   = 0;
+  std::vector<std::pair<glm::ivec3, WorldRegionStore::ChunkData>> deferredChunks{};
+  std::vector<ChunkIndex> swappedChunks{};
+  for (auto &[chunkPos, chunkData] : _pendingWorldChunks) {
+    ChunkIndex const chunkIndex{chunkPos.x, chunkPos.y, chunkPos.z};
+    // the chunks that have left the window meanwhile are loaded again once they're back, and the
+    // ones that are edited since they entered are newer than their saves
+    if (!_isInChunkWindow(chunkIndex, _chunkWindowOrigin) ||
+        _dirtyWorldChunks.find(chunkIndex) != _dirtyWorldChunks.end() ||
+        _chunkIndexToSavedField.find(chunkIndex) != _chunkIndexToSavedField.end() ||
+        _chunkIndexToEvictedField.find(chunkIndex) != _chunkIndexToEvictedField.end() ||
+        _pendingChunkEdits.find(chunkIndex) != _pendingChunkEdits.end()) {
+      continue;
+    }
+    size_t const octreeSize = chunkData.octree.size() * sizeof(uint32_t);
+    if (_isChunkInFlight(chunkIndex) || uploadedSize + octreeSize > uploadBudget ||
+        std::chrono::steady_clock::now() > deadline) {
+      deferredChunks.emplace_back(chunkPos, std::move(chunkData));
+      continue;
+    }
+
+    _chunkIndexToEvictedField[chunkIndex] = std::move(chunkData.field);
+    bool const isOctreeValid = chunkData.hasOctree && chunkData.lod < _chunkLodCount &&
+                               octreeSize <= std::min(_octreePageSize, stagingRing->getCapacity());
+    std::optional<OctreeAllocation> allocation{};
+    if (isOctreeValid && octreeSize > 0) {
+      allocation = _allocateOctreeRegion(octreeSize);
+      if (!stagingRing->upload(_octreeBufferPages[allocation->page]->getVkBuffer(),
+                               chunkData.octree.data(), octreeSize,
+                               allocation->region.offset())) {
+        _deallocateOctreeRegion(*allocation);
+        allocation.reset();
+      }
+    }
+    bool const isUploaded = isOctreeValid && (octreeSize == 0 || allocation.has_value());
+    if (!isUploaded) {
+      if (std::find(_pendingChunkRestores.begin(), _pendingChunkRestores.end(), chunkIndex) ==
+          _pendingChunkRestores.end()) {
+        _pendingChunkRestores.push_back(chunkIndex);
+      }
+      continue;
+    }
+
+    ChunkIndicesEntry chunkIndicesEntry{0};
+    if (allocation.has_value()) {
+      chunkIndicesEntry = _makeChunkIndicesEntry(allocation->page, chunkData.lod,
+                                                 allocation->region.offset() / sizeof(uint32_t));
+    }
+    stagingRing->upload(_chunkIndicesBuffer->getVkBuffer(), &chunkIndicesEntry,
+                        sizeof(ChunkIndicesEntry),
+                        _getChunksBufferLinearIndex(chunkIndex) * sizeof(ChunkIndicesEntry));
+    // the stored chunks have no bounds, the bounds of the replaced octree mustn't clip them
+    uint32_t const chunkBounds = 0;
+    stagingRing->upload(_chunkBoundsBuffer->getVkBuffer(), &chunkBounds, sizeof(uint32_t),
+                        _getChunksBufferLinearIndex(chunkIndex) * sizeof(uint32_t));
+    uploadedSize += octreeSize;
+
+    // the frames in flight might still be tracing the generated octree
+    auto const replaced = _chunkIndexToBufferAllocResult.find(chunkIndex);
+    if (replaced != _chunkIndexToBufferAllocResult.end()) {
+      _retiredAllocations.push_back({replaced->second, framesLeft});
+      _chunkIndexToBufferAllocResult.erase(replaced);
+    }
+    if (allocation.has_value()) {
+      _chunkIndexToBufferAllocResult[chunkIndex] = *allocation;
+    }
+    _chunkIndexToLod[chunkIndex] = chunkData.lod;
+    _pendingChunkBuilds.erase(
+        std::remove(_pendingChunkBuilds.begin(), _pendingChunkBuilds.end(), chunkIndex),
+        _pendingChunkBuilds.end());
+    swappedChunks.push_back(chunkIndex);
+  }
+  _pendingWorldChunks = std::move(deferredChunks);
+  if (swappedChunks.empty()) {
+    return;
+  }
+
+  // the uploads are made visible to the renderer like any other swap
+  uint64_t const timelineValue = ++_chunkSwapValue;
+  _submitWithTimelineSignal(_appContext, {}, _chunkSwapSemaphore, timelineValue);
+  for (auto const &chunkIndex : swappedChunks) {
+    _swappedChunks.emplace_back(timelineValue,
+                                glm::ivec3(chunkIndex.x, chunkIndex.y, chunkIndex.z));
+  }
+  _octreeBufferMayHaveHoles = true;
+  _logger->debug("{} chunks loaded from the world ({} kb)", swappedChunks.size(),
+                 uploadedSize / 1024);
+}
+
+void SvoBuilder::_loadWorldWindow() {
+  if (_worldRegionStore == nullptr) {
+    return;
+  }
+  TaskScheduler::get().wait(_worldLoadTasks);
+  _worldLoadTasks.clear();
+  _applyLoadedWorldChunks(std::numeric_limits<size_t>::max());
+}
+
+void SvoBuilder::_recordChunkVoxelizationCommands(uint32_t slotIndex, bool applyEdit,
+                                                  bool loadSavedField, bool isFieldBatched) {
+  auto &slot                = _chunkBuildSlots[slotIndex];
+  VkCommandBuffer cmdBuffer = slot.voxelizationCommandBuffer;
+  uint32_t const fieldDim   = (_configContainer->terrainInfo->chunkVoxelDim >> slot.lod) + 1;
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+  _chunkBuildProfiler->recordReset(cmdBuffer, slotIndex);
+  _recordBufferDataResetForNewChunkGeneration(cmdBuffer, slotIndex, slot.chunkIndex);
+
+  // construct field image, in editing mode, expand the saved field bricks if possible, caching
+  // this doesn't offer performance boost, the field of a batched build is made available by the
+  // batch, and left out of the stats
+  if (!isFieldBatched) {
+    _chunkBuildProfiler->recordStageBegin(cmdBuffer, slotIndex,
+                                          ChunkBuildProfiler::kFieldConstruction);
+    if (loadSavedField) {
+      _chunkFieldBrickLoadPipeline->recordCommand(cmdBuffer, slotIndex, fieldDim, fieldDim,
+                                                  fieldDim);
+    } else {
+      _chunkFieldConstructionPipeline->recordCommand(cmdBuffer, slotIndex, fieldDim, fieldDim,
+                                                     fieldDim);
+    }
+    _chunkBuildProfiler->recordStageEnd(cmdBuffer, slotIndex,
+                                        ChunkBuildProfiler::kFieldConstruction);
+    _recordShaderAccessBarrier(cmdBuffer);
+  }
+
+  if (applyEdit) {
+    // edit field image, only the field points of the region are touched
+    _chunkBuildProfiler->recordStageBegin(cmdBuffer, slotIndex,
+                                          ChunkBuildProfiler::kFieldModification);
+    _chunkFieldModificationPipeline->recordCommand(cmdBuffer, slotIndex, slot.regionExtent.x + 1,
+                                                   slot.regionExtent.y + 1,
+                                                   slot.regionExtent.z + 1);
+    _chunkBuildProfiler->recordStageEnd(cmdBuffer, slotIndex,
+                                        ChunkBuildProfiler::kFieldModification);
+    _recordShaderAccessBarrier(cmdBuffer);
+  }
+
+  // save the edited field as bricks, the voxel creation only reads the field image as well, so
+  // they don't need a barrier in between, the previews leave the saved field to their full builds
+  if (slot.isStoringField) {
+    uint32_t const brickThreadDim =
+        (fieldDim + kFieldBrickDim - 1) / kFieldBrickDim * kFieldBrickDim;
+    _chunkBuildProfiler->recordStageBegin(cmdBuffer, slotIndex,
+                                          ChunkBuildProfiler::kFieldBrickStore);
+    _chunkFieldBrickStorePipeline->recordCommand(cmdBuffer, slotIndex, brickThreadDim,
+                                                 brickThreadDim, brickThreadDim);
+    _chunkBuildProfiler->recordStageEnd(cmdBuffer, slotIndex, ChunkBuildProfiler::kFieldBrickStore);
+  }
+
+  // the saved fragments outside of the region are still valid, both passes append to the fragment
+  // list atomically, so they don't need a barrier in between
+  _chunkBuildProfiler->recordStageBegin(cmdBuffer, slotIndex, ChunkBuildProfiler::kVoxelCreation);
+  if (slot.fragmentListSaveInfo.loadCount > 0) {
+    _chunkFragmentListLoadPipeline->recordCommand(cmdBuffer, slotIndex,
+                                                  slot.fragmentListSaveInfo.loadCount, 1, 1);
+  }
+
+  // construct voxels of the region into fragmentlist buffer
+  _chunkVoxelCreationPipeline->recordCommand(cmdBuffer, slotIndex, slot.regionExtent.x,
+                                             slot.regionExtent.y, slot.regionExtent.z);
+  _chunkBuildProfiler->recordStageEnd(cmdBuffer, slotIndex, ChunkBuildProfiler::kVoxelCreation);
+  _recordShaderAccessBarrier(cmdBuffer);
+
+  // keep the fragment list of the edited chunk for the next edit, the fragment count tells the
+  // host whether it fitted, it's read back by the octree creation
+  bool const isStoringFragmentList = slot.fragmentListSaveInfo.storeCapacity > 0;
+  if (isStoringFragmentList) {
+    _chunkBuildProfiler->recordStageBegin(cmdBuffer, slotIndex,
+                                          ChunkBuildProfiler::kFragmentListStore);
+    _chunkFragmentListStorePipeline->recordCommand(cmdBuffer, slotIndex,
+                                                   kGridStrideCopyThreadCount, 1, 1);
+    _chunkBuildProfiler->recordStageEnd(cmdBuffer, slotIndex,
+                                        ChunkBuildProfiler::kFragmentListStore);
+  }
+
+  // the host shrinks the reservation of the saved field to the count
+  if (slot.isStoringField) {
+    VkMemoryBarrier transferReadBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    transferReadBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+    transferReadBarrier.dstAccessMask   = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &transferReadBarrier, 0, nullptr, 0,
+                         nullptr);
+    VkBufferCopy brickCountCopy = {offsetof(G_FieldBrickSaveInfo, brickCount),
+                                   2 * sizeof(uint32_t), sizeof(uint32_t)};
+    vkCmdCopyBuffer(cmdBuffer, _fieldBrickSaveInfoBufferBundle->getBuffer(slotIndex)->getVkBuffer(),
+                    _octreeBufferLengthReadbackBufferBundle->getBuffer(slotIndex)->getVkBuffer(),
+                    1, &brickCountCopy);
+  }
+
+  vkEndCommandBuffer(cmdBuffer);
+}
+
+void SvoBuilder::_recordChunkFragmentUploadCommands(uint32_t slotIndex) {
+  auto &slot                = _chunkBuildSlots[slotIndex];
+  VkCommandBuffer cmdBuffer = slot.voxelizationCommandBuffer;
+
+  auto const &fragmentList =
+      _voxData->chunkFragmentLists[_getChunksBufferLinearIndex(slot.chunkIndex)];
+  slot.importedFragmentCount = static_cast<uint32_t>(fragmentList.size());
+
+  // the slot is idle, so the gpu is done with its staging buffer, the coarser levels merge the
+  // fragments that end up in the same voxel during the octree creation
+  Buffer *stagingBuffer = _fragmentListStagingBufferBundle->getBuffer(slotIndex);
+  if (slot.lod == 0) {
+    std::memcpy(stagingBuffer->getMappedAddr(), fragmentList.data(),
+                fragmentList.size() * sizeof(G_FragmentListEntry));
+  } else {
+    uint32_t constexpr kCoordinateMask = 0x3FF;
+
+    auto *stagedFragments = static_cast<G_FragmentListEntry *>(stagingBuffer->getMappedAddr());
+    for (size_t i = 0; i < fragmentList.size(); i++) {
+      uint32_t const coordinates = fragmentList[i].coordinates;
+      uint32_t const x           = (coordinates & kCoordinateMask) >> slot.lod;
+      uint32_t const y           = ((coordinates >> 10) & kCoordinateMask) >> slot.lod;
+      uint32_t const z           = ((coordinates >> 20) & kCoordinateMask) >> slot.lod;
+
+      stagedFragments[i].coordinates = x | (y << 10) | (z << 20);
+      stagedFragments[i].properties  = fragmentList[i].properties;
+    }
+  }
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+  _chunkBuildProfiler->recordReset(cmdBuffer, slotIndex);
+  _chunkBuildProfiler->recordStageBegin(cmdBuffer, slotIndex, ChunkBuildProfiler::kFragmentUpload);
+  VkBufferCopy fragmentListCopy = {0, 0, fragmentList.size() * sizeof(G_FragmentListEntry)};
+  vkCmdCopyBuffer(cmdBuffer, stagingBuffer->getVkBuffer(),
+                  _fragmentListBufferBundle->getBuffer(slotIndex)->getVkBuffer(), 1,
+                  &fragmentListCopy);
+  _chunkBuildProfiler->recordStageEnd(cmdBuffer, slotIndex, ChunkBuildProfiler::kFragmentUpload);
+
+  // the reset writes the fragment count of the slot, its trailing barrier covers the copy as well
+  _recordBufferDataResetForNewChunkGeneration(cmdBuffer, slotIndex, slot.chunkIndex);
+
+  vkEndCommandBuffer(cmdBuffer);
+}
+
+void SvoBuilder::_loadVoxScene() {
+  uint32_t const chunkVoxelDim = _configContainer->terrainInfo->chunkVoxelDim;
+  std::string const pathToVoxScene =
+      kPathToResourceFolder + "models/vox/" + _configContainer->svoBuilderInfo->voxSceneFile;
+
+  _voxData = std::make_unique<VoxData>(
+      VoxLoader::fetchDataFromFile(pathToVoxScene, chunkVoxelDim, getChunksDim(), _logger,
+                                   _configContainer->svoBuilderInfo->voxPrefabMinInstanceCount));
+
+  // overlapping instances can emit a voxel twice, which could overflow the fragment list
+  size_t maxFragmentCount = 1;
+  for (auto const &fragmentList : _voxData->chunkFragmentLists) {
+    maxFragmentCount = std::max(maxFragmentCount, fragmentList.size());
+  }
+  if (maxFragmentCount > static_cast<size_t>(chunkVoxelDim) * chunkVoxelDim * chunkVoxelDim) {
+    _logger->error("an imported chunk has {} fragments, more than the fragment list can hold",
+                   maxFragmentCount);
+    exit(0);
+  }
+
+  _fragmentListStagingBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, maxFragmentCount * sizeof(G_FragmentListEntry),
+      VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryStyle::kHostVisible);
+
+  // the uploaded fragments skip the voxelization, so the lists have to hold them from the start
+  if (maxFragmentCount > _fragmentListCapacity) {
+    _resizeFragmentListBuffers(static_cast<uint32_t>(maxFragmentCount));
+  }
+}
+
+void SvoBuilder::_uploadPrefabInstances() {
+  auto const uploadStart       = std::chrono::steady_clock::now();
+  uint32_t const chunkVoxelDim = _configContainer->terrainInfo->chunkVoxelDim;
+  auto const &chunksDim        = getChunksDim();
+  auto const &prefabs          = _voxData->prefabs;
+
+  // every prefab is built once, and optimized like the chunks of the scene
+  std::vector<std::vector<uint32_t>> prefabOctrees(prefabs.size());
+  TaskScheduler::get().parallelFor(prefabs.size(), [&](size_t prefabIndex, uint32_t) {
+    auto const &prefab = prefabs[prefabIndex];
+    auto octree        = CpuSvoBuilder::buildOctree(prefab.fragments, prefab.voxelResolution);
+    if (!octree.empty() && _configContainer->svoBuilderInfo->deduplicateChunkOctrees) {
+      octree = OctreeDag::deduplicate(octree.data(), octree.size());
+    }
+    if (!octree.empty() && _configContainer->svoBuilderInfo->reorderChunkOctrees) {
+      octree = OctreeLayout::reorderForTraversal(octree.data(), octree.size(),
+                                                 OctreeLayout::kBreadthFirstLevelCount);
+    }
+    prefabOctrees[prefabIndex] = std::move(octree);
+  });
+
+  std::vector<std::pair<OctreeAllocation, std::vector<uint32_t>>> pageWrites{};
+  std::vector<std::optional<OctreeAllocation>> prefabAllocations(prefabs.size());
+  size_t prefabOctreeSize = 0;
+  for (size_t prefabIndex = 0; prefabIndex < prefabs.size(); prefabIndex++) {
+    auto &octree = prefabOctrees[prefabIndex];
+    if (octree.empty()) {
+      continue;
+    }
+    prefabOctreeSize += octree.size() * sizeof(uint32_t);
+    prefabAllocations[prefabIndex] = _allocateOctreeRegion(octree.size() * sizeof(uint32_t));
+    pageWrites.emplace_back(*prefabAllocations[prefabIndex], std::move(octree));
+  }
+
+  // an instance is listed by every chunk that its model overlaps, the chunks clip the rays to
+  // themselves, so an instance is never hit out of the order of the chunks
+  std::unordered_map<ChunkIndex, std::vector<uint32_t>, ChunkIndexHash> chunkInstanceTables{};
+  uint32_t droppedInstanceCount = 0;
+  for (auto const &instance : _voxData->prefabInstances) {
+    auto const &prefab     = prefabs[instance.prefabIndex];
+    auto const &allocation = prefabAllocations[instance.prefabIndex];
+    if (!allocation.has_value()) {
+      continue;
+    }
+
+    glm::vec3 const position = glm::vec3(_chunkWindowOrigin) +
+                               glm::vec3(instance.voxelPos) / static_cast<float>(chunkVoxelDim);
+    float const size =
+        static_cast<float>(prefab.voxelResolution) / static_cast<float>(chunkVoxelDim);
+    std::array<uint32_t, kOctreeInstanceLength> const record{
+        glm::floatBitsToUint(position.x),
+        glm::floatBitsToUint(position.y),
+        glm::floatBitsToUint(position.z),
+        glm::floatBitsToUint(size),
+        allocation->page,
+        static_cast<uint32_t>(allocation->region.offset() / sizeof(uint32_t))};
+
+    glm::ivec3 const minChunk = glm::ivec3(instance.voxelPos / chunkVoxelDim);
+    glm::ivec3 const maxChunk =
+        glm::min(glm::ivec3((instance.voxelPos + prefab.dim - 1U) / chunkVoxelDim),
+                 glm::ivec3(chunksDim) - 1);
+    for (int32_t z = minChunk.z; z <= maxChunk.z; z++) {
+      for (int32_t y = minChunk.y; y <= maxChunk.y; y++) {
+        for (int32_t x = minChunk.x; x <= maxChunk.x; x++) {
+          auto &table = chunkInstanceTables[ChunkIndex{_chunkWindowOrigin.x + x,
+                                                       _chunkWindowOrigin.y + y,
+                                                       _chunkWindowOrigin.z + z}];
+          if (table.size() / kOctreeInstanceLength == kMaxChunkInstanceCount) {
+            droppedInstanceCount++;
+            continue;
+          }
+          table.insert(table.end(), record.begin(), record.end());
+        }
+      }
+    }
+  }
+  if (droppedInstanceCount > 0) {
+    _logger->warn("{} prefab instances are dropped from the chunks that hold more than {}",
+                  droppedInstanceCount, kMaxChunkInstanceCount);
+  }
+
+  std::vector<glm::uvec2> chunkInstancesEntries(chunksDim.x * chunksDim.y * chunksDim.z,
+                                                glm::uvec2{0});
+  size_t instanceTableSize = 0;
+  for (auto &[chunkIndex, table] : chunkInstanceTables) {
+    auto const instanceCount = static_cast<uint32_t>(table.size() / kOctreeInstanceLength);
+    auto const allocation    = _allocateOctreeRegion(table.size() * sizeof(uint32_t));
+    chunkInstancesEntries[_getChunksBufferLinearIndex(chunkIndex)] = {
+        static_cast<uint32_t>(allocation.region.offset() / sizeof(uint32_t)),
+        (allocation.page << kChunkInstanceCountBitCount) | instanceCount};
+    instanceTableSize += table.size() * sizeof(uint32_t);
+    _instancedChunks.push_back(chunkIndex);
+    pageWrites.emplace_back(allocation, std::move(table));
+  }
+
+  // a whole page is written at once, like the optimization of the scene right before
+  std::vector<uint32_t> pageData(_octreePageSize / sizeof(uint32_t));
+  for (uint32_t page = 0; page < _octreeBufferPages.size(); page++) {
+    bool const isPageWritten =
+        std::any_of(pageWrites.begin(), pageWrites.end(),
+                    [page](auto const &pageWrite) { return pageWrite.first.page == page; });
+    if (!isPageWritten) {
+      continue;
+    }
+    _octreeBufferPages[page]->fetchData(pageData.data());
+    for (auto const &[allocation, data] : pageWrites) {
+      if (allocation.page == page) {
+        std::copy(data.begin(), data.end(),
+                  pageData.begin() + allocation.region.offset() / sizeof(uint32_t));
+      }
+    }
+    _octreeBufferPages[page]->fillData(pageData.data());
+  }
+  _chunkInstancesBuffer->fillData(chunkInstancesEntries.data());
+
+  size_t constexpr kKb = 1024;
+  auto const uploadTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                std::chrono::steady_clock::now() - uploadStart)
+                                .count();
+  _logger->info("{} prefab octrees of {} kb, {} instances in the tables of {} chunks of {} kb, "
+                "uploaded in {} ms",
+                prefabs.size(), prefabOctreeSize / kKb, _voxData->prefabInstances.size(),
+                chunkInstanceTables.size(), instanceTableSize / kKb, uploadTimeMs);
+}
+
+std::optional<glm::uvec2> SvoBuilder::uploadObjectOctree(std::vector<uint32_t> const &octree) {
+  auto *stagingRing       = _appContext->getStagingRing();
+  size_t const octreeSize = octree.size() * sizeof(uint32_t);
+  if (octreeSize == 0 || octreeSize > std::min(_octreePageSize, stagingRing->getCapacity())) {
+    return std::nullopt;
+  }
+
+  // unlike the prefabs, the pages aren't written as a whole, the builds in flight write them too
+  auto const allocation = _allocateOctreeRegion(octreeSize);
+  if (!stagingRing->upload(_octreeBufferPages[allocation.page]->getVkBuffer(), octree.data(),
+                           octreeSize, allocation.region.offset())) {
+    _deallocateOctreeRegion(allocation);
+    return std::nullopt;
+  }
+  stagingRing->waitIdle();
+  return glm::uvec2{allocation.page,
+                    static_cast<uint32_t>(allocation.region.offset() / sizeof(uint32_t))};
+}
+
+void SvoBuilder::_decideDirtyRegion(ChunkBuildSlot &slot) const {
+  auto const voxelDim = static_cast<int>(_configContainer->terrainInfo->chunkVoxelDim);
+  glm::vec3 const chunkPos{slot.chunkIndex.x, slot.chunkIndex.y, slot.chunkIndex.z};
+
+  glm::ivec3 regionMin{voxelDim};
+  glm::ivec3 regionMax{0};
+  for (uint32_t i = 0; i < slot.editingBatch.stampCount; i++) {
+    auto const &stamp        = slot.editingBatch.stamps[i];
+    glm::vec3 const reach    = _getEditingReach(stamp);
+    glm::vec3 const localMin = (stamp.pos - reach - chunkPos) * static_cast<float>(voxelDim);
+    glm::vec3 const localMax = (stamp.pos + reach - chunkPos) * static_cast<float>(voxelDim);
+
+    // field points sit half a voxel off the voxel grid, and a voxel is affected by all of its 8
+    // corners, so the region is padded by one voxel on both sides
+    regionMin = glm::min(regionMin, glm::ivec3(glm::floor(localMin)) - 1);
+    regionMax = glm::max(regionMax, glm::ivec3(glm::ceil(localMax)) + 2);
+  }
+
+  regionMin = glm::clamp(regionMin, glm::ivec3{0}, glm::ivec3{voxelDim});
+  regionMax = glm::clamp(regionMax, regionMin, glm::ivec3{voxelDim});
+
+  slot.regionOffset = glm::uvec3(regionMin);
+  slot.regionExtent = glm::uvec3(regionMax - regionMin);
+}
+
+void SvoBuilder::_submitChunkBuild(uint32_t slotIndex, ChunkIndex chunkIndex, bool isEditing,
+                                   uint32_t reservedOctreeLength, bool isFieldBatched) {
+  auto &slot                = _chunkBuildSlots[slotIndex];
+  slot.chunkIndex           = chunkIndex;
+  slot.isEditing            = isEditing;
+  slot.fragmentListCapacity = _fragmentListCapacity;
+  slot.startTime            = std::chrono::steady_clock::now();
+
+  // a retry is the only case that passes an explicit length, the saved field of a retried edit
+  // already has the edit applied to it
+  bool const isRetry = reservedOctreeLength != 0;
+
+  // an evicted field is brought back before anything reads it
+  _uploadEvictedSavedField(chunkIndex);
+  auto const savedField    = _chunkIndexToSavedField.find(chunkIndex);
+  bool const hasSavedField = savedField != _chunkIndexToSavedField.end();
+  if (hasSavedField) {
+    savedField->second.lastUse = ++_savedFieldUseCount;
+  }
+
+  // a retry keeps the level its length was measured at, the field is only saved at full detail
+  if (!isRetry) {
+    if (slot.isPreview) {
+      slot.lod = _getEditPreviewLod();
+    } else {
+      slot.lod = isEditing || hasSavedField ? 0 : _decideChunkLod(chunkIndex);
+    }
+  }
+
+  // the octree length is unknown until the build is finished, so a speculative reservation is
+  // made, the gpu writes the octree right into it, and the tail is given back afterwards
+  if (!isRetry) {
+    reservedOctreeLength = _octreeLengthEstimate;
+  }
+  slot.reservation = _allocateOctreeRegion(reservedOctreeLength * sizeof(uint32_t));
+
+  auto const savedFragmentList = _chunkIndexToFragmentListAllocResult.find(chunkIndex);
+
+  // an edit only regenerates the fragments of its dirty region if the field and the fragment list
+  // are both saved from the previous edit, retries, first edits and previews voxelize the whole
+  // chunk, the saved fragments are at full detail
+  bool const applyEdit     = isEditing && !isRetry;
+  bool const isIncremental = applyEdit && !slot.isPreview && hasSavedField &&
+                             savedFragmentList != _chunkIndexToFragmentListAllocResult.end();
+
+  uint32_t const voxelDim      = _configContainer->terrainInfo->chunkVoxelDim >> slot.lod;
+  slot.regionOffset            = glm::uvec3{0};
+  slot.regionExtent            = glm::uvec3{voxelDim};
+  slot.fragmentListSaveInfo    = {};
+  slot.fragmentListReservation = {};
+  if (isIncremental) {
+    _decideDirtyRegion(slot);
+    slot.fragmentListSaveInfo.loadOffset =
+        savedFragmentList->second.offset() / sizeof(G_FragmentListEntry);
+    slot.fragmentListSaveInfo.loadCount =
+        savedFragmentList->second.size() / sizeof(G_FragmentListEntry);
+  }
+
+  // the new fragments are bounded by the voxels of the region, or by the estimate of the whole
+  // chunk, saving is optional, so it's skipped if the pool is full
+  if (isEditing && !slot.isPreview) {
+    uint32_t const regionVoxelCount =
+        slot.regionExtent.x * slot.regionExtent.y * slot.regionExtent.z;
+    uint32_t const storeCapacity =
+        slot.fragmentListSaveInfo.loadCount + std::min(regionVoxelCount, _fragmentCountEstimate);
+    if (_fragmentListMemoryAllocator->canAllocate(storeCapacity * sizeof(G_FragmentListEntry))) {
+      slot.fragmentListReservation =
+          _fragmentListMemoryAllocator->allocate(storeCapacity * sizeof(G_FragmentListEntry));
+      slot.fragmentListSaveInfo.storeOffset =
+          slot.fragmentListReservation.offset() / sizeof(G_FragmentListEntry);
+      slot.fragmentListSaveInfo.storeCapacity = storeCapacity;
+    }
+  }
+
+  // the bricks of the edited field are unknown until the store pass is done, so the reservation
+  // fits every brick of the field, and is shrunk to the stored ones afterwards, unlike the fragment
+  // list, the field has to be saved, since the edit is only kept in there
+  slot.isStoringField     = applyEdit && !slot.isPreview;
+  slot.fieldBrickSaveInfo = {};
+  if (hasSavedField) {
+    slot.fieldBrickSaveInfo.loadTableOffset =
+        savedField->second.allocation.offset() / sizeof(uint32_t);
+  }
+  if (slot.isStoringField) {
+    size_t const fullFieldSize = static_cast<size_t>(_getFieldBrickTableLength()) *
+                                 (kFieldBrickLength + 1) * sizeof(uint32_t);
+    slot.fieldBrickReservation = _fieldBrickPoolMemoryAllocator->allocate(fullFieldSize);
+    slot.fieldBrickSaveInfo.storeTableOffset =
+        slot.fieldBrickReservation.offset() / sizeof(uint32_t);
+  }
+
+  slot.importedFragmentCount = 0;
+  if (_voxData != nullptr) {
+    _recordChunkFragmentUploadCommands(slotIndex);
+  } else {
+    _recordChunkVoxelizationCommands(slotIndex, applyEdit, hasSavedField, isFieldBatched);
+  }
+
+  std::vector<VkCommandBuffer> const cmdBuffers = {
+      slot.voxelizationCommandBuffer,
+      _octreeCreationCommandBuffers[slotIndex * _chunkLodCount + slot.lod]};
+  slot.deviceIndex =
+      isEditing || hasSavedField || isFieldBatched ? 0 : _decideChunkBuildDevice(slotIndex);
+  if (slot.deviceIndex == 0) {
+    slot.timelineValue = ++_chunkSwapValue;
+    _submitWithTimelineSignal(_appContext, cmdBuffers, _chunkSwapSemaphore, slot.timelineValue);
+  } else {
+    slot.timelineValue = ++_peerBuildValues[slot.deviceIndex];
+    _submitWithTimelineSignal(_appContext, cmdBuffers, _peerBuildSemaphores[slot.deviceIndex],
+                              slot.timelineValue, VK_NULL_HANDLE, 1U << slot.deviceIndex);
+  }
+  slot.state = ChunkBuildSlot::State::kBuilding;
+}
+
+void SvoBuilder::_submitGeneratedChunkBuilds(
+    std::vector<std::pair<uint32_t, ChunkIndex>> const &builds) {
+  // the chunks with a saved field load it instead, and the imported ones are uploaded, only the
+  // slots within the image array of the batch can take part
+  std::vector<std::pair<uint32_t, ChunkIndex>> batchedBuilds{};
+  if (_configContainer->svoBuilderInfo->batchedFieldConstruction && _voxData == nullptr) {
+    for (auto const &build : builds) {
+      bool const hasSavedField = _chunkIndexToSavedField.count(build.second) != 0 ||
+                                 _chunkIndexToEvictedField.count(build.second) != 0;
+      // the batch is constructed on the first device, the slots of the others build on their own
+      bool const isOnFirstDevice = _decideChunkBuildDevice(build.first) == 0;
+      if (build.first < kMaxFieldBatchSize && !hasSavedField && isOnFirstDevice) {
+        batchedBuilds.push_back(build);
+      }
+    }
+  }
+
+  // a lone chunk is constructed within its own build
+  if (batchedBuilds.size() < 2) {
+    batchedBuilds.clear();
+  } else {
+    _submitFieldBatch(batchedBuilds);
+  }
 
-  // pipelines
-  _createDescriptorSetBundle();
-  _createPipelines();
-  _recordCommandBuffers();
+  for (auto const &build : builds) {
+    bool const isFieldBatched =
+        std::find(batchedBuilds.begin(), batchedBuilds.end(), build) != batchedBuilds.end();
+    _submitChunkBuild(build.first, build.second, false, 0, isFieldBatched);
+  }
 }
 
-void SvoBuilder::onPipelineRebuilt() {
-  _recordCommandBuffers();
+void SvoBuilder::_submitFieldBatch(std::vector<std::pair<uint32_t, ChunkIndex>> const &builds) {
+  // the slots of the previous batch have been finished since, the wait only guards the slots that
+  // had no build before
+  _waitForTimelineValue(_appContext->getDevice(), _chunkSwapSemaphore, _fieldBatchTimelineValue);
+
+  // the level of detail is decided the same way as by the build, a slab fits the full detail field
+  uint32_t const chunkVoxelDim = _configContainer->terrainInfo->chunkVoxelDim;
+  G_FieldBatchInfo batchInfo{};
+  batchInfo.chunksDim        = getChunksDim();
+  batchInfo.islandFalloff    = _isStreamingChunks() ? 0U : 1U;
+  batchInfo.fieldDispatchDim = (chunkVoxelDim + 1 + 7) / 8 * 8;
+  batchInfo.entryCount       = static_cast<uint32_t>(builds.size());
+  for (uint32_t i = 0; i < builds.size(); i++) {
+    auto const &[slotIndex, chunkIndex] = builds[i];
+    auto &entry                         = batchInfo.entries[i];
+    entry.chunkIndex                    = {chunkIndex.x, chunkIndex.y, chunkIndex.z};
+    entry.slotIndex                     = slotIndex;
+    entry.voxelResolution               = chunkVoxelDim >> _decideChunkLod(chunkIndex);
+  }
 
-  _chunkBufferMemoryAllocator->freeAll();
-  _chunkIndexToBufferAllocResult.clear();
+  VkCommandBuffer cmdBuffer = _fieldBatchCommandBuffer;
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
-  _chunkIndexToFieldImagesMap.clear();
+  _recordBufferUpdate(cmdBuffer, _fieldBatchInfoBuffer.get(), batchInfo);
+  _recordTransferToShaderBarrier(cmdBuffer);
 
-  _initBufferData();
+  // any descriptor set works, the batch bindings are the same in all of them, the barrier covers
+  // the builds that are submitted after the batch
+  _chunkFieldBatchConstructionPipeline->recordCommand(
+      cmdBuffer, 0, batchInfo.fieldDispatchDim, batchInfo.fieldDispatchDim,
+      batchInfo.fieldDispatchDim * batchInfo.entryCount);
+  _recordShaderAccessBarrier(cmdBuffer);
 
-  buildScene();
-}
+  vkEndCommandBuffer(cmdBuffer);
 
-// call me every time before building a new chunk
-void SvoBuilder::_resetBufferDataForNewChunkGeneration(ChunkIndex chunkIndex) {
-  uint32_t atomicCounterInitData = 1;
-  _counterBuffer->fillData(&atomicCounterInitData);
+  _fieldBatchTimelineValue = ++_chunkSwapValue;
+  _submitWithTimelineSignal(_appContext, {cmdBuffer}, _chunkSwapSemaphore,
+                            _fieldBatchTimelineValue);
+}
 
-  G_OctreeBuildInfo buildInfo{};
-  buildInfo.allocBegin = 0;
-  buildInfo.allocNum   = 8;
-  _octreeBuildInfoBuffer->fillData(&buildInfo);
+bool SvoBuilder::_finishChunkBuild(uint32_t slotIndex) {
+  auto &slot               = _chunkBuildSlots[slotIndex];
+  auto const chunkIndex    = slot.chunkIndex;
+  double const buildTimeMs = _chunkBuildProfiler->collect(slotIndex);
+  if (slot.isEditing) {
+    _editStats.editBuildGpuTimeMs += buildTimeMs;
+  }
 
-  G_IndirectDispatchInfo indirectDispatchInfo{};
-  indirectDispatchInfo.dispatchX = 1;
-  indirectDispatchInfo.dispatchY = 1;
-  indirectDispatchInfo.dispatchZ = 1;
-  _indirectAllocNumBuffer->fillData(&indirectDispatchInfo);
-  _indirectFragLengthBuffer->fillData(&indirectDispatchInfo);
+  // the readback buffer is made visible to the host by the end of the octree creation, empty
+  // chunks are detected on the gpu and report a zero length
+  std::array<uint32_t, 3> readback{};
+  _octreeBufferLengthReadbackBufferBundle->getBuffer(slotIndex)->fetchData(readback.data());
+  uint32_t const octreeBufferLength = readback[0];
+  uint32_t const fragmentCount      = readback[1];
+  uint32_t const fieldBrickCount    = readback[2];
+  uint32_t const reservedLength     = slot.reservation.region.size() / sizeof(uint32_t);
+  // the octree length is 0xffffffff then
+  bool const isFragmentListOverflowed = fragmentCount > slot.fragmentListCapacity;
+
+  // a retried preview would be swapped in after the full build of its edit, so it's dropped, the
+  // full build isn't held back by the overflow of its preview, its own lists are sized for it
+  if (slot.isPreview && (isFragmentListOverflowed || octreeBufferLength > reservedLength)) {
+    _deallocateOctreeRegion(slot.reservation);
+    slot.isPreview = false;
+    slot.state     = ChunkBuildSlot::State::kIdle;
+    return true;
+  }
 
-  G_FragmentListInfo fragmentListInfo{};
-  fragmentListInfo.voxelResolution    = _configContainer->terrainInfo->chunkVoxelDim;
-  fragmentListInfo.voxelFragmentCount = 0;
-  _fragmentListInfoBuffer->fillData(&fragmentListInfo);
+  // the stored field replaces the one it was loaded from, before a possible retry, which loads it
+  if (slot.isStoringField) {
+    std::optional<CustomMemoryAllocationResult> replacedField{};
+    auto const savedField = _chunkIndexToSavedField.find(chunkIndex);
+    if (savedField != _chunkIndexToSavedField.end()) {
+      replacedField = savedField->second.allocation;
+    }
+    _journalReplacedSavedField(slot.editStroke, chunkIndex, replacedField);
+    _chunkIndexToSavedField[chunkIndex] = {
+        _fieldBrickPoolMemoryAllocator->shrink(
+            slot.fieldBrickReservation,
+            (_getFieldBrickTableLength() + fieldBrickCount * kFieldBrickLength) * sizeof(uint32_t)),
+        ++_savedFieldUseCount};
+    slot.isStoringField = false;
+    _markWorldChunkDirty(chunkIndex);
+  }
 
-  G_ChunksInfo chunksInfo{};
-  chunksInfo.chunksDim             = getChunksDim();
-  chunksInfo.currentlyWritingChunk = {chunkIndex.x, chunkIndex.y, chunkIndex.z};
-  _chunksInfoBuffer->fillData(&chunksInfo);
+  // the gpu skipped the octree of an overflowed fragment list, the count is exact though, so the
+  // lists are grown to it, with some headroom, unless another retry grew them enough already, and
+  // the chunk is voxelized again
+  if (isFragmentListOverflowed) {
+    _logger->debug("fragment list overflowed ({} > {}), retrying", fragmentCount,
+                   slot.fragmentListCapacity);
+    _deallocateOctreeRegion(slot.reservation);
+    if (slot.fragmentListSaveInfo.storeCapacity > 0) {
+      _fragmentListMemoryAllocator->deallocate(slot.fragmentListReservation);
+    }
+    uint64_t const voxelCount =
+        static_cast<uint64_t>(_configContainer->terrainInfo->chunkVoxelDim) *
+        _configContainer->terrainInfo->chunkVoxelDim * _configContainer->terrainInfo->chunkVoxelDim;
+    auto const fragmentListCapacity = static_cast<uint32_t>(
+        std::min(voxelCount, static_cast<uint64_t>(fragmentCount) + fragmentCount / 4));
+    if (fragmentListCapacity > _fragmentListCapacity) {
+      _resizeFragmentListBuffers(fragmentListCapacity);
+    }
+    _submitChunkBuild(slotIndex, chunkIndex, slot.isEditing, _octreeLengthEstimate);
+    return false;
+  }
 
-  // the first 8 are not calculated, so pre-allocate them
-  uint32_t octreeBufferSize = 8;
-  _octreeBufferLengthBuffer->fillData(&octreeBufferSize);
-}
+  // keep some headroom over the largest octree seen so far, so that overflows stay rare
+  _octreeLengthEstimate =
+      std::max(_octreeLengthEstimate, octreeBufferLength + octreeBufferLength / 4);
+
+  // the octree didn't fit, the gpu skipped the copy and left the chunk indices buffer untouched,
+  // so retry with the exact length, which is known now
+  if (octreeBufferLength > reservedLength) {
+    _logger->debug("octree reservation overflowed ({} > {}), retrying", octreeBufferLength,
+                   reservedLength);
+    _deallocateOctreeRegion(slot.reservation);
+    if (slot.fragmentListSaveInfo.storeCapacity > 0) {
+      _fragmentListMemoryAllocator->deallocate(slot.fragmentListReservation);
+    }
+    _submitChunkBuild(slotIndex, chunkIndex, slot.isEditing, octreeBufferLength);
+    return false;
+  }
 
-void SvoBuilder::buildScene() {
-  uint32_t zero = 0;
-  _octreeBufferWriteOffsetBuffer->fillData(&zero);
+  // the previously saved fragment list has been consumed by this edit, the new one replaces it
+  if (slot.isEditing && !slot.isPreview) {
+    auto const &savedFragmentList = _chunkIndexToFragmentListAllocResult.find(chunkIndex);
+    if (savedFragmentList != _chunkIndexToFragmentListAllocResult.end()) {
+      _fragmentListMemoryAllocator->deallocate(savedFragmentList->second);
+      _chunkIndexToFragmentListAllocResult.erase(savedFragmentList);
+    }
 
-  uint32_t minTimeMs = std::numeric_limits<uint32_t>::max();
-  uint32_t maxTimeMs = 0;
-  uint32_t avgTimeMs = 0;
-  for (uint32_t z = 0; z < _configContainer->terrainInfo->chunksDim.z; z++) {
-    for (uint32_t y = 0; y < _configContainer->terrainInfo->chunksDim.y; y++) {
-      for (uint32_t x = 0; x < _configContainer->terrainInfo->chunksDim.x; x++) {
-        ChunkIndex chunkIndex{x, y, z};
-
-        auto start = std::chrono::steady_clock::now();
-        _buildChunkFromNoise(chunkIndex);
-        auto end      = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-        minTimeMs     = std::min(minTimeMs, static_cast<uint32_t>(duration));
-        maxTimeMs     = std::max(maxTimeMs, static_cast<uint32_t>(duration));
-        avgTimeMs += static_cast<uint32_t>(duration);
+    auto const storeCapacity = slot.fragmentListSaveInfo.storeCapacity;
+    if (storeCapacity > 0) {
+      if (fragmentCount > 0 && fragmentCount <= storeCapacity) {
+        _chunkIndexToFragmentListAllocResult[chunkIndex] = _fragmentListMemoryAllocator->shrink(
+            slot.fragmentListReservation, fragmentCount * sizeof(G_FragmentListEntry));
+      } else {
+        _fragmentListMemoryAllocator->deallocate(slot.fragmentListReservation);
       }
     }
-  }
 
-  avgTimeMs /= _configContainer->terrainInfo->chunksDim.x *
-               _configContainer->terrainInfo->chunksDim.y *
-               _configContainer->terrainInfo->chunksDim.z;
+    _fragmentCountEstimate = std::max(_fragmentCountEstimate, fragmentCount + fragmentCount / 4);
+  }
 
-  _logger->info("min time: {} ms, max time: {} ms, avg time: {} ms", minTimeMs, maxTimeMs,
-                avgTimeMs);
+  // the previous octree of this chunk has been replaced on the gpu, so its memory region can be
+  // reused for new allocations, edits and level of detail changes happen while rendering, so the
+  // frames in flight are given time to finish tracing the old octree first
+  auto const &it = _chunkIndexToBufferAllocResult.find(chunkIndex);
+  if (it != _chunkIndexToBufferAllocResult.end()) {
+    _retiredAllocations.push_back(
+        {it->second, static_cast<uint32_t>(_configContainer->applicationInfo->framesInFlight)});
+    _chunkIndexToBufferAllocResult.erase(it);
+  }
+  _chunkIndexToLod[chunkIndex] = slot.lod;
+
+  if (octreeBufferLength == 0) {
+    _deallocateOctreeRegion(slot.reservation);
+  } else {
+    auto const &reservation = slot.reservation;
+    _chunkIndexToBufferAllocResult[chunkIndex] = {
+        reservation.page, _octreePageAllocators[reservation.page]->shrink(
+                              reservation.region, octreeBufferLength * sizeof(uint32_t))};
+  }
+  _octreeBufferMayHaveHoles = true;
+  // the build of another device is only visible once it's copied to the first one
+  uint64_t const swapValue = slot.deviceIndex == 0
+                                 ? slot.timelineValue
+                                 : _submitChunkBuildMerge(slotIndex, octreeBufferLength);
+  _swappedChunks.emplace_back(swapValue, glm::ivec3(chunkIndex.x, chunkIndex.y, chunkIndex.z));
+  if (slot.isEditing && !slot.isPreview) {
+    _editStats.editedChunkCount++;
+  }
 
-  _chunkBufferMemoryAllocator->printStats();
+  slot.isPreview = false;
+  slot.state     = ChunkBuildSlot::State::kIdle;
+  return true;
 }
 
-std::vector<SvoBuilder::ChunkIndex> SvoBuilder::_getEditingChunks(glm::vec3 centerPos,
-                                                                  float radius) {
-  std::vector<ChunkIndex> chunks{};
+std::vector<glm::ivec3> SvoBuilder::takeSwappedChunks() {
+  // a slot is finished once the live counter reaches its value, which can be ahead of the value
+  // read at the start of the update, those chunks are handed out by the next call
+  std::vector<glm::ivec3> swappedChunks{};
+  auto const isVisible = [this](std::pair<uint64_t, glm::ivec3> const &swappedChunk) {
+    return swappedChunk.first <= _completedChunkSwapValue;
+  };
+  for (auto const &swappedChunk : _swappedChunks) {
+    if (isVisible(swappedChunk)) {
+      swappedChunks.push_back(swappedChunk.second);
+    }
+  }
+  _swappedChunks.erase(std::remove_if(_swappedChunks.begin(), _swappedChunks.end(), isVisible),
+                       _swappedChunks.end());
+  return swappedChunks;
+}
 
-  glm::vec3 minPos = centerPos - glm::vec3{radius, radius, radius};
-  glm::vec3 maxPos = centerPos + glm::vec3{radius, radius, radius};
-  glm::uvec3 minChunkIndex =
-      glm::uvec3{static_cast<uint32_t>(minPos.x), static_cast<uint32_t>(minPos.y),
-                 static_cast<uint32_t>(minPos.z)};
-  glm::uvec3 maxChunkIndex =
-      glm::uvec3{static_cast<uint32_t>(maxPos.x), static_cast<uint32_t>(maxPos.y),
-                 static_cast<uint32_t>(maxPos.z)};
+std::vector<glm::ivec3> SvoBuilder::getNonEmptyChunks() const {
+  std::vector<glm::ivec3> nonEmptyChunks{};
+  nonEmptyChunks.reserve(_chunkIndexToBufferAllocResult.size());
+  for (auto const &[chunkIndex, _] : _chunkIndexToBufferAllocResult) {
+    nonEmptyChunks.emplace_back(chunkIndex.x, chunkIndex.y, chunkIndex.z);
+  }
+  for (auto const &chunkIndex : _instancedChunks) {
+    if (_chunkIndexToBufferAllocResult.find(chunkIndex) == _chunkIndexToBufferAllocResult.end()) {
+      nonEmptyChunks.emplace_back(chunkIndex.x, chunkIndex.y, chunkIndex.z);
+    }
+  }
+  return nonEmptyChunks;
+}
 
-  // ensure min and max is in the range
-  auto const &chunksDim = getChunksDim();
-  minChunkIndex         = glm::max(minChunkIndex, glm::uvec3{0, 0, 0});
-  maxChunkIndex =
-      glm::min(maxChunkIndex, glm::uvec3{chunksDim.x - 1, chunksDim.y - 1, chunksDim.z - 1});
+void SvoBuilder::_updateOctreeCompaction() {
+  if (!_inFlightOctreeMoves.empty()) {
+    if (_completedChunkSwapValue < _compactionTimelineValue) {
+      return;
+    }
 
-  for (uint32_t z = minChunkIndex.z; z <= maxChunkIndex.z; z++) {
-    for (uint32_t y = minChunkIndex.y; y <= maxChunkIndex.y; y++) {
-      for (uint32_t x = minChunkIndex.x; x <= maxChunkIndex.x; x++) {
-        chunks.emplace_back(ChunkIndex{x, y, z});
-      }
+    // the renderer picks up the new chunk indices from now on, but the frames in flight might still
+    // be tracing the old regions
+    for (auto const &move : _inFlightOctreeMoves) {
+      _retiredAllocations.push_back(
+          {move.source, static_cast<uint32_t>(_configContainer->applicationInfo->framesInFlight)});
     }
+    _inFlightOctreeMoves.clear();
   }
 
-  // print using logger
-  // _logger->info("------");
-  // for (auto const &chunk : chunks) {
-  //   _logger->info("editing chunk: x: {}, y: {}, z: {}", chunk.x, chunk.y, chunk.z);
-  // }
-  // _logger->info("------");
+  bool const isCompactionEnabled = _configContainer->svoBuilderInfo->octreeCompactionBudgetKb > 0;
+  if (_octreeBufferMayHaveHoles && isCompactionEnabled) {
+    _octreeBufferMayHaveHoles = _submitOctreeCompactionBatch();
+  }
+}
 
-  // print no only
-  // _logger->info("editing chunks: {}", chunks.size());
+bool SvoBuilder::_submitOctreeCompactionBatch() {
+  // the octree of a chunk in flight is about to be replaced, so moving it is wasted work
+  std::vector<std::pair<OctreeAllocation, ChunkIndex>> candidates{};
+  candidates.reserve(_chunkIndexToBufferAllocResult.size());
+  for (auto const &[chunkIndex, allocation] : _chunkIndexToBufferAllocResult) {
+    bool const isInFlight = std::any_of(_chunkBuildSlots.begin(), _chunkBuildSlots.end(),
+                                        [&chunkIndex](ChunkBuildSlot const &slot) {
+                                          return slot.state == ChunkBuildSlot::State::kBuilding &&
+                                                 slot.chunkIndex == chunkIndex;
+                                        });
+    if (!isInFlight) {
+      candidates.emplace_back(allocation, chunkIndex);
+    }
+  }
 
-  return chunks;
-}
+  // the highest octrees are moved first, so that the free space gathers at the end of the pages
+  std::sort(candidates.begin(), candidates.end(), [](auto const &a, auto const &b) {
+    if (a.first.page != b.first.page) {
+      return a.first.page > b.first.page;
+    }
+    return a.first.region.offset() > b.first.region.offset();
+  });
+
+  // at least one octree is moved per batch, however large it is
+  size_t const budget =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->octreeCompactionBudgetKb) * 1024;
+  size_t movedSize = 0;
+  for (auto const &[source, chunkIndex] : candidates) {
+    if (movedSize >= budget) {
+      break;
+    }
 
-void SvoBuilder::handleCursorHit(glm::vec3 hitPos, bool deletionMode) {
-  // change chunk editing buffer
-  G_ChunkEditingInfo chunkEditingInfo{};
-  chunkEditingInfo.pos       = hitPos;
-  chunkEditingInfo.radius    = _configContainer->brushInfo->size;
-  chunkEditingInfo.strength  = _configContainer->brushInfo->strength;
-  chunkEditingInfo.operation = deletionMode ? 0U : 1U; // 0 for deletion, 1 for addition
-  _chunkEditingInfoBuffer->fillData(&chunkEditingInfo);
+    // anywhere in a lower page, or below the source in the same page
+    std::optional<CustomMemoryAllocationResult> destinationRegion{};
+    uint32_t destinationPage = 0;
+    for (; destinationPage <= source.page; destinationPage++) {
+      size_t const offsetLimit =
+          destinationPage == source.page ? source.region.offset() : _octreePageSize;
+      destinationRegion = _octreePageAllocators[destinationPage]->allocateBelow(
+          source.region.size(), offsetLimit);
+      if (destinationRegion.has_value()) {
+        break;
+      }
+    }
+    if (!destinationRegion.has_value()) {
+      continue;
+    }
 
-  const auto &chunks = _getEditingChunks(hitPos, _configContainer->brushInfo->size);
-  for (auto const &chunk : chunks) {
-    _editExistingChunk(chunk);
-  }
-}
-
-void SvoBuilder::_editExistingChunk(ChunkIndex chunkIndex) {
-  _resetBufferDataForNewChunkGeneration(chunkIndex);
-
-  VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
-
-  // if the chunk does not have save, create it to buffer
-  if (_chunkIndexToFieldImagesMap.find(chunkIndex) == _chunkIndexToFieldImagesMap.end()) {
-    _logger->info("constructing new field image");
-    cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-    _chunkFieldConstructionPipeline->recordCommand(
-        cmdBuffer, 0, _configContainer->terrainInfo->chunkVoxelDim + 1,
-        _configContainer->terrainInfo->chunkVoxelDim + 1,
-        _configContainer->terrainInfo->chunkVoxelDim + 1);
-    endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                          _appContext->getGraphicsQueue(), cmdBuffer);
-  }
-  // otherwise, load from save to buffer, caching this doesn't offer performance boost
-  else {
-    cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-    ImageForwardingPair f{_chunkIndexToFieldImagesMap[chunkIndex].get(),
-                          _chunkFieldImage.get(),
-                          VK_IMAGE_LAYOUT_GENERAL,
-                          VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_GENERAL,
-                          VK_IMAGE_LAYOUT_GENERAL};
-    f.forwardCopy(cmdBuffer);
-    endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                          _appContext->getGraphicsQueue(), cmdBuffer);
-  }
-
-  // edit field image
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkFieldModificationPipeline->recordCommand(cmdBuffer, 0,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+    _inFlightOctreeMoves.push_back({chunkIndex, source});
+    _chunkIndexToBufferAllocResult[chunkIndex] = {destinationPage, destinationRegion.value()};
+    movedSize += source.region.size();
+  }
 
-  // ensure the image has been created before copying
-  auto const &it = _chunkIndexToFieldImagesMap.find(chunkIndex);
-  if (it == _chunkIndexToFieldImagesMap.end()) {
-    _logger->info("creating new image for chunk");
-    _chunkIndexToFieldImagesMap[chunkIndex] =
-        std::make_unique<Image>(_appContext,
-                                ImageDimensions{_configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                _configContainer->terrainInfo->chunkVoxelDim + 1},
-                                VK_FORMAT_R16_UINT,
-                                VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                                    VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  if (_inFlightOctreeMoves.empty()) {
+    return false;
   }
 
-  // save from buffer to image
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  ImageForwardingPair f{_chunkFieldImage.get(),  _chunkIndexToFieldImagesMap[chunkIndex].get(),
-                        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_UNDEFINED,
-                        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL};
-  f.forwardCopy(cmdBuffer);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  VkCommandBuffer cmdBuffer = _compactionCommandBuffer;
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+  // the octrees and the chunk indices are written by the chunk builds before
+  VkMemoryBarrier shaderToTransferBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  shaderToTransferBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+  shaderToTransferBarrier.dstAccessMask =
+      VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &shaderToTransferBarrier, 0, nullptr,
+                       0, nullptr);
 
-  // remove svo buffer allocation rec, so new allocations can be made to this memory region
-  auto const &it2 = _chunkIndexToBufferAllocResult.find(chunkIndex);
-  if (it2 != _chunkIndexToBufferAllocResult.end()) {
-    _chunkBufferMemoryAllocator->deallocate(it2->second);
-    _chunkIndexToBufferAllocResult.erase(it2);
+  // the renderer waits for the whole submission, so it sees either the old entry and octree of a
+  // chunk, or the new ones, never a mix of both
+  for (auto const &move : _inFlightOctreeMoves) {
+    auto const &ci          = move.chunkIndex;
+    auto const &destination = _chunkIndexToBufferAllocResult[ci];
+
+    // the destination is in a lower page, or ends before the source begins, so the regions never
+    // overlap
+    VkBufferCopy copyRegion = {move.source.region.offset(), destination.region.offset(),
+                               move.source.region.size()};
+    vkCmdCopyBuffer(cmdBuffer, _octreeBufferPages[move.source.page]->getVkBuffer(),
+                    _octreeBufferPages[destination.page]->getVkBuffer(), 1, &copyRegion);
+
+    ChunkIndicesEntry const chunkIndicesEntry = _makeChunkIndicesEntry(
+        destination.page, _chunkIndexToLod[ci], destination.region.offset() / sizeof(uint32_t));
+    vkCmdUpdateBuffer(cmdBuffer, _chunkIndicesBuffer->getVkBuffer(),
+                      _getChunksBufferLinearIndex(ci) * sizeof(ChunkIndicesEntry),
+                      sizeof(ChunkIndicesEntry), &chunkIndicesEntry);
   }
 
-  // construct voxels into fragmentlist buffer
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkVoxelCreationPipeline->recordCommand(
-      cmdBuffer, 0, _configContainer->terrainInfo->chunkVoxelDim,
-      _configContainer->terrainInfo->chunkVoxelDim, _configContainer->terrainInfo->chunkVoxelDim);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  vkEndCommandBuffer(cmdBuffer);
 
-  // check if the fragment list is empty, if so, we can skip the octree creation
-  G_FragmentListInfo fragmentListInfo{};
-  _fragmentListInfoBuffer->fetchData(&fragmentListInfo);
-  if (fragmentListInfo.voxelFragmentCount == 0) {
-    // alter the pointer stored in the chunk indices buffer
-    uint32_t zero = 0;
-    _octreeBufferWriteOffsetBuffer->fillData(&zero);
-    cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-    _chunkIndicesBufferUpdaterPipeline->recordCommand(cmdBuffer, 0, 1, 1, 1);
-    endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                          _appContext->getGraphicsQueue(), cmdBuffer);
+  _compactionTimelineValue = ++_chunkSwapValue;
+  _submitWithTimelineSignal(_appContext, {cmdBuffer}, _chunkSwapSemaphore,
+                            _compactionTimelineValue);
+  return true;
+}
 
-    // but maintain the image, because the weight has been altered
-    return;
+std::vector<Buffer *> SvoBuilder::getOctreeBufferPages() const {
+  std::vector<Buffer *> pages{};
+  pages.reserve(_octreeBufferPages.size());
+  for (auto const &page : _octreeBufferPages) {
+    pages.push_back(page.get());
   }
+  return pages;
+}
 
-  // octree construction
-  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  // wait until the image is ready
-  submitInfo.waitSemaphoreCount = 0;
-  // signal a semaphore after excecution finished
-  submitInfo.signalSemaphoreCount = 0;
-  // wait for no stage
-  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
-  submitInfo.pWaitDstStageMask = &waitStages;
-
-  std::vector<VkCommandBuffer> commandBuffersToSubmit2{_octreeCreationCommandBuffer};
-  submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffersToSubmit2.size());
-  submitInfo.pCommandBuffers    = commandBuffersToSubmit2.data();
-
-  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(_appContext->getGraphicsQueue());
-
-  uint32_t octreeBufferLength = 0;
-  _octreeBufferLengthBuffer->fetchData(&octreeBufferLength);
-
-  _chunkIndexToBufferAllocResult[chunkIndex] =
-      _chunkBufferMemoryAllocator->allocate(octreeBufferLength * sizeof(uint32_t));
-  uint32_t writeOffsetInBytes = _chunkIndexToBufferAllocResult[chunkIndex].offset();
-
-  // print offset in mb
-  _logger->info("memory offset: {} mb", static_cast<float>(writeOffsetInBytes) / (1024 * 1024));
-
-  VkBufferCopy bufCopy = {
-      0,                                     // srcOffset
-      writeOffsetInBytes,                    // dstOffset,
-      octreeBufferLength * sizeof(uint32_t), // size
-  };
+SvoBuilder::OctreeAllocation SvoBuilder::_allocateOctreeRegion(size_t size) {
+  if (size > _octreePageSize) {
+    _logger->error("octree region of {} bytes doesn't fit into a page", size);
+    exit(0);
+  }
+  _editStats.octreeAllocationCount++;
 
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  // copy staging buffer to main buffer
-  vkCmdCopyBuffer(cmdBuffer, _chunkOctreeBuffer->getVkBuffer(),
-                  _appendedOctreeBuffer->getVkBuffer(), 1, &bufCopy);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  for (uint32_t page = 0; page < _octreePageAllocators.size(); page++) {
+    if (_octreePageAllocators[page]->canAllocate(size)) {
+      return {page, _octreePageAllocators[page]->allocate(size)};
+    }
+  }
 
-  uint32_t writeOffsetInUint32 = writeOffsetInBytes / sizeof(uint32_t) + 1U;
-  _octreeBufferWriteOffsetBuffer->fillData(&writeOffsetInUint32);
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  // write the chunks image, according to the accumulated buffer offset
-  // we should do it here, since we can cull null chunks here after the voxels are decided
-  _chunkIndicesBufferUpdaterPipeline->recordCommand(cmdBuffer, 0, 1, 1, 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+  _addOctreeBufferPage();
+  auto const page = static_cast<uint32_t>(_octreePageAllocators.size() - 1);
+  return {page, _octreePageAllocators[page]->allocate(size)};
 }
 
-void SvoBuilder::_buildChunkFromNoise(ChunkIndex chunkIndex) {
-  _resetBufferDataForNewChunkGeneration(chunkIndex);
+bool SvoBuilder::_canAllocateOctreeRegionWithinBudget(size_t size) const {
+  for (auto const &allocator : _octreePageAllocators) {
+    if (allocator->canAllocate(size)) {
+      return true;
+    }
+  }
 
-  VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+  size_t constexpr kMb = 1024 * 1024;
+  size_t const poolBudget =
+      static_cast<size_t>(_configContainer->svoBuilderInfo->octreePoolBudgetMb) * kMb;
+  bool const fitsPoolBudget =
+      poolBudget == 0 || (_octreeBufferPages.size() + 1) * _octreePageSize <= poolBudget;
+  return _octreeBufferPages.size() < kMaxOctreePageCount && fitsPoolBudget &&
+         _appContext->fitsDeviceMemoryBudget(_octreePageSize);
+}
 
-  // construct field image
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkFieldConstructionPipeline->recordCommand(cmdBuffer, 0,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                                 _configContainer->terrainInfo->chunkVoxelDim + 1);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+void SvoBuilder::_deallocateOctreeRegion(OctreeAllocation const &allocation) {
+  _editStats.octreeDeallocationCount++;
+  _octreePageAllocators[allocation.page]->deallocate(allocation.region);
+}
 
-  // construct voxels into fragmentlist buffer
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  _chunkVoxelCreationPipeline->recordCommand(
-      cmdBuffer, 0, _configContainer->terrainInfo->chunkVoxelDim,
-      _configContainer->terrainInfo->chunkVoxelDim, _configContainer->terrainInfo->chunkVoxelDim);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+void SvoBuilder::_addOctreeBufferPage() {
+  if (_octreeBufferPages.size() == kMaxOctreePageCount) {
+    _logger->error("all {} octree buffer pages are full, allocation failed", kMaxOctreePageCount);
+    exit(0);
+  }
 
-  // intermediate step: check if the fragment list is empty, if so, we can skip the octree creation
-  G_FragmentListInfo fragmentListInfo{};
-  _fragmentListInfoBuffer->fetchData(&fragmentListInfo);
-  if (fragmentListInfo.voxelFragmentCount == 0) {
+  VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+      _appContext, MemoryCategory::kOctreePool);
+  bool const texelBuffer   = _configContainer->svoTracerInfo->octreeTexelBuffer;
+  bool const deviceAddress = _octreePageAddressBuffer != nullptr;
+  VkBufferUsageFlags usage =
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  if (texelBuffer) {
+    usage |= VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
+  }
+  if (deviceAddress) {
+    usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  }
+  _octreeBufferPages.emplace_back(
+      std::make_unique<Buffer>(_appContext, _octreePageSize, usage, MemoryStyle::kDedicated));
+  // the tracer fetches the nodes through the view, the builder keeps writing the storage buffer
+  if (texelBuffer) {
+    _octreeBufferPages.back()->createTexelBufferView(VK_FORMAT_R32_UINT);
+  }
+  // no submitted frame reads the entry of a page that isn't there yet
+  if (deviceAddress) {
+    auto *pageAddresses = static_cast<VkDeviceAddress *>(_octreePageAddressBuffer->getMappedAddr());
+    pageAddresses[_octreeBufferPages.size() - 1] = _octreeBufferPages.back()->getDeviceAddress();
+  }
+  _octreePageAllocators.emplace_back(std::make_unique<CustomMemoryAllocator>(
+      _logger, _octreePageSize, AllocationStrategy::kTlsf));
+  if (_isTracingAllocations()) {
+    _octreePageAllocators.back()->startTrace();
+  }
+  _logger->info("octree buffer page {} created ({} mb)", _octreeBufferPages.size() - 1,
+                _octreePageSize / (1024 * 1024));
+
+  // the first page is there before the descriptor sets are created
+  if (_descriptorSetBundle == nullptr) {
     return;
   }
 
-  // octree construction
-  VkSubmitInfo submitInfo{VK_STRUCTURE_TYPE_SUBMIT_INFO};
-  // wait until the image is ready
-  submitInfo.waitSemaphoreCount = 0;
-  // signal a semaphore after excecution finished
-  submitInfo.signalSemaphoreCount = 0;
-  // wait for no stage
-  VkPipelineStageFlags waitStages{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
-  submitInfo.pWaitDstStageMask = &waitStages;
+  // the submitted builds don't use the element of the new page, so if the arrays are updated after
+  // bind, that element is written right away, and the recorded command buffers stay valid,
+  // otherwise the descriptor sets can only be updated once the submitted builds are done with
+  // them, and the recorded command buffers are invalidated by the update
+  bool const isUpdatedAfterBind = _descriptorSetBundle->areBufferArraysUpdatedAfterBind();
+  if (isUpdatedAfterBind) {
+    _descriptorSetBundle->updateBufferArray(13, getOctreeBufferPages());
+  } else {
+    VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &_chunkSwapSemaphore;
+    waitInfo.pValues        = &_chunkSwapValue;
+    vkWaitSemaphores(_appContext->getDevice(), &waitInfo, UINT64_MAX);
+
+    _descriptorSetBundle->updateBufferArray(13, getOctreeBufferPages());
+    _recordCommandBuffers();
+  }
 
-  std::vector<VkCommandBuffer> commandBuffersToSubmit2{_octreeCreationCommandBuffer};
-  submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffersToSubmit2.size());
-  submitInfo.pCommandBuffers    = commandBuffersToSubmit2.data();
+  // the tracer looks the new page up in the address table, there's nothing to rebind
+  if (deviceAddress) {
+    return;
+  }
 
-  vkQueueSubmit(_appContext->getGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE);
-  vkQueueWaitIdle(_appContext->getGraphicsQueue());
+  // the tracer writes the element of the new page into its own arrays between two frames
+  if (isUpdatedAfterBind) {
+    GlobalEventDispatcher::get().trigger<E_OctreeBufferPageAdded>();
+    return;
+  }
 
-  uint32_t octreeBufferLength = 0;
-  _octreeBufferLengthBuffer->fetchData(&octreeBufferLength);
+  // no chunk of the new page is visible to the tracer until the next update, and the render loop
+  // is blocked before that, so the tracer can rebind the pages in time
+  uint32_t blockStateBits = BlockState::kOctreeBufferPagesChanged;
+  GlobalEventDispatcher::get().trigger<E_RenderLoopBlockRequest>(
+      E_RenderLoopBlockRequest{blockStateBits});
+}
 
-  // remove allocation
-  auto const &it = _chunkIndexToBufferAllocResult.find(chunkIndex);
-  if (it != _chunkIndexToBufferAllocResult.end()) {
-    _chunkBufferMemoryAllocator->deallocate(it->second);
-    // erasing is omitted here, since we are going to overwrite it anyway
+void SvoBuilder::_createImages() {
+  VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+      _appContext, MemoryCategory::kFieldData);
+  for (uint32_t i = 0; i < _chunkBuildSlotCount; i++) {
+    _chunkFieldImages.emplace_back(
+        std::make_unique<Image>(_appContext,
+                                ImageDimensions{_configContainer->terrainInfo->chunkVoxelDim + 1,
+                                                _configContainer->terrainInfo->chunkVoxelDim + 1,
+                                                _configContainer->terrainInfo->chunkVoxelDim + 1},
+                                VK_FORMAT_R16_UINT,
+                                VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                    VK_IMAGE_USAGE_TRANSFER_DST_BIT));
   }
-  _chunkIndexToBufferAllocResult[chunkIndex] =
-      _chunkBufferMemoryAllocator->allocate(octreeBufferLength * sizeof(uint32_t));
-  uint32_t writeOffsetInBytes = _chunkIndexToBufferAllocResult[chunkIndex].offset();
 
-  _logger->info("memory offset: {} mb", static_cast<float>(writeOffsetInBytes) / (1024 * 1024));
-
-  VkBufferCopy bufCopy = {
-      0,                                     // srcOffset
-      writeOffsetInBytes,                    // dstOffset,
-      octreeBufferLength * sizeof(uint32_t), // size
-  };
+  if (_configContainer->terrainInfo->bakedNoiseOctaveCount == 0) {
+    return;
+  }
+  // the filtering wraps around, so the volume tiles the lattice like the wrapped noise does
+  auto settings         = Sampler::Settings{};
+  settings.addressModeU = Sampler::AddressMode::kRepeat;
+  settings.addressModeV = Sampler::AddressMode::kRepeat;
+  settings.addressModeW = Sampler::AddressMode::kRepeat;
+  _noiseVolumeSampler   = std::make_unique<Sampler>(_appContext, settings);
+
+  // the storage and the linear filtering of this format are mandatory
+  uint32_t constexpr kNoiseVolumeDim = kNoiseVolumeLatticeDim * kNoiseVolumeTexelsPerCell;
+  _noiseVolumeImage                  = std::make_unique<Image>(
+      _appContext, ImageDimensions{kNoiseVolumeDim, kNoiseVolumeDim, kNoiseVolumeDim},
+      VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+      _noiseVolumeSampler->getVkSampler());
+}
 
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  // copy staging buffer to main buffer
-  vkCmdCopyBuffer(cmdBuffer, _chunkOctreeBuffer->getVkBuffer(),
-                  _appendedOctreeBuffer->getVkBuffer(), 1, &bufCopy);
-  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
-                        _appContext->getGraphicsQueue(), cmdBuffer);
+void SvoBuilder::_bakeNoiseVolume() {
+  if (_noiseVolumeBakePipeline == nullptr) {
+    return;
+  }
+  uint32_t constexpr kNoiseVolumeDim = kNoiseVolumeLatticeDim * kNoiseVolumeTexelsPerCell;
 
-  uint32_t writeOffsetInUint32 = writeOffsetInBytes / sizeof(uint32_t) + 1U;
-  _octreeBufferWriteOffsetBuffer->fillData(&writeOffsetInUint32);
-  cmdBuffer = beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
-  // write the chunks image, according to the accumulated buffer offset
-  // we should do it here, since we can cull null chunks here after the voxels are decided
-  _chunkIndicesBufferUpdaterPipeline->recordCommand(cmdBuffer, 0, 1, 1, 1);
+  VkCommandBuffer cmdBuffer =
+      beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
+  _noiseVolumeBakePipeline->recordCommand(cmdBuffer, 0, kNoiseVolumeDim, kNoiseVolumeDim,
+                                          kNoiseVolumeDim);
+  // the single time submission is waited for, which makes the volume visible to the builds after it
   endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
                         _appContext->getGraphicsQueue(), cmdBuffer);
 }
 
-void SvoBuilder::_createImages() {
-  _chunkFieldImage =
-      std::make_unique<Image>(_appContext,
-                              ImageDimensions{_configContainer->terrainInfo->chunkVoxelDim + 1,
-                                              _configContainer->terrainInfo->chunkVoxelDim + 1,
-                                              _configContainer->terrainInfo->chunkVoxelDim + 1},
-                              VK_FORMAT_R16_UINT,
-                              VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                                  VK_IMAGE_USAGE_TRANSFER_DST_BIT);
-}
-
 // voxData is passed in to decide the size of some buffers dureing allocation
-void SvoBuilder::_createBuffers(size_t maximumOctreeBufferSize) {
+void SvoBuilder::_createBuffers(size_t savedFragmentListBufferSize,
+                                size_t fieldBrickPoolBufferSize) {
   _chunkIndicesBuffer = std::make_unique<Buffer>(
+      _appContext,
+      sizeof(ChunkIndicesEntry) * _configContainer->terrainInfo->chunksDim.x *
+          _configContainer->terrainInfo->chunksDim.y * _configContainer->terrainInfo->chunksDim.z,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _chunkBoundsBuffer = std::make_unique<Buffer>(
       _appContext,
       sizeof(uint32_t) * _configContainer->terrainInfo->chunksDim.x *
           _configContainer->terrainInfo->chunksDim.y * _configContainer->terrainInfo->chunksDim.z,
       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  _counterBuffer = std::make_unique<Buffer>(
-      _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _chunkInstancesBuffer = std::make_unique<Buffer>(
+      _appContext,
+      sizeof(glm::uvec2) * _configContainer->terrainInfo->chunksDim.x *
+          _configContainer->terrainInfo->chunksDim.y * _configContainer->terrainInfo->chunksDim.z,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _paletteBuffer = std::make_unique<Buffer>(_appContext, sizeof(BlockPalette::Palette),
+                                            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                            MemoryStyle::kDedicated);
+
+  _counterBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, sizeof(uint32_t),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
   uint32_t sizeInWorstCase =
       std::ceil(static_cast<float>(_configContainer->terrainInfo->chunkVoxelDim *
@@ -453,93 +3435,200 @@ void SvoBuilder::_createBuffers(size_t maximumOctreeBufferSize) {
   _logger->info("estimated chunk staging buffer size : {} mb",
                 static_cast<float>(sizeInWorstCase) / (1024 * 1024));
 
-  _chunkOctreeBuffer = std::make_unique<Buffer>(
-      _appContext,
+  _chunkOctreeBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount,
       sizeof(uint32_t) * _configContainer->terrainInfo->chunkVoxelDim *
           _configContainer->terrainInfo->chunkVoxelDim *
           _configContainer->terrainInfo->chunkVoxelDim,
       VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
       MemoryStyle::kHostVisible);
 
-  _indirectFragLengthBuffer = std::make_unique<Buffer>(_appContext, sizeof(G_IndirectDispatchInfo),
-                                                       VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-                                                           VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                       MemoryStyle::kDedicated);
-
-  _appendedOctreeBuffer = std::make_unique<Buffer>(_appContext, maximumOctreeBufferSize,
-                                                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                       VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                   MemoryStyle::kDedicated);
-
-  uint32_t maximumFragmentListBufferSize =
-      sizeof(G_FragmentListEntry) * _configContainer->terrainInfo->chunkVoxelDim *
-      _configContainer->terrainInfo->chunkVoxelDim * _configContainer->terrainInfo->chunkVoxelDim;
-  _fragmentListBuffer =
-      std::make_unique<Buffer>(_appContext, maximumFragmentListBufferSize,
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _indirectFragLengthBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, sizeof(G_IndirectDispatchInfo),
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      MemoryStyle::kDedicated);
+
+  // the unused entries are never read, the pages are only indexed through the chunk indices
+  if (_configContainer->svoTracerInfo->octreeDeviceAddress) {
+    VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+        _appContext, MemoryCategory::kOctreePool);
+    _octreePageAddressBuffer = std::make_unique<Buffer>(
+        _appContext, sizeof(VkDeviceAddress) * kMaxOctreePageCount,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kHostVisible);
+  }
 
-  _logger->info("fragment list buffer size: {} mb",
-                static_cast<float>(maximumFragmentListBufferSize) / (1024 * 1024));
+  // the rest of the pages are added on demand
+  _addOctreeBufferPage();
 
-  _octreeBuildInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_OctreeBuildInfo),
+  _savedFragmentListBuffer =
+      std::make_unique<Buffer>(_appContext, savedFragmentListBufferSize,
                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  _indirectAllocNumBuffer = std::make_unique<Buffer>(_appContext, sizeof(G_IndirectDispatchInfo),
-                                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
-                                                         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                                                     MemoryStyle::kDedicated);
+  // the evicted fields are copied out of the pool, and back into it
+  {
+    VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+        _appContext, MemoryCategory::kFieldData);
+    _fieldBrickPoolBuffer = std::make_unique<Buffer>(
+        _appContext, fieldBrickPoolBufferSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        MemoryStyle::kDedicated);
+  }
 
-  _fragmentListInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_FragmentListInfo),
+  _fieldBatchInfoBuffer =
+      std::make_unique<Buffer>(_appContext, sizeof(G_FieldBatchInfo),
                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  _chunksInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_ChunksInfo),
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _resizeFragmentListBuffers(_fragmentListCapacity);
 
-  _chunkEditingInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_ChunkEditingInfo),
-                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _octreeBuildInfoBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, sizeof(G_OctreeBuildInfo),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _indirectAllocNumBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, sizeof(G_IndirectDispatchInfo),
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+      MemoryStyle::kDedicated);
+
+  _fragmentListInfoBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, sizeof(G_FragmentListInfo),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _chunksInfoBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, sizeof(G_ChunksInfo),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _chunkEditingBatchBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, sizeof(G_ChunkEditingBatch),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _octreeBufferLengthBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, sizeof(uint32_t),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _octreeReservationInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, sizeof(G_OctreeReservationInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _fragmentListSaveInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, sizeof(G_FragmentListSaveInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _fieldBrickSaveInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, sizeof(G_FieldBrickSaveInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+      MemoryStyle::kDedicated);
+
+  _octreeBottomUpInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, sizeof(G_OctreeBottomUpInfo),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+
+  _octreeBufferLengthReadbackBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _chunkBuildSlotCount, 3 * sizeof(uint32_t),
+                                     VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryStyle::kHostVisible);
+}
+
+void SvoBuilder::_resizeFragmentListBuffers(uint32_t capacity) {
+  // the submitted builds might still be writing the current lists
+  bool const isDescriptorSetCreated = _descriptorSetBundle != nullptr;
+  if (isDescriptorSetCreated) {
+    VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores    = &_chunkSwapSemaphore;
+    waitInfo.pValues        = &_chunkSwapValue;
+    vkWaitSemaphores(_appContext->getDevice(), &waitInfo, UINT64_MAX);
+  }
 
-  _octreeBufferLengthBuffer = std::make_unique<Buffer>(
-      _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _fragmentListCapacity = capacity;
+  size_t const fragmentListBufferSize =
+      static_cast<size_t>(_fragmentListCapacity) * sizeof(G_FragmentListEntry);
+  _fragmentListBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, fragmentListBufferSize,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+
+  _logger->info("fragment list buffer size: {} mb (x{} build slots)",
+                static_cast<float>(fragmentListBufferSize) / (1024 * 1024), _chunkBuildSlotCount);
+
+  // the sort takes turns between the fragment list and the scratch list, with the histograms of
+  // every block of it
+  bool const isBottomUp = _configContainer->svoBuilderInfo->bottomUpOctreeBuild;
+  size_t const blockCount =
+      (static_cast<size_t>(_fragmentListCapacity) + kBottomUpBlockSize - 1) / kBottomUpBlockSize;
+  _fragmentListScratchBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount, isBottomUp ? fragmentListBufferSize : sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  _octreeBlockSumBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _chunkBuildSlotCount,
+      isBottomUp ? kRadixBinCount * blockCount * sizeof(uint32_t) : sizeof(uint32_t),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  _octreeBufferWriteOffsetBuffer = std::make_unique<Buffer>(
-      _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  if (!isDescriptorSetCreated) {
+    return;
+  }
+  _createDescriptorSetBundle();
+  _updatePipelinesDescriptorBundles();
+  _recordCommandBuffers();
 }
 
 void SvoBuilder::_initBufferData() {
   // clear the chunks buffer
-  std::vector<uint32_t> chunksData(_configContainer->terrainInfo->chunksDim.x *
-                                       _configContainer->terrainInfo->chunksDim.y *
-                                       _configContainer->terrainInfo->chunksDim.z,
-                                   0);
+  std::vector<ChunkIndicesEntry> chunksData(_configContainer->terrainInfo->chunksDim.x *
+                                                _configContainer->terrainInfo->chunksDim.y *
+                                                _configContainer->terrainInfo->chunksDim.z,
+                                            ChunkIndicesEntry{0});
   _chunkIndicesBuffer->fillData(chunksData.data());
+  std::vector<uint32_t> const chunkBounds(chunksData.size(), 0);
+  _chunkBoundsBuffer->fillData(chunkBounds.data());
+  std::vector<glm::uvec2> const chunkInstancesEntries(chunksData.size(), glm::uvec2{0});
+  _chunkInstancesBuffer->fillData(chunkInstancesEntries.data());
 }
 
 void SvoBuilder::_createDescriptorSetBundle() {
-  _descriptorSetBundle =
-      std::make_unique<DescriptorSetBundle>(_appContext, 1, VK_SHADER_STAGE_COMPUTE_BIT);
-
-  _descriptorSetBundle->bindStorageImage(0, _chunkFieldImage.get());
+  // one descriptor set per build slot
+  _descriptorSetBundle = std::make_unique<DescriptorSetBundle>(_appContext, _chunkBuildSlotCount,
+                                                               VK_SHADER_STAGE_COMPUTE_BIT);
+
+  std::vector<Image *> chunkFieldImages{};
+  chunkFieldImages.reserve(_chunkFieldImages.size());
+  for (auto const &chunkFieldImage : _chunkFieldImages) {
+    chunkFieldImages.push_back(chunkFieldImage.get());
+  }
+  _descriptorSetBundle->bindStorageImageBundle(0, chunkFieldImages);
 
   _descriptorSetBundle->bindStorageBuffer(1, _chunkIndicesBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(2, _indirectFragLengthBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(3, _counterBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(4, _chunkOctreeBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(5, _fragmentListBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(6, _octreeBuildInfoBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(7, _indirectAllocNumBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(8, _fragmentListInfoBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(9, _chunksInfoBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(10, _octreeBufferLengthBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(11, _octreeBufferWriteOffsetBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(12, _chunkEditingInfoBuffer.get());
+  _descriptorSetBundle->bindStorageBufferBundle(2, _indirectFragLengthBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(3, _counterBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(4, _chunkOctreeBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(5, _fragmentListBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(6, _octreeBuildInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(7, _indirectAllocNumBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(8, _fragmentListInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(9, _chunksInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(10, _octreeBufferLengthBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(11, _octreeReservationInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(12, _chunkEditingBatchBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferArray(13, getOctreeBufferPages(), kMaxOctreePageCount);
+  _descriptorSetBundle->bindStorageBuffer(14, _savedFragmentListBuffer.get());
+  _descriptorSetBundle->bindStorageBufferBundle(15, _fragmentListSaveInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBuffer(16, _fieldBrickPoolBuffer.get());
+  _descriptorSetBundle->bindStorageBufferBundle(17, _fieldBrickSaveInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(18, _fragmentListScratchBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(19, _octreeBlockSumBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(20, _octreeBottomUpInfoBufferBundle.get());
+
+  // the images of the slots past the array are never batched
+  chunkFieldImages.resize(std::min<size_t>(chunkFieldImages.size(), kMaxFieldBatchSize));
+  _descriptorSetBundle->bindStorageImageArray(21, chunkFieldImages, kMaxFieldBatchSize);
+  _descriptorSetBundle->bindStorageBuffer(22, _fieldBatchInfoBuffer.get());
+  if (_noiseVolumeImage != nullptr) {
+    _descriptorSetBundle->bindStorageImage(23, _noiseVolumeImage.get());
+    _descriptorSetBundle->bindImageSampler(24, _noiseVolumeImage.get());
+  }
+  _descriptorSetBundle->bindStorageBuffer(25, _chunkBoundsBuffer.get());
 
   _descriptorSetBundle->create();
 }
-
 void SvoBuilder::_createPipelines() {
   _chunkIndicesBufferUpdaterPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkIndicesBufferUpdater.comp"),
@@ -549,6 +3638,10 @@ void SvoBuilder::_createPipelines() {
       _appContext, _logger, this, _makeShaderFullPath("chunkFieldConstruction.comp"),
       WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
+  _chunkFieldBatchConstructionPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkFieldBatchConstruction.comp"),
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
   _chunkFieldModificationPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkFieldModification.comp"),
       WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
@@ -557,6 +3650,22 @@ void SvoBuilder::_createPipelines() {
       _appContext, _logger, this, _makeShaderFullPath("chunkVoxelCreation.comp"),
       WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
+  _chunkFragmentListLoadPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkFragmentListLoad.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _chunkFragmentListStorePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkFragmentListStore.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _chunkFieldBrickLoadPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkFieldBrickLoad.comp"),
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _chunkFieldBrickStorePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkFieldBrickStore.comp"),
+      WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
   _chunkModifyArgPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("chunkModifyArg.comp"),
       WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
@@ -568,6 +3677,8 @@ void SvoBuilder::_createPipelines() {
   _tagNodePipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeTagNode.comp"),
       WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+  // the full detail variant is built with the others, the coarser ones on their first recording
+  _tagNodePipeline->setSpecializationConstants({_voxelLevelCount});
 
   _allocNodePipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeAllocNode.comp"),
@@ -576,21 +3687,187 @@ void SvoBuilder::_createPipelines() {
   _modifyArgPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("octreeModifyArg.comp"),
       WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _chunkOctreeCopyPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkOctreeCopy.comp"),
+      WorkGroupSize{64, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  if (_noiseVolumeImage != nullptr) {
+    _noiseVolumeBakePipeline = std::make_unique<ComputePipeline>(
+        _appContext, _logger, this, _makeShaderFullPath("noiseVolumeBake.comp"),
+        WorkGroupSize{8, 8, 8}, _descriptorSetBundle.get(), _shaderCompiler,
+        _shaderChangeListener);
+  }
+
+  // the pass, the level count and the source list of the bottom-up build are pushed
+  uint32_t constexpr kBottomUpPushConstantSize = 3 * sizeof(uint32_t);
+
+  _octreeBottomUpArgPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("octreeBottomUpArg.comp"),
+      WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      kBottomUpPushConstantSize);
+
+  _octreeRadixCountPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("octreeRadixCount.comp"),
+      WorkGroupSize{kBottomUpBlockSize, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler,
+      _shaderChangeListener, kBottomUpPushConstantSize);
+
+  _octreeRadixScatterPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("octreeRadixScatter.comp"),
+      WorkGroupSize{kBottomUpBlockSize, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler,
+      _shaderChangeListener, kBottomUpPushConstantSize);
+
+  _octreeBlockScanPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("octreeBlockScan.comp"),
+      WorkGroupSize{256, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(uint32_t));
+
+  _octreeLevelCountPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("octreeLevelCount.comp"),
+      WorkGroupSize{kBottomUpBlockSize, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler,
+      _shaderChangeListener, kBottomUpPushConstantSize);
+
+  _octreeLevelScatterPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("octreeLevelScatter.comp"),
+      WorkGroupSize{kBottomUpBlockSize, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler,
+      _shaderChangeListener, kBottomUpPushConstantSize);
+
+  // the shaders are compiled concurrently, the constructors above only register the pipelines
+  std::vector<ComputePipeline *> pipelines{
+      _chunkIndicesBufferUpdaterPipeline.get(), _chunkFieldConstructionPipeline.get(),
+      _chunkFieldBatchConstructionPipeline.get(), _chunkFieldModificationPipeline.get(),
+      _chunkVoxelCreationPipeline.get(), _chunkFragmentListLoadPipeline.get(),
+      _chunkFragmentListStorePipeline.get(), _chunkFieldBrickLoadPipeline.get(),
+      _chunkFieldBrickStorePipeline.get(), _chunkModifyArgPipeline.get(), _initNodePipeline.get(),
+      _tagNodePipeline.get(), _allocNodePipeline.get(), _modifyArgPipeline.get(),
+      _chunkOctreeCopyPipeline.get(),
+      _octreeBottomUpArgPipeline.get(), _octreeRadixCountPipeline.get(),
+      _octreeRadixScatterPipeline.get(), _octreeBlockScanPipeline.get(),
+      _octreeLevelCountPipeline.get(), _octreeLevelScatterPipeline.get()};
+  if (_noiseVolumeBakePipeline != nullptr) {
+    pipelines.push_back(_noiseVolumeBakePipeline.get());
+  }
+  ComputePipeline::compileAndBuild(pipelines);
+}
+
+void SvoBuilder::_updatePipelinesDescriptorBundles() {
+  _chunkIndicesBufferUpdaterPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFieldConstructionPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFieldBatchConstructionPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFieldModificationPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkVoxelCreationPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFragmentListLoadPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFragmentListStorePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFieldBrickLoadPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkFieldBrickStorePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkModifyArgPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _initNodePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _tagNodePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _allocNodePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _modifyArgPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _chunkOctreeCopyPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _octreeBottomUpArgPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _octreeRadixCountPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _octreeRadixScatterPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _octreeBlockScanPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _octreeLevelCountPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _octreeLevelScatterPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  if (_noiseVolumeBakePipeline != nullptr) {
+    _noiseVolumeBakePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  }
+}
+
+void SvoBuilder::_recordCommandBuffers() {
+  for (auto &commandBuffer : _octreeCreationCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _buildCommandPool, 1, &commandBuffer);
+  }
+  _octreeCreationCommandBuffers.clear();
+
+  _octreeCreationCommandBuffers.resize(_chunkBuildSlotCount * _chunkLodCount);
+  for (uint32_t slotIndex = 0; slotIndex < _chunkBuildSlotCount; slotIndex++) {
+    for (uint32_t lod = 0; lod < _chunkLodCount; lod++) {
+      _recordOctreeCreationCommandBuffer(slotIndex, lod);
+    }
+  }
+}
+
+void SvoBuilder::_recordBottomUpOctreeCreationCommands(VkCommandBuffer commandBuffer,
+                                                       uint32_t slotIndex, uint32_t levelCount) {
+  VkMemoryBarrier shaderAccessBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  shaderAccessBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+  shaderAccessBarrier.dstAccessMask   = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                        VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+  auto const recordBarrier = [&]() {
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         0, 1, &shaderAccessBarrier, 0, nullptr, 0, nullptr);
+  };
+
+  // a block per workgroup, the arg pass sizes it to the source of the coming pass
+  VkBuffer const blockDispatchBuffer =
+      _indirectAllocNumBufferBundle->getBuffer(slotIndex)->getVkBuffer();
+
+  // the source alternates between the fragment list and the scratch list with every pass
+  std::array<uint32_t, 3> pushConstants = {levelCount, levelCount, 1};
+  auto const recordCompaction = [&](ComputePipeline *countPipeline,
+                                    ComputePipeline *scatterPipeline, uint32_t entriesPerBlock) {
+    countPipeline->recordIndirectCommand(commandBuffer, slotIndex, blockDispatchBuffer,
+                                         pushConstants.data());
+    recordBarrier();
+    _octreeBlockScanPipeline->recordCommand(commandBuffer, slotIndex, 1, 1, 1, &entriesPerBlock);
+    recordBarrier();
+    scatterPipeline->recordIndirectCommand(commandBuffer, slotIndex, blockDispatchBuffer,
+                                           pushConstants.data());
+    recordBarrier();
+    pushConstants[2] = pushConstants[2] == 0 ? 1 : 0;
+  };
+
+  // the morton codes are sorted from the lowest digit up, they have 3 bits per level
+  _chunkBuildProfiler->recordStageBegin(commandBuffer, slotIndex, ChunkBuildProfiler::kOctreeSort);
+  _octreeBottomUpArgPipeline->recordCommand(commandBuffer, slotIndex, 1, 1, 1,
+                                            pushConstants.data());
+  recordBarrier();
+  uint32_t const radixPassCount = (3 * levelCount + kRadixBitCount - 1) / kRadixBitCount;
+  for (uint32_t pass = 0; pass < radixPassCount; pass++) {
+    pushConstants[0] = pass;
+    recordCompaction(_octreeRadixCountPipeline.get(), _octreeRadixScatterPipeline.get(),
+                     kRadixBinCount);
+  }
+
+  // the fragments that share a voxel are merged into the leaves
+  pushConstants[0] = levelCount;
+  recordCompaction(_octreeLevelCountPipeline.get(), _octreeLevelScatterPipeline.get(), 1);
+  _chunkBuildProfiler->recordStageEnd(commandBuffer, slotIndex, ChunkBuildProfiler::kOctreeSort);
+
+  // each step writes the nodes of the level below it, from the leaves up to the root group, the
+  // stages line up with the ones of the level by level build
+  for (uint32_t step = levelCount; step-- > 0;) {
+    uint32_t const levelStage = ChunkBuildProfiler::kOctreeLevelBegin + step;
+    _chunkBuildProfiler->recordStageBegin(commandBuffer, slotIndex, levelStage);
+    pushConstants[0] = step;
+    _octreeBottomUpArgPipeline->recordCommand(commandBuffer, slotIndex, 1, 1, 1,
+                                              pushConstants.data());
+    recordBarrier();
+    recordCompaction(_octreeLevelCountPipeline.get(), _octreeLevelScatterPipeline.get(), 1);
+    _chunkBuildProfiler->recordStageEnd(commandBuffer, slotIndex, levelStage);
+  }
 }
 
-void SvoBuilder::_recordCommandBuffers() { _recordOctreeCreationCommandBuffer(); }
+void SvoBuilder::_recordOctreeCreationCommandBuffer(uint32_t slotIndex, uint32_t lod) {
+  VkCommandBuffer &commandBuffer = _octreeCreationCommandBuffers[slotIndex * _chunkLodCount + lod];
+  // a coarser octree has a level less per level of detail
+  uint32_t const levelCount = _voxelLevelCount - lod;
 
-void SvoBuilder::_recordOctreeCreationCommandBuffer() {
   VkCommandBufferAllocateInfo allocInfo{};
   allocInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-  allocInfo.commandPool        = _appContext->getCommandPool();
+  allocInfo.commandPool        = _buildCommandPool;
   allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
   allocInfo.commandBufferCount = 1;
 
-  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &_octreeCreationCommandBuffer);
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &commandBuffer);
 
   VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-  vkBeginCommandBuffer(_octreeCreationCommandBuffer, &beginInfo);
+  vkBeginCommandBuffer(commandBuffer, &beginInfo);
 
   // create the standard memory barrier
   VkMemoryBarrier shaderAccessBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
@@ -601,54 +3878,108 @@ void SvoBuilder::_recordOctreeCreationCommandBuffer() {
   indirectReadBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
   indirectReadBarrier.dstAccessMask   = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
 
-  _chunkModifyArgPipeline->recordCommand(_octreeCreationCommandBuffer, 0, 1, 1, 1);
+  _chunkModifyArgPipeline->recordCommand(commandBuffer, slotIndex, 1, 1, 1);
 
-  vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0, nullptr,
                        0, nullptr);
 
-  vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                        0, 1, &indirectReadBarrier, 0, nullptr, 0, nullptr);
 
   // step 2: octree construction
-
-  for (uint32_t level = 0; level < _voxelLevelCount; level++) {
-    _initNodePipeline->recordIndirectCommand(_octreeCreationCommandBuffer, 0,
-                                             _indirectAllocNumBuffer->getVkBuffer());
-    vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
-                         nullptr, 0, nullptr);
-
-    // that indirect buffer will no longer be updated, and it is made available by the previous
-    // barrier
-    _tagNodePipeline->recordIndirectCommand(_octreeCreationCommandBuffer, 0,
-                                            _indirectFragLengthBuffer->getVkBuffer());
-
-    // not last level
-    if (level != _voxelLevelCount - 1) {
-      vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
-                           nullptr, 0, nullptr);
-
-      _allocNodePipeline->recordIndirectCommand(_octreeCreationCommandBuffer, 0,
-                                                _indirectAllocNumBuffer->getVkBuffer());
-      vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
-                           nullptr, 0, nullptr);
-
-      _modifyArgPipeline->recordCommand(_octreeCreationCommandBuffer, 0, 1, 1, 1);
-
-      vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+  if (_configContainer->svoBuilderInfo->bottomUpOctreeBuild) {
+    _recordBottomUpOctreeCreationCommands(commandBuffer, slotIndex, levelCount);
+  } else {
+    // the variants are kept by the pipeline, so the buffers of the other levels of detail stay valid
+    _tagNodePipeline->setSpecializationConstants({levelCount});
+    for (uint32_t level = 0; level < levelCount; level++) {
+      uint32_t const levelStage = ChunkBuildProfiler::kOctreeLevelBegin + level;
+      _chunkBuildProfiler->recordStageBegin(commandBuffer, slotIndex, levelStage);
+      _initNodePipeline->recordIndirectCommand(
+          commandBuffer, slotIndex,
+          _indirectAllocNumBufferBundle->getBuffer(slotIndex)->getVkBuffer());
+      vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
                            nullptr, 0, nullptr);
 
-      vkCmdPipelineBarrier(_octreeCreationCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
-                               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           0, 1, &indirectReadBarrier, 0, nullptr, 0, nullptr);
+      // that indirect buffer will no longer be updated, and it is made available by the previous
+      // barrier
+      _tagNodePipeline->recordIndirectCommand(
+          commandBuffer, slotIndex,
+          _indirectFragLengthBufferBundle->getBuffer(slotIndex)->getVkBuffer());
+
+      // not last level
+      if (level != levelCount - 1) {
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
+                             nullptr, 0, nullptr);
+
+        _allocNodePipeline->recordIndirectCommand(
+            commandBuffer, slotIndex,
+            _indirectAllocNumBufferBundle->getBuffer(slotIndex)->getVkBuffer());
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
+                             nullptr, 0, nullptr);
+
+        _modifyArgPipeline->recordCommand(commandBuffer, slotIndex, 1, 1, 1);
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0,
+                             nullptr, 0, nullptr);
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                                 VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &indirectReadBarrier, 0, nullptr, 0, nullptr);
+      }
+      _chunkBuildProfiler->recordStageEnd(commandBuffer, slotIndex, levelStage);
     }
   }
 
-  vkEndCommandBuffer(_octreeCreationCommandBuffer);
+  // step 3: write the octree straight into its reservation, and point the chunk to it, both are
+  // skipped by the shaders if the reservation turns out to be too small
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0, nullptr,
+                       0, nullptr);
+  uint32_t const octreeCopyStage = _chunkBuildProfiler->getOctreeCopyStage();
+  _chunkBuildProfiler->recordStageBegin(commandBuffer, slotIndex, octreeCopyStage);
+  _chunkOctreeCopyPipeline->recordCommand(commandBuffer, slotIndex, kGridStrideCopyThreadCount, 1,
+                                          1);
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &shaderAccessBarrier, 0, nullptr,
+                       0, nullptr);
+  _chunkIndicesBufferUpdaterPipeline->recordCommand(commandBuffer, slotIndex, 1, 1, 1);
+  _chunkBuildProfiler->recordStageEnd(commandBuffer, slotIndex, octreeCopyStage);
+
+  // step 4: copy the octree length and the fragment count to the host visible readback buffer, so
+  // the host can trim the reservations later without a blocking fetch, and grow the fragment lists
+  // if they overflowed
+  VkMemoryBarrier transferReadBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  transferReadBarrier.srcAccessMask   = VK_ACCESS_SHADER_WRITE_BIT;
+  transferReadBarrier.dstAccessMask   = VK_ACCESS_TRANSFER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &transferReadBarrier, 0, nullptr, 0,
+                       nullptr);
+
+  VkBufferCopy octreeBufferLengthCopy = {0, 0, sizeof(uint32_t)};
+  vkCmdCopyBuffer(commandBuffer,
+                  _octreeBufferLengthBufferBundle->getBuffer(slotIndex)->getVkBuffer(),
+                  _octreeBufferLengthReadbackBufferBundle->getBuffer(slotIndex)->getVkBuffer(), 1,
+                  &octreeBufferLengthCopy);
+  VkBufferCopy fragmentCountCopy = {offsetof(G_FragmentListInfo, voxelFragmentCount),
+                                    sizeof(uint32_t), sizeof(uint32_t)};
+  vkCmdCopyBuffer(commandBuffer, _fragmentListInfoBufferBundle->getBuffer(slotIndex)->getVkBuffer(),
+                  _octreeBufferLengthReadbackBufferBundle->getBuffer(slotIndex)->getVkBuffer(), 1,
+                  &fragmentCountCopy);
+
+  // the semaphore signal only covers device access, so the host read is made visible explicitly
+  VkMemoryBarrier hostReadBarrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  hostReadBarrier.srcAccessMask   = VK_ACCESS_TRANSFER_WRITE_BIT;
+  hostReadBarrier.dstAccessMask   = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                       0, 1, &hostReadBarrier, 0, nullptr, 0, nullptr);
+
+  vkEndCommandBuffer(commandBuffer);
 }
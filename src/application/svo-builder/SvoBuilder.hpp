@@ -1,31 +1,50 @@
 #pragma once
 
+#include "BlockPalette.hpp"
+#include "SvoBuilderDataGpu.hpp"
+#include "WorldRegionStore.hpp"
 #include "custom-mem-alloc/CustomMemoryAllocator.hpp"
 #include "scheduler/Scheduler.hpp"
+#include "scheduler/TaskScheduler.hpp"
 #include "volk.h"
 
 #include "glm/glm.hpp" // IWYU pragma: export
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 struct ConfigContainer;
+struct VoxData;
 
 class DescriptorSetBundle;
 class ComputePipeline;
 class Logger;
 class VulkanApplicationContext;
 class Buffer;
+class ChunkOctreeCache;
+class ChunkBuildProfiler;
+class DynamicObjects;
+class BufferBundle;
 class Image;
+class Sampler;
 class ShaderCompiler;
 class ShaderChangeListener;
 
 class SvoBuilder : public PipelineScheduler {
 private:
+  // in world chunks, negative while streaming the chunks behind the starting point
   struct ChunkIndex {
-    uint32_t x;
-    uint32_t y;
-    uint32_t z;
+    int32_t x;
+    int32_t y;
+    int32_t z;
 
     bool operator==(const ChunkIndex &other) const {
       return x == other.x && y == other.y && z == other.z;
@@ -34,15 +53,144 @@ private:
 
   struct ChunkIndexHash {
     std::size_t operator()(const ChunkIndex &ci) const {
-      std::size_t hx = std::hash<uint32_t>()(ci.x);
-      std::size_t hy = std::hash<uint32_t>()(ci.y);
-      std::size_t hz = std::hash<uint32_t>()(ci.z);
+      std::size_t hx = std::hash<int32_t>()(ci.x);
+      std::size_t hy = std::hash<int32_t>()(ci.y);
+      std::size_t hz = std::hash<int32_t>()(ci.z);
 
       return hx ^ (hy << 1) ^ (hz << 2);
     }
   };
 
+  // a region of one of the octree buffer pages
+  struct OctreeAllocation {
+    uint32_t page = 0;
+    CustomMemoryAllocationResult region{};
+  };
+
+  // every build slot owns an independent set of staging resources (field image, fragment list,
+  // chunk octree buffer...), so that several chunks can be in flight on the gpu at the same time,
+  // the descriptor set, buffer bundles and images of a slot share the index of the slot
+  struct ChunkBuildSlot {
+    enum class State { kIdle, kBuilding };
+
+    State state = State::kIdle;
+    ChunkIndex chunkIndex{};
+    bool isEditing = false;
+    // the coarse build of an edit, which is swapped in ahead of the full build of the edit, it
+    // neither stores the field nor the fragment list, and is dropped instead of being retried
+    bool isPreview = false;
+    // the chunk is built at chunkVoxelDim / 2^lod, edits are built at full detail, their previews
+    // at SvoBuilderInfo::editPreviewLod
+    uint32_t lod = 0;
+    G_ChunkEditingBatch editingBatch{};
+    // the stroke the replaced saved field is journaled for
+    uint64_t editStroke = 0;
+    OctreeAllocation reservation{};
+    // the voxelized region of the chunk, edits with a saved fragment list narrow it down
+    glm::uvec3 regionOffset{};
+    glm::uvec3 regionExtent{};
+    G_FragmentListSaveInfo fragmentListSaveInfo{};
+    // of the fragment lists the build was submitted with, the retry of another slot may have grown
+    // them meanwhile, an overflow is only detected against the lists the gpu actually wrote
+    uint32_t fragmentListCapacity = 0;
+    // the fragments of an imported scene are uploaded by the host, instead of being voxelized
+    uint32_t importedFragmentCount = 0;
+    CustomMemoryAllocationResult fragmentListReservation{};
+    // set for the edits that store the field, the reservation fits the table and every brick
+    bool isStoringField = false;
+    G_FieldBrickSaveInfo fieldBrickSaveInfo{};
+    CustomMemoryAllocationResult fieldBrickReservation{};
+    // the build is finished once the chunk swap semaphore reaches this value
+    uint64_t timelineValue                    = 0;
+    VkCommandBuffer voxelizationCommandBuffer = VK_NULL_HANDLE;
+    std::chrono::steady_clock::time_point startTime{};
+    // the device of the group the build runs on, the builds of the other devices signal their own
+    // semaphores, and are merged into the first one, which renders, once they're finished
+    uint32_t deviceIndex               = 0;
+    VkCommandBuffer mergeCommandBuffer = VK_NULL_HANDLE;
+    uint64_t mergeTimelineValue        = 0;
+  };
+
+  // the brush stamps of a chunk are accumulated until the batch interval is over, or the batch is
+  // full, then the chunk is rebuilt once for all of them
+  struct PendingChunkEdit {
+    G_ChunkEditingBatch editingBatch{};
+    // a batch that holds the stamps of two strokes goes with the later one
+    uint64_t editStroke = 0;
+    std::chrono::steady_clock::time_point firstStampTime{};
+  };
+
+  // an octree region that was replaced by an edit, the frames in flight might still be tracing it
+  struct RetiredAllocation {
+    OctreeAllocation allocation;
+    uint32_t framesLeft;
+  };
+
+  // the saved field of an edited chunk, the least recently built ones are evicted to the host once
+  // the resident fields exceed their budget, the next build of the chunk uploads it again
+  struct SavedField {
+    CustomMemoryAllocationResult allocation{};
+    uint64_t lastUse = 0;
+  };
+
+  // filled by the staging ring once the copy of an evicted field is done, on whichever thread
+  // retires its batch
+  struct EvictedFieldCopy {
+    std::vector<uint32_t> field;
+    std::atomic<bool> isDone{false};
+  };
+  // the field stays saved until its copy is done, and is only evicted then if no build or journal
+  // step has used it since, which would have changed its last use
+  struct PendingFieldEviction {
+    uint64_t lastUse = 0;
+    std::shared_ptr<EvictedFieldCopy> copy;
+  };
+
+  // the saved fields that the edits of a brush stroke replaced, they stay in the field brick pool,
+  // so only the bricks around the surface are kept, nullopt stands for a chunk that was still the
+  // generated terrain, a step through the journal swaps them with the current fields, so that the
+  // same entry steps back again
+  struct EditJournalEntry {
+    uint64_t editStroke = 0;
+    std::unordered_map<ChunkIndex, std::optional<CustomMemoryAllocationResult>, ChunkIndexHash>
+        chunkFields;
+  };
+
+  // the buffers that the builds of another device of the group write, bound to the memory instance
+  // of that device, so the first device copies the results out of them
+  struct PeerBufferAliases {
+    std::vector<VkBuffer> octreePages{};
+    VkBuffer chunkIndices = VK_NULL_HANDLE;
+    VkBuffer chunkBounds  = VK_NULL_HANDLE;
+  };
+
+  // a chunk octree that is being copied to a lower page or a lower region of its page, the source
+  // is retired once the copy is finished
+  struct OctreeMove {
+    ChunkIndex chunkIndex;
+    OctreeAllocation source;
+  };
+
+  // the saved chunks of the world are copied into the readback buffer of a batch, which is written
+  // to their regions by a task once the copies are done, the batches form a ring, a batch is only
+  // refilled once its task is done
+  struct WorldSaveBatch {
+    std::unique_ptr<Buffer> readbackBuffer;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    TaskScheduler::TaskHandle writeTask{};
+  };
+
 public:
+  // the counters of the edits and of the octree allocator, the benchmark reports them per frame
+  struct EditStats {
+    // the builds of the edits that finished, a retried build is counted once
+    uint32_t editedChunkCount = 0;
+    // the gpu time of those builds, the retries and the previews included
+    double editBuildGpuTimeMs        = 0.0;
+    uint32_t octreeAllocationCount   = 0;
+    uint32_t octreeDeallocationCount = 0;
+  };
+
   SvoBuilder(VulkanApplicationContext *appContext, Logger *logger, ShaderCompiler *shaderCompiler,
              ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer);
   ~SvoBuilder() override;
@@ -58,13 +206,65 @@ public:
 
   void buildScene();
 
+  // queues the brush stamp, the chunks are rebuilt asynchronously on the compute queue
   void handleCursorHit(glm::vec3 hitPos, bool deletionMode);
-
-  Buffer *getAppendedOctreeBuffer() { return _appendedOctreeBuffer.get(); }
+  // queues a list of edits as a single stroke, for the procedural edits of the levels, every chunk
+  // they overlap is rebuilt once per kMaxChunkEditingStampCount of its edits, each rebuild applies
+  // them in one field modification pass, none of them is dropped
+  void applyEdits(std::vector<G_ChunkEditingInfo> const &edits);
+  // a stroke lasts while the brush is held, it's what a step of the edit journal undoes
+  void endEditStroke() { _isEditStrokeActive = false; }
+  // both are applied once the edits in flight have landed, only the chunks of the stroke are
+  // rebuilt, from their journaled fields
+  void undoEditStroke() { _requestedJournalSteps++; }
+  void redoEditStroke() { _requestedJournalSteps--; }
+
+  // called once per frame, picks up the finished edits and submits the pending ones, never blocks,
+  // while streaming, the chunk window follows the camera as well, ahead of its motion
+  void update(glm::vec3 cameraPosition, glm::vec3 cameraFront);
+
+  // writes the chunks edited since the last save to the world, and waits for the writes, it's
+  // done on the exit anyway
+  void saveWorld();
+
+  // the renderer waits on the completed value, so that the edited chunk indices are visible to it,
+  // until then, the previous octrees of the edited chunks are traced
+  [[nodiscard]] VkSemaphore getChunkSwapSemaphore() const { return _chunkSwapSemaphore; }
+  [[nodiscard]] uint64_t getCompletedChunkSwapValue() const { return _completedChunkSwapValue; }
+
+  // new pages are added while building, the render loop is asked to block then, so that the tracer
+  // can rebind them
+  [[nodiscard]] std::vector<Buffer *> getOctreeBufferPages() const;
+  // the device addresses of the pages, indexed by the page, only created if the tracer reads the
+  // pages through them, a new page is written into it before any chunk of it is visible
+  Buffer *getOctreePageAddressBuffer() { return _octreePageAddressBuffer.get(); }
   Buffer *getChunkIndicesBuffer() { return _chunkIndicesBuffer.get(); }
+  // the packed bounds of the voxels of the chunks, indexed like the chunk indices buffer
+  Buffer *getChunkBoundsBuffer() { return _chunkBoundsBuffer.get(); }
+  // the entries of the prefab instance tables of the chunks, indexed like the chunk indices buffer
+  Buffer *getChunkInstancesBuffer() { return _chunkInstancesBuffer.get(); }
+  // the colors that the leaves of the octrees index, it's replaced along with the scene
+  Buffer *getPaletteBuffer() { return _paletteBuffer.get(); }
 
   [[nodiscard]] uint32_t getVoxelLevelCount() const { return _voxelLevelCount; }
   [[nodiscard]] glm::uvec3 getChunksDim() const;
+  // the tracer maps the chunk indices with this origin, it follows the window once the entries of
+  // the chunks that left it are cleared
+  [[nodiscard]] glm::ivec3 getChunkWindowOrigin() const { return _visibleChunkWindowOrigin; }
+  // the chunks whose octrees were swapped since the last call, once the swaps are visible to the
+  // renderer, so that the tracer can tell whether its cached shadow map is outdated
+  std::vector<glm::ivec3> takeSwappedChunks();
+  // the chunks with an octree or prefab instances, the ones that are still built are included once
+  // their builds finish, which is before their swaps are visible, their entries are empty till then
+  [[nodiscard]] std::vector<glm::ivec3> getNonEmptyChunks() const;
+  // the objects that move over the chunks, they're traced from their own octrees
+  DynamicObjects *getDynamicObjects() { return _dynamicObjects.get(); }
+  // stores the octree of a dynamic object shape in the pages, only its region is written, and the
+  // upload is waited for, returns the page and the offset in words, or nullopt if it doesn't fit,
+  // the region is freed along with the whole scene
+  std::optional<glm::uvec2> uploadObjectOctree(std::vector<uint32_t> const &octree);
+  // the counters since the last call
+  EditStats takeEditStats() { return std::exchange(_editStats, EditStats{}); }
 
 private:
   VulkanApplicationContext *_appContext;
@@ -74,63 +274,375 @@ private:
 
   ConfigContainer *_configContainer;
 
-  uint32_t _voxelLevelCount = 0;
+  uint32_t _voxelLevelCount      = 0;
+  uint32_t _chunkLodCount        = 0;
+  uint32_t _chunkBuildSlotCount  = 0;
+  uint32_t _octreeLengthEstimate = 0; // in uint32
+  uint32_t _fragmentCountEstimate = 0;
+  // in entries, of the fragment list of every build slot, it grows with the overflowing builds
+  uint32_t _fragmentListCapacity = 0;
 
   std::unique_ptr<DescriptorSetBundle> _descriptorSetBundle;
-  std::unique_ptr<CustomMemoryAllocator> _chunkBufferMemoryAllocator;
-
-  VkCommandBuffer _octreeCreationCommandBuffer = VK_NULL_HANDLE;
-
-  std::vector<ChunkIndex> _getEditingChunks(glm::vec3 centerPos, float radius);
+  // one allocator per octree buffer page
+  std::vector<std::unique_ptr<CustomMemoryAllocator>> _octreePageAllocators;
+  std::unique_ptr<CustomMemoryAllocator> _fragmentListMemoryAllocator;
+  std::unique_ptr<CustomMemoryAllocator> _fieldBrickPoolMemoryAllocator;
+
+  VkCommandPool _buildCommandPool = VK_NULL_HANDLE;
+  std::vector<ChunkBuildSlot> _chunkBuildSlots;
+  // one per slot and level of detail, the octree of each level has its own depth
+  std::vector<VkCommandBuffer> _octreeCreationCommandBuffers;
+
+  // signaled by every chunk build on the compute queue
+  VkSemaphore _chunkSwapSemaphore   = VK_NULL_HANDLE;
+  uint64_t _chunkSwapValue          = 0;
+  uint64_t _completedChunkSwapValue = 0;
+  // the finished builds, with the chunk swap value that makes them visible
+  std::vector<std::pair<uint64_t, glm::ivec3>> _swappedChunks;
+
+  // the builds on the other devices of a group, indexed by the device, the first entries are
+  // unused, every device signals its own semaphore, since they finish out of submission order
+  std::vector<VkSemaphore> _peerBuildSemaphores;
+  std::vector<uint64_t> _peerBuildValues;
+  std::vector<PeerBufferAliases> _peerBufferAliases;
+
+  // the stamps that don't fit into a full batch start the next one of the chunk, its batches are
+  // built one after another, none of them is ever empty
+  std::unordered_map<ChunkIndex, std::deque<PendingChunkEdit>, ChunkIndexHash> _pendingChunkEdits;
+  std::vector<RetiredAllocation> _retiredAllocations;
+  EditStats _editStats{};
+
+  // the latest stroke is at the back of both, a new stroke clears the undone ones
+  std::vector<EditJournalEntry> _undoJournal;
+  std::vector<EditJournalEntry> _redoJournal;
+  uint64_t _editStrokeCount = 0;
+  bool _isEditStrokeActive  = false;
+  // positive for undos, negative for redos
+  int32_t _requestedJournalSteps = 0;
+  // the chunks whose fields have been swapped by a journal step, built before the edits
+  std::vector<ChunkIndex> _pendingChunkRestores;
+
+  // the compaction moves a batch of octrees per frame with a single submission on the compute
+  // queue, which points the chunk indices to the new regions as well
+  VkCommandBuffer _compactionCommandBuffer = VK_NULL_HANDLE;
+  std::vector<OctreeMove> _inFlightOctreeMoves;
+  uint64_t _compactionTimelineValue = 0;
+
+  // the fields of the generated chunks submitted together are constructed by a single dispatch,
+  // which goes ahead of their builds with a submission of its own
+  VkCommandBuffer _fieldBatchCommandBuffer = VK_NULL_HANDLE;
+  uint64_t _fieldBatchTimelineValue        = 0;
+  // set whenever the octree pool changes, cleared once a compaction pass finds nothing to move
+  bool _octreeBufferMayHaveHoles = false;
+  // logs once per time the streamed builds are held back by the budgets
+  bool _isOverOctreePoolBudget = false;
+
+  // the chunks are streamed in a window of chunksDim, which only moves in xz, the window is moved
+  // first, and the tracer follows once the entries of the left chunks are cleared on the gpu
+  glm::ivec3 _chunkWindowOrigin{0};
+  glm::ivec3 _visibleChunkWindowOrigin{0};
+  uint64_t _chunkWindowShiftTimelineValue        = 0;
+  VkCommandBuffer _chunkWindowShiftCommandBuffer = VK_NULL_HANDLE;
+  // the octrees of the left chunks, retired once the tracer follows the window
+  std::vector<OctreeAllocation> _chunkWindowLeavingAllocations;
+  // the frames in flight still trace with the previous origin, no entry is written until they
+  // are done
+  uint32_t _chunkWindowSettleFramesLeft = 0;
+  // the chunks that entered the window, or whose level of detail is outdated, they are built in the
+  // background, the one the camera is expected to see first is at the back
+  std::vector<ChunkIndex> _pendingChunkBuilds;
+
+  // the levels of detail follow the chunk the camera is in
+  glm::ivec3 _cameraChunk{0};
+  glm::ivec3 _lodCameraChunk{0};
+  // the camera of the last update, the velocity is smoothed over the frames, in chunks per second
+  glm::vec3 _cameraPosition{0.F};
+  glm::vec3 _cameraFront{0.F, 0.F, -1.F};
+  glm::vec3 _cameraVelocity{0.F};
+  std::chrono::steady_clock::time_point _lastCameraUpdateTime{};
+  // the level of detail of every built chunk, the empty ones included
+  std::unordered_map<ChunkIndex, uint32_t, ChunkIndexHash> _chunkIndexToLod;
+
+  [[nodiscard]] bool _isStreamingChunks() const;
+  [[nodiscard]] bool _isChunkWindowSettled() const;
+  // mirrors getChunksBufferLinearIndex of chunking.glsl
+  [[nodiscard]] uint32_t _getChunksBufferLinearIndex(ChunkIndex const &chunkIndex) const;
+  [[nodiscard]] bool _isInChunkWindow(ChunkIndex const &chunkIndex, glm::ivec3 windowOrigin) const;
+  [[nodiscard]] std::vector<ChunkIndex> _getChunkWindow(glm::ivec3 windowOrigin) const;
+
+  // publishes the moved window to the tracer, and moves it again once the camera has left its
+  // centre chunk, only while no build or compaction is in flight
+  void _updateChunkWindow();
+  // drops the chunks that leave the window, clears their entries in a single submission, and
+  // queues the entering ones nearest first
+  void _submitChunkWindowShift(glm::ivec3 newOrigin);
+
+  void _updateCameraMotion(glm::vec3 cameraPosition, glm::vec3 cameraFront);
+  // the chunk the camera is expected in after the lookahead, the window is centred on it
+  [[nodiscard]] glm::ivec3 _getPredictedCameraChunk() const;
+  // in seconds, the time the camera takes to close in on the chunk, or to turn to it, the queued
+  // chunks are built and loaded in this order
+  [[nodiscard]] float _getTimeToVisibility(ChunkIndex const &chunkIndex) const;
+
+  // by the distance rings around the camera chunk, on the xz plane
+  [[nodiscard]] uint32_t _decideChunkLod(ChunkIndex const &chunkIndex) const;
+  // queues the built chunks whose level of detail differs from the one of their ring, the edited
+  // chunks are kept at full detail, a coarser build would drop their edits
+  void _queueChunkLodChanges();
+  void _sortPendingChunkBuilds();
+  [[nodiscard]] bool _isChunkInFlight(ChunkIndex const &chunkIndex) const;
+  // the most urgent pending chunk that isn't in flight is submitted into every idle slot,
+  // non-blocking, nothing is submitted past the deadline
+  void _submitPendingChunkBuilds(std::chrono::steady_clock::time_point deadline);
+
+  // the chunks of the window that the box overlaps
+  std::vector<ChunkIndex> _getEditingChunks(glm::vec3 minPos, glm::vec3 maxPos);
+  // adds the edit to the pending batches of the chunks it overlaps
+  void _queueEdit(G_ChunkEditingInfo const &edit);
+
+  void _createChunkBuildSlots();
+  void _destroyChunkBuildSlots();
+
+  // the operations on the pools are recorded for the allocator benchmark if a trace file is set
+  [[nodiscard]] bool _isTracingAllocations() const;
+  void _writeAllocationTraces() const;
 
   void _recordCommandBuffers();
-  void _recordOctreeCreationCommandBuffer();
-
-  void _editExistingChunk(ChunkIndex chunkIndex);
-  void _buildChunkFromNoise(ChunkIndex chunkIndex);
+  void _recordOctreeCreationCommandBuffer(uint32_t slotIndex, uint32_t lod);
+  // the alternative to the level by level tagging, see octreeBottomUp.glsl
+  void _recordBottomUpOctreeCreationCommands(VkCommandBuffer commandBuffer, uint32_t slotIndex,
+                                             uint32_t levelCount);
+
+  // the level of the edit previews, within the levels of the chunks, 0 if they're disabled
+  [[nodiscard]] uint32_t _getEditPreviewLod() const;
+  void _submitPendingChunkEdits();
+  // with more batches queued than SvoBuilder.maxPendingEditBatches, the builds in flight are waited
+  // for, and the batches are submitted into the freed slots, until they're back under the cap
+  void _drainPendingChunkEdits();
+  void _releaseRetiredAllocations();
+
+  // takes the field that the finished edit replaced, if it's the first one of its stroke for the
+  // chunk, it's freed otherwise, the oldest strokes are dropped once the journal exceeds its budget
+  void _journalReplacedSavedField(uint64_t editStroke, ChunkIndex const &chunkIndex,
+                                  std::optional<CustomMemoryAllocationResult> replacedField);
+  void _clearEditJournal(std::vector<EditJournalEntry> &journal);
+  // waits for the edits of the strokes to land, and for their chunks to leave the slots
+  void _applyRequestedJournalSteps();
+  void _swapJournaledSavedFields(EditJournalEntry &entry);
+  void _submitPendingChunkRestores();
+
+  // retires the sources of the finished moves, and submits the next batch
+  void _updateOctreeCompaction();
+  // moves the highest chunk octrees that fit into a lower hole, returns false if there are none
+  bool _submitOctreeCompactionBatch();
+
+  // the whole chunk build is a single non-blocking submission, the chunk swap semaphore reaches the
+  // value of the slot once the octree is in the appended octree buffer, a zero reserved length uses
+  // the running estimate
+  void _submitChunkBuild(uint32_t slotIndex, ChunkIndex chunkIndex, bool isEditing,
+                         uint32_t reservedOctreeLength = 0, bool isFieldBatched = false);
+  // submits the builds of the generated chunks, sharing a batched field construction if enabled
+  void _submitGeneratedChunkBuilds(std::vector<std::pair<uint32_t, ChunkIndex>> const &builds);
+  void _submitFieldBatch(std::vector<std::pair<uint32_t, ChunkIndex>> const &builds);
+  // mirrors the final allocation of a finished slot, returns false if the slot has been resubmitted
+  // because its reservation overflowed
+  bool _finishChunkBuild(uint32_t slotIndex);
+  // the builds of the first device are judged by the last read chunk swap value
+  void _finishCompletedChunkBuilds();
+  // the field of a batched build is already constructed by the batch
+  void _recordChunkVoxelizationCommands(uint32_t slotIndex, bool applyEdit, bool loadSavedField,
+                                        bool isFieldBatched);
+  // the saved fields are at full detail, in uint32
+  [[nodiscard]] uint32_t _getFieldBrickTableLength() const;
+  // the copies go through the staging ring, neither waits for them, the builds that read an
+  // uploaded field wait on the ring, the evictions are finished by a later update
+  void _evictColdSavedFields();
+  void _finishSavedFieldEvictions();
+  void _uploadEvictedSavedField(ChunkIndex const &chunkIndex);
+  // the voxels that the stamps of the editing batch can reach, including the ones whose corners
+  // are reached
+  void _decideDirtyRegion(ChunkBuildSlot &slot) const;
+
+  // the fragments of an imported chunk are copied into the mapped staging buffer of the slot, and
+  // fed to the octree creation from there, the voxelization is skipped
+  void _recordChunkFragmentUploadCommands(uint32_t slotIndex);
+  void _loadVoxScene();
+  // the octrees of the prefabs of the imported scene are built on the host and stored once, the
+  // chunks that their instances overlap get tables of them, both are written into the pages after
+  // the scene is optimized, which packs the pages anew
+  void _uploadPrefabInstances();
+  std::unique_ptr<DynamicObjects> _dynamicObjects;
+
+  // streams the octrees of the cache into the pages through a staging ring, returns false if the
+  // cache turns out to be broken, nothing is kept then
+  bool _loadChunkOctreesFromCache(ChunkOctreeCache &cache);
+  void _saveChunkOctreesToCache(ChunkOctreeCache &cache);
+  // merges the identical subtrees of the octrees of a freshly built scene, and lays their nodes out
+  // in traversal order, the octrees of a page are packed from its start again afterwards
+  void _optimizeChunkOctrees();
+  // the generated chunks are spread over the devices of a group, the edits, the saved fields, the
+  // imported scenes and the field batches stay on the first one
+  [[nodiscard]] uint32_t _decideChunkBuildDevice(uint32_t slotIndex) const;
+  [[nodiscard]] VkSemaphore _getChunkBuildSemaphore(uint32_t slotIndex) const;
+  // the aliases of the pages are added along with the pages
+  void _createPeerBufferAliases();
+  void _destroyPeerBufferAliases();
+  // copies the octree, the chunk indices entry and the bounds of a build of another device to the
+  // first one, returns the chunk swap value the chunk is swapped at
+  uint64_t _submitChunkBuildMerge(uint32_t slotIndex, uint32_t octreeBufferLength);
+  bool _isChunkBuildSlotFinished(uint32_t slotIndex);
+  void _waitForChunkBuildSlot(uint32_t slotIndex);
+  void _waitForAllChunkBuildSlots();
+
+  // only with a world name, the edited chunks are saved to its regions, and loaded back once their
+  // chunks are in the window
+  std::unique_ptr<WorldRegionStore> _worldRegionStore;
+  // the chunks whose saved fields have changed since they were written
+  std::unordered_set<ChunkIndex, ChunkIndexHash> _dirtyWorldChunks;
+  std::vector<WorldSaveBatch> _worldSaveBatches;
+  uint32_t _nextWorldSaveBatch = 0;
+  std::chrono::steady_clock::time_point _lastWorldSaveTime{};
+  // the chunks read by the load tasks, they're taken over on the render thread
+  std::vector<TaskScheduler::TaskHandle> _worldLoadTasks;
+  std::mutex _loadedWorldChunksMutex;
+  std::vector<std::pair<glm::ivec3, WorldRegionStore::ChunkData>> _loadedWorldChunks;
+  std::vector<std::pair<glm::ivec3, WorldRegionStore::ChunkData>> _pendingWorldChunks;
+
+  void _createWorldRegionStore();
+  [[nodiscard]] uint64_t _makeWorldBuilderKey() const;
+  void _markWorldChunkDirty(ChunkIndex const &chunkIndex);
+  // the octree is only saved if it's built from the current field, that is, if no build of the
+  // chunk is in flight or pending
+  [[nodiscard]] bool _isChunkOctreeCurrent(ChunkIndex const &chunkIndex) const;
+  // fills the next batch of the ring with the chunks at the front, which are taken from the list,
+  // the batch is waited for if its previous task isn't done
+  void _submitWorldSaveBatch(std::vector<ChunkIndex> &chunkIndices);
+  void _saveWorldChunks(std::vector<ChunkIndex> chunkIndices);
+  // submits a batch of the dirty chunks once the save interval is over, if the ring has room
+  void _updateWorldSave();
+  // the reads wait for the writes in flight, so a chunk that returns reads its latest save
+  void _requestWorldChunks(std::vector<ChunkIndex> const &chunkIndices);
+  // the field of a loaded chunk replaces the generated one, its octree is uploaded through the
+  // staging ring, or it's built from the field if there's none, the uploads of a frame are bounded
+  // by the size and the deadline, the most urgent chunks go first
+  void _applyLoadedWorldChunks(size_t uploadBudget,
+                               std::chrono::steady_clock::time_point deadline =
+                                   std::chrono::steady_clock::time_point::max());
+  // the window is loaded right away
+  void _loadWorldWindow();
+
+  // set if an imported scene replaces the generated terrain, it's kept for the scene rebuilds
+  std::unique_ptr<VoxData> _voxData;
+  // the palette of the current scene, it's saved along with the octrees of the cache
+  BlockPalette::Palette _palette{};
+  void _setPalette(BlockPalette::Palette const &palette);
+
+  std::unique_ptr<ChunkBuildProfiler> _chunkBuildProfiler;
 
   /// IMAGES
-  std::unique_ptr<Image> _chunkFieldImage;
-  std::unordered_map<ChunkIndex, std::unique_ptr<Image>, ChunkIndexHash>
-      _chunkIndexToFieldImagesMap;
+  // the dense field of the chunk being built, the edited chunks keep theirs as field bricks
+  std::vector<std::unique_ptr<Image>> _chunkFieldImages;
+  std::unordered_map<ChunkIndex, SavedField, ChunkIndexHash> _chunkIndexToSavedField;
+  // the evicted fields keep their brick layout, which already leaves out the uniform bricks
+  std::unordered_map<ChunkIndex, std::vector<uint32_t>, ChunkIndexHash> _chunkIndexToEvictedField;
+  std::unordered_map<ChunkIndex, PendingFieldEviction, ChunkIndexHash> _pendingFieldEvictions;
+  // counts the chunk builds, it orders the saved fields by their last use
+  uint64_t _savedFieldUseCount = 0;
+  std::unordered_map<ChunkIndex, OctreeAllocation, ChunkIndexHash> _chunkIndexToBufferAllocResult;
+  // the chunks with prefab instances, the prefab octrees and the instance tables are never freed
+  // on their own, only along with the whole scene
+  std::vector<ChunkIndex> _instancedChunks;
   std::unordered_map<ChunkIndex, CustomMemoryAllocationResult, ChunkIndexHash>
-      _chunkIndexToBufferAllocResult;
+      _chunkIndexToFragmentListAllocResult;
+  // one period of the gradient noise, the lowest octaves of the terrain are filtered from it when
+  // they're baked, see TerrainInfo::bakedNoiseOctaveCount
+  std::unique_ptr<Sampler> _noiseVolumeSampler;
+  std::unique_ptr<Image> _noiseVolumeImage;
   void _createImages();
+  void _bakeNoiseVolume();
 
   /// BUFFERS
   std::unique_ptr<Buffer> _chunkIndicesBuffer;
-  std::unique_ptr<Buffer> _appendedOctreeBuffer;
-  std::unique_ptr<Buffer> _chunksInfoBuffer;
-  std::unique_ptr<Buffer> _chunkEditingInfoBuffer;
-  std::unique_ptr<Buffer> _octreeBufferLengthBuffer;
-  std::unique_ptr<Buffer> _octreeBufferWriteOffsetBuffer;
-
-  std::unique_ptr<Buffer> _indirectFragLengthBuffer;
-  std::unique_ptr<Buffer> _counterBuffer;
-  std::unique_ptr<Buffer> _chunkOctreeBuffer;
-  std::unique_ptr<Buffer> _fragmentListBuffer;
-  std::unique_ptr<Buffer> _octreeBuildInfoBuffer;
-  std::unique_ptr<Buffer> _indirectAllocNumBuffer;
-  std::unique_ptr<Buffer> _fragmentListInfoBuffer;
-
-  void _createBuffers(size_t octreeBufferSize);
+  std::unique_ptr<Buffer> _chunkBoundsBuffer;
+  std::unique_ptr<Buffer> _chunkInstancesBuffer;
+  std::unique_ptr<Buffer> _paletteBuffer;
+  std::vector<std::unique_ptr<Buffer>> _octreeBufferPages;
+  std::unique_ptr<Buffer> _octreePageAddressBuffer;
+  size_t _octreePageSize = 0;
+  std::unique_ptr<Buffer> _savedFragmentListBuffer;
+  std::unique_ptr<Buffer> _fieldBrickPoolBuffer;
+  std::unique_ptr<Buffer> _fieldBatchInfoBuffer;
+
+  // per build slot
+  std::unique_ptr<BufferBundle> _chunksInfoBufferBundle;
+  std::unique_ptr<BufferBundle> _octreeBufferLengthBufferBundle;
+  std::unique_ptr<BufferBundle> _octreeReservationInfoBufferBundle;
+  std::unique_ptr<BufferBundle> _indirectFragLengthBufferBundle;
+  std::unique_ptr<BufferBundle> _counterBufferBundle;
+  std::unique_ptr<BufferBundle> _chunkOctreeBufferBundle;
+  std::unique_ptr<BufferBundle> _fragmentListBufferBundle;
+  std::unique_ptr<BufferBundle> _octreeBuildInfoBufferBundle;
+  std::unique_ptr<BufferBundle> _indirectAllocNumBufferBundle;
+  std::unique_ptr<BufferBundle> _fragmentListInfoBufferBundle;
+  std::unique_ptr<BufferBundle> _chunkEditingBatchBufferBundle;
+  std::unique_ptr<BufferBundle> _fragmentListSaveInfoBufferBundle;
+  std::unique_ptr<BufferBundle> _fieldBrickSaveInfoBufferBundle;
+  // the bottom-up octree build only, the scratch list and the block sums are left tiny without it
+  std::unique_ptr<BufferBundle> _fragmentListScratchBufferBundle;
+  std::unique_ptr<BufferBundle> _octreeBlockSumBufferBundle;
+  std::unique_ptr<BufferBundle> _octreeBottomUpInfoBufferBundle;
+
+  // host visible, only created for an imported scene, sized for its largest chunk
+  std::unique_ptr<BufferBundle> _fragmentListStagingBufferBundle;
+
+  // host visible copy of the octree length, the fragment count and the field brick count, filled
+  // at the end of the build
+  std::unique_ptr<BufferBundle> _octreeBufferLengthReadbackBufferBundle;
+
+  void _createBuffers(size_t savedFragmentListBufferSize, size_t fieldBrickPoolBufferSize);
+  // recreates the fragment lists of the build slots, once the descriptor sets exist, the submitted
+  // builds are waited for, and the descriptor sets and the command buffers are made again
+  void _resizeFragmentListBuffers(uint32_t capacity);
+  // takes the region from the first page that fits it, a page is added if none of them does
+  OctreeAllocation _allocateOctreeRegion(size_t size);
+  // whether the region fits into a page, or a page can be added within the budgets
+  [[nodiscard]] bool _canAllocateOctreeRegionWithinBudget(size_t size) const;
+  void _addOctreeBufferPage();
+  void _deallocateOctreeRegion(OctreeAllocation const &allocation);
   void _initBufferData();
-  void _resetBufferDataForNewChunkGeneration(ChunkIndex chunkIndex);
+  void _recordBufferDataResetForNewChunkGeneration(VkCommandBuffer commandBuffer,
+                                                   uint32_t slotIndex, ChunkIndex chunkIndex);
 
   /// PIPELINES
 
   std::unique_ptr<ComputePipeline> _chunkIndicesBufferUpdaterPipeline;
 
   std::unique_ptr<ComputePipeline> _chunkFieldConstructionPipeline;
+  std::unique_ptr<ComputePipeline> _chunkFieldBatchConstructionPipeline;
   std::unique_ptr<ComputePipeline> _chunkFieldModificationPipeline;
   std::unique_ptr<ComputePipeline> _chunkVoxelCreationPipeline;
+  std::unique_ptr<ComputePipeline> _chunkFragmentListLoadPipeline;
+  std::unique_ptr<ComputePipeline> _chunkFragmentListStorePipeline;
+  std::unique_ptr<ComputePipeline> _chunkFieldBrickLoadPipeline;
+  std::unique_ptr<ComputePipeline> _chunkFieldBrickStorePipeline;
   std::unique_ptr<ComputePipeline> _chunkModifyArgPipeline;
+  // only created if the noise is baked
+  std::unique_ptr<ComputePipeline> _noiseVolumeBakePipeline;
 
   std::unique_ptr<ComputePipeline> _initNodePipeline;
   std::unique_ptr<ComputePipeline> _tagNodePipeline;
   std::unique_ptr<ComputePipeline> _allocNodePipeline;
   std::unique_ptr<ComputePipeline> _modifyArgPipeline;
+  std::unique_ptr<ComputePipeline> _chunkOctreeCopyPipeline;
+
+  std::unique_ptr<ComputePipeline> _octreeBottomUpArgPipeline;
+  std::unique_ptr<ComputePipeline> _octreeRadixCountPipeline;
+  std::unique_ptr<ComputePipeline> _octreeRadixScatterPipeline;
+  std::unique_ptr<ComputePipeline> _octreeBlockScanPipeline;
+  std::unique_ptr<ComputePipeline> _octreeLevelCountPipeline;
+  std::unique_ptr<ComputePipeline> _octreeLevelScatterPipeline;
 
   void _createDescriptorSetBundle();
   void _createPipelines();
+  void _updatePipelinesDescriptorBundles();
 };
\ No newline at end of file
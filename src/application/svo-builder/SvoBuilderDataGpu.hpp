@@ -14,15 +14,18 @@
 
 #define vec3 alignas(16) glm::vec3
 #define uvec3 alignas(16) glm::uvec3
+#define ivec3 alignas(16) glm::ivec3
 #define vec2 alignas(8) glm::vec2
 #define mat4 alignas(16) glm::mat4
 #define uvec2 alignas(8) glm::uvec2
 #define uint uint32_t
 
+#include "blockType.glsl"             // IWYU pragma: export
 #include "svoBuilderDataStructs.glsl" // IWYU pragma: export
 
 #undef vec3
 #undef uvec3
+#undef ivec3
 #undef vec2
 #undef mat4
 #undef uvec2
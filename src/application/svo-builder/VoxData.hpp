@@ -1,13 +1,36 @@
 #pragma once
 
+#include "BlockPalette.hpp"
 #include "SvoBuilderDataGpu.hpp"
 
-#include <array>
 #include <cstdint>
 #include <vector>
 
-struct VoxData {
+// a model of the scene that is traced through its instances, instead of being baked into the chunks
+struct VoxPrefab {
+  // of the model, in voxels, y is up
+  glm::uvec3 dim;
+  // the power of two that the octree of the prefab spans, at least dim
   uint32_t voxelResolution;
-  std::vector<G_FragmentListEntry> fragmentList;
-  std::array<uint32_t, 256> paletteData;
+  // the surface voxels of the model, the coordinates are local to the prefab
+  std::vector<G_FragmentListEntry> fragments;
+};
+
+struct VoxPrefabInstance {
+  uint32_t prefabIndex;
+  // of the min corner of the model, in voxels of the chunk grid
+  glm::uvec3 voxelPos;
+};
+
+struct VoxData {
+  // the extent of all instances, in voxels, y is up
+  glm::uvec3 sceneDim;
+  // the surface voxels of the scene, indexed by the linear index of the chunk that contains them,
+  // the coordinates of the fragments are local to their chunk
+  std::vector<std::vector<G_FragmentListEntry>> chunkFragmentLists;
+  // indexed by the leaves of the imported chunks
+  BlockPalette::Palette paletteData;
+  // empty unless the prefabs are enabled, their instances are left out of the fragment lists
+  std::vector<VoxPrefab> prefabs;
+  std::vector<VoxPrefabInstance> prefabInstances;
 };
@@ -1,15 +1,34 @@
 #include "VoxLoader.hpp"
 
+#include "scheduler/TaskScheduler.hpp"
+#include "utils/logger/Logger.hpp"
+
 #define OGT_VOX_IMPLEMENTATION
 #include "ogt_vox.h"
 
-#include <cassert>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
-#include <cstdio>
-#include <iostream>
+#include <limits>
 #include <vector>
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 // https://github.com/jpaver/opengametools/blob/master/demo/demo_vox.cpp
 namespace VoxLoader {
 struct InstanceData {
@@ -18,83 +37,132 @@ struct InstanceData {
 };
 
 namespace {
-// a helper function to load a magica voxel scene given a filename.
-ogt_vox_scene const *_loadVoxelScene(std::string const &pathToFile, uint32_t sceneReadFlags = 0) {
-  // open the file
-  FILE *fp = nullptr;
-  if (fopen_s(&fp, pathToFile.c_str(), "rb") != 0) {
-    fp = nullptr;
-  }
-  assert(fp != nullptr && "failed to open vox file, check the path");
-
-  // get the buffer size which matches the size of the file
-  fseek(fp, 0, SEEK_END);
-  uint32_t const bufferSize = ftell(fp);
-  fseek(fp, 0, SEEK_SET);
-
-  // load the file into a memory buffer
-  std::vector<uint8_t> voxBuffer(bufferSize);
-  fread(voxBuffer.data(), bufferSize, 1, fp);
-  fclose(fp);
-
-  // construct the scene from the buffer
-  ogt_vox_scene const *scene =
-      ogt_vox_read_scene_with_flags(voxBuffer.data(), bufferSize, sceneReadFlags);
-
-  assert(scene != nullptr && "failed to load vox scene");
-  return scene;
-}
-
-uint32_t _getVoxelResolution(ogt_vox_scene const *scene,
-                             std::vector<InstanceData> const &instanceData) {
-  // assert(model->size_x == model->size_y && model->size_y == model->size_z &&
-  //        "only cubic models are supported");
-  // assert((model->size_x & (model->size_x - 1)) == 0 && "model size must be a power of 2");
-
-  // find min and maxextent of x, y, and z by iterating over all instances
-  int minExtentX = std::numeric_limits<int>::max();
-  int minExtentY = std::numeric_limits<int>::max();
-  int minExtentZ = std::numeric_limits<int>::max();
-  int maxExtentX = std::numeric_limits<int>::min();
-  int maxExtentY = std::numeric_limits<int>::min();
-  int maxExtentZ = std::numeric_limits<int>::min();
+// a read only view of the whole file, the scene is parsed right from the mapping, so the file is
+// never copied into a buffer of its own
+class MappedFile {
+public:
+  MappedFile(std::string const &pathToFile) {
+#if defined(_WIN32)
+    _fileHandle = CreateFileA(pathToFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+      return;
+    }
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(_fileHandle, &fileSize);
+    _size          = static_cast<size_t>(fileSize.QuadPart);
+    _mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mappingHandle != nullptr) {
+      _data = static_cast<uint8_t const *>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    _fileDescriptor = open(pathToFile.c_str(), O_RDONLY);
+    if (_fileDescriptor < 0) {
+      return;
+    }
+    struct stat fileStat {};
+    fstat(_fileDescriptor, &fileStat);
+    _size         = static_cast<size_t>(fileStat.st_size);
+    void *mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fileDescriptor, 0);
+    if (mapping != MAP_FAILED) {
+      _data = static_cast<uint8_t const *>(mapping);
+    }
+#endif
+  }
 
-  for (auto const &instance : instanceData) {
-    auto const *model = scene->models[instance.modelIndex];
-    minExtentX        = std::min(minExtentX, instance.transform.x);
-    minExtentY        = std::min(minExtentY, instance.transform.y);
-    minExtentZ        = std::min(minExtentZ, instance.transform.z);
-    maxExtentX = std::max(maxExtentX, instance.transform.x + static_cast<int>(model->size_x));
-    maxExtentY = std::max(maxExtentY, instance.transform.y + static_cast<int>(model->size_y));
-    maxExtentZ = std::max(maxExtentZ, instance.transform.z + static_cast<int>(model->size_z));
+  ~MappedFile() {
+#if defined(_WIN32)
+    if (_data != nullptr) {
+      UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle != nullptr) {
+      CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle != INVALID_HANDLE_VALUE) {
+      CloseHandle(_fileHandle);
+    }
+#else
+    if (_data != nullptr) {
+      munmap(const_cast<uint8_t *>(_data), _size);
+    }
+    if (_fileDescriptor >= 0) {
+      close(_fileDescriptor);
+    }
+#endif
   }
 
-  uint32_t deltaX = maxExtentX - minExtentX;
-  uint32_t deltaY = maxExtentY - minExtentY;
-  uint32_t deltaZ = maxExtentZ - minExtentZ;
+  // disable copy and move
+  MappedFile(MappedFile const &)            = delete;
+  MappedFile(MappedFile &&)                 = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile &&)      = delete;
+
+  [[nodiscard]] uint8_t const *getData() const { return _data; }
+  [[nodiscard]] size_t getSize() const { return _size; }
+
+private:
+  uint8_t const *_data = nullptr;
+  size_t _size         = 0;
+#if defined(_WIN32)
+  HANDLE _fileHandle    = INVALID_HANDLE_VALUE;
+  HANDLE _mappingHandle = nullptr;
+#else
+  int _fileDescriptor = -1;
+#endif
+};
 
-  uint32_t resolution = std::max(deltaX, std::max(deltaY, deltaZ));
-  // assert((resolution & (resolution - 1)) == 0 && "resolution must be a power of 2");
-  std::cout << "resolution: " << resolution << '\n';
-  // now ceil that to the next power of 2
-  resolution = static_cast<uint32_t>(std::pow(2, std::ceil(std::log(resolution) / std::log(2))));
+// the instances are split into slabs of this many vox layers, these are the work items of the
+// worker threads
+uint32_t constexpr kSlabThickness = 16;
 
-  std::cout << "ceiled resolution: " << resolution << '\n';
+struct VoxelizationTask {
+  uint32_t instanceIndex;
+  uint32_t slabBegin;
+  uint32_t slabEnd;
+};
 
-  return resolution;
+// mirrors compressNormal of chunkVoxelCreation.comp
+uint32_t _compressNormal(glm::vec3 normal) {
+  float const l1Norm = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+  if (l1Norm == 0.F) {
+    return 0;
+  }
+  glm::vec2 p = glm::vec2(normal.x, normal.y) / l1Norm;
+  if (normal.z < 0.F) {
+    p = (1.F - glm::abs(glm::vec2(p.y, p.x))) *
+        glm::vec2(p.x >= 0.F ? 1.F : -1.F, p.y >= 0.F ? 1.F : -1.F);
+  }
+  glm::uvec2 const quantized = glm::uvec2(glm::round((p * 0.5F + 0.5F) * 62.F));
+  return quantized.x | (quantized.y << 6);
 }
 
-// this example just counts the number of solid voxels in this model, but an importer
-// would probably do something like convert the model into a triangle mesh.
-VoxData _parseSceneInstances(ogt_vox_scene const *scene,
-                             std::vector<InstanceData> const &instanceData) {
-  VoxData voxData{};
-  voxData.voxelResolution = _getVoxelResolution(scene, instanceData);
+// a helper function to load a magica voxel scene given a mapped file
+ogt_vox_scene const *_loadVoxelScene(MappedFile const &mappedFile, uint32_t sceneReadFlags = 0) {
+  if (mappedFile.getData() == nullptr ||
+      mappedFile.getSize() > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+  return ogt_vox_read_scene_with_flags(mappedFile.getData(),
+                                       static_cast<uint32_t>(mappedFile.getSize()), sceneReadFlags);
+}
 
-  auto const &palette = scene->palette.color;
+glm::uvec3 _getSceneDim(ogt_vox_scene const *scene,
+                        std::vector<InstanceData> const &instanceData) {
+  // the transforms are shifted to the origin beforehand, so the extent is the max corner
+  glm::uvec3 sceneDim{0};
+  for (auto const &instance : instanceData) {
+    auto const *model = scene->models[instance.modelIndex];
+    // vox files are z up
+    sceneDim.x = std::max(sceneDim.x, static_cast<uint32_t>(instance.transform.x) + model->size_x);
+    sceneDim.y = std::max(sceneDim.y, static_cast<uint32_t>(instance.transform.z) + model->size_z);
+    sceneDim.z = std::max(sceneDim.z, static_cast<uint32_t>(instance.transform.y) + model->size_y);
+  }
+  return sceneDim;
+}
 
-  // fill palette data
-  for (int i = 0; i < 256; i++) {
+void _fillPaletteData(ogt_vox_scene const *scene, VoxData &voxData) {
+  auto const &palette = scene->palette.color;
+  for (uint32_t i = 0; i < BlockPalette::kPaletteSize; i++) {
     auto const &color       = palette[i];
     uint32_t convertedColor = 0;
 
@@ -106,51 +174,204 @@ VoxData _parseSceneInstances(ogt_vox_scene const *scene,
     convertedColor |= color.a << 24;
     voxData.paletteData[i] = convertedColor;
   }
+}
 
-  // fill image data
-  for (auto const &instance : instanceData) {
-    uint32_t voxelIndex = 0;
-    auto const *model   = scene->models[instance.modelIndex];
-
-    for (uint32_t z = 0; z < model->size_z; z++) {
-      for (uint32_t y = 0; y < model->size_y; y++) {
-        for (uint32_t x = 0; x < model->size_x; x++) {
-          uint32_t shiftedX = x + instance.transform.x;
-          uint32_t shiftedY = y + instance.transform.y;
-          uint32_t shiftedZ = z + instance.transform.z;
-
-          // if color index == 0, this voxel is empty, otherwise it is solid.
-          uint8_t const colorIndex = model->voxel_data[voxelIndex];
-          bool isVoxelValid        = (colorIndex != 0);
-
-          // std::cout << "index: " << voxelIndex << "x: " << shiftedX << " y: " << shiftedY
-          //           << " z: " << shiftedZ << " colorIndex: " << static_cast<uint32_t>(colorIndex)
-          //           << std::endl;
-
-          if (isVoxelValid) {
-
-            // in this way we can ensure these arrays use the same entry
-            // voxData.coordinates.push_back(x);
-            // voxData.properties.push_back(static_cast<uint32_t>(colorIndex));
-            uint32_t coordinatesData = 0;
-            coordinatesData |= shiftedX;
-            coordinatesData |= shiftedZ << 10;
-            coordinatesData |= shiftedY << 20;
-
-            uint32_t propertiesData = 0;
-            propertiesData |= colorIndex;
-
-            voxData.fragmentList.emplace_back(coordinatesData, propertiesData);
-          }
-          voxelIndex++;
+// only the voxels with an empty face neighbour in their model are kept, like the terrain, which
+// only emits the voxels at the surface, the normal points away from the empty neighbours, false for
+// the voxels that aren't kept
+bool _getSurfaceVoxelProperties(ogt_vox_model const *model, int x, int y, int z,
+                                uint32_t &oProperties) {
+  auto const sizeX = static_cast<int>(model->size_x);
+  auto const sizeY = static_cast<int>(model->size_y);
+  auto const sizeZ = static_cast<int>(model->size_z);
+
+  auto const isSolid = [&](int x, int y, int z) {
+    if (x < 0 || y < 0 || z < 0 || x >= sizeX || y >= sizeY || z >= sizeZ) {
+      return false;
+    }
+    return model->voxel_data[x + (y + z * sizeY) * sizeX] != 0;
+  };
+
+  uint8_t const colorIndex = model->voxel_data[x + (y + z * sizeY) * sizeX];
+  if (colorIndex == 0) {
+    return false;
+  }
+
+  // vox files are z up, the normal is in the y up space of the renderer
+  std::array<bool, 6> const isNeighbourEmpty = {
+      !isSolid(x - 1, y, z), !isSolid(x + 1, y, z), !isSolid(x, y, z - 1),
+      !isSolid(x, y, z + 1), !isSolid(x, y - 1, z), !isSolid(x, y + 1, z)};
+  if (std::none_of(isNeighbourEmpty.begin(), isNeighbourEmpty.end(),
+                   [](bool isEmpty) { return isEmpty; })) {
+    return false;
+  }
+
+  glm::vec3 normal{0.F};
+  for (int axis = 0; axis < 3; axis++) {
+    normal[axis] = static_cast<float>(isNeighbourEmpty[2 * axis + 1]) -
+                   static_cast<float>(isNeighbourEmpty[2 * axis]);
+  }
+  // opposite empty neighbours cancel out, such thin voxels face upwards
+  normal = glm::length(normal) > 0.F ? glm::normalize(normal) : glm::vec3{0.F, 1.F, 0.F};
+
+  // the leaves index the palette of the file, see BlockPalette.hpp
+  oProperties = colorIndex | (_compressNormal(normal) << 8);
+  return true;
+}
+
+void _voxelizeSlab(ogt_vox_scene const *scene, InstanceData const &instance, uint32_t slabBegin,
+                   uint32_t slabEnd, uint32_t chunkVoxelDim, glm::uvec3 chunksDim,
+                   std::vector<std::vector<G_FragmentListEntry>> &chunkFragmentLists) {
+  auto const *model = scene->models[instance.modelIndex];
+  auto const sizeX  = static_cast<int>(model->size_x);
+  auto const sizeY  = static_cast<int>(model->size_y);
+
+  glm::uvec3 const gridDim = chunksDim * chunkVoxelDim;
+  for (int z = static_cast<int>(slabBegin); z < static_cast<int>(slabEnd); z++) {
+    for (int y = 0; y < sizeY; y++) {
+      for (int x = 0; x < sizeX; x++) {
+        uint32_t properties = 0;
+        if (!_getSurfaceVoxelProperties(model, x, y, z, properties)) {
+          continue;
+        }
+
+        glm::uvec3 const voxelPos{static_cast<uint32_t>(x + instance.transform.x),
+                                  static_cast<uint32_t>(z + instance.transform.z),
+                                  static_cast<uint32_t>(y + instance.transform.y)};
+        if (voxelPos.x >= gridDim.x || voxelPos.y >= gridDim.y || voxelPos.z >= gridDim.z) {
+          continue;
         }
+
+        glm::uvec3 const chunkIndex = voxelPos / chunkVoxelDim;
+        glm::uvec3 const localPos   = voxelPos % chunkVoxelDim;
+        uint32_t const linearIndex =
+            chunkIndex.x + chunkIndex.y * chunksDim.x + chunkIndex.z * chunksDim.x * chunksDim.y;
+
+        G_FragmentListEntry fragment{};
+        fragment.coordinates = localPos.x | (localPos.y << 10) | (localPos.z << 20);
+        fragment.properties  = properties;
+        chunkFragmentLists[linearIndex].push_back(fragment);
       }
     }
   }
+}
 
-  std::cout << "fragment list size: " << voxData.fragmentList.size() << '\n';
+// the surface voxels of the whole model, in the y up space of the prefab
+VoxPrefab _voxelizePrefab(ogt_vox_model const *model) {
+  VoxPrefab prefab{};
+  prefab.dim = {model->size_x, model->size_z, model->size_y};
+  // an octree has at least one level below its root
+  prefab.voxelResolution = 2;
+  while (prefab.voxelResolution < std::max(prefab.dim.x, std::max(prefab.dim.y, prefab.dim.z))) {
+    prefab.voxelResolution <<= 1;
+  }
 
-  return voxData;
+  for (int z = 0; z < static_cast<int>(model->size_z); z++) {
+    for (int y = 0; y < static_cast<int>(model->size_y); y++) {
+      for (int x = 0; x < static_cast<int>(model->size_x); x++) {
+        uint32_t properties = 0;
+        if (!_getSurfaceVoxelProperties(model, x, y, z, properties)) {
+          continue;
+        }
+        G_FragmentListEntry fragment{};
+        fragment.coordinates = static_cast<uint32_t>(x) | (static_cast<uint32_t>(z) << 10) |
+                               (static_cast<uint32_t>(y) << 20);
+        fragment.properties = properties;
+        prefab.fragments.push_back(fragment);
+      }
+    }
+  }
+  return prefab;
+}
+
+void _voxelizeSceneInstances(ogt_vox_scene const *scene,
+                             std::vector<InstanceData> const &instanceData,
+                             uint32_t chunkVoxelDim, glm::uvec3 chunksDim, VoxData &voxData) {
+  size_t const chunkCount = static_cast<size_t>(chunksDim.x) * chunksDim.y * chunksDim.z;
+
+  std::vector<VoxelizationTask> tasks{};
+  for (uint32_t instanceIndex = 0; instanceIndex < instanceData.size(); instanceIndex++) {
+    uint32_t const layerCount = scene->models[instanceData[instanceIndex].modelIndex]->size_z;
+    for (uint32_t slabBegin = 0; slabBegin < layerCount; slabBegin += kSlabThickness) {
+      tasks.push_back({instanceIndex, slabBegin, std::min(slabBegin + kSlabThickness, layerCount)});
+    }
+  }
+
+  // every slot of the scheduler buckets into its own lists, so the workers never share a vector,
+  // they are concatenated per chunk afterwards
+  auto &scheduler = TaskScheduler::get();
+  std::vector<std::vector<std::vector<G_FragmentListEntry>>> workerFragmentLists(
+      scheduler.getSlotCount(), std::vector<std::vector<G_FragmentListEntry>>(chunkCount));
+
+  scheduler.parallelFor(tasks.size(), [&](size_t taskIndex, uint32_t slot) {
+    auto const &task = tasks[taskIndex];
+    _voxelizeSlab(scene, instanceData[task.instanceIndex], task.slabBegin, task.slabEnd,
+                  chunkVoxelDim, chunksDim, workerFragmentLists[slot]);
+  });
+
+  voxData.chunkFragmentLists.resize(chunkCount);
+  for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+    size_t fragmentCount = 0;
+    for (auto const &fragmentLists : workerFragmentLists) {
+      fragmentCount += fragmentLists[chunk].size();
+    }
+
+    auto &chunkFragmentList = voxData.chunkFragmentLists[chunk];
+    chunkFragmentList.reserve(fragmentCount);
+    for (auto &fragmentLists : workerFragmentLists) {
+      chunkFragmentList.insert(chunkFragmentList.end(), fragmentLists[chunk].begin(),
+                               fragmentLists[chunk].end());
+      // the worker lists are freed early, large scenes hold a lot of fragments
+      std::vector<G_FragmentListEntry>().swap(fragmentLists[chunk]);
+    }
+  }
+}
+
+// the models with enough instances become prefabs, their instances within the chunk grid are kept
+// as they are, the instances of the other models are left to be baked, the largest prefab is bound
+// by the 10 bits of the fragment coordinates
+void _extractPrefabs(ogt_vox_scene const *scene, std::vector<InstanceData> const &instanceData,
+                     uint32_t chunkVoxelDim, glm::uvec3 chunksDim, uint32_t minInstanceCount,
+                     VoxData &voxData, std::vector<InstanceData> &oBakedInstanceData) {
+  uint32_t constexpr kMaxPrefabDim = 1024;
+
+  std::vector<uint32_t> modelInstanceCounts(scene->num_models, 0);
+  for (auto const &instance : instanceData) {
+    modelInstanceCounts[instance.modelIndex]++;
+  }
+
+  std::vector<uint32_t> modelToPrefab(scene->num_models, std::numeric_limits<uint32_t>::max());
+  std::vector<ogt_vox_model const *> prefabModels{};
+  for (uint32_t modelIndex = 0; modelIndex < scene->num_models; modelIndex++) {
+    auto const *model = scene->models[modelIndex];
+    if (minInstanceCount == 0 || modelInstanceCounts[modelIndex] < minInstanceCount ||
+        std::max(model->size_x, std::max(model->size_y, model->size_z)) > kMaxPrefabDim) {
+      continue;
+    }
+    modelToPrefab[modelIndex] = static_cast<uint32_t>(prefabModels.size());
+    prefabModels.push_back(model);
+  }
+
+  glm::uvec3 const gridDim = chunksDim * chunkVoxelDim;
+  for (auto const &instance : instanceData) {
+    uint32_t const prefabIndex = modelToPrefab[instance.modelIndex];
+    if (prefabIndex == std::numeric_limits<uint32_t>::max()) {
+      oBakedInstanceData.push_back(instance);
+      continue;
+    }
+    // vox files are z up
+    glm::uvec3 const voxelPos{static_cast<uint32_t>(instance.transform.x),
+                              static_cast<uint32_t>(instance.transform.z),
+                              static_cast<uint32_t>(instance.transform.y)};
+    if (glm::all(glm::lessThan(voxelPos, gridDim))) {
+      voxData.prefabInstances.push_back({prefabIndex, voxelPos});
+    }
+  }
+
+  voxData.prefabs.resize(prefabModels.size());
+  TaskScheduler::get().parallelFor(prefabModels.size(), [&](size_t prefabIndex, uint32_t) {
+    voxData.prefabs[prefabIndex] = _voxelizePrefab(prefabModels[prefabIndex]);
+  });
 }
 
 // find the minimum coord among all instances, and shift all instances by that amount
@@ -181,8 +402,16 @@ VoxTransform VoxTransform::operator-(VoxTransform const &other) const {
   return VoxTransform{VoxTransform{x - other.x, y - other.y, z - other.z}};
 }
 
-VoxData fetchDataFromFile(std::string const &pathToFile) {
-  const ogt_vox_scene *scene = _loadVoxelScene(pathToFile);
+VoxData fetchDataFromFile(std::string const &pathToFile, uint32_t chunkVoxelDim,
+                          glm::uvec3 chunksDim, Logger *logger, uint32_t prefabMinInstanceCount) {
+  auto const loadStart = std::chrono::steady_clock::now();
+
+  MappedFile const mappedFile(pathToFile);
+  ogt_vox_scene const *scene = _loadVoxelScene(mappedFile);
+  if (scene == nullptr) {
+    logger->error("failed to load vox scene {}", pathToFile);
+    exit(0);
+  }
 
   std::vector<InstanceData> instanceData{};
   for (size_t instanceIndex = 0; instanceIndex < scene->num_instances; instanceIndex++) {
@@ -194,8 +423,41 @@ VoxData fetchDataFromFile(std::string const &pathToFile) {
 
   _shiftInstanceTransforms(instanceData);
 
-  VoxData voxData = _parseSceneInstances(scene, instanceData);
+  VoxData voxData{};
+  voxData.sceneDim = _getSceneDim(scene, instanceData);
+  _fillPaletteData(scene, voxData);
+
+  std::vector<InstanceData> bakedInstanceData{};
+  _extractPrefabs(scene, instanceData, chunkVoxelDim, chunksDim, prefabMinInstanceCount, voxData,
+                  bakedInstanceData);
+  _voxelizeSceneInstances(scene, bakedInstanceData, chunkVoxelDim, chunksDim, voxData);
+
+  ogt_vox_destroy_scene(scene);
 
+  glm::uvec3 const gridDim = chunksDim * chunkVoxelDim;
+  if (glm::any(glm::greaterThan(voxData.sceneDim, gridDim))) {
+    logger->warn("vox scene ({}, {}, {}) exceeds the chunk grid ({}, {}, {}), the rest is dropped",
+                 voxData.sceneDim.x, voxData.sceneDim.y, voxData.sceneDim.z, gridDim.x, gridDim.y,
+                 gridDim.z);
+  }
+
+  size_t fragmentCount = 0;
+  for (auto const &chunkFragmentList : voxData.chunkFragmentLists) {
+    fragmentCount += chunkFragmentList.size();
+  }
+  auto const loadTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - loadStart)
+                              .count();
+  logger->info("vox scene {} loaded: {} surface voxels in {} ms", pathToFile, fragmentCount,
+               loadTimeMs);
+  if (!voxData.prefabs.empty()) {
+    size_t prefabFragmentCount = 0;
+    for (auto const &prefab : voxData.prefabs) {
+      prefabFragmentCount += prefab.fragments.size();
+    }
+    logger->info("{} prefabs with {} surface voxels, placed by {} instances",
+                 voxData.prefabs.size(), prefabFragmentCount, voxData.prefabInstances.size());
+  }
   return voxData;
 }
-} // namespace VoxLoader
\ No newline at end of file
+} // namespace VoxLoader
@@ -21,5 +21,10 @@ struct VoxTransform {
   int z;
 };
 
-VoxData fetchDataFromFile(std::string const &pathToFile);
+// the file is memory mapped, and the instances are voxelized by a pool of worker threads, voxels
+// outside of the chunk grid are dropped, the models with at least prefabMinInstanceCount instances
+// are voxelized once as prefabs, which are never baked into the chunks, 0 bakes all of them
+VoxData fetchDataFromFile(std::string const &pathToFile, uint32_t chunkVoxelDim,
+                          glm::uvec3 chunksDim, Logger *logger,
+                          uint32_t prefabMinInstanceCount = 0);
 }; // namespace VoxLoader
\ No newline at end of file
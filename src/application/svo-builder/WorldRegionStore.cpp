@@ -0,0 +1,315 @@
+#include "WorldRegionStore.hpp"
+
+#include "utils/logger/Logger.hpp"
+
+#include "lz4.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <tuple>
+
+namespace {
+// bumped whenever the layout of the file, or of the saved fields changes
+uint32_t constexpr kRegionFormatVersion = 1;
+uint32_t constexpr kRegionMagic         = 0x47524C56; // "VLRG"
+
+size_t constexpr kRegionChunkCount = static_cast<size_t>(WorldRegionStore::kRegionDim) *
+                                     WorldRegionStore::kRegionDim * WorldRegionStore::kRegionDim;
+
+struct RegionFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t chunkVoxelDim;
+  uint32_t regionDim;
+  uint64_t builderKey;
+};
+
+// the compressed field of a chunk is followed by its compressed octree
+struct RegionIndexEntry {
+  // from the start of the file, zero for the chunks that aren't stored
+  uint64_t offset;
+  uint32_t fieldLength; // in uint32
+  uint32_t fieldCompressedSize;
+  uint32_t octreeLength; // in uint32
+  uint32_t octreeCompressedSize;
+  uint32_t lod;
+  uint32_t flags;
+};
+
+uint32_t constexpr kHasOctreeFlag = 1U << 0;
+
+using RegionKey = std::tuple<int32_t, int32_t, int32_t>;
+
+int32_t _floorDiv(int32_t value, int32_t divisor) {
+  return (value >= 0 ? value : value - (divisor - 1)) / divisor;
+}
+
+glm::ivec3 _getRegion(glm::ivec3 chunkIndex) {
+  return {_floorDiv(chunkIndex.x, WorldRegionStore::kRegionDim),
+          _floorDiv(chunkIndex.y, WorldRegionStore::kRegionDim),
+          _floorDiv(chunkIndex.z, WorldRegionStore::kRegionDim)};
+}
+
+size_t _getIndexInRegion(glm::ivec3 chunkIndex) {
+  glm::ivec3 const local = chunkIndex - _getRegion(chunkIndex) * WorldRegionStore::kRegionDim;
+  return static_cast<size_t>(local.x) +
+         static_cast<size_t>(local.y) * WorldRegionStore::kRegionDim +
+         static_cast<size_t>(local.z) * WorldRegionStore::kRegionDim * WorldRegionStore::kRegionDim;
+}
+
+std::vector<char> _compress(std::vector<uint32_t> const &words) {
+  if (words.empty()) {
+    return {};
+  }
+  auto const sourceSize = static_cast<int>(words.size() * sizeof(uint32_t));
+  std::vector<char> compressed(LZ4_compressBound(sourceSize));
+  int const compressedSize =
+      LZ4_compress_default(reinterpret_cast<char const *>(words.data()), compressed.data(),
+                           sourceSize, static_cast<int>(compressed.size()));
+  compressed.resize(compressedSize);
+  return compressed;
+}
+
+bool _decompress(char const *compressed, uint32_t compressedSize, uint32_t length,
+                 std::vector<uint32_t> &words) {
+  words.resize(length);
+  if (length == 0) {
+    return true;
+  }
+  auto const size = static_cast<int>(length * sizeof(uint32_t));
+  return LZ4_decompress_safe(compressed, reinterpret_cast<char *>(words.data()),
+                             static_cast<int>(compressedSize), size) == size;
+}
+
+// the header and the index of a region file, which stays open, so that the blobs of the chunks
+// are read one by one, the index is empty if there's none, or if it doesn't match the world
+struct Region {
+  RegionFileHeader header{};
+  std::vector<RegionIndexEntry> index{};
+  std::ifstream file{};
+};
+
+bool _openRegion(std::string const &pathToFile, uint32_t chunkVoxelDim, Region &region,
+                 Logger *logger) {
+  region.file.open(pathToFile, std::ios::binary | std::ios::ate);
+  if (!region.file.is_open()) {
+    return false;
+  }
+  auto const fileSize = static_cast<uint64_t>(region.file.tellg());
+
+  size_t constexpr kIndexSize = kRegionChunkCount * sizeof(RegionIndexEntry);
+  if (fileSize < sizeof(RegionFileHeader) + kIndexSize) {
+    logger->warn("the world region {} is truncated, it's ignored", pathToFile);
+    return false;
+  }
+  region.file.seekg(0);
+  region.file.read(reinterpret_cast<char *>(&region.header), sizeof(RegionFileHeader));
+  if (!region.file || region.header.magic != kRegionMagic ||
+      region.header.version != kRegionFormatVersion ||
+      region.header.chunkVoxelDim != chunkVoxelDim ||
+      region.header.regionDim != static_cast<uint32_t>(WorldRegionStore::kRegionDim)) {
+    logger->warn("the world region {} belongs to another format or chunk size, it's ignored",
+                 pathToFile);
+    return false;
+  }
+  std::vector<RegionIndexEntry> index(kRegionChunkCount);
+  region.file.read(reinterpret_cast<char *>(index.data()), kIndexSize);
+  if (!region.file) {
+    logger->warn("the world region {} is truncated, it's ignored", pathToFile);
+    return false;
+  }
+
+  // an entry that points past the end would be read out of bounds later on
+  for (auto &entry : index) {
+    if (entry.offset + entry.fieldCompressedSize + entry.octreeCompressedSize > fileSize) {
+      entry = {};
+    }
+  }
+  region.index = std::move(index);
+  return true;
+}
+
+// the first size bytes of the blobs of the entry, false if the file can't be read
+bool _readBlob(Region &region, RegionIndexEntry const &entry, size_t size,
+               std::vector<char> &blob) {
+  blob.resize(size);
+  region.file.seekg(static_cast<std::streamoff>(entry.offset));
+  region.file.read(blob.data(), static_cast<std::streamsize>(size));
+  if (!region.file) {
+    region.file.clear();
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+WorldRegionStore::WorldRegionStore(Logger *logger, std::string pathToFolder,
+                                   uint32_t chunkVoxelDim, uint64_t builderKey)
+    : _logger(logger), _pathToFolder(std::move(pathToFolder)), _chunkVoxelDim(chunkVoxelDim),
+      _builderKey(builderKey) {}
+
+std::string WorldRegionStore::_getPathToRegion(glm::ivec3 region) const {
+  return _pathToFolder + fmt::format("r.{}.{}.{}.vlr", region.x, region.y, region.z);
+}
+
+void WorldRegionStore::writeChunks(
+    std::vector<std::pair<glm::ivec3, std::optional<ChunkData>>> const &chunks) {
+  std::map<RegionKey, std::vector<size_t>> regionToChunks{};
+  for (size_t i = 0; i < chunks.size(); i++) {
+    glm::ivec3 const region = _getRegion(chunks[i].first);
+    regionToChunks[{region.x, region.y, region.z}].push_back(i);
+  }
+
+  std::lock_guard<std::mutex> lock(_fileMutex);
+  std::error_code errorCode{};
+  std::filesystem::create_directories(_pathToFolder, errorCode);
+
+  uint64_t const builderKey = _builderKey;
+  for (auto const &[regionKey, chunkIndices] : regionToChunks) {
+    glm::ivec3 const region{std::get<0>(regionKey), std::get<1>(regionKey),
+                            std::get<2>(regionKey)};
+    std::string const pathToRegion = _getPathToRegion(region);
+    Region oldRegion{};
+    _openRegion(pathToRegion, _chunkVoxelDim, oldRegion, _logger);
+    // the octrees of other builder shaders are dropped, the fields are kept either way
+    bool const areOldOctreesValid = oldRegion.header.builderKey == builderKey;
+
+    std::vector<std::optional<ChunkData const *>> updates(kRegionChunkCount);
+    for (size_t const i : chunkIndices) {
+      auto const &[chunkIndex, data] = chunks[i];
+      updates[_getIndexInRegion(chunkIndex)] =
+          data.has_value() ? &data.value() : static_cast<ChunkData const *>(nullptr);
+    }
+
+    std::vector<RegionIndexEntry> index(kRegionChunkCount, RegionIndexEntry{});
+    std::vector<char> blobs{};
+    std::vector<char> oldBlob{};
+    size_t const blobsOffset =
+        sizeof(RegionFileHeader) + kRegionChunkCount * sizeof(RegionIndexEntry);
+    for (size_t i = 0; i < kRegionChunkCount; i++) {
+      auto &entry = index[i];
+      if (updates[i].has_value()) {
+        ChunkData const *data = *updates[i];
+        if (data == nullptr) {
+          continue;
+        }
+        std::vector<char> const field  = _compress(data->field);
+        std::vector<char> const octree = _compress(data->octree);
+        entry.offset                   = blobsOffset + blobs.size();
+        entry.fieldLength              = static_cast<uint32_t>(data->field.size());
+        entry.fieldCompressedSize      = static_cast<uint32_t>(field.size());
+        entry.octreeLength             = static_cast<uint32_t>(data->octree.size());
+        entry.octreeCompressedSize     = static_cast<uint32_t>(octree.size());
+        entry.lod                      = data->lod;
+        entry.flags                    = data->hasOctree ? kHasOctreeFlag : 0U;
+        blobs.insert(blobs.end(), field.begin(), field.end());
+        blobs.insert(blobs.end(), octree.begin(), octree.end());
+        continue;
+      }
+
+      if (oldRegion.index.empty() || oldRegion.index[i].offset == 0) {
+        continue;
+      }
+      RegionIndexEntry const &oldEntry = oldRegion.index[i];
+      entry                            = oldEntry;
+      entry.offset                     = blobsOffset + blobs.size();
+      if (!areOldOctreesValid) {
+        entry.octreeLength         = 0;
+        entry.octreeCompressedSize = 0;
+        entry.flags &= ~kHasOctreeFlag;
+      }
+      if (!_readBlob(oldRegion, oldEntry, entry.fieldCompressedSize + entry.octreeCompressedSize,
+                     oldBlob)) {
+        _logger->warn("failed to read a chunk of the world region {}, it's dropped", pathToRegion);
+        entry = {};
+        continue;
+      }
+      blobs.insert(blobs.end(), oldBlob.begin(), oldBlob.end());
+    }
+    // the old region is replaced below, which fails on some platforms while it's open
+    oldRegion.file.close();
+
+    // a region without any chunk left is removed
+    bool const isEmpty = std::all_of(index.begin(), index.end(), [](RegionIndexEntry const &entry) {
+      return entry.offset == 0;
+    });
+    if (isEmpty) {
+      std::filesystem::remove(pathToRegion, errorCode);
+      continue;
+    }
+
+    std::string const pathToTemporary = pathToRegion + ".tmp";
+    std::ofstream file(pathToTemporary, std::ios::binary | std::ios::trunc);
+    RegionFileHeader const header{kRegionMagic, kRegionFormatVersion, _chunkVoxelDim,
+                                  static_cast<uint32_t>(kRegionDim), builderKey};
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const *>(index.data()),
+               static_cast<std::streamsize>(index.size() * sizeof(RegionIndexEntry)));
+    file.write(blobs.data(), static_cast<std::streamsize>(blobs.size()));
+    file.close();
+    if (!file) {
+      _logger->warn("failed to write the world region {}", pathToRegion);
+      std::remove(pathToTemporary.c_str());
+      continue;
+    }
+    std::filesystem::rename(pathToTemporary, pathToRegion, errorCode);
+    if (errorCode) {
+      _logger->warn("failed to replace the world region {}: {}", pathToRegion,
+                    errorCode.message());
+    }
+  }
+}
+
+std::vector<std::pair<glm::ivec3, WorldRegionStore::ChunkData>>
+WorldRegionStore::readChunks(std::vector<glm::ivec3> const &chunkIndices) {
+  std::map<RegionKey, std::vector<glm::ivec3>> regionToChunks{};
+  for (auto const &chunkIndex : chunkIndices) {
+    glm::ivec3 const region = _getRegion(chunkIndex);
+    regionToChunks[{region.x, region.y, region.z}].push_back(chunkIndex);
+  }
+
+  std::lock_guard<std::mutex> lock(_fileMutex);
+  uint64_t const builderKey = _builderKey;
+  std::vector<std::pair<glm::ivec3, ChunkData>> readChunks{};
+  for (auto const &[regionKey, regionChunks] : regionToChunks) {
+    glm::ivec3 const region{std::get<0>(regionKey), std::get<1>(regionKey),
+                            std::get<2>(regionKey)};
+    Region storedRegion{};
+    if (!_openRegion(_getPathToRegion(region), _chunkVoxelDim, storedRegion, _logger)) {
+      continue;
+    }
+    bool const areOctreesValid = storedRegion.header.builderKey == builderKey;
+
+    // only the blobs of the requested chunks are read, the octrees only if they're still valid
+    std::vector<char> blob{};
+    for (auto const &chunkIndex : regionChunks) {
+      RegionIndexEntry const &entry = storedRegion.index[_getIndexInRegion(chunkIndex)];
+      if (entry.offset == 0) {
+        continue;
+      }
+      bool const isOctreeRead = areOctreesValid && (entry.flags & kHasOctreeFlag) != 0;
+      size_t const blobSize =
+          entry.fieldCompressedSize + (isOctreeRead ? entry.octreeCompressedSize : 0);
+      ChunkData data{};
+      if (!_readBlob(storedRegion, entry, blobSize, blob) ||
+          !_decompress(blob.data(), entry.fieldCompressedSize, entry.fieldLength, data.field)) {
+        _logger->warn("the field of chunk ({}, {}, {}) is broken, it's generated again",
+                      chunkIndex.x, chunkIndex.y, chunkIndex.z);
+        continue;
+      }
+      data.lod       = entry.lod;
+      data.hasOctree = isOctreeRead && _decompress(blob.data() + entry.fieldCompressedSize,
+                                                   entry.octreeCompressedSize, entry.octreeLength,
+                                                   data.octree);
+      if (!data.hasOctree) {
+        data.octree.clear();
+      }
+      readChunks.emplace_back(chunkIndex, std::move(data));
+    }
+  }
+  return readChunks;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "glm/glm.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Logger;
+
+// the edited chunks of a world, kept in region files of kRegionDim^3 chunks, every file starts with
+// an index of the offsets of its chunks, so a chunk is read without the rest of its region, the
+// fields and the octrees are compressed with lz4, a region is rewritten to a temporary file that
+// replaces it, so an interrupted write never leaves a broken region behind, it's used by the tasks
+// of the scheduler, so every call may come from any thread
+class WorldRegionStore {
+public:
+  static int32_t constexpr kRegionDim = 8;
+
+  struct ChunkData {
+    // the saved field, the brick table followed by the stored bricks
+    std::vector<uint32_t> field{};
+    // without an octree, or with one of other builder shaders, the chunk is built from its field
+    bool hasOctree = false;
+    std::vector<uint32_t> octree{};
+    uint32_t lod = 0;
+  };
+
+  // the builder key tells whether the stored octrees are still valid, see ChunkOctreeCache::makeKey
+  WorldRegionStore(Logger *logger, std::string pathToFolder, uint32_t chunkVoxelDim,
+                   uint64_t builderKey);
+
+  void setBuilderKey(uint64_t builderKey) { _builderKey = builderKey; }
+
+  // the chunks without data are removed from their regions
+  void writeChunks(std::vector<std::pair<glm::ivec3, std::optional<ChunkData>>> const &chunks);
+  // the chunks that aren't stored are left out
+  std::vector<std::pair<glm::ivec3, ChunkData>>
+  readChunks(std::vector<glm::ivec3> const &chunkIndices);
+
+private:
+  Logger *_logger;
+  std::string _pathToFolder;
+  uint32_t _chunkVoxelDim;
+  std::atomic<uint64_t> _builderKey;
+
+  // the reads of the regions and their rewrites are never interleaved
+  std::mutex _fileMutex;
+
+  [[nodiscard]] std::string _getPathToRegion(glm::ivec3 region) const;
+};
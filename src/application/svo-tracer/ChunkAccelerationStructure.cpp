@@ -0,0 +1,243 @@
+#include "ChunkAccelerationStructure.hpp"
+
+#include "app-context/VulkanApplicationContext.hpp"
+#include "utils/logger/Logger.hpp"
+#include "vulkan-wrapper/memory/Buffer.hpp"
+#include "vulkan-wrapper/utils/SimpleCommands.hpp"
+
+#include <algorithm>
+
+namespace {
+VkAccelerationStructureBuildGeometryInfoKHR
+_makeBuildInfo(VkAccelerationStructureTypeKHR type,
+               VkAccelerationStructureGeometryKHR const &geometry) {
+  VkAccelerationStructureBuildGeometryInfoKHR buildInfo{
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR};
+  buildInfo.type          = type;
+  buildInfo.flags         = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+  buildInfo.mode          = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
+  buildInfo.geometryCount = 1;
+  buildInfo.pGeometries   = &geometry;
+  return buildInfo;
+}
+
+VkAccelerationStructureGeometryKHR _makeInstancesGeometry(VkDeviceAddress instancesAddress) {
+  VkAccelerationStructureGeometryKHR geometry{
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR};
+  geometry.geometryType       = VK_GEOMETRY_TYPE_INSTANCES_KHR;
+  geometry.geometry.instances = {
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR};
+  geometry.geometry.instances.arrayOfPointers    = VK_FALSE;
+  geometry.geometry.instances.data.deviceAddress = instancesAddress;
+  return geometry;
+}
+} // namespace
+
+ChunkAccelerationStructure::ChunkAccelerationStructure(VulkanApplicationContext *appContext,
+                                                       Logger *logger, size_t framesInFlight,
+                                                       uint32_t maxChunkCount)
+    : _appContext(appContext), _logger(logger), _maxChunkCount(maxChunkCount) {
+  VkPhysicalDeviceAccelerationStructurePropertiesKHR accelerationStructureProperties{
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR};
+  VkPhysicalDeviceProperties2 properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2};
+  properties.pNext = &accelerationStructureProperties;
+  vkGetPhysicalDeviceProperties2(_appContext->getPhysicalDevice(), &properties);
+  _scratchOffsetAlignment =
+      accelerationStructureProperties.minAccelerationStructureScratchOffsetAlignment;
+
+  _createBottomLevelAccelerationStructure();
+  _createTopLevelAccelerationStructure(framesInFlight);
+  _recordBuildCommandBuffers();
+}
+
+ChunkAccelerationStructure::~ChunkAccelerationStructure() {
+  for (auto &commandBuffer : _buildCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getCommandPool(), 1,
+                         &commandBuffer);
+  }
+  vkDestroyAccelerationStructureKHR(_appContext->getDevice(), _topLevelAccelerationStructure,
+                                    nullptr);
+  vkDestroyAccelerationStructureKHR(_appContext->getDevice(), _bottomLevelAccelerationStructure,
+                                    nullptr);
+}
+
+void ChunkAccelerationStructure::updateInstances(size_t currentFrame,
+                                                 std::vector<glm::ivec3> const &chunkIndices) {
+  if (chunkIndices.size() > _maxChunkCount) {
+    _logger->error("{} chunks don't fit in the chunk acceleration structure of {} instances",
+                   chunkIndices.size(), _maxChunkCount);
+  }
+
+  // an instance that doesn't reference a bottom level structure is inactive
+  std::vector<VkAccelerationStructureInstanceKHR> instances(_maxChunkCount,
+                                                            VkAccelerationStructureInstanceKHR{});
+  auto const activeCount =
+      static_cast<uint32_t>(std::min<size_t>(chunkIndices.size(), _maxChunkCount));
+  for (uint32_t i = 0; i < activeCount; i++) {
+    // the chunks are one unit wide in world space, the transform is row major
+    glm::vec3 const translation(chunkIndices[i]);
+    VkTransformMatrixKHR const transform = {{{1.F, 0.F, 0.F, translation.x},
+                                             {0.F, 1.F, 0.F, translation.y},
+                                             {0.F, 0.F, 1.F, translation.z}}};
+    VkAccelerationStructureInstanceKHR &instance = instances[i];
+    instance.transform                      = transform;
+    instance.mask                           = 0xFF;
+    instance.flags                          = VK_GEOMETRY_INSTANCE_FORCE_OPAQUE_BIT_KHR;
+    instance.accelerationStructureReference = _bottomLevelAddress;
+  }
+  _instanceBuffers[currentFrame]->fillData(instances.data());
+}
+
+void ChunkAccelerationStructure::_createBottomLevelAccelerationStructure() {
+  VkAabbPositionsKHR const unitBox{0.F, 0.F, 0.F, 1.F, 1.F, 1.F};
+  _aabbBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(VkAabbPositionsKHR),
+      VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+          VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+      MemoryStyle::kHostVisible);
+  _aabbBuffer->fillData(&unitBox);
+
+  VkAccelerationStructureGeometryKHR geometry{
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR};
+  geometry.geometryType   = VK_GEOMETRY_TYPE_AABBS_KHR;
+  geometry.flags          = VK_GEOMETRY_OPAQUE_BIT_KHR;
+  geometry.geometry.aabbs = {VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_AABBS_DATA_KHR};
+  geometry.geometry.aabbs.data.deviceAddress = _aabbBuffer->getDeviceAddress();
+  geometry.geometry.aabbs.stride             = sizeof(VkAabbPositionsKHR);
+
+  VkDeviceSize const scratchSize =
+      _createAccelerationStructure(VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR, geometry, 1,
+                                   _bottomLevelBuffer, _bottomLevelAccelerationStructure);
+  auto const scratchBuffer = _createScratchBuffer(scratchSize);
+
+  // the box never changes, so it's built once
+  auto buildInfo = _makeBuildInfo(VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR, geometry);
+  buildInfo.dstAccelerationStructure  = _bottomLevelAccelerationStructure;
+  buildInfo.scratchData.deviceAddress = _getScratchAddress(*scratchBuffer);
+  VkAccelerationStructureBuildRangeInfoKHR const buildRange{1, 0, 0, 0};
+  VkAccelerationStructureBuildRangeInfoKHR const *pBuildRange = &buildRange;
+
+  VkCommandBuffer commandBuffer =
+      beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
+  vkCmdBuildAccelerationStructuresKHR(commandBuffer, 1, &buildInfo, &pBuildRange);
+  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
+                        _appContext->getGraphicsQueue(), commandBuffer);
+
+  VkAccelerationStructureDeviceAddressInfoKHR addressInfo{
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR};
+  addressInfo.accelerationStructure = _bottomLevelAccelerationStructure;
+  _bottomLevelAddress = vkGetAccelerationStructureDeviceAddressKHR(_appContext->getDevice(),
+                                                                   &addressInfo);
+}
+
+void ChunkAccelerationStructure::_createTopLevelAccelerationStructure(size_t framesInFlight) {
+  // inactive until the first update
+  std::vector<VkAccelerationStructureInstanceKHR> const inactiveInstances(
+      _maxChunkCount, VkAccelerationStructureInstanceKHR{});
+  for (size_t i = 0; i < framesInFlight; i++) {
+    _instanceBuffers.emplace_back(std::make_unique<Buffer>(
+        _appContext, sizeof(VkAccelerationStructureInstanceKHR) * _maxChunkCount,
+        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        MemoryStyle::kHostVisible));
+    _instanceBuffers.back()->fillData(inactiveInstances.data());
+  }
+
+  VkDeviceSize const scratchSize = _createAccelerationStructure(
+      VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
+      _makeInstancesGeometry(_instanceBuffers.front()->getDeviceAddress()), _maxChunkCount,
+      _topLevelBuffer, _topLevelAccelerationStructure);
+  _topLevelScratchBuffer = _createScratchBuffer(scratchSize);
+}
+
+void ChunkAccelerationStructure::_recordBuildCommandBuffers() {
+  _buildCommandBuffers.resize(_instanceBuffers.size());
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = _appContext->getCommandPool();
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = static_cast<uint32_t>(_buildCommandBuffers.size());
+
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, _buildCommandBuffers.data());
+
+  // the previous build may still be read by the tracing of the last frame, or write the scratch
+  // buffer
+  VkMemoryBarrier buildBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  buildBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+  buildBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR |
+                               VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+  VkMemoryBarrier tracingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  tracingBarrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+  tracingBarrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+
+  VkAccelerationStructureBuildRangeInfoKHR const buildRange{_maxChunkCount, 0, 0, 0};
+  VkAccelerationStructureBuildRangeInfoKHR const *pBuildRange = &buildRange;
+
+  for (size_t frameIndex = 0; frameIndex < _buildCommandBuffers.size(); frameIndex++) {
+    auto &cmdBuffer = _buildCommandBuffers[frameIndex];
+
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+
+    vkCmdPipelineBarrier(cmdBuffer,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                             VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                         VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1,
+                         &buildBarrier, 0, nullptr, 0, nullptr);
+
+    auto const geometry = _makeInstancesGeometry(_instanceBuffers[frameIndex]->getDeviceAddress());
+    auto buildInfo      = _makeBuildInfo(VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR, geometry);
+    buildInfo.dstAccelerationStructure  = _topLevelAccelerationStructure;
+    buildInfo.scratchData.deviceAddress = _getScratchAddress(*_topLevelScratchBuffer);
+    vkCmdBuildAccelerationStructuresKHR(cmdBuffer, 1, &buildInfo, &pBuildRange);
+
+    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &tracingBarrier, 0, nullptr,
+                         0, nullptr);
+
+    vkEndCommandBuffer(cmdBuffer);
+  }
+}
+
+VkDeviceSize ChunkAccelerationStructure::_createAccelerationStructure(
+    VkAccelerationStructureTypeKHR type, VkAccelerationStructureGeometryKHR const &geometry,
+    uint32_t primitiveCount, std::unique_ptr<Buffer> &buffer,
+    VkAccelerationStructureKHR &accelerationStructure) {
+  auto const buildInfo = _makeBuildInfo(type, geometry);
+  VkAccelerationStructureBuildSizesInfoKHR buildSizes{
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR};
+  vkGetAccelerationStructureBuildSizesKHR(_appContext->getDevice(),
+                                          VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
+                                          &buildInfo, &primitiveCount, &buildSizes);
+
+  buffer = std::make_unique<Buffer>(_appContext, buildSizes.accelerationStructureSize,
+                                    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
+                                        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                    MemoryStyle::kDedicated);
+
+  VkAccelerationStructureCreateInfoKHR createInfo{
+      VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR};
+  createInfo.buffer = buffer->getVkBuffer();
+  createInfo.size   = buildSizes.accelerationStructureSize;
+  createInfo.type   = type;
+  if (vkCreateAccelerationStructureKHR(_appContext->getDevice(), &createInfo, nullptr,
+                                       &accelerationStructure) != VK_SUCCESS) {
+    _logger->error("failed to create the chunk acceleration structure");
+  }
+  return buildSizes.buildScratchSize;
+}
+
+// the scratch address has its own alignment, which the allocator doesn't know of, so the buffer
+// is padded by it
+std::unique_ptr<Buffer>
+ChunkAccelerationStructure::_createScratchBuffer(VkDeviceSize scratchSize) const {
+  return std::make_unique<Buffer>(
+      _appContext, scratchSize + _scratchOffsetAlignment,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+      MemoryStyle::kDedicated);
+}
+
+VkDeviceAddress ChunkAccelerationStructure::_getScratchAddress(Buffer const &scratchBuffer) const {
+  VkDeviceSize const alignment = std::max<VkDeviceSize>(_scratchOffsetAlignment, 1);
+  return (scratchBuffer.getDeviceAddress() + alignment - 1) / alignment * alignment;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "glm/glm.hpp"
+#include "volk.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Logger;
+class VulkanApplicationContext;
+class Buffer;
+
+// the non-empty chunks of the window as a top level acceleration structure, for the ray queries of
+// the shadow and indirect rays, every chunk is an instance of the same unit box, translated to its
+// chunk index, the hardware traversal only finds the candidate chunks, the octrees are still
+// marched in the shaders
+// the top level structure is sized for the whole window, so that its handle never changes, the
+// unused instances are inactive
+class ChunkAccelerationStructure {
+public:
+  ChunkAccelerationStructure(VulkanApplicationContext *appContext, Logger *logger,
+                             size_t framesInFlight, uint32_t maxChunkCount);
+  ~ChunkAccelerationStructure();
+
+  // disable copy and move
+  ChunkAccelerationStructure(ChunkAccelerationStructure const &)            = delete;
+  ChunkAccelerationStructure(ChunkAccelerationStructure &&)                 = delete;
+  ChunkAccelerationStructure &operator=(ChunkAccelerationStructure const &) = delete;
+  ChunkAccelerationStructure &operator=(ChunkAccelerationStructure &&)      = delete;
+
+  [[nodiscard]] VkAccelerationStructureKHR const *getTopLevelAccelerationStructure() const {
+    return &_topLevelAccelerationStructure;
+  }
+
+  // fills the instances of the frame, its build command buffer has to be submitted with the frame,
+  // before the tracing
+  void updateInstances(size_t currentFrame, std::vector<glm::ivec3> const &chunkIndices);
+  VkCommandBuffer getBuildCommandBuffer(size_t currentFrame) {
+    return _buildCommandBuffers[currentFrame];
+  }
+
+private:
+  VulkanApplicationContext *_appContext;
+  Logger *_logger;
+  uint32_t _maxChunkCount;
+
+  VkDeviceSize _scratchOffsetAlignment = 0;
+
+  std::unique_ptr<Buffer> _aabbBuffer;
+  std::unique_ptr<Buffer> _bottomLevelBuffer;
+  VkAccelerationStructureKHR _bottomLevelAccelerationStructure = VK_NULL_HANDLE;
+  VkDeviceAddress _bottomLevelAddress                          = 0;
+
+  std::unique_ptr<Buffer> _topLevelBuffer;
+  VkAccelerationStructureKHR _topLevelAccelerationStructure = VK_NULL_HANDLE;
+  // the builds of the frames in flight are ordered on the queue, so they share the scratch buffer
+  std::unique_ptr<Buffer> _topLevelScratchBuffer;
+  std::vector<std::unique_ptr<Buffer>> _instanceBuffers;
+  std::vector<VkCommandBuffer> _buildCommandBuffers;
+
+  void _createBottomLevelAccelerationStructure();
+  void _createTopLevelAccelerationStructure(size_t framesInFlight);
+  void _recordBuildCommandBuffers();
+
+  // returns the scratch size of its builds
+  VkDeviceSize _createAccelerationStructure(VkAccelerationStructureTypeKHR type,
+                                            VkAccelerationStructureGeometryKHR const &geometry,
+                                            uint32_t primitiveCount,
+                                            std::unique_ptr<Buffer> &buffer,
+                                            VkAccelerationStructureKHR &accelerationStructure);
+  [[nodiscard]] std::unique_ptr<Buffer> _createScratchBuffer(VkDeviceSize scratchSize) const;
+  [[nodiscard]] VkDeviceAddress _getScratchAddress(Buffer const &scratchBuffer) const;
+};
@@ -1,33 +1,63 @@
 #include "SvoTracer.hpp"
 
+#include "../svo-builder/DynamicObjects.hpp"
 #include "../svo-builder/SvoBuilder.hpp"
+#include "ChunkAccelerationStructure.hpp"
+#include "TracingPassProfiler.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
 #include "camera/Camera.hpp"
 #include "camera/ShadowMapCamera.hpp"
+#include "application/BlockState.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "utils/config/RootDir.h"
+#include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
+#include "utils/event-types/EventType.hpp"
 #include "utils/io/ShaderFileReader.hpp"
 #include "utils/logger/Logger.hpp"
+#include "utils/startup-trace/StartupTrace.hpp"
+#include "utils/traversal-stats-sink/TraversalStatsSink.hpp"
 #include "vulkan-wrapper/descriptor-set/DescriptorSetBundle.hpp"
 #include "vulkan-wrapper/memory/Buffer.hpp"
 #include "vulkan-wrapper/memory/BufferBundle.hpp"
 #include "vulkan-wrapper/memory/Image.hpp"
+#include "vulkan-wrapper/memory/TransientImagePool.hpp"
 #include "vulkan-wrapper/pipeline/ComputePipeline.hpp"
 #include "vulkan-wrapper/sampler/Sampler.hpp"
+#include "vulkan-wrapper/utils/PassBarrierTracker.hpp"
+#include "vulkan-wrapper/utils/SimpleCommands.hpp"
 
 #include "config-container/ConfigContainer.hpp"
+#include "config-container/sub-config/ApplicationInfo.hpp"
+#include "config-container/sub-config/BenchmarkInfo.hpp"
+#include "config-container/sub-config/ShadowMapCameraInfo.hpp"
 #include "config-container/sub-config/SvoTracerInfo.hpp"
 #include "config-container/sub-config/SvoTracerTweakingInfo.hpp"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <thread>
 
 // should also be synchronized with the shader
-constexpr uint32_t kTransmittanceLutWidth    = 256;
-constexpr uint32_t kTransmittanceLutHeight   = 64;
-constexpr uint32_t kMultiScatteringLutWidth  = 32;
-constexpr uint32_t kMultiScatteringLutHeight = 32;
-constexpr uint32_t kSkyViewLutWidth          = 200;
-constexpr uint32_t kSkyViewLutHeight         = 200;
+constexpr uint32_t kTransmittanceLutWidth       = 256;
+constexpr uint32_t kTransmittanceLutHeight      = 64;
+constexpr uint32_t kMultiScatteringLutWidth     = 32;
+constexpr uint32_t kMultiScatteringLutHeight    = 32;
+constexpr uint32_t kSkyViewLutWidth             = 200;
+constexpr uint32_t kSkyViewLutHeight            = 200;
+constexpr uint32_t kChunkOccupancyCellDim       = 4;
+constexpr uint32_t kWavefrontQueueWorkGroupSize = 64;
+constexpr uint32_t kWavefrontDirectionBinCount  = 24;
+constexpr uint32_t kWavefrontRayBinScanSize     = 256;
+constexpr uint32_t kATrousFusedIterationCount   = 2;
+constexpr uint32_t kTraversalSurfaces           = 0;
+constexpr uint32_t kMaxBeamLevelCount =
+    TracingPassProfiler::kCoarseBeam - TracingPassProfiler::kCoarseBeamLevel3 + 1;
 
 namespace {
 float halton(int base, int index) {
@@ -64,6 +94,42 @@ glm::vec3 _getDirOnUnitSphere(float alt, float azi) {
 glm::vec3 _getSunDir(float sunAltitude, float sunAzimuth) {
   return _getDirOnUnitSphere(glm::radians(sunAltitude), glm::radians(sunAzimuth));
 }
+
+// mirrors getChunkOccupancyCellsDim of chunking.glsl
+glm::uvec3 _getChunkOccupancyCellsDim(glm::uvec3 chunksDim) {
+  return (chunksDim + kChunkOccupancyCellDim - 1U) / kChunkOccupancyCellDim;
+}
+
+// the indirect ray queue holds a ray per pixel, the shadow ray queue one for the surface and one
+// for the indirect hit of each pixel
+std::array<uint32_t, kWavefrontRayQueueCount> constexpr kWavefrontRaysPerPixel = {1, 2};
+
+// mirrors ComputePipeline::recordCommand, for the 8x8 work groups of the indirect pipelines
+VkDispatchIndirectCommand _makeDispatchCommand(glm::uvec2 threadCount) {
+  uint32_t constexpr kWorkGroupSize = 8;
+  return {(threadCount.x + kWorkGroupSize - 1) / kWorkGroupSize,
+          (threadCount.y + kWorkGroupSize - 1) / kWorkGroupSize, 1};
+}
+
+// mirrors the coarse beam pass, there's a beam on each corner of the beam cells, w = 16 -> 3,
+// w = 17 -> 4
+glm::uvec2 _getBeamCount(glm::uvec2 size, uint32_t beamResolution) {
+  return (size + glm::uvec2(beamResolution - 1)) / beamResolution + glm::uvec2(1);
+}
+
+// mirrors getGodRaySize of godRay.glsl
+glm::uvec2 _getGodRaySize(glm::uvec2 lowResSize, uint32_t godRayDownscale) {
+  return (lowResSize + godRayDownscale - 1U) / godRayDownscale;
+}
+
+uint32_t _getBeamLevelCount(SvoTracerInfo const &svoTracerInfo) {
+  return std::clamp(svoTracerInfo.beamLevelCount, 1U, kMaxBeamLevelCount);
+}
+
+// the level 0 is the finest one, each level above it halves the resolution of the beams
+TracingPassProfiler::Pass _getBeamLevelPass(uint32_t level) {
+  return static_cast<TracingPassProfiler::Pass>(TracingPassProfiler::kCoarseBeam - level);
+}
 }; // namespace
 
 SvoTracer::SvoTracer(VulkanApplicationContext *appContext, Logger *logger, size_t framesInFlight,
@@ -71,33 +137,86 @@ SvoTracer::SvoTracer(VulkanApplicationContext *appContext, Logger *logger, size_
                      ShaderChangeListener *shaderChangeListener, ConfigContainer *configContainer)
     : _appContext(appContext), _logger(logger), _window(window), _shaderCompiler(shaderCompiler),
       _shaderChangeListener(shaderChangeListener), _configContainer(configContainer),
-      _framesInFlight(framesInFlight) {
+      _framesInFlight(framesInFlight), _isHistoryPingPonged(framesInFlight % 2 == 0),
+      _outdatedTweakingGroupBits(framesInFlight, kAllTweakingGroups) {
   _camera          = std::make_unique<Camera>(_window, configContainer);
   _shadowMapCamera = std::make_unique<ShadowMapCamera>(configContainer);
 
+  GlobalEventDispatcher::get()
+      .sink<E_TweakingInfoChanged>()
+      .connect<&SvoTracer::_onTweakingInfoChanged>(this);
+
+  if (!_isHistoryPingPonged) {
+    _logger->warn("odd frames in flight count: {}, the history images are copied every frame",
+                  _framesInFlight);
+  }
+
   _updateImageResolutions();
 }
 
 SvoTracer::~SvoTracer() {
-  for (auto &commandBuffer : _tracingCommandBuffers) {
-    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getCommandPool(), 1,
+  GlobalEventDispatcher::get().disconnect(this);
+  for (auto &commandBuffer : _skyLutCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getAsyncComputeCommandPool(), 1,
+                         &commandBuffer);
+  }
+  for (auto &commandBuffer : _shadowMapCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getAsyncComputeCommandPool(), 1,
                          &commandBuffer);
   }
+  for (uint32_t frameIndex = 0; frameIndex < _renderingCommandPools.size(); frameIndex++) {
+    for (auto const *commandBuffers :
+         {&_chunkOccupancyCommandBuffers, &_coarseBeamCommandBuffers, &_tracingCommandBuffers}) {
+      vkFreeCommandBuffers(_appContext->getDevice(), _renderingCommandPools[frameIndex], 1,
+                           &(*commandBuffers)[frameIndex]);
+    }
+  }
+  if (_traversalQueryPool != VK_NULL_HANDLE) {
+    vkDestroyQueryPool(_appContext->getDevice(), _traversalQueryPool, nullptr);
+  }
+  if (_captureQueryPool != VK_NULL_HANDLE) {
+    vkDestroyQueryPool(_appContext->getDevice(), _captureQueryPool, nullptr);
+  }
+}
+
+VkCommandBuffer SvoTracer::getChunkAccelerationStructureCommandBuffer(size_t currentFrame) {
+  return _chunkAccelerationStructure->getBuildCommandBuffer(currentFrame);
 }
 
 void SvoTracer::processInput(double deltaTime) { _camera->processInput(deltaTime); }
 
-void SvoTracer::_updateImageResolutions() {
+void SvoTracer::setCameraPose(glm::vec3 const &position, float yaw, float pitch) {
+  _camera->setPose(position, yaw, pitch);
+}
+
+glm::vec3 SvoTracer::getCameraPosition() const { return _camera->getPosition(); }
+glm::vec3 SvoTracer::getCameraFront() const { return _camera->getFront(); }
+
+bool SvoTracer::_updateImageResolutions() {
   _highResWidth  = _appContext->getSwapchainExtentWidth();
   _highResHeight = _appContext->getSwapchainExtentHeight();
 
-  _lowResWidth =
-      static_cast<uint32_t>(_highResWidth / _configContainer->svoTracerInfo->upscaleRatio);
-  _lowResHeight =
-      static_cast<uint32_t>(_highResHeight / _configContainer->svoTracerInfo->upscaleRatio);
+  float const upscaleRatio = _configContainer->svoTracerInfo->upscaleRatio;
+  _lowResWidth             = static_cast<uint32_t>(_highResWidth / upscaleRatio);
+  _lowResHeight            = static_cast<uint32_t>(_highResHeight / upscaleRatio);
 
   _logger->info("target res: {}x{}", _highResWidth, _highResHeight);
   _logger->info("rendering res: {}x{}", _lowResWidth, _lowResHeight);
+
+  // the images are kept while the extent fits, and they aren't larger than its size class by more
+  // than a step, so that a shrunk window doesn't hold on to a lot of memory
+  glm::uvec2 const highResSize{_highResWidth, _highResHeight};
+  uint32_t const sizeClass = std::max(_configContainer->svoTracerInfo->renderTargetSizeClass, 1U);
+  glm::uvec2 const classSize = (highResSize + glm::uvec2(sizeClass - 1)) / sizeClass * sizeClass;
+  if (glm::all(glm::lessThanEqual(highResSize, _highResImageSize)) &&
+      glm::all(glm::lessThanEqual(_highResImageSize, classSize + glm::uvec2(sizeClass)))) {
+    return false;
+  }
+
+  _highResImageSize = classSize;
+  _lowResImageSize  = glm::uvec2(glm::vec2(classSize) / upscaleRatio);
+  _logger->info("render target size: {}x{}", _highResImageSize.x, _highResImageSize.y);
+  return true;
 }
 
 void SvoTracer::init(SvoBuilder *svoBuilder) {
@@ -106,16 +225,44 @@ void SvoTracer::init(SvoBuilder *svoBuilder) {
   _createSamplers();
 
   // images
-  _createImages();
-  _createImageForwardingPairs();
+  {
+    StartupTrace::Scope scope("tracer images");
+    _createImages();
+    _createImageForwardingPairs();
+  }
 
   // buffers
-  _createBuffersAndBufferBundles();
-  _initBufferData();
+  {
+    StartupTrace::Scope scope("tracer buffers");
+    _createBuffersAndBufferBundles();
+    _createWavefrontBuffers();
+    _createShadowReservoirBuffers();
+    _createRadianceCacheBuffer();
+    _createATrousTileListBuffers();
+    _createSamplingTileBuffer();
+    _createFrameDumpBuffers();
+    _createTraversalBenchmarkBuffers();
+    _createCaptureViewBuffer();
+    _initBufferData();
+  }
+
+  if (_appContext->isRayQuerySupported()) {
+    glm::uvec3 const chunksDim = _svoBuilder->getChunksDim();
+    _chunkAccelerationStructure = std::make_unique<ChunkAccelerationStructure>(
+        _appContext, _logger, _framesInFlight, chunksDim.x * chunksDim.y * chunksDim.z);
+  }
+
+  // pipelines, the compilations mostly wait for the prewarm tasks of their shaders
+  {
+    StartupTrace::Scope scope("tracer pipelines");
+    _createDescriptorSetBundle();
+    _createPipelines();
+  }
 
-  // pipelines
-  _createDescriptorSetBundle();
-  _createPipelines();
+  _passProfiler = std::make_unique<TracingPassProfiler>(_appContext, _logger, _framesInFlight);
+  // in the order of the ray types of G_TraversalHistogram
+  _traversalStatsSink = std::make_unique<TraversalStatsSink>(
+      std::vector<std::string>{"primary", "shadow", "indirect"});
 
   // create command buffers
   _recordRenderingCommandBuffers();
@@ -128,18 +275,29 @@ void SvoTracer::init(SvoBuilder *svoBuilder) {
       [this](CursorMoveInfo const &mouseInfo) { _camera->handleMouseMovement(mouseInfo); });
 }
 
+// the swapchain images are new in any case, the rest is only created again if the images don't fit
+// the new extent, the passes are dispatched for the extent indirectly otherwise
 void SvoTracer::onSwapchainResize() {
-  _updateImageResolutions();
+  _isStillnessBroken = true;
+  if (_updateImageResolutions()) {
+    // images
+    _createSwapchainRelatedImages();
+
+    // buffers
+    _createWavefrontBuffers();
+    _createShadowReservoirBuffers();
+    _createATrousTileListBuffers();
+    _createSamplingTileBuffer();
+    _createFrameDumpBuffers();
+
+    // pipelines
+    _createDescriptorSetBundle();
+    _updatePipelinesDescriptorBundles();
+
+    _recordRenderingCommandBuffers();
+  }
 
-  // images
-  _createSwapchainRelatedImages();
   _createImageForwardingPairs();
-
-  // pipelines
-  _createDescriptorSetBundle();
-  _updatePipelinesDescriptorBundles();
-
-  _recordRenderingCommandBuffers();
   _recordDeliveryCommandBuffers();
 }
 
@@ -151,7 +309,57 @@ void SvoTracer::_createTaaSamplingOffsets() {
   }
 }
 
-void SvoTracer::onPipelineRebuilt() { _recordRenderingCommandBuffers(); }
+void SvoTracer::onPipelineRebuilt() {
+  // the lut and shadow map shaders may have changed
+  _isSkyLutComputed    = false;
+  _isShadowMapRendered = false;
+  _recordRenderingCommandBuffers();
+}
+
+// the builder has added a page to the octree pool, the unused elements of the array were bound to
+// the first page till now, or left unbound, it's not called if the pages are read through their
+// addresses
+void SvoTracer::onOctreeBufferPagesChanged() {
+  _descriptorSetBundle->updateBufferArray(45, _svoBuilder->getOctreeBufferPages());
+  if (_configContainer->svoTracerInfo->octreeTexelBuffer) {
+    _descriptorSetBundle->updateBufferArray(67, _svoBuilder->getOctreeBufferPages());
+  }
+
+  // only the element of the new page is written then, which no recorded frame uses yet
+  if (_descriptorSetBundle->areBufferArraysUpdatedAfterBind()) {
+    return;
+  }
+
+  _recordRenderingCommandBuffers();
+  _recordDeliveryCommandBuffers();
+}
+
+void SvoTracer::onPipelineVariantsChanged() {
+  _tracingSpecializationConstants = _getTracingSpecializationConstants();
+  bool isVariantSwapped =
+      _svoTracingPipeline->setSpecializationConstants(_tracingSpecializationConstants);
+  isVariantSwapped |=
+      _svoCourseBeamPipeline->setSpecializationConstants(_getCoarseBeamSpecializationConstants());
+  bool const isPostChainFused   = _configContainer->svoTracerTweakingInfo->fusedPostChain;
+  bool const isPostChainSwapped = isPostChainFused != _isPostChainFused;
+  _isPostChainFused             = isPostChainFused;
+  if (isVariantSwapped || isPostChainSwapped) {
+    _recordRenderingCommandBuffers();
+  }
+}
+
+// mirrors the constant ids of svoTracing.comp
+std::vector<uint32_t> SvoTracer::_getTracingSpecializationConstants() const {
+  SvoTracerTweakingInfo const &td = *_configContainer->svoTracerTweakingInfo;
+  return {static_cast<uint32_t>(td.traceIndirectRay), static_cast<uint32_t>(td.beamOptimization),
+          static_cast<uint32_t>(td.visualizeChunks), static_cast<uint32_t>(td.visualizeOctree),
+          static_cast<uint32_t>(td.packetTraversal)};
+}
+
+// mirrors the constant ids of svoCoarseBeam.comp, the packets follow the ones of the tracing
+std::vector<uint32_t> SvoTracer::_getCoarseBeamSpecializationConstants() const {
+  return {static_cast<uint32_t>(_configContainer->svoTracerTweakingInfo->packetTraversal)};
+}
 
 void SvoTracer::_createSamplers() {
   {
@@ -176,12 +384,15 @@ void SvoTracer::_createImages() {
   _createBlueNoiseImages();
   _createSkyLutImages();
   _createShadowMapImage();
+  _createCaptureImage();
   _createSwapchainRelatedImages();
 }
 
 void SvoTracer::_createSwapchainRelatedImages() { _createFullSizedImages(); }
 
 void SvoTracer::_createBlueNoiseImages() {
+  VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+      _appContext, MemoryCategory::kBlueNoise);
   auto _loadNoise = [this](std::unique_ptr<Image> &noiseImage, std::string const &&stbnPath) {
     _logger->info("loading blue noise images from {}", stbnPath);
 
@@ -229,117 +440,213 @@ void SvoTracer::_createShadowMapImage() {
       _defaultSampler->getVkSampler());
 }
 
+void SvoTracer::_createCaptureImage() {
+  VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+      _appContext, MemoryCategory::kRenderTargets);
+  uint32_t const captureResolution = _configContainer->svoTracerInfo->captureResolution;
+  _captureImage                    = std::make_unique<Image>(
+      _appContext, ImageDimensions{captureResolution, captureResolution},
+      _configContainer->svoTracerInfo->captureViewCapacity, VK_FORMAT_R16G16B16A16_SFLOAT,
+      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+}
+
 // https://docs.vulkan.org/spec/latest/chapters/formats.html
 void SvoTracer::_createFullSizedImages() {
+  VulkanApplicationContext::MemoryCategoryScope const memoryCategoryScope(
+      _appContext, MemoryCategory::kRenderTargets);
+  ImageDimensions const lowResDimensions{_lowResImageSize.x, _lowResImageSize.y};
+  ImageDimensions const highResDimensions{_highResImageSize.x, _highResImageSize.y};
+
   // the sky hdr view is very sensitive to gradient, so a high precision format is a must
-  _backgroundImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _backgroundImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                             VK_IMAGE_USAGE_STORAGE_BIT);
 
-  // w = 16 -> 3, w = 17 -> 4
-  _beamDepthImage = std::make_unique<Image>(
-      _appContext,
-      ImageDimensions{
-          static_cast<uint32_t>(
-              std::ceil(static_cast<float>(_lowResWidth) /
-                        static_cast<float>(_configContainer->svoTracerInfo->beamResolution)) +
-              1),
-          static_cast<uint32_t>(
-              std::ceil(static_cast<float>(_lowResHeight) /
-                        static_cast<float>(_configContainer->svoTracerInfo->beamResolution)) +
-              1)},
-      VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
-
-  _rawImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                      VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
-
-  _instantImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
-
-  _depthImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                        VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _rawImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                      VK_IMAGE_USAGE_STORAGE_BIT);
+
+  _instantImage = std::make_unique<Image>(_appContext, lowResDimensions,
+                                          VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+                                          VK_IMAGE_USAGE_STORAGE_BIT);
 
   _octreeVisualizationImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+      _appContext, lowResDimensions, VK_FORMAT_B10G11R11_UFLOAT_PACK32,
       VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
-  _hitImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                      VK_FORMAT_R8_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+  // the g-buffer images that the denoising filters read are sampled as well, the fetches go
+  // through the texture cache, see hitTexture of the shaders
+  VkSampler const gBufferSampler = _defaultSampler->getVkSampler();
+
+  _hitImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R8_UINT,
+                                      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                      gBufferSampler);
 
-  _temporalHistLengthImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_R8_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
+  _temporalHistLengthImage = std::make_unique<Image>(
+      _appContext, lowResDimensions, VK_FORMAT_R8_UINT,
+      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, gBufferSampler);
 
-  _motionImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
+  _motionImage = std::make_unique<Image>(_appContext, lowResDimensions,
                                          VK_FORMAT_R16G16B16A16_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT);
-  _normalImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
-  _lastNormalImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
-  _positionImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32G32B32A32_SFLOAT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+  // both images of a history pair are written and read as the last one, when they are ping ponged
+  VkImageUsageFlags const historyUsage = VK_IMAGE_USAGE_STORAGE_BIT |
+                                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                         VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  VkImageUsageFlags const gBufferHistoryUsage = historyUsage | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+  _normalImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                         gBufferHistoryUsage, gBufferSampler);
+  _lastNormalImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                             gBufferHistoryUsage, gBufferSampler);
+
+  // the positions can be reconstructed from the depth, which takes a quarter of the texels
+  if (_configContainer->svoTracerInfo->positionFromDepth) {
+    _historyDepthImage = std::make_unique<Image>(_appContext, lowResDimensions,
+                                                 VK_FORMAT_R32_SFLOAT, gBufferHistoryUsage,
+                                                 gBufferSampler);
+    _lastDepthImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_SFLOAT,
+                                              gBufferHistoryUsage, gBufferSampler);
+  } else {
+    _positionImage = std::make_unique<Image>(_appContext, lowResDimensions,
+                                             VK_FORMAT_R32G32B32A32_SFLOAT, gBufferHistoryUsage,
+                                             gBufferSampler);
+    _lastPositionImage = std::make_unique<Image>(_appContext, lowResDimensions,
+                                                 VK_FORMAT_R32G32B32A32_SFLOAT,
+                                                 gBufferHistoryUsage, gBufferSampler);
+  }
 
-  _lastPositionImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32G32B32A32_SFLOAT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  _voxHashImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                          gBufferHistoryUsage, gBufferSampler);
+  _lastVoxHashImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                              gBufferHistoryUsage, gBufferSampler);
 
-  _voxHashImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
-  _lastVoxHashImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  if (_configContainer->svoTracerInfo->depthReprojection) {
+    _voxelDepthImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_SFLOAT,
+                                               VK_IMAGE_USAGE_STORAGE_BIT);
+    _isVoxelDepthWritten = false;
+  }
 
   // precision issues occurred when using VK_FORMAT_B10G11R11_UFLOAT_PACK32 to store hdr accumed
   // results, it can be observed when using a very low alpha blending value.
   // so either use VK_FORMAT_R32_UINT with custom RGBE packer / unpacker
-  _accumedImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
-  _lastAccumedImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  _accumedImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                          gBufferHistoryUsage, gBufferSampler);
+  _lastAccumedImage = std::make_unique<Image>(_appContext, lowResDimensions, VK_FORMAT_R32_UINT,
+                                              gBufferHistoryUsage, gBufferSampler);
+
+  if (_configContainer->svoTracerInfo->aTrousAdaptive ||
+      _configContainer->svoTracerInfo->adaptiveSampling) {
+    _temporalMomentsImage = std::make_unique<Image>(_appContext, lowResDimensions,
+                                                    VK_FORMAT_R32G32_SFLOAT, historyUsage);
+    _lastTemporalMomentsImage = std::make_unique<Image>(_appContext, lowResDimensions,
+                                                        VK_FORMAT_R32G32_SFLOAT, historyUsage);
+  }
 
-  _godRayAccumedImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+  glm::uvec2 const godRaySize =
+      _getGodRaySize(_lowResImageSize, _configContainer->svoTracerInfo->godRayDownscale);
+  ImageDimensions const godRayDimensions{godRaySize.x, godRaySize.y};
+  _godRayAccumedImage = std::make_unique<Image>(_appContext, godRayDimensions, VK_FORMAT_R32_UINT,
+                                                historyUsage);
 
-  _lastGodRayAccumedImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_lowResWidth, _lowResHeight}, VK_FORMAT_R32_UINT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  _lastGodRayAccumedImage = std::make_unique<Image>(_appContext, godRayDimensions,
+                                                    VK_FORMAT_R32_UINT, historyUsage);
 
-  // same for taa images, use VK_FORMAT_R16G16B16A16_SFLOAT to enable accelerated sampling
-  _taaImage = std::make_unique<Image>(_appContext, ImageDimensions{_highResWidth, _highResHeight},
-                                      VK_FORMAT_R16G16B16A16_SFLOAT,
-                                      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+  // same for taa images, use VK_FORMAT_R16G16B16A16_SFLOAT to enable accelerated sampling, both of
+  // them are sampled as the last one
+  _taaImage = std::make_unique<Image>(
+      _appContext, highResDimensions, VK_FORMAT_R16G16B16A16_SFLOAT,
+      historyUsage | VK_IMAGE_USAGE_SAMPLED_BIT, _defaultSampler->getVkSampler());
   _lastTaaImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_highResWidth, _highResHeight}, VK_FORMAT_R16G16B16A16_SFLOAT,
-      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
-      _defaultSampler->getVkSampler());
-
-  _blittedImage = std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                                          VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT);
-
-  // both of the ping and pong can be dumped to the render target image and the lastAccumedImage
-  _aTrousPingImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
-
-  // also serves as the output image
-  _aTrousPongImage =
-      std::make_unique<Image>(_appContext, ImageDimensions{_lowResWidth, _lowResHeight},
-                              VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_STORAGE_BIT);
+      _appContext, highResDimensions, VK_FORMAT_R16G16B16A16_SFLOAT,
+      historyUsage | VK_IMAGE_USAGE_SAMPLED_BIT, _defaultSampler->getVkSampler());
 
   _renderTargetImage = std::make_unique<Image>(
-      _appContext, ImageDimensions{_highResWidth, _highResHeight},
-      _appContext->getSwapchainImageFormat(),
+      _appContext, highResDimensions, _appContext->getSwapchainImageFormat(),
       VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
           VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
+  // the storage reads need the exact format of the shader, so it's not the swapchain one
+  _guiOverlayImage = std::make_unique<Image>(
+      _appContext, highResDimensions, VK_FORMAT_R8G8B8A8_UNORM,
+      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+          VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+  VkCommandBuffer commandBuffer =
+      beginSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool());
+  _guiOverlayImage->clearImage(commandBuffer);
+  endSingleTimeCommands(_appContext->getDevice(), _appContext->getCommandPool(),
+                        _appContext->getGraphicsQueue(), commandBuffer);
+
+  _createTransientImages();
+}
+
+// the pass ranges have to cover every pass that touches the images, they are acquired at the first
+// passes of their ranges, see _recordRenderingCommandBuffers
+void SvoTracer::_createTransientImages() {
+  _transientImagePool = std::make_unique<TransientImagePool>(_appContext, _logger);
+
+  ImageDimensions const lowResDimensions{_lowResImageSize.x, _lowResImageSize.y};
+
+  // the levels of the beams lie side by side, from the finest one at the origin, which is the only
+  // one the tracing reads, the shader derives their offsets from the render size the same way
+  auto const &svoTracerInfo     = *_configContainer->svoTracerInfo;
+  uint32_t const beamLevelCount = _getBeamLevelCount(svoTracerInfo);
+  ImageDimensions beamDepthDimensions{0, 0};
+  for (uint32_t level = 0; level < beamLevelCount; level++) {
+    glm::uvec2 const beamCount =
+        _getBeamCount(_lowResImageSize, svoTracerInfo.beamResolution << level);
+    beamDepthDimensions.width += beamCount.x;
+    beamDepthDimensions.height = std::max(beamDepthDimensions.height, beamCount.y);
+  }
+  uint32_t const beamDepth = _transientImagePool->addImage(
+      "beam depth", beamDepthDimensions, VK_FORMAT_R32_SFLOAT, VK_IMAGE_USAGE_STORAGE_BIT,
+      _getBeamLevelPass(beamLevelCount - 1), TracingPassProfiler::kTracing);
+
+  // nothing but the tracing reads the voxels of the last frame that land on the pixels
+  uint32_t reprojectedDepth = 0;
+  if (svoTracerInfo.depthReprojection) {
+    reprojectedDepth = _transientImagePool->addImage(
+        "reprojected depth", lowResDimensions, VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT,
+        TracingPassProfiler::kDepthReprojection, TracingPassProfiler::kTracing);
+  }
+
+  // the depth is read by the next frame when the positions are reconstructed from it
+  bool const isDepthTransient = !_configContainer->svoTracerInfo->positionFromDepth;
+  uint32_t depth              = 0;
+  if (isDepthTransient) {
+    depth = _transientImagePool->addImage("depth", lowResDimensions, VK_FORMAT_R32_SFLOAT,
+                                          VK_IMAGE_USAGE_STORAGE_BIT, TracingPassProfiler::kTracing,
+                                          TracingPassProfiler::kATrous);
+  }
+
+  // both of the ping and pong can be dumped to the render target image and the lastAccumedImage,
+  // the ping is the output of the temporal filter if the first iterations are fused
+  uint32_t const aTrousPingFirstPass = _configContainer->svoTracerInfo->aTrousFused
+                                           ? TracingPassProfiler::kTemporalFilter
+                                           : TracingPassProfiler::kATrous;
+  uint32_t const aTrousPing = _transientImagePool->addImage(
+      "a-trous ping", lowResDimensions, VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+      VK_IMAGE_USAGE_STORAGE_BIT, aTrousPingFirstPass, TracingPassProfiler::kATrous);
+
+  // also serves as the output image, which the fused post chain reads in the post processing
+  uint32_t const aTrousPong = _transientImagePool->addImage(
+      "a-trous pong", lowResDimensions, VK_FORMAT_B10G11R11_UFLOAT_PACK32,
+      VK_IMAGE_USAGE_STORAGE_BIT, TracingPassProfiler::kTemporalFilter,
+      TracingPassProfiler::kPostProcessing);
+
+  uint32_t const blitted = _transientImagePool->addImage(
+      "blitted", lowResDimensions, VK_FORMAT_R32_UINT, VK_IMAGE_USAGE_STORAGE_BIT,
+      TracingPassProfiler::kBackgroundBlit, TracingPassProfiler::kPostProcessing);
+
+  _transientImagePool->allocate();
+
+  _beamDepthImage  = _transientImagePool->getImage(beamDepth);
+  _reprojectedDepthImage =
+      svoTracerInfo.depthReprojection ? _transientImagePool->getImage(reprojectedDepth) : nullptr;
+  _aTrousPingImage = _transientImagePool->getImage(aTrousPing);
+  _aTrousPongImage = _transientImagePool->getImage(aTrousPong);
+  _blittedImage    = _transientImagePool->getImage(blitted);
+
+  _depthImage =
+      isDepthTransient ? _transientImagePool->getImage(depth) : _historyDepthImage.get();
 }
 
 void SvoTracer::_createImageForwardingPairs() {
@@ -347,9 +654,15 @@ void SvoTracer::_createImageForwardingPairs() {
       _normalImage.get(), _lastNormalImage.get(), VK_IMAGE_LAYOUT_GENERAL,
       VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
 
-  _positionForwardingPair = std::make_unique<ImageForwardingPair>(
-      _positionImage.get(), _lastPositionImage.get(), VK_IMAGE_LAYOUT_GENERAL,
-      VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
+  if (_configContainer->svoTracerInfo->positionFromDepth) {
+    _depthForwardingPair = std::make_unique<ImageForwardingPair>(
+        _historyDepthImage.get(), _lastDepthImage.get(), VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
+  } else {
+    _positionForwardingPair = std::make_unique<ImageForwardingPair>(
+        _positionImage.get(), _lastPositionImage.get(), VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
+  }
 
   _voxHashForwardingPair = std::make_unique<ImageForwardingPair>(
       _voxHashImage.get(), _lastVoxHashImage.get(), VK_IMAGE_LAYOUT_GENERAL,
@@ -359,6 +672,12 @@ void SvoTracer::_createImageForwardingPairs() {
       _accumedImage.get(), _lastAccumedImage.get(), VK_IMAGE_LAYOUT_GENERAL,
       VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
 
+  if (_temporalMomentsImage != nullptr) {
+    _temporalMomentsForwardingPair = std::make_unique<ImageForwardingPair>(
+        _temporalMomentsImage.get(), _lastTemporalMomentsImage.get(), VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
+  }
+
   _godRayAccumedForwardingPair = std::make_unique<ImageForwardingPair>(
       _godRayAccumedImage.get(), _lastGodRayAccumedImage.get(), VK_IMAGE_LAYOUT_GENERAL,
       VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
@@ -367,14 +686,27 @@ void SvoTracer::_createImageForwardingPairs() {
       _taaImage.get(), _lastTaaImage.get(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_UNDEFINED,
       VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL);
 
-  // creating forwarding pairs to copy the image result each frame to a specific swapchain
+  // creating forwarding pairs to copy the image result each frame to a specific swapchain, the gui
+  // is already composited, so it's presented right after
   _targetForwardingPairs.clear();
   for (int i = 0; i < _appContext->getSwapchainImagesCount(); i++) {
     _targetForwardingPairs.emplace_back(std::make_unique<ImageForwardingPair>(
         _renderTargetImage->getVkImage(), _appContext->getSwapchainImages()[i],
-        _renderTargetImage->getDimensions(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL));
+        ImageDimensions{_highResWidth, _highResHeight}, VK_IMAGE_LAYOUT_GENERAL,
+        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR));
+  }
+}
+
+// the descriptor sets of the odd frames in flight bind the pair the other way round, so that the
+// images written by a frame are read as the last ones by the next frame
+std::vector<Image *> SvoTracer::_getHistoryImageBundle(Image *image, Image *lastImage,
+                                                       bool isLastImage) const {
+  std::vector<Image *> images(_framesInFlight);
+  for (size_t i = 0; i < _framesInFlight; i++) {
+    bool const isSwapped = _isHistoryPingPonged && i % 2 == 1;
+    images[i]            = isSwapped != isLastImage ? lastImage : image;
   }
+  return images;
 }
 
 // these buffers are modified by the CPU side every frame, and we have multiple frames in flight,
@@ -384,221 +716,1156 @@ void SvoTracer::_createBuffersAndBufferBundles() {
   _sceneInfoBuffer =
       std::make_unique<Buffer>(_appContext, sizeof(G_SceneInfo), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
                                MemoryStyle::kDedicated);
+  // written by the sky lut submission, which runs before the first frame
+  _skyRadianceShBuffer = std::make_unique<Buffer>(_appContext, sizeof(G_SkyRadianceSh),
+                                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                  MemoryStyle::kDedicated);
+
+  // buffer bundles
+  // a slot per frame in flight, the host reads the one of the frame that's done, see getOutputInfo
+  _outputInfoBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_OutputInfo),
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kHostVisible);
+  G_OutputInfo const emptyOutputInfo{};
+  _outputInfoBufferBundle->fillData(&emptyOutputInfo);
+
+  // cleared by the command buffer of its frame, see _recordTraversalHistogramResetCommand
+  _traversalHistogramBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_TraversalHistogram),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kHostVisible);
+  G_TraversalHistogram const emptyTraversalHistogram{};
+  _traversalHistogramBufferBundle->fillData(&emptyTraversalHistogram);
+
+  // the constants of the frames are read by every pass, so they're kept in the device local
+  // memory, see _recordFrameConstantCopies
+  _renderInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_RenderInfo), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+      MemoryStyle::kDeviceLocalHostVisible);
+
+  _environmentInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_EnvironmentInfo), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+      MemoryStyle::kDeviceLocalHostVisible);
+
+  _tweakableParametersBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_TweakableParameters),
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+
+  _temporalFilterInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_TemporalFilterInfo),
+      VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+
+  _spatialFilterInfoBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_SpatialFilterInfo), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+      MemoryStyle::kDeviceLocalHostVisible);
+
+  _lowResDispatchBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(VkDispatchIndirectCommand),
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+
+  _beamDispatchBufferBundles.resize(_getBeamLevelCount(*_configContainer->svoTracerInfo));
+  for (auto &beamDispatchBufferBundle : _beamDispatchBufferBundles) {
+    beamDispatchBufferBundle = std::make_unique<BufferBundle>(
+        _appContext, _framesInFlight, sizeof(VkDispatchIndirectCommand),
+        VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+  }
 
-  _aTrousIterationBuffer = std::make_unique<Buffer>(_appContext, sizeof(uint32_t),
-                                                    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-                                                        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-                                                    MemoryStyle::kDedicated);
+  _highResDispatchBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(VkDispatchIndirectCommand),
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+
+  _godRayDispatchBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(VkDispatchIndirectCommand),
+      VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+
+  glm::uvec3 const cellsDim = _getChunkOccupancyCellsDim(_svoBuilder->getChunksDim());
+  _chunkOccupancyBufferBundle =
+      std::make_unique<BufferBundle>(_appContext, _framesInFlight,
+                                     sizeof(uint32_t) * cellsDim.x * cellsDim.y * cellsDim.z,
+                                     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+  // read by every step of the dda, so it's kept in the device local memory, the host writes the
+  // slot of a frame once its last submission is done
+  _dynamicObjectGridBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight,
+      sizeof(uint32_t) * _svoBuilder->getDynamicObjects()->getGridLength(),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDeviceLocalHostVisible);
+  _dynamicObjectGridBufferBundle->fillData();
+  // the grid of the builder is written into every slot again
+  _dynamicObjectGridFrameVersions.assign(_framesInFlight, _dynamicObjectGridVersion - 1);
+  _chunkFrustumBoundsBufferBundle = std::make_unique<BufferBundle>(
+      _appContext, _framesInFlight, sizeof(G_ChunkFrustumBounds),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+
+  // the bins are sized for the whole window, so they don't depend on the render size
+  glm::uvec3 const chunksDim = _svoBuilder->getChunksDim();
+
+  _wavefrontRayBinBuffer = std::make_unique<Buffer>(
+      _appContext,
+      sizeof(uint32_t) * chunksDim.x * chunksDim.y * chunksDim.z * kWavefrontDirectionBinCount,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+}
 
-  _aTrousIterationStagingBuffers.clear();
-  _aTrousIterationStagingBuffers.reserve(_configContainer->svoTracerInfo->aTrousSizeMax);
-  for (int i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
-    _aTrousIterationStagingBuffers.emplace_back(std::make_unique<Buffer>(
-        _appContext, sizeof(uint32_t), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryStyle::kDedicated));
+// sized for the low res images, so they are created again along with them
+void SvoTracer::_createWavefrontBuffers() {
+  VkDeviceSize const pixelCount =
+      static_cast<VkDeviceSize>(_lowResImageSize.x) * _lowResImageSize.y;
+
+  _wavefrontRayQueueBuffers.clear();
+  for (uint32_t queue = 0; queue < kWavefrontRayQueueCount; queue++) {
+    VkDeviceSize const queueSize = sizeof(G_WavefrontQueueInfo) +
+                                   sizeof(G_WavefrontRay) * kWavefrontRaysPerPixel.at(queue) *
+                                       pixelCount;
+    _wavefrontRayQueueBuffers.emplace_back(std::make_unique<Buffer>(
+        _appContext, queueSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        MemoryStyle::kDedicated));
   }
 
-  _outputInfoBuffer =
-      std::make_unique<Buffer>(_appContext, sizeof(G_OutputInfo),
+  _wavefrontPixelBuffer =
+      std::make_unique<Buffer>(_appContext, sizeof(G_WavefrontPixel) * pixelCount,
                                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
 
-  // buffer bundles
-  _renderInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_RenderInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+  _wavefrontBinnedRayBuffer = std::make_unique<Buffer>(
+      _appContext,
+      sizeof(G_WavefrontRay) * kWavefrontRaysPerPixel.at(kIndirectRayQueue) * pixelCount,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+}
 
-  _environmentInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_EnvironmentInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+// sized for the low res images as well, the history is cleared, so that a resize drops it
+void SvoTracer::_createShadowReservoirBuffers() {
+  VkDeviceSize const pixelCount =
+      static_cast<VkDeviceSize>(_lowResImageSize.x) * _lowResImageSize.y;
+  std::vector<G_ShadowReservoir> const invalidReservoirs(pixelCount);
+
+  _shadowReservoirBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_ShadowReservoir) * pixelCount,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+  _shadowReservoirBuffer->fillData(invalidReservoirs.data());
+
+  _lastShadowReservoirBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_ShadowReservoir) * pixelCount,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+  _lastShadowReservoirBuffer->fillData(invalidReservoirs.data());
+}
 
-  _tweakableParametersBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_TweakableParameters),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+// the keys are in world space, so the cache outlives the moves of the chunk window and the
+// resizes, it's cleared once, 0 marks an empty entry
+void SvoTracer::_createRadianceCacheBuffer() {
+  VkDeviceSize const entryCount = VkDeviceSize{1}
+                                  << _configContainer->svoTracerInfo->radianceCacheSizeLog2;
+  std::vector<G_RadianceCacheEntry> const emptyEntries(entryCount);
+
+  _radianceCacheBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_RadianceCacheEntry) * entryCount,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+  _radianceCacheBuffer->fillData(emptyEntries.data());
+}
 
-  _temporalFilterInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_TemporalFilterInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+void SvoTracer::_createATrousTileListBuffers() {
+  _aTrousTileListBuffers.clear();
+  if (!_configContainer->svoTracerInfo->aTrousAdaptive) {
+    return;
+  }
 
-  _spatialFilterInfoBufferBundle =
-      std::make_unique<BufferBundle>(_appContext, _framesInFlight, sizeof(G_SpatialFilterInfo),
-                                     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryStyle::kHostVisible);
+  glm::uvec2 const tilesDim    = (_lowResImageSize + kFilterTileSize - 1U) / kFilterTileSize;
+  VkDeviceSize const tileCount = static_cast<VkDeviceSize>(tilesDim.x) * tilesDim.y;
+  VkDeviceSize const listSize  = sizeof(G_ATrousTileListInfo) + sizeof(uint32_t) * tileCount;
+  for (uint32_t iteration = 0; iteration < kATrousMaxIterationCount; iteration++) {
+    _aTrousTileListBuffers.emplace_back(std::make_unique<Buffer>(
+        _appContext, listSize,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        MemoryStyle::kDedicated));
+  }
 }
 
-void SvoTracer::_initBufferData() {
-  G_SceneInfo sceneData = {_configContainer->svoTracerInfo->beamResolution,
-                           _svoBuilder->getVoxelLevelCount(), _svoBuilder->getChunksDim()};
-  _sceneInfoBuffer->fillData(&sceneData);
+// every tile starts out unconverged, so the tiles are all sampled after a resize
+void SvoTracer::_createSamplingTileBuffer() {
+  _samplingTileBuffer.reset();
+  if (!_configContainer->svoTracerInfo->adaptiveSampling) {
+    return;
+  }
+
+  glm::uvec2 const tilesDim = (_lowResImageSize + kFilterTileSize - 1U) / kFilterTileSize;
+  std::vector<uint32_t> const unconvergedTiles(static_cast<size_t>(tilesDim.x) * tilesDim.y, 0);
+  _samplingTileBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(uint32_t) * unconvergedTiles.size(),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kDedicated);
+  _samplingTileBuffer->fillData(unconvergedTiles.data());
+}
 
-  for (uint32_t i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
-    uint32_t aTrousIteration = i;
-    _aTrousIterationStagingBuffers[i]->fillData(&aTrousIteration);
+// the frames are read back once their slot comes around again, so the render loop never waits on
+// the copies
+void SvoTracer::_createFrameDumpBuffers() {
+  _frameDumpBuffers.clear();
+  bool const isDumped = _appContext->isHeadless()
+                            ? _configContainer->applicationInfo->dumpHeadlessFrames
+                            : _configContainer->applicationInfo->frameRecording;
+  if (!isDumped) {
+    return;
+  }
+  VkDeviceSize const frameSize = static_cast<VkDeviceSize>(_highResWidth) * _highResHeight * 4;
+  for (size_t i = 0; i < _framesInFlight; i++) {
+    _frameDumpBuffers.emplace_back(std::make_unique<Buffer>(
+        _appContext, frameSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, MemoryStyle::kHostReadback));
   }
 }
 
-void SvoTracer::_recordRenderingCommandBuffers() {
-  for (auto &commandBuffer : _tracingCommandBuffers) {
-    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getCommandPool(), 1,
+// the surfaces are only read by the benchmark, a single one is enough otherwise
+void SvoTracer::_createTraversalBenchmarkBuffers() {
+  _traversalStatsBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_TraversalStats),
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      MemoryStyle::kHostVisible);
+
+  VkDeviceSize const surfaceCount =
+      std::max(_configContainer->benchmarkInfo->traversalRayCount, 1U);
+  _traversalSurfaceBuffer =
+      std::make_unique<Buffer>(_appContext, sizeof(G_TraversalSurface) * surfaceCount,
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kDedicated);
+}
+
+SvoTracer::TraversalBatchResult SvoTracer::runTraversalBatch(size_t currentFrame,
+                                                             TraversalRayMode mode, uint32_t seed) {
+  auto const &device    = _appContext->getDevice();
+  auto const frameIndex = static_cast<uint32_t>(currentFrame);
+
+  // the rays cover the screen with its aspect ratio
+  uint32_t const rayCount = _configContainer->benchmarkInfo->traversalRayCount;
+  double const aspectRatio =
+      static_cast<double>(_highResWidth) / static_cast<double>(std::max(_highResHeight, 1U));
+  uint32_t const gridWidth =
+      std::max(static_cast<uint32_t>(std::round(std::sqrt(rayCount * aspectRatio))), 1U);
+
+  if (_traversalQueryPool == VK_NULL_HANDLE) {
+    VkQueryPoolCreateInfo queryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    queryPoolInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 2;
+    vkCreateQueryPool(device, &queryPoolInfo, nullptr, &_traversalQueryPool);
+  }
+
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, _appContext->getCommandPool());
+  vkCmdResetQueryPool(commandBuffer, _traversalQueryPool, 0, 2);
+  vkCmdFillBuffer(commandBuffer, _traversalStatsBuffer->getVkBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+  if (mode != TraversalRayMode::kCoherentPrimary) {
+    std::array<uint32_t, 4> const surfacePushConstants = {kTraversalSurfaces, rayCount, gridWidth,
+                                                          seed};
+    _traversalBenchmarkPipeline->recordCommand(commandBuffer, frameIndex, rayCount, 1, 1,
+                                               surfacePushConstants.data());
+  }
+
+  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
+                       nullptr);
+
+  std::array<uint32_t, 4> const pushConstants = {static_cast<uint32_t>(mode), rayCount, gridWidth,
+                                                 seed};
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _traversalQueryPool, 0);
+  _traversalBenchmarkPipeline->recordCommand(commandBuffer, frameIndex, rayCount, 1, 1,
+                                             pushConstants.data());
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _traversalQueryPool, 1);
+
+  memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  memoryBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+
+  endSingleTimeCommands(device, _appContext->getCommandPool(), _appContext->getGraphicsQueue(),
+                        commandBuffer);
+
+  std::array<uint64_t, 2> timestamps{};
+  vkGetQueryPoolResults(device, _traversalQueryPool, 0, 2, sizeof(timestamps), timestamps.data(),
+                        sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_appContext->getPhysicalDevice(), &properties);
+
+  TraversalBatchResult result{};
+  double constexpr kNsPerMs = 1000000.0;
+  result.gpuTimeMs          = static_cast<double>(timestamps[1] - timestamps[0]) *
+                     static_cast<double>(properties.limits.timestampPeriod) / kNsPerMs;
+  vmaInvalidateAllocation(_appContext->getAllocator(), _traversalStatsBuffer->getAllocation(), 0,
+                          VK_WHOLE_SIZE);
+  std::memcpy(&result.stats, _traversalStatsBuffer->getMappedAddr(), sizeof(G_TraversalStats));
+  return result;
+}
+
+void SvoTracer::_createCaptureViewBuffer() {
+  _captureViewBuffer = std::make_unique<Buffer>(
+      _appContext, sizeof(G_CaptureView) * _configContainer->svoTracerInfo->captureViewCapacity,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryStyle::kHostVisible);
+}
+
+std::vector<SvoTracer::CaptureView> SvoTracer::makeCubemapCaptureViews(glm::vec3 position) {
+  // +x, -x, +y, -y, +z, -z, the right and the up of each face follow the texel axes of the cube
+  // layers, the rows of a layer go down along -up
+  std::array<std::pair<glm::vec3, glm::vec3>, 6> const faceAxes = {{
+      {{0.F, 0.F, -1.F}, {0.F, 1.F, 0.F}},
+      {{0.F, 0.F, 1.F}, {0.F, 1.F, 0.F}},
+      {{1.F, 0.F, 0.F}, {0.F, 0.F, -1.F}},
+      {{1.F, 0.F, 0.F}, {0.F, 0.F, 1.F}},
+      {{1.F, 0.F, 0.F}, {0.F, 1.F, 0.F}},
+      {{-1.F, 0.F, 0.F}, {0.F, 1.F, 0.F}},
+  }};
+  float constexpr kCubeFaceFovDegrees = 90.F;
+
+  std::vector<CaptureView> views{};
+  views.reserve(faceAxes.size());
+  for (auto const &[right, up] : faceAxes) {
+    views.push_back({position, right, up, glm::cross(up, right), kCubeFaceFovDegrees});
+  }
+  return views;
+}
+
+double SvoTracer::captureViews(size_t currentFrame, std::vector<CaptureView> const &views,
+                               uint32_t seed) {
+  auto const &device        = _appContext->getDevice();
+  auto const &svoTracerInfo = *_configContainer->svoTracerInfo;
+  auto const frameIndex     = static_cast<uint32_t>(currentFrame);
+
+  auto const viewCount =
+      static_cast<uint32_t>(std::min<size_t>(views.size(), svoTracerInfo.captureViewCapacity));
+  if (viewCount < views.size()) {
+    _logger->warn("only {} of the {} views are captured, see SvoTracer.captureViewCapacity",
+                  viewCount, views.size());
+  }
+  if (viewCount == 0) {
+    return 0.0;
+  }
+
+  std::vector<G_CaptureView> captureViewData(svoTracerInfo.captureViewCapacity);
+  for (uint32_t i = 0; i < viewCount; i++) {
+    auto const &view              = views[i];
+    captureViewData[i].position   = view.position;
+    captureViewData[i].tanHalfFov = std::tan(glm::radians(view.fovDegrees) * 0.5F);
+    captureViewData[i].right      = view.right;
+    captureViewData[i].up         = view.up;
+    captureViewData[i].forward    = view.forward;
+  }
+  _captureViewBuffer->fillData(captureViewData.data());
+
+  if (_captureQueryPool == VK_NULL_HANDLE) {
+    VkQueryPoolCreateInfo queryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    queryPoolInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 2;
+    vkCreateQueryPool(device, &queryPoolInfo, nullptr, &_captureQueryPool);
+  }
+
+  VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, _appContext->getCommandPool());
+  vkCmdResetQueryPool(commandBuffer, _captureQueryPool, 0, 2);
+
+  // a single dispatch covers all of the views, their index is the z of the dispatch
+  std::array<uint32_t, 4> const pushConstants = {viewCount, svoTracerInfo.captureResolution,
+                                                 svoTracerInfo.captureSampleCount, seed};
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _captureQueryPool, 0);
+  _viewCapturePipeline->recordCommand(commandBuffer, frameIndex, svoTracerInfo.captureResolution,
+                                      svoTracerInfo.captureResolution, viewCount,
+                                      pushConstants.data());
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _captureQueryPool, 1);
+
+  // the layers are read by the transfers or the shaders of the caller
+  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1,
+                       &memoryBarrier, 0, nullptr, 0, nullptr);
+
+  endSingleTimeCommands(device, _appContext->getCommandPool(), _appContext->getGraphicsQueue(),
+                        commandBuffer);
+
+  std::array<uint64_t, 2> timestamps{};
+  vkGetQueryPoolResults(device, _captureQueryPool, 0, 2, sizeof(timestamps), timestamps.data(),
+                        sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_appContext->getPhysicalDevice(), &properties);
+
+  double constexpr kNsPerMs = 1000000.0;
+  return static_cast<double>(timestamps[1] - timestamps[0]) *
+         static_cast<double>(properties.limits.timestampPeriod) / kNsPerMs;
+}
+
+uint8_t const *SvoTracer::getFrameDump(size_t currentFrame) {
+  if (currentFrame >= _frameDumpBuffers.size()) {
+    return nullptr;
+  }
+  auto &frameDumpBuffer = _frameDumpBuffers[currentFrame];
+  // the memory may not be host coherent
+  vmaInvalidateAllocation(_appContext->getAllocator(), frameDumpBuffer->getAllocation(), 0,
+                          VK_WHOLE_SIZE);
+  return static_cast<uint8_t const *>(frameDumpBuffer->getMappedAddr());
+}
+
+void SvoTracer::_initBufferData() {
+  auto const &svoTracerInfo = *_configContainer->svoTracerInfo;
+  G_SceneInfo sceneData     = {svoTracerInfo.beamResolution,
+                               _svoBuilder->getVoxelLevelCount(),
+                               _svoBuilder->getChunksDim(),
+                               1U << svoTracerInfo.radianceCacheSizeLog2,
+                               std::max(svoTracerInfo.radianceCacheUpdateInterval, 1U),
+                               svoTracerInfo.godRayDownscale,
+                               svoTracerInfo.tracingInterleave};
+  _sceneInfoBuffer->fillData(&sceneData);
+}
+
+void SvoTracer::_recordSkyLutCommandBuffers() {
+  for (auto &commandBuffer : _skyLutCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getAsyncComputeCommandPool(), 1,
                          &commandBuffer);
   }
-  _tracingCommandBuffers.clear();
+  _skyLutCommandBuffers.clear();
 
-  _tracingCommandBuffers.resize(_framesInFlight); //  change this later on, because it is
-                                                  //  bounded to the swapchain image
+  _skyLutCommandBuffers.resize(_framesInFlight);
   VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
-  allocInfo.commandPool        = _appContext->getCommandPool();
+  allocInfo.commandPool        = _appContext->getAsyncComputeCommandPool();
   allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-  allocInfo.commandBufferCount = (uint32_t)_tracingCommandBuffers.size();
+  allocInfo.commandBufferCount = static_cast<uint32_t>(_skyLutCommandBuffers.size());
 
-  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, _tracingCommandBuffers.data());
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, _skyLutCommandBuffers.data());
 
   VkMemoryBarrier uboWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
   uboWritingBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT;
   uboWritingBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-  // create the general memory barrier
   VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
   memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
   memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
 
-  for (uint32_t frameIndex = 0; frameIndex < _tracingCommandBuffers.size(); frameIndex++) {
-    auto &cmdBuffer = _tracingCommandBuffers[frameIndex];
+  for (uint32_t frameIndex = 0; frameIndex < _skyLutCommandBuffers.size(); frameIndex++) {
+    auto &cmdBuffer = _skyLutCommandBuffers[frameIndex];
 
     VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
     vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+    _passProfiler->recordReset(cmdBuffer, frameIndex, TracingPassProfiler::kTransmittanceLut,
+                               TracingPassProfiler::kShadowMap);
 
-    // make all host writes to the ubo visible to the shaders
+    // the luts are shared by the frames in flight, the submission waits on the graphics queue, so
+    // that the previous frame is done sampling them, the compute stage is waited on as well, for
+    // when it's submitted along the graphics passes
     vkCmdPipelineBarrier(cmdBuffer,
-                         VK_PIPELINE_STAGE_HOST_BIT,           // source stage
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // destination stage
-                         0,                                    // dependency flags
-                         1,                                    // memory barrier count
-                         &uboWritingBarrier,                   // memory barriers
-                         0,                                    // buffer memory barrier count
-                         nullptr,                              // buffer memory barriers
-                         0,                                    // image memory barrier count
-                         nullptr                               // image memory barriers
-    );
-
-    // _renderTargetImage->clearImage(cmdBuffer);
+                         VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &uboWritingBarrier, 0, nullptr,
+                         0, nullptr);
+
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kTransmittanceLut);
     _transmittanceLutPipeline->recordCommand(cmdBuffer, frameIndex, kTransmittanceLutWidth,
                                              kTransmittanceLutHeight, 1);
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kTransmittanceLut);
 
     vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
                          nullptr);
 
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kMultiScatteringLut);
     _multiScatteringLutPipeline->recordCommand(cmdBuffer, frameIndex, kMultiScatteringLutWidth,
                                                kMultiScatteringLutHeight, 1);
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kMultiScatteringLut);
 
     vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
                          nullptr);
 
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kSkyViewLut);
     _skyViewLutPipeline->recordCommand(cmdBuffer, frameIndex, kSkyViewLutWidth, kSkyViewLutHeight,
                                        1);
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kSkyViewLut);
 
     vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
                          nullptr);
 
-    _shadowMapPipeline->recordCommand(cmdBuffer, frameIndex,
-                                      _configContainer->svoTracerInfo->shadowMapResolution,
-                                      _configContainer->svoTracerInfo->shadowMapResolution, 1);
+    // a single group projects the sky view lut
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kSkyRadianceSh);
+    _skyRadianceShPipeline->recordCommand(cmdBuffer, frameIndex, 256, 1, 1);
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kSkyRadianceSh);
 
+    // the tracing command buffer samples the luts, it waits on this submission, or is submitted
+    // after it to the same queue
     vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
                          nullptr);
 
-    _svoCourseBeamPipeline->recordCommand(
-        cmdBuffer, frameIndex,
-        static_cast<uint32_t>(
-            std::ceil(static_cast<float>(_lowResWidth) /
-                      static_cast<float>(_configContainer->svoTracerInfo->beamResolution))) +
-            1,
-        static_cast<uint32_t>(
-            std::ceil(static_cast<float>(_lowResHeight) /
-                      static_cast<float>(_configContainer->svoTracerInfo->beamResolution))) +
-            1,
-        1);
+    vkEndCommandBuffer(cmdBuffer);
+  }
+}
 
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+void SvoTracer::_recordShadowMapCommandBuffers() {
+  for (auto &commandBuffer : _shadowMapCommandBuffers) {
+    vkFreeCommandBuffers(_appContext->getDevice(), _appContext->getAsyncComputeCommandPool(), 1,
+                         &commandBuffer);
+  }
+  _shadowMapCommandBuffers.clear();
 
-    _svoTracingPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+  _shadowMapCommandBuffers.resize(_framesInFlight);
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = _appContext->getAsyncComputeCommandPool();
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = static_cast<uint32_t>(_shadowMapCommandBuffers.size());
 
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+  vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, _shadowMapCommandBuffers.data());
 
-    _godRayPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+  // the shader writes are those of the chunk occupancy, for when it's submitted along the graphics
+  // passes
+  VkMemoryBarrier uboWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  uboWritingBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  uboWritingBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
 
-    _temporalFilterPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+  for (uint32_t frameIndex = 0; frameIndex < _shadowMapCommandBuffers.size(); frameIndex++) {
+    auto &cmdBuffer = _shadowMapCommandBuffers[frameIndex];
+
+    VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+    _passProfiler->recordReset(cmdBuffer, frameIndex, TracingPassProfiler::kShadowMap,
+                               TracingPassProfiler::kChunkOccupancy);
+
+    // the map is shared by the frames in flight as well, mirrors the sky luts
+    vkCmdPipelineBarrier(cmdBuffer,
+                         VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &uboWritingBarrier, 0, nullptr,
+                         0, nullptr);
+
+    // the occupancy of the frame is computed by the chunk occupancy command buffer, which this
+    // submission waits on
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kShadowMap);
+    _shadowMapPipeline->recordCommand(cmdBuffer, frameIndex,
+                                      _configContainer->svoTracerInfo->shadowMapResolution,
+                                      _configContainer->svoTracerInfo->shadowMapResolution, 1);
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kShadowMap);
 
     vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
                          VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
                          nullptr);
 
-    for (int i = 0; i < _configContainer->svoTracerInfo->aTrousSizeMax; i++) {
-      VkBufferCopy bufCopy = {
-          0,                                 // srcOffset
-          0,                                 // dstOffset,
-          _aTrousIterationBuffer->getSize(), // size
-      };
-
-      vkCmdCopyBuffer(cmdBuffer, _aTrousIterationStagingBuffers[i]->getVkBuffer(),
-                      _aTrousIterationBuffer->getVkBuffer(), 1, &bufCopy);
-
-      VkMemoryBarrier bufferCopyMemoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
-      bufferCopyMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-      bufferCopyMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-      vkCmdPipelineBarrier(cmdBuffer,
-                           VK_PIPELINE_STAGE_TRANSFER_BIT,       // source stage
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, // destination stage
-                           0,                                    // dependency flags
-                           1,                                    // memory barrier count
-                           &bufferCopyMemoryBarrier,             // memory barriers
-                           0,                                    // buffer memory barrier count
-                           nullptr,                              // buffer memory barriers
-                           0,                                    // image memory barrier count
-                           nullptr                               // image memory barriers
-      );
-
-      _aTrousPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
-
-      vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr,
-                           0, nullptr);
+    vkEndCommandBuffer(cmdBuffer);
+  }
+}
+
+// the constants of the frame are copied from their staging buffers, when the device can't map its
+// local memory, at the top of the first command buffer of the frame, the async compute passes wait
+// on it as well
+void SvoTracer::_recordFrameConstantCopies(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+  std::vector<BufferBundle *> frameConstantBundles = {
+      _renderInfoBufferBundle.get(),          _environmentInfoBufferBundle.get(),
+      _tweakableParametersBufferBundle.get(), _temporalFilterInfoBufferBundle.get(),
+      _spatialFilterInfoBufferBundle.get(),   _lowResDispatchBufferBundle.get(),
+      _highResDispatchBufferBundle.get(),     _godRayDispatchBufferBundle.get()};
+  for (auto const &beamDispatchBufferBundle : _beamDispatchBufferBundles) {
+    frameConstantBundles.push_back(beamDispatchBufferBundle.get());
+  }
+  for (auto *bundle : frameConstantBundles) {
+    bundle->getBuffer(frameIndex)->recordStagedCopy(commandBuffer);
+  }
+}
+
+// the occupancy is derived from the chunk indices every frame, after the chunk swaps the frame
+// waits on, it's per frame in flight, so that it's never overwritten while another frame reads it,
+// the bounds of the chunks in the frusta are merged into it with atomics, so they're reset first
+void SvoTracer::_recordChunkOccupancyCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+  VkBuffer const frustumBoundsBuffer =
+      _chunkFrustumBoundsBufferBundle->getBuffer(frameIndex)->getVkBuffer();
+  VkDeviceSize constexpr kFrustumBoundsSize = sizeof(G_ChunkFrustumBounds::boundsMin);
+  vkCmdFillBuffer(commandBuffer, frustumBoundsBuffer, offsetof(G_ChunkFrustumBounds, boundsMin),
+                  kFrustumBoundsSize, std::numeric_limits<uint32_t>::max());
+  vkCmdFillBuffer(commandBuffer, frustumBoundsBuffer, offsetof(G_ChunkFrustumBounds, boundsMax),
+                  kFrustumBoundsSize, 0);
+
+  VkMemoryBarrier frustumBoundsResetBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  frustumBoundsResetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  frustumBoundsResetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &frustumBoundsResetBarrier, 0,
+                       nullptr, 0, nullptr);
+
+  glm::uvec3 const cellsDim = _getChunkOccupancyCellsDim(_svoBuilder->getChunksDim());
+  _chunkOccupancyPipeline->recordCommand(commandBuffer, frameIndex, cellsDim.x, cellsDim.y,
+                                         cellsDim.z);
+}
+
+// the queues and the ray bins are emptied before the primary rays append to them, after the kernels
+// of the previous frame are done with them
+void SvoTracer::_recordWavefrontQueueResetCommand(VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier queueReadingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  queueReadingBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  queueReadingBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, // source stage
+                       VK_PIPELINE_STAGE_TRANSFER_BIT,          // destination stage
+                       0,                                       // dependency flags
+                       1,                                       // memory barrier count
+                       &queueReadingBarrier,                    // memory barriers
+                       0,                                       // buffer memory barrier count
+                       nullptr,                                 // buffer memory barriers
+                       0,                                       // image memory barrier count
+                       nullptr                                  // image memory barriers
+  );
+
+  for (auto const &queueBuffer : _wavefrontRayQueueBuffers) {
+    vkCmdFillBuffer(commandBuffer, queueBuffer->getVkBuffer(), 0, sizeof(G_WavefrontQueueInfo), 0);
+  }
+  vkCmdFillBuffer(commandBuffer, _wavefrontRayBinBuffer->getVkBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+  VkMemoryBarrier queueResetBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  queueResetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  queueResetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &queueResetBarrier, 0, nullptr,
+                       0, nullptr);
+}
+
+// the lists are appended to by the temporal filter, the indirect dispatches of the last frame have
+// to be done with them first, mirrors _recordWavefrontQueueResetCommand
+void SvoTracer::_recordATrousTileListResetCommand(VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier listReadingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  listReadingBarrier.srcAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+  listReadingBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &listReadingBarrier, 0, nullptr, 0,
+                       nullptr);
+
+  // a group per tile, so the tile count is the dispatch itself
+  G_ATrousTileListInfo const emptyList{0, 1, 1, 0};
+  for (auto const &listBuffer : _aTrousTileListBuffers) {
+    vkCmdUpdateBuffer(commandBuffer, listBuffer->getVkBuffer(), 0, sizeof(G_ATrousTileListInfo),
+                      &emptyList);
+  }
+
+  VkMemoryBarrier listResetBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  listResetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  listResetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &listResetBarrier, 0, nullptr,
+                       0, nullptr);
+}
+
+// the slot was last read by the host before this frame was recorded, so only the tracing has to
+// wait for the clear
+void SvoTracer::_recordTraversalHistogramResetCommand(VkCommandBuffer commandBuffer,
+                                                      uint32_t frameIndex) {
+  vkCmdFillBuffer(commandBuffer,
+                  _traversalHistogramBufferBundle->getBuffer(frameIndex)->getVkBuffer(), 0,
+                  VK_WHOLE_SIZE, 0);
+
+  VkMemoryBarrier histogramResetBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  histogramResetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  histogramResetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &histogramResetBarrier, 0,
+                       nullptr, 0, nullptr);
+}
+
+// every stage appends its surviving rays to the queues compactly, their dispatches are derived
+// from the ray counts right after, so the kernel of a bounce only runs over the rays that reach it,
+// the dispatches are empty while the megakernel traces all of them
+void SvoTracer::_recordWavefrontBouncesCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+  VkMemoryBarrier queueWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  queueWritingBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  queueWritingBarrier.dstAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+  VkPipelineStageFlags const queueReadingStages =
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+
+  _wavefrontQueueArgPipeline->recordCommand(commandBuffer, frameIndex, 1, 1, 1);
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  // the counting sort of the indirect rays, the passes return right away while it's off
+  _wavefrontRayBinCountPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex, _wavefrontRayQueueBuffers[kIndirectRayQueue]->getVkBuffer());
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  _wavefrontRayBinScanPipeline->recordCommand(commandBuffer, frameIndex, kWavefrontRayBinScanSize,
+                                              1, 1);
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  _wavefrontRayBinScatterPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex, _wavefrontRayQueueBuffers[kIndirectRayQueue]->getVkBuffer());
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  _wavefrontIndirectRaysPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex, _wavefrontRayQueueBuffers[kIndirectRayQueue]->getVkBuffer());
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  // the shadow rays of the indirect hits are appended now
+  _wavefrontQueueArgPipeline->recordCommand(commandBuffer, frameIndex, 1, 1, 1);
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  _wavefrontShadowRaysPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex, _wavefrontRayQueueBuffers[kShadowRayQueue]->getVkBuffer());
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, queueReadingStages, 0,
+                       1, &queueWritingBarrier, 0, nullptr, 0, nullptr);
+
+  _wavefrontResolvePipeline->recordIndirectCommand(
+      commandBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+}
+
+// the pixels of this frame are cleared, then the voxels of the last frame are scattered to them,
+// the dispatches cover the whole images, since the last frame may have been rendered at another
+// scale
+void SvoTracer::_recordDepthReprojectionCommand(VkCommandBuffer commandBuffer,
+                                                uint32_t frameIndex, PassBarrierTracker &tracker) {
+  _transientImagePool->recordImageAcquiringBarriers(commandBuffer,
+                                                    TracingPassProfiler::kDepthReprojection);
+  _passProfiler->recordPassBegin(commandBuffer, frameIndex,
+                                 TracingPassProfiler::kDepthReprojection);
+
+  uint32_t isScattering = 0;
+  tracker.recordPassDependencies(commandBuffer, {}, {_reprojectedDepthImage});
+  _depthReprojectionPipeline->recordCommand(commandBuffer, frameIndex, _lowResImageSize.x,
+                                            _lowResImageSize.y, 1, &isScattering);
+
+  // the voxel depths were written by the tracing of the last frame, which the tracker doesn't see
+  VkMemoryBarrier voxelDepthReadingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  voxelDepthReadingBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  voxelDepthReadingBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &voxelDepthReadingBarrier, 0,
+                       nullptr, 0, nullptr);
+
+  isScattering = 1;
+  tracker.recordPassDependencies(commandBuffer, {_voxelDepthImage.get(), _reprojectedDepthImage},
+                                 {_reprojectedDepthImage});
+  _depthReprojectionPipeline->recordCommand(commandBuffer, frameIndex, _lowResImageSize.x,
+                                            _lowResImageSize.y, 1, &isScattering);
+
+  _passProfiler->recordPassEnd(commandBuffer, frameIndex, TracingPassProfiler::kDepthReprojection);
+}
+
+void SvoTracer::_recordPostChainCommands(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                         PassBarrierTracker &tracker) {
+  tracker.recordPassDependencies(
+      commandBuffer,
+      {_backgroundImage.get(), _instantImage.get(), _hitImage.get(), _aTrousPongImage},
+      {_blittedImage});
+  _transientImagePool->recordImageAcquiringBarriers(commandBuffer,
+                                                    TracingPassProfiler::kBackgroundBlit);
+  _passProfiler->recordPassBegin(commandBuffer, frameIndex, TracingPassProfiler::kBackgroundBlit);
+  _backgroundBlitPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(commandBuffer, frameIndex, TracingPassProfiler::kBackgroundBlit);
+
+  tracker.recordPassDependencies(
+      commandBuffer, {_motionImage.get(), _blittedImage, _lastTaaImage.get()}, {_taaImage.get()});
+  _passProfiler->recordPassBegin(commandBuffer, frameIndex, TracingPassProfiler::kTaaUpscaling);
+  _taaUpscalingPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex,
+      _highResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(commandBuffer, frameIndex, TracingPassProfiler::kTaaUpscaling);
+
+  tracker.recordPassDependencies(commandBuffer,
+                                 {_rawImage.get(), _octreeVisualizationImage.get(),
+                                  _taaImage.get(), _blittedImage, _shadowMapImage.get()},
+                                 {_renderTargetImage.get()});
+  _passProfiler->recordPassBegin(commandBuffer, frameIndex, TracingPassProfiler::kPostProcessing);
+  _postProcessingPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex,
+      _highResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(commandBuffer, frameIndex, TracingPassProfiler::kPostProcessing);
+}
+
+// the blitted image is left unacquired, the a-trous pong is read till the post processing instead
+void SvoTracer::_recordFusedPostChainCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                             PassBarrierTracker &tracker) {
+  tracker.recordPassDependencies(
+      commandBuffer,
+      {_backgroundImage.get(), _instantImage.get(), _hitImage.get(), _aTrousPongImage,
+       _motionImage.get(), _lastTaaImage.get(), _octreeVisualizationImage.get()},
+      {_taaImage.get(), _renderTargetImage.get()});
+  _passProfiler->recordPassBegin(commandBuffer, frameIndex, TracingPassProfiler::kPostProcessing);
+  _fusedPostChainPipeline->recordIndirectCommand(
+      commandBuffer, frameIndex,
+      _highResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(commandBuffer, frameIndex, TracingPassProfiler::kPostProcessing);
+}
+
+void SvoTracer::_recordRenderingCommandBuffers() {
+  // the sky luts and the shadow map are dispatched with the same descriptor sets, so they're
+  // recorded along
+  _recordSkyLutCommandBuffers();
+  _recordShadowMapCommandBuffers();
+
+  for (uint32_t frameIndex = 0; frameIndex < _renderingCommandPools.size(); frameIndex++) {
+    for (auto *commandBuffers :
+         {&_chunkOccupancyCommandBuffers, &_coarseBeamCommandBuffers, &_tracingCommandBuffers}) {
+      vkFreeCommandBuffers(_appContext->getDevice(), _renderingCommandPools[frameIndex], 1,
+                           &(*commandBuffers)[frameIndex]);
     }
+  }
 
-    _backgroundBlitPipeline->recordCommand(cmdBuffer, frameIndex, _lowResWidth, _lowResHeight, 1);
+  // the frames in flight share no recording state, so each one is recorded by a single thread, into
+  // command buffers of the pool of that thread, the threads take the frames in turns
+  size_t const threadCount =
+      std::max<size_t>(1, std::min(_appContext->getRecordingThreadCount(), _framesInFlight));
+  _renderingCommandPools.resize(_framesInFlight);
+  for (size_t frameIndex = 0; frameIndex < _framesInFlight; frameIndex++) {
+    _renderingCommandPools[frameIndex] =
+        _appContext->getRecordingCommandPool(frameIndex % threadCount);
+  }
+  _chunkOccupancyCommandBuffers.resize(_framesInFlight);
+  _coarseBeamCommandBuffers.resize(_framesInFlight);
+  _tracingCommandBuffers.resize(_framesInFlight);
+
+  // the buffers of the frames recorded in drawFrame are only allocated here
+  bool const isRecordedEveryFrame = _configContainer->svoTracerInfo->recordEveryFrame;
+  std::vector<std::thread> workers{};
+  workers.reserve(threadCount);
+  for (size_t threadIndex = 0; threadIndex < threadCount; threadIndex++) {
+    workers.emplace_back([this, threadIndex, threadCount, isRecordedEveryFrame]() {
+      for (size_t frameIndex = threadIndex; frameIndex < _framesInFlight;
+           frameIndex += threadCount) {
+        _allocateFrameCommandBuffers(static_cast<uint32_t>(frameIndex));
+        if (!isRecordedEveryFrame) {
+          _recordFrameCommandBuffers(static_cast<uint32_t>(frameIndex));
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
 
-    vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+void SvoTracer::_allocateFrameCommandBuffers(uint32_t frameIndex) {
+  VkCommandBufferAllocateInfo allocInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+  allocInfo.commandPool        = _renderingCommandPools[frameIndex];
+  allocInfo.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocInfo.commandBufferCount = 1;
+  for (auto *commandBuffers :
+       {&_chunkOccupancyCommandBuffers, &_coarseBeamCommandBuffers, &_tracingCommandBuffers}) {
+    vkAllocateCommandBuffers(_appContext->getDevice(), &allocInfo, &(*commandBuffers)[frameIndex]);
+  }
+}
+
+// the occupancy, the coarse beam and the tracing command buffers of a frame in flight, they're
+// submitted in this order, and their barriers are tracked across them, recording them again resets
+// them implicitly
+void SvoTracer::_recordFrameCommandBuffers(uint32_t frameIndex) {
+  auto &occupancyCmdBuffer = _chunkOccupancyCommandBuffers[frameIndex];
+  auto &beamCmdBuffer      = _coarseBeamCommandBuffers[frameIndex];
+  auto &cmdBuffer          = _tracingCommandBuffers[frameIndex];
+
+  // the passes that return right away with the tweaking of this frame are left out when the frame
+  // is recorded right before its submission, the pre-recorded frames keep all of them, their
+  // timestamps are skipped, so that the frame time is still measured
+  auto const &td                  = *_configContainer->svoTracerTweakingInfo;
+  bool const isRecordedEveryFrame = _configContainer->svoTracerInfo->recordEveryFrame;
+  bool const isWavefrontRecorded  = !isRecordedEveryFrame || td.wavefrontTracing;
+  bool const isShadowResamplingRecorded =
+      !isRecordedEveryFrame || (td.shadowResampling && !td.wavefrontTracing);
+  if (!isWavefrontRecorded) {
+    _passProfiler->skipPasses(frameIndex, TracingPassProfiler::kWavefrontBounces,
+                              TracingPassProfiler::kShadowResampling);
+  }
+  if (!isShadowResamplingRecorded) {
+    _passProfiler->skipPasses(frameIndex, TracingPassProfiler::kShadowResampling,
+                              TracingPassProfiler::kGodRay);
+  }
+
+  VkMemoryBarrier dispatchWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  dispatchWritingBarrier.srcAccessMask = VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  dispatchWritingBarrier.dstAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+  VkCommandBufferBeginInfo beginInfo{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+
+  vkBeginCommandBuffer(occupancyCmdBuffer, &beginInfo);
+  _passProfiler->recordReset(occupancyCmdBuffer, frameIndex,
+                             TracingPassProfiler::kChunkOccupancy, TracingPassProfiler::kPassCount);
+
+  // make all host writes to the ubo and the dispatch sizes visible to the shaders, along with the
+  // copies of the staged ones
+  _recordFrameConstantCopies(occupancyCmdBuffer, frameIndex);
+  vkCmdPipelineBarrier(occupancyCmdBuffer,
+                       VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, // source stage
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+                           VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, // destination stage
+                       0,                                       // dependency flags
+                       1,                                       // memory barrier count
+                       &dispatchWritingBarrier,                 // memory barriers
+                       0,                                       // buffer memory barrier count
+                       nullptr,                                 // buffer memory barriers
+                       0,                                       // image memory barrier count
+                       nullptr                                  // image memory barriers
+  );
+
+  // the passes only wait on the ones before them that they depend on, the history images are
+  // named by their roles in this frame, the wavefront buffers are always accessed together, so
+  // the pixel buffer stands for all of them, and the occupancy for the frustum bounds, the passes
+  // that overlap share their gpu times, the tracker spans the three command buffers, since they're
+  // submitted to the same queue in order
+  PassBarrierTracker tracker{};
+  Image *const depth            = _depthImage;
+  Image *const lastDepth        = _lastDepthImage.get();
+  Image *const position         = _positionImage.get();
+  Image *const lastPosition     = _lastPositionImage.get();
+  Image *const histLength       = _temporalHistLengthImage.get();
+  Buffer *const wavefront       = _wavefrontPixelBuffer.get();
+  BufferBundle *const occupancy = _chunkOccupancyBufferBundle.get();
+
+  tracker.recordPassDependencies(occupancyCmdBuffer, {}, {occupancy});
+  _passProfiler->recordPassBegin(occupancyCmdBuffer, frameIndex,
+                                 TracingPassProfiler::kChunkOccupancy);
+  _recordChunkOccupancyCommand(occupancyCmdBuffer, frameIndex);
+  _passProfiler->recordPassEnd(occupancyCmdBuffer, frameIndex,
+                               TracingPassProfiler::kChunkOccupancy);
+
+  vkEndCommandBuffer(occupancyCmdBuffer);
+
+  vkBeginCommandBuffer(beamCmdBuffer, &beginInfo);
+
+  // from the coarsest level down, each one reads the level above it, the level and the level count
+  // are pushed with each dispatch
+  auto const beamLevelCount = static_cast<uint32_t>(_beamDispatchBufferBundles.size());
+  _transientImagePool->recordImageAcquiringBarriers(beamCmdBuffer,
+                                                    _getBeamLevelPass(beamLevelCount - 1));
+  for (uint32_t level = beamLevelCount; level-- > 0;) {
+    std::vector<PassBarrierTracker::Resource> beamReads = {occupancy};
+    if (level + 1 < beamLevelCount) {
+      beamReads.emplace_back(_beamDepthImage);
+    }
+    tracker.recordPassDependencies(beamCmdBuffer, beamReads, {_beamDepthImage});
+    std::array<uint32_t, 2> const beamPushConstants = {level, beamLevelCount};
+    _passProfiler->recordPassBegin(beamCmdBuffer, frameIndex, _getBeamLevelPass(level));
+    _svoCourseBeamPipeline->recordIndirectCommand(
+        beamCmdBuffer, frameIndex,
+        _beamDispatchBufferBundles[level]->getBuffer(frameIndex)->getVkBuffer(),
+        beamPushConstants.data());
+    _passProfiler->recordPassEnd(beamCmdBuffer, frameIndex, _getBeamLevelPass(level));
+  }
+
+  if (_configContainer->svoTracerInfo->depthReprojection) {
+    _recordDepthReprojectionCommand(beamCmdBuffer, frameIndex, tracker);
+  }
+
+  vkEndCommandBuffer(beamCmdBuffer);
 
-    _taaUpscalingPipeline->recordCommand(cmdBuffer, frameIndex, _highResWidth, _highResHeight, 1);
+  vkBeginCommandBuffer(cmdBuffer, &beginInfo);
 
+  // its barriers don't make the shader writes visible to the shaders
+  if (isWavefrontRecorded) {
+    _recordWavefrontQueueResetCommand(cmdBuffer);
+  }
+  // it's cheap enough to be reset whether the statistics are on or not, so the command buffers
+  // aren't recorded again when they're toggled
+  _recordTraversalHistogramResetCommand(cmdBuffer, frameIndex);
+
+  // a single ray under the crosshair, it's left out of the profile since it's negligible next to
+  // the tracing pass
+  tracker.recordPassDependencies(cmdBuffer, {occupancy},
+                                 {_outputInfoBufferBundle->getBuffer(frameIndex)});
+  _brushPickingPipeline->recordCommand(cmdBuffer, frameIndex, 1, 1, 1);
+
+  tracker.recordPassDependencies(
+      cmdBuffer,
+      {occupancy, _beamDepthImage, _reprojectedDepthImage, _lastNormalImage.get(),
+       _lastVoxHashImage.get(), _lastShadowReservoirBuffer.get(), _shadowMapImage.get(),
+       _radianceCacheBuffer.get(), _samplingTileBuffer.get()},
+      {_backgroundImage.get(), _rawImage.get(), _instantImage.get(), depth,
+       _octreeVisualizationImage.get(), _hitImage.get(), _motionImage.get(),
+       _normalImage.get(), position, _voxHashImage.get(), _voxelDepthImage.get(), wavefront,
+       _shadowReservoirBuffer.get(), _radianceCacheBuffer.get()});
+  _transientImagePool->recordImageAcquiringBarriers(cmdBuffer, TracingPassProfiler::kTracing);
+  _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kTracing);
+  _svoTracingPipeline->recordIndirectCommand(
+      cmdBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kTracing);
+
+  // the kernels of the bounces are ordered by barriers of their own
+  if (isWavefrontRecorded) {
+    tracker.recordPassDependencies(cmdBuffer, {occupancy, wavefront, _rawImage.get()},
+                                   {wavefront, _rawImage.get()});
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kWavefrontBounces);
+    _recordWavefrontBouncesCommand(cmdBuffer, frameIndex);
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kWavefrontBounces);
+  }
+
+  // the rays are all marched by now, the host reads their statistics once the frame is done
+  VkBufferMemoryBarrier const traversalHistogramBarrier =
+      _traversalHistogramBufferBundle->getBuffer(frameIndex)->getMemoryBarrier(
+          VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &traversalHistogramBarrier, 0,
+                       nullptr);
+
+  if (isShadowResamplingRecorded) {
+    tracker.recordPassDependencies(
+        cmdBuffer, {_normalImage.get(), depth, _shadowReservoirBuffer.get(), _rawImage.get()},
+        {_rawImage.get(), _lastShadowReservoirBuffer.get()});
+    _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kShadowResampling);
+    _shadowResamplingPipeline->recordIndirectCommand(
+        cmdBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+    _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kShadowResampling);
+  }
+
+  // overlaps with the shadow resampling, the upsampling is timed along with it
+  tracker.recordPassDependencies(cmdBuffer, {depth, _lastGodRayAccumedImage.get()},
+                                 {_godRayAccumedImage.get()});
+  _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kGodRay);
+  _godRayPipeline->recordIndirectCommand(
+      cmdBuffer, frameIndex, _godRayDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  tracker.recordPassDependencies(cmdBuffer, {depth, _godRayAccumedImage.get(), _instantImage.get()},
+                                 {_instantImage.get()});
+  _godRayUpsamplePipeline->recordIndirectCommand(
+      cmdBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kGodRay);
+
+  bool const isATrousAdaptive = _configContainer->svoTracerInfo->aTrousAdaptive;
+  if (isATrousAdaptive) {
+    _recordATrousTileListResetCommand(cmdBuffer);
+  }
+
+  tracker.recordPassDependencies(
+      cmdBuffer,
+      {_rawImage.get(), depth, lastDepth, _hitImage.get(), histLength, _motionImage.get(),
+       _normalImage.get(), _lastNormalImage.get(), position, lastPosition,
+       _lastAccumedImage.get(), _lastTemporalMomentsImage.get(), _samplingTileBuffer.get()},
+      {histLength, _accumedImage.get(), _aTrousPingImage, _aTrousPongImage,
+       _temporalMomentsImage.get(), _samplingTileBuffer.get()});
+  _transientImagePool->recordImageAcquiringBarriers(cmdBuffer,
+                                                    TracingPassProfiler::kTemporalFilter);
+  _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kTemporalFilter);
+  _temporalFilterPipeline->recordIndirectCommand(
+      cmdBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+  _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kTemporalFilter);
+
+  // the tile lists are read as the dispatches of the iterations as well
+  if (isATrousAdaptive) {
+    VkMemoryBarrier listWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+    listWritingBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    listWritingBarrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
     vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
-                         nullptr);
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                         0, 1, &listWritingBarrier, 0, nullptr, 0, nullptr);
+  }
+
+  std::vector<PassBarrierTracker::Resource> const aTrousReads = {
+      depth,     _hitImage.get(),     _normalImage.get(), position,        lastPosition,
+      lastDepth, _voxHashImage.get(), histLength,         _aTrousPingImage, _aTrousPongImage};
+
+  _transientImagePool->recordImageAcquiringBarriers(cmdBuffer, TracingPassProfiler::kATrous);
+  _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kATrous);
+  // the fused iterations don't read the iteration index
+  uint32_t firstIteration = 0;
+  if (_configContainer->svoTracerInfo->aTrousFused) {
+    tracker.recordPassDependencies(cmdBuffer, aTrousReads, {_aTrousPongImage});
+    _aTrousFusedPipeline->recordIndirectCommand(
+        cmdBuffer, frameIndex, _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer());
+    firstIteration = kATrousFusedIterationCount;
+  }
+  // the iteration index is pushed with each dispatch, the adaptive iterations are dispatched over
+  // their tile lists
+  uint32_t const iterationEnd =
+      isATrousAdaptive
+          ? std::min(_configContainer->svoTracerInfo->aTrousSizeMax, kATrousMaxIterationCount)
+          : _configContainer->svoTracerInfo->aTrousSizeMax;
+  for (uint32_t i = firstIteration; i < iterationEnd; i++) {
+    tracker.recordPassDependencies(cmdBuffer, aTrousReads, {_aTrousPingImage, _aTrousPongImage});
+    VkBuffer const dispatchBuffer =
+        isATrousAdaptive ? _aTrousTileListBuffers[i]->getVkBuffer()
+                         : _lowResDispatchBufferBundle->getBuffer(frameIndex)->getVkBuffer();
+    _aTrousPipeline->recordIndirectCommand(cmdBuffer, frameIndex, dispatchBuffer, &i);
+  }
+  _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kATrous);
 
-    _postProcessingPipeline->recordCommand(cmdBuffer, frameIndex, _highResWidth, _highResHeight, 1);
+  if (_isPostChainFused) {
+    _recordFusedPostChainCommand(cmdBuffer, frameIndex, tracker);
+  } else {
+    _recordPostChainCommands(cmdBuffer, frameIndex, tracker);
+  }
 
-    // copy to history images
+  // the ping ponged history only has to be visible to the next frame, which also keeps it from
+  // writing the images this frame still reads
+  _passProfiler->recordPassBegin(cmdBuffer, frameIndex, TracingPassProfiler::kHistoryCopy);
+  if (_isHistoryPingPonged) {
+    tracker.recordBarrier(cmdBuffer);
+  } else {
     _normalForwardingPair->forwardCopy(cmdBuffer);
-    _positionForwardingPair->forwardCopy(cmdBuffer);
+    if (_configContainer->svoTracerInfo->positionFromDepth) {
+      _depthForwardingPair->forwardCopy(cmdBuffer);
+    } else {
+      _positionForwardingPair->forwardCopy(cmdBuffer);
+    }
     _voxHashForwardingPair->forwardCopy(cmdBuffer);
     _accumedForwardingPair->forwardCopy(cmdBuffer);
+    if (_temporalMomentsForwardingPair != nullptr) {
+      _temporalMomentsForwardingPair->forwardCopy(cmdBuffer);
+    }
     _godRayAccumedForwardingPair->forwardCopy(cmdBuffer);
     _taaForwardingPair->forwardCopy(cmdBuffer);
+  }
+  _passProfiler->recordPassEnd(cmdBuffer, frameIndex, TracingPassProfiler::kHistoryCopy);
 
-    vkEndCommandBuffer(cmdBuffer);
+  _recordFrameDumpCommand(cmdBuffer, frameIndex);
+
+  // the output info is read by the host once the frame is done
+  VkMemoryBarrier outputInfoReadingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  outputInfoReadingBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  outputInfoReadingBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+  vkCmdPipelineBarrier(cmdBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &outputInfoReadingBarrier, 0, nullptr,
+                       0, nullptr);
+
+  vkEndCommandBuffer(cmdBuffer);
+}
+
+// the render target stays in the general layout, the delivery copies it to the swapchain image
+// afterwards
+void SvoTracer::_recordFrameDumpCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+  if (frameIndex >= _frameDumpBuffers.size()) {
+    return;
   }
+  auto &frameDumpBuffer = _frameDumpBuffers[frameIndex];
+
+  VkMemoryBarrier renderTargetWritingBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  renderTargetWritingBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  renderTargetWritingBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &renderTargetWritingBarrier, 0,
+                       nullptr, 0, nullptr);
+
+  VkBufferImageCopy region{};
+  region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+  region.imageSubresource.layerCount = 1;
+  region.imageExtent                 = {_highResWidth, _highResHeight, 1};
+  vkCmdCopyImageToBuffer(commandBuffer, _renderTargetImage->getVkImage(), VK_IMAGE_LAYOUT_GENERAL,
+                         frameDumpBuffer->getVkBuffer(), 1, &region);
+
+  VkBufferMemoryBarrier const dumpBarrier =
+      frameDumpBuffer->getMemoryBarrier(VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT);
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                       0, 0, nullptr, 1, &dumpBarrier, 0, nullptr);
 }
 
 void SvoTracer::_recordDeliveryCommandBuffers() {
@@ -646,14 +1913,204 @@ void SvoTracer::_recordDeliveryCommandBuffers() {
 }
 
 void SvoTracer::drawFrame(size_t currentFrame) {
-  _updateShadowMapCamera();
+  auto const frameIndex          = static_cast<uint32_t>(currentFrame);
+  bool const isFrameTimeMeasured = _passProfiler->collect(frameIndex);
+  _collectTraversalStatistics(currentFrame);
+  _updateRenderSize(isFrameTimeMeasured);
+  // the swapped chunks are taken every frame, so that an old edit never counts later on
+  auto swappedChunks = _svoBuilder->takeSwappedChunks();
+  _updateDynamicObjectGrid(currentFrame, swappedChunks);
+  _updateShadowMapCamera(swappedChunks);
+  _updateDepthReprojection(swappedChunks);
+  _updateStaticFrameCount(swappedChunks);
+  _updateChunkAccelerationStructure(currentFrame, swappedChunks);
   _updateUboData(currentFrame);
+  _updateDispatchSizes(currentFrame);
+
+  // the last submission of this slot is done, so its command buffers can be recorded again
+  if (_configContainer->svoTracerInfo->recordEveryFrame) {
+    auto const recordingBeginTime = std::chrono::steady_clock::now();
+    _recordFrameCommandBuffers(frameIndex);
+    _latestRecordingTimeMs = std::chrono::duration<float, std::milli>(
+                                 std::chrono::steady_clock::now() - recordingBeginTime)
+                                 .count();
+  }
+
+  // this frame is still traced with the last variant, and post processed with the last chain
+  if (_getTracingSpecializationConstants() != _tracingSpecializationConstants ||
+      _configContainer->svoTracerTweakingInfo->fusedPostChain != _isPostChainFused) {
+    GlobalEventDispatcher::get().trigger<E_RenderLoopBlockRequest>(
+        E_RenderLoopBlockRequest{BlockState::kPipelineVariantsChanged});
+  }
+
+  // the command buffers that aren't submitted with this frame leave their queries untouched
+  if (!_isSkyLutOutdated) {
+    _passProfiler->skipPasses(frameIndex, TracingPassProfiler::kTransmittanceLut,
+                              TracingPassProfiler::kShadowMap);
+  }
+  if (!_isShadowMapOutdated) {
+    _passProfiler->skipPasses(frameIndex, TracingPassProfiler::kShadowMap,
+                              TracingPassProfiler::kChunkOccupancy);
+  }
+  if (!_configContainer->svoTracerInfo->depthReprojection) {
+    _passProfiler->skipPasses(frameIndex, TracingPassProfiler::kDepthReprojection,
+                              TracingPassProfiler::kTracing);
+  }
+  // the fused post chain is timed as the post processing
+  if (_isPostChainFused) {
+    _passProfiler->skipPasses(frameIndex, TracingPassProfiler::kBackgroundBlit,
+                              TracingPassProfiler::kPostProcessing);
+  }
+  // the levels of the beams beyond the configured count are never recorded
+  _passProfiler->skipPasses(
+      frameIndex, TracingPassProfiler::kCoarseBeamLevel3,
+      _getBeamLevelPass(static_cast<uint32_t>(_beamDispatchBufferBundles.size()) - 1));
 }
 
-void SvoTracer::_updateShadowMapCamera() {
+void SvoTracer::_updateRenderSize(bool isFrameTimeMeasured) {
+  _renderSizePrev = _renderSize;
+
+  auto const &svoTracerInfo = *_configContainer->svoTracerInfo;
+  if (svoTracerInfo.dynamicResolution && isFrameTimeMeasured) {
+    // the pixel count goes with the square of the scale, so the correction is a square root, it's
+    // damped, so that a single slow frame doesn't drop the resolution, and slightly off frames are
+    // ignored, so that the scale doesn't flicker around the target
+    float constexpr kRenderScaleDamping = 0.1F;
+    float constexpr kFrameTimeTolerance = 0.05F;
+    float const frameTimeMs             = _passProfiler->getLatestFrameTimeMs();
+    float const targetFrameTimeMs       = svoTracerInfo.targetFrameTimeMs;
+    if (frameTimeMs > 0.F &&
+        std::abs(frameTimeMs - targetFrameTimeMs) > kFrameTimeTolerance * targetFrameTimeMs) {
+      float const correction = std::sqrt(targetFrameTimeMs / frameTimeMs);
+      _renderScale = glm::clamp(_renderScale * glm::mix(1.F, correction, kRenderScaleDamping),
+                                svoTracerInfo.minRenderScale, 1.F);
+    }
+  }
+
+  _renderSize = glm::max(
+      glm::uvec2(glm::round(glm::vec2(_lowResWidth, _lowResHeight) * _renderScale)), 1U);
+}
+
+void SvoTracer::_updateShadowMapCamera(std::vector<glm::ivec3> const &swappedChunks) {
   glm::vec3 sunDir = _getSunDir(_configContainer->svoTracerTweakingInfo->sunAltitude,
                                 _configContainer->svoTracerTweakingInfo->sunAzimuth);
+  glm::vec3 const lastPosition = _shadowMapCamera->getPosition();
+  glm::vec3 const lastFront    = _shadowMapCamera->getFront();
   _shadowMapCamera->updateCameraVectors(_camera->getPosition(), sunDir);
+
+  glm::ivec3 const chunkWindowOrigin = _svoBuilder->getChunkWindowOrigin();
+  _isShadowMapOutdated = !_isShadowMapRendered || _shadowMapCamera->getPosition() != lastPosition ||
+                         _shadowMapCamera->getFront() != lastFront ||
+                         chunkWindowOrigin != _shadowMapChunkWindowOrigin ||
+                         _isAnyChunkInShadowMap(swappedChunks);
+  _isShadowMapRendered        = true;
+  _shadowMapChunkWindowOrigin = chunkWindowOrigin;
+}
+
+// the voxels of a swapped chunk may have moved, and the positions of the last frame are off by the
+// move of the chunk window, the voxel depths written by this frame hold for the next one again
+void SvoTracer::_updateDepthReprojection(std::vector<glm::ivec3> const &swappedChunks) {
+  glm::ivec3 const chunkWindowOrigin = _svoBuilder->getChunkWindowOrigin();
+  _isLastVoxelDepthReprojected = _isVoxelDepthWritten && swappedChunks.empty() &&
+                                 chunkWindowOrigin == _voxelDepthChunkWindowOrigin;
+  _isVoxelDepthWritten         = _configContainer->svoTracerInfo->depthReprojection;
+  _voxelDepthChunkWindowOrigin = chunkWindowOrigin;
+}
+
+// the converged tiles are only skipped while nothing that the pixels see changes, the sub-pixel
+// jitter of the taa still moves every frame, so the skipped tiles are resolved as they converged
+void SvoTracer::_updateStaticFrameCount(std::vector<glm::ivec3> const &swappedChunks) {
+  glm::vec3 const camPosition        = _camera->getPosition();
+  glm::vec3 const camFront           = _camera->getFront();
+  float const camVFov                = _camera->getVFov();
+  glm::ivec3 const chunkWindowOrigin = _svoBuilder->getChunkWindowOrigin();
+  bool const isStill = !_isStillnessBroken && swappedChunks.empty() &&
+                       camPosition == _stillCamPosition && camFront == _stillCamFront &&
+                       camVFov == _stillCamVFov && chunkWindowOrigin == _stillChunkWindowOrigin &&
+                       _renderSize == _renderSizePrev;
+  _staticFrameCount       = isStill ? _staticFrameCount + 1 : 0;
+  _stillCamPosition       = camPosition;
+  _stillCamFront          = camFront;
+  _stillCamVFov           = camVFov;
+  _stillChunkWindowOrigin = chunkWindowOrigin;
+  _isStillnessBroken      = false;
+}
+
+// a moved object invalidates the same caches as a swapped chunk, in both the chunks it left and the
+// ones it entered, the grid is rewritten on the host as a whole, it's tiny next to the octrees
+void SvoTracer::_updateDynamicObjectGrid(size_t currentFrame,
+                                         std::vector<glm::ivec3> &swappedChunks) {
+  auto const changedChunks =
+      _svoBuilder->getDynamicObjects()->updateGrid(_svoBuilder->getChunkWindowOrigin());
+  if (!changedChunks.empty()) {
+    _dynamicObjectGridVersion++;
+    swappedChunks.insert(swappedChunks.end(), changedChunks.begin(), changedChunks.end());
+  }
+  if (_dynamicObjectGridFrameVersions[currentFrame] == _dynamicObjectGridVersion) {
+    return;
+  }
+  _dynamicObjectGridFrameVersions[currentFrame] = _dynamicObjectGridVersion;
+  _dynamicObjectGridBufferBundle->getBuffer(currentFrame)
+      ->fillData(_svoBuilder->getDynamicObjects()->getGrid().data());
+}
+
+void SvoTracer::_updateChunkAccelerationStructure(size_t currentFrame,
+                                                  std::vector<glm::ivec3> const &swappedChunks) {
+  if (_chunkAccelerationStructure == nullptr ||
+      !_configContainer->svoTracerTweakingInfo->useRayQuery) {
+    _isChunkAccelerationStructureBuilt    = false;
+    _isChunkAccelerationStructureOutdated = false;
+    return;
+  }
+
+  // a swap can turn a chunk empty, or fill one, the swaps that kept a chunk non-empty aren't told
+  // apart, they are rare compared to the frames
+  glm::ivec3 const chunkWindowOrigin = _svoBuilder->getChunkWindowOrigin();
+  _isChunkAccelerationStructureOutdated =
+      !_isChunkAccelerationStructureBuilt || !swappedChunks.empty() ||
+      chunkWindowOrigin != _accelerationStructureChunkWindowOrigin;
+  _isChunkAccelerationStructureBuilt      = true;
+  _accelerationStructureChunkWindowOrigin = chunkWindowOrigin;
+  if (_isChunkAccelerationStructureOutdated) {
+    // the chunks that only hold dynamic objects get boxes too, the others aren't listed twice
+    auto nonEmptyChunks = _svoBuilder->getNonEmptyChunks();
+    for (auto const &chunkIndex : _svoBuilder->getDynamicObjects()->getGridChunks()) {
+      if (std::find(nonEmptyChunks.begin(), nonEmptyChunks.end(), chunkIndex) ==
+          nonEmptyChunks.end()) {
+        nonEmptyChunks.push_back(chunkIndex);
+      }
+    }
+    _chunkAccelerationStructure->updateInstances(currentFrame, nonEmptyChunks);
+  }
+}
+
+bool SvoTracer::_isAnyChunkInShadowMap(std::vector<glm::ivec3> const &chunkIndices) const {
+  // the bounds of each chunk are tested against the orthographic box in view space, the camera
+  // looks down -z, and the rays march past the far plane, so only the near side bounds the depth
+  glm::mat4 const vMat = _shadowMapCamera->getViewMatrix();
+  float const range    = _configContainer->shadowMapCameraInfo->range;
+  for (auto const &chunkIndex : chunkIndices) {
+    glm::vec3 boxMin(std::numeric_limits<float>::max());
+    glm::vec3 boxMax(std::numeric_limits<float>::lowest());
+    for (uint32_t corner = 0; corner < 8; corner++) {
+      glm::vec3 const cornerOffset(corner & 1U, (corner >> 1U) & 1U, (corner >> 2U) & 1U);
+      glm::vec3 const viewPos(vMat * glm::vec4(glm::vec3(chunkIndex) + cornerOffset, 1.F));
+      boxMin = glm::min(boxMin, viewPos);
+      boxMax = glm::max(boxMax, viewPos);
+    }
+    if (boxMax.x >= -range && boxMin.x <= range && boxMax.y >= -range && boxMin.y <= range &&
+        boxMin.z <= 0.F) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void SvoTracer::_onTweakingInfoChanged(E_TweakingInfoChanged const &event) {
+  for (auto &groupBits : _outdatedTweakingGroupBits) {
+    groupBits |= event.tweakingGroupBits;
+  }
+  _isStillnessBroken = true;
 }
 
 void SvoTracer::_updateUboData(size_t currentFrame) {
@@ -665,6 +2122,7 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
   static glm::mat4 pMatPrevInv{1.0F};
   static glm::mat4 vpMatPrev{1.0F};
   static glm::mat4 vpMatPrevInv{1.0F};
+  static glm::vec2 subpixOffsetPrev{0.0F};
 
   auto currentTime = static_cast<float>(glfwGetTime());
 
@@ -681,10 +2139,14 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
       _shadowMapCamera->getProjectionMatrix() * _shadowMapCamera->getViewMatrix();
   auto vpMatShadowMapCamInv = glm::inverse(vpMatShadowMapCam);
 
+  glm::vec2 const subpixOffset =
+      _subpixOffsets[currentSample % _configContainer->svoTracerInfo->taaSamplingOffsetSize];
+
   G_RenderInfo renderInfo = {
       _camera->getPosition(),
       _shadowMapCamera->getPosition(),
-      _subpixOffsets[currentSample % _configContainer->svoTracerInfo->taaSamplingOffsetSize],
+      subpixOffset,
+      subpixOffsetPrev,
       vMat,
       vMatInv,
       vMatPrev,
@@ -699,13 +2161,17 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
       vpMatPrevInv,
       vpMatShadowMapCam,
       vpMatShadowMapCamInv,
-      glm::uvec2(_lowResWidth, _lowResHeight),
-      glm::vec2(1.F / static_cast<float>(_lowResWidth), 1.F / static_cast<float>(_lowResHeight)),
+      _renderSize,
+      1.F / glm::vec2(_renderSize),
+      _renderSizePrev,
       glm::uvec2(_highResWidth, _highResHeight),
       glm::vec2(1.F / static_cast<float>(_highResWidth), 1.F / static_cast<float>(_highResHeight)),
       _camera->getVFov(),
       currentSample,
       currentTime,
+      _svoBuilder->getChunkWindowOrigin(),
+      static_cast<uint32_t>(_isLastVoxelDepthReprojected),
+      _staticFrameCount,
   };
   _renderInfoBufferBundle->getBuffer(currentFrame)->fillData(&renderInfo);
 
@@ -716,54 +2182,147 @@ void SvoTracer::_updateUboData(size_t currentFrame) {
   vpMatPrev    = vpMat;
   vpMatPrevInv = vpMatInv;
 
+  subpixOffsetPrev = subpixOffset;
+
+  currentSample++;
+
+  // the rest only changes with the edits of the gui
+  uint32_t const outdatedGroupBits         = _outdatedTweakingGroupBits[currentFrame];
+  _outdatedTweakingGroupBits[currentFrame] = 0;
+
   SvoTracerTweakingInfo const &td = *_configContainer->svoTracerTweakingInfo;
   glm::vec3 sunDir                = _getSunDir(td.sunAltitude, td.sunAzimuth);
-  G_EnvironmentInfo environmentInfo{};
-  environmentInfo.sunDir                 = sunDir;
-  environmentInfo.rayleighScatteringBase = td.rayleighScatteringBase;
-  environmentInfo.mieScatteringBase      = td.mieScatteringBase;
-  environmentInfo.mieAbsorptionBase      = td.mieAbsorptionBase;
-  environmentInfo.ozoneAbsorptionBase    = td.ozoneAbsorptionBase;
-  environmentInfo.sunLuminance           = td.sunLuminance;
-  environmentInfo.atmosLuminance         = td.atmosLuminance;
-  environmentInfo.sunSize                = td.sunSize;
-  _environmentInfoBufferBundle->getBuffer(currentFrame)->fillData(&environmentInfo);
+  if ((outdatedGroupBits & kEnvironmentGroup) != 0) {
+    G_EnvironmentInfo environmentInfo{};
+    environmentInfo.sunDir                 = sunDir;
+    environmentInfo.rayleighScatteringBase = td.rayleighScatteringBase;
+    environmentInfo.mieScatteringBase      = td.mieScatteringBase;
+    environmentInfo.mieAbsorptionBase      = td.mieAbsorptionBase;
+    environmentInfo.ozoneAbsorptionBase    = td.ozoneAbsorptionBase;
+    environmentInfo.sunLuminance           = td.sunLuminance;
+    environmentInfo.atmosLuminance         = td.atmosLuminance;
+    environmentInfo.sunSize                = td.sunSize;
+    _environmentInfoBufferBundle->getBuffer(currentFrame)->fillData(&environmentInfo);
+  }
+
+  // the lut inputs are spread over the environment and the debug parameters
+  _isSkyLutOutdated = !_isSkyLutComputed;
+  if ((outdatedGroupBits & (kEnvironmentGroup | kTracingGroup)) != 0) {
+    SkyLutInputs const skyLutInputs{sunDir,
+                                    td.rayleighScatteringBase,
+                                    td.mieScatteringBase,
+                                    td.mieAbsorptionBase,
+                                    td.ozoneAbsorptionBase,
+                                    td.debugC1,
+                                    td.debugF1};
+    _isSkyLutOutdated = _isSkyLutOutdated || !(skyLutInputs == _skyLutInputs);
+    _skyLutInputs     = skyLutInputs;
+  }
+  _isSkyLutComputed = true;
+
+  if ((outdatedGroupBits & kTracingGroup) != 0) {
+    _updateTweakableParameters(currentFrame);
+  }
+  if ((outdatedGroupBits & kTemporalFilterGroup) != 0) {
+    G_TemporalFilterInfo temporalFilterInfo{};
+    temporalFilterInfo.temporalAlpha           = td.temporalAlpha;
+    temporalFilterInfo.temporalPositionPhi     = td.temporalPositionPhi;
+    temporalFilterInfo.convergedSampleCount    = td.convergedSampleCount;
+    temporalFilterInfo.convergedNoiseTolerance = td.convergedNoiseTolerance;
+    _temporalFilterInfoBufferBundle->getBuffer(currentFrame)->fillData(&temporalFilterInfo);
+  }
+  if ((outdatedGroupBits & kSpatialFilterGroup) != 0) {
+    G_SpatialFilterInfo spatialFilterInfo{};
+    spatialFilterInfo.aTrousIterationCount  = static_cast<uint32_t>(td.aTrousIterationCount);
+    spatialFilterInfo.phiC                  = td.phiC;
+    spatialFilterInfo.phiN                  = td.phiN;
+    spatialFilterInfo.phiP                  = td.phiP;
+    spatialFilterInfo.minPhiZ               = td.minPhiZ;
+    spatialFilterInfo.maxPhiZ               = td.maxPhiZ;
+    spatialFilterInfo.phiZStableSampleCount = td.phiZStableSampleCount;
+    spatialFilterInfo.changingLuminancePhi  = td.changingLuminancePhi;
+    spatialFilterInfo.aTrousNoiseTolerance  = td.aTrousNoiseTolerance;
+    _spatialFilterInfoBufferBundle->getBuffer(currentFrame)->fillData(&spatialFilterInfo);
+  }
+}
+
+void SvoTracer::_updateTweakableParameters(size_t currentFrame) {
+  SvoTracerTweakingInfo const &td = *_configContainer->svoTracerTweakingInfo;
+  bool const isRayQueryUsed       = td.useRayQuery && _chunkAccelerationStructure != nullptr;
+  bool const isShadowResampled    = td.shadowResampling && !td.wavefrontTracing;
 
   G_TweakableParameters tweakableParameters{};
-  tweakableParameters.debugB1          = td.debugB1;
-  tweakableParameters.debugF1          = td.debugF1;
-  tweakableParameters.debugI1          = td.debugI1;
-  tweakableParameters.debugC1          = td.debugC1;
-  tweakableParameters.explosure        = td.explosure;
-  tweakableParameters.visualizeChunks  = td.visualizeChunks;
-  tweakableParameters.visualizeOctree  = td.visualizeOctree;
-  tweakableParameters.beamOptimization = td.beamOptimization;
-  tweakableParameters.traceIndirectRay = td.traceIndirectRay;
-  tweakableParameters.taa              = td.taa;
+  tweakableParameters.debugB1                      = td.debugB1;
+  tweakableParameters.debugF1                      = td.debugF1;
+  tweakableParameters.debugI1                      = td.debugI1;
+  tweakableParameters.debugC1                      = td.debugC1;
+  tweakableParameters.explosure                    = td.explosure;
+  tweakableParameters.visualizeChunks              = td.visualizeChunks;
+  tweakableParameters.visualizeOctree              = td.visualizeOctree;
+  tweakableParameters.beamOptimization             = td.beamOptimization;
+  tweakableParameters.traceIndirectRay             = td.traceIndirectRay;
+  tweakableParameters.taa                          = td.taa;
+  tweakableParameters.useRayQuery                  = isRayQueryUsed;
+  tweakableParameters.wavefrontTracing             = td.wavefrontTracing;
+  tweakableParameters.wavefrontRayBinning          = td.wavefrontRayBinning;
+  tweakableParameters.shadowResampling             = isShadowResampled;
+  tweakableParameters.shadowResamplingCheckerboard = td.shadowResamplingCheckerboard;
+  tweakableParameters.shadowMapVisibility          = td.shadowMapVisibility;
+  tweakableParameters.radianceCache                = td.radianceCache;
+  tweakableParameters.traversalStatistics          = td.traversalStatistics;
+  tweakableParameters.indirectSkySh                = td.indirectSkySh;
   _tweakableParametersBufferBundle->getBuffer(currentFrame)->fillData(&tweakableParameters);
+}
+
+void SvoTracer::_updateDispatchSizes(size_t currentFrame) {
+  auto const beamResolution = _configContainer->svoTracerInfo->beamResolution;
+  for (uint32_t level = 0; level < _beamDispatchBufferBundles.size(); level++) {
+    VkDispatchIndirectCommand beamDispatch =
+        _makeDispatchCommand(_getBeamCount(_renderSize, beamResolution << level));
+    _beamDispatchBufferBundles[level]->getBuffer(currentFrame)->fillData(&beamDispatch);
+  }
 
-  G_TemporalFilterInfo temporalFilterInfo{};
-  temporalFilterInfo.temporalAlpha       = td.temporalAlpha;
-  temporalFilterInfo.temporalPositionPhi = td.temporalPositionPhi;
-  _temporalFilterInfoBufferBundle->getBuffer(currentFrame)->fillData(&temporalFilterInfo);
-
-  G_SpatialFilterInfo spatialFilterInfo{};
-  spatialFilterInfo.aTrousIterationCount  = static_cast<uint32_t>(td.aTrousIterationCount);
-  spatialFilterInfo.phiC                  = td.phiC;
-  spatialFilterInfo.phiN                  = td.phiN;
-  spatialFilterInfo.phiP                  = td.phiP;
-  spatialFilterInfo.minPhiZ               = td.minPhiZ;
-  spatialFilterInfo.maxPhiZ               = td.maxPhiZ;
-  spatialFilterInfo.phiZStableSampleCount = td.phiZStableSampleCount;
-  spatialFilterInfo.changingLuminancePhi  = td.changingLuminancePhi;
-  _spatialFilterInfoBufferBundle->getBuffer(currentFrame)->fillData(&spatialFilterInfo);
+  VkDispatchIndirectCommand lowResDispatch = _makeDispatchCommand(_renderSize);
+  VkDispatchIndirectCommand highResDispatch =
+      _makeDispatchCommand(glm::uvec2(_highResWidth, _highResHeight));
+  VkDispatchIndirectCommand godRayDispatch = _makeDispatchCommand(
+      _getGodRaySize(_renderSize, _configContainer->svoTracerInfo->godRayDownscale));
+  _lowResDispatchBufferBundle->getBuffer(currentFrame)->fillData(&lowResDispatch);
+  _highResDispatchBufferBundle->getBuffer(currentFrame)->fillData(&highResDispatch);
+  _godRayDispatchBufferBundle->getBuffer(currentFrame)->fillData(&godRayDispatch);
+}
 
-  currentSample++;
+void SvoTracer::_collectTraversalStatistics(size_t currentFrame) {
+  if (!_configContainer->svoTracerTweakingInfo->traversalStatistics) {
+    if (_traversalStatsSink->hasRecord()) {
+      _traversalStatsSink->clear();
+    }
+    return;
+  }
+
+  // the frames traced before the statistics were turned on are recorded without rays
+  G_TraversalHistogram histogram{};
+  _traversalHistogramBufferBundle->getBuffer(currentFrame)->fetchData(&histogram);
+  std::vector<TraversalStatsSink::RayTypeStats> rayTypeStats(kTraversalRayTypeCount);
+  for (uint32_t rayType = 0; rayType < kTraversalRayTypeCount; rayType++) {
+    auto &stats             = rayTypeStats[rayType];
+    stats.rayCount          = histogram.rayCount[rayType];
+    stats.iterSum           = histogram.iterSum[rayType];
+    stats.chunkTraversedSum = histogram.chunkTraversedSum[rayType];
+
+    uint32_t const *iterBuckets  = &histogram.iterBuckets[rayType * kTraversalIterBucketCount];
+    uint32_t const *chunkBuckets = &histogram.chunkBuckets[rayType * kTraversalChunkBucketCount];
+    stats.iterBuckets.assign(iterBuckets, iterBuckets + kTraversalIterBucketCount);
+    stats.chunkBuckets.assign(chunkBuckets, chunkBuckets + kTraversalChunkBucketCount);
+  }
+  _traversalStatsSink->addRecord(std::move(rayTypeStats));
 }
 
-G_OutputInfo SvoTracer::getOutputInfo() {
+// the slot of the current frame was last written by the frame that is framesInFlight frames older,
+// which the host has waited on before recording this one, so the read never races with the gpu
+G_OutputInfo SvoTracer::getOutputInfo(size_t currentFrame) {
   G_OutputInfo outputInfo{};
-  _outputInfoBuffer->fetchData(&outputInfo);
+  _outputInfoBufferBundle->getBuffer(currentFrame)->fetchData(&outputInfo);
   return outputInfo;
 }
 
@@ -783,36 +2342,79 @@ void SvoTracer::_createDescriptorSetBundle() {
   _descriptorSetBundle->bindStorageImage(8, _weightedCosineBlueNoise.get());
 
   _descriptorSetBundle->bindStorageImage(10, _backgroundImage.get());
-  _descriptorSetBundle->bindStorageImage(11, _beamDepthImage.get());
+  _descriptorSetBundle->bindStorageImage(11, _beamDepthImage);
   _descriptorSetBundle->bindStorageImage(12, _rawImage.get());
   _descriptorSetBundle->bindStorageImage(13, _instantImage.get());
-  _descriptorSetBundle->bindStorageImage(14, _depthImage.get());
+  if (_configContainer->svoTracerInfo->positionFromDepth) {
+    _descriptorSetBundle->bindStorageImageBundle(
+        14, _getHistoryImageBundle(_historyDepthImage.get(), _lastDepthImage.get(), false));
+  } else {
+    _descriptorSetBundle->bindStorageImage(14, _depthImage);
+  }
   _descriptorSetBundle->bindStorageImage(15, _octreeVisualizationImage.get());
   _descriptorSetBundle->bindStorageImage(16, _hitImage.get());
   _descriptorSetBundle->bindStorageImage(17, _temporalHistLengthImage.get());
   _descriptorSetBundle->bindStorageImage(18, _motionImage.get());
-  _descriptorSetBundle->bindStorageImage(19, _normalImage.get());
-  _descriptorSetBundle->bindStorageImage(20, _lastNormalImage.get());
-  _descriptorSetBundle->bindStorageImage(21, _positionImage.get());
-  _descriptorSetBundle->bindStorageImage(22, _lastPositionImage.get());
-  _descriptorSetBundle->bindStorageImage(23, _voxHashImage.get());
-  _descriptorSetBundle->bindStorageImage(24, _lastVoxHashImage.get());
-  _descriptorSetBundle->bindStorageImage(25, _accumedImage.get());
-  _descriptorSetBundle->bindStorageImage(26, _lastAccumedImage.get());
-  _descriptorSetBundle->bindStorageImage(27, _godRayAccumedImage.get());
-  _descriptorSetBundle->bindStorageImage(28, _lastGodRayAccumedImage.get());
-
-  _descriptorSetBundle->bindStorageImage(29, _taaImage.get());
-  _descriptorSetBundle->bindStorageImage(30, _lastTaaImage.get());
-
-  _descriptorSetBundle->bindStorageImage(31, _blittedImage.get());
-
-  _descriptorSetBundle->bindStorageImage(32, _aTrousPingImage.get());
-  _descriptorSetBundle->bindStorageImage(33, _aTrousPongImage.get());
+  _descriptorSetBundle->bindStorageImageBundle(
+      19, _getHistoryImageBundle(_normalImage.get(), _lastNormalImage.get(), false));
+  _descriptorSetBundle->bindStorageImageBundle(
+      20, _getHistoryImageBundle(_normalImage.get(), _lastNormalImage.get(), true));
+  if (!_configContainer->svoTracerInfo->positionFromDepth) {
+    _descriptorSetBundle->bindStorageImageBundle(
+        21, _getHistoryImageBundle(_positionImage.get(), _lastPositionImage.get(), false));
+    _descriptorSetBundle->bindStorageImageBundle(
+        22, _getHistoryImageBundle(_positionImage.get(), _lastPositionImage.get(), true));
+  }
+  _descriptorSetBundle->bindStorageImageBundle(
+      23, _getHistoryImageBundle(_voxHashImage.get(), _lastVoxHashImage.get(), false));
+  _descriptorSetBundle->bindStorageImageBundle(
+      24, _getHistoryImageBundle(_voxHashImage.get(), _lastVoxHashImage.get(), true));
+  _descriptorSetBundle->bindStorageImageBundle(
+      25, _getHistoryImageBundle(_accumedImage.get(), _lastAccumedImage.get(), false));
+  _descriptorSetBundle->bindStorageImageBundle(
+      26, _getHistoryImageBundle(_accumedImage.get(), _lastAccumedImage.get(), true));
+  _descriptorSetBundle->bindStorageImageBundle(
+      27, _getHistoryImageBundle(_godRayAccumedImage.get(), _lastGodRayAccumedImage.get(), false));
+  _descriptorSetBundle->bindStorageImageBundle(
+      28, _getHistoryImageBundle(_godRayAccumedImage.get(), _lastGodRayAccumedImage.get(), true));
+
+  _descriptorSetBundle->bindStorageImageBundle(
+      29, _getHistoryImageBundle(_taaImage.get(), _lastTaaImage.get(), false));
+  _descriptorSetBundle->bindStorageImageBundle(
+      30, _getHistoryImageBundle(_taaImage.get(), _lastTaaImage.get(), true));
+
+  _descriptorSetBundle->bindStorageImage(31, _blittedImage);
+
+  _descriptorSetBundle->bindStorageImage(32, _aTrousPingImage);
+  _descriptorSetBundle->bindStorageImage(33, _aTrousPongImage);
 
   _descriptorSetBundle->bindStorageImage(34, _renderTargetImage.get());
 
-  _descriptorSetBundle->bindImageSampler(35, _lastTaaImage.get());
+  _descriptorSetBundle->bindImageSamplerBundle(
+      35, _getHistoryImageBundle(_taaImage.get(), _lastTaaImage.get(), true));
+
+  // the sampled views of the g-buffer images above, for the passes that only read them
+  _descriptorSetBundle->bindImageSampler(68, _hitImage.get());
+  _descriptorSetBundle->bindImageSampler(69, _temporalHistLengthImage.get());
+  _descriptorSetBundle->bindImageSamplerBundle(
+      70, _getHistoryImageBundle(_normalImage.get(), _lastNormalImage.get(), false));
+  _descriptorSetBundle->bindImageSamplerBundle(
+      71, _getHistoryImageBundle(_normalImage.get(), _lastNormalImage.get(), true));
+  if (_configContainer->svoTracerInfo->positionFromDepth) {
+    _descriptorSetBundle->bindImageSamplerBundle(
+        72, _getHistoryImageBundle(_historyDepthImage.get(), _lastDepthImage.get(), false));
+    _descriptorSetBundle->bindImageSamplerBundle(
+        73, _getHistoryImageBundle(_historyDepthImage.get(), _lastDepthImage.get(), true));
+  } else {
+    _descriptorSetBundle->bindImageSamplerBundle(
+        72, _getHistoryImageBundle(_positionImage.get(), _lastPositionImage.get(), false));
+    _descriptorSetBundle->bindImageSamplerBundle(
+        73, _getHistoryImageBundle(_positionImage.get(), _lastPositionImage.get(), true));
+  }
+  _descriptorSetBundle->bindImageSamplerBundle(
+      74, _getHistoryImageBundle(_voxHashImage.get(), _lastVoxHashImage.get(), false));
+  _descriptorSetBundle->bindImageSamplerBundle(
+      75, _getHistoryImageBundle(_accumedImage.get(), _lastAccumedImage.get(), true));
 
   _descriptorSetBundle->bindStorageImage(36, _transmittanceLutImage.get());
   _descriptorSetBundle->bindStorageImage(37, _multiScatteringLutImage.get());
@@ -820,15 +2422,88 @@ void SvoTracer::_createDescriptorSetBundle() {
   _descriptorSetBundle->bindImageSampler(39, _transmittanceLutImage.get());
   _descriptorSetBundle->bindImageSampler(40, _multiScatteringLutImage.get());
   _descriptorSetBundle->bindImageSampler(41, _skyViewLutImage.get());
+  _descriptorSetBundle->bindStorageBuffer(80, _skyRadianceShBuffer.get());
+  _descriptorSetBundle->bindStorageImage(81, _captureImage.get());
+  _descriptorSetBundle->bindStorageBuffer(82, _captureViewBuffer.get());
 
   _descriptorSetBundle->bindStorageImage(42, _shadowMapImage.get());
   _descriptorSetBundle->bindImageSampler(43, _shadowMapImage.get());
 
   _descriptorSetBundle->bindStorageBuffer(9, _svoBuilder->getChunkIndicesBuffer());
+  _descriptorSetBundle->bindStorageBuffer(78, _svoBuilder->getChunkBoundsBuffer());
+  _descriptorSetBundle->bindStorageBuffer(83, _svoBuilder->getChunkInstancesBuffer());
+  _descriptorSetBundle->bindStorageBufferBundle(84, _dynamicObjectGridBufferBundle.get());
   _descriptorSetBundle->bindStorageBuffer(44, _sceneInfoBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(45, _svoBuilder->getAppendedOctreeBuffer());
-  _descriptorSetBundle->bindStorageBuffer(46, _aTrousIterationBuffer.get());
-  _descriptorSetBundle->bindStorageBuffer(47, _outputInfoBuffer.get());
+  _descriptorSetBundle->bindStorageBufferArray(45, _svoBuilder->getOctreeBufferPages(),
+                                               kMaxOctreePageCount);
+  // the same pages, read through their texel buffer views
+  if (_configContainer->svoTracerInfo->octreeTexelBuffer) {
+    _descriptorSetBundle->bindUniformTexelBufferArray(67, _svoBuilder->getOctreeBufferPages(),
+                                                      kMaxOctreePageCount);
+  }
+  // or through their addresses
+  if (_configContainer->svoTracerInfo->octreeDeviceAddress) {
+    _descriptorSetBundle->bindStorageBuffer(76, _svoBuilder->getOctreePageAddressBuffer());
+  }
+  _descriptorSetBundle->bindStorageBuffer(46, _svoBuilder->getPaletteBuffer());
+  _descriptorSetBundle->bindStorageBufferBundle(47, _outputInfoBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(49, _chunkOccupancyBufferBundle.get());
+  _descriptorSetBundle->bindStorageBufferBundle(79, _chunkFrustumBoundsBufferBundle.get());
+  std::vector<Buffer *> wavefrontRayQueueBuffers;
+  wavefrontRayQueueBuffers.reserve(_wavefrontRayQueueBuffers.size());
+  for (auto const &queueBuffer : _wavefrontRayQueueBuffers) {
+    wavefrontRayQueueBuffers.push_back(queueBuffer.get());
+  }
+  _descriptorSetBundle->bindStorageBufferArray(50, wavefrontRayQueueBuffers,
+                                               kWavefrontRayQueueCount);
+  _descriptorSetBundle->bindStorageBuffer(51, _wavefrontPixelBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(52, _wavefrontRayBinBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(53, _wavefrontBinnedRayBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(54, _shadowReservoirBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(55, _lastShadowReservoirBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(57, _traversalStatsBuffer.get());
+  _descriptorSetBundle->bindStorageBuffer(58, _traversalSurfaceBuffer.get());
+  _descriptorSetBundle->bindStorageImage(59, _guiOverlayImage.get());
+  _descriptorSetBundle->bindStorageBuffer(62, _radianceCacheBuffer.get());
+  _descriptorSetBundle->bindStorageBufferBundle(77, _traversalHistogramBufferBundle.get());
+
+  if (_configContainer->svoTracerInfo->positionFromDepth) {
+    _descriptorSetBundle->bindStorageImageBundle(
+        56, _getHistoryImageBundle(_historyDepthImage.get(), _lastDepthImage.get(), true));
+  }
+
+  if (_temporalMomentsImage != nullptr) {
+    _descriptorSetBundle->bindStorageImageBundle(
+        63, _getHistoryImageBundle(_temporalMomentsImage.get(), _lastTemporalMomentsImage.get(),
+                                   false));
+    _descriptorSetBundle->bindStorageImageBundle(
+        64, _getHistoryImageBundle(_temporalMomentsImage.get(), _lastTemporalMomentsImage.get(),
+                                   true));
+  }
+
+  if (_configContainer->svoTracerInfo->aTrousAdaptive) {
+    std::vector<Buffer *> aTrousTileListBuffers;
+    for (auto const &listBuffer : _aTrousTileListBuffers) {
+      aTrousTileListBuffers.push_back(listBuffer.get());
+    }
+    _descriptorSetBundle->bindStorageBufferArray(65, aTrousTileListBuffers,
+                                                 kATrousMaxIterationCount);
+  }
+
+  if (_samplingTileBuffer != nullptr) {
+    _descriptorSetBundle->bindStorageBuffer(66, _samplingTileBuffer.get());
+  }
+
+  if (_configContainer->svoTracerInfo->depthReprojection) {
+    _descriptorSetBundle->bindStorageImage(60, _voxelDepthImage.get());
+    _descriptorSetBundle->bindStorageImage(61, _reprojectedDepthImage);
+  }
+
+  // the shaders only declare it if SUPPORTS_RAY_QUERY is defined
+  if (_chunkAccelerationStructure != nullptr) {
+    _descriptorSetBundle->bindAccelerationStructure(
+        48, _chunkAccelerationStructure->getTopLevelAccelerationStructure());
+  }
 
   _descriptorSetBundle->create();
 }
@@ -846,29 +2521,90 @@ void SvoTracer::_createPipelines() {
       _appContext, _logger, this, _makeShaderFullPath("skyViewLut.comp"), WorkGroupSize{8, 8, 1},
       _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
+  _skyRadianceShPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("skyRadianceSh.comp"),
+      WorkGroupSize{256, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
   _shadowMapPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("shadowMap.comp"), WorkGroupSize{8, 8, 1},
       _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
+  _chunkOccupancyPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("chunkOccupancy.comp"),
+      WorkGroupSize{4, 4, 4}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
   _svoCourseBeamPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("svoCoarseBeam.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 2 * sizeof(uint32_t));
+  _svoCourseBeamPipeline->setSpecializationConstants(_getCoarseBeamSpecializationConstants());
 
   _svoTracingPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("svoTracing.comp"), WorkGroupSize{8, 8, 1},
       _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+  _tracingSpecializationConstants = _getTracingSpecializationConstants();
+  _svoTracingPipeline->setSpecializationConstants(_tracingSpecializationConstants);
+  _isPostChainFused = _configContainer->svoTracerTweakingInfo->fusedPostChain;
+
+  _brushPickingPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("brushPicking.comp"), WorkGroupSize{1, 1, 1},
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _wavefrontQueueArgPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontQueueArg.comp"),
+      WorkGroupSize{1, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _wavefrontRayBinCountPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontRayBinCount.comp"),
+      WorkGroupSize{kWavefrontQueueWorkGroupSize, 1, 1}, _descriptorSetBundle.get(),
+      _shaderCompiler, _shaderChangeListener);
+
+  _wavefrontRayBinScanPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontRayBinScan.comp"),
+      WorkGroupSize{kWavefrontRayBinScanSize, 1, 1}, _descriptorSetBundle.get(), _shaderCompiler,
+      _shaderChangeListener);
+
+  _wavefrontRayBinScatterPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontRayBinScatter.comp"),
+      WorkGroupSize{kWavefrontQueueWorkGroupSize, 1, 1}, _descriptorSetBundle.get(),
+      _shaderCompiler, _shaderChangeListener);
+
+  _wavefrontIndirectRaysPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontIndirectRays.comp"),
+      WorkGroupSize{kWavefrontQueueWorkGroupSize, 1, 1}, _descriptorSetBundle.get(),
+      _shaderCompiler, _shaderChangeListener);
+
+  _wavefrontShadowRaysPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontShadowRays.comp"),
+      WorkGroupSize{kWavefrontQueueWorkGroupSize, 1, 1}, _descriptorSetBundle.get(),
+      _shaderCompiler, _shaderChangeListener);
+
+  _wavefrontResolvePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("wavefrontResolve.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _shadowResamplingPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("shadowResampling.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
   _godRayPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("godRay.comp"), WorkGroupSize{8, 8, 1},
       _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
+  _godRayUpsamplePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("godRayUpsample.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
   _temporalFilterPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("temporalFilter.comp"),
       WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
   _aTrousPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("aTrous.comp"), WorkGroupSize{8, 8, 1},
-      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, sizeof(uint32_t));
+
+  _aTrousFusedPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("aTrousFused.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
 
   _backgroundBlitPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("backgroundBlit.comp"),
@@ -881,21 +2617,71 @@ void SvoTracer::_createPipelines() {
   _postProcessingPipeline = std::make_unique<ComputePipeline>(
       _appContext, _logger, this, _makeShaderFullPath("postProcessing.comp"),
       WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _fusedPostChainPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("fusedPostChain.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener);
+
+  _traversalBenchmarkPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("traversalBenchmark.comp"),
+      WorkGroupSize{kWavefrontQueueWorkGroupSize, 1, 1}, _descriptorSetBundle.get(),
+      _shaderCompiler, _shaderChangeListener, 4 * sizeof(uint32_t));
+
+  _viewCapturePipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("viewCapture.comp"), WorkGroupSize{8, 8, 1},
+      _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener, 4 * sizeof(uint32_t));
+
+  _depthReprojectionPipeline = std::make_unique<ComputePipeline>(
+      _appContext, _logger, this, _makeShaderFullPath("depthReprojection.comp"),
+      WorkGroupSize{8, 8, 1}, _descriptorSetBundle.get(), _shaderCompiler, _shaderChangeListener,
+      sizeof(uint32_t));
+
+  // the shaders are compiled concurrently, the constructors above only register the pipelines
+  ComputePipeline::compileAndBuild({
+      _transmittanceLutPipeline.get(), _multiScatteringLutPipeline.get(), _skyViewLutPipeline.get(),
+      _skyRadianceShPipeline.get(), _shadowMapPipeline.get(), _chunkOccupancyPipeline.get(),
+      _svoCourseBeamPipeline.get(), _svoTracingPipeline.get(), _brushPickingPipeline.get(),
+      _wavefrontQueueArgPipeline.get(), _wavefrontRayBinCountPipeline.get(),
+      _wavefrontRayBinScanPipeline.get(), _wavefrontRayBinScatterPipeline.get(),
+      _wavefrontIndirectRaysPipeline.get(), _wavefrontShadowRaysPipeline.get(),
+      _wavefrontResolvePipeline.get(), _shadowResamplingPipeline.get(), _godRayPipeline.get(),
+      _godRayUpsamplePipeline.get(), _temporalFilterPipeline.get(), _aTrousPipeline.get(),
+      _aTrousFusedPipeline.get(), _backgroundBlitPipeline.get(), _taaUpscalingPipeline.get(),
+      _postProcessingPipeline.get(), _fusedPostChainPipeline.get(),
+      _traversalBenchmarkPipeline.get(), _viewCapturePipeline.get(),
+      _depthReprojectionPipeline.get()});
 }
 
 void SvoTracer::_updatePipelinesDescriptorBundles() {
   _transmittanceLutPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _multiScatteringLutPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _skyViewLutPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _skyRadianceShPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
 
   _shadowMapPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
 
+  _chunkOccupancyPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _svoCourseBeamPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _svoTracingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _brushPickingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontQueueArgPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontRayBinCountPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontRayBinScanPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontRayBinScatterPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontIndirectRaysPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontShadowRaysPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _wavefrontResolvePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _shadowResamplingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _godRayPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _godRayUpsamplePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _temporalFilterPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _aTrousPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _aTrousFusedPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _backgroundBlitPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _taaUpscalingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
   _postProcessingPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _fusedPostChainPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _traversalBenchmarkPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _viewCapturePipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
+  _depthReprojectionPipeline->updateDescriptorSetBundle(_descriptorSetBundle.get());
 }
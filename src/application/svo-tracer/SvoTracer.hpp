@@ -9,12 +9,14 @@
 #include <vector>
 
 struct ConfigContainer;
+struct E_TweakingInfoChanged;
 
 class Logger;
 class VulkanApplicationContext;
 
 class Image;
 class ImageForwardingPair;
+class TransientImagePool;
 class Buffer;
 class BufferBundle;
 class Sampler;
@@ -26,6 +28,10 @@ class ShadowMapCamera;
 class Window;
 class ShaderCompiler;
 class ShaderChangeListener;
+class TracingPassProfiler;
+class TraversalStatsSink;
+class ChunkAccelerationStructure;
+class PassBarrierTracker;
 
 class SvoTracer : public PipelineScheduler {
 public:
@@ -44,6 +50,34 @@ public:
   void onPipelineRebuilt() override;
 
   void onSwapchainResize();
+  void onOctreeBufferPagesChanged();
+  // swaps the pipeline variants and the post chain to the current toggles, the render loop must be
+  // blocked
+  void onPipelineVariantsChanged();
+  // only exists if ray queries are supported, it's submitted first, if the chunks changed
+  VkCommandBuffer getChunkAccelerationStructureCommandBuffer(size_t currentFrame);
+  [[nodiscard]] bool isChunkAccelerationStructureOutdated() const {
+    return _isChunkAccelerationStructureOutdated;
+  }
+  // only has to be submitted, after the chunk occupancy, and before the tracing command buffer, if
+  // the luts are outdated, it's allocated for the async compute queue
+  VkCommandBuffer getSkyLutCommandBuffer(size_t currentFrame) {
+    return _skyLutCommandBuffers[currentFrame];
+  }
+  [[nodiscard]] bool isSkyLutOutdated() const { return _isSkyLutOutdated; }
+  // the same goes for the shadow map, which is submitted after the sky luts
+  VkCommandBuffer getShadowMapCommandBuffer(size_t currentFrame) {
+    return _shadowMapCommandBuffers[currentFrame];
+  }
+  [[nodiscard]] bool isShadowMapOutdated() const { return _isShadowMapOutdated; }
+  // the passes of a frame are split into three command buffers, which are submitted in order, the
+  // coarse beam doesn't read the sky luts or the shadow map, so it overlaps with them
+  VkCommandBuffer getChunkOccupancyCommandBuffer(size_t currentFrame) {
+    return _chunkOccupancyCommandBuffers[currentFrame];
+  }
+  VkCommandBuffer getCoarseBeamCommandBuffer(size_t currentFrame) {
+    return _coarseBeamCommandBuffers[currentFrame];
+  }
   VkCommandBuffer getTracingCommandBuffer(size_t currentFrame) {
     return _tracingCommandBuffers[currentFrame];
   }
@@ -53,9 +87,65 @@ public:
 
   void drawFrame(size_t currentFrame);
 
-  G_OutputInfo getOutputInfo();
+  // the output of the last frame that has completed on the gpu, which is framesInFlight frames
+  // behind the current one, it has to be called before drawFrame
+  G_OutputInfo getOutputInfo(size_t currentFrame);
 
   void processInput(double deltaTime);
+  void setCameraPose(glm::vec3 const &position, float yaw, float pitch);
+  [[nodiscard]] glm::vec3 getCameraPosition() const;
+  [[nodiscard]] glm::vec3 getCameraFront() const;
+  [[nodiscard]] TracingPassProfiler *getPassProfiler() const { return _passProfiler.get(); }
+  // with SvoTracerTweakingData.traversalStatistics, of the frames that completed on the gpu
+  [[nodiscard]] TraversalStatsSink *getTraversalStatsSink() const {
+    return _traversalStatsSink.get();
+  }
+  // the host time drawFrame spent recording the command buffers, only when they're recorded every
+  // frame
+  [[nodiscard]] float getLatestRecordingTimeMs() const { return _latestRecordingTimeMs; }
+  // drawn by the gui, and composited by the post processing of every frame, it's recreated with
+  // the swapchain
+  [[nodiscard]] Image *getGuiOverlayImage() const { return _guiOverlayImage.get(); }
+
+  // the bgra texels of the render target, copied right after the post processing of the frame in
+  // flight, so they include the gui overlay, which is disabled in the headless mode, the frame has
+  // to be completed on the gpu, nullptr if the frames are neither dumped nor recorded
+  uint8_t const *getFrameDump(size_t currentFrame);
+
+  // the ray batches of the traversal benchmark, the hemisphere and the shadow rays start from the
+  // primary hits of the grid, should be synchronized with traversalBenchmark.comp
+  enum class TraversalRayMode : uint32_t {
+    kCoherentPrimary  = 1,
+    kRandomHemisphere = 2,
+    kShadowTowardSun  = 3,
+  };
+  struct TraversalBatchResult {
+    G_TraversalStats stats;
+    double gpuTimeMs;
+  };
+  // marches Benchmark.traversalRayCount rays through the octrees, without the rest of the frame,
+  // with the camera and the chunk window of the last frame drawn to the slot, the device has to be
+  // idle, it's waited on before returning
+  TraversalBatchResult runTraversalBatch(size_t currentFrame, TraversalRayMode mode, uint32_t seed);
+  // a square view of a capture, with normalized axes, the fov spans the whole layer
+  struct CaptureView {
+    glm::vec3 position;
+    glm::vec3 right;
+    glm::vec3 up;
+    glm::vec3 forward;
+    float fovDegrees;
+  };
+  // the six faces of a cubemap at the position, in the order of the vulkan cube layers
+  static std::vector<CaptureView> makeCubemapCaptureViews(glm::vec3 position);
+  // renders the views into the layers of the capture image in one batch of dispatches, with the
+  // luts, the shadow map and the chunk window of the last frame drawn to the slot, and without the
+  // temporal passes, the views beyond SvoTracer.captureViewCapacity are left out, the device has to
+  // be idle, it's waited on before returning, returns the gpu time in ms
+  double captureViews(size_t currentFrame, std::vector<CaptureView> const &views, uint32_t seed);
+  // rgba16f, a layer per view, in VK_IMAGE_LAYOUT_GENERAL
+  [[nodiscard]] Image *getCaptureImage() const { return _captureImage.get(); }
+  [[nodiscard]] uint32_t getFrameDumpWidth() const { return _highResWidth; }
+  [[nodiscard]] uint32_t getFrameDumpHeight() const { return _highResHeight; }
 
 private:
   VulkanApplicationContext *_appContext;
@@ -72,22 +162,141 @@ private:
   SvoBuilder *_svoBuilder = nullptr;
 
   size_t _framesInFlight;
+  // the history images swap their roles between the frames in flight, if there's an even number of
+  // them, otherwise the written images are copied to the last ones at the end of every frame
+  bool _isHistoryPingPonged;
+  std::vector<VkCommandBuffer> _skyLutCommandBuffers{};
+  std::vector<VkCommandBuffer> _shadowMapCommandBuffers{};
+  std::vector<VkCommandBuffer> _chunkOccupancyCommandBuffers{};
+  std::vector<VkCommandBuffer> _coarseBeamCommandBuffers{};
   std::vector<VkCommandBuffer> _tracingCommandBuffers{};
+  // the recording thread pools the three command buffers above of each frame are allocated from
+  std::vector<VkCommandPool> _renderingCommandPools{};
   std::vector<VkCommandBuffer> _deliveryCommandBuffers{};
+  std::unique_ptr<TracingPassProfiler> _passProfiler;
+  std::unique_ptr<TraversalStatsSink> _traversalStatsSink;
+  float _latestRecordingTimeMs = 0.F;
 
   uint32_t _lowResWidth   = 0;
   uint32_t _lowResHeight  = 0;
   uint32_t _highResWidth  = 0;
   uint32_t _highResHeight = 0;
+  // the size of the images, the sizes above are the rendered part of them, see
+  // SvoTracer.renderTargetSizeClass
+  glm::uvec2 _lowResImageSize{0};
+  glm::uvec2 _highResImageSize{0};
+
+  // the rendered part of the low res images, which are sized for a scale of one, the scale is only
+  // changed with the dynamic resolution, the dispatches of the low res passes are indirect, so
+  // that the command buffers don't have to be recorded again
+  float _renderScale = 1.F;
+  glm::uvec2 _renderSize{0};
+  glm::uvec2 _renderSizePrev{0};
 
   std::vector<glm::vec2> _subpixOffsets{};
 
-  void _updateShadowMapCamera();
+  // the toggles that the tracing pipeline is specialized with, the variant is swapped in the next
+  // blocked render loop after they're flipped
+  std::vector<uint32_t> _tracingSpecializationConstants{};
+  [[nodiscard]] std::vector<uint32_t> _getTracingSpecializationConstants() const;
+  [[nodiscard]] std::vector<uint32_t> _getCoarseBeamSpecializationConstants() const;
+  // the post chain that the command buffers are recorded with, swapped along with the variants
+  bool _isPostChainFused = false;
+
+  // the sky luts are computed again only when these change, the sun direction and the bases of
+  // G_EnvironmentInfo, along with the tweakable parameters that atmosCommon.glsl reads
+  struct SkyLutInputs {
+    glm::vec3 sunDir;
+    glm::vec3 rayleighScatteringBase;
+    float mieScatteringBase;
+    float mieAbsorptionBase;
+    glm::vec3 ozoneAbsorptionBase;
+    glm::vec3 groundAlbedo;
+    float rayleighDensityFalloff;
+
+    bool operator==(SkyLutInputs const &other) const {
+      return sunDir == other.sunDir && rayleighScatteringBase == other.rayleighScatteringBase &&
+             mieScatteringBase == other.mieScatteringBase &&
+             mieAbsorptionBase == other.mieAbsorptionBase &&
+             ozoneAbsorptionBase == other.ozoneAbsorptionBase &&
+             groundAlbedo == other.groundAlbedo &&
+             rayleighDensityFalloff == other.rayleighDensityFalloff;
+    }
+  };
+  SkyLutInputs _skyLutInputs{};
+  bool _isSkyLutComputed = false;
+  bool _isSkyLutOutdated = true;
+
+  // the TweakingGroup bits of the uniform buffers that each slot has to write again, every slot
+  // has its own copy of them, so an edit is written by the next framesInFlight frames
+  std::vector<uint32_t> _outdatedTweakingGroupBits;
+
+  // the shadow map is rendered again when the snapped shadow map camera moves, when the chunk
+  // window moves, or when a swapped chunk lies in the map
+  glm::ivec3 _shadowMapChunkWindowOrigin{0};
+  bool _isShadowMapRendered = false;
+  bool _isShadowMapOutdated = true;
+
+  // the voxel depths of the last frame are reprojected if they have been written since the image
+  // was created, and if no chunk has been swapped, and the chunk window hasn't moved since
+  glm::ivec3 _voxelDepthChunkWindowOrigin{0};
+  bool _isVoxelDepthWritten         = false;
+  bool _isLastVoxelDepthReprojected = false;
+
+  // the frames since the camera, the chunks, the render size or the tweaking last changed, the
+  // edits and the resizes in between mark the stillness as broken
+  glm::vec3 _stillCamPosition{0.F};
+  glm::vec3 _stillCamFront{0.F};
+  float _stillCamVFov = 0.F;
+  glm::ivec3 _stillChunkWindowOrigin{0};
+  bool _isStillnessBroken     = true;
+  uint32_t _staticFrameCount = 0;
+
+  // the chunk acceleration structure is built again when the non-empty chunks, or the chunk window
+  // change, and only while the ray queries are used
+  std::unique_ptr<ChunkAccelerationStructure> _chunkAccelerationStructure;
+  glm::ivec3 _accelerationStructureChunkWindowOrigin{0};
+  bool _isChunkAccelerationStructureBuilt    = false;
+  bool _isChunkAccelerationStructureOutdated = false;
+
+  void _updateRenderSize(bool isFrameTimeMeasured);
+  void _updateShadowMapCamera(std::vector<glm::ivec3> const &swappedChunks);
+  void _updateDepthReprojection(std::vector<glm::ivec3> const &swappedChunks);
+  void _updateStaticFrameCount(std::vector<glm::ivec3> const &swappedChunks);
+  // the chunks of the moved objects are added to the swapped chunks
+  void _updateDynamicObjectGrid(size_t currentFrame, std::vector<glm::ivec3> &swappedChunks);
+  void _updateChunkAccelerationStructure(size_t currentFrame,
+                                         std::vector<glm::ivec3> const &swappedChunks);
+  [[nodiscard]] bool _isAnyChunkInShadowMap(std::vector<glm::ivec3> const &chunkIndices) const;
+  void _onTweakingInfoChanged(E_TweakingInfoChanged const &event);
   void _updateUboData(size_t currentFrame);
-
-  void _updateImageResolutions();
-
+  void _updateTweakableParameters(size_t currentFrame);
+  void _updateDispatchSizes(size_t currentFrame);
+  // the statistics of the last frame of the slot, which has completed, like getOutputInfo
+  void _collectTraversalStatistics(size_t currentFrame);
+
+  // returns true if the images have to be allocated again for the new resolutions
+  bool _updateImageResolutions();
+
+  void _recordSkyLutCommandBuffers();
+  void _recordShadowMapCommandBuffers();
+  void _recordFrameConstantCopies(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+  void _recordChunkOccupancyCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+  void _recordWavefrontQueueResetCommand(VkCommandBuffer commandBuffer);
+  void _recordATrousTileListResetCommand(VkCommandBuffer commandBuffer);
+  void _recordTraversalHistogramResetCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+  void _recordFrameDumpCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+  void _recordWavefrontBouncesCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex);
+  void _recordDepthReprojectionCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                       PassBarrierTracker &tracker);
+  // the background blit, the taa upscaling and the post processing, or the fused pass of them
+  void _recordPostChainCommands(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                PassBarrierTracker &tracker);
+  void _recordFusedPostChainCommand(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                    PassBarrierTracker &tracker);
   void _recordRenderingCommandBuffers();
+  void _allocateFrameCommandBuffers(uint32_t frameIndex);
+  void _recordFrameCommandBuffers(uint32_t frameIndex);
   void _recordDeliveryCommandBuffers();
 
   void _createTaaSamplingOffsets();
@@ -109,17 +318,26 @@ private:
 
   std::unique_ptr<Image> _shadowMapImage;
 
+  // the layers of the captured views, see captureViews
+  std::unique_ptr<Image> _captureImage;
+
   // the followed up resources are swapchain dimension related
+  // the images that only live within a range of the passes of a frame are aliased by the pool,
+  // which owns them
+  std::unique_ptr<TransientImagePool> _transientImagePool;
   std::unique_ptr<Image> _backgroundImage;
-  std::unique_ptr<Image> _beamDepthImage;
+  Image *_beamDepthImage        = nullptr;
+  Image *_reprojectedDepthImage = nullptr;
   std::unique_ptr<Image> _rawImage;
   std::unique_ptr<Image> _instantImage;
-  std::unique_ptr<Image> _depthImage;
+  Image *_depthImage = nullptr;
   std::unique_ptr<Image> _octreeVisualizationImage;
   std::unique_ptr<Image> _hitImage;
   std::unique_ptr<Image> _temporalHistLengthImage;
   std::unique_ptr<Image> _motionImage;
 
+  // the pairs below are the history images, the forwarding pairs are only used if they aren't ping
+  // ponged
   std::unique_ptr<Image> _normalImage;
   std::unique_ptr<Image> _lastNormalImage;
   std::unique_ptr<ImageForwardingPair> _normalForwardingPair;
@@ -128,14 +346,30 @@ private:
   std::unique_ptr<Image> _lastPositionImage;
   std::unique_ptr<ImageForwardingPair> _positionForwardingPair;
 
+  // replaces the position pair with SvoTracer.positionFromDepth, _depthImage points to the first
+  // one then, instead of a transient image
+  std::unique_ptr<Image> _historyDepthImage;
+  std::unique_ptr<Image> _lastDepthImage;
+  std::unique_ptr<ImageForwardingPair> _depthForwardingPair;
+
   std::unique_ptr<Image> _voxHashImage;
   std::unique_ptr<Image> _lastVoxHashImage;
   std::unique_ptr<ImageForwardingPair> _voxHashForwardingPair;
 
+  // only with SvoTracer.depthReprojection, it's read before the tracing writes it again, so it
+  // needs no pair
+  std::unique_ptr<Image> _voxelDepthImage;
+
   std::unique_ptr<Image> _accumedImage;
   std::unique_ptr<Image> _lastAccumedImage;
   std::unique_ptr<ImageForwardingPair> _accumedForwardingPair;
 
+  // only with SvoTracer.aTrousAdaptive, the luminance moments of the accumed colors
+  std::unique_ptr<Image> _temporalMomentsImage;
+  std::unique_ptr<Image> _lastTemporalMomentsImage;
+  std::unique_ptr<ImageForwardingPair> _temporalMomentsForwardingPair;
+
+  // sized for every SvoTracer.godRayDownscale low res pixels per axis
   std::unique_ptr<Image> _godRayAccumedImage;
   std::unique_ptr<Image> _lastGodRayAccumedImage;
   std::unique_ptr<ImageForwardingPair> _godRayAccumedForwardingPair;
@@ -144,12 +378,14 @@ private:
   std::unique_ptr<Image> _lastTaaImage;
   std::unique_ptr<ImageForwardingPair> _taaForwardingPair;
 
-  std::unique_ptr<Image> _blittedImage;
+  Image *_blittedImage = nullptr;
 
-  std::unique_ptr<Image> _aTrousPingImage;
-  std::unique_ptr<Image> _aTrousPongImage;
+  Image *_aTrousPingImage = nullptr;
+  Image *_aTrousPongImage = nullptr;
 
   std::unique_ptr<Image> _renderTargetImage;
+  // premultiplied, and transparent until the gui is drawn into it
+  std::unique_ptr<Image> _guiOverlayImage;
   std::vector<std::unique_ptr<ImageForwardingPair>> _targetForwardingPairs;
 
   void _createSamplers();
@@ -157,11 +393,16 @@ private:
   void _createImages();
   void _createSkyLutImages();
   void _createShadowMapImage();
+  void _createCaptureImage();
   void _createSwapchainRelatedImages(); // auto release
 
   void _createBlueNoiseImages();
   void _createFullSizedImages();
+  void _createTransientImages();
   void _createImageForwardingPairs();
+  // one image per descriptor set, the written one of the pair, or the last one
+  [[nodiscard]] std::vector<Image *> _getHistoryImageBundle(Image *image, Image *lastImage,
+                                                            bool isLastImage) const;
 
   /// BUFFERS
 
@@ -176,13 +417,70 @@ private:
   std::unique_ptr<BufferBundle> _tweakableParametersBufferBundle;
   std::unique_ptr<BufferBundle> _temporalFilterInfoBufferBundle;
   std::unique_ptr<BufferBundle> _spatialFilterInfoBufferBundle;
+  // VkDispatchIndirectCommand, for the render size, and for each level of the coarse beams that
+  // cover it, from the finest one
+  std::unique_ptr<BufferBundle> _lowResDispatchBufferBundle;
+  std::vector<std::unique_ptr<BufferBundle>> _beamDispatchBufferBundles;
+  // VkDispatchIndirectCommand, for the swapchain extent, so that a resize within the images doesn't
+  // record the command buffers again
+  std::unique_ptr<BufferBundle> _highResDispatchBufferBundle;
+  // VkDispatchIndirectCommand, for the god ray pixels of the render size
+  std::unique_ptr<BufferBundle> _godRayDispatchBufferBundle;
+  // an occupancy bit per cell of chunks, for the dda to leap over the empty cells
+  std::unique_ptr<BufferBundle> _chunkOccupancyBufferBundle;
+  // the top-level grid of the dynamic objects, a frame slot is only written once the grid changes
+  std::unique_ptr<BufferBundle> _dynamicObjectGridBufferBundle;
+  uint64_t _dynamicObjectGridVersion = 0;
+  std::vector<uint64_t> _dynamicObjectGridFrameVersions;
+  // G_ChunkFrustumBounds, the chunks in the frusta of the frame, written along with the occupancy
+  std::unique_ptr<BufferBundle> _chunkFrustumBoundsBufferBundle;
+  // the brush hits, written by the picking ray of each frame, see getOutputInfo
+  std::unique_ptr<BufferBundle> _outputInfoBufferBundle;
+  // G_TraversalHistogram, reset and written by each frame, read back like the output info
+  std::unique_ptr<BufferBundle> _traversalHistogramBufferBundle;
 
   std::unique_ptr<Buffer> _sceneInfoBuffer;
-  std::unique_ptr<Buffer> _aTrousIterationBuffer;
-  std::vector<std::unique_ptr<Buffer>> _aTrousIterationStagingBuffers;
-  std::unique_ptr<Buffer> _outputInfoBuffer;
+  // G_SkyRadianceSh, the sky view lut projected for the indirect misses, written with the luts
+  std::unique_ptr<Buffer> _skyRadianceShBuffer;
+  // the ray queues of the wavefront tracing, and the radiance slots of their pixels, they are sized
+  // for the low res images
+  std::vector<std::unique_ptr<Buffer>> _wavefrontRayQueueBuffers;
+  std::unique_ptr<Buffer> _wavefrontPixelBuffer;
+  // the counting sort of the indirect rays, the bins are per chunk of the window and direction
+  std::unique_ptr<Buffer> _wavefrontRayBinBuffer;
+  std::unique_ptr<Buffer> _wavefrontBinnedRayBuffer;
+  // the light samples of the shadow rays, the last ones are the history of the temporal reuse,
+  // written by the spatial reuse
+  std::unique_ptr<Buffer> _shadowReservoirBuffer;
+  std::unique_ptr<Buffer> _lastShadowReservoirBuffer;
+  // the radiance that leaves the voxels, shared by the frames in flight, see radianceCache.glsl
+  std::unique_ptr<Buffer> _radianceCacheBuffer;
+  // only with SvoTracer.aTrousAdaptive, the tiles of every a-trous iteration, behind its dispatch,
+  // sized for the low res images
+  std::vector<std::unique_ptr<Buffer>> _aTrousTileListBuffers;
+  // only with SvoTracer.adaptiveSampling, whether the pixels of every tile converged, sized for the
+  // low res images, see adaptiveSampling.glsl
+  std::unique_ptr<Buffer> _samplingTileBuffer;
+  // one per frame in flight, only created for the dumped headless frames, and the recorded ones
+  std::vector<std::unique_ptr<Buffer>> _frameDumpBuffers;
+  // the sums of the traversal batches, read by the host, and the primary hits they start from
+  std::unique_ptr<Buffer> _traversalStatsBuffer;
+  std::unique_ptr<Buffer> _traversalSurfaceBuffer;
+  // the begin and the end of the batch, created by the first one
+  VkQueryPool _traversalQueryPool = VK_NULL_HANDLE;
+  // host visible, rewritten by every capture
+  std::unique_ptr<Buffer> _captureViewBuffer;
+  VkQueryPool _captureQueryPool = VK_NULL_HANDLE;
 
   void _createBuffersAndBufferBundles();
+  void _createWavefrontBuffers();
+  void _createShadowReservoirBuffers();
+  void _createRadianceCacheBuffer();
+  void _createATrousTileListBuffers();
+  void _createSamplingTileBuffer();
+  void _createFrameDumpBuffers();
+  void _createTraversalBenchmarkBuffers();
+  void _createCaptureViewBuffer();
   void _initBufferData();
 
   /// PIPELINES
@@ -192,16 +490,33 @@ private:
   std::unique_ptr<ComputePipeline> _transmittanceLutPipeline;
   std::unique_ptr<ComputePipeline> _multiScatteringLutPipeline;
   std::unique_ptr<ComputePipeline> _skyViewLutPipeline;
+  std::unique_ptr<ComputePipeline> _skyRadianceShPipeline;
 
   std::unique_ptr<ComputePipeline> _shadowMapPipeline;
+  std::unique_ptr<ComputePipeline> _chunkOccupancyPipeline;
   std::unique_ptr<ComputePipeline> _svoCourseBeamPipeline;
   std::unique_ptr<ComputePipeline> _svoTracingPipeline;
+  std::unique_ptr<ComputePipeline> _brushPickingPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontQueueArgPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontRayBinCountPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontRayBinScanPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontRayBinScatterPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontIndirectRaysPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontShadowRaysPipeline;
+  std::unique_ptr<ComputePipeline> _wavefrontResolvePipeline;
+  std::unique_ptr<ComputePipeline> _shadowResamplingPipeline;
   std::unique_ptr<ComputePipeline> _godRayPipeline;
+  std::unique_ptr<ComputePipeline> _godRayUpsamplePipeline;
   std::unique_ptr<ComputePipeline> _temporalFilterPipeline;
   std::unique_ptr<ComputePipeline> _aTrousPipeline;
+  std::unique_ptr<ComputePipeline> _aTrousFusedPipeline;
   std::unique_ptr<ComputePipeline> _backgroundBlitPipeline;
   std::unique_ptr<ComputePipeline> _taaUpscalingPipeline;
   std::unique_ptr<ComputePipeline> _postProcessingPipeline;
+  std::unique_ptr<ComputePipeline> _fusedPostChainPipeline;
+  std::unique_ptr<ComputePipeline> _traversalBenchmarkPipeline;
+  std::unique_ptr<ComputePipeline> _viewCapturePipeline;
+  std::unique_ptr<ComputePipeline> _depthReprojectionPipeline;
 
   void _createDescriptorSetBundle();
   void _createPipelines();
@@ -0,0 +1,170 @@
+#include "TracingPassProfiler.hpp"
+
+#include "app-context/VulkanApplicationContext.hpp"
+#include "utils/logger/Logger.hpp"
+#include "utils/pass-time-sink/PassTimeSink.hpp"
+
+#include <array>
+#include <string>
+
+namespace {
+// enough for a few seconds of the stacked plot
+size_t constexpr kPassHistorySize = 400;
+
+std::array<char const *, TracingPassProfiler::kPassCount> constexpr kPassNames = {
+    "transmittance lut", "multi-scattering lut", "sky-view lut",       "sky radiance sh",
+    "shadow map",        "chunk occupancy",      "coarse beam 3",      "coarse beam 2",
+    "coarse beam 1",     "coarse beam",          "depth reprojection", "tracing",
+    "wavefront bounces", "shadow resampling",    "god ray",            "temporal filter",
+    "a-trous",           "background blit",      "taa upscaling",      "post processing",
+    "history copy",
+};
+} // namespace
+
+TracingPassProfiler::TracingPassProfiler(VulkanApplicationContext *appContext, Logger *logger,
+                                         size_t framesInFlight)
+    : _appContext(appContext), _logger(logger), _isFrameSubmitted(framesInFlight, false),
+      _skippedPassBits(framesInFlight, 0) {
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(_appContext->getPhysicalDevice(), &properties);
+  _timestampPeriodNs = static_cast<double>(properties.limits.timestampPeriod);
+
+  VkQueryPoolCreateInfo queryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+  queryPoolInfo.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+  queryPoolInfo.queryCount = static_cast<uint32_t>(framesInFlight) * kPassCount * 2;
+  vkCreateQueryPool(_appContext->getDevice(), &queryPoolInfo, nullptr, &_queryPool);
+
+#ifndef NVALIDATIONLAYERS
+  // the passes are compute dispatches, so the other counters would stay at zero
+  if (_appContext->isPipelineStatisticsQuerySupported()) {
+    VkQueryPoolCreateInfo statisticsQueryPoolInfo{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+    statisticsQueryPoolInfo.queryType  = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+    statisticsQueryPoolInfo.queryCount = static_cast<uint32_t>(framesInFlight) * kPassCount;
+    statisticsQueryPoolInfo.pipelineStatistics =
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+    vkCreateQueryPool(_appContext->getDevice(), &statisticsQueryPoolInfo, nullptr,
+                      &_statisticsQueryPool);
+  }
+#endif // NVALIDATIONLAYERS
+
+  _passTimeSink = std::make_unique<PassTimeSink>(
+      std::vector<std::string>(kPassNames.begin(), kPassNames.end()), kPassHistorySize);
+}
+
+TracingPassProfiler::~TracingPassProfiler() {
+  vkDestroyQueryPool(_appContext->getDevice(), _queryPool, nullptr);
+  if (_statisticsQueryPool != VK_NULL_HANDLE) {
+    vkDestroyQueryPool(_appContext->getDevice(), _statisticsQueryPool, nullptr);
+  }
+}
+
+void TracingPassProfiler::recordReset(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                      Pass firstPass, Pass endPass) {
+  vkCmdResetQueryPool(commandBuffer, _queryPool, _getQueryIndex(frameIndex, firstPass),
+                      (endPass - firstPass) * 2);
+  if (_statisticsQueryPool != VK_NULL_HANDLE) {
+    vkCmdResetQueryPool(commandBuffer, _statisticsQueryPool,
+                        _getStatisticsQueryIndex(frameIndex, firstPass), endPass - firstPass);
+  }
+}
+
+// mirrors ChunkBuildProfiler, both wait for the commands before them, the passes are separated by
+// barriers anyway
+void TracingPassProfiler::recordPassBegin(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                          Pass pass) {
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool,
+                      _getQueryIndex(frameIndex, pass));
+  // the passes never overlap, so only one statistics query is active at a time
+  if (_statisticsQueryPool != VK_NULL_HANDLE) {
+    vkCmdBeginQuery(commandBuffer, _statisticsQueryPool, _getStatisticsQueryIndex(frameIndex, pass),
+                    0);
+  }
+}
+
+void TracingPassProfiler::recordPassEnd(VkCommandBuffer commandBuffer, uint32_t frameIndex,
+                                        Pass pass) {
+  if (_statisticsQueryPool != VK_NULL_HANDLE) {
+    vkCmdEndQuery(commandBuffer, _statisticsQueryPool, _getStatisticsQueryIndex(frameIndex, pass));
+  }
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _queryPool,
+                      _getQueryIndex(frameIndex, pass) + 1);
+}
+
+bool TracingPassProfiler::collect(uint32_t frameIndex) {
+  uint32_t const skippedPassBits = _skippedPassBits[frameIndex];
+  _skippedPassBits[frameIndex]   = 0;
+  if (!_isFrameSubmitted[frameIndex]) {
+    _isFrameSubmitted[frameIndex] = true;
+    return false;
+  }
+
+  // the fence of the frame has been waited on, so this doesn't wait, a frame with a missing
+  // timestamp is dropped as a whole
+  std::vector<float> passTimesMs(kPassCount, 0.F);
+  for (uint32_t pass = 0; pass < kPassCount; pass++) {
+    if ((skippedPassBits & (1U << pass)) != 0) {
+      continue;
+    }
+
+    // a timestamp and its availability per query
+    std::array<uint64_t, 4> results{};
+    vkGetQueryPoolResults(_appContext->getDevice(), _queryPool, _getQueryIndex(frameIndex, pass),
+                          2, results.size() * sizeof(uint64_t), results.data(),
+                          2 * sizeof(uint64_t),
+                          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    uint64_t const *begin = results.data();
+    uint64_t const *end   = begin + 2;
+    if (begin[1] == 0 || end[1] == 0 || end[0] < begin[0]) {
+      return false;
+    }
+    double constexpr kNsPerMs = 1000000.0;
+    passTimesMs[pass] =
+        static_cast<float>(static_cast<double>(end[0] - begin[0]) * _timestampPeriodNs / kNsPerMs);
+  }
+  _passTimeSink->addRecord(passTimesMs, _collectInvocationCounts(frameIndex, skippedPassBits));
+
+  _latestFrameTimeMs = 0.F;
+  for (float const passTimeMs : passTimesMs) {
+    _latestFrameTimeMs += passTimeMs;
+  }
+  return true;
+}
+
+std::vector<uint64_t>
+TracingPassProfiler::_collectInvocationCounts(uint32_t frameIndex,
+                                              uint32_t skippedPassBits) const {
+  if (_statisticsQueryPool == VK_NULL_HANDLE) {
+    return {};
+  }
+  std::vector<uint64_t> invocationCounts(kPassCount, 0);
+  for (uint32_t pass = 0; pass < kPassCount; pass++) {
+    if ((skippedPassBits & (1U << pass)) != 0) {
+      continue;
+    }
+    // the count and its availability
+    std::array<uint64_t, 2> result{};
+    vkGetQueryPoolResults(_appContext->getDevice(), _statisticsQueryPool,
+                          _getStatisticsQueryIndex(frameIndex, pass), 1,
+                          result.size() * sizeof(uint64_t), result.data(), 0,
+                          VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result[1] == 0) {
+      return {};
+    }
+    invocationCounts[pass] = result[0];
+  }
+  return invocationCounts;
+}
+
+void TracingPassProfiler::skipPasses(uint32_t frameIndex, Pass firstPass, Pass endPass) {
+  for (uint32_t pass = firstPass; pass < endPass; pass++) {
+    _skippedPassBits[frameIndex] |= 1U << pass;
+  }
+}
+
+void TracingPassProfiler::writeCsv(std::string const &pathToFile) const {
+  if (!_passTimeSink->writeCsv(pathToFile)) {
+    _logger->warn("failed to write the tracing pass profile to {}", pathToFile);
+    return;
+  }
+  _logger->info("tracing pass profile written to {}", pathToFile);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "volk.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Logger;
+class PassTimeSink;
+class VulkanApplicationContext;
+
+// gpu timestamps around every pass of the tracing command buffers, one range of queries per frame
+// in flight, the range of a frame is read once its fence is waited on again, that is, frames in
+// flight frames later, so the readback never stalls, with the validation layers, the compute
+// invocations of every pass are counted by a pipeline statistics query as well
+class TracingPassProfiler {
+public:
+  enum Pass : uint32_t {
+    // the sky luts and the shadow map have their own command buffers, which aren't submitted every
+    // frame
+    kTransmittanceLut,
+    kMultiScatteringLut,
+    kSkyViewLut,
+    kSkyRadianceSh,
+    kShadowMap,
+    kChunkOccupancy,
+    // the coarser levels of the beams, each one starts from the depths of the level above it, the
+    // ones beyond the configured level count are skipped
+    kCoarseBeamLevel3,
+    kCoarseBeamLevel2,
+    kCoarseBeamLevel1,
+    kCoarseBeam,        // the finest level, which is read by the tracing
+    kDepthReprojection, // the voxels hit by the last frame, moved to this one
+    kTracing,
+    kWavefrontBounces, // the queued rays of the wavefront tracing, along with their resolve
+    kShadowResampling,
+    kGodRay,
+    kTemporalFilter,
+    kATrous, // all of the iterations, along with their uploads
+    kBackgroundBlit,
+    kTaaUpscaling,
+    kPostProcessing,
+    kHistoryCopy,
+    kPassCount,
+  };
+
+  TracingPassProfiler(VulkanApplicationContext *appContext, Logger *logger,
+                      size_t framesInFlight);
+  ~TracingPassProfiler();
+
+  // disable copy and move
+  TracingPassProfiler(TracingPassProfiler const &)            = delete;
+  TracingPassProfiler(TracingPassProfiler &&)                 = delete;
+  TracingPassProfiler &operator=(TracingPassProfiler const &) = delete;
+  TracingPassProfiler &operator=(TracingPassProfiler &&)      = delete;
+
+  // the resets go first in the command buffers of the frame, each one covers the passes of its
+  // command buffer, from the first pass up to the end pass
+  void recordReset(VkCommandBuffer commandBuffer, uint32_t frameIndex, Pass firstPass,
+                   Pass endPass);
+  void recordPassBegin(VkCommandBuffer commandBuffer, uint32_t frameIndex, Pass pass);
+  void recordPassEnd(VkCommandBuffer commandBuffer, uint32_t frameIndex, Pass pass);
+
+  // called after the fence of the frame is waited on, before its command buffers are submitted
+  // again, adds the passes of the last submission of the frame to the sink, returns false if no
+  // record was added
+  bool collect(uint32_t frameIndex);
+  // the sum of the passes of the latest record, which is as old as the frames in flight
+  [[nodiscard]] float getLatestFrameTimeMs() const { return _latestFrameTimeMs; }
+  // the passes of a command buffer that isn't part of the next submission of the frame count as
+  // zero, their queries hold an older frame, or were never reset, so they aren't read
+  void skipPasses(uint32_t frameIndex, Pass firstPass, Pass endPass);
+
+  [[nodiscard]] PassTimeSink *getPassTimeSink() const { return _passTimeSink.get(); }
+  void writeCsv(std::string const &pathToFile) const;
+
+private:
+  VulkanApplicationContext *_appContext;
+  Logger *_logger;
+  double _timestampPeriodNs = 0.0;
+
+  VkQueryPool _queryPool = VK_NULL_HANDLE;
+  // a query per pass, null without the validation layers, or without the device feature
+  VkQueryPool _statisticsQueryPool = VK_NULL_HANDLE;
+  // the queries of a frame are never read before its first submission
+  std::vector<bool> _isFrameSubmitted;
+  // a bit per pass
+  std::vector<uint32_t> _skippedPassBits;
+  float _latestFrameTimeMs = 0.F;
+  std::unique_ptr<PassTimeSink> _passTimeSink;
+
+  [[nodiscard]] static uint32_t _getQueryIndex(uint32_t frameIndex, uint32_t pass) {
+    return (frameIndex * kPassCount + pass) * 2;
+  }
+  [[nodiscard]] static uint32_t _getStatisticsQueryIndex(uint32_t frameIndex, uint32_t pass) {
+    return frameIndex * kPassCount + pass;
+  }
+  // the counts of the passes, or nothing if a count is missing
+  [[nodiscard]] std::vector<uint64_t> _collectInvocationCounts(uint32_t frameIndex,
+                                                               uint32_t skippedPassBits) const;
+};
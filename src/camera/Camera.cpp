@@ -45,6 +45,13 @@ float Camera::getVFov() const { return _configContainer->cameraInfo->vFov; }
 
 void Camera::processInput(double deltaTime) { processKeyboard(deltaTime); }
 
+void Camera::setPose(glm::vec3 const &position, float yaw, float pitch) {
+  _position = position;
+  _yaw      = yaw;
+  _pitch    = pitch;
+  _updateCameraVectors();
+}
+
 void Camera::processKeyboard(double deltaTime) {
   if (!canMove()) {
     return;
@@ -29,6 +29,9 @@ public:
 
   void processInput(double deltaTime);
 
+  // places the camera directly, for the scripted camera paths, the angles are in euler angles
+  void setPose(glm::vec3 const &position, float yaw, float pitch);
+
   // processes input received from any keyboard-like input system. Accepts input
   // parameter in the form of camera defined ENUM (to abstract it from windowing
   // systems)
@@ -3,6 +3,8 @@
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/ShadowMapCameraInfo.hpp"
 
+#include <cmath>
+
 glm::vec3 constexpr kWorldUp             = {0.F, 1.F, 0.F};
 float constexpr kShadowMapCameraDistance = 10.F;
 
@@ -17,8 +19,19 @@ glm::mat4 ShadowMapCamera::getProjectionMatrix() const {
 }
 
 void ShadowMapCamera::updateCameraVectors(glm::vec3 playerCameraPosition, glm::vec3 sunDir) {
-  _position = sunDir * kShadowMapCameraDistance + playerCameraPosition;
-  _front    = -sunDir;
-  _right    = glm::normalize(glm::cross(_front, kWorldUp));
-  _up       = glm::cross(_right, _front);
+  _front = -sunDir;
+  _right = glm::normalize(glm::cross(_front, kWorldUp));
+  _up    = glm::cross(_right, _front);
+
+  // the centre is snapped along the axes of the light, so the position stays exactly the same
+  // while the player camera moves inside a cell, which keeps the cached map valid
+  glm::vec3 center        = playerCameraPosition;
+  auto const snapDistance = _configContainer->shadowMapCameraInfo->snapDistance;
+  if (snapDistance > 0.F) {
+    auto const snapAlong = [&](glm::vec3 axis) {
+      return axis * std::round(glm::dot(axis, playerCameraPosition) / snapDistance) * snapDistance;
+    };
+    center = snapAlong(_right) + snapAlong(_up) + snapAlong(_front);
+  }
+  _position = sunDir * kShadowMapCameraDistance + center;
 }
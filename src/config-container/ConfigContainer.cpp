@@ -3,20 +3,24 @@
 #include "utils/toml-config/TomlConfigReader.hpp"
 
 #include "sub-config/ApplicationInfo.hpp"
+#include "sub-config/BenchmarkInfo.hpp"
 #include "sub-config/BrushInfo.hpp"
 #include "sub-config/CameraInfo.hpp"
 #include "sub-config/ImguiManagerInfo.hpp"
 #include "sub-config/ShadowMapCameraInfo.hpp"
+#include "sub-config/SvoBuilderInfo.hpp"
 #include "sub-config/SvoTracerInfo.hpp"
 #include "sub-config/SvoTracerTweakingInfo.hpp"
 #include "sub-config/TerrainInfo.hpp"
 
 ConfigContainer::ConfigContainer(Logger *logger)
     : applicationInfo(std::make_unique<ApplicationInfo>()),
-      brushInfo(std::make_unique<BrushInfo>()), cameraInfo(std::make_unique<CameraInfo>()),
+      benchmarkInfo(std::make_unique<BenchmarkInfo>()), brushInfo(std::make_unique<BrushInfo>()),
+      cameraInfo(std::make_unique<CameraInfo>()),
       imguiManagerInfo(std::make_unique<ImguiManagerInfo>()),
       shadowMapCameraInfo(std::make_unique<ShadowMapCameraInfo>()),
       terrainInfo(std::make_unique<TerrainInfo>()),
+      svoBuilderInfo(std::make_unique<SvoBuilderInfo>()),
       svoTracerInfo(std::make_unique<SvoTracerInfo>()),
       svoTracerTweakingInfo(std::make_unique<SvoTracerTweakingInfo>()), _logger(logger) {
   _loadConfig();
@@ -28,11 +32,13 @@ void ConfigContainer::_loadConfig() {
   TomlConfigReader tomlConfigReader{_logger};
 
   applicationInfo->loadConfig(&tomlConfigReader);
+  benchmarkInfo->loadConfig(&tomlConfigReader);
   brushInfo->loadConfig(&tomlConfigReader);
   cameraInfo->loadConfig(&tomlConfigReader);
   imguiManagerInfo->loadConfig(&tomlConfigReader);
   shadowMapCameraInfo->loadConfig(&tomlConfigReader);
   terrainInfo->loadConfig(&tomlConfigReader);
+  svoBuilderInfo->loadConfig(&tomlConfigReader);
   svoTracerInfo->loadConfig(&tomlConfigReader);
   svoTracerTweakingInfo->loadConfig(&tomlConfigReader);
 }
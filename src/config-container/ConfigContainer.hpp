@@ -3,11 +3,13 @@
 #include <memory>
 
 struct ApplicationInfo;
+struct BenchmarkInfo;
 struct BrushInfo;
 struct CameraInfo;
 struct ImguiManagerInfo;
 struct ShadowMapCameraInfo;
 struct TerrainInfo;
+struct SvoBuilderInfo;
 struct SvoTracerInfo;
 struct SvoTracerTweakingInfo;
 
@@ -24,11 +26,13 @@ struct ConfigContainer {
   ConfigContainer &operator=(ConfigContainer &&)      = delete;
 
   std::unique_ptr<ApplicationInfo> applicationInfo;
+  std::unique_ptr<BenchmarkInfo> benchmarkInfo;
   std::unique_ptr<BrushInfo> brushInfo;
   std::unique_ptr<CameraInfo> cameraInfo;
   std::unique_ptr<ImguiManagerInfo> imguiManagerInfo;
   std::unique_ptr<ShadowMapCameraInfo> shadowMapCameraInfo;
   std::unique_ptr<TerrainInfo> terrainInfo;
+  std::unique_ptr<SvoBuilderInfo> svoBuilderInfo;
   std::unique_ptr<SvoTracerInfo> svoTracerInfo;
   std::unique_ptr<SvoTracerTweakingInfo> svoTracerTweakingInfo;
 
@@ -3,6 +3,17 @@
 #include "utils/toml-config/TomlConfigReader.hpp"
 
 void ApplicationInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
-  framesInFlight     = tomlConfigReader->getConfig<uint32_t>("Application.framesInFlight");
-  isFramerateLimited = tomlConfigReader->getConfig<bool>("Application.isFramerateLimited");
+  framesInFlight      = tomlConfigReader->getConfig<uint32_t>("Application.framesInFlight");
+  isFramerateLimited  = tomlConfigReader->getConfig<bool>("Application.isFramerateLimited");
+  targetFps           = tomlConfigReader->getConfig<uint32_t>("Application.targetFps");
+  isLowLatencyPresent = tomlConfigReader->getConfig<bool>("Application.isLowLatencyPresent");
+  isHeadless          = tomlConfigReader->getConfig<bool>("Application.isHeadless");
+  headlessResolution =
+      tomlConfigReader->getConfig<std::array<int, 2>>("Application.headlessResolution");
+  dumpHeadlessFrames = tomlConfigReader->getConfig<bool>("Application.dumpHeadlessFrames");
+  frameRecording     = tomlConfigReader->getConfig<bool>("Application.frameRecording");
+  isTransferQueueDedicated =
+      tomlConfigReader->getConfig<bool>("Application.isTransferQueueDedicated");
+  isDeviceGroupUsed = tomlConfigReader->getConfig<bool>("Application.isDeviceGroupUsed");
+  startupTraceFile  = tomlConfigReader->getConfig<std::string>("Application.startupTraceFile");
 }
@@ -1,10 +1,25 @@
 #pragma once
 
+#include <array>
+#include <string>
+
 class TomlConfigReader;
 
 struct ApplicationInfo {
   int framesInFlight{};
   bool isFramerateLimited{};
+  // zero leaves the frames unpaced
+  uint32_t targetFps{};
+  bool isLowLatencyPresent{};
+  bool isHeadless{};
+  std::array<int, 2> headlessResolution{};
+  bool dumpHeadlessFrames{};
+  // the windowed frames are read back like the headless ones, and written while recording
+  bool frameRecording{};
+  bool isTransferQueueDedicated{};
+  bool isDeviceGroupUsed{};
+  // the chrome trace of the startup phases, in the profiles folder, empty to skip it
+  std::string startupTraceFile{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
@@ -0,0 +1,16 @@
+#include "BenchmarkInfo.hpp"
+
+#include "utils/toml-config/TomlConfigReader.hpp"
+
+void BenchmarkInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
+  enabled         = tomlConfigReader->getConfig<bool>("Benchmark.enabled");
+  fixedTimeStepMs = tomlConfigReader->getConfig<float>("Benchmark.fixedTimeStepMs");
+  csvFile         = tomlConfigReader->getConfig<std::string>("Benchmark.csvFile");
+  keyframes = tomlConfigReader->getConfigArray<std::array<float, 6>>("Benchmark.keyframes");
+  traversalRayCount   = tomlConfigReader->getConfig<uint32_t>("Benchmark.traversalRayCount");
+  traversalBatchCount = tomlConfigReader->getConfig<uint32_t>("Benchmark.traversalBatchCount");
+  recordEditSessionFile =
+      tomlConfigReader->getConfig<std::string>("Benchmark.recordEditSessionFile");
+  replayEditSessionFile =
+      tomlConfigReader->getConfig<std::string>("Benchmark.replayEditSessionFile");
+}
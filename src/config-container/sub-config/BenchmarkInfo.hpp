@@ -0,0 +1,22 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class TomlConfigReader;
+
+struct BenchmarkInfo {
+  bool enabled{};
+  float fixedTimeStepMs{};
+  std::string csvFile{};
+  // each one is the time in seconds, the position, the yaw and the pitch in euler angles
+  std::vector<std::array<float, 6>> keyframes{};
+  uint32_t traversalRayCount{};
+  uint32_t traversalBatchCount{};
+  std::string recordEditSessionFile{};
+  std::string replayEditSessionFile{};
+
+  void loadConfig(TomlConfigReader *tomlConfigReader);
+};
@@ -3,6 +3,9 @@
 #include "utils/toml-config/TomlConfigReader.hpp"
 
 void ImguiManagerInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
+  enabled = tomlConfigReader->getConfig<bool>("ImguiManager.enabled");
+  overlayRefreshIntervalMs =
+      tomlConfigReader->getConfig<float>("ImguiManager.overlayRefreshIntervalMs");
   fontSize       = tomlConfigReader->getConfig<float>("ImguiManager.fontSize");
   auto const &gc = tomlConfigReader->getConfig<std::array<int, 3>>("ImguiManager.fpsGuiColor");
   fpsGuiColor    = Color(gc.at(0), gc.at(1), gc.at(2));
@@ -5,6 +5,9 @@
 class TomlConfigReader;
 
 struct ImguiManagerInfo {
+  bool enabled;
+  // the throttled redraw of the overlay, while the gui isn't interacted with
+  float overlayRefreshIntervalMs;
   float fontSize;
   Color fpsGuiColor;
   Color menuBarBackgroundColor;
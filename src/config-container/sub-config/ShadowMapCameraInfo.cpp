@@ -3,5 +3,6 @@
 #include "utils/toml-config/TomlConfigReader.hpp"
 
 void ShadowMapCameraInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
-  range = tomlConfigReader->getConfig<float>("ShadowMapCamera.range");
+  range        = tomlConfigReader->getConfig<float>("ShadowMapCamera.range");
+  snapDistance = tomlConfigReader->getConfig<float>("ShadowMapCamera.snapDistance");
 }
@@ -4,6 +4,7 @@ class TomlConfigReader;
 
 struct ShadowMapCameraInfo {
   float range{};
+  float snapDistance{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
@@ -0,0 +1,45 @@
+#include "SvoBuilderInfo.hpp"
+
+#include "utils/toml-config/TomlConfigReader.hpp"
+
+void SvoBuilderInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
+  chunkBuildSlotCount = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.chunkBuildSlotCount");
+  editBatchIntervalMs = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.editBatchIntervalMs");
+  editPreviewLod      = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.editPreviewLod");
+  maxPendingEditBatches =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.maxPendingEditBatches");
+  octreeCompactionBudgetKb =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.octreeCompactionBudgetKb");
+  octreePageSizeMb = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.octreePageSizeMb");
+  octreePoolBudgetMb = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.octreePoolBudgetMb");
+  fieldBrickPoolSizeMb = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.fieldBrickPoolSizeMb");
+  fieldBrickResidentBudgetMb =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.fieldBrickResidentBudgetMb");
+  editJournalBudgetMb = tomlConfigReader->getConfig<uint32_t>("SvoBuilder.editJournalBudgetMb");
+  useChunkOctreeCache = tomlConfigReader->getConfig<bool>("SvoBuilder.useChunkOctreeCache");
+  deduplicateChunkOctrees =
+      tomlConfigReader->getConfig<bool>("SvoBuilder.deduplicateChunkOctrees");
+  reorderChunkOctrees = tomlConfigReader->getConfig<bool>("SvoBuilder.reorderChunkOctrees");
+  bottomUpOctreeBuild = tomlConfigReader->getConfig<bool>("SvoBuilder.bottomUpOctreeBuild");
+  batchedFieldConstruction =
+      tomlConfigReader->getConfig<bool>("SvoBuilder.batchedFieldConstruction");
+  chunkBuildProfileCsvFile =
+      tomlConfigReader->getConfig<std::string>("SvoBuilder.chunkBuildProfileCsvFile");
+  allocationTraceFile = tomlConfigReader->getConfig<std::string>("SvoBuilder.allocationTraceFile");
+  voxSceneFile = tomlConfigReader->getConfig<std::string>("SvoBuilder.voxSceneFile");
+  worldName    = tomlConfigReader->getConfig<std::string>("SvoBuilder.worldName");
+  voxPrefabMinInstanceCount =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.voxPrefabMinInstanceCount");
+  worldSaveIntervalSec =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.worldSaveIntervalSec");
+  chunkLodDistances =
+      tomlConfigReader->getConfig<std::array<uint32_t, 3>>("SvoBuilder.chunkLodDistances");
+  streamingLookaheadSec =
+      tomlConfigReader->getConfig<float>("SvoBuilder.streamingLookaheadSec");
+  streamingFrameBudgetMs =
+      tomlConfigReader->getConfig<float>("SvoBuilder.streamingFrameBudgetMs");
+  dynamicObjectGridCapacity =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.dynamicObjectGridCapacity");
+  dynamicObjectDemoCount =
+      tomlConfigReader->getConfig<uint32_t>("SvoBuilder.dynamicObjectDemoCount");
+}
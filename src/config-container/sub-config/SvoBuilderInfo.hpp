@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+class TomlConfigReader;
+
+struct SvoBuilderInfo {
+  uint32_t chunkBuildSlotCount{};
+  uint32_t editBatchIntervalMs{};
+  uint32_t maxPendingEditBatches{};
+  // the level of detail of the coarse build that goes ahead of every edit, 0 disables it
+  uint32_t editPreviewLod{};
+  uint32_t octreeCompactionBudgetKb{};
+  uint32_t octreePageSizeMb{};
+  uint32_t octreePoolBudgetMb{};
+  uint32_t fieldBrickPoolSizeMb{};
+  uint32_t fieldBrickResidentBudgetMb{};
+  uint32_t editJournalBudgetMb{};
+  bool useChunkOctreeCache{};
+  bool deduplicateChunkOctrees{};
+  bool reorderChunkOctrees{};
+  bool bottomUpOctreeBuild{};
+  bool batchedFieldConstruction{};
+  std::string chunkBuildProfileCsvFile{};
+  std::string allocationTraceFile{};
+  std::string voxSceneFile{};
+  // the models of the imported scene with at least this many instances are kept as prefabs, 0 bakes
+  // every instance into its chunks
+  uint32_t voxPrefabMinInstanceCount{};
+  std::string worldName{};
+  uint32_t worldSaveIntervalSec{};
+  // one distance per level of detail after the first one, in chunks
+  std::array<uint32_t, 3> chunkLodDistances{};
+  // how far ahead the streamed window is centred, along the velocity of the camera
+  float streamingLookaheadSec{};
+  // of the host time per frame, for the loaded chunks and the generated builds
+  float streamingFrameBudgetMs{};
+  // the listings of the dynamic objects in the top-level grid of a frame, one per chunk overlapped
+  uint32_t dynamicObjectGridCapacity{};
+  // the spheres of the dynamic object demo, 0 disables it
+  uint32_t dynamicObjectDemoCount{};
+
+  void loadConfig(TomlConfigReader *tomlConfigReader);
+};
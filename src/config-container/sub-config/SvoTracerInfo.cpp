@@ -2,10 +2,50 @@
 
 #include "utils/toml-config/TomlConfigReader.hpp"
 
+#include <algorithm>
+
 void SvoTracerInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
   aTrousSizeMax         = tomlConfigReader->getConfig<uint32_t>("SvoTracer.aTrousSizeMax");
   beamResolution        = tomlConfigReader->getConfig<uint32_t>("SvoTracer.beamResolution");
+  beamLevelCount        = tomlConfigReader->getConfig<uint32_t>("SvoTracer.beamLevelCount");
   taaSamplingOffsetSize = tomlConfigReader->getConfig<uint32_t>("SvoTracer.taaSamplingOffsetSize");
   shadowMapResolution   = tomlConfigReader->getConfig<uint32_t>("SvoTracer.shadowMapResolution");
   upscaleRatio          = tomlConfigReader->getConfig<float>("SvoTracer.upscaleRatio");
+  dynamicResolution     = tomlConfigReader->getConfig<bool>("SvoTracer.dynamicResolution");
+  targetFrameTimeMs     = tomlConfigReader->getConfig<float>("SvoTracer.targetFrameTimeMs");
+  minRenderScale        = tomlConfigReader->getConfig<float>("SvoTracer.minRenderScale");
+  passProfileCsvFile =
+      tomlConfigReader->getConfig<std::string>("SvoTracer.passProfileCsvFile");
+  shortStackSize    = tomlConfigReader->getConfig<uint32_t>("SvoTracer.shortStackSize");
+  positionFromDepth = tomlConfigReader->getConfig<bool>("SvoTracer.positionFromDepth");
+  aTrousFused       = tomlConfigReader->getConfig<bool>("SvoTracer.aTrousFused");
+  // the fused iterations filter whole tiles with their aprons, which leaves nothing to compact
+  aTrousAdaptive =
+      tomlConfigReader->getConfig<bool>("SvoTracer.aTrousAdaptive") && !aTrousFused;
+  adaptiveSampling  = tomlConfigReader->getConfig<bool>("SvoTracer.adaptiveSampling");
+  depthReprojection = tomlConfigReader->getConfig<bool>("SvoTracer.depthReprojection");
+  renderTargetSizeClass =
+      tomlConfigReader->getConfig<uint32_t>("SvoTracer.renderTargetSizeClass");
+  recordEveryFrame = tomlConfigReader->getConfig<bool>("SvoTracer.recordEveryFrame");
+  radianceCacheSizeLog2 =
+      tomlConfigReader->getConfig<uint32_t>("SvoTracer.radianceCacheSizeLog2");
+  radianceCacheUpdateInterval =
+      tomlConfigReader->getConfig<uint32_t>("SvoTracer.radianceCacheUpdateInterval");
+  godRayDownscale =
+      std::max(tomlConfigReader->getConfig<uint32_t>("SvoTracer.godRayDownscale"), 1U);
+  // the patterns of the shaders only take 1, 2 and 4
+  uint32_t const interleave =
+      tomlConfigReader->getConfig<uint32_t>("SvoTracer.tracingInterleave");
+  tracingInterleave = interleave >= 4 ? 4 : (interleave >= 2 ? 2 : 1);
+  octreeDeviceAddress = tomlConfigReader->getConfig<bool>("SvoTracer.octreeDeviceAddress");
+  // the pages are read through one of the two paths
+  octreeTexelBuffer =
+      tomlConfigReader->getConfig<bool>("SvoTracer.octreeTexelBuffer") && !octreeDeviceAddress;
+  halfPrecisionFilters = tomlConfigReader->getConfig<bool>("SvoTracer.halfPrecisionFilters");
+  captureResolution =
+      std::max(tomlConfigReader->getConfig<uint32_t>("SvoTracer.captureResolution"), 1U);
+  captureViewCapacity =
+      std::max(tomlConfigReader->getConfig<uint32_t>("SvoTracer.captureViewCapacity"), 1U);
+  captureSampleCount =
+      std::max(tomlConfigReader->getConfig<uint32_t>("SvoTracer.captureSampleCount"), 1U);
 }
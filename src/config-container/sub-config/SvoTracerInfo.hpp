@@ -1,15 +1,61 @@
 #pragma once
 
 #include <cstdint>
+#include <string>
 
 class TomlConfigReader;
 
 struct SvoTracerInfo {
   uint32_t aTrousSizeMax{};
   uint32_t beamResolution{};
+  // the levels of the coarse beams, the resolution doubles with each level above the finest one
+  uint32_t beamLevelCount{};
+  // the primary rays start near the voxels that the last frame hit, where they're reprojected well
+  bool depthReprojection{};
   uint32_t taaSamplingOffsetSize{};
   uint32_t shadowMapResolution{};
   float upscaleRatio{};
+  bool dynamicResolution{};
+  float targetFrameTimeMs{};
+  float minRenderScale{};
+  std::string passProfileCsvFile{};
+  // the entries of the octree traversal stack that are kept, 0 keeps all of them
+  uint32_t shortStackSize{};
+  // the positions are reconstructed from the depth, instead of being stored in the g-buffer
+  bool positionFromDepth{};
+  // the first a-trous iterations are fused into a dispatch that filters tiles in shared memory
+  bool aTrousFused{};
+  // the temporal filter queues every tile for the a-trous iterations that its noise needs, off with
+  // aTrousFused
+  bool aTrousAdaptive{};
+  // the converged tiles of a still frame skip their shadow and indirect rays
+  bool adaptiveSampling{};
+  // the render targets are allocated in steps of this many pixels per axis, a resize within them
+  // only changes the rendered part
+  uint32_t renderTargetSizeClass{};
+  // the command buffers of a frame are recorded before each submission, with the needed passes only
+  bool recordEveryFrame{};
+  // the radiance cache has 2^radianceCacheSizeLog2 entries
+  uint32_t radianceCacheSizeLog2{};
+  // a pixel updates the radiance cache once every this many frames
+  uint32_t radianceCacheUpdateInterval{};
+  // the god rays are gathered for every godRayDownscale low res pixels per axis, at least 1
+  uint32_t godRayDownscale{};
+  // one of every tracingInterleave pixels samples its shadow and indirect rays per frame, 1, 2 or 4
+  uint32_t tracingInterleave{};
+  // the tracer reads the octree pages through texel buffer views instead of storage buffers
+  bool octreeTexelBuffer{};
+  // the tracer reads the octree pages through their buffer device addresses, which it looks up in
+  // a table of the builder, it takes precedence over the texel buffers
+  bool octreeDeviceAddress{};
+  // the weights and the blending of the denoising filters and the taa are computed in 16 bits, if
+  // the device supports it
+  bool halfPrecisionFilters{};
+  // the captures render batches of views into the layers of an array image of captureResolution^2
+  // texels, captureViewCapacity layers, with captureSampleCount samples of lighting per texel
+  uint32_t captureResolution{};
+  uint32_t captureViewCapacity{};
+  uint32_t captureSampleCount{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
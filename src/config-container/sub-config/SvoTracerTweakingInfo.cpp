@@ -10,13 +10,29 @@ void SvoTracerTweakingInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
       tomlConfigReader->getConfig<std::array<float, 3>>("SvoTracerTweakingData.debugC1");
   debugC1 = glm::vec3(dc1.at(0), dc1.at(1), dc1.at(2));
 
-  explosure = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.explosure");
+  explosure      = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.explosure");
+  fusedPostChain = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.fusedPostChain");
 
   visualizeChunks  = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.visualizeChunks");
   visualizeOctree  = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.visualizeOctree");
   beamOptimization = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.beamOptimization");
   traceIndirectRay = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.traceIndirectRay");
+  packetTraversal  = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.packetTraversal");
   taa              = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.taa");
+  useRayQuery      = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.useRayQuery");
+  wavefrontTracing = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.wavefrontTracing");
+  wavefrontRayBinning =
+      tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.wavefrontRayBinning");
+
+  shadowResampling = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.shadowResampling");
+  shadowResamplingCheckerboard =
+      tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.shadowResamplingCheckerboard");
+  shadowMapVisibility =
+      tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.shadowMapVisibility");
+  radianceCache = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.radianceCache");
+  traversalStatistics =
+      tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.traversalStatistics");
+  indirectSkySh = tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.indirectSkySh");
 
   sunAltitude     = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.sunAltitude");
   sunAzimuth      = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.sunAzimuth");
@@ -35,6 +51,10 @@ void SvoTracerTweakingInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
   temporalAlpha = tomlConfigReader->getConfig<float>("SvoTracerTweakingData.temporalAlpha");
   temporalPositionPhi =
       tomlConfigReader->getConfig<float>("SvoTracerTweakingData.temporalPositionPhi");
+  convergedSampleCount =
+      tomlConfigReader->getConfig<float>("SvoTracerTweakingData.convergedSampleCount");
+  convergedNoiseTolerance =
+      tomlConfigReader->getConfig<float>("SvoTracerTweakingData.convergedNoiseTolerance");
 
   aTrousIterationCount =
       tomlConfigReader->getConfig<int>("SvoTracerTweakingData.aTrousIterationCount");
@@ -47,4 +67,6 @@ void SvoTracerTweakingInfo::loadConfig(TomlConfigReader *tomlConfigReader) {
       tomlConfigReader->getConfig<float>("SvoTracerTweakingData.phiZStableSampleCount");
   changingLuminancePhi =
       tomlConfigReader->getConfig<bool>("SvoTracerTweakingData.changingLuminancePhi");
+  aTrousNoiseTolerance =
+      tomlConfigReader->getConfig<float>("SvoTracerTweakingData.aTrousNoiseTolerance");
 }
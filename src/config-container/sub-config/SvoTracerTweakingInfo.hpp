@@ -2,8 +2,22 @@
 
 #include "glm/glm.hpp" // IWYU pragma: export
 
+#include <cstdint>
+
 class TomlConfigReader;
 
+// the parameters of a group are uploaded to the same uniform buffer, which is only written again
+// when one of them is edited
+enum TweakingGroup : uint32_t {
+  // the atmosphere and the sun
+  kEnvironmentGroup = 1U,
+  // the debug, tracing and post processing toggles
+  kTracingGroup        = 2U,
+  kTemporalFilterGroup = 4U,
+  kSpatialFilterGroup  = 8U,
+  kAllTweakingGroups   = 15U,
+};
+
 struct SvoTracerTweakingInfo {
   // debug parameters
   bool debugB1{};
@@ -12,13 +26,41 @@ struct SvoTracerTweakingInfo {
   glm::vec3 debugC1{};
 
   float explosure{};
+  // the blit, the taa upscaling and the post processing are done by a single dispatch
+  bool fusedPostChain{};
 
   // tweakable parameters
   bool visualizeChunks{};
   bool visualizeOctree{};
   bool beamOptimization{};
   bool traceIndirectRay{};
+  // the lanes of the primary rays and of the coarse beams share their chunk and node fetches while
+  // their rays agree on them
+  bool packetTraversal{};
   bool taa{};
+  // only takes effect if the device supports ray queries
+  bool useRayQuery{};
+  // traces the surface rays in their own kernels over compacted queues, instead of the megakernel
+  bool wavefrontTracing{};
+  // sorts the indirect rays of the wavefront tracing by their start chunk and direction
+  bool wavefrontRayBinning{};
+  // reuses the shadow ray samples of the last frame and of the neighbouring pixels, ignored by the
+  // wavefront tracing
+  bool shadowResampling{};
+  // the pixels with a history only trace a fresh shadow ray every other frame
+  bool shadowResamplingCheckerboard{};
+  // the sun visibility of the primary hits is read from the shadow map where it's unambiguous,
+  // ignored by the wavefront tracing
+  bool shadowMapVisibility{};
+  // the indirect rays end at the cached radiance of the voxels they hit, ignored by the wavefront
+  // tracing
+  bool radianceCache{};
+  // histograms of the iterations and of the traversed chunks of the rays, per ray type, read back
+  // every frame for the gui and the benchmark
+  bool traversalStatistics{};
+  // the sky of the indirect misses is evaluated from a spherical harmonics projection of the sky
+  // view lut, instead of sampling it per ray
+  bool indirectSkySh{};
 
   // for env
   float sunAltitude{};
@@ -34,6 +76,9 @@ struct SvoTracerTweakingInfo {
   // for temporal filter info
   float temporalAlpha{};
   float temporalPositionPhi{};
+  // only with SvoTracer.adaptiveSampling
+  float convergedSampleCount{};
+  float convergedNoiseTolerance{};
 
   // for spatial filter info
   int aTrousIterationCount{};
@@ -44,6 +89,8 @@ struct SvoTracerTweakingInfo {
   float maxPhiZ{};
   float phiZStableSampleCount{};
   bool changingLuminancePhi{};
+  // only with SvoTracer.aTrousAdaptive
+  float aTrousNoiseTolerance{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
@@ -9,6 +9,8 @@ class TomlConfigReader;
 struct TerrainInfo {
   uint32_t chunkVoxelDim{};
   glm::uvec3 chunksDim{};
+  bool streamChunks{};
+  uint32_t bakedNoiseOctaveCount{};
 
   void loadConfig(TomlConfigReader *tomlConfigReader);
 };
@@ -0,0 +1,103 @@
+#include "AllocationTrace.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace {
+char _getOpTag(AllocationTrace::OpType type) {
+  switch (type) {
+  case AllocationTrace::OpType::kAllocate:
+    return 'a';
+  case AllocationTrace::OpType::kDeallocate:
+    return 'f';
+  case AllocationTrace::OpType::kShrink:
+    return 's';
+  case AllocationTrace::OpType::kFreeAll:
+    return 'c';
+  }
+  return '?';
+}
+
+std::optional<AllocationTrace::OpType> _getOpType(char tag) {
+  switch (tag) {
+  case 'a':
+    return AllocationTrace::OpType::kAllocate;
+  case 'f':
+    return AllocationTrace::OpType::kDeallocate;
+  case 's':
+    return AllocationTrace::OpType::kShrink;
+  case 'c':
+    return AllocationTrace::OpType::kFreeAll;
+  default:
+    return std::nullopt;
+  }
+}
+} // namespace
+
+void AllocationTrace::recordAllocate(CustomMemoryAllocationResult const &result) {
+  uint32_t const allocationId            = _allocationCount++;
+  _offsetToAllocationId[result.offset()] = allocationId;
+  _ops.push_back({OpType::kAllocate, allocationId, result.size()});
+}
+
+void AllocationTrace::recordDeallocate(CustomMemoryAllocationResult const &result) {
+  auto const it = _offsetToAllocationId.find(result.offset());
+  if (it == _offsetToAllocationId.end()) {
+    return;
+  }
+  _ops.push_back({OpType::kDeallocate, it->second, 0});
+  _offsetToAllocationId.erase(it);
+}
+
+void AllocationTrace::recordShrink(CustomMemoryAllocationResult const &alloc, size_t newSize) {
+  auto const it = _offsetToAllocationId.find(alloc.offset());
+  if (it == _offsetToAllocationId.end()) {
+    return;
+  }
+  _ops.push_back({OpType::kShrink, it->second, newSize});
+}
+
+void AllocationTrace::recordFreeAll() {
+  _offsetToAllocationId.clear();
+  _ops.push_back({OpType::kFreeAll, 0, 0});
+}
+
+bool AllocationTrace::writeToFile(std::string const &pathToFile) const {
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path());
+  std::ofstream file(pathToFile);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file << "pool " << _poolSize << "\n";
+  for (auto const &op : _ops) {
+    file << _getOpTag(op.type) << " " << op.allocationId << " " << op.size << "\n";
+  }
+  return file.good();
+}
+
+std::optional<AllocationTrace> AllocationTrace::readFromFile(std::string const &pathToFile) {
+  std::ifstream file(pathToFile);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+
+  std::string header;
+  size_t poolSize = 0;
+  if (!(file >> header >> poolSize) || header != "pool") {
+    return std::nullopt;
+  }
+
+  AllocationTrace trace(poolSize);
+  char tag    = 0;
+  uint32_t id = 0;
+  size_t size = 0;
+  while (file >> tag >> id >> size) {
+    auto const type = _getOpType(tag);
+    if (!type.has_value()) {
+      return std::nullopt;
+    }
+    trace.addOp({type.value(), id, size});
+  }
+  return trace;
+}
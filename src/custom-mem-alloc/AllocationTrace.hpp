@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CustomMemoryAllocationResult.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// the operations on an allocator in the order they were made, so that a session can be replayed
+// against another strategy, the allocations are named by the order they were made in, since their
+// offsets differ between the strategies
+class AllocationTrace {
+public:
+  enum class OpType : uint8_t {
+    kAllocate,
+    kDeallocate,
+    kShrink,
+    kFreeAll,
+  };
+
+  struct Op {
+    OpType type;
+    uint32_t allocationId;
+    // the requested size of the allocations, the new size of the shrinks
+    size_t size;
+  };
+
+  explicit AllocationTrace(size_t poolSize) : _poolSize(poolSize) {}
+
+  void recordAllocate(CustomMemoryAllocationResult const &result);
+  // the deallocations of untraced allocations are skipped, e.g. the tails given back by a shrink
+  void recordDeallocate(CustomMemoryAllocationResult const &result);
+  void recordShrink(CustomMemoryAllocationResult const &alloc, size_t newSize);
+  void recordFreeAll();
+
+  // for the synthetic workloads, the ids are up to the caller
+  void addOp(Op const &op) { _ops.push_back(op); }
+
+  [[nodiscard]] size_t getPoolSize() const { return _poolSize; }
+  [[nodiscard]] std::vector<Op> const &getOps() const { return _ops; }
+
+  // one op per line, after a line with the pool size
+  bool writeToFile(std::string const &pathToFile) const;
+  static std::optional<AllocationTrace> readFromFile(std::string const &pathToFile);
+
+private:
+  size_t _poolSize;
+  std::vector<Op> _ops{};
+
+  std::unordered_map<size_t, uint32_t> _offsetToAllocationId{};
+  uint32_t _allocationCount = 0;
+};
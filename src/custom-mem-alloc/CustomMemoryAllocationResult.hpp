@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class CustomMemoryAllocationResult {
+public:
+  static uint32_t constexpr kInvalidBlockIndex = UINT32_MAX;
+
+  CustomMemoryAllocationResult() : _offset(0), _size(0) {}
+  CustomMemoryAllocationResult(size_t offset, size_t size, uint32_t blockIndex = kInvalidBlockIndex)
+      : _offset(offset), _size(size), _blockIndex(blockIndex) {}
+  size_t offset() const { return _offset; }
+  size_t size() const { return _size; }
+
+  // only used by the allocators that keep track of their blocks, so that they don't need to search
+  // for the block of an allocation
+  uint32_t blockIndex() const { return _blockIndex; }
+
+private:
+  size_t _offset;
+  size_t _size;
+  uint32_t _blockIndex = kInvalidBlockIndex;
+};
@@ -1,71 +1,58 @@
 #include "CustomMemoryAllocator.hpp"
 
+#include "AllocationTrace.hpp"
+#include "TlsfMemoryAllocator.hpp"
 #include "utils/logger/Logger.hpp"
 
+#include <algorithm>
 #include <cassert>
 
-#include <random>
-
-static size_t constexpr kMb = 1024 * 1024;
-
-CustomMemoryAllocator::CustomMemoryAllocator(Logger *logger, size_t poolSize)
-    : _logger(logger), _poolSize(poolSize), _firstFreeList(std::make_unique<FreeList>()) {
-  _firstFreeList->offset = 0;
-  _firstFreeList->size   = poolSize;
-
-  // uncomment this line to run the test
-  // _test();
+CustomMemoryAllocator::CustomMemoryAllocator(Logger *logger, size_t poolSize,
+                                             AllocationStrategy strategy)
+    : _logger(logger), _poolSize(poolSize), _strategy(strategy) {
+  if (_strategy == AllocationStrategy::kTlsf) {
+    _tlsfAllocator = std::make_unique<TlsfMemoryAllocator>(_logger, poolSize);
+  } else {
+    _firstFreeList         = std::make_unique<FreeList>();
+    _firstFreeList->offset = 0;
+    _firstFreeList->size   = poolSize;
+  }
 }
 
 CustomMemoryAllocator::~CustomMemoryAllocator() = default;
 
-void CustomMemoryAllocator::_test() {
-  _logger->info("Running test for CustomMemoryAllocator");
+void CustomMemoryAllocator::startTrace() { _trace = std::make_unique<AllocationTrace>(_poolSize); }
 
-  // create random device
-  std::random_device rd;
-  std::mt19937 gen(rd());
-
-  double constexpr kBufferLowerBound = 1.0;
-  double constexpr kBufferUpperBound = 3.0;
-  size_t constexpr kInitialChunkSize = 100;
-  double constexpr kBufferGrowSpeed  = 0.0001;
-
-  std::uniform_real_distribution<double> chunkBufferSizeDis(kBufferLowerBound, kBufferUpperBound);
-
-  // this is for selecting a random chunk
-  std::uniform_int_distribution<size_t> chunkSelectionDis(0, kInitialChunkSize - 1);
-
-  std::vector<CustomMemoryAllocationResult> chunks{};
-  for (int i = 0; i < kInitialChunkSize; ++i) {
-    size_t usingBufferSize = static_cast<size_t>(chunkBufferSizeDis(gen) * kMb);
-    chunks.push_back(allocate(usingBufferSize));
+CustomMemoryAllocationResult CustomMemoryAllocator::allocate(size_t size) {
+  CustomMemoryAllocationResult const result = _allocate(size);
+  if (_trace != nullptr) {
+    _trace->recordAllocate(result);
   }
+  return result;
+}
 
-  int constexpr kIt = 100000000;
-  for (int i = 0; i < kIt; ++i) {
-    size_t selectedChunk = chunkSelectionDis(gen);
-
-    CustomMemoryAllocationResult &chunk = chunks[selectedChunk];
-
-    double chunkSizeMb = static_cast<double>(chunk.size()) / kMb;
-    double bufferSize =
-        chunkSizeMb < kBufferUpperBound ? chunkSizeMb + kBufferGrowSpeed : chunkBufferSizeDis(gen);
-
-    deallocate(chunk);
-
-    size_t usingBufferSize = static_cast<size_t>(bufferSize * kMb);
-    chunk                  = allocate(usingBufferSize);
+std::optional<CustomMemoryAllocationResult>
+CustomMemoryAllocator::allocateBelow(size_t size, size_t offsetLimit) {
+  auto const result = _allocateBelow(size, offsetLimit);
+  if (_trace != nullptr && result.has_value()) {
+    _trace->recordAllocate(result.value());
   }
+  return result;
+}
 
-  printStats();
-
-  // quit the application
-  exit(0);
+void CustomMemoryAllocator::deallocate(CustomMemoryAllocationResult allocToBeFreed) {
+  if (_trace != nullptr) {
+    _trace->recordDeallocate(allocToBeFreed);
+  }
+  _deallocate(allocToBeFreed);
 }
 
 // allocate using first-fit algorithm
-CustomMemoryAllocationResult CustomMemoryAllocator::allocate(size_t size) {
+CustomMemoryAllocationResult CustomMemoryAllocator::_allocate(size_t size) {
+  if (_tlsfAllocator != nullptr) {
+    return _tlsfAllocator->allocate(size);
+  }
+
   FreeList *current = _firstFreeList.get();
   if (current == nullptr) {
     _logger->error("no free memory available, allocation failed");
@@ -92,23 +79,83 @@ CustomMemoryAllocationResult CustomMemoryAllocator::allocate(size_t size) {
   exit(0);
 }
 
-void CustomMemoryAllocator::deallocate(CustomMemoryAllocationResult allocToBeFreed) {
+std::optional<CustomMemoryAllocationResult>
+CustomMemoryAllocator::_allocateBelow(size_t size, size_t offsetLimit) {
+  if (_tlsfAllocator != nullptr) {
+    return _tlsfAllocator->allocateBelow(size, offsetLimit);
+  }
+
+  // the freelists are sorted by offset, so the first fitting one is the lowest
+  FreeList *current = _firstFreeList.get();
+  while (current != nullptr && current->offset + size <= offsetLimit) {
+    if (current->size >= size) {
+      size_t res = current->offset;
+      current->offset += size;
+      current->size -= size;
+      if (current->size == 0) {
+        _removeFreeList(current);
+      }
+      return CustomMemoryAllocationResult(res, size);
+    }
+    current = current->next.get();
+  }
+  return std::nullopt;
+}
+
+bool CustomMemoryAllocator::canAllocate(size_t size) const {
+  if (_tlsfAllocator != nullptr) {
+    return _tlsfAllocator->canAllocate(size);
+  }
+
+  FreeList *current = _firstFreeList.get();
+  while (current != nullptr) {
+    if (current->size >= size) {
+      return true;
+    }
+    current = current->next.get();
+  }
+  return false;
+}
+
+void CustomMemoryAllocator::_deallocate(CustomMemoryAllocationResult allocToBeFreed) {
+  if (_tlsfAllocator != nullptr) {
+    _tlsfAllocator->deallocate(allocToBeFreed);
+    return;
+  }
+
   FreeList *prev = nullptr;
   FreeList *next = _firstFreeList.get();
 
-  do {
-    if (allocToBeFreed.offset() < next->offset || next == nullptr) {
+  // the pool can be fully allocated, in which case there is no freelist to walk
+  while (next != nullptr) {
+    if (allocToBeFreed.offset() < next->offset) {
       _addFreeList(allocToBeFreed.offset(), allocToBeFreed.size(), prev, next);
       return;
     }
     prev = next;
     next = next->next.get();
-  } while (next != nullptr);
+  }
 
   // if the code reaches here, it means that the allocated memory is at the end of the pool
   _addFreeList(allocToBeFreed.offset(), allocToBeFreed.size(), prev, next);
 }
 
+CustomMemoryAllocationResult CustomMemoryAllocator::shrink(CustomMemoryAllocationResult alloc,
+                                                          size_t newSize) {
+  if (_trace != nullptr) {
+    _trace->recordShrink(alloc, newSize);
+  }
+  if (_tlsfAllocator != nullptr) {
+    return _tlsfAllocator->shrink(alloc, newSize);
+  }
+
+  assert(newSize <= alloc.size() && "shrink cannot grow an allocation");
+  if (newSize < alloc.size()) {
+    _deallocate(CustomMemoryAllocationResult(alloc.offset() + newSize, alloc.size() - newSize));
+  }
+  return CustomMemoryAllocationResult(alloc.offset(), newSize);
+}
+
 void CustomMemoryAllocator::_removeFreeList(FreeList *freeList) {
   FreeList *prev = freeList->prev;
   FreeList *next = freeList->next.get();
@@ -178,15 +225,27 @@ void CustomMemoryAllocator::_addFreeList(size_t offset, size_t size, FreeList *p
 }
 
 void CustomMemoryAllocator::freeAll() {
-  _firstFreeList         = std::make_unique<FreeList>();
-  _firstFreeList->offset = 0;
-  _firstFreeList->size   = _poolSize;
+  if (_trace != nullptr) {
+    _trace->recordFreeAll();
+  }
+  if (_tlsfAllocator != nullptr) {
+    _tlsfAllocator->freeAll();
+  } else {
+    _firstFreeList         = std::make_unique<FreeList>();
+    _firstFreeList->offset = 0;
+    _firstFreeList->size   = _poolSize;
+  }
   _logger->info("all memory has been freed");
 
   printStats();
 }
 
 void CustomMemoryAllocator::printStats() const {
+  if (_tlsfAllocator != nullptr) {
+    _tlsfAllocator->printStats();
+    return;
+  }
+
   FreeList *current = _firstFreeList.get();
   while (current != nullptr) {
     _logger->info("freeList: offset={}, size={}", current->offset, current->size);
@@ -203,3 +262,19 @@ void CustomMemoryAllocator::printStats() const {
   size_t constexpr kMb = 1024 * 1024;
   _logger->info("total free memory size: {} ({} mb)", totalSize, totalSize / kMb);
 }
+
+void CustomMemoryAllocator::getFreeStats(size_t &freeSize, size_t &largestFreeBlockSize) const {
+  if (_tlsfAllocator != nullptr) {
+    _tlsfAllocator->getFreeStats(freeSize, largestFreeBlockSize);
+    return;
+  }
+
+  freeSize             = 0;
+  largestFreeBlockSize = 0;
+  FreeList *current    = _firstFreeList.get();
+  while (current != nullptr) {
+    freeSize += current->size;
+    largestFreeBlockSize = std::max(largestFreeBlockSize, current->size);
+    current              = current->next.get();
+  }
+}
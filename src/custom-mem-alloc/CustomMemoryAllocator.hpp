@@ -1,6 +1,9 @@
 #pragma once
 
+#include "CustomMemoryAllocationResult.hpp"
+
 #include <memory>
+#include <optional>
 
 struct FreeList {
   FreeList *prev                 = nullptr;
@@ -9,23 +12,21 @@ struct FreeList {
   size_t size                    = 0;
 };
 
-class CustomMemoryAllocationResult {
-public:
-  CustomMemoryAllocationResult() : _offset(0), _size(0) {}
-  CustomMemoryAllocationResult(size_t offset, size_t size) : _offset(offset), _size(size) {}
-  size_t offset() const { return _offset; }
-  size_t size() const { return _size; }
-
-private:
-  size_t _offset;
-  size_t _size;
+// selects the algorithm behind the allocator, first-fit walks a list of the free blocks, tlsf finds
+// a free block in constant time with two-level segregated lists
+enum class AllocationStrategy {
+  kFirstFit,
+  kTlsf,
 };
 
 class Logger;
+class AllocationTrace;
+class TlsfMemoryAllocator;
 
 class CustomMemoryAllocator {
 public:
-  CustomMemoryAllocator(Logger *logger, size_t poolSize);
+  CustomMemoryAllocator(Logger *logger, size_t poolSize,
+                        AllocationStrategy strategy = AllocationStrategy::kFirstFit);
   ~CustomMemoryAllocator();
 
   // disable copy and move
@@ -34,24 +35,48 @@ public:
   CustomMemoryAllocator(CustomMemoryAllocator &&)                 = delete;
   CustomMemoryAllocator &operator=(CustomMemoryAllocator &&)      = delete;
 
-  // allocate memory from the pool using first-fit algorithm, returns the starting address (aka.
+  // allocate memory from the pool using the selected strategy, returns the starting address (aka.
   // offset) of the allocated memory
   CustomMemoryAllocationResult allocate(size_t size);
 
+  // allocate from the lowest free region that ends before the offset limit, compaction moves
+  // allocations this way, so it never fails, it returns nothing if there's no such region instead
+  std::optional<CustomMemoryAllocationResult> allocateBelow(size_t size, size_t offsetLimit);
+
+  // whether an allocation of this size would succeed, for allocations that are optional
+  [[nodiscard]] bool canAllocate(size_t size) const;
+
   // deallocate memory from the pool using the address of the allocated memory
   void deallocate(CustomMemoryAllocationResult allocToBeFreed);
 
+  // give the tail of an allocation back to the pool, used when the final size of a speculatively
+  // reserved allocation is known
+  CustomMemoryAllocationResult shrink(CustomMemoryAllocationResult alloc, size_t newSize);
+
   void freeAll();
 
   void printStats() const;
 
+  // the total free size, and the largest allocation that would fit, for the fragmentation
+  void getFreeStats(size_t &freeSize, size_t &largestFreeBlockSize) const;
+
+  // the operations from here on are recorded, for replaying them in the allocator benchmark
+  void startTrace();
+  // nullptr if the operations aren't recorded
+  [[nodiscard]] AllocationTrace const *getTrace() const { return _trace.get(); }
+
 private:
   Logger *_logger;
 
   size_t _poolSize;
+  AllocationStrategy _strategy;
   std::unique_ptr<FreeList> _firstFreeList = nullptr;
+  std::unique_ptr<TlsfMemoryAllocator> _tlsfAllocator;
+  std::unique_ptr<AllocationTrace> _trace;
 
-  void _test();
+  CustomMemoryAllocationResult _allocate(size_t size);
+  std::optional<CustomMemoryAllocationResult> _allocateBelow(size_t size, size_t offsetLimit);
+  void _deallocate(CustomMemoryAllocationResult allocToBeFreed);
 
   std::unique_ptr<FreeList> &_getUniquePtr(FreeList *freeList);
 
@@ -0,0 +1,309 @@
+#include "TlsfMemoryAllocator.hpp"
+
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+// index of the lowest set bit, the value must not be zero
+uint32_t _findFirstSet(uint32_t value) {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward(&index, value);
+  return static_cast<uint32_t>(index);
+#else
+  return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+
+// index of the highest set bit, the value must not be zero
+uint32_t _findLastSet(uint64_t value) {
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanReverse64(&index, value);
+  return static_cast<uint32_t>(index);
+#else
+  return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+}
+} // namespace
+
+TlsfMemoryAllocator::TlsfMemoryAllocator(Logger *logger, size_t poolSize)
+    : _logger(logger), _poolSize(poolSize / kAlignment * kAlignment) {
+  if (_poolSize >= (size_t{1} << kFirstLevelMaxLog2)) {
+    _logger->error("pool size {} is too large for the tlsf allocator", poolSize);
+    exit(0);
+  }
+
+  // most of the pools hold one allocation per chunk, this avoids growing the node array early on
+  size_t constexpr kInitialBlockCapacity = 1024;
+  _blocks.reserve(kInitialBlockCapacity);
+  freeAll();
+}
+
+TlsfMemoryAllocator::~TlsfMemoryAllocator() = default;
+
+size_t TlsfMemoryAllocator::_adjustSize(size_t size) {
+  return std::max((size + kAlignment - 1) / kAlignment * kAlignment, kAlignment);
+}
+
+void TlsfMemoryAllocator::_mapping(size_t size, uint32_t &firstLevel, uint32_t &secondLevel) {
+  if (size < kSmallBlockSize) {
+    firstLevel  = 0;
+    secondLevel = static_cast<uint32_t>(size / (kSmallBlockSize / kSecondLevelCount));
+    return;
+  }
+  uint32_t const lastSet = _findLastSet(size);
+  secondLevel = static_cast<uint32_t>(size >> (lastSet - kSecondLevelLog2)) ^ kSecondLevelCount;
+  firstLevel  = lastSet - (kFirstLevelShift - 1);
+}
+
+void TlsfMemoryAllocator::_mappingSearch(size_t size, uint32_t &firstLevel,
+                                         uint32_t &secondLevel) {
+  // round up to the next bin, so that any block of the found bin fits
+  if (size >= kSmallBlockSize) {
+    size += (size_t{1} << (_findLastSet(size) - kSecondLevelLog2)) - 1;
+  }
+  _mapping(size, firstLevel, secondLevel);
+}
+
+uint32_t TlsfMemoryAllocator::_findSuitableBlock(uint32_t firstLevel, uint32_t secondLevel) const {
+  if (firstLevel >= kFirstLevelCount) {
+    return kNullBlock;
+  }
+
+  uint32_t secondLevelMap = _secondLevelBitmaps[firstLevel] & (~0U << secondLevel);
+  if (secondLevelMap == 0) {
+    // no bin of this class is large enough, take the smallest of the larger classes
+    uint32_t const firstLevelMap =
+        firstLevel + 1 < 32 ? _firstLevelBitmap & (~0U << (firstLevel + 1)) : 0;
+    if (firstLevelMap == 0) {
+      return kNullBlock;
+    }
+    firstLevel     = _findFirstSet(firstLevelMap);
+    secondLevelMap = _secondLevelBitmaps[firstLevel];
+  }
+  secondLevel = _findFirstSet(secondLevelMap);
+  return _freeListHeads[firstLevel][secondLevel];
+}
+
+uint32_t TlsfMemoryAllocator::_createBlock(size_t offset, size_t size) {
+  uint32_t blockIndex = 0;
+  if (_unusedBlockIndices.empty()) {
+    blockIndex = static_cast<uint32_t>(_blocks.size());
+    _blocks.emplace_back();
+  } else {
+    blockIndex = _unusedBlockIndices.back();
+    _unusedBlockIndices.pop_back();
+    _blocks[blockIndex] = Block{};
+  }
+  _blocks[blockIndex].offset = offset;
+  _blocks[blockIndex].size   = size;
+  return blockIndex;
+}
+
+void TlsfMemoryAllocator::_destroyBlock(uint32_t blockIndex) {
+  _unusedBlockIndices.push_back(blockIndex);
+}
+
+void TlsfMemoryAllocator::_insertFreeBlock(uint32_t blockIndex) {
+  uint32_t firstLevel  = 0;
+  uint32_t secondLevel = 0;
+  _mapping(_blocks[blockIndex].size, firstLevel, secondLevel);
+
+  uint32_t const head          = _freeListHeads[firstLevel][secondLevel];
+  _blocks[blockIndex].isFree   = true;
+  _blocks[blockIndex].prevFree = kNullBlock;
+  _blocks[blockIndex].nextFree = head;
+  if (head != kNullBlock) {
+    _blocks[head].prevFree = blockIndex;
+  }
+  _freeListHeads[firstLevel][secondLevel] = blockIndex;
+
+  _firstLevelBitmap |= 1U << firstLevel;
+  _secondLevelBitmaps[firstLevel] |= 1U << secondLevel;
+}
+
+void TlsfMemoryAllocator::_removeFreeBlock(uint32_t blockIndex) {
+  uint32_t firstLevel  = 0;
+  uint32_t secondLevel = 0;
+  _mapping(_blocks[blockIndex].size, firstLevel, secondLevel);
+
+  uint32_t const prev = _blocks[blockIndex].prevFree;
+  uint32_t const next = _blocks[blockIndex].nextFree;
+  if (next != kNullBlock) {
+    _blocks[next].prevFree = prev;
+  }
+  if (prev != kNullBlock) {
+    _blocks[prev].nextFree = next;
+  } else {
+    _freeListHeads[firstLevel][secondLevel] = next;
+    // the bin is empty now
+    if (next == kNullBlock) {
+      _secondLevelBitmaps[firstLevel] &= ~(1U << secondLevel);
+      if (_secondLevelBitmaps[firstLevel] == 0) {
+        _firstLevelBitmap &= ~(1U << firstLevel);
+      }
+    }
+  }
+  _blocks[blockIndex].isFree = false;
+}
+
+uint32_t TlsfMemoryAllocator::_mergeWithNeighbours(uint32_t blockIndex) {
+  uint32_t const prev = _blocks[blockIndex].prevPhysical;
+  if (prev != kNullBlock && _blocks[prev].isFree) {
+    _removeFreeBlock(prev);
+    uint32_t const next = _blocks[blockIndex].nextPhysical;
+    _blocks[prev].size += _blocks[blockIndex].size;
+    _blocks[prev].nextPhysical = next;
+    if (next != kNullBlock) {
+      _blocks[next].prevPhysical = prev;
+    }
+    _destroyBlock(blockIndex);
+    blockIndex = prev;
+  }
+
+  uint32_t const next = _blocks[blockIndex].nextPhysical;
+  if (next != kNullBlock && _blocks[next].isFree) {
+    _removeFreeBlock(next);
+    uint32_t const nextOfNext = _blocks[next].nextPhysical;
+    _blocks[blockIndex].size += _blocks[next].size;
+    _blocks[blockIndex].nextPhysical = nextOfNext;
+    if (nextOfNext != kNullBlock) {
+      _blocks[nextOfNext].prevPhysical = blockIndex;
+    }
+    _destroyBlock(next);
+  }
+  return blockIndex;
+}
+
+void TlsfMemoryAllocator::_trimUsedBlock(uint32_t blockIndex, size_t size) {
+  // both sizes are aligned, so any remainder can form a block on its own
+  if (_blocks[blockIndex].size <= size) {
+    return;
+  }
+
+  uint32_t const remainder =
+      _createBlock(_blocks[blockIndex].offset + size, _blocks[blockIndex].size - size);
+  uint32_t const next             = _blocks[blockIndex].nextPhysical;
+  _blocks[remainder].prevPhysical = blockIndex;
+  _blocks[remainder].nextPhysical = next;
+  _blocks[remainder].isFree       = true;
+  if (next != kNullBlock) {
+    _blocks[next].prevPhysical = remainder;
+  }
+  _blocks[blockIndex].nextPhysical = remainder;
+  _blocks[blockIndex].size         = size;
+
+  _insertFreeBlock(_mergeWithNeighbours(remainder));
+}
+
+CustomMemoryAllocationResult TlsfMemoryAllocator::allocate(size_t size) {
+  size_t const adjustedSize = _adjustSize(size);
+
+  uint32_t firstLevel  = 0;
+  uint32_t secondLevel = 0;
+  _mappingSearch(adjustedSize, firstLevel, secondLevel);
+  uint32_t const blockIndex = _findSuitableBlock(firstLevel, secondLevel);
+  if (blockIndex == kNullBlock) {
+    _logger->error("no free memory available, allocation failed");
+    exit(0);
+  }
+
+  _removeFreeBlock(blockIndex);
+  _trimUsedBlock(blockIndex, adjustedSize);
+  return {_blocks[blockIndex].offset, size, blockIndex};
+}
+
+std::optional<CustomMemoryAllocationResult>
+TlsfMemoryAllocator::allocateBelow(size_t size, size_t offsetLimit) {
+  size_t const adjustedSize = _adjustSize(size);
+
+  // the block at offset 0 is never merged into another one, so it is always the first node
+  for (uint32_t i = 0; i != kNullBlock && _blocks[i].offset + adjustedSize <= offsetLimit;
+       i = _blocks[i].nextPhysical) {
+    if (_blocks[i].isFree && _blocks[i].size >= adjustedSize) {
+      _removeFreeBlock(i);
+      _trimUsedBlock(i, adjustedSize);
+      return CustomMemoryAllocationResult(_blocks[i].offset, size, i);
+    }
+  }
+  return std::nullopt;
+}
+
+bool TlsfMemoryAllocator::canAllocate(size_t size) const {
+  uint32_t firstLevel  = 0;
+  uint32_t secondLevel = 0;
+  _mappingSearch(_adjustSize(size), firstLevel, secondLevel);
+  return _findSuitableBlock(firstLevel, secondLevel) != kNullBlock;
+}
+
+void TlsfMemoryAllocator::deallocate(CustomMemoryAllocationResult allocToBeFreed) {
+  uint32_t const blockIndex = allocToBeFreed.blockIndex();
+  if (blockIndex >= _blocks.size() || _blocks[blockIndex].isFree ||
+      _blocks[blockIndex].offset != allocToBeFreed.offset()) {
+    _logger->error("the allocation at offset {} is not owned by the tlsf allocator",
+                   allocToBeFreed.offset());
+    exit(0);
+  }
+
+  _blocks[blockIndex].isFree = true;
+  _insertFreeBlock(_mergeWithNeighbours(blockIndex));
+}
+
+CustomMemoryAllocationResult TlsfMemoryAllocator::shrink(CustomMemoryAllocationResult alloc,
+                                                        size_t newSize) {
+  assert(newSize <= alloc.size() && "shrink cannot grow an allocation");
+  _trimUsedBlock(alloc.blockIndex(), _adjustSize(newSize));
+  return {alloc.offset(), newSize, alloc.blockIndex()};
+}
+
+void TlsfMemoryAllocator::freeAll() {
+  _blocks.clear();
+  _unusedBlockIndices.clear();
+
+  _firstLevelBitmap = 0;
+  std::fill(std::begin(_secondLevelBitmaps), std::end(_secondLevelBitmaps), 0);
+  for (auto &heads : _freeListHeads) {
+    std::fill(std::begin(heads), std::end(heads), kNullBlock);
+  }
+
+  _insertFreeBlock(_createBlock(0, _poolSize));
+}
+
+void TlsfMemoryAllocator::printStats() const {
+  // the block at offset 0 is never merged into another one, so it is always the first node
+  size_t totalSize   = 0;
+  size_t largestSize = 0;
+  size_t blockCount  = 0;
+  for (uint32_t i = 0; i != kNullBlock; i = _blocks[i].nextPhysical) {
+    ++blockCount;
+    if (!_blocks[i].isFree) {
+      continue;
+    }
+    _logger->info("freeList: offset={}, size={}", _blocks[i].offset, _blocks[i].size);
+    totalSize += _blocks[i].size;
+    largestSize = std::max(largestSize, _blocks[i].size);
+  }
+
+  size_t constexpr kMb = 1024 * 1024;
+  _logger->info("total free memory size: {} ({} mb), largest free block: {} ({} mb), {} blocks",
+                totalSize, totalSize / kMb, largestSize, largestSize / kMb, blockCount);
+}
+
+// mirrors printStats
+void TlsfMemoryAllocator::getFreeStats(size_t &freeSize, size_t &largestFreeBlockSize) const {
+  freeSize             = 0;
+  largestFreeBlockSize = 0;
+  for (uint32_t i = 0; i != kNullBlock; i = _blocks[i].nextPhysical) {
+    if (_blocks[i].isFree) {
+      freeSize += _blocks[i].size;
+      largestFreeBlockSize = std::max(largestFreeBlockSize, _blocks[i].size);
+    }
+  }
+}
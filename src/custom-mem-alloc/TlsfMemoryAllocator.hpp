@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CustomMemoryAllocationResult.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+class Logger;
+
+// two-level segregated fit allocator, the free blocks are binned by a coarse power of two class and
+// a linear subdivision of it, both levels have a bitmap of the non-empty bins, so that finding a
+// suitable free block and coalescing on deallocation both take constant time
+// the pool memory lives on the gpu, so the block headers are kept in a pooled node array instead,
+// the allocation result carries the index of its block
+class TlsfMemoryAllocator {
+public:
+  TlsfMemoryAllocator(Logger *logger, size_t poolSize);
+  ~TlsfMemoryAllocator();
+
+  // disable copy and move
+  TlsfMemoryAllocator(const TlsfMemoryAllocator &)            = delete;
+  TlsfMemoryAllocator &operator=(const TlsfMemoryAllocator &) = delete;
+  TlsfMemoryAllocator(TlsfMemoryAllocator &&)                 = delete;
+  TlsfMemoryAllocator &operator=(TlsfMemoryAllocator &&)      = delete;
+
+  CustomMemoryAllocationResult allocate(size_t size);
+  // walks the blocks in address order, so it's linear in the block count, unlike the other calls
+  std::optional<CustomMemoryAllocationResult> allocateBelow(size_t size, size_t offsetLimit);
+  [[nodiscard]] bool canAllocate(size_t size) const;
+  void deallocate(CustomMemoryAllocationResult allocToBeFreed);
+  CustomMemoryAllocationResult shrink(CustomMemoryAllocationResult alloc, size_t newSize);
+
+  void freeAll();
+
+  void printStats() const;
+  void getFreeStats(size_t &freeSize, size_t &largestFreeBlockSize) const;
+
+private:
+  static uint32_t constexpr kNullBlock = UINT32_MAX;
+
+  // block sizes are multiples of the alignment, so offsets keep the alignment of the entries
+  static uint32_t constexpr kAlignmentLog2     = 4;
+  static size_t constexpr kAlignment           = size_t{1} << kAlignmentLog2;
+  static uint32_t constexpr kSecondLevelLog2   = 5;
+  static uint32_t constexpr kSecondLevelCount  = 1U << kSecondLevelLog2;
+  static uint32_t constexpr kFirstLevelShift   = kSecondLevelLog2 + kAlignmentLog2;
+  static uint32_t constexpr kFirstLevelMaxLog2 = 40;
+  static uint32_t constexpr kFirstLevelCount   = kFirstLevelMaxLog2 - kFirstLevelShift + 1;
+  // blocks below this size are binned linearly in the first class
+  static size_t constexpr kSmallBlockSize = size_t{1} << kFirstLevelShift;
+
+  struct Block {
+    size_t offset = 0;
+    size_t size   = 0;
+    bool isFree   = false;
+    // neighbours in the pool memory, for coalescing
+    uint32_t prevPhysical = kNullBlock;
+    uint32_t nextPhysical = kNullBlock;
+    // neighbours in the free list of the bin, only valid for free blocks
+    uint32_t prevFree = kNullBlock;
+    uint32_t nextFree = kNullBlock;
+  };
+
+  Logger *_logger;
+  size_t _poolSize;
+
+  std::vector<Block> _blocks;
+  // indices of the nodes in _blocks that are not part of the pool currently
+  std::vector<uint32_t> _unusedBlockIndices;
+
+  uint32_t _firstLevelBitmap = 0;
+  uint32_t _secondLevelBitmaps[kFirstLevelCount]{};
+  uint32_t _freeListHeads[kFirstLevelCount][kSecondLevelCount]{};
+
+  static size_t _adjustSize(size_t size);
+  static void _mapping(size_t size, uint32_t &firstLevel, uint32_t &secondLevel);
+  // maps to the first bin whose blocks are all large enough for the size
+  static void _mappingSearch(size_t size, uint32_t &firstLevel, uint32_t &secondLevel);
+
+  [[nodiscard]] uint32_t _findSuitableBlock(uint32_t firstLevel, uint32_t secondLevel) const;
+
+  uint32_t _createBlock(size_t offset, size_t size);
+  void _destroyBlock(uint32_t blockIndex);
+
+  void _insertFreeBlock(uint32_t blockIndex);
+  void _removeFreeBlock(uint32_t blockIndex);
+
+  // splits the tail beyond size off the used block, and gives it back to the pool
+  void _trimUsedBlock(uint32_t blockIndex, size_t size);
+  // merges the free block with its free physical neighbours, returns the merged block
+  uint32_t _mergeWithNeighbours(uint32_t blockIndex);
+};
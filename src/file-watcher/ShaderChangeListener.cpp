@@ -6,8 +6,12 @@
 #include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
 #include "utils/event-types/EventType.hpp"
 #include "utils/logger/Logger.hpp"
+#include "utils/shader-compiler/ShaderCompiler.hpp"
 #include "vulkan-wrapper/pipeline/Pipeline.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 namespace {
 // input a/b/\c/d.xxx
 // output a/b/c/d.xxx
@@ -28,17 +32,26 @@ std::string _normalizePath(const std::string &path) {
 }
 }; // namespace
 
-ShaderChangeListener::ShaderChangeListener(Logger *logger)
-    : _logger(logger), _fileWatcher(std::make_unique<efsw::FileWatcher>()) {
+ShaderChangeListener::ShaderChangeListener(Logger *logger, ShaderCompiler *shaderCompiler)
+    : _logger(logger), _shaderCompiler(shaderCompiler),
+      _fileWatcher(std::make_unique<efsw::FileWatcher>()) {
   _fileWatcher->addWatch(kPathToResourceFolder + "shaders/", this, true);
   _fileWatcher->watch();
 
   GlobalEventDispatcher::get()
       .sink<E_RenderLoopBlocked>()
       .connect<&ShaderChangeListener::_onRenderLoopBlocked>(this);
+  GlobalEventDispatcher::get()
+      .sink<E_ShaderCompileDone>()
+      .connect<&ShaderChangeListener::_onShaderCompileDone>(this);
 }
 
-ShaderChangeListener::~ShaderChangeListener() { GlobalEventDispatcher::get().disconnect(this); }
+ShaderChangeListener::~ShaderChangeListener() {
+  GlobalEventDispatcher::get().disconnect(this);
+  if (_compileThread.joinable()) {
+    _compileThread.join();
+  }
+}
 
 void ShaderChangeListener::handleFileAction(efsw::WatchID /*watchid*/, std::string const &dir,
                                             std::string const &filename, efsw::Action action,
@@ -51,94 +64,127 @@ void ShaderChangeListener::handleFileAction(efsw::WatchID /*watchid*/, std::stri
 
   _logger->info("noticed raw shader file change: {}", normalizedPathToFile);
 
+  // before the pipelines are queued, so their compilation never sees the stale source
+  _shaderCompiler->invalidateIncludedFile(normalizedPathToFile);
+
+  std::lock_guard<std::mutex> lock(_mutex);
   auto it = _shaderFileNameToPipelines.find(normalizedPathToFile);
   if (it == _shaderFileNameToPipelines.end()) {
     return;
   }
 
   // here, is some editors, (vscode, notepad++), when a file is saved, it might be saved twice
-  // simultaneously, so the block request is sent twice, however, when the render loop is blocked,
-  // the pipelines will be rebuilt only once, a caching mechanism is used to avoid duplicates
+  // simultaneously, the pipelines that are still pending are only compiled once for both
   _pipelinesToRebuild.insert(it->second.begin(), it->second.end());
+}
 
-  // request to block the render loop, when the render loop is blocked, the pipelines will be
-  // rebuilt
-  uint32_t blockStateBits = BlockState::kShaderChanged;
-  GlobalEventDispatcher::get().trigger<E_RenderLoopBlockRequest>(
-      E_RenderLoopBlockRequest{blockStateBits});
+void ShaderChangeListener::update() {
+  // the compiled pipelines are swapped first, the files changed meanwhile are compiled afterwards
+  if (_isCompiling || _isSwapPending) {
+    return;
+  }
+  _startCompiling();
 }
 
-void ShaderChangeListener::_onRenderLoopBlocked() {
+void ShaderChangeListener::_onShaderCompileDone() { _finishCompiling(); }
+
+void ShaderChangeListener::_startCompiling() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_pipelinesToRebuild.empty()) {
+      return;
+    }
+    for (auto const &pipeline : _pipelinesToRebuild) {
+      _rebuildJobs.push_back({pipeline, std::nullopt, {}});
+    }
+    _pipelinesToRebuild.clear();
+  }
+
   // logging
   std::string pipelineNames;
-  for (auto const &pipeline : _pipelinesToRebuild) {
-    pipelineNames += pipeline->getFullPathToShaderSourceCode() + " ";
+  for (auto const &job : _rebuildJobs) {
+    pipelineNames += job.pipeline->getFullPathToShaderSourceCode() + " ";
   }
-  _logger->info("rebuilding shaders due to changes: {}", pipelineNames);
+  _logger->info("compiling shaders due to changes: {}", pipelineNames);
 
-  std::string rebuildFailedNames;
-
-  std::unordered_set<PipelineScheduler *> schedulersNeededToBeUpdated{};
-
-  // rebuild pipelines
-  for (auto const &pipeline : _pipelinesToRebuild) {
-    // if shader module is rebuilt, then rebuild the pipeline, this is fail safe, because a valid
-    // shader module is previously built and cached when initializing
-    if (pipeline->compileAndCacheShaderModule()) {
-      pipeline->build();
-      schedulersNeededToBeUpdated.insert(pipeline->getScheduler());
-      continue;
+  _isCompiling   = true;
+  _compileThread = std::thread([this]() {
+    for (auto &job : _rebuildJobs) {
+      job.code = job.pipeline->compileShader(job.includedFiles);
     }
-    rebuildFailedNames += pipeline->getFullPathToShaderSourceCode() + " ";
+    GlobalEventDispatcher::enqueue(E_ShaderCompileDone{});
+  });
+}
+
+void ShaderChangeListener::_finishCompiling() {
+  if (_compileThread.joinable()) {
+    _compileThread.join();
   }
+  _isCompiling = false;
+
+  // the failed ones keep their last shader module, which is a valid one, since the first one is
+  // required when initializing
+  std::string rebuildFailedNames;
+  auto const failedBegin =
+      std::remove_if(_rebuildJobs.begin(), _rebuildJobs.end(), [&](RebuildJob const &job) {
+        if (job.code.has_value()) {
+          return false;
+        }
+        rebuildFailedNames += job.pipeline->getFullPathToShaderSourceCode() + " ";
+        return true;
+      });
+  _rebuildJobs.erase(failedBegin, _rebuildJobs.end());
 
   if (!rebuildFailedNames.empty()) {
     _logger->error("shaders building failed and are not cached: {}", rebuildFailedNames);
   }
+  if (_rebuildJobs.empty()) {
+    return;
+  }
+
+  // the pipelines are swapped when the render loop is blocked, since the recorded command buffers
+  // still use the current ones
+  _isSwapPending          = true;
+  uint32_t blockStateBits = BlockState::kShaderChanged;
+  GlobalEventDispatcher::get().trigger<E_RenderLoopBlockRequest>(
+      E_RenderLoopBlockRequest{blockStateBits});
+}
+
+void ShaderChangeListener::_onRenderLoopBlocked() {
+  if (!_isSwapPending) {
+    return;
+  }
+
+  std::unordered_set<PipelineScheduler *> schedulersNeededToBeUpdated{};
+  for (auto const &job : _rebuildJobs) {
+    job.pipeline->cacheShaderModule(job.code.value(), job.includedFiles);
+    job.pipeline->build();
+    schedulersNeededToBeUpdated.insert(job.pipeline->getScheduler());
+  }
+  _logger->info("swapped {} rebuilt pipelines", _rebuildJobs.size());
 
   // update affected schedulers
   for (auto const &scheduler : schedulersNeededToBeUpdated) {
     scheduler->onPipelineRebuilt();
   }
 
-  // clear the cache
-  _pipelinesToRebuild.clear();
+  _rebuildJobs.clear();
+  _isSwapPending = false;
 
   // then the render loop can be continued
 }
 
+// the mutex has to be held
 void ShaderChangeListener::_addWatchingFile(Pipeline *pipeline,
-                                            std::string const &&fullPathToShaderFile) {
-  auto it = _shaderFileNameToPipelines.find(fullPathToShaderFile);
-  if (it == _shaderFileNameToPipelines.end()) {
-    _shaderFileNameToPipelines[fullPathToShaderFile] = std::unordered_set<Pipeline *>{};
-  }
-
-  auto it2 = _pipelineToShaderFileNames.find(pipeline);
-  if (it2 == _pipelineToShaderFileNames.end()) {
-    _pipelineToShaderFileNames[pipeline] = std::unordered_set<std::string>{};
-  }
-
+                                            std::string const &fullPathToShaderFile) {
   _shaderFileNameToPipelines[fullPathToShaderFile].insert(pipeline);
   _pipelineToShaderFileNames[pipeline].insert(fullPathToShaderFile);
 
   _logger->info("file added to change watch list: {}", fullPathToShaderFile);
-
-  _lastPipeline = pipeline;
-}
-
-void ShaderChangeListener::addWatchingPipeline(Pipeline *pipeline) {
-  _addWatchingFile(pipeline, pipeline->getFullPathToShaderSourceCode());
 }
 
-void ShaderChangeListener::appendShaderFileToLastWatchedPipeline(
-    std::string const &fullPathToShaderFile) {
-  assert(_lastPipeline != nullptr &&
-         "appendShaderFileToLastWatchedPipeline should be called after another _addWatchingFile");
-  _addWatchingFile(_lastPipeline, std::move(fullPathToShaderFile));
-}
-
-void ShaderChangeListener::removeWatchingPipeline(Pipeline *pipeline) {
+// the mutex has to be held
+void ShaderChangeListener::_removeWatchingFiles(Pipeline *pipeline) {
   auto it = _pipelineToShaderFileNames.find(pipeline);
   assert(it != _pipelineToShaderFileNames.end());
   auto const &associatedShaderFileNames = it->second;
@@ -152,3 +198,37 @@ void ShaderChangeListener::removeWatchingPipeline(Pipeline *pipeline) {
   }
   _pipelineToShaderFileNames.erase(pipeline);
 }
+
+void ShaderChangeListener::addWatchingPipeline(Pipeline *pipeline) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _addWatchingFile(pipeline, pipeline->getFullPathToShaderSourceCode());
+}
+
+void ShaderChangeListener::setIncludedShaderFiles(Pipeline *pipeline,
+                                                  std::vector<std::string> const &includedFiles) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  assert(_pipelineToShaderFileNames.find(pipeline) != _pipelineToShaderFileNames.end() &&
+         "setIncludedShaderFiles should be called after addWatchingPipeline");
+  // an include that has been removed from the shader no longer rebuilds it
+  _removeWatchingFiles(pipeline);
+  _addWatchingFile(pipeline, pipeline->getFullPathToShaderSourceCode());
+  for (auto const &includedFile : includedFiles) {
+    _addWatchingFile(pipeline, includedFile);
+  }
+}
+
+void ShaderChangeListener::removeWatchingPipeline(Pipeline *pipeline) {
+  // the compile thread must be done with the pipeline before it's gone
+  auto const isRebuilt = [pipeline](RebuildJob const &job) { return job.pipeline == pipeline; };
+  if (std::any_of(_rebuildJobs.begin(), _rebuildJobs.end(), isRebuilt)) {
+    if (_compileThread.joinable()) {
+      _compileThread.join();
+    }
+    _rebuildJobs.erase(std::remove_if(_rebuildJobs.begin(), _rebuildJobs.end(), isRebuilt),
+                       _rebuildJobs.end());
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  _pipelinesToRebuild.erase(pipeline);
+  _removeWatchingFiles(pipeline);
+}
@@ -3,17 +3,28 @@
 // https://github.com/SpartanJ/efsw
 #include "efsw/efsw.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 class Logger;
 class PipelineScheduler;
 class Pipeline;
+class ShaderCompiler;
 
+// the pipelines that depend on a changed file, directly or through their includes, are compiled on
+// a background thread while the frames go on, only the swap of the compiled ones blocks the render
+// loop, the file actions arrive on the thread of the file watcher, every changed file is dropped
+// from the include cache of the shader compiler
 class ShaderChangeListener : public efsw::FileWatchListener {
 public:
-  ShaderChangeListener(Logger *logger);
+  ShaderChangeListener(Logger *logger, ShaderCompiler *shaderCompiler);
   ~ShaderChangeListener() override;
 
   // disable copy and move
@@ -28,22 +39,44 @@ public:
 
   void addWatchingPipeline(Pipeline *pipeline);
 
-  // used to include headers
-  void appendShaderFileToLastWatchedPipeline(std::string const &fullPathToShaderFile);
+  // replaces the included files of the pipeline from its last compilation, the pipeline has to be
+  // watched already, the includes are transitive, so a change to any of them rebuilds it
+  void setIncludedShaderFiles(Pipeline *pipeline, std::vector<std::string> const &includedFiles);
 
   void removeWatchingPipeline(Pipeline *pipeline);
 
+  // called once per frame, after the queued events are drained, starts the compilation of the
+  // changed pipelines, the render loop block for their swap is requested once they're compiled
+  void update();
+
 private:
+  struct RebuildJob {
+    Pipeline *pipeline;
+    std::optional<std::vector<uint32_t>> code;
+    std::vector<std::string> includedFiles;
+  };
+
   Logger *_logger;
+  ShaderCompiler *_shaderCompiler;
   std::unique_ptr<efsw::FileWatcher> _fileWatcher;
 
+  // guards the maps and the pending pipelines, which the file watcher thread reads and writes
+  std::mutex _mutex;
   std::unordered_map<std::string, std::unordered_set<Pipeline *>> _shaderFileNameToPipelines{};
   std::unordered_map<Pipeline *, std::unordered_set<std::string>> _pipelineToShaderFileNames{};
   std::unordered_set<Pipeline *> _pipelinesToRebuild{};
 
-  Pipeline *_lastPipeline = nullptr;
+  // owned by the compile thread until it enqueues E_ShaderCompileDone, then by the main thread
+  std::vector<RebuildJob> _rebuildJobs{};
+  std::thread _compileThread;
+  bool _isCompiling   = false;
+  bool _isSwapPending = false;
 
   void _onRenderLoopBlocked();
+  void _onShaderCompileDone();
+  void _startCompiling();
+  void _finishCompiling();
 
-  void _addWatchingFile(Pipeline *pipeline, std::string const &&fullPathToShaderFile);
+  void _addWatchingFile(Pipeline *pipeline, std::string const &fullPathToShaderFile);
+  void _removeWatchingFiles(Pipeline *pipeline);
 };
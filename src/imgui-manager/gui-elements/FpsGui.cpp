@@ -4,12 +4,16 @@
 
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/ImguiManagerInfo.hpp"
+#include "utils/fps-sink/FpsSink.hpp"
 #include "utils/logger/Logger.hpp"
 #include "window/Window.hpp"
 
 #include "imgui.h"
 #include "implot.h"
 
+#include <cfloat>
+#include <string>
+
 int constexpr kHistSize = 800;
 
 FpsGui::FpsGui(Logger *logger, ConfigContainer *configContainer, Window *window)
@@ -24,13 +28,15 @@ FpsGui::FpsGui(Logger *logger, ConfigContainer *configContainer, Window *window)
   _y.resize(kHistSize, 0);
 }
 
-void FpsGui::update(VulkanApplicationContext *appContext, double filteredFps) {
+void FpsGui::update(VulkanApplicationContext *appContext, FpsSink const *fpsSink) {
   int windowWidth  = 0;
   int windowHeight = 0;
   _window->getWindowDimension(windowWidth, windowHeight);
 
   float constexpr kHoriRatio = 0.3F;
-  float constexpr kVertRatio = 0.2F;
+  float constexpr kVertRatio = 0.3F;
+  // the rest of the window is left to the frame time stats and their histogram
+  float constexpr kGraphRatio = 0.6F;
 
   float constexpr kGraphPadding = 10.F;
   float const fpsWindowWidth    = windowWidth * kHoriRatio;
@@ -45,7 +51,7 @@ void FpsGui::update(VulkanApplicationContext *appContext, double filteredFps) {
     _logger->error("failed to create fps window!");
   }
 
-  _updateFpsHistData(filteredFps);
+  _updateFpsHistData(fpsSink->getFilteredFps());
 
   // clear y array, and refill using deque
   std::fill(_y.begin(), _y.end(), 0);
@@ -55,7 +61,7 @@ void FpsGui::update(VulkanApplicationContext *appContext, double filteredFps) {
   float constexpr kYMin   = 0;
   float constexpr kYMax   = 3000.F;
   float const kGraphSizeX = fpsWindowWidth - 2 * kGraphPadding;
-  float const kGraphSizeY = fpsWindowHeight - 2 * kGraphPadding;
+  float const kGraphSizeY = fpsWindowHeight * kGraphRatio - 2 * kGraphPadding;
 
   ImPlot::SetNextAxisLimits(ImAxis_Y1, kYMin, kYMax);
 
@@ -74,6 +80,22 @@ void FpsGui::update(VulkanApplicationContext *appContext, double filteredFps) {
   ImPlot::PlotShaded("", _x.data(), _y.data(), kHistSize, 0, ImPlotShadedFlags_None);
   ImPlot::EndPlot();
 
+  auto const &stats = fpsSink->getFrameTimeStats();
+  ImGui::SetCursorPosX(kGraphPadding);
+  ImGui::Text("p50: %.2f ms  p95: %.2f ms  p99: %.2f ms  max: %.2f ms  stutters: %zu",
+              stats.p50InMs, stats.p95InMs, stats.p99InMs, stats.maxInMs,
+              fpsSink->getStutterCount());
+
+  // the bins span from 0 to the max frame time, which is labeled on the right
+  auto const &histogram = fpsSink->getFrameTimeHistogram();
+  std::string const histogramLabel =
+      "0 - " + std::to_string(static_cast<int>(stats.maxInMs + 0.5F)) + " ms";
+  ImGui::SetCursorPosX(kGraphPadding);
+  ImGui::PlotHistogram("##FrameTimeHistogram", histogram.data(),
+                       static_cast<int>(histogram.size()), 0, histogramLabel.c_str(), 0.F,
+                       FLT_MAX,
+                       ImVec2(kGraphSizeX, ImGui::GetContentRegionAvail().y - kGraphPadding));
+
   ImGui::End();
 }
 
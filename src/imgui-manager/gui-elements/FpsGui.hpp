@@ -6,13 +6,14 @@
 struct ConfigContainer;
 
 class VulkanApplicationContext;
+class FpsSink;
 class Logger;
 class Window;
 
 class FpsGui {
 public:
   FpsGui(Logger *logger, ConfigContainer *configContainer, Window *window);
-  void update(VulkanApplicationContext *appContext, double filteredFps);
+  void update(VulkanApplicationContext *appContext, FpsSink const *fpsSink);
 
 private:
   Logger *_logger;
@@ -0,0 +1,48 @@
+#include "MemoryGui.hpp"
+
+#include "app-context/MemoryCategory.hpp"
+#include "app-context/VulkanApplicationContext.hpp"
+
+#include "imgui.h"
+
+#include <string>
+
+namespace {
+float constexpr kMb = 1024.F * 1024.F;
+
+float _toMb(VkDeviceSize size) { return static_cast<float>(size) / kMb; }
+} // namespace
+
+MemoryGui::MemoryGui(VulkanApplicationContext *appContext) : _appContext(appContext) {}
+
+void MemoryGui::update() {
+  if (!ImGui::Begin("Memory", nullptr,
+                    ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse)) {
+    ImGui::End();
+    return;
+  }
+
+  // without VK_EXT_memory_budget the budgets are estimated by vma from the heap sizes
+  ImGui::SeparatorText("Heaps");
+  auto const budgets = _appContext->getHeapBudgets();
+  for (uint32_t heapIndex = 0; heapIndex < budgets.size(); heapIndex++) {
+    auto const &budget = budgets[heapIndex];
+    float const usageFraction =
+        budget.budget == 0 ? 0.F : _toMb(budget.usage) / _toMb(budget.budget);
+    std::string const heapLabel = "Heap " + std::to_string(heapIndex) +
+                                  (_appContext->isDeviceLocalHeap(heapIndex) ? " (Device)" : "");
+    std::string const usageLabel = std::to_string(static_cast<int>(_toMb(budget.usage))) + " / " +
+                                   std::to_string(static_cast<int>(_toMb(budget.budget))) + " MB";
+    ImGui::Text("%s", heapLabel.c_str());
+    ImGui::ProgressBar(usageFraction, ImVec2(200.F, 0.F), usageLabel.c_str());
+  }
+
+  ImGui::SeparatorText("Categories");
+  for (uint32_t i = 0; i < static_cast<uint32_t>(MemoryCategory::kCount); i++) {
+    auto const category = static_cast<MemoryCategory>(i);
+    ImGui::Text("%s: %.1f MB", getMemoryCategoryName(category),
+                _toMb(_appContext->getTrackedMemorySize(category)));
+  }
+
+  ImGui::End();
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+class VulkanApplicationContext;
+
+// the usage of the memory heaps against their budgets, and the device memory of each category
+class MemoryGui {
+public:
+  MemoryGui(VulkanApplicationContext *appContext);
+  void update();
+
+private:
+  VulkanApplicationContext *_appContext;
+};
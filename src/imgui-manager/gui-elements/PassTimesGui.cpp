@@ -0,0 +1,74 @@
+#include "PassTimesGui.hpp"
+
+#include "utils/logger/Logger.hpp"
+#include "utils/pass-time-sink/PassTimeSink.hpp"
+#include "window/Window.hpp"
+
+#include "imgui.h"
+#include "implot.h"
+
+PassTimesGui::PassTimesGui(Logger *logger, Window *window) : _logger(logger), _window(window) {}
+
+void PassTimesGui::update(PassTimeSink const *passTimeSink) {
+  int windowWidth  = 0;
+  int windowHeight = 0;
+  _window->getWindowDimension(windowWidth, windowHeight);
+
+  // mirrors FpsGui, in the opposite corner
+  float constexpr kHoriRatio = 0.3F;
+  float constexpr kVertRatio = 0.3F;
+
+  float constexpr kGraphPadding     = 10.F;
+  float const passTimesWindowWidth  = windowWidth * kHoriRatio;
+  float const passTimesWindowHeight = windowHeight * kVertRatio;
+
+  ImGui::SetNextWindowSize(ImVec2(passTimesWindowWidth, passTimesWindowHeight));
+  ImGui::SetNextWindowPos(ImVec2(0, windowHeight - passTimesWindowHeight));
+
+  if (!ImGui::Begin("Pass Times", nullptr,
+                    ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+                        ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoTitleBar)) {
+    _logger->error("failed to create pass times window!");
+  }
+
+  auto const historySize = static_cast<int>(passTimeSink->getHistorySize());
+  if (_x.size() != passTimeSink->getHistorySize()) {
+    _x.resize(historySize);
+    for (int i = 0; i < historySize; ++i) {
+      _x[i] = static_cast<float>(i);
+    }
+  }
+
+  float const graphSizeX = passTimesWindowWidth - 2 * kGraphPadding;
+  float const graphSizeY = passTimesWindowHeight - 2 * kGraphPadding;
+
+  ImGui::SetCursorPosX(kGraphPadding);
+  ImGui::SetCursorPosY(kGraphPadding);
+
+  if (!ImPlot::BeginPlot("##PassTimesStackedPlot", ImVec2(graphSizeX, graphSizeY),
+                         ImPlotFlags_NoInputs)) {
+    _logger->error("failed to begin plot!");
+  }
+  ImPlot::SetupAxis(ImAxis_X1, nullptr,
+                    ImPlotAxisFlags_NoDecorations | ImPlotAxisFlags_NoTickLabels);
+  ImPlot::SetupAxis(ImAxis_Y1, "ms", ImPlotAxisFlags_AutoFit);
+  ImPlot::SetupLegend(ImPlotLocation_NorthWest, ImPlotLegendFlags_Outside);
+
+  // the frames that aren't recorded yet are left at zero, like in FpsGui
+  _yTop.assign(historySize, 0.F);
+  auto const &passNames = passTimeSink->getPassNames();
+  for (size_t pass = 0; pass < passNames.size(); pass++) {
+    auto const &passHistory = passTimeSink->getPassHistory(pass);
+    auto const firstFrame   = static_cast<size_t>(historySize) - passHistory.size();
+
+    _yBottom = _yTop;
+    for (size_t i = 0; i < passHistory.size(); i++) {
+      _yTop[firstFrame + i] += passHistory[i];
+    }
+    ImPlot::PlotShaded(passNames[pass].c_str(), _x.data(), _yBottom.data(), _yTop.data(),
+                       historySize, ImPlotShadedFlags_None);
+  }
+  ImPlot::EndPlot();
+
+  ImGui::End();
+}
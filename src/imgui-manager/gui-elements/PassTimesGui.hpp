@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+class Logger;
+class PassTimeSink;
+class Window;
+
+// the gpu times of the tracing passes as a stacked plot, the oldest frame on the left
+class PassTimesGui {
+public:
+  PassTimesGui(Logger *logger, Window *window);
+  void update(PassTimeSink const *passTimeSink);
+
+private:
+  Logger *_logger;
+  Window *_window;
+
+  std::vector<float> _x{};
+  // the top of the previous pass is the bottom of the next one
+  std::vector<float> _yBottom{};
+  std::vector<float> _yTop{};
+};
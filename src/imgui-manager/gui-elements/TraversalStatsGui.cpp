@@ -0,0 +1,88 @@
+#include "TraversalStatsGui.hpp"
+
+#include "utils/logger/Logger.hpp"
+#include "utils/traversal-stats-sink/TraversalStatsSink.hpp"
+#include "window/Window.hpp"
+
+#include "imgui.h"
+#include "implot.h"
+
+TraversalStatsGui::TraversalStatsGui(Logger *logger, Window *window)
+    : _logger(logger), _window(window) {}
+
+void TraversalStatsGui::update(TraversalStatsSink const *traversalStatsSink) {
+  int windowWidth  = 0;
+  int windowHeight = 0;
+  _window->getWindowDimension(windowWidth, windowHeight);
+
+  // between PassTimesGui and FpsGui
+  float constexpr kHoriRatio = 0.4F;
+  float constexpr kVertRatio = 0.3F;
+
+  float constexpr kGraphPadding     = 10.F;
+  float const traversalWindowWidth  = windowWidth * kHoriRatio;
+  float const traversalWindowHeight = windowHeight * kVertRatio;
+
+  ImGui::SetNextWindowSize(ImVec2(traversalWindowWidth, traversalWindowHeight));
+  ImGui::SetNextWindowPos(ImVec2((windowWidth - traversalWindowWidth) * 0.5F,
+                                 windowHeight - traversalWindowHeight));
+
+  if (!ImGui::Begin("Traversal Stats", nullptr,
+                    ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove |
+                        ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoTitleBar)) {
+    _logger->error("failed to create traversal stats window!");
+  }
+
+  if (!traversalStatsSink->hasRecord()) {
+    ImGui::Text("Turn on the traversal statistics in the tracing config");
+    ImGui::End();
+    return;
+  }
+
+  auto const &rayTypeNames = traversalStatsSink->getRayTypeNames();
+  std::vector<char const *> rayTypeLabels{};
+  _iterFractions.clear();
+  _chunkFractions.clear();
+  for (size_t rayType = 0; rayType < rayTypeNames.size(); rayType++) {
+    auto const &stats = traversalStatsSink->getLatestStats(rayType);
+    ImGui::Text("%s: %u rays, %.1f iterations, %.2f chunks", rayTypeNames[rayType].c_str(),
+                stats.rayCount, stats.getAvgIter(), stats.getAvgChunkTraversed());
+    rayTypeLabels.push_back(rayTypeNames[rayType].c_str());
+
+    float const rayCount = stats.rayCount == 0 ? 1.F : static_cast<float>(stats.rayCount);
+    for (uint32_t const count : stats.iterBuckets) {
+      _iterFractions.push_back(static_cast<float>(count) / rayCount);
+    }
+    for (uint32_t const count : stats.chunkBuckets) {
+      _chunkFractions.push_back(static_cast<float>(count) / rayCount);
+    }
+  }
+
+  // the histograms share the rest of the window side by side
+  float const graphSizeX = (traversalWindowWidth - 3 * kGraphPadding) * 0.5F;
+  float const graphSizeY = traversalWindowHeight - ImGui::GetCursorPosY() - kGraphPadding;
+  auto const &firstStats = traversalStatsSink->getLatestStats(0);
+  _plotHistogram("##TraversalIterPlot", "log2 iterations", _iterFractions, rayTypeLabels,
+                 static_cast<int>(firstStats.iterBuckets.size()), graphSizeX, graphSizeY);
+  ImGui::SameLine();
+  _plotHistogram("##TraversalChunkPlot", "chunks", _chunkFractions, rayTypeLabels,
+                 static_cast<int>(firstStats.chunkBuckets.size()), graphSizeX, graphSizeY);
+
+  ImGui::End();
+}
+
+void TraversalStatsGui::_plotHistogram(char const *plotId, char const *xLabel,
+                                       std::vector<float> const &fractions,
+                                       std::vector<char const *> const &rayTypeLabels,
+                                       int bucketCount, float width, float height) const {
+  if (!ImPlot::BeginPlot(plotId, ImVec2(width, height), ImPlotFlags_NoInputs)) {
+    _logger->error("failed to begin plot!");
+  }
+  ImPlot::SetupAxis(ImAxis_X1, xLabel, ImPlotAxisFlags_AutoFit);
+  ImPlot::SetupAxis(ImAxis_Y1, nullptr, ImPlotAxisFlags_AutoFit);
+  ImPlot::SetupLegend(ImPlotLocation_NorthEast);
+  // the last bucket takes the rest
+  ImPlot::PlotBarGroups(rayTypeLabels.data(), fractions.data(),
+                        static_cast<int>(rayTypeLabels.size()), bucketCount);
+  ImPlot::EndPlot();
+}
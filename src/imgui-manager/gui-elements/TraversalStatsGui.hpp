@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+class Logger;
+class TraversalStatsSink;
+class Window;
+
+// the iteration and the traversed chunk histograms of the latest frame, a bar group per bucket with
+// a bar per ray type, each ray type is normalized by its ray count, so they compare by their shape
+class TraversalStatsGui {
+public:
+  TraversalStatsGui(Logger *logger, Window *window);
+  void update(TraversalStatsSink const *traversalStatsSink);
+
+private:
+  Logger *_logger;
+  Window *_window;
+
+  // the buckets of a ray type after another, as PlotBarGroups takes them
+  std::vector<float> _iterFractions{};
+  std::vector<float> _chunkFractions{};
+
+  void _plotHistogram(char const *plotId, char const *xLabel, std::vector<float> const &fractions,
+                      std::vector<char const *> const &rayTypeLabels, int bucketCount, float width,
+                      float height) const;
+};
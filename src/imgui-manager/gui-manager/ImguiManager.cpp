@@ -4,24 +4,69 @@
 #include "implot.h"
 
 #include "../gui-elements/FpsGui.hpp"
+#include "../gui-elements/MemoryGui.hpp"
+#include "../gui-elements/PassTimesGui.hpp"
+#include "../gui-elements/TraversalStatsGui.hpp"
 #include "../imgui-backends/imgui_impl_glfw.h"
 #include "../imgui-backends/imgui_impl_vulkan.h"
 #include "app-context/VulkanApplicationContext.hpp"
 #include "utils/config/RootDir.h"
+#include "utils/event-dispatcher/GlobalEventDispatcher.hpp"
+#include "utils/event-types/EventType.hpp"
 #include "utils/fps-sink/FpsSink.hpp"
 #include "utils/logger/Logger.hpp"
+#include "utils/pass-time-sink/PassTimeSink.hpp"
+#include "vulkan-wrapper/memory/Image.hpp"
 #include "window/Window.hpp"
 
 #include "config-container/ConfigContainer.hpp"
 #include "config-container/sub-config/ApplicationInfo.hpp"
 #include "config-container/sub-config/BrushInfo.hpp"
 #include "config-container/sub-config/ImguiManagerInfo.hpp"
+#include "config-container/sub-config/SvoTracerInfo.hpp"
 #include "config-container/sub-config/SvoTracerTweakingInfo.hpp"
 
+#include <array>
+#include <chrono>
+
+// the export of the pass times menu falls back to this one, when no file is configured
+char const *const kDefaultPassProfileCsvFile = "tracing_passes.csv";
+
+namespace {
+// fnv-1a
+uint64_t constexpr kFnvOffsetBasis = 14695981039346656037ULL;
+uint64_t constexpr kFnvPrime       = 1099511628211ULL;
+
+void _hashBytes(uint64_t &hash, void const *data, size_t size) {
+  auto const *bytes = static_cast<uint8_t const *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash = (hash ^ bytes[i]) * kFnvPrime;
+  }
+}
+
+// the vertices, the indices and the draw commands cover everything that the pass draws
+uint64_t _hashDrawData(ImDrawData const *drawData) {
+  uint64_t hash = kFnvOffsetBasis;
+  _hashBytes(hash, &drawData->DisplaySize, sizeof(drawData->DisplaySize));
+  for (int listIndex = 0; listIndex < drawData->CmdListsCount; listIndex++) {
+    ImDrawList const *drawList = drawData->CmdLists[listIndex];
+    _hashBytes(hash, drawList->VtxBuffer.Data, drawList->VtxBuffer.size_in_bytes());
+    _hashBytes(hash, drawList->IdxBuffer.Data, drawList->IdxBuffer.size_in_bytes());
+    for (auto const &drawCommand : drawList->CmdBuffer) {
+      _hashBytes(hash, &drawCommand.ClipRect, sizeof(drawCommand.ClipRect));
+      _hashBytes(hash, &drawCommand.TextureId, sizeof(drawCommand.TextureId));
+      _hashBytes(hash, &drawCommand.ElemCount, sizeof(drawCommand.ElemCount));
+    }
+  }
+  return hash;
+}
+} // namespace
+
 ImguiManager::ImguiManager(VulkanApplicationContext *appContext, Window *window, Logger *logger,
                            ConfigContainer *configContainer)
     : _appContext(appContext), _window(window), _logger(logger), _configContainer(configContainer),
-      _framesInFlight(configContainer->applicationInfo->framesInFlight) {}
+      _framesInFlight(configContainer->applicationInfo->framesInFlight),
+      _isEnabled(configContainer->imguiManagerInfo->enabled && !appContext->isHeadless()) {}
 
 ImguiManager::~ImguiManager() {
   for (auto &guiCommandBuffer : _guiCommandBuffers) {
@@ -31,7 +76,7 @@ ImguiManager::~ImguiManager() {
 
   vkDestroyRenderPass(_appContext->getDevice(), _guiPass, nullptr);
 
-  _cleanupFrameBuffers();
+  _cleanupFrameBuffer();
 
   ImGui_ImplVulkan_Shutdown();
   ImGui_ImplGlfw_Shutdown();
@@ -42,23 +87,28 @@ ImguiManager::~ImguiManager() {
   ImGui::DestroyContext();
 }
 
-void ImguiManager::_cleanupFrameBuffers() {
-  for (auto &guiFrameBuffer : _guiFrameBuffers) {
-    vkDestroyFramebuffer(_appContext->getDevice(), guiFrameBuffer, nullptr);
-  }
+void ImguiManager::_cleanupFrameBuffer() {
+  vkDestroyFramebuffer(_appContext->getDevice(), _guiFrameBuffer, nullptr);
 }
 
-void ImguiManager::onSwapchainResize() {
-  _cleanupFrameBuffers();
-  _createFramebuffers();
+// the new overlay is transparent, so it's drawn with the next frame
+void ImguiManager::onSwapchainResize(Image *overlayImage) {
+  _overlayImage      = overlayImage;
+  _isOverlayOutdated = true;
+  _cleanupFrameBuffer();
+  _createFramebuffer();
 }
 
-void ImguiManager::init() {
-  _fpsGui = std::make_unique<FpsGui>(_logger, _configContainer, _window);
+void ImguiManager::init(Image *overlayImage) {
+  _overlayImage      = overlayImage;
+  _fpsGui            = std::make_unique<FpsGui>(_logger, _configContainer, _window);
+  _passTimesGui      = std::make_unique<PassTimesGui>(_logger, _window);
+  _memoryGui         = std::make_unique<MemoryGui>(_appContext);
+  _traversalStatsGui = std::make_unique<TraversalStatsGui>(_logger, _window);
 
   _createGuiCommandBuffers();
   _createGuiRenderPass();
-  _createFramebuffers();
+  _createFramebuffer();
   _createGuiDescripterPool();
 
   // setup Dear ImGui context
@@ -93,7 +143,7 @@ void ImguiManager::init() {
   info.Device                    = _appContext->getDevice();
   info.QueueFamily               = _appContext->getQueueFamilyIndices().graphicsFamily;
   info.Queue                     = _appContext->getGraphicsQueue();
-  info.PipelineCache             = VK_NULL_HANDLE;
+  info.PipelineCache             = _appContext->getPipelineCache();
   info.DescriptorPool            = _guiDescriptorPool;
   info.RenderPass                = _guiPass;
   info.Allocator                 = VK_NULL_HANDLE;
@@ -146,20 +196,20 @@ void ImguiManager::_createGuiCommandBuffers() {
 }
 
 void ImguiManager::_createGuiRenderPass() {
-  // Imgui Pass, right after the main pass
+  // Imgui Pass, right before the main pass, which composites it
   VkAttachmentDescription attachment = {};
-  attachment.format                  = _appContext->getSwapchainImageFormat();
+  attachment.format                  = VK_FORMAT_R8G8B8A8_UNORM;
   attachment.samples                 = VK_SAMPLE_COUNT_1_BIT;
-  // Load onto the current render pass
-  attachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
-  // Store img until display time
+  // the whole overlay is drawn again, onto a transparent one
+  attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+  // kept for the frames that don't draw the gui
   attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
   // No stencil
   attachment.stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-  attachment.initialLayout  = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-  // Present image right after this pass
-  attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  attachment.initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED;
+  // read as a storage image by the post processing
+  attachment.finalLayout = VK_IMAGE_LAYOUT_GENERAL;
 
   VkAttachmentReference colorAttachment = {};
   colorAttachment.attachment            = 0;
@@ -170,13 +220,21 @@ void ImguiManager::_createGuiRenderPass() {
   subpass.colorAttachmentCount = 1;
   subpass.pColorAttachments    = &colorAttachment;
 
-  VkSubpassDependency dependency = {};
-  dependency.srcSubpass          = VK_SUBPASS_EXTERNAL;
-  dependency.dstSubpass          = 0;
-  dependency.srcStageMask        = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  dependency.dstStageMask        = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  dependency.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-  dependency.dstAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  // the post processing of the earlier frames reads the overlay before it's cleared, and the one
+  // of this frame after it's drawn
+  std::array<VkSubpassDependency, 2> dependencies{};
+  dependencies[0].srcSubpass    = VK_SUBPASS_EXTERNAL;
+  dependencies[0].dstSubpass    = 0;
+  dependencies[0].srcStageMask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  dependencies[0].dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[0].srcAccessMask = 0;
+  dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].srcSubpass    = 0;
+  dependencies[1].dstSubpass    = VK_SUBPASS_EXTERNAL;
+  dependencies[1].srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  dependencies[1].dstStageMask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+  dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
 
   VkRenderPassCreateInfo renderPassCreateInfo = {};
   renderPassCreateInfo.sType                  = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -184,40 +242,36 @@ void ImguiManager::_createGuiRenderPass() {
   renderPassCreateInfo.pAttachments           = &attachment;
   renderPassCreateInfo.subpassCount           = 1;
   renderPassCreateInfo.pSubpasses             = &subpass;
-  renderPassCreateInfo.dependencyCount        = 1;
-  renderPassCreateInfo.pDependencies          = &dependency;
+  renderPassCreateInfo.dependencyCount        = static_cast<uint32_t>(dependencies.size());
+  renderPassCreateInfo.pDependencies          = dependencies.data();
 
   vkCreateRenderPass(_appContext->getDevice(), &renderPassCreateInfo, nullptr, &_guiPass);
 }
 
-void ImguiManager::_createFramebuffers() {
-  // Create gui frame buffers for gui pass to use
-  // Each frame buffer will have an attachment of VkImageView, in this case, the
-  // attachments are mSwapchainImageViews
-  _guiFrameBuffers.resize(_appContext->getSwapchainImagesCount());
-
-  uint32_t const w = _appContext->getSwapchainExtentWidth();
-  uint32_t const h = _appContext->getSwapchainExtentHeight();
-
-  // Iterate through image views
-  for (size_t i = 0; i < _appContext->getSwapchainImagesCount(); i++) {
-    VkImageView attachment = _appContext->getSwapchainImageViews()[i];
-
-    VkFramebufferCreateInfo frameBufferCreateInfo{};
-    frameBufferCreateInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-    frameBufferCreateInfo.renderPass      = _guiPass;
-    frameBufferCreateInfo.attachmentCount = 1;
-    frameBufferCreateInfo.pAttachments    = &attachment;
-    frameBufferCreateInfo.width           = w;
-    frameBufferCreateInfo.height          = h;
-    frameBufferCreateInfo.layers          = 1;
-
-    vkCreateFramebuffer(_appContext->getDevice(), &frameBufferCreateInfo, nullptr,
-                        &_guiFrameBuffers[i]);
-  }
+// a single overlay is shared by the frames in flight, the frames are ordered on the queue
+void ImguiManager::_createFramebuffer() {
+  VkImageView attachment = _overlayImage->getVkImageView();
+
+  VkFramebufferCreateInfo frameBufferCreateInfo{};
+  frameBufferCreateInfo.sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+  frameBufferCreateInfo.renderPass      = _guiPass;
+  frameBufferCreateInfo.attachmentCount = 1;
+  frameBufferCreateInfo.pAttachments    = &attachment;
+  frameBufferCreateInfo.width           = _overlayImage->getDimensions().width;
+  frameBufferCreateInfo.height          = _overlayImage->getDimensions().height;
+  frameBufferCreateInfo.layers          = 1;
+
+  vkCreateFramebuffer(_appContext->getDevice(), &frameBufferCreateInfo, nullptr, &_guiFrameBuffer);
 }
 
-void ImguiManager::recordCommandBuffer(size_t currentFrame, uint32_t imageIndex) {
+bool ImguiManager::recordCommandBuffer(size_t currentFrame) {
+  if (!_isEnabled || !_isOverlayOutdated) {
+    return false;
+  }
+  _isOverlayOutdated   = false;
+  _overlayDrawDataHash = _drawDataHash;
+  _lastOverlayDrawTime = std::chrono::steady_clock::now();
+
   VkCommandBuffer commandBuffer = _guiCommandBuffers[currentFrame];
 
   VkCommandBufferBeginInfo beginInfo{};
@@ -231,11 +285,11 @@ void ImguiManager::recordCommandBuffer(size_t currentFrame, uint32_t imageIndex)
   VkRenderPassBeginInfo renderPassInfo = {};
   renderPassInfo.sType                 = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
   renderPassInfo.renderPass            = _guiPass;
-  renderPassInfo.framebuffer           = _guiFrameBuffers[imageIndex];
+  renderPassInfo.framebuffer           = _guiFrameBuffer;
   renderPassInfo.renderArea.extent     = _appContext->getSwapchainExtent();
 
   VkClearValue clearValue{};
-  clearValue.color = {{0.0F, 0.0F, 0.0F, 1.0F}};
+  clearValue.color = {{0.0F, 0.0F, 0.0F, 0.0F}};
 
   renderPassInfo.clearValueCount = 1;
   renderPassInfo.pClearValues    = &clearValue;
@@ -247,6 +301,7 @@ void ImguiManager::recordCommandBuffer(size_t currentFrame, uint32_t imageIndex)
 
   vkCmdEndRenderPass(commandBuffer);
   vkEndCommandBuffer(commandBuffer);
+  return true;
 }
 
 void ImguiManager::_drawConfigMenuItem() {
@@ -257,11 +312,17 @@ void ImguiManager::_drawConfigMenuItem() {
     auto &stti = _configContainer->svoTracerTweakingInfo;
     auto &bi   = _configContainer->brushInfo;
 
+    // the svo tracer only uploads the edited groups again
+    bool isEnvironmentEdited    = false;
+    bool isTracingEdited        = false;
+    bool isTemporalFilterEdited = false;
+    bool isSpatialFilterEdited  = false;
+
     ImGui::SeparatorText("Debug");
-    ImGui::Checkbox("Debug B1", &stti->debugB1);
-    ImGui::SliderFloat("Debug F1", &stti->debugF1, 0.0F, 1.0F);
-    ImGui::SliderInt("Debug I1", &stti->debugI1, 0, 10);
-    ImGui::ColorEdit3("Debug C1", &stti->debugC1.x);
+    isTracingEdited |= ImGui::Checkbox("Debug B1", &stti->debugB1);
+    isTracingEdited |= ImGui::SliderFloat("Debug F1", &stti->debugF1, 0.0F, 1.0F);
+    isTracingEdited |= ImGui::SliderInt("Debug I1", &stti->debugI1, 0, 10);
+    isTracingEdited |= ImGui::ColorEdit3("Debug C1", &stti->debugC1.x);
 
     ///
 
@@ -270,47 +331,93 @@ void ImguiManager::_drawConfigMenuItem() {
     ImGui::SliderFloat("Brush Strength", &bi->strength, 0.001F, 0.01F);
 
     ImGui::SeparatorText("Atmos");
-    ImGui::SliderFloat("Sun Altitude", &stti->sunAltitude, 0.F, 180.F);
-    ImGui::SliderFloat("Sun Azimuth", &stti->sunAzimuth, -180.F, 180.F);
-    ImGui::InputFloat3("Rayleigh Scattering Base", &stti->rayleighScatteringBase.x);
-    ImGui::SliderFloat("Mie Scattering Base", &stti->mieScatteringBase, 0.0F, 10.0F);
-    ImGui::SliderFloat("Mie Absorption Base", &stti->mieAbsorptionBase, 0.0F, 10.0F);
-    ImGui::InputFloat3("Ozone Absorption Base", &stti->ozoneAbsorptionBase.x);
-    ImGui::SliderFloat("Sun Luminance", &stti->sunLuminance, 0.0F, 10.0F);
-    ImGui::SliderFloat("Atmos Luminance", &stti->atmosLuminance, 0.0F, 10.0F);
-    ImGui::SliderFloat("Sun Size", &stti->sunSize, 0.0F, 100.0F);
+    isEnvironmentEdited |= ImGui::SliderFloat("Sun Altitude", &stti->sunAltitude, 0.F, 180.F);
+    isEnvironmentEdited |= ImGui::SliderFloat("Sun Azimuth", &stti->sunAzimuth, -180.F, 180.F);
+    isEnvironmentEdited |=
+        ImGui::InputFloat3("Rayleigh Scattering Base", &stti->rayleighScatteringBase.x);
+    isEnvironmentEdited |=
+        ImGui::SliderFloat("Mie Scattering Base", &stti->mieScatteringBase, 0.0F, 10.0F);
+    isEnvironmentEdited |=
+        ImGui::SliderFloat("Mie Absorption Base", &stti->mieAbsorptionBase, 0.0F, 10.0F);
+    isEnvironmentEdited |=
+        ImGui::InputFloat3("Ozone Absorption Base", &stti->ozoneAbsorptionBase.x);
+    isEnvironmentEdited |= ImGui::SliderFloat("Sun Luminance", &stti->sunLuminance, 0.0F, 10.0F);
+    isEnvironmentEdited |=
+        ImGui::SliderFloat("Atmos Luminance", &stti->atmosLuminance, 0.0F, 10.0F);
+    isEnvironmentEdited |= ImGui::SliderFloat("Sun Size", &stti->sunSize, 0.0F, 100.0F);
 
     ///
 
     ImGui::SeparatorText("Tracing");
-    ImGui::Checkbox("Visualize Chunks", &stti->visualizeChunks);
-    ImGui::Checkbox("Visualize Octree", &stti->visualizeOctree);
-    ImGui::Checkbox("Beam Optimization", &stti->beamOptimization);
-    ImGui::Checkbox("Trace Indirect Ray", &stti->traceIndirectRay);
+    isTracingEdited |= ImGui::Checkbox("Visualize Chunks", &stti->visualizeChunks);
+    isTracingEdited |= ImGui::Checkbox("Visualize Octree", &stti->visualizeOctree);
+    isTracingEdited |= ImGui::Checkbox("Beam Optimization", &stti->beamOptimization);
+    isTracingEdited |= ImGui::Checkbox("Trace Indirect Ray", &stti->traceIndirectRay);
+    isTracingEdited |= ImGui::Checkbox("Indirect Sky SH", &stti->indirectSkySh);
+    isTracingEdited |= ImGui::Checkbox("Packet Traversal", &stti->packetTraversal);
+    if (_appContext->isRayQuerySupported()) {
+      isTracingEdited |= ImGui::Checkbox("Use Ray Query", &stti->useRayQuery);
+    }
+    isTracingEdited |= ImGui::Checkbox("Wavefront Tracing", &stti->wavefrontTracing);
+    if (stti->wavefrontTracing) {
+      isTracingEdited |= ImGui::Checkbox("Bin Indirect Rays", &stti->wavefrontRayBinning);
+    } else {
+      isTracingEdited |= ImGui::Checkbox("Shadow Resampling", &stti->shadowResampling);
+      if (stti->shadowResampling) {
+        isTracingEdited |=
+            ImGui::Checkbox("Checkerboard Shadow Rays", &stti->shadowResamplingCheckerboard);
+      }
+      isTracingEdited |= ImGui::Checkbox("Shadow Map Visibility", &stti->shadowMapVisibility);
+      isTracingEdited |= ImGui::Checkbox("Radiance Cache", &stti->radianceCache);
+    }
+    isTracingEdited |= ImGui::Checkbox("Traversal Statistics", &stti->traversalStatistics);
 
     ///
 
     ImGui::SeparatorText("Filtering");
-    ImGui::Checkbox("TAA", &stti->taa);
-    ImGui::SliderFloat("Temporal Alpha", &stti->temporalAlpha, 0.0F, 1.0F);
-    ImGui::SliderInt("A-Trous Iteration Count", &stti->aTrousIterationCount, 0, 5);
-    ImGui::SliderFloat("Phi Z - Far End", &stti->minPhiZ, 0.0F, 1.0F);
-    ImGui::SliderFloat("Phi Z - Near End", &stti->maxPhiZ, 0.0F, 1.0F);
-    ImGui::SliderFloat("PhiC", &stti->phiC, 0.0F, 1.0F);
-    ImGui::Checkbox("Changing Luminance Phi", &stti->changingLuminancePhi);
+    isTracingEdited |= ImGui::Checkbox("TAA", &stti->taa);
+    isTemporalFilterEdited |=
+        ImGui::SliderFloat("Temporal Alpha", &stti->temporalAlpha, 0.0F, 1.0F);
+    if (_configContainer->svoTracerInfo->adaptiveSampling) {
+      isTemporalFilterEdited |= ImGui::SliderFloat("Converged Sample Count",
+                                                   &stti->convergedSampleCount, 4.0F, 255.0F);
+      isTemporalFilterEdited |= ImGui::SliderFloat("Converged Noise Tolerance",
+                                                   &stti->convergedNoiseTolerance, 0.0F, 0.1F);
+    }
+    isSpatialFilterEdited |=
+        ImGui::SliderInt("A-Trous Iteration Count", &stti->aTrousIterationCount, 0, 5);
+    isSpatialFilterEdited |= ImGui::SliderFloat("Phi Z - Far End", &stti->minPhiZ, 0.0F, 1.0F);
+    isSpatialFilterEdited |= ImGui::SliderFloat("Phi Z - Near End", &stti->maxPhiZ, 0.0F, 1.0F);
+    isSpatialFilterEdited |= ImGui::SliderFloat("PhiC", &stti->phiC, 0.0F, 1.0F);
+    isSpatialFilterEdited |= ImGui::Checkbox("Changing Luminance Phi", &stti->changingLuminancePhi);
+    if (_configContainer->svoTracerInfo->aTrousAdaptive) {
+      isSpatialFilterEdited |= ImGui::SliderFloat("A-Trous Noise Tolerance",
+                                                  &stti->aTrousNoiseTolerance, 0.0F, 0.5F);
+    }
 
     ///
 
     ImGui::SeparatorText("Post Processing");
-    ImGui::SliderFloat("Explosure", &stti->explosure, 0.0F, 20.0F);
+    isTracingEdited |= ImGui::SliderFloat("Explosure", &stti->explosure, 0.0F, 20.0F);
+    isTracingEdited |= ImGui::Checkbox("Fused Post Chain", &stti->fusedPostChain);
 
     ///
 
+    uint32_t const editedGroupBits =
+        (isEnvironmentEdited ? kEnvironmentGroup : 0U) | (isTracingEdited ? kTracingGroup : 0U) |
+        (isTemporalFilterEdited ? kTemporalFilterGroup : 0U) |
+        (isSpatialFilterEdited ? kSpatialFilterGroup : 0U);
+    if (editedGroupBits != 0) {
+      GlobalEventDispatcher::get().trigger<E_TweakingInfoChanged>(
+          E_TweakingInfoChanged{editedGroupBits});
+    }
+
     ImGui::EndMenu();
   }
 }
 
-void ImguiManager::_drawFpsMenuItem(double fpsInTimeBucket) {
+void ImguiManager::_drawFpsMenuItem(FpsSink const *fpsSink, PassTimeSink const *passTimeSink) {
+  double const fpsInTimeBucket = fpsSink->getFpsInTimeBucket();
   std::string const kFpsString = std::to_string(static_cast<int>(fpsInTimeBucket)) + " FPS";
 
   // calculate the right-aligned position for the FPS menu
@@ -323,6 +430,25 @@ void ImguiManager::_drawFpsMenuItem(double fpsInTimeBucket) {
   ImGui::SetNextItemWidth(fpsMenuWidth);
   if (ImGui::BeginMenu("##FpsMenu")) {
     ImGui::Checkbox("Show Fps", &_showFpsGraph);
+    ImGui::Checkbox("Show Pass Times", &_showPassTimesGraph);
+    ImGui::Checkbox("Show Memory", &_showMemory);
+    ImGui::Checkbox("Show Traversal Stats", &_showTraversalStats);
+    if (ImGui::MenuItem("Export Pass Times")) {
+      _exportPassTimes(passTimeSink);
+    }
+    // from the submission until the host has seen the frame done
+    ImGui::Text("Frame Latency: %.2f ms", fpsSink->getFilteredFrameLatencyInMs());
+    ImGui::Text("Frame Wait: %.2f ms", fpsSink->getFilteredFrameWaitInMs());
+    if (_appContext->isLowLatencyPresent() && _appContext->isPresentWaitSupported()) {
+      ImGui::Text("Input To Photon: %.2f ms", fpsSink->getFilteredInputLatencyInMs());
+    }
+    if (_configContainer->svoTracerInfo->recordEveryFrame) {
+      ImGui::Text("Command Recording: %.2f ms", fpsSink->getFilteredRecordingTimeInMs());
+    }
+    if (_configContainer->applicationInfo->frameRecording) {
+      ImGui::Text("Recorded Frames: %zu (dropped %zu)", fpsSink->getRecordedFrameCount(),
+                  fpsSink->getDroppedFrameCount());
+    }
     ImGui::EndMenu();
   }
 
@@ -340,10 +466,22 @@ void ImguiManager::_syncMousePosition() {
                        static_cast<float>(_window->getCursorYPos()));
 }
 
-void ImguiManager::draw(FpsSink *fpsSink) {
-  double const filteredFps     = fpsSink->getFilteredFps();
-  double const fpsInTimeBucket = fpsSink->getFpsInTimeBucket();
+void ImguiManager::_exportPassTimes(PassTimeSink const *passTimeSink) {
+  auto const &csvFile = _configContainer->svoTracerInfo->passProfileCsvFile;
+  std::string const fileName   = csvFile.empty() ? kDefaultPassProfileCsvFile : csvFile;
+  std::string const pathToFile = kPathToResourceFolder + "profiles/" + fileName;
+  if (!passTimeSink->writeCsv(pathToFile)) {
+    _logger->warn("failed to write the tracing pass profile to {}", pathToFile);
+    return;
+  }
+  _logger->info("tracing pass profile written to {}", pathToFile);
+}
 
+void ImguiManager::draw(FpsSink *fpsSink, PassTimeSink const *passTimeSink,
+                        TraversalStatsSink const *traversalStatsSink) {
+  if (!_isEnabled) {
+    return;
+  }
   _syncMousePosition();
 
   ImGui_ImplVulkan_NewFrame();
@@ -354,12 +492,35 @@ void ImguiManager::draw(FpsSink *fpsSink) {
 
   ImGui::BeginMainMenuBar();
   _drawConfigMenuItem();
-  _drawFpsMenuItem(fpsInTimeBucket);
+  _drawFpsMenuItem(fpsSink, passTimeSink);
   ImGui::EndMainMenuBar();
 
   if (_showFpsGraph) {
-    _fpsGui->update(_appContext, filteredFps);
+    _fpsGui->update(_appContext, fpsSink);
+  }
+  if (_showPassTimesGraph) {
+    _passTimesGui->update(passTimeSink);
+  }
+  if (_showMemory) {
+    _memoryGui->update();
+  }
+  if (_showTraversalStats) {
+    _traversalStatsGui->update(traversalStatsSink);
   }
 
   ImGui::Render();
+
+  // while the gui is hovered or typed into, the changes are drawn right away, otherwise they're
+  // only the moving graphs, which are throttled
+  _drawDataHash = _hashDrawData(ImGui::GetDrawData());
+  if (_isOverlayOutdated || _drawDataHash == _overlayDrawDataHash) {
+    return;
+  }
+  ImGuiIO const &io        = ImGui::GetIO();
+  bool const isInteracting = io.WantCaptureMouse || io.WantCaptureKeyboard;
+  std::chrono::duration<float, std::milli> const sinceLastDraw =
+      std::chrono::steady_clock::now() - _lastOverlayDrawTime;
+  _isOverlayOutdated =
+      isInteracting ||
+      sinceLastDraw.count() >= _configContainer->imguiManagerInfo->overlayRefreshIntervalMs;
 }
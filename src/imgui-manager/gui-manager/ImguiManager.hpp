@@ -2,6 +2,7 @@
 
 #include "volk.h"
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -9,10 +10,16 @@
 struct ConfigContainer;
 
 class FpsGui;
+class Image;
+class MemoryGui;
+class PassTimesGui;
+class TraversalStatsGui;
 class VulkanApplicationContext;
 class Window;
 class Logger;
 class FpsSink;
+class PassTimeSink;
+class TraversalStatsSink;
 
 class ImguiManager {
 public:
@@ -26,17 +33,20 @@ public:
   ImguiManager(ImguiManager &&)                 = delete;
   ImguiManager &operator=(ImguiManager &&)      = delete;
 
-  void init();
+  // the gui is drawn into the overlay image, which the caller composites over the frame
+  void init(Image *overlayImage);
 
-  void draw(FpsSink *fpsSink);
+  void draw(FpsSink *fpsSink, PassTimeSink const *passTimeSink,
+            TraversalStatsSink const *traversalStatsSink);
 
   [[nodiscard]] VkCommandBuffer getCommandBuffer(size_t currentFrame) {
     return _guiCommandBuffers[currentFrame];
   }
 
-  void onSwapchainResize();
+  void onSwapchainResize(Image *overlayImage);
 
-  void recordCommandBuffer(size_t currentFrame, uint32_t imageIndex);
+  // returns false if the overlay is kept, the command buffer isn't submitted then
+  bool recordCommandBuffer(size_t currentFrame);
 
 private:
   VulkanApplicationContext *_appContext;
@@ -45,24 +55,39 @@ private:
   ConfigContainer *_configContainer;
 
   int _framesInFlight;
-  bool _showFpsGraph = false;
+  bool _isEnabled;
+  bool _showFpsGraph       = false;
+  bool _showPassTimesGraph = false;
+  bool _showMemory         = false;
+  bool _showTraversalStats = false;
 
   std::unique_ptr<FpsGui> _fpsGui;
+  std::unique_ptr<PassTimesGui> _passTimesGui;
+  std::unique_ptr<MemoryGui> _memoryGui;
+  std::unique_ptr<TraversalStatsGui> _traversalStatsGui;
 
   VkDescriptorPool _guiDescriptorPool = VK_NULL_HANDLE;
   VkRenderPass _guiPass               = VK_NULL_HANDLE;
-  std::vector<VkFramebuffer> _guiFrameBuffers;
+  VkFramebuffer _guiFrameBuffer       = VK_NULL_HANDLE;
   std::vector<VkCommandBuffer> _guiCommandBuffers;
 
-  void _cleanupFrameBuffers();
+  // the overlay is drawn again once the draw data differs from the one it holds
+  Image *_overlayImage          = nullptr;
+  uint64_t _drawDataHash        = 0;
+  uint64_t _overlayDrawDataHash = 0;
+  bool _isOverlayOutdated       = true;
+  std::chrono::steady_clock::time_point _lastOverlayDrawTime{};
+
+  void _cleanupFrameBuffer();
 
   void _createGuiDescripterPool();
   void _createGuiCommandBuffers();
   void _createGuiRenderPass();
-  void _createFramebuffers();
+  void _createFramebuffer();
 
   void _syncMousePosition();
 
   void _drawConfigMenuItem();
-  void _drawFpsMenuItem(double fpsInTimeBucket);
+  void _drawFpsMenuItem(FpsSink const *fpsSink, PassTimeSink const *passTimeSink);
+  void _exportPassTimes(PassTimeSink const *passTimeSink);
 };
\ No newline at end of file
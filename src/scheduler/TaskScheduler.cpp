@@ -0,0 +1,272 @@
+#include "TaskScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+uint32_t constexpr kNotAWorker = UINT32_MAX;
+// the queue of the worker that runs on this thread
+thread_local uint32_t tWorkerIndex = kNotAWorker;
+
+// the timeline thread wakes up this often to pick up the waits that are added meanwhile
+uint64_t constexpr kTimelineWaitTimeoutNs = 1'000'000;
+auto constexpr kWaitPollInterval          = std::chrono::milliseconds(1);
+} // namespace
+
+TaskScheduler &TaskScheduler::get() {
+  static TaskScheduler scheduler{};
+  return scheduler;
+}
+
+TaskScheduler::TaskScheduler() {
+  // the thread that submits the work takes part in it while it waits, so it has one core less, but
+  // there's always a worker, which runs the tasks that nobody waits on
+  uint32_t const workerCount = std::max(2U, std::thread::hardware_concurrency()) - 1;
+  for (uint32_t i = 0; i < workerCount; i++) {
+    _workerQueues.emplace_back(std::make_unique<WorkerQueue>());
+  }
+  for (uint32_t i = 0; i < workerCount; i++) {
+    _workerThreads.emplace_back([this, i]() { _workerLoop(i); });
+  }
+  _timelineThread = std::thread([this]() { _timelineLoop(); });
+}
+
+TaskScheduler::~TaskScheduler() {
+  // the locks keep the threads from missing the flag between their check and their sleep
+  {
+    std::lock_guard<std::mutex> sleepLock(_sleepMutex);
+    std::lock_guard<std::mutex> timelineLock(_timelineMutex);
+    _isStopping = true;
+  }
+  _wakeCondition.notify_all();
+  _timelineCondition.notify_all();
+  for (auto &workerThread : _workerThreads) {
+    workerThread.join();
+  }
+  _timelineThread.join();
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submit(std::function<void()> function,
+                                                std::vector<TaskHandle> const &dependencies) {
+  auto task      = std::make_shared<Task>();
+  task->function = std::move(function);
+  _addDependencies(task, dependencies);
+  _release(task);
+  return task;
+}
+
+TaskScheduler::TaskHandle
+TaskScheduler::submitAfterTimelineValue(VkDevice device, VkSemaphore timelineSemaphore,
+                                        uint64_t value, std::function<void()> function,
+                                        std::vector<TaskHandle> const &dependencies) {
+  auto task      = std::make_shared<Task>();
+  task->function = std::move(function);
+  _addDependencies(task, dependencies);
+
+  // the timeline value is held like one more dependency
+  task->pendingCount++;
+  {
+    std::lock_guard<std::mutex> lock(_timelineMutex);
+    _timelineWaits.push_back({device, timelineSemaphore, value, task});
+  }
+  _timelineCondition.notify_one();
+
+  _release(task);
+  return task;
+}
+
+void TaskScheduler::wait(TaskHandle const &task) {
+  while (!task->isDone) {
+    if (TaskHandle other = _take()) {
+      _run(other);
+      continue;
+    }
+    // the dependencies of the task may be run by the workers, or be held by the gpu
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _wakeCondition.wait_for(lock, kWaitPollInterval,
+                            [&]() { return task->isDone || _queuedTaskCount > 0; });
+  }
+}
+
+void TaskScheduler::wait(std::vector<TaskHandle> const &tasks) {
+  for (auto const &task : tasks) {
+    wait(task);
+  }
+}
+
+void TaskScheduler::parallelFor(size_t count,
+                                std::function<void(size_t index, uint32_t slot)> const &function) {
+  if (count == 0) {
+    return;
+  }
+  // a task per slot, which takes the indices until none is left, the last slot is run by the
+  // calling thread
+  auto const slotCount = static_cast<uint32_t>(std::min<size_t>(getSlotCount(), count));
+  std::atomic<size_t> nextIndex{0};
+  auto const runSlot = [&](uint32_t slot) {
+    for (size_t index = nextIndex++; index < count; index = nextIndex++) {
+      function(index, slot);
+    }
+  };
+
+  std::vector<TaskHandle> slotTasks{};
+  slotTasks.reserve(slotCount - 1);
+  for (uint32_t slot = 0; slot + 1 < slotCount; slot++) {
+    slotTasks.push_back(submit([&runSlot, slot]() { runSlot(slot); }));
+  }
+  runSlot(slotCount - 1);
+  wait(slotTasks);
+}
+
+void TaskScheduler::_workerLoop(uint32_t workerIndex) {
+  tWorkerIndex = workerIndex;
+  for (;;) {
+    if (TaskHandle task = _take()) {
+      _run(task);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(_sleepMutex);
+    _wakeCondition.wait(lock, [this]() { return _isStopping || _queuedTaskCount > 0; });
+    if (_isStopping) {
+      return;
+    }
+  }
+}
+
+void TaskScheduler::_timelineLoop() {
+  for (;;) {
+    std::vector<TimelineWait> timelineWaits{};
+    {
+      std::unique_lock<std::mutex> lock(_timelineMutex);
+      _timelineCondition.wait(lock, [this]() { return _isStopping || !_timelineWaits.empty(); });
+      if (_isStopping) {
+        return;
+      }
+      timelineWaits = _timelineWaits;
+    }
+
+    // the waits are on the device of the oldest one, the others are polled meanwhile
+    VkDevice const device = timelineWaits.front().device;
+    std::vector<VkSemaphore> semaphores{};
+    std::vector<uint64_t> values{};
+    for (auto const &timelineWait : timelineWaits) {
+      if (timelineWait.device == device) {
+        semaphores.push_back(timelineWait.timelineSemaphore);
+        values.push_back(timelineWait.value);
+      }
+    }
+    VkSemaphoreWaitInfo waitInfo{VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO};
+    waitInfo.flags          = VK_SEMAPHORE_WAIT_ANY_BIT;
+    waitInfo.semaphoreCount = static_cast<uint32_t>(semaphores.size());
+    waitInfo.pSemaphores    = semaphores.data();
+    waitInfo.pValues        = values.data();
+    vkWaitSemaphores(device, &waitInfo, kTimelineWaitTimeoutNs);
+
+    std::vector<TaskHandle> releasedTasks{};
+    {
+      std::lock_guard<std::mutex> lock(_timelineMutex);
+      auto const isReached = [](TimelineWait const &timelineWait) {
+        uint64_t value = 0;
+        vkGetSemaphoreCounterValue(timelineWait.device, timelineWait.timelineSemaphore, &value);
+        return value >= timelineWait.value;
+      };
+      for (auto const &timelineWait : _timelineWaits) {
+        if (isReached(timelineWait)) {
+          releasedTasks.push_back(timelineWait.task);
+        }
+      }
+      _timelineWaits.erase(
+          std::remove_if(_timelineWaits.begin(), _timelineWaits.end(),
+                         [&releasedTasks](TimelineWait const &timelineWait) {
+                           return std::find(releasedTasks.begin(), releasedTasks.end(),
+                                            timelineWait.task) != releasedTasks.end();
+                         }),
+          _timelineWaits.end());
+    }
+    for (auto const &task : releasedTasks) {
+      _release(task);
+    }
+  }
+}
+
+void TaskScheduler::_release(TaskHandle const &task) {
+  if (--task->pendingCount == 0) {
+    _push(task);
+  }
+}
+
+void TaskScheduler::_push(TaskHandle const &task) {
+  uint32_t const queueIndex =
+      tWorkerIndex != kNotAWorker
+          ? tWorkerIndex
+          : _nextExternalQueue++ % static_cast<uint32_t>(_workerQueues.size());
+  // counted before it's queued, so the count never drops below zero, the lock keeps a worker from
+  // missing the count between its check and its sleep
+  {
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+    _queuedTaskCount++;
+  }
+  {
+    std::lock_guard<std::mutex> lock(_workerQueues[queueIndex]->mutex);
+    _workerQueues[queueIndex]->tasks.push_back(task);
+  }
+  _wakeCondition.notify_one();
+}
+
+TaskScheduler::TaskHandle TaskScheduler::_take() {
+  auto const queueCount = static_cast<uint32_t>(_workerQueues.size());
+  // the own queue is taken from the back, where the latest tasks are, which are likely warm in the
+  // cache, the others are stolen from the front
+  uint32_t const ownIndex = tWorkerIndex != kNotAWorker ? tWorkerIndex : 0;
+  for (uint32_t i = 0; i < queueCount; i++) {
+    uint32_t const queueIndex = (ownIndex + i) % queueCount;
+    auto &workerQueue         = *_workerQueues[queueIndex];
+    std::lock_guard<std::mutex> lock(workerQueue.mutex);
+    if (workerQueue.tasks.empty()) {
+      continue;
+    }
+    TaskHandle task{};
+    if (queueIndex == tWorkerIndex) {
+      task = std::move(workerQueue.tasks.back());
+      workerQueue.tasks.pop_back();
+    } else {
+      task = std::move(workerQueue.tasks.front());
+      workerQueue.tasks.pop_front();
+    }
+    _queuedTaskCount--;
+    return task;
+  }
+  return nullptr;
+}
+
+void TaskScheduler::_run(TaskHandle const &task) {
+  task->function();
+
+  std::vector<TaskHandle> continuations{};
+  {
+    std::lock_guard<std::mutex> lock(task->continuationMutex);
+    task->isDone = true;
+    continuations.swap(task->continuations);
+  }
+  for (auto const &continuation : continuations) {
+    _release(continuation);
+  }
+
+  // the threads that wait on the task
+  {
+    std::lock_guard<std::mutex> lock(_sleepMutex);
+  }
+  _wakeCondition.notify_all();
+}
+
+void TaskScheduler::_addDependencies(TaskHandle const &task,
+                                     std::vector<TaskHandle> const &dependencies) {
+  for (auto const &dependency : dependencies) {
+    std::lock_guard<std::mutex> lock(dependency->continuationMutex);
+    if (dependency->isDone) {
+      continue;
+    }
+    task->pendingCount++;
+    dependency->continuations.push_back(task);
+  }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "volk.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a pool of worker threads for the cpu side work, every worker has a deque of its own, it takes the
+// tasks that it pushed from the back, and steals from the front of the others once it runs dry,
+// the tasks form graphs, a task is only pushed once all of the tasks it depends on are done
+class TaskScheduler {
+public:
+  struct Task;
+  using TaskHandle = std::shared_ptr<Task>;
+
+  struct Task {
+    std::function<void()> function;
+    // the dependencies that aren't done yet, and one more while the task is being submitted
+    std::atomic<uint32_t> pendingCount{1};
+    std::atomic<bool> isDone{false};
+
+    // the tasks that depend on this one, they're released once it's done
+    std::mutex continuationMutex;
+    std::vector<TaskHandle> continuations{};
+  };
+
+  static TaskScheduler &get();
+
+  TaskScheduler();
+  ~TaskScheduler();
+
+  // disable move and copy
+  TaskScheduler(const TaskScheduler &)            = delete;
+  TaskScheduler &operator=(const TaskScheduler &) = delete;
+  TaskScheduler(TaskScheduler &&)                 = delete;
+  TaskScheduler &operator=(TaskScheduler &&)      = delete;
+
+  // the task runs once all of the dependencies are done, so it's their continuation
+  TaskHandle submit(std::function<void()> function,
+                    std::vector<TaskHandle> const &dependencies = {});
+
+  // the task runs once the timeline semaphore reaches the value, the semaphore is waited on by a
+  // thread of its own, so neither the workers nor the render thread are blocked by the gpu
+  TaskHandle submitAfterTimelineValue(VkDevice device, VkSemaphore timelineSemaphore,
+                                      uint64_t value, std::function<void()> function,
+                                      std::vector<TaskHandle> const &dependencies = {});
+
+  // the calling thread runs the queued tasks while it waits, so it may be a worker itself
+  void wait(TaskHandle const &task);
+  void wait(std::vector<TaskHandle> const &tasks);
+
+  // calls the function for every index below the count, the indices are taken one by one, so the
+  // uneven ones are balanced, the slot is below getSlotCount(), and no two calls with the same slot
+  // run at once, so it can address the state of a worker, the calling thread takes part too
+  void parallelFor(size_t count, std::function<void(size_t index, uint32_t slot)> const &function);
+
+  // the worker threads and the calling thread
+  [[nodiscard]] uint32_t getSlotCount() const {
+    return static_cast<uint32_t>(_workerThreads.size()) + 1;
+  }
+
+private:
+  struct TimelineWait {
+    VkDevice device;
+    VkSemaphore timelineSemaphore;
+    uint64_t value;
+    TaskHandle task;
+  };
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<TaskHandle> tasks;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> _workerQueues{};
+  std::vector<std::thread> _workerThreads{};
+  // the queue the tasks submitted by the other threads go to, in turns
+  std::atomic<uint32_t> _nextExternalQueue{0};
+
+  // the workers sleep while nothing is queued, the waiting threads until a task is done
+  std::atomic<uint32_t> _queuedTaskCount{0};
+  std::mutex _sleepMutex;
+  std::condition_variable _wakeCondition;
+  std::atomic<bool> _isStopping{false};
+
+  std::vector<TimelineWait> _timelineWaits{};
+  std::mutex _timelineMutex;
+  std::condition_variable _timelineCondition;
+  std::thread _timelineThread;
+
+  void _workerLoop(uint32_t workerIndex);
+  void _timelineLoop();
+
+  // releases the hold of the submission, or of a dependency, the task is pushed once none is left
+  void _release(TaskHandle const &task);
+  void _push(TaskHandle const &task);
+  // pops a task of the own queue, or steals one of the others
+  TaskHandle _take();
+  void _run(TaskHandle const &task);
+  void _addDependencies(TaskHandle const &task, std::vector<TaskHandle> const &dependencies);
+};
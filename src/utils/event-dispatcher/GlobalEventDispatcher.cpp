@@ -1,5 +1,73 @@
 #include "GlobalEventDispatcher.hpp"
 
+#include <algorithm>
+
 namespace GlobalEventDispatcher {
 entt::dispatcher gGlobalEventDispatcher;
+
+namespace {
+// an intrusive mpsc queue, the producers swap themselves in as the head, then link the previous
+// head to themselves, the consumer follows the links from the tail, the stub keeps the queue from
+// ever being empty, so the head is never null
+QueuedEvent gStub{};
+std::atomic<QueuedEvent *> gHead{&gStub};
+QueuedEvent *gTail = &gStub;
+
+std::unordered_map<std::string_view, QueueLatency> gQueueLatencies{};
+
+// returns nullptr if the queue is empty, or if a producer has swapped the head without linking it
+// yet, its event is taken by the next drain then
+QueuedEvent *_pop() {
+  QueuedEvent *tail = gTail;
+  QueuedEvent *next = tail->next.load(std::memory_order_acquire);
+  if (tail == &gStub) {
+    if (next == nullptr) {
+      return nullptr;
+    }
+    gTail = next;
+    tail  = next;
+    next  = next->next.load(std::memory_order_acquire);
+  }
+  if (next != nullptr) {
+    gTail = next;
+    return tail;
+  }
+  if (tail != gHead.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  // the tail is the last event, the stub is put behind it, so it can be taken
+  enqueue(&gStub);
+  next = tail->next.load(std::memory_order_acquire);
+  if (next != nullptr) {
+    gTail = next;
+    return tail;
+  }
+  return nullptr;
+}
+} // namespace
+
+void enqueue(QueuedEvent *queuedEvent) {
+  queuedEvent->next.store(nullptr, std::memory_order_relaxed);
+  QueuedEvent *previousHead = gHead.exchange(queuedEvent, std::memory_order_acq_rel);
+  previousHead->next.store(queuedEvent, std::memory_order_release);
+}
+
+void drain() {
+  while (QueuedEvent *queuedEvent = _pop()) {
+    double const latencyMs = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - queuedEvent->enqueueTime)
+                                 .count();
+    auto &queueLatency = gQueueLatencies[queuedEvent->typeName];
+    queueLatency.eventCount++;
+    queueLatency.totalMs += latencyMs;
+    queueLatency.maxMs = std::max(queueLatency.maxMs, latencyMs);
+
+    queuedEvent->trigger();
+    delete queuedEvent;
+  }
+}
+
+std::unordered_map<std::string_view, QueueLatency> const &getQueueLatencies() {
+  return gQueueLatencies;
+}
 } // namespace GlobalEventDispatcher
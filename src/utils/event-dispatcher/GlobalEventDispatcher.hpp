@@ -1,8 +1,51 @@
 #pragma once
 
+#include "entt/core/type_info.hpp"
 #include "entt/signal/dispatcher.hpp" // IWYU pragma: export
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
 namespace GlobalEventDispatcher {
 extern entt::dispatcher gGlobalEventDispatcher;
 inline entt::dispatcher &get() { return gGlobalEventDispatcher; }
+
+// the dispatcher triggers the handlers on the calling thread, so the other threads hand their
+// events off to a queue instead, which is lock-free for any number of them, the main thread drains
+// it once per frame, and triggers the events in the order they were enqueued
+struct QueuedEvent {
+  std::atomic<QueuedEvent *> next{nullptr};
+  std::function<void()> trigger;
+  std::string_view typeName;
+  std::chrono::steady_clock::time_point enqueueTime;
+};
+
+// from the enqueue of the events of a type to their trigger
+struct QueueLatency {
+  uint64_t eventCount = 0;
+  double totalMs      = 0.0;
+  double maxMs        = 0.0;
+};
+
+// the queue owns the event from here on, it's deleted once it's triggered
+void enqueue(QueuedEvent *queuedEvent);
+
+template <typename Event> void enqueue(Event event) {
+  auto *queuedEvent        = new QueuedEvent{};
+  queuedEvent->trigger     = [event = std::move(event)]() { get().trigger<Event>(Event{event}); };
+  queuedEvent->typeName    = entt::type_id<Event>().name();
+  queuedEvent->enqueueTime = std::chrono::steady_clock::now();
+  enqueue(queuedEvent);
+}
+
+// only called by the main thread, the events that the handlers enqueue meanwhile are triggered too
+void drain();
+
+// keyed by the type names of the events, only read by the main thread
+std::unordered_map<std::string_view, QueueLatency> const &getQueueLatencies();
 }; // namespace GlobalEventDispatcher
@@ -9,3 +9,16 @@ struct E_RenderLoopBlockRequest {
 
 // after the caller's render loop comes to a halt, this event is triggered
 struct E_RenderLoopBlocked {};
+
+// the background compilation of the changed shaders is done, it's enqueued by the compile thread,
+// see GlobalEventDispatcher::enqueue
+struct E_ShaderCompileDone {};
+
+// the svo builder has added an octree buffer page, the buffer arrays of the descriptor sets are
+// updated after bind, so the render loop isn't blocked to rebind it, see BlockState
+struct E_OctreeBufferPageAdded {};
+
+// the gui has edited the tweaking parameters, the bits are the TweakingGroup of the edited ones
+struct E_TweakingInfoChanged {
+  uint32_t tweakingGroupBits;
+};
@@ -2,23 +2,62 @@
 
 #include "MovingAvg.hpp"
 
+#include <algorithm>
 #include <chrono>
 
 size_t constexpr kMovingAvgSize              = 100;
 double constexpr kBucketRefreshIntervalInSec = 0.2;
+size_t constexpr kHistogramBinCount          = 40;
+// the frames above this multiple of the median are counted as stutters
+float constexpr kStutterFactor = 2.F;
 
-FpsSink::FpsSink() { _avg = std::make_unique<MovingAvg>(kMovingAvgSize); }
+FpsSink::FpsSink() {
+  _avg              = std::make_unique<MovingAvg>(kMovingAvgSize);
+  _latencyAvg       = std::make_unique<MovingAvg>(kMovingAvgSize);
+  _waitAvg          = std::make_unique<MovingAvg>(kMovingAvgSize);
+  _inputLatencyAvg  = std::make_unique<MovingAvg>(kMovingAvgSize);
+  _recordingTimeAvg = std::make_unique<MovingAvg>(kMovingAvgSize);
+
+  _sortedFrameTimesInMs.reserve(kFrameTimeRingSize);
+  _frameTimeHistogram.resize(kHistogramBinCount, 0.F);
+}
 
 FpsSink::~FpsSink() = default;
 
 void FpsSink::addRecord(double fps) {
   _updateMovingAvg(fps);
-  _updateBucket(fps);
+  if (fps > 0.0) {
+    _addFrameTime(static_cast<float>(1000.0 / fps));
+  }
+  if (_updateBucket(fps)) {
+    _updateFrameTimeStats();
+  }
+}
+
+void FpsSink::addFrameLatencyRecord(double latencyInMs, double waitInMs) {
+  _latencyAvg->add(static_cast<float>(latencyInMs));
+  _waitAvg->add(static_cast<float>(waitInMs));
+}
+
+void FpsSink::addInputLatencyRecord(double latencyInMs) {
+  _inputLatencyAvg->add(static_cast<float>(latencyInMs));
+}
+
+void FpsSink::addRecordingTimeRecord(double recordingTimeInMs) {
+  _recordingTimeAvg->add(static_cast<float>(recordingTimeInMs));
+}
+
+void FpsSink::addRecordedFrame(bool isDropped) {
+  if (isDropped) {
+    _droppedFrameCount++;
+    return;
+  }
+  _recordedFrameCount++;
 }
 
 void FpsSink::_updateMovingAvg(double fps) { _avg->add(static_cast<float>(fps)); }
 
-void FpsSink::_updateBucket(double fps) {
+bool FpsSink::_updateBucket(double fps) {
   static auto lastUpdateTime = std::chrono::steady_clock::now();
 
   auto now = std::chrono::steady_clock::now();
@@ -36,9 +75,57 @@ void FpsSink::_updateBucket(double fps) {
 
     _fpsInTimeBucket.clear();
     lastUpdateTime = now;
+    return true;
+  }
+  return false;
+}
+
+void FpsSink::_addFrameTime(float frameTimeInMs) {
+  // the median of the last refresh, so a single stall doesn't raise its own threshold
+  if (_frameTimeStats.p50InMs > 0.F && frameTimeInMs > kStutterFactor * _frameTimeStats.p50InMs) {
+    _stutterCount++;
+  }
+
+  size_t const frameTimeCount = _frameTimeCount.load(std::memory_order_relaxed);
+  _frameTimesInMs[frameTimeCount % kFrameTimeRingSize] = frameTimeInMs;
+  _frameTimeCount.store(frameTimeCount + 1, std::memory_order_release);
+}
+
+void FpsSink::_updateFrameTimeStats() {
+  size_t const frameTimeCount =
+      std::min(_frameTimeCount.load(std::memory_order_acquire), kFrameTimeRingSize);
+  if (frameTimeCount == 0) {
+    return;
+  }
+
+  _sortedFrameTimesInMs.assign(_frameTimesInMs.begin(), _frameTimesInMs.begin() + frameTimeCount);
+  std::sort(_sortedFrameTimesInMs.begin(), _sortedFrameTimesInMs.end());
+  auto const percentile = [this, frameTimeCount](float fraction) {
+    auto const index = static_cast<size_t>(fraction * static_cast<float>(frameTimeCount));
+    return _sortedFrameTimesInMs[std::min(index, frameTimeCount - 1)];
+  };
+  _frameTimeStats.p50InMs = percentile(0.5F);
+  _frameTimeStats.p95InMs = percentile(0.95F);
+  _frameTimeStats.p99InMs = percentile(0.99F);
+  _frameTimeStats.maxInMs = _sortedFrameTimesInMs.back();
+
+  _frameTimeHistogramBinWidthInMs =
+      std::max(_frameTimeStats.maxInMs, 1.F) / static_cast<float>(kHistogramBinCount);
+  std::fill(_frameTimeHistogram.begin(), _frameTimeHistogram.end(), 0.F);
+  for (float const frameTimeInMs : _sortedFrameTimesInMs) {
+    auto const bin = static_cast<size_t>(frameTimeInMs / _frameTimeHistogramBinWidthInMs);
+    _frameTimeHistogram[std::min(bin, kHistogramBinCount - 1)] += 1.F;
   }
 }
 
 double FpsSink::getFilteredFps() const { return _avg->getAverage(); }
 
 double FpsSink::getFpsInTimeBucket() const { return _lastAvgInBucket; }
+
+double FpsSink::getFilteredFrameLatencyInMs() const { return _latencyAvg->getAverage(); }
+
+double FpsSink::getFilteredFrameWaitInMs() const { return _waitAvg->getAverage(); }
+
+double FpsSink::getFilteredInputLatencyInMs() const { return _inputLatencyAvg->getAverage(); }
+
+double FpsSink::getFilteredRecordingTimeInMs() const { return _recordingTimeAvg->getAverage(); }
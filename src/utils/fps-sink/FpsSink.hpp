@@ -1,9 +1,21 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
 class MovingAvg;
+
+// the percentiles of the recent frame times, the averages hide the single long frames
+struct FrameTimeStats {
+  float p50InMs = 0.F;
+  float p95InMs = 0.F;
+  float p99InMs = 0.F;
+  float maxInMs = 0.F;
+};
+
 class FpsSink {
 public:
   FpsSink();
@@ -16,6 +28,14 @@ public:
   FpsSink &operator=(FpsSink &&)      = delete;
 
   void addRecord(double fps);
+  // the time from the submission of a frame until the host has seen it done, and how long the host
+  // was blocked on it
+  void addFrameLatencyRecord(double latencyInMs, double waitInMs);
+  // from the sampling of the input until the frame is displayed, only with the present waits
+  void addInputLatencyRecord(double latencyInMs);
+  // the host time spent recording the command buffers of a frame, only when they're recorded per
+  // frame
+  void addRecordingTimeRecord(double recordingTimeInMs);
 
   // get fps with frequent updates, for plot use
   [[nodiscard]] double getFilteredFps() const;
@@ -23,11 +43,53 @@ public:
   // get fps with less frequent updates, digit is human readable
   [[nodiscard]] double getFpsInTimeBucket() const;
 
+  [[nodiscard]] double getFilteredFrameLatencyInMs() const;
+  [[nodiscard]] double getFilteredFrameWaitInMs() const;
+  [[nodiscard]] double getFilteredInputLatencyInMs() const;
+  [[nodiscard]] double getFilteredRecordingTimeInMs() const;
+
+  // of the frames in the ring, refreshed with the time bucket
+  [[nodiscard]] FrameTimeStats const &getFrameTimeStats() const { return _frameTimeStats; }
+  // the frame counts of the bins, from 0 to the max frame time of the ring
+  [[nodiscard]] std::vector<float> const &getFrameTimeHistogram() const {
+    return _frameTimeHistogram;
+  }
+  [[nodiscard]] float getFrameTimeHistogramBinWidthInMs() const {
+    return _frameTimeHistogramBinWidthInMs;
+  }
+  // the frames that took more than twice the median, since the start
+  [[nodiscard]] size_t getStutterCount() const { return _stutterCount; }
+
+  // a frame of the recording, dropped if the writers were busy with the ones before it
+  void addRecordedFrame(bool isDropped);
+  [[nodiscard]] size_t getRecordedFrameCount() const { return _recordedFrameCount; }
+  [[nodiscard]] size_t getDroppedFrameCount() const { return _droppedFrameCount; }
+
 private:
+  static size_t constexpr kFrameTimeRingSize = 1024;
   std::unique_ptr<MovingAvg> _avg;
+  std::unique_ptr<MovingAvg> _latencyAvg;
+  std::unique_ptr<MovingAvg> _waitAvg;
+  std::unique_ptr<MovingAvg> _inputLatencyAvg;
+  std::unique_ptr<MovingAvg> _recordingTimeAvg;
   std::vector<double> _fpsInTimeBucket{};
   double _lastAvgInBucket = 0.0;
 
+  // the raw frame times, written by the render loop only, the count is published after the slot
+  // is written, so the ring can be read while it's filled
+  std::array<float, kFrameTimeRingSize> _frameTimesInMs{};
+  std::atomic<size_t> _frameTimeCount = 0;
+  std::vector<float> _sortedFrameTimesInMs{};
+  FrameTimeStats _frameTimeStats{};
+  std::vector<float> _frameTimeHistogram{};
+  float _frameTimeHistogramBinWidthInMs = 0.F;
+  size_t _stutterCount                  = 0;
+  size_t _recordedFrameCount            = 0;
+  size_t _droppedFrameCount             = 0;
+
   void _updateMovingAvg(double fps);
-  void _updateBucket(double fps);
+  // returns true if the bucket is refreshed
+  bool _updateBucket(double fps);
+  void _addFrameTime(float frameTimeInMs);
+  void _updateFrameTimeStats();
 };
\ No newline at end of file
@@ -1,18 +1,33 @@
 #include "Logger.hpp" // IWYU pragma: export
 
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+namespace {
+// the records that can be queued before the oldest ones are overwritten
+size_t constexpr kQueueSize = 8192;
+} // namespace
+
 Logger::Logger() {
+  // the records are formatted on the calling thread, and written to the console by a background
+  // thread, so the hot paths never wait on the sinks, both loggers share the thread, which keeps
+  // their order, and a full queue drops the oldest records instead of blocking
+  spdlog::init_thread_pool(kQueueSize, 1);
+
   // the normal logger is designed to showcase the log level
-  _spdLogger = spdlog::stdout_color_mt("normalLogger");
+  _spdLogger = spdlog::stdout_color_mt<spdlog::async_factory_nonblock>("normalLogger");
   // %^ marks the beginning of the colorized section
   // %l will be replaced by the current log level
   // %$ marks the end of the colorized section
   _spdLogger->set_pattern("%^[%l]%$ %v");
+  if constexpr (kDebugLogsEnabled) {
+    _spdLogger->set_level(spdlog::level::debug);
+  }
 
   // the println logger is designed to print without any log level
-  _printlnSpdLogger = spdlog::stdout_color_mt("printlnLogger");
+  _printlnSpdLogger = spdlog::stdout_color_mt<spdlog::async_factory_nonblock>("printlnLogger");
   _printlnSpdLogger->set_pattern("%v");
 }
 
-Logger::~Logger() { spdlog::drop_all(); }
+// drains the queue, and joins the background thread
+Logger::~Logger() { spdlog::shutdown(); }
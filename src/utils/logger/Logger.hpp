@@ -11,11 +11,23 @@ public:
   Logger();
   ~Logger();
 
+#ifdef NDEBUGLOGS
+  static bool constexpr kDebugLogsEnabled = false;
+#else
+  static bool constexpr kDebugLogsEnabled = true;
+#endif
+
   template <typename... Args> inline void subInfo(std::string format, Args &&...args) {
     std::string formatWithSubInfo = "* " + std::move(format);
     _spdLogger->info(fmt::runtime(formatWithSubInfo), std::forward<Args>(args)...);
   }
 
+  // compiled out of the release builds, for the hot paths, like the per chunk logs of the edits
+  template <typename... Args> inline void debug(const std::string &format, Args &&...args) {
+    if constexpr (kDebugLogsEnabled) {
+      _spdLogger->debug(fmt::runtime(format), std::forward<Args>(args)...);
+    }
+  }
   template <typename... Args> inline void info(const std::string &format, Args &&...args) {
     _spdLogger->info(fmt::runtime(format), std::forward<Args>(args)...);
   }
@@ -0,0 +1,68 @@
+#include "PassTimeSink.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+PassTimeSink::PassTimeSink(std::vector<std::string> passNames, size_t historySize)
+    : _passNames(std::move(passNames)), _historySize(historySize),
+      _passHistories(_passNames.size()), _passStats(_passNames.size()) {}
+
+PassTimeSink::~PassTimeSink() = default;
+
+void PassTimeSink::addRecord(std::vector<float> const &passTimesMs,
+                             std::vector<uint64_t> const &passInvocationCounts) {
+  for (size_t i = 0; i < _passNames.size(); i++) {
+    float const timeMs = passTimesMs[i];
+
+    auto &passHistory = _passHistories[i];
+    passHistory.push_back(timeMs);
+    if (passHistory.size() > _historySize) {
+      passHistory.pop_front();
+    }
+
+    auto &passStats = _passStats[i];
+    passStats.totalMs += timeMs;
+    passStats.minMs = _frameCount == 0 ? timeMs : std::min(passStats.minMs, timeMs);
+    passStats.maxMs = _frameCount == 0 ? timeMs : std::max(passStats.maxMs, timeMs);
+    if (!passInvocationCounts.empty()) {
+      passStats.totalInvocations += passInvocationCounts[i];
+    }
+  }
+  _frameCount++;
+  if (!passInvocationCounts.empty()) {
+    _countedFrameCount++;
+  }
+}
+
+void PassTimeSink::clear() {
+  _passHistories.assign(_passNames.size(), {});
+  _passStats.assign(_passNames.size(), PassStats{});
+  _frameCount        = 0;
+  _countedFrameCount = 0;
+}
+
+bool PassTimeSink::writeCsv(std::string const &pathToFile) const {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+  std::ofstream file(pathToFile, std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  // the invocations are left empty if they weren't counted
+  file << "pass,frames,avg_ms,min_ms,max_ms,avg_invocations\n";
+  for (size_t i = 0; i < _passNames.size(); i++) {
+    auto const &passStats = _passStats[i];
+    double const avgMs =
+        _frameCount == 0 ? 0.0 : passStats.totalMs / static_cast<double>(_frameCount);
+    file << _passNames[i] << "," << _frameCount << "," << avgMs << "," << passStats.minMs << ","
+         << passStats.maxMs << ",";
+    if (_countedFrameCount > 0) {
+      file << passStats.totalInvocations / _countedFrameCount;
+    }
+    file << "\n";
+  }
+  return static_cast<bool>(file);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+// the gpu time of every pass of the recent frames, for the stacked plot, and the stats of all of
+// the recorded frames, for the csv export, along with the compute invocations of the passes if
+// they're counted
+class PassTimeSink {
+public:
+  PassTimeSink(std::vector<std::string> passNames, size_t historySize);
+  ~PassTimeSink();
+
+  // delete copy and move
+  PassTimeSink(const PassTimeSink &)            = delete;
+  PassTimeSink &operator=(const PassTimeSink &) = delete;
+  PassTimeSink(PassTimeSink &&)                 = delete;
+  PassTimeSink &operator=(PassTimeSink &&)      = delete;
+
+  // one time per pass, in ms, and one invocation count per pass, or none if they aren't counted
+  void addRecord(std::vector<float> const &passTimesMs,
+                 std::vector<uint64_t> const &passInvocationCounts = {});
+  void clear();
+
+  [[nodiscard]] std::vector<std::string> const &getPassNames() const { return _passNames; }
+  [[nodiscard]] size_t getHistorySize() const { return _historySize; }
+  // the oldest frame first
+  [[nodiscard]] std::deque<float> const &getPassHistory(size_t passIndex) const {
+    return _passHistories[passIndex];
+  }
+
+  // one line per pass, returns false if the file can't be written
+  bool writeCsv(std::string const &pathToFile) const;
+
+private:
+  std::vector<std::string> _passNames;
+  size_t _historySize;
+  std::vector<std::deque<float>> _passHistories;
+
+  struct PassStats {
+    double totalMs            = 0.0;
+    float minMs               = 0.0F;
+    float maxMs               = 0.0F;
+    uint64_t totalInvocations = 0;
+  };
+  std::vector<PassStats> _passStats;
+  size_t _frameCount = 0;
+  // the frames with invocation counts, a frame may miss them while the others have them
+  size_t _countedFrameCount = 0;
+};
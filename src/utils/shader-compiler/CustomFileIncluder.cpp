@@ -1,10 +1,11 @@
 #include "CustomFileIncluder.hpp"
 
-#include "utils/io/ShaderFileReader.hpp"
-#include "utils/logger/Logger.hpp"
+#include "IncludeCache.hpp"
 
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -47,17 +48,18 @@ std::string _compressPath(std::string const &originalPath) {
 }
 } // namespace
 
-CustomFileIncluder::CustomFileIncluder(Logger *logger,
-                                       std::function<void(std::string const &)> includeCallback)
-    : _logger(logger), _includeCallback(includeCallback) {}
+CustomFileIncluder::CustomFileIncluder(
+    IncludeCache *includeCache, std::function<void(std::string const &, uint64_t)> includeCallback)
+    : _includeCache(includeCache), _includeCallback(includeCallback) {}
 
 shaderc_include_result *MakeErrorIncludeResult(const char *message) {
   return new shaderc_include_result{"", 0, message, strlen(message)};
 }
 
+// keeps the cached source alive until shaderc releases it, even if it's invalidated meanwhile
 struct FileInfo {
   std::string fullPath;
-  std::string content;
+  std::shared_ptr<IncludeCache::Entry const> entry;
 };
 
 shaderc_include_result *CustomFileIncluder::GetInclude(const char *requested_source,
@@ -67,15 +69,16 @@ shaderc_include_result *CustomFileIncluder::GetInclude(const char *requested_sou
   std::string fullPath = _includeDir + requested_source;
   fullPath             = _compressPath(fullPath);
 
+  auto entry = _includeCache->get(fullPath);
   if (_includeCallback != nullptr) {
-    _includeCallback(fullPath);
+    _includeCallback(fullPath, entry->hash);
   }
 
-  std::string content = ShaderFileReader::readShaderSourceCode(fullPath, _logger);
   // store the pointer created in a pointer for destroying later on, eww!
-  auto *info = new FileInfo{fullPath, content};
-  return new shaderc_include_result{fullPath.c_str(), fullPath.size(), info->content.c_str(),
-                                    info->content.length(), info};
+  auto *info = new FileInfo{fullPath, std::move(entry)};
+  return new shaderc_include_result{info->fullPath.c_str(), info->fullPath.size(),
+                                    info->entry->source.c_str(), info->entry->source.length(),
+                                    info};
 }
 
 void CustomFileIncluder::ReleaseInclude(shaderc_include_result *include_result) {
@@ -2,15 +2,19 @@
 
 #include "shaderc/shaderc.hpp"
 
+#include <cstdint>
 #include <functional>
 #include <string>
 
-class Logger;
+class IncludeCache;
 
+// the included files are taken from the include cache, the callback gets their full paths, and the
+// hashes of their sources
 class CustomFileIncluder : public shaderc::CompileOptions::IncluderInterface {
 public:
-  CustomFileIncluder(Logger *logger,
-                     std::function<void(std::string const &)> includeCallback = nullptr);
+  CustomFileIncluder(
+      IncludeCache *includeCache,
+      std::function<void(std::string const &, uint64_t)> includeCallback = nullptr);
 
   shaderc_include_result *GetInclude(const char *requested_source, shaderc_include_type type,
                                      const char *requesting_source, size_t include_depth) override;
@@ -22,8 +26,8 @@ public:
   void setIncludeDir(const std::string &includeDir) { _includeDir = includeDir; }
 
 private:
-  Logger *_logger;
-  std::function<void(std::string const &)> _includeCallback;
+  IncludeCache *_includeCache;
+  std::function<void(std::string const &, uint64_t)> _includeCallback;
 
   std::string _includeDir{};
 };
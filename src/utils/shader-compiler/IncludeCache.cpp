@@ -0,0 +1,52 @@
+#include "IncludeCache.hpp"
+
+#include "utils/io/ShaderFileReader.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <utility>
+
+namespace {
+// fnv-1a, mirrors ShaderCompiler
+uint64_t constexpr kFnvOffsetBasis = 14695981039346656037ULL;
+uint64_t constexpr kFnvPrime       = 1099511628211ULL;
+} // namespace
+
+IncludeCache::IncludeCache(Logger *logger) : _logger(logger) {}
+
+std::shared_ptr<IncludeCache::Entry const> IncludeCache::get(std::string const &fullPathToFile) {
+  uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto const it = _entries.find(fullPathToFile);
+    if (it != _entries.end()) {
+      return it->second;
+    }
+    generation = _generation;
+  }
+
+  // read without the lock, two compilations may read the same file at once, the first one is kept
+  std::string source  = ShaderFileReader::readShaderSourceCode(fullPathToFile, _logger);
+  uint64_t const hash = hashSource(source);
+  auto entry          = std::make_shared<Entry const>(Entry{std::move(source), hash});
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (generation != _generation) {
+    return entry;
+  }
+  return _entries.emplace(fullPathToFile, std::move(entry)).first->second;
+}
+
+void IncludeCache::invalidate(std::string const &fullPathToFile) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _entries.erase(fullPathToFile);
+  _generation++;
+}
+
+uint64_t IncludeCache::hashSource(std::string const &source) {
+  uint64_t hash = kFnvOffsetBasis;
+  for (char const c : source) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
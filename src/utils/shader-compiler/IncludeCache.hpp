@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class Logger;
+
+// the sources of the included files, each is read from the disk once, and shared by every
+// compilation of the shader compiler, the shader change listener drops the entries of the changed
+// files, so they're read again on their next include, it's safe to use from several threads
+class IncludeCache {
+public:
+  struct Entry {
+    std::string source;
+    // of the source, so the compilations can tell whether their includes have changed
+    uint64_t hash;
+  };
+
+  IncludeCache(Logger *logger);
+
+  // the entry stays valid for the caller even if it's invalidated meanwhile
+  std::shared_ptr<Entry const> get(std::string const &fullPathToFile);
+  void invalidate(std::string const &fullPathToFile);
+
+  static uint64_t hashSource(std::string const &source);
+
+private:
+  Logger *_logger;
+
+  std::mutex _mutex;
+  std::unordered_map<std::string, std::shared_ptr<Entry const>> _entries{};
+  // bumped by every invalidation, a source read before it isn't cached, since it may be stale
+  uint64_t _generation = 0;
+};
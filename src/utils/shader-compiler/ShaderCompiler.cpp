@@ -1,7 +1,16 @@
 #include "ShaderCompiler.hpp"
 
 #include "CustomFileIncluder.hpp"
+#include "utils/config/RootDir.h"
 #include "utils/logger/Logger.hpp"
+#include "utils/startup-trace/StartupTrace.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
 
 struct PathInfo {
   std::string fullPathToDir;
@@ -9,6 +18,37 @@ struct PathInfo {
 };
 
 namespace {
+// bumped whenever the compile options change in a way that isn't visible in the preprocessed source
+uint32_t constexpr kSpirvCacheVersion = 1;
+
+shaderc_env_version constexpr kTargetEnvVersion        = shaderc_env_version_vulkan_1_2;
+shaderc_optimization_level constexpr kOptimizationLevel = shaderc_optimization_level_performance;
+
+// fnv-1a, mirrors ChunkOctreeCache, the key has to stay the same between launches
+uint64_t constexpr kFnvOffsetBasis = 14695981039346656037ULL;
+uint64_t constexpr kFnvPrime       = 1099511628211ULL;
+
+uint64_t _hashBytes(uint64_t hash, void const *data, size_t size) {
+  auto const *bytes = static_cast<unsigned char const *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+std::string _getPathToCachedSpirv(std::string const &preprocessedSource) {
+  uint64_t hash = kFnvOffsetBasis;
+  hash          = _hashBytes(hash, &kSpirvCacheVersion, sizeof(kSpirvCacheVersion));
+  hash          = _hashBytes(hash, &kTargetEnvVersion, sizeof(kTargetEnvVersion));
+  hash          = _hashBytes(hash, &kOptimizationLevel, sizeof(kOptimizationLevel));
+  hash          = _hashBytes(hash, preprocessedSource.data(), preprocessedSource.size());
+
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return kPathToResourceFolder + "cache/spirv/" + ss.str() + ".spv";
+}
+
 // input: a/b/c.glsl
 // output: {a/b/, c.glsl}
 PathInfo _getFullDirAndFileName(const std::string &fullPath, Logger *logger) {
@@ -25,38 +65,191 @@ PathInfo _getFullDirAndFileName(const std::string &fullPath, Logger *logger) {
 }
 }; // namespace
 
-ShaderCompiler::ShaderCompiler(Logger *logger, std::function<void(std::string const &)> includeCallback) : _logger(logger) {
-  std::unique_ptr<CustomFileIncluder> fileIncluder = std::make_unique<CustomFileIncluder>(logger, includeCallback);
+ShaderCompiler::ShaderCompiler(Logger *logger) : _logger(logger), _includeCache(logger) {
+  // _defaultOptions.SetTargetSpirv(shaderc_spirv_version_1_3);
+  _defaultOptions.SetTargetEnvironment(shaderc_target_env_vulkan, kTargetEnvVersion);
+  _defaultOptions.SetOptimizationLevel(kOptimizationLevel);
+}
+
+void ShaderCompiler::invalidateIncludedFile(std::string const &fullPathToFile) {
+  _includeCache.invalidate(fullPathToFile);
+}
 
-  // _defaultOptions takes the ownership of fileIncluder, but doesn't provide a way to retrieve it,
-  // so we need to store it as a raw pointer
-  _fileIncluder = fileIncluder.get();
+// the macros aren't part of the hashes of the compiled shaders, so they're all preprocessed again
+void ShaderCompiler::addMacroDefinition(std::string const &name) {
+  std::lock_guard<std::mutex> lock(_compiledShadersMutex);
+  _defaultOptions.AddMacroDefinition(name);
+  _compiledShaders.clear();
+  _macroGeneration++;
+}
 
-  _defaultOptions.SetIncluder(std::move(fileIncluder));
-  // _defaultOptions.SetTargetSpirv(shaderc_spirv_version_1_3);
-  _defaultOptions.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_1);
-  _defaultOptions.SetOptimizationLevel(shaderc_optimization_level_performance);
+void ShaderCompiler::addMacroDefinition(std::string const &name, std::string const &value) {
+  std::lock_guard<std::mutex> lock(_compiledShadersMutex);
+  _defaultOptions.AddMacroDefinition(name, value);
+  _compiledShaders.clear();
+  _macroGeneration++;
+}
+
+void ShaderCompiler::prewarm(std::vector<std::string> const &fullPathsToFiles) {
+  for (auto const &fullPathToFile : fullPathsToFiles) {
+    _prewarmTasks[fullPathToFile] = TaskScheduler::get().submit([this, fullPathToFile]() {
+      auto const fileName = _getFullDirAndFileName(fullPathToFile, _logger).fileName;
+      StartupTrace::Scope scope("prewarm " + fileName);
+      auto const sourceCode = ShaderFileReader::readShaderSourceCode(fullPathToFile, _logger);
+      std::vector<std::string> includedFiles{};
+      _compile(fullPathToFile, sourceCode, includedFiles);
+    });
+  }
 }
 
 std::optional<std::vector<uint32_t>>
 ShaderCompiler::compileComputeShader(const std::string &fullPathToFile,
-                                     std::string const &sourceCode) {
+                                     std::string const &sourceCode,
+                                     std::vector<std::string> &includedFiles) {
+  // the calling thread runs the other tasks meanwhile, the task is done already after the startup
+  auto const prewarmTask = _prewarmTasks.find(fullPathToFile);
+  if (prewarmTask != _prewarmTasks.end()) {
+    TaskScheduler::get().wait(prewarmTask->second);
+  }
+  return _compile(fullPathToFile, sourceCode, includedFiles);
+}
+
+std::optional<std::vector<uint32_t>>
+ShaderCompiler::_compile(const std::string &fullPathToFile, std::string const &sourceCode,
+                         std::vector<std::string> &includedFiles) {
   auto const fullDirAndFileName = _getFullDirAndFileName(fullPathToFile, _logger);
 
-  _fileIncluder->setIncludeDir(fullDirAndFileName.fullPathToDir);
+  // the second compilation of a prewarmed shader at the startup, and the ones whose includes were
+  // saved unchanged, go straight to the disk cache
+  uint64_t const sourceHash = IncludeCache::hashSource(sourceCode);
+  if (auto const pathToCachedSpirv =
+          _findCompiledShader(fullPathToFile, sourceHash, includedFiles)) {
+    if (auto cachedSpirv = _loadCachedSpirv(*pathToCachedSpirv)) {
+      return cachedSpirv;
+    }
+  }
+
+  // every compilation owns its options, and the includer in them, so the concurrent ones don't
+  // share the include directory, the options clone the macro definitions
+  std::unique_lock<std::mutex> optionsLock(_compiledShadersMutex);
+  shaderc::CompileOptions options(_defaultOptions);
+  uint64_t const macroGeneration = _macroGeneration;
+  optionsLock.unlock();
+  std::vector<IncludedFile> compiledIncludedFiles{};
+  auto fileIncluder = std::make_unique<CustomFileIncluder>(
+      &_includeCache, [&](std::string const &fullPathToIncludedFile, uint64_t hash) {
+        includedFiles.push_back(fullPathToIncludedFile);
+        compiledIncludedFiles.push_back({fullPathToIncludedFile, hash});
+      });
+  fileIncluder->setIncludeDir(fullDirAndFileName.fullPathToDir);
+  options.SetIncluder(std::move(fileIncluder));
 
-  std::optional<std::vector<uint32_t>> res = std::nullopt;
-  shaderc_shader_kind const kind           = shaderc_glsl_compute_shader;
+  shaderc_shader_kind const kind = shaderc_glsl_compute_shader;
+
+  // the preprocessing resolves the includes, which are also reported on a cache hit, it's cheap
+  // compared to the optimization passes
+  shaderc::PreprocessedSourceCompilationResult preprocessResult =
+      this->PreprocessGlsl(sourceCode, kind, fullDirAndFileName.fileName.c_str(), options);
+  if (preprocessResult.GetCompilationStatus() != shaderc_compilation_status_success) {
+    _logger->warn(preprocessResult.GetErrorMessage());
+    return std::nullopt;
+  }
+
+  std::string const pathToCachedSpirv =
+      _getPathToCachedSpirv(std::string(preprocessResult.cbegin(), preprocessResult.cend()));
+  auto const storeCompiledShader = [&]() {
+    std::lock_guard<std::mutex> lock(_compiledShadersMutex);
+    if (macroGeneration == _macroGeneration) {
+      _compiledShaders[fullPathToFile] = {sourceHash, compiledIncludedFiles, pathToCachedSpirv};
+    }
+  };
+  if (auto cachedSpirv = _loadCachedSpirv(pathToCachedSpirv)) {
+    storeCompiledShader();
+    return cachedSpirv;
+  }
 
   // from shaderc's doc:
   // the input_file_name is used as a tag to identify the source string in cases like emitting error
   // messages, it doesn't have to be a file name
-  shaderc::SpvCompilationResult compilationResult = this->CompileGlslToSpv(
-      sourceCode, kind, fullDirAndFileName.fileName.c_str(), _defaultOptions);
+  shaderc::SpvCompilationResult compilationResult =
+      this->CompileGlslToSpv(sourceCode, kind, fullDirAndFileName.fileName.c_str(), options);
 
   if (compilationResult.GetCompilationStatus() != shaderc_compilation_status_success) {
     _logger->warn(compilationResult.GetErrorMessage());
     return std::nullopt;
   }
-  return std::vector<uint32_t>(compilationResult.cbegin(), compilationResult.cend());
+  std::vector<uint32_t> spirv(compilationResult.cbegin(), compilationResult.cend());
+  _storeCachedSpirv(pathToCachedSpirv, spirv);
+  storeCompiledShader();
+  return spirv;
+}
+
+std::optional<std::string>
+ShaderCompiler::_findCompiledShader(std::string const &fullPathToFile, uint64_t sourceHash,
+                                    std::vector<std::string> &includedFiles) {
+  CompiledShader compiledShader{};
+  {
+    std::lock_guard<std::mutex> lock(_compiledShadersMutex);
+    auto const it = _compiledShaders.find(fullPathToFile);
+    if (it == _compiledShaders.end() || it->second.sourceHash != sourceHash) {
+      return std::nullopt;
+    }
+    compiledShader = it->second;
+  }
+
+  // the includes are compared by their content, a file that's saved without a change still hits,
+  // the ones invalidated since are read again by the cache
+  for (auto const &includedFile : compiledShader.includedFiles) {
+    if (_includeCache.get(includedFile.fullPath)->hash != includedFile.hash) {
+      return std::nullopt;
+    }
+  }
+  for (auto const &includedFile : compiledShader.includedFiles) {
+    includedFiles.push_back(includedFile.fullPath);
+  }
+  return compiledShader.pathToCachedSpirv;
+}
+
+std::optional<std::vector<uint32_t>>
+ShaderCompiler::_loadCachedSpirv(std::string const &pathToFile) const {
+  std::ifstream file(pathToFile, std::ios::ate | std::ios::binary);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  auto const fileSize = static_cast<size_t>(file.tellg());
+  if (fileSize == 0 || fileSize % sizeof(uint32_t) != 0) {
+    _logger->warn("the cached spir-v at {} is corrupted, it's compiled again", pathToFile);
+    return std::nullopt;
+  }
+
+  std::vector<uint32_t> spirv(fileSize / sizeof(uint32_t));
+  file.seekg(0);
+  file.read(reinterpret_cast<char *>(spirv.data()), static_cast<std::streamsize>(fileSize));
+  if (!file) {
+    return std::nullopt;
+  }
+  return spirv;
+}
+
+// written to a temporary file first, so a crash mid-write never leaves a truncated cache entry
+void ShaderCompiler::_storeCachedSpirv(std::string const &pathToFile,
+                                       std::vector<uint32_t> const &spirv) const {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+
+  std::string const temporaryPath = pathToFile + ".tmp";
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      _logger->warn("failed to write the cached spir-v to {}", temporaryPath);
+      return;
+    }
+    file.write(reinterpret_cast<char const *>(spirv.data()),
+               static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+  }
+  std::filesystem::rename(temporaryPath, pathToFile, errorCode);
+  if (errorCode) {
+    _logger->warn("failed to write the cached spir-v to {}", pathToFile);
+    std::remove(temporaryPath.c_str());
+  }
 }
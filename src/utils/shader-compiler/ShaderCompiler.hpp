@@ -1,27 +1,80 @@
 #pragma once
 
+#include "IncludeCache.hpp"
+#include "scheduler/TaskScheduler.hpp"
 #include "shaderc/shaderc.hpp"
 #include "utils/io/ShaderFileReader.hpp"
 
 #include <cstdint>
-#include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class Logger;
-class CustomFileIncluder;
 
+// the shaders can be compiled from several threads at once, a macro may be added meanwhile, the
+// compilations that started before it don't see it
 class ShaderCompiler : public shaderc::Compiler {
 public:
-  ShaderCompiler(Logger *logger,
-                 std::function<void(std::string const &)> includeCallback = nullptr);
+  ShaderCompiler(Logger *logger);
 
-  std::optional<std::vector<uint32_t>> compileComputeShader(const std::string &fullPathToFile,
-                                                            std::string const &sourceCode);
+  // the spir-v is cached on the disk, keyed by the hash of the preprocessed source, which contains
+  // the included files and the macro definitions, so only the changed shaders are optimized again,
+  // a shader whose source and includes hash the same as in its last compilation isn't even
+  // preprocessed, the full paths of the included files are appended to includedFiles
+  std::optional<std::vector<uint32_t>>
+  compileComputeShader(const std::string &fullPathToFile, std::string const &sourceCode,
+                       std::vector<std::string> &includedFiles);
+
+  // drops the cached source of a changed file, the shaders that include it are preprocessed again
+  void invalidateIncludedFile(std::string const &fullPathToFile);
+
+  // defined for all of the shaders compiled afterwards
+  void addMacroDefinition(std::string const &name);
+  void addMacroDefinition(std::string const &name, std::string const &value);
+
+  // the shaders are compiled to the disk cache by the tasks of the scheduler, while the startup
+  // goes on, a compilation of one of them waits for its task and reads the cache, it's called once,
+  // after the last macro is added, and before the first compilation
+  void prewarm(std::vector<std::string> const &fullPathsToFiles);
 
 private:
+  struct IncludedFile {
+    std::string fullPath;
+    uint64_t hash;
+  };
+  // the last successful compilation of a shader, its includes are in the order they were included
+  struct CompiledShader {
+    uint64_t sourceHash;
+    std::vector<IncludedFile> includedFiles;
+    std::string pathToCachedSpirv;
+  };
+
   Logger *_logger;
+  IncludeCache _includeCache;
+  // guards the default options as well, the prewarm tasks copy them while the startup may still
+  // add macros
+  std::mutex _compiledShadersMutex;
   shaderc::CompileOptions _defaultOptions;
-  CustomFileIncluder *_fileIncluder;
+  // keyed by the full path to the shader, cleared when a macro is added
+  std::unordered_map<std::string, CompiledShader> _compiledShaders{};
+  // bumped by every added macro, a compilation that copied the options before it isn't kept
+  uint64_t _macroGeneration = 0;
+  // only written by prewarm
+  std::unordered_map<std::string, TaskScheduler::TaskHandle> _prewarmTasks{};
+
+  std::optional<std::vector<uint32_t>> _compile(const std::string &fullPathToFile,
+                                                std::string const &sourceCode,
+                                                std::vector<std::string> &includedFiles);
+  // the path to the cached spir-v of the last compilation, if neither the source nor any of the
+  // includes has changed since, the includes are appended to includedFiles then
+  std::optional<std::string> _findCompiledShader(std::string const &fullPathToFile,
+                                                 uint64_t sourceHash,
+                                                 std::vector<std::string> &includedFiles);
+
+  std::optional<std::vector<uint32_t>> _loadCachedSpirv(std::string const &pathToFile) const;
+  void _storeCachedSpirv(std::string const &pathToFile, std::vector<uint32_t> const &spirv) const;
 
 }; // namespace ShaderCompiler
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "StartupTrace.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace {
+// the phases are printed as they are, so the names must not need escaping
+void _writePhase(std::ofstream &file, std::string const &name, uint32_t threadIndex,
+                 double startInUs, double durationInUs) {
+  file << R"({"name":")" << name << R"(","cat":"startup","ph":"X","pid":0,"tid":)" << threadIndex
+       << R"(,"ts":)" << startInUs << R"(,"dur":)" << durationInUs << "}";
+}
+} // namespace
+
+StartupTrace::Scope::Scope(std::string name)
+    : _name(std::move(name)), _startTime(std::chrono::steady_clock::now()) {}
+
+StartupTrace::Scope::~Scope() {
+  StartupTrace::get().addPhase(std::move(_name), _startTime, std::chrono::steady_clock::now());
+}
+
+StartupTrace &StartupTrace::get() {
+  static StartupTrace startupTrace{};
+  return startupTrace;
+}
+
+void StartupTrace::start() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _isRecording = true;
+  _origin      = std::chrono::steady_clock::now();
+  _phases.clear();
+  _threadIndices.clear();
+  _threadIndices[std::this_thread::get_id()] = 0;
+}
+
+void StartupTrace::addPhase(std::string name, std::chrono::steady_clock::time_point startTime,
+                            std::chrono::steady_clock::time_point endTime) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!_isRecording) {
+    return;
+  }
+  double const startInUs = _toUs(startTime);
+  _phases.push_back({std::move(name), _getThreadIndex(), startInUs, _toUs(endTime) - startInUs});
+}
+
+double StartupTrace::finish() {
+  auto const endTime = std::chrono::steady_clock::now();
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!_isRecording) {
+    return 0.0;
+  }
+  _phases.push_back({"time to first frame", _getThreadIndex(), 0.0, _toUs(endTime)});
+  _isRecording = false;
+  return std::chrono::duration<double, std::milli>(endTime - _origin).count();
+}
+
+bool StartupTrace::writeJson(std::string const &pathToFile) const {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+  std::ofstream file(pathToFile, std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  file << std::fixed;
+  file.precision(1);
+  file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  for (size_t i = 0; i < _phases.size(); i++) {
+    Phase const &phase = _phases[i];
+    file << (i == 0 ? "\n" : ",\n");
+    _writePhase(file, phase.name, phase.threadIndex, phase.startInUs, phase.durationInUs);
+  }
+  file << "\n]}\n";
+  file.close();
+  return static_cast<bool>(file);
+}
+
+// the mutex is held
+uint32_t StartupTrace::_getThreadIndex() {
+  return _threadIndices
+      .try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(_threadIndices.size()))
+      .first->second;
+}
+
+double StartupTrace::_toUs(std::chrono::steady_clock::time_point timePoint) const {
+  return std::chrono::duration<double, std::micro>(timePoint - _origin).count();
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// the phases of the startup, from the construction of the application to its first frame, on all
+// of the threads, kept as the complete events of the chrome trace format, so the critical path and
+// the overlap of the tasks can be read off chrome://tracing or perfetto, the phases can be recorded
+// from any thread, the recording stops with the first frame
+class StartupTrace {
+public:
+  // a phase from its construction to its destruction
+  class Scope {
+  public:
+    explicit Scope(std::string name);
+    ~Scope();
+
+    // delete copy and move
+    Scope(const Scope &)            = delete;
+    Scope &operator=(const Scope &) = delete;
+    Scope(Scope &&)                 = delete;
+    Scope &operator=(Scope &&)      = delete;
+
+  private:
+    std::string _name;
+    std::chrono::steady_clock::time_point _startTime;
+  };
+
+  static StartupTrace &get();
+
+  // the origin of the trace, and of the time to the first frame
+  void start();
+  void addPhase(std::string name, std::chrono::steady_clock::time_point startTime,
+                std::chrono::steady_clock::time_point endTime);
+  // records the first frame, the later phases are dropped, returns the time to the first frame
+  double finish();
+
+  bool writeJson(std::string const &pathToFile) const;
+
+private:
+  struct Phase {
+    std::string name;
+    uint32_t threadIndex;
+    double startInUs;
+    double durationInUs;
+  };
+
+  mutable std::mutex _mutex;
+  bool _isRecording = false;
+  std::chrono::steady_clock::time_point _origin{};
+  std::vector<Phase> _phases{};
+  // the threads are numbered in the order they record their first phase, the starting thread is 0
+  std::unordered_map<std::thread::id, uint32_t> _threadIndices{};
+
+  uint32_t _getThreadIndex();
+  double _toUs(std::chrono::steady_clock::time_point timePoint) const;
+};
@@ -10,6 +10,7 @@
 #include <optional>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 template <class T> struct ArrayTrait : std::false_type {
   using type = void;
@@ -44,6 +45,24 @@ public:
     return defaultConfigOpt.value();
   }
 
+  // for the arrays of any length, the elements are of the types that getConfig takes, an array
+  // that isn't found in either of the configs is empty
+  template <class T> std::vector<T> getConfigArray(std::string const &configItemPath) {
+    auto customConfigOpt = _tryGetConfigArray<T>(ConfigType::kCustom, configItemPath);
+    if (customConfigOpt.has_value()) {
+      _logger->info("TomlConfigReader::getConfigArray() got custom config at {}", configItemPath);
+      return customConfigOpt.value();
+    }
+
+    auto defaultConfigOpt = _tryGetConfigArray<T>(ConfigType::kDefault, configItemPath);
+    if (!defaultConfigOpt.has_value()) {
+      _logger->error("TomlConfigReader::getConfigArray() failed to get default config at {}",
+                     configItemPath);
+      return {};
+    }
+    return defaultConfigOpt.value();
+  }
+
 private:
   Logger *_logger;
   std::unique_ptr<toml::v3::parse_result> _defaultConfig;
@@ -99,4 +118,35 @@ private:
       return res;
     }
   }
+
+  template <class T>
+  std::optional<std::vector<T>> _tryGetConfigArray(ConfigType configType,
+                                                    std::string const &configItemPath) {
+    toml::v3::parse_result const &config =
+        configType == ConfigType::kDefault ? *_defaultConfig : *_customConfig;
+
+    if (!config.succeeded()) {
+      return std::nullopt;
+    }
+    toml::array const *array = config.at_path(configItemPath).as_array();
+    if (!array) {
+      return std::nullopt;
+    }
+
+    // mirrors _tryGetConfig, for each of the elements
+    std::vector<T> res;
+    res.reserve(array->size());
+    for (size_t i = 0; i < array->size(); i++) {
+      std::string const elementPath = configItemPath + "[" + std::to_string(i) + "]";
+      auto val                      = _tryGetConfig<T>(configType, elementPath);
+      if (val == std::nullopt) {
+        _logger->error("TomlConfigReader::_tryGetConfigArray() array has invalid value for the "
+                       "{}th element at {}",
+                       i, configItemPath);
+        return std::nullopt;
+      }
+      res.push_back(val.value());
+    }
+    return res;
+  }
 };
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "TraversalStatsSink.hpp"
+
+#include <utility>
+
+float TraversalStatsSink::RayTypeStats::getAvgIter() const {
+  return rayCount == 0 ? 0.F
+                       : static_cast<float>(static_cast<double>(iterSum) /
+                                            static_cast<double>(rayCount));
+}
+
+float TraversalStatsSink::RayTypeStats::getAvgChunkTraversed() const {
+  return rayCount == 0 ? 0.F
+                       : static_cast<float>(static_cast<double>(chunkTraversedSum) /
+                                            static_cast<double>(rayCount));
+}
+
+TraversalStatsSink::TraversalStatsSink(std::vector<std::string> rayTypeNames)
+    : _rayTypeNames(std::move(rayTypeNames)) {}
+
+TraversalStatsSink::~TraversalStatsSink() = default;
+
+void TraversalStatsSink::addRecord(std::vector<RayTypeStats> rayTypeStats) {
+  _latestStats = std::move(rayTypeStats);
+}
+
+void TraversalStatsSink::clear() { _latestStats.clear(); }
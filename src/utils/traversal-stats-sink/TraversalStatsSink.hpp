@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// the traversal statistics of the rays of the latest frame that has them, per ray type, for the gui
+// and the benchmark, the iterations are bucketed by their log2 and the traversed chunks by their
+// count
+class TraversalStatsSink {
+public:
+  struct RayTypeStats {
+    uint32_t rayCount          = 0;
+    uint64_t iterSum           = 0;
+    uint64_t chunkTraversedSum = 0;
+    std::vector<uint32_t> iterBuckets{};
+    std::vector<uint32_t> chunkBuckets{};
+
+    [[nodiscard]] float getAvgIter() const;
+    [[nodiscard]] float getAvgChunkTraversed() const;
+  };
+
+  explicit TraversalStatsSink(std::vector<std::string> rayTypeNames);
+  ~TraversalStatsSink();
+
+  // delete copy and move
+  TraversalStatsSink(const TraversalStatsSink &)            = delete;
+  TraversalStatsSink &operator=(const TraversalStatsSink &) = delete;
+  TraversalStatsSink(TraversalStatsSink &&)                 = delete;
+  TraversalStatsSink &operator=(TraversalStatsSink &&)      = delete;
+
+  // one per ray type
+  void addRecord(std::vector<RayTypeStats> rayTypeStats);
+  void clear();
+
+  [[nodiscard]] std::vector<std::string> const &getRayTypeNames() const { return _rayTypeNames; }
+  // false until a frame with the statistics is recorded
+  [[nodiscard]] bool hasRecord() const { return !_latestStats.empty(); }
+  [[nodiscard]] RayTypeStats const &getLatestStats(size_t rayType) const {
+    return _latestStats[rayType];
+  }
+
+private:
+  std::vector<std::string> _rayTypeNames;
+  std::vector<RayTypeStats> _latestStats{};
+};
@@ -5,9 +5,30 @@
 #include "../memory/Buffer.hpp"
 #include "../memory/BufferBundle.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+
+namespace {
+template <typename T>
+std::vector<std::pair<uint32_t, T>>
+_filterBindings(std::vector<std::pair<uint32_t, T>> const &bindings,
+                std::unordered_set<uint32_t> const &bindingSlots) {
+  std::vector<std::pair<uint32_t, T>> filteredBindings{};
+  std::copy_if(bindings.begin(), bindings.end(), std::back_inserter(filteredBindings),
+               [&](auto const &binding) { return bindingSlots.count(binding.first) != 0; });
+  return filteredBindings;
+}
+} // namespace
 
 DescriptorSetBundle::~DescriptorSetBundle() {
+  for (auto *subBundle : _subBundles) {
+    subBundle->_parent = nullptr;
+  }
+  if (_parent != nullptr) {
+    auto &siblings = _parent->_subBundles;
+    siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+  }
   vkDestroyDescriptorSetLayout(_appContext->getDevice(), _descriptorSetLayout, nullptr);
   vkDestroyDescriptorPool(_appContext->getDevice(), _descriptorPool, nullptr);
 }
@@ -47,12 +68,155 @@ void DescriptorSetBundle::bindStorageBuffer(uint32_t bindingSlot, Buffer *buffer
   _storageBuffers.emplace_back(bindingSlot, buffer);
 }
 
+void DescriptorSetBundle::bindStorageBufferBundle(uint32_t bindingSlot,
+                                                  BufferBundle *bufferBundle) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+  assert(bufferBundle->getBundleSize() == _bundleSize &&
+         "the size of the storage buffer bundle must be the same as the descriptor set bundle");
+
+  _boundedSlots.insert(bindingSlot);
+  _storageBufferBundles.emplace_back(bindingSlot, bufferBundle);
+}
+
+void DescriptorSetBundle::bindStorageImageBundle(uint32_t bindingSlot,
+                                                 std::vector<Image *> const &storageImages) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+  assert(storageImages.size() == _bundleSize &&
+         "the size of the storage image bundle must be the same as the descriptor set bundle");
+
+  _boundedSlots.insert(bindingSlot);
+  _storageImageBundles.emplace_back(bindingSlot, storageImages);
+}
+
+void DescriptorSetBundle::bindImageSamplerBundle(uint32_t bindingSlot,
+                                                 std::vector<Image *> const &storageImages) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+  assert(storageImages.size() == _bundleSize &&
+         "the size of the image sampler bundle must be the same as the descriptor set bundle");
+
+  _boundedSlots.insert(bindingSlot);
+  _imageSamplerBundles.emplace_back(bindingSlot, storageImages);
+}
+
+void DescriptorSetBundle::bindStorageBufferArray(uint32_t bindingSlot,
+                                                 std::vector<Buffer *> const &buffers,
+                                                 uint32_t arraySize) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+  assert(!buffers.empty() && buffers.size() <= arraySize &&
+         "the storage buffer array must hold at least one buffer, and at most its size");
+
+  _boundedSlots.insert(bindingSlot);
+  _bufferArrays.push_back({bindingSlot, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, arraySize, buffers});
+}
+
+void DescriptorSetBundle::bindUniformTexelBufferArray(uint32_t bindingSlot,
+                                                      std::vector<Buffer *> const &buffers,
+                                                      uint32_t arraySize) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+  assert(!buffers.empty() && buffers.size() <= arraySize &&
+         "the texel buffer array must hold at least one buffer, and at most its size");
+
+  _boundedSlots.insert(bindingSlot);
+  _bufferArrays.push_back(
+      {bindingSlot, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, arraySize, buffers});
+}
+
+void DescriptorSetBundle::updateBufferArray(uint32_t bindingSlot,
+                                            std::vector<Buffer *> const &buffers) {
+  auto it = std::find_if(_bufferArrays.begin(), _bufferArrays.end(),
+                         [bindingSlot](BufferArray const &array) {
+                           return array.bindingSlot == bindingSlot;
+                         });
+  assert(it != _bufferArrays.end() && "the binding is not a buffer array");
+  assert(!buffers.empty() && buffers.size() <= it->arraySize &&
+         "the buffer array must hold at least one buffer, and at most its size");
+
+  // only the elements from the first changed one on are written if the others may be in use
+  uint32_t firstElement = 0;
+  if (areBufferArraysUpdatedAfterBind()) {
+    while (firstElement < std::min(buffers.size(), it->buffers.size()) &&
+           buffers[firstElement] == it->buffers[firstElement]) {
+      firstElement++;
+    }
+  }
+
+  it->buffers = buffers;
+  for (uint32_t j = 0; j < _bundleSize; j++) {
+    _writeBufferArray(j, *it, firstElement);
+  }
+
+  for (auto *subBundle : _subBundles) {
+    if (subBundle->_boundedSlots.count(bindingSlot) != 0) {
+      subBundle->updateBufferArray(bindingSlot, buffers);
+    }
+  }
+}
+
+bool DescriptorSetBundle::areBufferArraysUpdatedAfterBind() const {
+  return _appContext->isDescriptorUpdateAfterBindSupported();
+}
+
+void DescriptorSetBundle::bindStorageImageArray(uint32_t bindingSlot,
+                                                std::vector<Image *> const &storageImages,
+                                                uint32_t arraySize) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+  assert(!storageImages.empty() && storageImages.size() <= arraySize &&
+         "the storage image array must hold at least one image, and at most its size");
+
+  _boundedSlots.insert(bindingSlot);
+  _storageImageArrays.push_back({bindingSlot, arraySize, storageImages});
+}
+
+void DescriptorSetBundle::bindAccelerationStructure(
+    uint32_t bindingSlot, VkAccelerationStructureKHR const *accelerationStructure) {
+  assert(_boundedSlots.find(bindingSlot) == _boundedSlots.end() && "binding socket duplicated");
+
+  _boundedSlots.insert(bindingSlot);
+  _accelerationStructures.emplace_back(bindingSlot, accelerationStructure);
+}
+
 void DescriptorSetBundle::create() {
   _createDescriptorPool();
   _createDescriptorSetLayout();
   _createDescriptorSets();
 }
 
+std::unique_ptr<DescriptorSetBundle>
+DescriptorSetBundle::createSubBundle(std::vector<uint32_t> const &bindingSlots) {
+  std::unordered_set<uint32_t> slots{};
+  for (uint32_t const bindingSlot : bindingSlots) {
+    if (_boundedSlots.count(bindingSlot) != 0) {
+      slots.insert(bindingSlot);
+    }
+  }
+
+  auto subBundle =
+      std::make_unique<DescriptorSetBundle>(_appContext, _bundleSize, _shaderStageFlags);
+  subBundle->_boundedSlots           = slots;
+  subBundle->_uniformBufferBundles   = _filterBindings(_uniformBufferBundles, slots);
+  subBundle->_storageImages          = _filterBindings(_storageImages, slots);
+  subBundle->_imageSamplers          = _filterBindings(_imageSamplers, slots);
+  subBundle->_storageBuffers         = _filterBindings(_storageBuffers, slots);
+  subBundle->_storageBufferBundles   = _filterBindings(_storageBufferBundles, slots);
+  subBundle->_storageImageBundles    = _filterBindings(_storageImageBundles, slots);
+  subBundle->_imageSamplerBundles    = _filterBindings(_imageSamplerBundles, slots);
+  subBundle->_accelerationStructures = _filterBindings(_accelerationStructures, slots);
+  std::copy_if(_bufferArrays.begin(), _bufferArrays.end(),
+               std::back_inserter(subBundle->_bufferArrays), [&](BufferArray const &array) {
+                 return slots.count(array.bindingSlot) != 0;
+               });
+  std::copy_if(_storageImageArrays.begin(), _storageImageArrays.end(),
+               std::back_inserter(subBundle->_storageImageArrays),
+               [&](StorageImageArray const &array) {
+                 return slots.count(array.bindingSlot) != 0;
+               });
+  subBundle->create();
+
+  subBundle->_parent = this;
+  _subBundles.push_back(subBundle.get());
+  return subBundle;
+}
+
 void DescriptorSetBundle::_createDescriptorPool() {
   std::vector<VkDescriptorPoolSize> poolSizes{};
 
@@ -66,38 +230,69 @@ void DescriptorSetBundle::_createDescriptorPool() {
         VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniformBufferSize});
   }
 
-  auto storageImageSize = static_cast<uint32_t>(_storageImages.size());
+  uint32_t storageImageArrayElementCount = 0;
+  for (auto const &array : _storageImageArrays) {
+    storageImageArrayElementCount += array.arraySize;
+  }
+  auto storageImageSize = static_cast<uint32_t>(
+      (_storageImages.size() + _storageImageBundles.size() + storageImageArrayElementCount) *
+      _bundleSize);
   if (storageImageSize > 0) {
     poolSizes.emplace_back(
         VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, storageImageSize});
   }
 
-  auto imageSamplerSize = static_cast<uint32_t>(_imageSamplers.size());
+  auto imageSamplerSize =
+      static_cast<uint32_t>((_imageSamplers.size() + _imageSamplerBundles.size()) * _bundleSize);
   if (imageSamplerSize > 0) {
     poolSizes.emplace_back(
         VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, imageSamplerSize});
   }
 
-  auto storageBufferSize = static_cast<uint32_t>(_storageBuffers.size());
+  uint32_t storageBufferArrayElementCount = 0;
+  uint32_t texelBufferArrayElementCount   = 0;
+  for (auto const &array : _bufferArrays) {
+    if (array.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER) {
+      storageBufferArrayElementCount += array.arraySize;
+    } else {
+      texelBufferArrayElementCount += array.arraySize;
+    }
+  }
+  auto storageBufferSize = static_cast<uint32_t>(
+      (_storageBuffers.size() + _storageBufferBundles.size() + storageBufferArrayElementCount) *
+      _bundleSize);
   if (storageBufferSize > 0) {
     poolSizes.emplace_back(
         VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, storageBufferSize});
   }
 
+  auto texelBufferSize = static_cast<uint32_t>(texelBufferArrayElementCount * _bundleSize);
+  if (texelBufferSize > 0) {
+    poolSizes.emplace_back(
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, texelBufferSize});
+  }
+
+  auto accelerationStructureSize =
+      static_cast<uint32_t>(_accelerationStructures.size() * _bundleSize);
+  if (accelerationStructureSize > 0) {
+    poolSizes.emplace_back(VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+                                                accelerationStructureSize});
+  }
+
   VkDescriptorPoolCreateInfo poolInfo{};
   poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
   // the max number of descriptor sets that can be allocated from this pool
   poolInfo.maxSets       = static_cast<uint32_t>(_bundleSize);
   poolInfo.pPoolSizes    = poolSizes.data();
   poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+  if (!_bufferArrays.empty() && areBufferArraysUpdatedAfterBind()) {
+    poolInfo.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+  }
 
   vkCreateDescriptorPool(_appContext->getDevice(), &poolInfo, nullptr, &_descriptorPool);
 }
 
-void DescriptorSetBundle::_createDescriptorSetLayout() {
-  // creates descriptor set layout that will be used to create every descriptor
-  // set features are extracted from buffer bundles, not buffers, thus to be
-  // reused in descriptor set creation
+std::vector<VkDescriptorSetLayoutBinding> DescriptorSetBundle::getLayoutBindings() const {
   std::vector<VkDescriptorSetLayoutBinding> bindings{};
 
   for (auto const &[bindingNo, _] : _uniformBufferBundles) {
@@ -118,6 +313,24 @@ void DescriptorSetBundle::_createDescriptorSetLayout() {
     bindings.push_back(samplerLayoutBinding);
   }
 
+  for (auto const &[bindingNo, _] : _storageImageBundles) {
+    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+    samplerLayoutBinding.binding         = bindingNo;
+    samplerLayoutBinding.descriptorCount = 1;
+    samplerLayoutBinding.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    samplerLayoutBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(samplerLayoutBinding);
+  }
+
+  for (auto const &array : _storageImageArrays) {
+    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+    samplerLayoutBinding.binding         = array.bindingSlot;
+    samplerLayoutBinding.descriptorCount = array.arraySize;
+    samplerLayoutBinding.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    samplerLayoutBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(samplerLayoutBinding);
+  }
+
   for (auto const &[bindingNo, _] : _imageSamplers) {
     VkDescriptorSetLayoutBinding samplerLayoutBinding{};
     samplerLayoutBinding.binding         = bindingNo;
@@ -127,6 +340,15 @@ void DescriptorSetBundle::_createDescriptorSetLayout() {
     bindings.push_back(samplerLayoutBinding);
   }
 
+  for (auto const &[bindingNo, _] : _imageSamplerBundles) {
+    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+    samplerLayoutBinding.binding         = bindingNo;
+    samplerLayoutBinding.descriptorCount = 1;
+    samplerLayoutBinding.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    samplerLayoutBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(samplerLayoutBinding);
+  }
+
   for (auto const &[bindingNo, _] : _storageBuffers) {
     VkDescriptorSetLayoutBinding storageBufferBinding{};
     storageBufferBinding.binding         = bindingNo;
@@ -136,11 +358,68 @@ void DescriptorSetBundle::_createDescriptorSetLayout() {
     bindings.push_back(storageBufferBinding);
   }
 
+  for (auto const &[bindingNo, _] : _storageBufferBundles) {
+    VkDescriptorSetLayoutBinding storageBufferBinding{};
+    storageBufferBinding.binding         = bindingNo;
+    storageBufferBinding.descriptorCount = 1;
+    storageBufferBinding.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    storageBufferBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(storageBufferBinding);
+  }
+
+  for (auto const &array : _bufferArrays) {
+    VkDescriptorSetLayoutBinding bufferArrayBinding{};
+    bufferArrayBinding.binding         = array.bindingSlot;
+    bufferArrayBinding.descriptorCount = array.arraySize;
+    bufferArrayBinding.descriptorType  = array.descriptorType;
+    bufferArrayBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(bufferArrayBinding);
+  }
+
+  for (auto const &[bindingNo, _] : _accelerationStructures) {
+    VkDescriptorSetLayoutBinding accelerationStructureBinding{};
+    accelerationStructureBinding.binding         = bindingNo;
+    accelerationStructureBinding.descriptorCount = 1;
+    accelerationStructureBinding.descriptorType  = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+    accelerationStructureBinding.stageFlags      = _shaderStageFlags;
+    bindings.push_back(accelerationStructureBinding);
+  }
+  return bindings;
+}
+
+void DescriptorSetBundle::_createDescriptorSetLayout() {
+  // creates descriptor set layout that will be used to create every descriptor
+  // set features are extracted from buffer bundles, not buffers, thus to be
+  // reused in descriptor set creation
+  std::vector<VkDescriptorSetLayoutBinding> const bindings = getLayoutBindings();
+
   VkDescriptorSetLayoutCreateInfo layoutInfo{};
   layoutInfo.sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
   layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
   layoutInfo.pBindings    = bindings.data();
 
+  // the flags of the buffer arrays, the other bindings are written once before any use
+  std::vector<VkDescriptorBindingFlags> bindingFlags(bindings.size(), 0);
+  VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO};
+  if (!_bufferArrays.empty() && areBufferArraysUpdatedAfterBind()) {
+    for (size_t i = 0; i < bindings.size(); i++) {
+      bool const isBufferArray = std::any_of(
+          _bufferArrays.begin(), _bufferArrays.end(), [&](BufferArray const &array) {
+            return array.bindingSlot == bindings[i].binding;
+          });
+      if (isBufferArray) {
+        bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+      }
+    }
+    bindingFlagsInfo.bindingCount  = static_cast<uint32_t>(bindingFlags.size());
+    bindingFlagsInfo.pBindingFlags = bindingFlags.data();
+    layoutInfo.pNext               = &bindingFlagsInfo;
+    layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+  }
+
   vkCreateDescriptorSetLayout(_appContext->getDevice(), &layoutInfo, nullptr,
                               &_descriptorSetLayout);
 }
@@ -185,6 +464,24 @@ void DescriptorSetBundle::_createDescriptorSet(uint32_t descriptorSetIndex) {
     descriptorWrites.push_back(descriptorWrite);
   }
 
+  std::vector<VkDescriptorImageInfo> storageImageBundleInfos{};
+  storageImageBundleInfos.reserve(_storageImageBundles.size());
+  for (auto const &[_, storageImages] : _storageImageBundles) {
+    storageImageBundleInfos.push_back(
+        storageImages[descriptorSetIndex]->getDescriptorInfo(VK_IMAGE_LAYOUT_GENERAL));
+  }
+  for (uint32_t i = 0; i < _storageImageBundles.size(); i++) {
+    auto const &[bindingNo, _] = _storageImageBundles[i];
+    VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    descriptorWrite.dstSet          = dstSet;
+    descriptorWrite.dstBinding      = bindingNo;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo      = &storageImageBundleInfos[i];
+    descriptorWrites.push_back(descriptorWrite);
+  }
+
   std::vector<VkDescriptorImageInfo> imageSamplerInfos{};
   imageSamplerInfos.reserve(_imageSamplers.size());
   for (auto const &[_, storageImage] : _imageSamplers) {
@@ -203,6 +500,24 @@ void DescriptorSetBundle::_createDescriptorSet(uint32_t descriptorSetIndex) {
     descriptorWrites.push_back(descriptorWrite);
   }
 
+  std::vector<VkDescriptorImageInfo> imageSamplerBundleInfos{};
+  imageSamplerBundleInfos.reserve(_imageSamplerBundles.size());
+  for (auto const &[_, storageImages] : _imageSamplerBundles) {
+    imageSamplerBundleInfos.push_back(
+        storageImages[descriptorSetIndex]->getDescriptorInfo(VK_IMAGE_LAYOUT_GENERAL));
+  }
+  for (uint32_t i = 0; i < _imageSamplerBundles.size(); i++) {
+    auto const &[bindingNo, _] = _imageSamplerBundles[i];
+    VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    descriptorWrite.dstSet          = dstSet;
+    descriptorWrite.dstBinding      = bindingNo;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo      = &imageSamplerBundleInfos[i];
+    descriptorWrites.push_back(descriptorWrite);
+  }
+
   std::vector<VkDescriptorBufferInfo> storageBufferInfos{};
   storageBufferInfos.reserve(_storageBuffers.size());
   for (auto const &[_, buffer] : _storageBuffers) {
@@ -220,8 +535,107 @@ void DescriptorSetBundle::_createDescriptorSet(uint32_t descriptorSetIndex) {
     descriptorWrites.push_back(descriptorWrite);
   }
 
+  std::vector<VkDescriptorBufferInfo> storageBufferBundleInfos{};
+  storageBufferBundleInfos.reserve(_storageBufferBundles.size());
+  for (auto const &[_, bufferBundle] : _storageBufferBundles) {
+    storageBufferBundleInfos.push_back(
+        bufferBundle->getBuffer(descriptorSetIndex)->getDescriptorInfo());
+  }
+  for (uint32_t i = 0; i < _storageBufferBundles.size(); i++) {
+    auto const &[bindingNo, _] = _storageBufferBundles[i];
+    VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    descriptorWrite.dstSet          = dstSet;
+    descriptorWrite.dstBinding      = bindingNo;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pBufferInfo     = &storageBufferBundleInfos[i];
+    descriptorWrites.push_back(descriptorWrite);
+  }
+
+  // the handles are chained to the writes
+  std::vector<VkWriteDescriptorSetAccelerationStructureKHR> accelerationStructureInfos{};
+  accelerationStructureInfos.reserve(_accelerationStructures.size());
+  for (auto const &[_, accelerationStructure] : _accelerationStructures) {
+    VkWriteDescriptorSetAccelerationStructureKHR accelerationStructureInfo{
+        VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR};
+    accelerationStructureInfo.accelerationStructureCount = 1;
+    accelerationStructureInfo.pAccelerationStructures    = accelerationStructure;
+    accelerationStructureInfos.push_back(accelerationStructureInfo);
+  }
+  for (uint32_t i = 0; i < _accelerationStructures.size(); i++) {
+    auto const &[bindingNo, _] = _accelerationStructures[i];
+    VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    descriptorWrite.pNext           = &accelerationStructureInfos[i];
+    descriptorWrite.dstSet          = dstSet;
+    descriptorWrite.dstBinding      = bindingNo;
+    descriptorWrite.dstArrayElement = 0;
+    descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrites.push_back(descriptorWrite);
+  }
+
   vkUpdateDescriptorSets(_appContext->getDevice(), static_cast<uint32_t>(descriptorWrites.size()),
                          descriptorWrites.data(), 0, nullptr);
+
+  for (auto const &array : _bufferArrays) {
+    _writeBufferArray(descriptorSetIndex, array);
+  }
+  for (auto const &array : _storageImageArrays) {
+    _writeStorageImageArray(descriptorSetIndex, array);
+  }
+}
+
+void DescriptorSetBundle::_writeBufferArray(uint32_t descriptorSetIndex,
+                                            BufferArray const &array, uint32_t firstElement) {
+  // the partially bound arrays leave the elements beyond the buffers unwritten, the others are
+  // padded with the first buffer
+  uint32_t const elementCount = areBufferArraysUpdatedAfterBind()
+                                    ? static_cast<uint32_t>(array.buffers.size())
+                                    : array.arraySize;
+  if (firstElement >= elementCount) {
+    return;
+  }
+
+  std::vector<VkDescriptorBufferInfo> bufferInfos(elementCount,
+                                                  array.buffers[0]->getDescriptorInfo());
+  std::vector<VkBufferView> texelBufferViews(elementCount,
+                                             array.buffers[0]->getTexelBufferView());
+  for (uint32_t i = 0; i < array.buffers.size(); i++) {
+    bufferInfos[i]      = array.buffers[i]->getDescriptorInfo();
+    texelBufferViews[i] = array.buffers[i]->getTexelBufferView();
+  }
+
+  VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+  descriptorWrite.dstSet          = _descriptorSets[descriptorSetIndex];
+  descriptorWrite.dstBinding      = array.bindingSlot;
+  descriptorWrite.dstArrayElement = firstElement;
+  descriptorWrite.descriptorType  = array.descriptorType;
+  descriptorWrite.descriptorCount = elementCount - firstElement;
+  if (array.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER) {
+    descriptorWrite.pTexelBufferView = texelBufferViews.data() + firstElement;
+  } else {
+    descriptorWrite.pBufferInfo = bufferInfos.data() + firstElement;
+  }
+  vkUpdateDescriptorSets(_appContext->getDevice(), 1, &descriptorWrite, 0, nullptr);
+}
+
+void DescriptorSetBundle::_writeStorageImageArray(uint32_t descriptorSetIndex,
+                                                  StorageImageArray const &array) {
+  std::vector<VkDescriptorImageInfo> imageInfos(
+      array.arraySize, array.storageImages[0]->getDescriptorInfo(VK_IMAGE_LAYOUT_GENERAL));
+  for (uint32_t i = 0; i < array.storageImages.size(); i++) {
+    imageInfos[i] = array.storageImages[i]->getDescriptorInfo(VK_IMAGE_LAYOUT_GENERAL);
+  }
+
+  VkWriteDescriptorSet descriptorWrite{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+  descriptorWrite.dstSet          = _descriptorSets[descriptorSetIndex];
+  descriptorWrite.dstBinding      = array.bindingSlot;
+  descriptorWrite.dstArrayElement = 0;
+  descriptorWrite.descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  descriptorWrite.descriptorCount = array.arraySize;
+  descriptorWrite.pImageInfo      = imageInfos.data();
+  vkUpdateDescriptorSets(_appContext->getDevice(), 1, &descriptorWrite, 0, nullptr);
 }
 
 void DescriptorSetBundle::_createDescriptorSets() {
@@ -4,6 +4,7 @@
 
 #include "volk.h"
 
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -20,24 +21,76 @@ public:
       : _appContext(appContext), _bundleSize(bundleSize), _shaderStageFlags(shaderStageFlags) {}
   ~DescriptorSetBundle();
 
-  // default copy and move
-  DescriptorSetBundle(const DescriptorSetBundle &)            = default;
-  DescriptorSetBundle &operator=(const DescriptorSetBundle &) = default;
-  DescriptorSetBundle(DescriptorSetBundle &&) noexcept        = default;
-  DescriptorSetBundle &operator=(DescriptorSetBundle &&)      = default;
+  // disable copy and move, the sub bundles point to their parent
+  DescriptorSetBundle(const DescriptorSetBundle &)            = delete;
+  DescriptorSetBundle &operator=(const DescriptorSetBundle &) = delete;
+  DescriptorSetBundle(DescriptorSetBundle &&)                 = delete;
+  DescriptorSetBundle &operator=(DescriptorSetBundle &&)      = delete;
 
   [[nodiscard]] size_t getBundleSize() const { return _bundleSize; }
   [[nodiscard]] VkDescriptorSet &getDescriptorSet(size_t index) { return _descriptorSets[index]; }
   [[nodiscard]] VkDescriptorSetLayout &getDescriptorSetLayout() { return _descriptorSetLayout; }
 
+  // the bindings of the layout, in the order they are created with
+  [[nodiscard]] std::vector<VkDescriptorSetLayoutBinding> getLayoutBindings() const;
+
   void bindUniformBufferBundle(uint32_t bindingSlot, BufferBundle *bufferBundle);
   void bindStorageImage(uint32_t bindingSlot, Image *storageImage);
   void bindImageSampler(uint32_t bindingSlot, Image *storageImage);
   void bindStorageBuffer(uint32_t bindingSlot, Buffer *buffer);
 
+  // the bundled variants bind a different resource to each descriptor set of the bundle, they are
+  // used when the same pipeline is recorded against several independent sets of resources
+  void bindStorageBufferBundle(uint32_t bindingSlot, BufferBundle *bufferBundle);
+  void bindStorageImageBundle(uint32_t bindingSlot, std::vector<Image *> const &storageImages);
+  void bindImageSamplerBundle(uint32_t bindingSlot, std::vector<Image *> const &storageImages);
+
+  // binds an array of storage buffers, the array elements beyond the given buffers are bound to the
+  // first one, so that all of them are valid, the array can be updated later on, as long as none of
+  // the descriptor sets is in use
+  void bindStorageBufferArray(uint32_t bindingSlot, std::vector<Buffer *> const &buffers,
+                              uint32_t arraySize);
+  // the same for the texel buffer views of the buffers, see Buffer::createTexelBufferView
+  void bindUniformTexelBufferArray(uint32_t bindingSlot, std::vector<Buffer *> const &buffers,
+                                   uint32_t arraySize);
+  // updates either kind of buffer array
+  void updateBufferArray(uint32_t bindingSlot, std::vector<Buffer *> const &buffers);
+  // if the device supports it, the buffer arrays are partially bound and updated after bind, the
+  // elements beyond the given buffers are left unwritten then, and an update only writes the
+  // elements that changed, the sets may be in use by then, and the command buffers recorded with
+  // them stay valid, as long as they don't access those elements
+  [[nodiscard]] bool areBufferArraysUpdatedAfterBind() const;
+
+  // binds an array of storage images, the same one to every descriptor set of the bundle, padded
+  // with the first image like the storage buffer arrays
+  void bindStorageImageArray(uint32_t bindingSlot, std::vector<Image *> const &storageImages,
+                             uint32_t arraySize);
+
+  // the handle is shared by all of the descriptor sets, so it has to outlive them
+  void bindAccelerationStructure(uint32_t bindingSlot,
+                                 VkAccelerationStructureKHR const *accelerationStructure);
+
   void create();
 
+  // a created bundle of the same resources, restricted to the given binding slots, so a pipeline
+  // only has the bindings that its shader uses in its layout, the updates of the buffer arrays
+  // of this bundle are forwarded to it until either is destroyed
+  std::unique_ptr<DescriptorSetBundle> createSubBundle(std::vector<uint32_t> const &bindingSlots);
+
 private:
+  struct BufferArray {
+    uint32_t bindingSlot;
+    VkDescriptorType descriptorType;
+    uint32_t arraySize;
+    std::vector<Buffer *> buffers;
+  };
+
+  struct StorageImageArray {
+    uint32_t bindingSlot;
+    uint32_t arraySize;
+    std::vector<Image *> storageImages;
+  };
+
   VulkanApplicationContext *_appContext;
   size_t _bundleSize;
   VkShaderStageFlags _shaderStageFlags;
@@ -51,11 +104,23 @@ private:
   std::vector<std::pair<uint32_t, Image *>> _storageImages{};
   std::vector<std::pair<uint32_t, Image *>> _imageSamplers{};
   std::vector<std::pair<uint32_t, Buffer *>> _storageBuffers{};
+  std::vector<std::pair<uint32_t, BufferBundle *>> _storageBufferBundles{};
+  std::vector<std::pair<uint32_t, std::vector<Image *>>> _storageImageBundles{};
+  std::vector<std::pair<uint32_t, std::vector<Image *>>> _imageSamplerBundles{};
+  std::vector<BufferArray> _bufferArrays{};
+  std::vector<StorageImageArray> _storageImageArrays{};
+  std::vector<std::pair<uint32_t, VkAccelerationStructureKHR const *>> _accelerationStructures{};
 
   std::vector<VkDescriptorSet> _descriptorSets{};
 
+  DescriptorSetBundle *_parent = nullptr;
+  std::vector<DescriptorSetBundle *> _subBundles{};
+
   void _createDescriptorPool();
   void _createDescriptorSetLayout();
   void _createDescriptorSets();
   void _createDescriptorSet(uint32_t descriptorSetIndex);
+  void _writeBufferArray(uint32_t descriptorSetIndex, BufferArray const &array,
+                         uint32_t firstElement = 0);
+  void _writeStorageImageArray(uint32_t descriptorSetIndex, StorageImageArray const &array);
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "app-context/VulkanApplicationContext.hpp"
 
 #include <cassert>
+#include <cstring>
 
 // https://gpuopen-librariesandsdks.github.io/VulkanMemoryAllocator/html/usage_patterns.html
 namespace {
@@ -18,6 +19,18 @@ VmaAllocationCreateFlags _decideAllocationCreateFlags(MemoryStyle memoryAccessin
     allocFlags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
     allocFlags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
     break;
+  case MemoryStyle::kDeviceLocalHostVisible:
+    // vma falls back to the memory that isn't host visible, when the mappable device local heap is
+    // missing or too small, see advanced data uploading in its docs
+    allocFlags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocFlags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+    allocFlags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT;
+    break;
+  case MemoryStyle::kHostReadback:
+    // random access makes vma prefer the host cached memory types
+    allocFlags |= VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocFlags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+    break;
   }
   return allocFlags;
 }
@@ -30,10 +43,22 @@ Buffer::Buffer(VulkanApplicationContext *appContext, VkDeviceSize size,
 }
 
 Buffer::~Buffer() {
+  if (_texelBufferView != VK_NULL_HANDLE) {
+    vkDestroyBufferView(_appContext->getDevice(), _texelBufferView, nullptr);
+    _texelBufferView = VK_NULL_HANDLE;
+  }
   if (_vkBuffer != VK_NULL_HANDLE) {
+    // the ring may still be copying from or to it
+    if (_memoryStyle == MemoryStyle::kDedicated) {
+      _appContext->getStagingRing()->waitIdle();
+    }
     vmaDestroyBuffer(_appContext->getAllocator(), _vkBuffer, _bufferAllocation);
+    _appContext->untrackMemory(_memoryCategory, _allocationSize);
     _vkBuffer = VK_NULL_HANDLE;
   }
+  if (_stagingBuffer.vkBuffer != VK_NULL_HANDLE) {
+    _destroyStagingBuffer(_stagingBuffer);
+  }
 }
 
 void Buffer::_allocate(VkBufferUsageFlags bufferUsageFlags) {
@@ -43,24 +68,86 @@ void Buffer::_allocate(VkBufferUsageFlags bufferUsageFlags) {
   if (_memoryStyle == MemoryStyle::kDedicated) {
     bufferUsageFlags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
   }
+  // the target of the staged copy, in case the memory isn't host visible after all
+  if (_memoryStyle == MemoryStyle::kDeviceLocalHostVisible) {
+    bufferUsageFlags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  }
 
   auto vmaAlloationCreateFlags = _decideAllocationCreateFlags(_memoryStyle);
+  // the chunk builds of the other devices of a group are copied out of aliases of the dedicated
+  // buffers, see SvoBuilder, which the dedicated allocation info would rule out
+  if (_memoryStyle == MemoryStyle::kDedicated && _appContext->isPeerMemoryCopySupported()) {
+    vmaAlloationCreateFlags |= VMA_ALLOCATION_CREATE_CAN_ALIAS_BIT;
+  }
 
   VkBufferCreateInfo bufferCreateInfo{VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
   bufferCreateInfo.size  = _size;
   bufferCreateInfo.usage = bufferUsageFlags;
 
+  auto const &sharedQueueFamilyIndices = _appContext->getSharedQueueFamilyIndices();
+  if (!sharedQueueFamilyIndices.empty()) {
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    bufferCreateInfo.queueFamilyIndexCount =
+        static_cast<uint32_t>(sharedQueueFamilyIndices.size());
+    bufferCreateInfo.pQueueFamilyIndices = sharedQueueFamilyIndices.data();
+  }
+
   VmaAllocationCreateInfo allocCreateInfo{};
-  allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+  allocCreateInfo.usage = _memoryStyle == MemoryStyle::kDeviceLocalHostVisible
+                              ? VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+                              : VMA_MEMORY_USAGE_AUTO;
   allocCreateInfo.flags = vmaAlloationCreateFlags;
 
   VmaAllocationInfo allocInfo{};
   vmaCreateBuffer(allocator, &bufferCreateInfo, &allocCreateInfo, &_vkBuffer, &_bufferAllocation,
                   &allocInfo);
 
-  if (_memoryStyle == MemoryStyle::kHostVisible) {
+  if (_memoryStyle == MemoryStyle::kHostVisible || _memoryStyle == MemoryStyle::kHostReadback) {
     _mappedAddr = allocInfo.pMappedData;
   }
+
+  _memoryCategory = _appContext->getMemoryCategory();
+  _allocationSize = allocInfo.size;
+
+  if (_memoryStyle == MemoryStyle::kDeviceLocalHostVisible) {
+    VkMemoryPropertyFlags memoryProperties = 0;
+    vmaGetAllocationMemoryProperties(allocator, _bufferAllocation, &memoryProperties);
+    if ((memoryProperties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0) {
+      _mappedAddr = allocInfo.pMappedData;
+    } else {
+      _stagingBuffer = _createStagingBuffer();
+      _mappedAddr    = _stagingBuffer.mappedAddr;
+      VmaAllocationInfo stagingAllocInfo{};
+      vmaGetAllocationInfo(allocator, _stagingBuffer.bufferAllocation, &stagingAllocInfo);
+      _allocationSize += stagingAllocInfo.size;
+    }
+  }
+  _appContext->trackMemory(_memoryCategory, _allocationSize);
+}
+
+VkDeviceAddress Buffer::getDeviceAddress() const {
+  VkBufferDeviceAddressInfo addressInfo{VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO};
+  addressInfo.buffer = _vkBuffer;
+  return vkGetBufferDeviceAddress(_appContext->getDevice(), &addressInfo);
+}
+
+void Buffer::createTexelBufferView(VkFormat format) {
+  assert(_texelBufferView == VK_NULL_HANDLE && "the texel buffer view is already created");
+
+  VkBufferViewCreateInfo viewCreateInfo{VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO};
+  viewCreateInfo.buffer = _vkBuffer;
+  viewCreateInfo.format = format;
+  viewCreateInfo.offset = 0;
+  viewCreateInfo.range  = VK_WHOLE_SIZE;
+  vkCreateBufferView(_appContext->getDevice(), &viewCreateInfo, nullptr, &_texelBufferView);
+}
+
+void Buffer::recordStagedCopy(VkCommandBuffer commandBuffer) {
+  if (!isStaged()) {
+    return;
+  }
+  VkBufferCopy const bufCopy = {0, 0, _size};
+  vkCmdCopyBuffer(commandBuffer, _stagingBuffer.vkBuffer, _vkBuffer, 1, &bufCopy);
 }
 
 VkBufferMemoryBarrier Buffer::getMemoryBarrier(VkAccessFlags srcAccessMask,
@@ -111,13 +198,39 @@ void Buffer::fillData(const void *data) {
   auto const &device      = _appContext->getDevice();
   auto const &queue       = _appContext->getGraphicsQueue();
   auto const &commandPool = _appContext->getCommandPool();
+  auto *stagingRing       = _appContext->getStagingRing();
 
   switch (_memoryStyle) {
-  case MemoryStyle::kHostVisible: {
+  case MemoryStyle::kHostVisible:
+  case MemoryStyle::kHostReadback: {
     memcpy(_mappedAddr, data, _size);
+    // the memory may not be host coherent
+    if (_memoryStyle == MemoryStyle::kHostReadback) {
+      vmaFlushAllocation(_appContext->getAllocator(), _bufferAllocation, 0, VK_WHOLE_SIZE);
+    }
+    break;
+  }
+  case MemoryStyle::kDeviceLocalHostVisible: {
+    if (data != nullptr) {
+      memcpy(_mappedAddr, data, _size);
+    } else {
+      memset(_mappedAddr, 0, _size);
+    }
+    // the memory may not be host coherent
+    vmaFlushAllocation(_appContext->getAllocator(),
+                       isStaged() ? _stagingBuffer.bufferAllocation : _bufferAllocation, 0,
+                       VK_WHOLE_SIZE);
     break;
   }
   case MemoryStyle::kDedicated: {
+    // batched into the next submit of the ring, which the frames and the builder wait on before
+    // their own work
+    if (stagingRing->upload(_vkBuffer, data, _size)) {
+      break;
+    }
+    // too large for the ring, a temporary staging buffer is used, after the pending uploads
+    stagingRing->flush(queue);
+
     StagingBufferHandle stagingBufferHandle = _createStagingBuffer();
     memcpy(stagingBufferHandle.mappedAddr, data, _size);
 
@@ -143,6 +256,7 @@ void Buffer::fetchData(void *data) {
   auto const &device      = _appContext->getDevice();
   auto const &queue       = _appContext->getGraphicsQueue();
   auto const &commandPool = _appContext->getCommandPool();
+  auto *stagingRing       = _appContext->getStagingRing();
 
   switch (_memoryStyle) {
   case MemoryStyle::kHostVisible: {
@@ -150,8 +264,25 @@ void Buffer::fetchData(void *data) {
     memcpy(data, _mappedAddr, _size);
     return;
   }
+  case MemoryStyle::kHostReadback: {
+    // the memory may not be host coherent
+    vmaInvalidateAllocation(_appContext->getAllocator(), _bufferAllocation, 0, VK_WHOLE_SIZE);
+    memcpy(data, _mappedAddr, _size);
+    return;
+  }
+  // only written by the host, so the mapping holds the contents, staged or not
+  case MemoryStyle::kDeviceLocalHostVisible: {
+    memcpy(data, _mappedAddr, _size);
+    return;
+  }
 
   case MemoryStyle::kDedicated: {
+    if (stagingRing->readback(_vkBuffer, data, _size)) {
+      break;
+    }
+    // mirrors fillData
+    stagingRing->flush(queue);
+
     StagingBufferHandle stagingBufferHandle = _createStagingBuffer();
 
     VkCommandBuffer commandBuffer = beginSingleTimeCommands(device, commandPool);
@@ -162,7 +293,10 @@ void Buffer::fetchData(void *data) {
         _size, // size
     };
 
-    // copy main buffer to staging buffer
+    // copy main buffer to staging buffer, from the first device of a group only, like the ring
+    if (_appContext->getDeviceCount() > 1) {
+      vkCmdSetDeviceMask(commandBuffer, DeviceGroupSubmit::kPrimaryDeviceMask);
+    }
     vkCmdCopyBuffer(commandBuffer, _vkBuffer, stagingBufferHandle.vkBuffer, 1, &bufCopy);
     endSingleTimeCommands(device, commandPool, queue, commandBuffer);
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "app-context/MemoryCategory.hpp"
 #include "volk.h"
 
 #ifdef _WIN32
@@ -11,6 +12,14 @@
 enum class MemoryStyle {
   kDedicated,
   kHostVisible,
+  // the constants that the host writes every frame, device local and mapped when the device can
+  // map its local memory (resizable bar), otherwise device local with a mapped staging buffer,
+  // which is copied over by recordStagedCopy
+  kDeviceLocalHostVisible,
+  // written by the gpu and read back by the host, mapped and host cached, so the host reads it at
+  // the speed of system memory instead of from write combined memory, the host has to invalidate
+  // it before reading, since it may not be coherent
+  kHostReadback,
 };
 
 class VulkanApplicationContext;
@@ -35,6 +44,16 @@ public:
   void *mapMemory();
   void unmapMemory();
 
+  // the persistent mapping of host visible buffers, of the staging buffer of the staged ones,
+  // nullptr for the dedicated ones
+  [[nodiscard]] void *getMappedAddr() const { return _mappedAddr; }
+
+  // the device local buffers that the host can't map directly are written through their staging
+  // buffer, and copied over by the command buffer before the shaders read them, the barrier after
+  // the copies is left to the caller, nothing is recorded for the others
+  [[nodiscard]] bool isStaged() const { return _stagingBuffer.vkBuffer != VK_NULL_HANDLE; }
+  void recordStagedCopy(VkCommandBuffer commandBuffer);
+
   [[nodiscard]] VmaAllocation getMainBufferAllocation() const { return _bufferAllocation; }
 
   inline VkBuffer &getVkBuffer() { return _vkBuffer; }
@@ -43,6 +62,14 @@ public:
 
   [[nodiscard]] inline VkDeviceSize getSize() const { return _size; }
 
+  // the buffer has to be created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+  [[nodiscard]] VkDeviceAddress getDeviceAddress() const;
+
+  // a view of the whole buffer, which is destroyed along with it, the buffer has to be created with
+  // VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT
+  void createTexelBufferView(VkFormat format);
+  [[nodiscard]] VkBufferView getTexelBufferView() const { return _texelBufferView; }
+
   VkBufferMemoryBarrier getMemoryBarrier(VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask);
 
   inline VkDescriptorBufferInfo getDescriptorInfo() {
@@ -59,10 +86,14 @@ private:
   VkDeviceSize _size; // total size of buffer
 
   MemoryStyle _memoryStyle;
+  // the tag of the allocation, of the scope that it was created in
+  MemoryCategory _memoryCategory = MemoryCategory::kUntagged;
+  VkDeviceSize _allocationSize   = 0;
 
   VkBuffer _vkBuffer              = VK_NULL_HANDLE;
   VmaAllocation _bufferAllocation = VK_NULL_HANDLE;
   void *_mappedAddr               = nullptr;
+  VkBufferView _texelBufferView   = VK_NULL_HANDLE;
 
   void _allocate(VkBufferUsageFlags bufferUsageFlags);
 
@@ -71,6 +102,8 @@ private:
     VmaAllocation bufferAllocation = VK_NULL_HANDLE;
     void *mappedAddr               = nullptr;
   };
+  // kept for the lifetime of the staged kDeviceLocalHostVisible buffers
+  StagingBufferHandle _stagingBuffer{};
 
   // create a staging buffer that is both allowed to be transferred to and from
   [[nodiscard]] StagingBufferHandle _createStagingBuffer() const;
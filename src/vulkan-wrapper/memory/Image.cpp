@@ -1,13 +1,21 @@
 #include "Image.hpp"
 
 #include "app-context/VulkanApplicationContext.hpp"
+#include "scheduler/TaskScheduler.hpp"
+#include "utils/config/RootDir.h"
 
 #include "../utils/SimpleCommands.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 
@@ -41,6 +49,141 @@ unsigned char *_loadImageFromPath(const std::string &path, int &width, int &heig
 }
 
 void _freeImageData(unsigned char *imageData) { stbi_image_free(imageData); }
+
+// bumped whenever the layout of the packed layers changes
+uint32_t constexpr kPackedLayersVersion = 1;
+
+struct PackedLayersHeader {
+  uint32_t version;
+  uint32_t width;
+  uint32_t height;
+  uint32_t layerCount;
+};
+
+// fnv-1a, mirrors ChunkOctreeCache, the key has to stay the same between launches
+uint64_t constexpr kFnvOffsetBasis = 14695981039346656037ULL;
+uint64_t constexpr kFnvPrime       = 1099511628211ULL;
+
+uint64_t _hashBytes(uint64_t hash, void const *data, size_t size) {
+  auto const *bytes = static_cast<unsigned char const *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+// keyed by the names and the sizes of the files, a replaced file has to be re-exported anyway
+std::string _getPathToPackedLayers(std::vector<std::string> const &filenames) {
+  uint64_t hash = kFnvOffsetBasis;
+  hash          = _hashBytes(hash, &kPackedLayersVersion, sizeof(kPackedLayersVersion));
+  for (std::string const &filename : filenames) {
+    std::error_code errorCode{};
+    uint64_t const fileSize = std::filesystem::file_size(filename, errorCode);
+    hash                    = _hashBytes(hash, filename.data(), filename.size());
+    hash                    = _hashBytes(hash, &fileSize, sizeof(fileSize));
+  }
+
+  std::stringstream ss;
+  ss << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return kPathToResourceFolder + "cache/textures/" + ss.str() + ".bin";
+}
+
+bool _loadPackedLayers(std::string const &pathToFile, uint32_t layerCount, uint32_t &width,
+                       uint32_t &height, std::vector<unsigned char> &layers) {
+  std::ifstream file(pathToFile, std::ios::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+  PackedLayersHeader header{};
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file || header.version != kPackedLayersVersion || header.layerCount != layerCount) {
+    return false;
+  }
+  layers.resize(static_cast<size_t>(header.width) * header.height * layerCount * STBI_rgb_alpha);
+  file.read(reinterpret_cast<char *>(layers.data()), static_cast<std::streamsize>(layers.size()));
+  if (!file) {
+    return false;
+  }
+  width  = header.width;
+  height = header.height;
+  return true;
+}
+
+// written to a temporary file first, so a crash never leaves a truncated one behind
+void _storePackedLayers(std::string const &pathToFile, PackedLayersHeader const &header,
+                        std::vector<unsigned char> const &layers) {
+  std::error_code errorCode{};
+  std::filesystem::create_directories(std::filesystem::path(pathToFile).parent_path(), errorCode);
+
+  std::string const pathToTmpFile = pathToFile + ".tmp";
+  {
+    std::ofstream file(pathToTmpFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      return;
+    }
+    file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    file.write(reinterpret_cast<char const *>(layers.data()),
+               static_cast<std::streamsize>(layers.size()));
+  }
+  std::filesystem::rename(pathToTmpFile, pathToFile, errorCode);
+}
+
+// the files are decoded in parallel, stb_image keeps no shared state while decoding
+void _decodeLayers(std::vector<std::string> const &filenames, uint32_t &width, uint32_t &height,
+                   std::vector<unsigned char> &layers) {
+  struct DecodedImage {
+    unsigned char *data = nullptr;
+    int width           = 0;
+    int height          = 0;
+  };
+  std::vector<DecodedImage> decodedImages(filenames.size());
+
+  TaskScheduler::get().parallelFor(filenames.size(), [&](size_t jobIndex, uint32_t /*slot*/) {
+    auto &decodedImage = decodedImages[jobIndex];
+    int channels       = 0;
+    decodedImage.data  = _loadImageFromPath(filenames[jobIndex], decodedImage.width,
+                                            decodedImage.height, channels);
+  });
+
+  width                  = static_cast<uint32_t>(decodedImages.front().width);
+  height                 = static_cast<uint32_t>(decodedImages.front().height);
+  size_t const layerSize = static_cast<size_t>(width) * height * STBI_rgb_alpha;
+  layers.resize(layerSize * filenames.size());
+  for (size_t i = 0; i < decodedImages.size(); i++) {
+    assert(decodedImages[i].width == decodedImages.front().width &&
+           decodedImages[i].height == decodedImages.front().height &&
+           "all images of a texture array should be in the same dimension");
+    std::memcpy(layers.data() + i * layerSize, decodedImages[i].data, layerSize);
+    _freeImageData(decodedImages[i].data);
+  }
+}
+
+VkImageCreateInfo _makeImageCreateInfo(VulkanApplicationContext *appContext,
+                                       ImageDimensions dimensions, uint32_t layerCount,
+                                       VkFormat format, VkSampleCountFlagBits numSamples,
+                                       VkImageTiling tiling, VkImageUsageFlags usage) {
+  VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+  imageInfo.imageType     = dimensions.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+  imageInfo.extent.width  = dimensions.width;
+  imageInfo.extent.height = dimensions.height;
+  imageInfo.extent.depth  = dimensions.depth;
+  imageInfo.mipLevels     = 1;
+  imageInfo.arrayLayers   = layerCount;
+  imageInfo.format        = format;
+  imageInfo.tiling        = tiling;
+  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+  imageInfo.usage         = usage;
+  imageInfo.samples       = numSamples;
+
+  auto const &sharedQueueFamilyIndices = appContext->getSharedQueueFamilyIndices();
+  if (!sharedQueueFamilyIndices.empty()) {
+    imageInfo.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+    imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(sharedQueueFamilyIndices.size());
+    imageInfo.pQueueFamilyIndices   = sharedQueueFamilyIndices.data();
+  }
+  return imageInfo;
+}
 } // namespace
 
 Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, VkFormat format,
@@ -57,6 +200,17 @@ Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, V
                                  _dimensions.depth, _layerCount);
 }
 
+Image::Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, uint32_t layerCount,
+             VkFormat format, VkImageUsageFlags usage, VkSampler sampler)
+    : _appContext(appContext), _vkSampler(sampler), _currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED),
+      _layerCount(layerCount), _format(format), _dimensions(dimensions) {
+  _createImage(VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, usage);
+
+  _transitionImageLayout(VK_IMAGE_LAYOUT_GENERAL);
+  _vkImageView = createImageView(_appContext->getDevice(), _vkImage, format,
+                                 VK_IMAGE_ASPECT_COLOR_BIT, _dimensions.depth, _layerCount);
+}
+
 Image::Image(VulkanApplicationContext *appContext, const std::string &filename,
              VkImageUsageFlags usage, VkSampler sampler, VkImageLayout initialImageLayout,
              VkSampleCountFlagBits numSamples, VkImageTiling tiling, VkImageAspectFlags aspectFlags)
@@ -96,18 +250,18 @@ Image::Image(VulkanApplicationContext *appContext, const std::vector<std::string
              VkSampleCountFlagBits numSamples, VkImageTiling tiling, VkImageAspectFlags aspectFlags)
     : _appContext(appContext), _vkSampler(sampler), _currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED),
       _layerCount(static_cast<uint32_t>(filenames.size())), _format(VK_FORMAT_R8G8B8A8_UNORM) {
-  std::vector<unsigned char *> imageDatas{};
-
-  int width    = 0;
-  int height   = 0;
-  int channels = 0;
-  for (std::string const &filename : filenames) {
-    // load image from path
-    auto *imageData = _loadImageFromPath(filename, width, height, channels);
-    imageDatas.push_back(imageData);
+  uint32_t width  = 0;
+  uint32_t height = 0;
+  std::vector<unsigned char> layers{};
+
+  std::string const pathToPackedLayers = _getPathToPackedLayers(filenames);
+  if (!_loadPackedLayers(pathToPackedLayers, _layerCount, width, height, layers)) {
+    _decodeLayers(filenames, width, height, layers);
+    _storePackedLayers(pathToPackedLayers, {kPackedLayersVersion, width, height, _layerCount},
+                       layers);
   }
 
-  _dimensions = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1};
+  _dimensions = {width, height, 1};
 
   _createImage(numSamples, tiling, usage);
 
@@ -116,11 +270,8 @@ Image::Image(VulkanApplicationContext *appContext, const std::vector<std::string
     _transitionImageLayout(VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
   }
 
-  // copy the image data to the image
-  for (uint32_t i = 0; i < filenames.size(); ++i) {
-    _copyDataToImage(imageDatas[i], i);
-    _freeImageData(imageDatas[i]);
-  }
+  // copy the image data to the image, all of the layers at once
+  _copyDataToImage(layers.data(), 0, _layerCount);
 
   if (initialImageLayout != VK_IMAGE_LAYOUT_UNDEFINED) {
     _transitionImageLayout(initialImageLayout);
@@ -130,21 +281,55 @@ Image::Image(VulkanApplicationContext *appContext, const std::vector<std::string
                                  _dimensions.depth, _layerCount);
 }
 
+Image::Image(VulkanApplicationContext *appContext, VmaAllocation aliasedAllocation,
+             ImageDimensions dimensions, VkFormat format, VkImageUsageFlags usage,
+             VkSampler sampler)
+    : _appContext(appContext), _vkSampler(sampler), _allocation(aliasedAllocation),
+      _isAliased(true), _currentImageLayout(VK_IMAGE_LAYOUT_UNDEFINED), _layerCount(1),
+      _format(format), _dimensions(dimensions) {
+  VkImageCreateInfo const imageInfo =
+      _makeImageCreateInfo(_appContext, _dimensions, _layerCount, _format, VK_SAMPLE_COUNT_1_BIT,
+                           VK_IMAGE_TILING_OPTIMAL, usage);
+  vmaCreateAliasingImage(_appContext->getAllocator(), _allocation, &imageInfo, &_vkImage);
+
+  _transitionImageLayout(VK_IMAGE_LAYOUT_GENERAL);
+  _vkImageView = createImageView(_appContext->getDevice(), _vkImage, format,
+                                 VK_IMAGE_ASPECT_COLOR_BIT, _dimensions.depth, _layerCount);
+}
+
 Image::~Image() {
   if (_vkImage != VK_NULL_HANDLE) {
     vkDestroyImageView(_appContext->getDevice(), _vkImageView, nullptr);
     vkDestroyImage(_appContext->getDevice(), _vkImage, nullptr);
-    vmaFreeMemory(_appContext->getAllocator(), _allocation);
+    if (!_isAliased) {
+      vmaFreeMemory(_appContext->getAllocator(), _allocation);
+      _appContext->untrackMemory(_memoryCategory, _allocationSize);
+    }
   }
 }
 
+VkMemoryRequirements Image::getMemoryRequirements(VulkanApplicationContext *appContext,
+                                                  ImageDimensions dimensions, VkFormat format,
+                                                  VkImageUsageFlags usage) {
+  VkImageCreateInfo const imageInfo = _makeImageCreateInfo(
+      appContext, dimensions, 1, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, usage);
+
+  VkImage image = VK_NULL_HANDLE;
+  vkCreateImage(appContext->getDevice(), &imageInfo, nullptr, &image);
+  VkMemoryRequirements memoryRequirements{};
+  vkGetImageMemoryRequirements(appContext->getDevice(), image, &memoryRequirements);
+  vkDestroyImage(appContext->getDevice(), image, nullptr);
+  return memoryRequirements;
+}
+
 void Image::clearImage(VkCommandBuffer commandBuffer) {
   VkImageSubresourceRange clearRange{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
   vkCmdClearColorImage(commandBuffer, _vkImage, VK_IMAGE_LAYOUT_GENERAL, &kClearColor, 1,
                        &clearRange);
 }
 
-void Image::_copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo) {
+void Image::_copyDataToImage(unsigned char const *imageData, uint32_t baseLayer,
+                             uint32_t layerCount) {
   auto const &device      = _appContext->getDevice();
   auto const &queue       = _appContext->getGraphicsQueue();
   auto const &commandPool = _appContext->getCommandPool();
@@ -152,7 +337,8 @@ void Image::_copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo) {
 
   const uint32_t imagePixelCount = _dimensions.width * _dimensions.height * _dimensions.depth;
   // the channel count is ignored here, because the VkFormat is enough
-  const uint32_t imageDataSize = imagePixelCount * kVkFormatBytesPerPixelMap.at(_format);
+  const uint32_t imageDataSize =
+      imagePixelCount * kVkFormatBytesPerPixelMap.at(_format) * layerCount;
 
   // create a staging buffer
   VkBufferCreateInfo bufferInfo{};
@@ -184,9 +370,10 @@ void Image::_copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo) {
   region.bufferImageHeight           = 0; // If your data is tightly packed, this can be 0
   region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   region.imageSubresource.mipLevel   = 0;
-  // the first layer of the texture array that the data should be copied into
-  region.imageSubresource.baseArrayLayer = layerToCopyTo;
-  region.imageSubresource.layerCount     = 1;
+  // the first layer of the texture array that the data should be copied into, the packed layers
+  // follow it
+  region.imageSubresource.baseArrayLayer = baseLayer;
+  region.imageSubresource.layerCount     = layerCount;
   region.imageOffset                     = {0, 0, 0};
   region.imageExtent                     = {static_cast<uint32_t>(_dimensions.width),
                                             static_cast<uint32_t>(_dimensions.height),
@@ -203,18 +390,8 @@ void Image::_copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo) {
 
 VkResult Image::_createImage(VkSampleCountFlagBits numSamples, VkImageTiling tiling,
                              VkImageUsageFlags usage) {
-  VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
-  imageInfo.imageType     = _dimensions.depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
-  imageInfo.extent.width  = _dimensions.width;
-  imageInfo.extent.height = _dimensions.height;
-  imageInfo.extent.depth  = _dimensions.depth;
-  imageInfo.mipLevels     = 1;
-  imageInfo.arrayLayers   = _layerCount;
-  imageInfo.format        = _format;
-  imageInfo.tiling        = tiling;
-  imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  imageInfo.usage         = usage;
-  imageInfo.samples       = numSamples;
+  VkImageCreateInfo const imageInfo = _makeImageCreateInfo(_appContext, _dimensions, _layerCount,
+                                                           _format, numSamples, tiling, usage);
 
   VmaAllocationCreateInfo vmaallocInfo = {};
   vmaallocInfo.usage                   = VMA_MEMORY_USAGE_AUTO;
@@ -223,8 +400,14 @@ VkResult Image::_createImage(VkSampleCountFlagBits numSamples, VkImageTiling til
       // sizes
       VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
 
-  return vmaCreateImage(_appContext->getAllocator(), &imageInfo, &vmaallocInfo, &_vkImage,
-                        &_allocation, nullptr);
+  VmaAllocationInfo allocInfo{};
+  VkResult const result = vmaCreateImage(_appContext->getAllocator(), &imageInfo, &vmaallocInfo,
+                                         &_vkImage, &_allocation, &allocInfo);
+
+  _memoryCategory = _appContext->getMemoryCategory();
+  _allocationSize = allocInfo.size;
+  _appContext->trackMemory(_memoryCategory, _allocationSize);
+  return result;
 }
 
 VkImageView Image::createImageView(VkDevice device, const VkImage &image, VkFormat format,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "app-context/MemoryCategory.hpp"
 #include "volk.h"
 
 #ifdef _WIN32
@@ -41,6 +42,10 @@ public:
         VkImageTiling tiling             = VK_IMAGE_TILING_OPTIMAL,
         VkImageAspectFlags aspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT);
 
+  // create a blank 2d array image of the given layers, in VK_IMAGE_LAYOUT_GENERAL
+  Image(VulkanApplicationContext *appContext, ImageDimensions dimensions, uint32_t layerCount,
+        VkFormat format, VkImageUsageFlags usage, VkSampler sampler = VK_NULL_HANDLE);
+
   // create an image from a file, VK_FORMAT_R8G8B8A8_UNORM is the only format that stb_image
   // supports, so the created image format is fixed, and only 2D images are supported.
   Image(VulkanApplicationContext *appContext, const std::string &filename, VkImageUsageFlags usage,
@@ -51,7 +56,8 @@ public:
         VkImageAspectFlags aspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT);
 
   // create a texture array from a set of image files, all images should be in
-  // the same dimension and the same format..
+  // the same dimension and the same format, they're decoded in parallel, and the decoded layers
+  // are cached on the disk, since the arrays of noise that this is used for never change
   Image(VulkanApplicationContext *appContext, const std::vector<std::string> &filenames,
         VkImageUsageFlags usage, VkSampler sampler = VK_NULL_HANDLE,
         VkImageLayout initialImageLayout = VK_IMAGE_LAYOUT_GENERAL,
@@ -59,6 +65,12 @@ public:
         VkImageTiling tiling             = VK_IMAGE_TILING_OPTIMAL,
         VkImageAspectFlags aspectFlags   = VK_IMAGE_ASPECT_COLOR_BIT);
 
+  // create a blank image in the memory of the given allocation, which is owned by the caller and
+  // may be shared with other images, see TransientImagePool
+  Image(VulkanApplicationContext *appContext, VmaAllocation aliasedAllocation,
+        ImageDimensions dimensions, VkFormat format, VkImageUsageFlags usage,
+        VkSampler sampler = VK_NULL_HANDLE);
+
   ~Image();
 
   // disable move and copy
@@ -68,6 +80,7 @@ public:
   Image &operator=(Image &&)      = delete;
 
   VkImage &getVkImage() { return _vkImage; }
+  [[nodiscard]] VkImageView getVkImageView() const { return _vkImageView; }
 
   [[nodiscard]] VkDescriptorImageInfo getDescriptorInfo(VkImageLayout imageLayout) const;
   [[nodiscard]] ImageDimensions getDimensions() const { return _dimensions; }
@@ -78,6 +91,11 @@ public:
                                      VkImageAspectFlags aspectFlags, uint32_t imageDepth = 1,
                                      uint32_t layerCount = 1);
 
+  // the memory requirements of a blank image, without creating it
+  static VkMemoryRequirements getMemoryRequirements(VulkanApplicationContext *appContext,
+                                                    ImageDimensions dimensions, VkFormat format,
+                                                    VkImageUsageFlags usage);
+
 private:
   VulkanApplicationContext *_appContext;
 
@@ -85,13 +103,20 @@ private:
   VkImageView _vkImageView  = VK_NULL_HANDLE;
   VkSampler _vkSampler      = VK_NULL_HANDLE;
   VmaAllocation _allocation = VK_NULL_HANDLE;
+  // the aliased allocations aren't freed along with the image, nor tracked by it
+  bool _isAliased = false;
+  // the tag of the allocation, of the scope that it was created in
+  MemoryCategory _memoryCategory = MemoryCategory::kUntagged;
+  VkDeviceSize _allocationSize   = 0;
   VkImageLayout _currentImageLayout;
   uint32_t _layerCount;
   VkFormat _format;
 
   ImageDimensions _dimensions;
 
-  void _copyDataToImage(unsigned char *imageData, uint32_t layerToCopyTo = 0);
+  // the layers are tightly packed one after another, they're uploaded in one staged copy
+  void _copyDataToImage(unsigned char const *imageData, uint32_t baseLayer = 0,
+                        uint32_t layerCount = 1);
 
   // creates an image with VK_IMAGE_LAYOUT_UNDEFINED initially
   VkResult _createImage(VkSampleCountFlagBits numSamples, VkImageTiling tiling,
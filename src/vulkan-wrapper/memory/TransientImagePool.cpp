@@ -0,0 +1,151 @@
+#include "TransientImagePool.hpp"
+
+#include "app-context/VulkanApplicationContext.hpp"
+#include "utils/logger/Logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <utility>
+
+namespace {
+double constexpr kMb = 1024.0 * 1024.0;
+} // namespace
+
+TransientImagePool::TransientImagePool(VulkanApplicationContext *appContext, Logger *logger)
+    : _appContext(appContext), _logger(logger) {}
+
+// the aliasing images have to go before the blocks they are bound to
+TransientImagePool::~TransientImagePool() {
+  _images.clear();
+  for (auto const &block : _blocks) {
+    vmaFreeMemory(_appContext->getAllocator(), block.allocation);
+    _appContext->untrackMemory(MemoryCategory::kRenderTargets, block.memoryRequirements.size);
+  }
+}
+
+uint32_t TransientImagePool::addImage(std::string name, ImageDimensions dimensions,
+                                      VkFormat format, VkImageUsageFlags usage, uint32_t firstPass,
+                                      uint32_t lastPass) {
+  assert(_blocks.empty() && "the images must be added before the pool is allocated");
+  assert(firstPass <= lastPass && "the pass range of a transient image is inclusive");
+
+  VkMemoryRequirements const memoryRequirements =
+      Image::getMemoryRequirements(_appContext, dimensions, format, usage);
+
+  TransientImage transientImage{};
+  transientImage.name               = std::move(name);
+  transientImage.dimensions         = dimensions;
+  transientImage.format             = format;
+  transientImage.usage              = usage;
+  transientImage.firstPass          = firstPass;
+  transientImage.lastPass           = lastPass;
+  transientImage.memoryRequirements = memoryRequirements;
+  _images.push_back(std::move(transientImage));
+  return static_cast<uint32_t>(_images.size() - 1);
+}
+
+void TransientImagePool::allocate() {
+  _assignBlocks();
+
+  VmaAllocationCreateInfo allocCreateInfo{};
+  allocCreateInfo.flags         = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+  allocCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+  for (auto &block : _blocks) {
+    vmaAllocateMemory(_appContext->getAllocator(), &block.memoryRequirements, &allocCreateInfo,
+                      &block.allocation, nullptr);
+    // the pool only holds the intermediate images of the passes
+    _appContext->trackMemory(MemoryCategory::kRenderTargets, block.memoryRequirements.size);
+  }
+
+  for (auto &transientImage : _images) {
+    transientImage.image = std::make_unique<Image>(
+        _appContext, _blocks[transientImage.blockIndex].allocation, transientImage.dimensions,
+        transientImage.format, transientImage.usage);
+  }
+
+  _logMemoryReport();
+}
+
+Image *TransientImagePool::getImage(uint32_t imageIndex) const {
+  assert(_images[imageIndex].image != nullptr && "the pool isn't allocated yet");
+  return _images[imageIndex].image.get();
+}
+
+// an interval partitioning, the images are visited by their first pass, each one goes into the
+// first block that is free by then, and has a compatible memory type
+void TransientImagePool::_assignBlocks() {
+  std::vector<size_t> imageOrder(_images.size());
+  std::iota(imageOrder.begin(), imageOrder.end(), 0);
+  std::stable_sort(imageOrder.begin(), imageOrder.end(), [this](size_t a, size_t b) {
+    return _images[a].firstPass < _images[b].firstPass;
+  });
+
+  for (size_t const imageIndex : imageOrder) {
+    auto &transientImage              = _images[imageIndex];
+    VkMemoryRequirements const &imReq = transientImage.memoryRequirements;
+
+    auto it = std::find_if(_blocks.begin(), _blocks.end(), [&](MemoryBlock const &block) {
+      return block.lastPass < transientImage.firstPass &&
+             (block.memoryRequirements.memoryTypeBits & imReq.memoryTypeBits) != 0;
+    });
+    if (it == _blocks.end()) {
+      _blocks.push_back({imReq, transientImage.lastPass, VK_NULL_HANDLE});
+      transientImage.blockIndex = _blocks.size() - 1;
+      continue;
+    }
+
+    VkMemoryRequirements &blockReq = it->memoryRequirements;
+    blockReq.size                  = std::max(blockReq.size, imReq.size);
+    blockReq.alignment             = std::max(blockReq.alignment, imReq.alignment);
+    blockReq.memoryTypeBits &= imReq.memoryTypeBits;
+
+    it->lastPass              = transientImage.lastPass;
+    transientImage.blockIndex = static_cast<size_t>(it - _blocks.begin());
+  }
+}
+
+void TransientImagePool::recordImageAcquiringBarriers(VkCommandBuffer commandBuffer,
+                                                      uint32_t pass) const {
+  std::vector<VkImageMemoryBarrier> imageBarriers{};
+  for (auto const &transientImage : _images) {
+    if (transientImage.firstPass != pass) {
+      continue;
+    }
+    VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.srcAccessMask       = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask       = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.oldLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout           = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image               = transientImage.image->getVkImage();
+    barrier.subresourceRange    = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    imageBarriers.push_back(barrier);
+  }
+  if (imageBarriers.empty()) {
+    return;
+  }
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr,
+                       static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+void TransientImagePool::_logMemoryReport() const {
+  VkDeviceSize unaliasedSize = 0;
+  for (auto const &transientImage : _images) {
+    unaliasedSize += transientImage.memoryRequirements.size;
+    _logger->info("transient image {}: {:.2f} mb, passes {} - {}, block {}", transientImage.name,
+                  static_cast<double>(transientImage.memoryRequirements.size) / kMb,
+                  transientImage.firstPass, transientImage.lastPass, transientImage.blockIndex);
+  }
+
+  VkDeviceSize aliasedSize = 0;
+  for (auto const &block : _blocks) {
+    aliasedSize += block.memoryRequirements.size;
+  }
+  _logger->info("transient images: {:.2f} mb in {} blocks, {:.2f} mb without aliasing",
+                static_cast<double>(aliasedSize) / kMb, _blocks.size(),
+                static_cast<double>(unaliasedSize) / kMb);
+}
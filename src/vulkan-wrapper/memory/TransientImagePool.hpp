@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include "volk.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Logger;
+class VulkanApplicationContext;
+
+// aliases the images that only live within a range of the passes of a frame into shared memory
+// blocks, the images whose pass ranges don't overlap share a block, so their content is lost
+// between the frames, and at the beginning of their ranges
+class TransientImagePool {
+public:
+  TransientImagePool(VulkanApplicationContext *appContext, Logger *logger);
+  ~TransientImagePool();
+
+  // disable copy and move
+  TransientImagePool(TransientImagePool const &)            = delete;
+  TransientImagePool(TransientImagePool &&)                 = delete;
+  TransientImagePool &operator=(TransientImagePool const &) = delete;
+  TransientImagePool &operator=(TransientImagePool &&)      = delete;
+
+  // the pass range is inclusive, returns the index of the image, which is created by allocate()
+  uint32_t addImage(std::string name, ImageDimensions dimensions, VkFormat format,
+                    VkImageUsageFlags usage, uint32_t firstPass, uint32_t lastPass);
+
+  // creates the blocks and the images in them, then logs the memory of every image and the total
+  // memory with and without the aliasing
+  void allocate();
+
+  // owned by the pool
+  [[nodiscard]] Image *getImage(uint32_t imageIndex) const;
+
+  // the images whose range begins at this pass are transitioned from the undefined layout, which
+  // has to happen before the first write to an aliased image, after the passes of the images it
+  // shares its block with
+  void recordImageAcquiringBarriers(VkCommandBuffer commandBuffer, uint32_t pass) const;
+
+private:
+  struct TransientImage {
+    std::string name;
+    ImageDimensions dimensions;
+    VkFormat format;
+    VkImageUsageFlags usage;
+    uint32_t firstPass;
+    uint32_t lastPass;
+    VkMemoryRequirements memoryRequirements;
+    size_t blockIndex;
+    std::unique_ptr<Image> image;
+  };
+
+  struct MemoryBlock {
+    VkMemoryRequirements memoryRequirements;
+    uint32_t lastPass;
+    VmaAllocation allocation;
+  };
+
+  VulkanApplicationContext *_appContext;
+  Logger *_logger;
+
+  std::vector<MemoryBlock> _blocks;
+  std::vector<TransientImage> _images;
+
+  void _assignBlocks();
+  void _logMemoryReport() const;
+};
@@ -3,52 +3,134 @@
 #include "app-context/VulkanApplicationContext.hpp"
 
 #include "../descriptor-set/DescriptorSetBundle.hpp"
+#include "file-watcher/ShaderChangeListener.hpp"
+#include "scheduler/TaskScheduler.hpp"
 #include "utils/io/ShaderFileReader.hpp"
 #include "utils/logger/Logger.hpp"
 #include "utils/shader-compiler/ShaderCompiler.hpp"
 
+#include <algorithm>
+#include <filesystem>
+
 ComputePipeline::ComputePipeline(VulkanApplicationContext *appContext, Logger *logger,
                                  PipelineScheduler *scheduler,
                                  std::string fullPathToShaderSourceCode,
                                  WorkGroupSize workGroupSize,
                                  DescriptorSetBundle *descriptorSetBundle,
                                  ShaderCompiler *shaderCompiler,
-                                 ShaderChangeListener *shaderChangeListener)
+                                 ShaderChangeListener *shaderChangeListener,
+                                 uint32_t pushConstantSize)
     : Pipeline(appContext, logger, scheduler, std::move(fullPathToShaderSourceCode),
-               descriptorSetBundle, VK_SHADER_STAGE_COMPUTE_BIT, shaderChangeListener),
-      _workGroupSize(workGroupSize), _shaderCompiler(shaderCompiler) {
-  if (!compileAndCacheShaderModule()) {
-    _logger->error("pipeline: {} is failed to compile!");
-    exit(0);
-  }
-  build();
-}
+               descriptorSetBundle, VK_SHADER_STAGE_COMPUTE_BIT, shaderChangeListener,
+               pushConstantSize),
+      _workGroupSize(workGroupSize),
+      _debugLabel(std::filesystem::path(_fullPathToShaderSourceCode).filename().string()),
+      _shaderCompiler(shaderCompiler) {}
 
 ComputePipeline::~ComputePipeline() = default;
 
+// the workers of the scheduler take the shaders one by one, the slowest one bounds the compilation,
+// the shader modules and the watched files are only touched on this thread afterwards
+void ComputePipeline::compileAndBuild(std::vector<ComputePipeline *> const &pipelines) {
+  struct CompileJob {
+    std::optional<std::vector<uint32_t>> code;
+    std::vector<std::string> includedFiles;
+  };
+  std::vector<CompileJob> jobs(pipelines.size());
+
+  TaskScheduler::get().parallelFor(jobs.size(), [&](size_t jobIndex, uint32_t /*slot*/) {
+    jobs[jobIndex].code = pipelines[jobIndex]->compileShader(jobs[jobIndex].includedFiles);
+  });
+
+  for (size_t i = 0; i < pipelines.size(); i++) {
+    ComputePipeline *pipeline = pipelines[i];
+    if (!jobs[i].code.has_value()) {
+      pipeline->_logger->error("pipeline: {} is failed to compile!",
+                               pipeline->_fullPathToShaderSourceCode);
+      exit(0);
+    }
+    pipeline->cacheShaderModule(jobs[i].code.value(), jobs[i].includedFiles);
+    pipeline->_cleanupPipelineAndLayout();
+    pipeline->_createPipelineLayout();
+  }
+
+  // the create infos point into each other, so they are filled in place
+  std::vector<VariantCreateInfo> variantCreateInfos(pipelines.size());
+  std::vector<VkComputePipelineCreateInfo> createInfos{};
+  createInfos.reserve(pipelines.size());
+  for (size_t i = 0; i < pipelines.size(); i++) {
+    pipelines[i]->_fillVariantCreateInfo(variantCreateInfos[i]);
+    createInfos.push_back(variantCreateInfos[i].createInfo);
+  }
+
+  std::vector<VkPipeline> vkPipelines(pipelines.size(), VK_NULL_HANDLE);
+  if (!pipelines.empty()) {
+    VulkanApplicationContext *appContext = pipelines.front()->_appContext;
+    vkCreateComputePipelines(appContext->getDevice(), appContext->getPipelineCache(),
+                             static_cast<uint32_t>(createInfos.size()), createInfos.data(),
+                             nullptr, vkPipelines.data());
+  }
+  for (size_t i = 0; i < pipelines.size(); i++) {
+    ComputePipeline *pipeline = pipelines[i];
+    pipeline->_pipeline       = vkPipelines[i];
+    pipeline->_pipelineVariants[pipeline->_specializationConstants] = vkPipelines[i];
+  }
+}
+
 bool ComputePipeline::compileAndCacheShaderModule() {
-  auto const sourceCode =
-      ShaderFileReader::readShaderSourceCode(_fullPathToShaderSourceCode, _logger);
-  auto const compiledCode =
-      _shaderCompiler->compileComputeShader(_fullPathToShaderSourceCode, sourceCode);
+  std::vector<std::string> includedFiles{};
+  auto const compiledCode = compileShader(includedFiles);
 
   if (compiledCode.has_value()) {
-    _cleanupShaderModule();
-    _cachedShaderModule = _createShaderModule(compiledCode.value());
+    cacheShaderModule(compiledCode.value(), includedFiles);
     return true;
   }
   return false;
 }
 
+std::optional<std::vector<uint32_t>>
+ComputePipeline::compileShader(std::vector<std::string> &includedFiles) const {
+  auto const sourceCode =
+      ShaderFileReader::readShaderSourceCode(_fullPathToShaderSourceCode, _logger);
+  return _shaderCompiler->compileComputeShader(_fullPathToShaderSourceCode, sourceCode,
+                                               includedFiles);
+}
+
+void ComputePipeline::cacheShaderModule(std::vector<uint32_t> const &code,
+                                        std::vector<std::string> const &includedFiles) {
+  _cleanupShaderModule();
+  _cachedShaderModule = _createShaderModule(code);
+  _reflectUsedBindingSlots(code);
+
+  if (_shaderChangeListener != nullptr) {
+    _shaderChangeListener->setIncludedShaderFiles(this, includedFiles);
+  }
+}
+
 // the shader module must be cached before this step
 void ComputePipeline::build() {
   _cleanupPipelineAndLayout();
+  _createPipelineLayout();
+
+  // the other variants are built again once they are set
+  _pipeline                                   = _createPipelineVariant();
+  _pipelineVariants[_specializationConstants] = _pipeline;
+}
+
+void ComputePipeline::_createPipelineLayout() {
+  _createUsedDescriptorSetBundle();
 
   VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
   pipelineLayoutInfo.sType          = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
   pipelineLayoutInfo.setLayoutCount = 1;
   // this is why the compute pipeline requires the descriptor set layout to be specified
-  pipelineLayoutInfo.pSetLayouts = &_descriptorSetBundle->getDescriptorSetLayout();
+  pipelineLayoutInfo.pSetLayouts = &_usedDescriptorSetBundle->getDescriptorSetLayout();
+
+  VkPushConstantRange pushConstantRange{VK_SHADER_STAGE_COMPUTE_BIT, 0, _pushConstantSize};
+  if (_pushConstantSize > 0) {
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges    = &pushConstantRange;
+  }
 
   vkCreatePipelineLayout(_appContext->getDevice(), &pipelineLayoutInfo, nullptr, &_pipelineLayout);
 
@@ -56,35 +138,120 @@ void ComputePipeline::build() {
     _logger->error("failed to build the pipeline because of a null shader module: {}",
                    _fullPathToShaderSourceCode);
   }
+}
+
+bool ComputePipeline::setSpecializationConstants(std::vector<uint32_t> specializationConstants) {
+  if (specializationConstants == _specializationConstants) {
+    return false;
+  }
+  _specializationConstants = std::move(specializationConstants);
+  // the pipelines that aren't built yet are created with the values later on
+  if (_pipelineLayout == VK_NULL_HANDLE) {
+    return false;
+  }
+
+  auto const it = _pipelineVariants.find(_specializationConstants);
+  if (it != _pipelineVariants.end()) {
+    _pipeline = it->second;
+    return true;
+  }
+  _pipeline                                   = _createPipelineVariant();
+  _pipelineVariants[_specializationConstants] = _pipeline;
+  return true;
+}
+
+VkPipeline ComputePipeline::_createPipelineVariant() {
+  VariantCreateInfo variantCreateInfo{};
+  _fillVariantCreateInfo(variantCreateInfo);
+
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  vkCreateComputePipelines(_appContext->getDevice(), _appContext->getPipelineCache(), 1,
+                           &variantCreateInfo.createInfo, nullptr, &pipeline);
+  return pipeline;
+}
+
+// the constant ids are the indices of the values, which are all 32 bit
+void ComputePipeline::_fillVariantCreateInfo(VariantCreateInfo &variantCreateInfo) const {
+  auto &mapEntries = variantCreateInfo.mapEntries;
+  mapEntries.resize(_specializationConstants.size());
+  for (size_t i = 0; i < mapEntries.size(); i++) {
+    mapEntries[i].constantID = static_cast<uint32_t>(i);
+    mapEntries[i].offset     = static_cast<uint32_t>(i * sizeof(uint32_t));
+    mapEntries[i].size       = sizeof(uint32_t);
+  }
+
+  VkSpecializationInfo &specializationInfo = variantCreateInfo.specializationInfo;
+  specializationInfo.mapEntryCount         = static_cast<uint32_t>(mapEntries.size());
+  specializationInfo.pMapEntries           = mapEntries.data();
+  specializationInfo.dataSize              = _specializationConstants.size() * sizeof(uint32_t);
+  specializationInfo.pData                 = _specializationConstants.data();
 
   VkPipelineShaderStageCreateInfo shaderStageInfo{};
   shaderStageInfo.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
   shaderStageInfo.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
   shaderStageInfo.module = _cachedShaderModule;
   shaderStageInfo.pName  = "main"; // name of the entry function of current shader
+  shaderStageInfo.pSpecializationInfo =
+      _specializationConstants.empty() ? nullptr : &specializationInfo;
+
+  VkComputePipelineCreateInfo &computePipelineCreateInfo = variantCreateInfo.createInfo;
 
-  VkComputePipelineCreateInfo computePipelineCreateInfo{};
   computePipelineCreateInfo.sType  = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
   computePipelineCreateInfo.layout = _pipelineLayout;
   computePipelineCreateInfo.flags  = 0;
   computePipelineCreateInfo.stage  = shaderStageInfo;
-
-  vkCreateComputePipelines(_appContext->getDevice(), VK_NULL_HANDLE, 1, &computePipelineCreateInfo,
-                           nullptr, &_pipeline);
 }
 
 void ComputePipeline::recordCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
                                     uint32_t threadCountX, uint32_t threadCountY,
                                     uint32_t threadCountZ) {
   _bind(commandBuffer, currentFrame);
+  _beginDebugLabel(commandBuffer);
   vkCmdDispatch(commandBuffer,
                 static_cast<uint32_t>(std::ceil((float)threadCountX / (float)_workGroupSize.x)),
                 static_cast<uint32_t>(std::ceil((float)threadCountY / (float)_workGroupSize.y)),
                 static_cast<uint32_t>(std::ceil((float)threadCountZ / (float)_workGroupSize.z)));
+  _endDebugLabel(commandBuffer);
 }
 
 void ComputePipeline::recordIndirectCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
                                             VkBuffer indirectBuffer) {
   _bind(commandBuffer, currentFrame);
+  _beginDebugLabel(commandBuffer);
   vkCmdDispatchIndirect(commandBuffer, indirectBuffer, 0);
+  _endDebugLabel(commandBuffer);
+}
+
+void ComputePipeline::recordCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
+                                    uint32_t threadCountX, uint32_t threadCountY,
+                                    uint32_t threadCountZ, void const *pushConstantData) {
+  _pushConstants(commandBuffer, pushConstantData);
+  recordCommand(commandBuffer, currentFrame, threadCountX, threadCountY, threadCountZ);
+}
+
+void ComputePipeline::recordIndirectCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
+                                            VkBuffer indirectBuffer,
+                                            void const *pushConstantData) {
+  _pushConstants(commandBuffer, pushConstantData);
+  recordIndirectCommand(commandBuffer, currentFrame, indirectBuffer);
+}
+
+// the labels show up as the names of the dispatches in the frame captures of renderdoc, nsight and
+// rgp, the debug utils are an instance extension, which is only enabled with the validation layers
+void ComputePipeline::_beginDebugLabel(VkCommandBuffer commandBuffer) const {
+#ifndef NVALIDATIONLAYERS
+  VkDebugUtilsLabelEXT label{VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT};
+  label.pLabelName = _debugLabel.c_str();
+  vkCmdBeginDebugUtilsLabelEXT(commandBuffer, &label);
+#else
+  (void)commandBuffer;
+#endif // NVALIDATIONLAYERS
+}
+
+void ComputePipeline::_endDebugLabel(VkCommandBuffer commandBuffer) {
+#ifndef NVALIDATIONLAYERS
+  vkCmdEndDebugUtilsLabelEXT(commandBuffer);
+#else
+  (void)commandBuffer;
+#endif // NVALIDATIONLAYERS
 }
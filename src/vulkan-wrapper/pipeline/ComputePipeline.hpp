@@ -2,6 +2,8 @@
 
 #include "Pipeline.hpp"
 
+#include <optional>
+
 struct WorkGroupSize {
   uint32_t x;
   uint32_t y;
@@ -16,7 +18,8 @@ public:
                   PipelineScheduler *scheduler, std::string fullPathToShaderSourceCode,
                   WorkGroupSize workGroupSize, DescriptorSetBundle *descriptorSetBundle,
                   ShaderCompiler *shaderCompiler,
-                  ShaderChangeListener *shaderChangeListener = nullptr);
+                  ShaderChangeListener *shaderChangeListener = nullptr,
+                  uint32_t pushConstantSize                  = 0);
 
   ~ComputePipeline() override;
 
@@ -26,17 +29,54 @@ public:
   ComputePipeline(ComputePipeline &&)                 = delete;
   ComputePipeline &operator=(ComputePipeline &&)      = delete;
 
+  // the pipelines are only usable after this, or after their own compileAndCacheShaderModule and
+  // build, the shaders are compiled on a pool of threads, then the pipelines are created in a batch
+  static void compileAndBuild(std::vector<ComputePipeline *> const &pipelines);
+
   void build() override;
   bool compileAndCacheShaderModule() override;
 
+  [[nodiscard]] std::optional<std::vector<uint32_t>>
+  compileShader(std::vector<std::string> &includedFiles) const override;
+  void cacheShaderModule(std::vector<uint32_t> const &code,
+                         std::vector<std::string> const &includedFiles) override;
+
+  // the variant of the values is built if it isn't cached yet, returns if the pipeline has been
+  // swapped, so the commands recorded with the last one have to be recorded again
+  bool setSpecializationConstants(std::vector<uint32_t> specializationConstants);
+
   void recordCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t threadCountX,
                      uint32_t threadCountY, uint32_t threadCountZ);
 
   void recordIndirectCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
                              VkBuffer indirectBuffer);
 
+  // these push the data before the dispatch, the pipeline has to be created with the size of it
+  void recordCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t threadCountX,
+                     uint32_t threadCountY, uint32_t threadCountZ, void const *pushConstantData);
+
+  void recordIndirectCommand(VkCommandBuffer commandBuffer, uint32_t currentFrame,
+                             VkBuffer indirectBuffer, void const *pushConstantData);
+
 private:
+  // the specialization info and the create info point into the struct, so it's filled in place
+  struct VariantCreateInfo {
+    std::vector<VkSpecializationMapEntry> mapEntries;
+    VkSpecializationInfo specializationInfo;
+    VkComputePipelineCreateInfo createInfo;
+  };
+
   WorkGroupSize _workGroupSize;
+  // the file name of the shader, the dispatches are labeled with it for the frame captures
+  std::string _debugLabel;
+
+  void _createPipelineLayout();
+  // only recorded with the validation layers, which enable the debug utils
+  void _beginDebugLabel(VkCommandBuffer commandBuffer) const;
+  static void _endDebugLabel(VkCommandBuffer commandBuffer);
+
+  VkPipeline _createPipelineVariant();
+  void _fillVariantCreateInfo(VariantCreateInfo &variantCreateInfo) const;
 
   ShaderCompiler *_shaderCompiler;
 };
\ No newline at end of file
@@ -1,10 +1,13 @@
 #include "Pipeline.hpp"
 #include "../descriptor-set/DescriptorSetBundle.hpp"
+#include "SpirvReflection.hpp"
 #include "app-context/VulkanApplicationContext.hpp"
 #include "file-watcher/ShaderChangeListener.hpp"
 #include "scheduler/Scheduler.hpp"
 #include "utils/logger/Logger.hpp"
 
+#include <algorithm>
+#include <cassert>
 #include <map>
 #include <vector>
 
@@ -16,11 +19,11 @@ static const std::map<VkShaderStageFlags, VkPipelineBindPoint> kShaderStageFlags
 Pipeline::Pipeline(VulkanApplicationContext *appContext, Logger *logger,
                    PipelineScheduler *scheduler, std::string fullPathToShaderSourceCode,
                    DescriptorSetBundle *descriptorSetBundle, VkShaderStageFlags shaderStageFlags,
-                   ShaderChangeListener *shaderChangeListener)
+                   ShaderChangeListener *shaderChangeListener, uint32_t pushConstantSize)
     : _appContext(appContext), _logger(logger), _scheduler(scheduler),
       _shaderChangeListener(shaderChangeListener), _descriptorSetBundle(descriptorSetBundle),
       _fullPathToShaderSourceCode(std::move(fullPathToShaderSourceCode)),
-      _shaderStageFlags(shaderStageFlags) {
+      _shaderStageFlags(shaderStageFlags), _pushConstantSize(pushConstantSize) {
 
   if (_shaderChangeListener != nullptr) {
     _shaderChangeListener->addWatchingPipeline(this);
@@ -41,10 +44,11 @@ void Pipeline::_cleanupPipelineAndLayout() {
     vkDestroyPipelineLayout(_appContext->getDevice(), _pipelineLayout, nullptr);
     _pipelineLayout = VK_NULL_HANDLE;
   }
-  if (_pipeline != VK_NULL_HANDLE) {
-    vkDestroyPipeline(_appContext->getDevice(), _pipeline, nullptr);
-    _pipeline = VK_NULL_HANDLE;
+  for (auto const &[specializationConstants, pipeline] : _pipelineVariants) {
+    vkDestroyPipeline(_appContext->getDevice(), pipeline, nullptr);
   }
+  _pipelineVariants.clear();
+  _pipeline = VK_NULL_HANDLE;
 }
 
 void Pipeline::_cleanupShaderModule() {
@@ -70,9 +74,51 @@ VkShaderModule Pipeline::_createShaderModule(const std::vector<uint32_t> &code)
   return shaderModule;
 }
 
+void Pipeline::_reflectUsedBindingSlots(const std::vector<uint32_t> &code) {
+  std::vector<VkDescriptorSetLayoutBinding> const layoutBindings =
+      _descriptorSetBundle->getLayoutBindings();
+
+  _usedBindingSlots.clear();
+  for (auto const &binding : SpirvReflection::reflectDescriptorBindings(code)) {
+    if (binding.set != 0) {
+      _logger->error("{} uses the descriptor set {}, only the set 0 is bound",
+                     _fullPathToShaderSourceCode, binding.set);
+      continue;
+    }
+    auto const it = std::find_if(layoutBindings.begin(), layoutBindings.end(),
+                                 [&](VkDescriptorSetLayoutBinding const &layoutBinding) {
+                                   return layoutBinding.binding == binding.binding;
+                                 });
+    if (it == layoutBindings.end()) {
+      _logger->error("{} uses the binding {}, which isn't bound to the descriptor set bundle",
+                     _fullPathToShaderSourceCode, binding.binding);
+      continue;
+    }
+    if (it->descriptorType != binding.descriptorType ||
+        (binding.descriptorCount != 0 && it->descriptorCount != binding.descriptorCount)) {
+      _logger->error("the binding {} of {} doesn't match the one of the descriptor set bundle",
+                     binding.binding, _fullPathToShaderSourceCode);
+      continue;
+    }
+    _usedBindingSlots.push_back(binding.binding);
+  }
+}
+
+// the sets of the sub bundle are recreated along with the pipeline, so the layout always matches
+void Pipeline::_createUsedDescriptorSetBundle() {
+  _usedDescriptorSetBundle = _descriptorSetBundle->createSubBundle(_usedBindingSlots);
+}
+
 void Pipeline::_bind(VkCommandBuffer commandBuffer, size_t currentFrame) {
   vkCmdBindDescriptorSets(commandBuffer, kShaderStageFlagsToBindPoint.at(_shaderStageFlags),
                           _pipelineLayout, 0, 1,
-                          &_descriptorSetBundle->getDescriptorSet(currentFrame), 0, nullptr);
+                          &_usedDescriptorSetBundle->getDescriptorSet(currentFrame), 0, nullptr);
   vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline);
 }
+
+// the data has to hold the whole push constant block
+void Pipeline::_pushConstants(VkCommandBuffer commandBuffer, void const *pushConstantData) {
+  assert(_pushConstantSize > 0 && "the pipeline is created without push constants");
+  vkCmdPushConstants(commandBuffer, _pipelineLayout, _shaderStageFlags, 0, _pushConstantSize,
+                     pushConstantData);
+}
@@ -3,6 +3,9 @@
 #include "volk.h"
 
 #include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -19,7 +22,7 @@ public:
   Pipeline(VulkanApplicationContext *appContext, Logger *logger, PipelineScheduler *scheduler,
            std::string fullPathToShaderSourceCode, DescriptorSetBundle *descriptorSetBundle,
            VkShaderStageFlags shaderStageFlags,
-           ShaderChangeListener *shaderChangeListener = nullptr);
+           ShaderChangeListener *shaderChangeListener = nullptr, uint32_t pushConstantSize = 0);
   virtual ~Pipeline();
 
   // disable copy and move
@@ -34,6 +37,14 @@ public:
   // returns of the shader has been compiled and cached correctly
   virtual bool compileAndCacheShaderModule() = 0;
 
+  // the two halves of compileAndCacheShaderModule, the compilation is safe to run on another
+  // thread, the full paths of the included files are appended to includedFiles, the caching then
+  // makes them the watched files of the pipeline, besides its source
+  [[nodiscard]] virtual std::optional<std::vector<uint32_t>>
+  compileShader(std::vector<std::string> &includedFiles) const = 0;
+  virtual void cacheShaderModule(std::vector<uint32_t> const &code,
+                                 std::vector<std::string> const &includedFiles) = 0;
+
   void updateDescriptorSetBundle(DescriptorSetBundle *descriptorSetBundle);
 
   [[nodiscard]] std::string getFullPathToShaderSourceCode() const {
@@ -52,18 +63,36 @@ protected:
   DescriptorSetBundle *_descriptorSetBundle;
   std::string _fullPathToShaderSourceCode;
 
+  // the binding slots that the cached shader module uses, reflected from its code, the pipeline
+  // layout and the bound descriptor sets are those of the sub bundle of only these slots
+  std::vector<uint32_t> _usedBindingSlots;
+  std::unique_ptr<DescriptorSetBundle> _usedDescriptorSetBundle;
+
   std::vector<BufferBundle *> _uniformBufferBundles; // buffer bundles for uniform data
   std::vector<BufferBundle *> _storageBufferBundles; // buffer bundles for storage data
   std::vector<Image *> _storageImages;               // images for storage data
 
   VkShaderStageFlags _shaderStageFlags;
 
+  // the size of the push constant block of the shader, starting at offset 0, 0 if it has none
+  uint32_t _pushConstantSize;
+
   VkPipeline _pipeline             = VK_NULL_HANDLE;
   VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
 
+  // the values of the specialization constants, indexed by their constant ids, the variants that
+  // have been built are cached by them, _pipeline is the one of the current values
+  std::vector<uint32_t> _specializationConstants;
+  std::map<std::vector<uint32_t>, VkPipeline> _pipelineVariants;
+
   void _cleanupPipelineAndLayout();
   void _cleanupShaderModule();
 
   VkShaderModule _createShaderModule(const std::vector<uint32_t> &code);
+  // also validates the bindings of the shader against the ones of the bundle, which mirror the
+  // descriptor set layouts of the glsl headers
+  void _reflectUsedBindingSlots(const std::vector<uint32_t> &code);
+  void _createUsedDescriptorSetBundle();
   void _bind(VkCommandBuffer commandBuffer, size_t currentFrame);
+  void _pushConstants(VkCommandBuffer commandBuffer, void const *pushConstantData);
 };
@@ -0,0 +1,205 @@
+#include "SpirvReflection.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+// from the spir-v specification, only the parts that describe the resource variables
+uint32_t constexpr kSpirvMagic      = 0x07230203;
+uint32_t constexpr kHeaderWordCount = 5;
+
+uint32_t constexpr kOpEntryPoint                   = 15;
+uint32_t constexpr kOpTypeImage                    = 25;
+uint32_t constexpr kOpTypeSampler                  = 26;
+uint32_t constexpr kOpTypeSampledImage             = 27;
+uint32_t constexpr kOpTypeArray                    = 28;
+uint32_t constexpr kOpTypeRuntimeArray             = 29;
+uint32_t constexpr kOpTypeStruct                   = 30;
+uint32_t constexpr kOpTypePointer                  = 32;
+uint32_t constexpr kOpConstant                     = 43;
+uint32_t constexpr kOpVariable                     = 59;
+uint32_t constexpr kOpDecorate                     = 71;
+uint32_t constexpr kOpTypeAccelerationStructureKHR = 5341;
+
+uint32_t constexpr kDecorationBlock         = 2;
+uint32_t constexpr kDecorationBufferBlock   = 3;
+uint32_t constexpr kDecorationBinding       = 33;
+uint32_t constexpr kDecorationDescriptorSet = 34;
+
+uint32_t constexpr kStorageClassUniformConstant = 0;
+uint32_t constexpr kStorageClassUniform         = 2;
+uint32_t constexpr kStorageClassStorageBuffer   = 12;
+
+// from this version on the entry point interface lists the resource variables too
+uint32_t constexpr kSpirvVersion14 = 0x00010400;
+
+struct TypeInfo {
+  uint32_t opcode;
+  // the element type of arrays and pointers, the sampled value of images
+  uint32_t operand;
+  // the length id of arrays
+  uint32_t lengthId;
+};
+
+struct VariableInfo {
+  uint32_t pointerTypeId;
+  uint32_t storageClass;
+};
+
+std::optional<VkDescriptorType> _getDescriptorType(TypeInfo const &type, uint32_t storageClass,
+                                                   bool isBlock, bool isBufferBlock) {
+  switch (type.opcode) {
+  case kOpTypeStruct:
+    if (storageClass == kStorageClassStorageBuffer || isBufferBlock) {
+      return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    if (storageClass == kStorageClassUniform && isBlock) {
+      return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    }
+    return std::nullopt;
+  case kOpTypeImage:
+    // sampled is 2 for the images that are only read and written without a sampler
+    return type.operand == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+  case kOpTypeSampledImage:
+    return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  case kOpTypeSampler:
+    return VK_DESCRIPTOR_TYPE_SAMPLER;
+  case kOpTypeAccelerationStructureKHR:
+    return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+  default:
+    return std::nullopt;
+  }
+}
+} // namespace
+
+namespace SpirvReflection {
+std::vector<DescriptorBinding> reflectDescriptorBindings(std::vector<uint32_t> const &code) {
+  if (code.size() < kHeaderWordCount || code[0] != kSpirvMagic) {
+    return {};
+  }
+  uint32_t const version = code[1];
+
+  std::unordered_map<uint32_t, uint32_t> sets{};
+  std::unordered_map<uint32_t, uint32_t> bindings{};
+  std::unordered_set<uint32_t> blocks{};
+  std::unordered_set<uint32_t> bufferBlocks{};
+  std::unordered_map<uint32_t, TypeInfo> types{};
+  std::unordered_map<uint32_t, uint32_t> constants{};
+  std::unordered_map<uint32_t, VariableInfo> variables{};
+  std::unordered_set<uint32_t> interfaceIds{};
+
+  for (size_t i = kHeaderWordCount; i < code.size();) {
+    uint32_t const wordCount = code[i] >> 16;
+    uint32_t const opcode    = code[i] & 0xFFFF;
+    if (wordCount == 0 || i + wordCount > code.size()) {
+      return {};
+    }
+    uint32_t const *operands = &code[i + 1];
+
+    switch (opcode) {
+    case kOpEntryPoint: {
+      // skips the execution model, the id, and the words of the name, which is a nul terminated
+      // string, so its last word is the first one whose highest byte is 0
+      size_t word = 2;
+      while (word < wordCount - 1 && (operands[word] >> 24) != 0) {
+        word++;
+      }
+      for (word++; word < wordCount - 1; word++) {
+        interfaceIds.insert(operands[word]);
+      }
+      break;
+    }
+    case kOpDecorate:
+      if (operands[1] == kDecorationDescriptorSet) {
+        sets[operands[0]] = operands[2];
+      } else if (operands[1] == kDecorationBinding) {
+        bindings[operands[0]] = operands[2];
+      } else if (operands[1] == kDecorationBlock) {
+        blocks.insert(operands[0]);
+      } else if (operands[1] == kDecorationBufferBlock) {
+        bufferBlocks.insert(operands[0]);
+      }
+      break;
+    case kOpTypeImage:
+      types[operands[0]] = {opcode, operands[6], 0};
+      break;
+    case kOpTypeArray:
+      types[operands[0]] = {opcode, operands[1], operands[2]};
+      break;
+    case kOpTypeRuntimeArray:
+      types[operands[0]] = {opcode, operands[1], 0};
+      break;
+    case kOpTypePointer:
+      types[operands[0]] = {opcode, operands[2], 0};
+      break;
+    case kOpTypeSampler:
+    case kOpTypeSampledImage:
+    case kOpTypeStruct:
+    case kOpTypeAccelerationStructureKHR:
+      types[operands[0]] = {opcode, 0, 0};
+      break;
+    case kOpConstant:
+      constants[operands[1]] = operands[2];
+      break;
+    case kOpVariable:
+      variables[operands[1]] = {operands[0], operands[2]};
+      break;
+    default:
+      break;
+    }
+    i += wordCount;
+  }
+
+  std::vector<DescriptorBinding> descriptorBindings{};
+  for (auto const &[variableId, variable] : variables) {
+    if (variable.storageClass != kStorageClassUniformConstant &&
+        variable.storageClass != kStorageClassUniform &&
+        variable.storageClass != kStorageClassStorageBuffer) {
+      continue;
+    }
+    if (version >= kSpirvVersion14 && interfaceIds.count(variableId) == 0) {
+      continue;
+    }
+    auto const setIt     = sets.find(variableId);
+    auto const bindingIt = bindings.find(variableId);
+    auto const pointerIt = types.find(variable.pointerTypeId);
+    if (setIt == sets.end() || bindingIt == bindings.end() || pointerIt == types.end()) {
+      continue;
+    }
+
+    // the arrays of descriptors are unwrapped to their element type
+    uint32_t typeId          = pointerIt->second.operand;
+    uint32_t descriptorCount = 1;
+    auto typeIt              = types.find(typeId);
+    if (typeIt != types.end() && typeIt->second.opcode == kOpTypeArray) {
+      auto const lengthIt = constants.find(typeIt->second.lengthId);
+      descriptorCount     = lengthIt != constants.end() ? lengthIt->second : 1;
+      typeId              = typeIt->second.operand;
+    } else if (typeIt != types.end() && typeIt->second.opcode == kOpTypeRuntimeArray) {
+      descriptorCount = 0;
+      typeId          = typeIt->second.operand;
+    }
+    typeIt = types.find(typeId);
+    if (typeIt == types.end()) {
+      continue;
+    }
+
+    auto const descriptorType =
+        _getDescriptorType(typeIt->second, variable.storageClass, blocks.count(typeId) != 0,
+                           bufferBlocks.count(typeId) != 0);
+    if (!descriptorType.has_value()) {
+      continue;
+    }
+    descriptorBindings.push_back(
+        {setIt->second, bindingIt->second, descriptorType.value(), descriptorCount});
+  }
+
+  std::sort(descriptorBindings.begin(), descriptorBindings.end(),
+            [](DescriptorBinding const &a, DescriptorBinding const &b) {
+              return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+            });
+  return descriptorBindings;
+}
+}; // namespace SpirvReflection
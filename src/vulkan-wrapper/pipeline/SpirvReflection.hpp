@@ -0,0 +1,22 @@
+#pragma once
+
+#include "volk.h"
+
+#include <cstdint>
+#include <vector>
+
+// reads the descriptor bindings that a compiled shader actually uses, from the decorations and the
+// types of its resource variables, the optimizer strips the unused ones, and from spir-v 1.4 on
+// the entry point lists every global that it references
+namespace SpirvReflection {
+struct DescriptorBinding {
+  uint32_t set;
+  uint32_t binding;
+  VkDescriptorType descriptorType;
+  // 0 for the runtime arrays
+  uint32_t descriptorCount;
+};
+
+// sorted by the set and the binding, empty if the code isn't valid spir-v
+std::vector<DescriptorBinding> reflectDescriptorBindings(std::vector<uint32_t> const &code);
+}; // namespace SpirvReflection
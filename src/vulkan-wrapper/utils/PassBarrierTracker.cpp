@@ -0,0 +1,33 @@
+#include "PassBarrierTracker.hpp"
+
+#include <algorithm>
+
+void PassBarrierTracker::recordPassDependencies(VkCommandBuffer commandBuffer,
+                                                std::vector<Resource> const &reads,
+                                                std::vector<Resource> const &writes) {
+  auto const isWritten = [this](Resource resource) { return _pendingWrites.count(resource) != 0; };
+  auto const isAccessed = [this, &isWritten](Resource resource) {
+    return isWritten(resource) || _pendingReads.count(resource) != 0;
+  };
+
+  if (std::any_of(reads.begin(), reads.end(), isWritten) ||
+      std::any_of(writes.begin(), writes.end(), isAccessed)) {
+    recordBarrier(commandBuffer);
+  }
+
+  _pendingReads.insert(reads.begin(), reads.end());
+  _pendingWrites.insert(writes.begin(), writes.end());
+}
+
+void PassBarrierTracker::recordBarrier(VkCommandBuffer commandBuffer) {
+  VkMemoryBarrier memoryBarrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+  memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0,
+                       nullptr);
+
+  _pendingReads.clear();
+  _pendingWrites.clear();
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "volk.h"
+
+#include <unordered_set>
+#include <vector>
+
+// tracks the resources that the compute passes of a command buffer read and write, and records a
+// barrier before a pass only if it depends on a pass since the last barrier, so that the
+// independent passes in between overlap on the gpu, the resources are identified by their
+// wrappers, e.g. an Image or a Buffer
+class PassBarrierTracker {
+public:
+  using Resource = void const *;
+
+  // records a compute to compute barrier first if the pass reads or writes a resource that is
+  // written since the last barrier, or writes one that is read since then
+  void recordPassDependencies(VkCommandBuffer commandBuffer, std::vector<Resource> const &reads,
+                              std::vector<Resource> const &writes);
+
+  // for the commands in between that aren't tracked, e.g. the passes with barriers of their own
+  void recordBarrier(VkCommandBuffer commandBuffer);
+
+private:
+  std::unordered_set<Resource> _pendingReads;
+  std::unordered_set<Resource> _pendingWrites;
+};
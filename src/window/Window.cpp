@@ -9,6 +9,34 @@
 
 Window::Window(WindowStyle windowStyle, Logger *logger, int widthIfWindowed, int heightIfWindowed)
     : _logger(logger), _widthIfWindowed(widthIfWindowed), _heightIfWindowed(heightIfWindowed) {
+  if (windowStyle == WindowStyle::kHeadless) {
+    _createHeadlessWindow();
+  } else {
+    _createWindow(windowStyle);
+  }
+
+  if (_cursorInfo.cursorState == CursorState::kInvisible) {
+    hideCursor();
+  } else {
+    showCursor();
+  }
+
+  glfwSetWindowUserPointer(_window, this); // set this pointer to the window class
+  glfwSetKeyCallback(_window, _keyCallback);
+  glfwSetCursorPosCallback(_window, _cursorPosCallback);
+  glfwSetMouseButtonCallback(_window, _mouseButtonCallback);
+  glfwSetFramebufferSizeCallback(_window, _frameBufferResizeCallback);
+
+  addKeyboardCallback(
+      [this](KeyboardInfo const &keyboardInfo) { _windowStyleToggleCallback(keyboardInfo); });
+}
+
+Window::~Window() {
+  glfwDestroyWindow(_window);
+  glfwTerminate();
+}
+
+void Window::_createWindow(WindowStyle windowStyle) {
   glfwInit();
 
   _monitor = glfwGetPrimaryMonitor();
@@ -42,26 +70,27 @@ Window::Window(WindowStyle windowStyle, Logger *logger, int widthIfWindowed, int
   setWindowStyle(windowStyle);
 
   _windowStyle = windowStyle;
+}
 
-  if (_cursorInfo.cursorState == CursorState::kInvisible) {
-    hideCursor();
-  } else {
-    showCursor();
-  }
-
-  glfwSetWindowUserPointer(_window, this); // set this pointer to the window class
-  glfwSetKeyCallback(_window, _keyCallback);
-  glfwSetCursorPosCallback(_window, _cursorPosCallback);
-  glfwSetMouseButtonCallback(_window, _mouseButtonCallback);
-  glfwSetFramebufferSizeCallback(_window, _frameBufferResizeCallback);
+// the null platform needs no display or monitor, it's there from glfw 3.4 on, the window only
+// carries the input callbacks and the size, which no event ever changes
+void Window::_createHeadlessWindow() {
+#ifdef GLFW_PLATFORM_NULL
+  glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
+  glfwInit();
 
-  addKeyboardCallback(
-      [this](KeyboardInfo const &keyboardInfo) { _windowStyleToggleCallback(keyboardInfo); });
-}
+  glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  _window = glfwCreateWindow(_widthIfWindowed, _heightIfWindowed, "Voxel Tracer v1.0", nullptr,
+                             nullptr);
+  if (_window == nullptr) {
+    _logger->error("failed to create the headless window");
+  }
 
-Window::~Window() {
-  glfwDestroyWindow(_window);
-  glfwTerminate();
+  _maximizedFullscreenWidth  = _widthIfWindowed;
+  _maximizedFullscreenHeight = _heightIfWindowed;
+  _windowStyle               = WindowStyle::kHeadless;
 }
 
 void Window::toggleWindowStyle() {
@@ -78,11 +107,13 @@ void Window::toggleWindowStyle() {
   case WindowStyle::kHover:
     setWindowStyle(WindowStyle::kFullScreen);
     break;
+  case WindowStyle::kHeadless:
+    break;
   }
 }
 
 void Window::setWindowStyle(WindowStyle newStyle) {
-  if (newStyle == _windowStyle) {
+  if (newStyle == _windowStyle || _windowStyle == WindowStyle::kHeadless) {
     return;
   }
 
@@ -91,7 +122,8 @@ void Window::setWindowStyle(WindowStyle newStyle) {
 
   switch (newStyle) {
   case WindowStyle::kNone:
-    assert(false && "Cannot set window style to none");
+  case WindowStyle::kHeadless:
+    assert(false && "Cannot set window style to none or headless");
     break;
 
   case WindowStyle::kFullScreen:
@@ -176,6 +208,9 @@ void Window::_keyCallback(GLFWwindow *window, int key, int /*scancode*/, int act
   // consume keys
   ki.disableInputBit(GLFW_KEY_E);
   ki.disableInputBit(GLFW_KEY_F);
+  // a held key would request another capture, or toggle the recording, with every repeat
+  ki.disableInputBit(GLFW_KEY_C);
+  ki.disableInputBit(GLFW_KEY_F9);
 }
 
 void Window::_cursorPosCallback(GLFWwindow *window, double xpos, double ypos) {
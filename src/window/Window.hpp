@@ -14,7 +14,8 @@
 #include <functional>
 #include <vector>
 
-enum class WindowStyle { kNone, kFullScreen, kMaximized, kHover };
+// a headless window is never shown, it's of the windowed size, and it keeps its style
+enum class WindowStyle { kNone, kFullScreen, kMaximized, kHover, kHeadless };
 
 class Logger;
 class Window {
@@ -101,6 +102,9 @@ private:
 
   void _resetCursorDelta();
 
+  void _createWindow(WindowStyle windowStyle);
+  void _createHeadlessWindow();
+
   void _windowStyleToggleCallback(KeyboardInfo const &keyboardInfo);
 
   // these functions are restricted to be static functions